@@ -46,11 +46,13 @@ UPDATE_STORAGE_ADDRESS := 0x80000
 #   FREERTOS_CONFIG
 #	LORAWAN_CONFIG
 #	BLE_CONFIG
+#	RTOS_HEAP (heap_4 or heap_tlsf)
 #
 #******************************************************************************
 # FREERTOS_CONFIG := $(shell pwd)/config/FreeRTOSConfig.h
 # LORAWAN_CONFIG  := $(shell pwd)/config/lorawan_config.h
 # BLE_CONFIG      := $(shell pwd)/config/ble_config.h
+# RTOS_HEAP       := heap_tlsf
 
 #******************************************************************************
 #
@@ -72,8 +74,30 @@ SRC += main.c
 SRC += console_task.c
 SRC += application_task.c
 SRC += application_task_cli.c
+SRC += energy_monitor.c
+SRC += energy_monitor_cli.c
+SRC += log_task.c
+SRC += log_task_cli.c
+SRC += rtos_stats.c
+SRC += rtos_stats_cli.c
+SRC += radio_coex.c
+SRC += radio_coex_cli.c
+SRC += sleep_governor.c
+SRC += sleep_governor_cli.c
 
 
+#
+# Per-interrupt statistics for the "top" command route every peripheral
+# vector through am_isr_profile().  They are off unless requested with
+#
+#   make ISR_PROFILING=1
+#
+ISR_PROFILING ?= 0
+ifeq ($(ISR_PROFILING),1)
+DEFINES += -DISR_PROFILING
+endif
+
+DEFINES += -DLOG_TOKENIZED
 DEFINES += -DSOFT_SE
 DEFINES += -DCONTEXT_MANAGEMENT_ENABLED
 
@@ -95,6 +119,7 @@ SRC += soft-se.c
 SRC += lmh_callbacks.c
 SRC += lmhp_fragmentation.c
 SRC += lorawan_se.c
+SRC += lorawan_scheduler.c
 SRC += lorawan_task.c
 SRC += lorawan_task_cli.c
 
@@ -104,6 +129,8 @@ INCLUDES += -I./comms/ble/tag
 VPATH += ./comms/ble
 VPATH += ./comms/ble/tag
 
+SRC += ble_ota.c
+SRC += ble_bulk.c
 SRC += ble_task.c
 SRC += ble_task_cli.c
 SRC += ble_stack.c
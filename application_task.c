@@ -41,6 +41,11 @@
 
 #include "application_task.h"
 #include "application_task_cli.h"
+#include "energy_monitor_cli.h"
+#include "log_task_cli.h"
+#include "rtos_stats_cli.h"
+#include "radio_coex_cli.h"
+#include "sleep_governor_cli.h"
 
 static TaskHandle_t application_task_handle;
 static QueueHandle_t lorawan_receive_queue;
@@ -84,6 +89,11 @@ static void application_setup_lorawan()
 static void application_task(void *parameter)
 {
     application_task_cli_register();
+    energy_monitor_cli_register();
+    log_task_cli_register();
+    rtos_stats_cli_register();
+    radio_coex_cli_register();
+    sleep_governor_cli_register();
 
     application_setup_task();
     application_setup_lorawan();
@@ -40,6 +40,7 @@ typedef enum
 {
     BLE_START,
     BLE_STOP,
+    BLE_BULK_BENCH,
 } ble_command_e;
 
 typedef struct
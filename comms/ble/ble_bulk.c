@@ -0,0 +1,389 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <wsf_types.h>
+#include <dm_api.h>
+#include <l2c_api.h>
+#include <att_api.h>
+#include <att_defs.h>
+#include <app_api.h>
+#include <svc_wdxs.h>
+
+#include "ble_bulk.h"
+
+//
+// Bulk data over an LE credit based channel.  The peer connects to
+// BLE_BULK_PSM and the producer is asked for one SDU at a time, the next one
+// as soon as L2CAP has handed the last segment of the previous one to HCI.
+// L2CAP segments each SDU across the peer MPS and stops when the peer runs
+// out of credits, so a slow consumer holds the producer off without any
+// buffering here.
+//
+// The benchmark streams the same number of bytes over the channel and then
+// as notifications on the WDXS file transfer data characteristic of the
+// same connection, one notification in flight at a time.
+//
+#define BLE_BULK_PSM       0x0080
+#define BLE_BULK_MPS       247
+#define BLE_BULK_SDU_SIZE  1024
+#define BLE_BULK_CREDITS   8
+#define BLE_BULK_CLOCK_HZ  32768
+
+typedef enum
+{
+    BLE_BULK_IDLE,
+    BLE_BULK_COC,
+    BLE_BULK_NOTIFY,
+} ble_bulk_state_e;
+
+static ble_bulk_state_e ble_bulk_state;
+static ble_bulk_producer_t ble_bulk_producer;
+static ble_bulk_path_statistics_t *ble_bulk_path;
+static bool ble_bulk_benchmark;
+
+static uint16_t ble_bulk_cid = L2C_COC_CID_NONE;
+static uint16_t ble_bulk_peer_mtu;
+static dmConnId_t ble_bulk_conn_id;
+
+static uint32_t ble_bulk_started;
+static uint32_t ble_bulk_sent;
+static uint16_t ble_bulk_pending;
+static uint64_t ble_bulk_latency;
+
+static uint32_t ble_bulk_remaining;
+static uint32_t ble_bulk_offset;
+static uint32_t ble_bulk_bench_bytes;
+
+static uint8_t ble_bulk_sdu[BLE_BULK_SDU_SIZE];
+
+static ble_bulk_statistics_t ble_bulk_stats;
+
+static uint32_t ble_bulk_ticks_to_us(uint32_t ui32Ticks)
+{
+    return (uint32_t)(((uint64_t)ui32Ticks * 1000000) / BLE_BULK_CLOCK_HZ);
+}
+
+static uint16_t ble_bulk_pattern(uint8_t *pui8Buffer, uint16_t ui16Size)
+{
+    uint16_t ui16Length;
+
+    ui16Length = (ble_bulk_remaining < ui16Size) ? ble_bulk_remaining : ui16Size;
+
+    for (uint16_t i = 0; i < ui16Length; i++)
+    {
+        pui8Buffer[i] = (uint8_t)(ble_bulk_offset + i);
+    }
+
+    ble_bulk_remaining -= ui16Length;
+    ble_bulk_offset += ui16Length;
+
+    return ui16Length;
+}
+
+static void ble_bulk_path_begin(ble_bulk_path_statistics_t *psPath, uint16_t ui16UnitSize)
+{
+    taskENTER_CRITICAL();
+    memset(psPath, 0, sizeof(ble_bulk_path_statistics_t));
+    psPath->ui32UnitSize = ui16UnitSize;
+    ble_bulk_stats.bRunning = true;
+    taskEXIT_CRITICAL();
+
+    ble_bulk_path = psPath;
+    ble_bulk_latency = 0;
+    ble_bulk_pending = 0;
+    ble_bulk_started = am_hal_stimer_counter_get();
+}
+
+//
+// Account for the unit that was just confirmed.  Latency runs from the data
+// request to the confirm, which is when the last fragment reached HCI.
+//
+static void ble_bulk_path_confirm(uint8_t ui8Status)
+{
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+    uint32_t ui32Us = ble_bulk_ticks_to_us(ui32Now - ble_bulk_sent);
+
+    taskENTER_CRITICAL();
+    if (ui8Status == 0)
+    {
+        ble_bulk_path->ui32Bytes += ble_bulk_pending;
+        ble_bulk_path->ui32Units++;
+        ble_bulk_latency += ui32Us;
+        ble_bulk_path->ui32LatencyAvgUs = (uint32_t)(ble_bulk_latency / ble_bulk_path->ui32Units);
+        if (ui32Us > ble_bulk_path->ui32LatencyMaxUs)
+        {
+            ble_bulk_path->ui32LatencyMaxUs = ui32Us;
+        }
+    }
+    else
+    {
+        ble_bulk_path->ui32Errors++;
+    }
+    ble_bulk_path->ui32DurationUs = ble_bulk_ticks_to_us(ui32Now - ble_bulk_started);
+    taskEXIT_CRITICAL();
+
+    ble_bulk_pending = 0;
+}
+
+static void ble_bulk_notify_next(void);
+
+static void ble_bulk_finish(void)
+{
+    if (ble_bulk_benchmark && (ble_bulk_state == BLE_BULK_COC))
+    {
+        ble_bulk_state = BLE_BULK_NOTIFY;
+        ble_bulk_remaining = ble_bulk_bench_bytes;
+        ble_bulk_offset = 0;
+        ble_bulk_path_begin(&ble_bulk_stats.sNotify, AttGetMtu(ble_bulk_conn_id) - ATT_VALUE_NTF_LEN);
+        ble_bulk_notify_next();
+        return;
+    }
+
+    ble_bulk_state = BLE_BULK_IDLE;
+    ble_bulk_benchmark = false;
+    ble_bulk_producer = NULL;
+
+    taskENTER_CRITICAL();
+    ble_bulk_stats.bRunning = false;
+    taskEXIT_CRITICAL();
+}
+
+static void ble_bulk_coc_next(void)
+{
+    uint16_t ui16Size;
+
+    ui16Size = (ble_bulk_peer_mtu < BLE_BULK_SDU_SIZE) ? ble_bulk_peer_mtu : BLE_BULK_SDU_SIZE;
+    ble_bulk_pending = ble_bulk_producer(ble_bulk_sdu, ui16Size);
+    if (ble_bulk_pending == 0)
+    {
+        ble_bulk_finish();
+        return;
+    }
+
+    ble_bulk_sent = am_hal_stimer_counter_get();
+    L2cCocDataReq(ble_bulk_cid, ble_bulk_pending, ble_bulk_sdu);
+}
+
+static void ble_bulk_notify_next(void)
+{
+    uint16_t ui16Size;
+
+    if (AppConnIsOpen() != ble_bulk_conn_id)
+    {
+        ble_bulk_finish();
+        return;
+    }
+
+    ui16Size = AttGetMtu(ble_bulk_conn_id) - ATT_VALUE_NTF_LEN;
+    ble_bulk_pending = ble_bulk_pattern(ble_bulk_sdu, ui16Size);
+    if (ble_bulk_pending == 0)
+    {
+        ble_bulk_finish();
+        return;
+    }
+
+    ble_bulk_sent = am_hal_stimer_counter_get();
+    AttsHandleValueNtf(ble_bulk_conn_id, WDXS_FTD_HDL, ble_bulk_pending, ble_bulk_sdu);
+}
+
+static void ble_bulk_coc_cback(l2cCocEvt_t *pMsg)
+{
+    switch (pMsg->hdr.event)
+    {
+    case L2C_COC_CONNECT_IND:
+        ble_bulk_cid = pMsg->connectInd.cid;
+        ble_bulk_peer_mtu = pMsg->connectInd.peerMtu;
+        ble_bulk_conn_id = (dmConnId_t)pMsg->hdr.param;
+
+        taskENTER_CRITICAL();
+        ble_bulk_stats.bConnected = true;
+        ble_bulk_stats.ui16PeerMtu = ble_bulk_peer_mtu;
+        taskEXIT_CRITICAL();
+        break;
+
+    case L2C_COC_DISCONNECT_IND:
+        if (pMsg->disconnectInd.cid != ble_bulk_cid)
+        {
+            break;
+        }
+
+        ble_bulk_cid = L2C_COC_CID_NONE;
+
+        taskENTER_CRITICAL();
+        ble_bulk_stats.bConnected = false;
+        taskEXIT_CRITICAL();
+
+        if (ble_bulk_state == BLE_BULK_COC)
+        {
+            ble_bulk_path_confirm(L2C_COC_DATA_ERR_OVERFLOW);
+            ble_bulk_benchmark = false;
+            ble_bulk_finish();
+        }
+        break;
+
+    case L2C_COC_DATA_CNF:
+        if ((ble_bulk_state != BLE_BULK_COC) || (pMsg->dataCnf.cid != ble_bulk_cid))
+        {
+            break;
+        }
+
+        ble_bulk_path_confirm(pMsg->hdr.status);
+        if (pMsg->hdr.status == L2C_COC_DATA_SUCCESS)
+        {
+            ble_bulk_coc_next();
+        }
+        else
+        {
+            ble_bulk_benchmark = false;
+            ble_bulk_finish();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+//
+// Called from the application ATT callback ahead of WDXS so the benchmark
+// notifications on the file transfer data handle are not seen as a transfer.
+//
+bool ble_bulk_att_cback(attEvt_t *pEvt)
+{
+    if ((ble_bulk_state != BLE_BULK_NOTIFY) || (pEvt->hdr.event != ATTS_HANDLE_VALUE_CNF) ||
+        (pEvt->handle != WDXS_FTD_HDL))
+    {
+        return false;
+    }
+
+    ble_bulk_path_confirm(pEvt->hdr.status);
+    if (pEvt->hdr.status == ATT_SUCCESS)
+    {
+        ble_bulk_notify_next();
+    }
+    else
+    {
+        ble_bulk_finish();
+    }
+
+    return true;
+}
+
+void ble_bulk_init(void)
+{
+    l2cCocReg_t sReg;
+
+    sReg.psm = BLE_BULK_PSM;
+    sReg.mps = BLE_BULK_MPS;
+    sReg.mtu = BLE_BULK_SDU_SIZE;
+    sReg.credits = BLE_BULK_CREDITS;
+    sReg.authoriz = FALSE;
+    sReg.secLevel = DM_SEC_LEVEL_NONE;
+    sReg.role = L2C_COC_ROLE_ACCEPTOR;
+
+    L2cCocRegister(ble_bulk_coc_cback, &sReg);
+}
+
+bool ble_bulk_start(ble_bulk_producer_t pfnProducer)
+{
+    if ((ble_bulk_state != BLE_BULK_IDLE) || (ble_bulk_cid == L2C_COC_CID_NONE))
+    {
+        return false;
+    }
+
+    ble_bulk_producer = pfnProducer;
+    ble_bulk_state = BLE_BULK_COC;
+    ble_bulk_path_begin(&ble_bulk_stats.sCoc, (ble_bulk_peer_mtu < BLE_BULK_SDU_SIZE) ?
+                                                  ble_bulk_peer_mtu : BLE_BULK_SDU_SIZE);
+    ble_bulk_coc_next();
+
+    return true;
+}
+
+//
+// Stop asking the producer for data.  An SDU already handed to L2CAP still
+// goes out and its confirm is ignored.
+//
+void ble_bulk_stop(void)
+{
+    ble_bulk_benchmark = false;
+    ble_bulk_finish();
+}
+
+//
+// A new run always starts from scratch, so a run left hanging by a dropped
+// connection is recovered by starting another one.
+//
+void ble_bulk_bench(uint32_t ui32Bytes)
+{
+    ble_bulk_stop();
+
+    taskENTER_CRITICAL();
+    memset(&ble_bulk_stats.sCoc, 0, sizeof(ble_bulk_path_statistics_t));
+    memset(&ble_bulk_stats.sNotify, 0, sizeof(ble_bulk_path_statistics_t));
+    taskEXIT_CRITICAL();
+
+    ble_bulk_conn_id = AppConnIsOpen();
+    if (ble_bulk_conn_id == DM_CONN_ID_NONE)
+    {
+        return;
+    }
+
+    ble_bulk_bench_bytes = ui32Bytes;
+    ble_bulk_remaining = ui32Bytes;
+    ble_bulk_offset = 0;
+    ble_bulk_benchmark = true;
+
+    if (!ble_bulk_start(ble_bulk_pattern))
+    {
+        //
+        // No channel open, only the notification path can be measured.
+        //
+        ble_bulk_state = BLE_BULK_COC;
+        ble_bulk_finish();
+    }
+}
+
+void ble_bulk_get_statistics(ble_bulk_statistics_t *psStats)
+{
+    taskENTER_CRITICAL();
+    memcpy(psStats, &ble_bulk_stats, sizeof(ble_bulk_statistics_t));
+    taskEXIT_CRITICAL();
+}
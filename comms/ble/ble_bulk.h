@@ -0,0 +1,76 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _BLE_BULK_H_
+#define _BLE_BULK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <att_api.h>
+
+//
+// Fill pui8Buffer with up to ui16Size bytes of the stream and return the
+// number written.  Returning zero ends the stream.
+//
+typedef uint16_t (*ble_bulk_producer_t)(uint8_t *pui8Buffer, uint16_t ui16Size);
+
+typedef struct
+{
+    uint32_t ui32Bytes;
+    uint32_t ui32Units;
+    uint32_t ui32UnitSize;
+    uint32_t ui32DurationUs;
+    uint32_t ui32LatencyAvgUs;
+    uint32_t ui32LatencyMaxUs;
+    uint32_t ui32Errors;
+} ble_bulk_path_statistics_t;
+
+typedef struct
+{
+    bool bConnected;
+    bool bRunning;
+    uint16_t ui16PeerMtu;
+    ble_bulk_path_statistics_t sCoc;
+    ble_bulk_path_statistics_t sNotify;
+} ble_bulk_statistics_t;
+
+//
+// Everything except ble_bulk_get_statistics must be called from the BLE task.
+//
+extern void ble_bulk_init(void);
+extern bool ble_bulk_start(ble_bulk_producer_t pfnProducer);
+extern void ble_bulk_stop(void);
+extern void ble_bulk_bench(uint32_t ui32Bytes);
+extern bool ble_bulk_att_cback(attEvt_t *pEvt);
+extern void ble_bulk_get_statistics(ble_bulk_statistics_t *psStats);
+
+#endif
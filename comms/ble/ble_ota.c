@@ -0,0 +1,600 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <queue.h>
+#include <task.h>
+
+#include <wsf_types.h>
+#include <wsf_assert.h>
+#include <wsf_efs.h>
+#include <util/crc32.h>
+#include <util/wstr.h>
+#include <wdx_defs.h>
+#include <wdxs/wdxs_api.h>
+
+#include "ble_config.h"
+#include "ota_config.h"
+
+#include "ble_ota.h"
+
+//
+// WDXS writes land in one of two page sized RAM buffers.  Full pages are
+// handed to a low priority task that erases ahead of the write cursor and
+// programs them, so the BLE task only waits on flash when both buffers are
+// still queued.  While it waits the controller holds the peer off with link
+// layer flow control, which is the only back-pressure WDXS has.  The wait is
+// bounded by BLE_OTA_WAIT_MS so a stuck flash cannot stall the WSF dispatcher;
+// past it the media operation fails and WDXS reports the error to the peer.
+//
+// An erase request returns at once.  The task keeps BLE_OTA_ERASE_AHEAD pages
+// erased ahead of the write cursor, and once no page has come in for
+// BLE_OTA_IDLE_MS it erases on to the end of the request, so an erase that
+// no put follows still clears the whole file.  Reads see the part still to
+// be erased as erased.
+//
+// The image is verified without reading flash back: the last four bytes of
+// a put are the little endian CRC-32 of everything before them, and the CRC
+// is accumulated as the data arrives.
+//
+#define BLE_OTA_PAGE_SIZE     AM_HAL_FLASH_PAGE_SIZE
+#define BLE_OTA_BUFFERS       2
+#define BLE_OTA_ERASE_AHEAD   2
+#define BLE_OTA_IDLE_MS       100
+#define BLE_OTA_PROGRAM_WORDS 512
+#define BLE_OTA_CRC_LEN       4
+#define BLE_OTA_TASK_STACK    256
+#define BLE_OTA_CLOCK_HZ      32768
+
+//
+// Enough for the OTA task to finish the page it is programming, the pages it
+// is erasing ahead and the page queued behind it.
+//
+#define BLE_OTA_WAIT_MS       250
+
+typedef struct
+{
+    uint32_t ui32Address;
+    uint32_t ui32Start;
+    uint32_t ui32End;
+    uint32_t pui32Data[BLE_OTA_PAGE_SIZE / 4];
+} ble_ota_buffer_t;
+
+static uint8_t ble_ota_media_erase(uint32_t ui32Address, uint32_t ui32Size);
+static uint8_t ble_ota_media_read(uint8_t *pui8Buffer, uint32_t ui32Address, uint32_t ui32Size);
+static uint8_t ble_ota_media_write(const uint8_t *pui8Buffer, uint32_t ui32Address, uint32_t ui32Size);
+static uint8_t ble_ota_media_command(uint8_t ui8Command, uint32_t ui32Parameter);
+
+//
+// Staging an image erases the whole OTA window, so the WSF NVM pages must not
+// fall inside it or on the page holding the OTA pointer.
+//
+#define BLE_OTA_NVM_END (WSF_NVM_START_ADDR + (WSF_NVM_NUM_OF_PAGES * WSF_NVM_PAGE_SIZE))
+
+WSF_CT_ASSERT((BLE_OTA_NVM_END <= OTA_FLASH_ADDRESS) ||
+              (WSF_NVM_START_ADDR >= (OTA_FLASH_ADDRESS + OTA_FLASH_MAX_SIZE)));
+WSF_CT_ASSERT((BLE_OTA_NVM_END <= OTA_POINTER_LOCATION) ||
+              (WSF_NVM_START_ADDR >= (OTA_POINTER_LOCATION + AM_HAL_FLASH_PAGE_SIZE)));
+
+static const wsfEfsMedia_t ble_ota_media = {
+    OTA_FLASH_ADDRESS,
+    OTA_FLASH_ADDRESS + OTA_FLASH_MAX_SIZE,
+    BLE_OTA_PAGE_SIZE,
+    NULL,
+    ble_ota_media_erase,
+    ble_ota_media_read,
+    ble_ota_media_write,
+    ble_ota_media_command};
+
+static ble_ota_buffer_t ble_ota_buffers[BLE_OTA_BUFFERS];
+static ble_ota_buffer_t *ble_ota_fill;
+
+static TaskHandle_t ble_ota_task_handle;
+static QueueHandle_t ble_ota_free_queue;
+static QueueHandle_t ble_ota_full_queue;
+
+//
+// The erased region grows from the start of the last erase request towards
+// ble_ota_limit.  Only the OTA task advances ble_ota_erased.
+//
+static volatile uint32_t ble_ota_cursor;
+static volatile uint32_t ble_ota_erased;
+static volatile uint32_t ble_ota_limit;
+
+static uint32_t ble_ota_crc;
+static uint32_t ble_ota_crc_next;
+static bool ble_ota_crc_valid;
+static uint8_t ble_ota_trailer[BLE_OTA_CRC_LEN];
+static uint32_t ble_ota_trailer_len;
+
+static ble_ota_statistics_t ble_ota_stats;
+
+static void ble_ota_erase_page(uint32_t ui32Address)
+{
+    int iStatus;
+
+    taskENTER_CRITICAL();
+    iStatus = am_hal_flash_page_erase(AM_HAL_FLASH_PROGRAM_KEY,
+                                      AM_HAL_FLASH_ADDR2INST(ui32Address),
+                                      AM_HAL_FLASH_ADDR2PAGE(ui32Address));
+    taskEXIT_CRITICAL();
+
+    ble_ota_stats.ui32Erased++;
+    if (iStatus)
+    {
+        ble_ota_stats.ui32Errors++;
+    }
+
+    //
+    // An erase request may have restarted the region meanwhile.
+    //
+    taskENTER_CRITICAL();
+    if (ble_ota_erased == ui32Address)
+    {
+        ble_ota_erased = ui32Address + BLE_OTA_PAGE_SIZE;
+    }
+    taskEXIT_CRITICAL();
+}
+
+//
+// How long the task may wait for a page before it erases the next one.
+//
+static TickType_t ble_ota_erase_wait(bool bIdle)
+{
+    uint32_t ui32Target = (ble_ota_cursor & ~(BLE_OTA_PAGE_SIZE - 1)) +
+                          (BLE_OTA_ERASE_AHEAD + 1) * BLE_OTA_PAGE_SIZE;
+
+    if (ble_ota_erased >= ble_ota_limit)
+    {
+        return portMAX_DELAY;
+    }
+
+    return (bIdle || (ble_ota_erased < ui32Target)) ? 0 : pdMS_TO_TICKS(BLE_OTA_IDLE_MS);
+}
+
+static void ble_ota_program(ble_ota_buffer_t *psBuffer)
+{
+    uint32_t ui32Word = psBuffer->ui32Start / 4;
+    uint32_t ui32End = (psBuffer->ui32End + 3) / 4;
+    uint32_t *pui32Flash = (uint32_t *)(uintptr_t)psBuffer->ui32Address;
+
+    //
+    // Normally already done ahead of time.
+    //
+    while ((ble_ota_erased <= psBuffer->ui32Address) && (ble_ota_erased < ble_ota_limit))
+    {
+        ble_ota_erase_page(ble_ota_erased);
+    }
+
+    //
+    // Program in slices so the BLE task is not locked out for a whole page.
+    //
+    while (ui32Word < ui32End)
+    {
+        uint32_t ui32Count = ui32End - ui32Word;
+        int iStatus;
+
+        if (ui32Count > BLE_OTA_PROGRAM_WORDS)
+        {
+            ui32Count = BLE_OTA_PROGRAM_WORDS;
+        }
+
+        taskENTER_CRITICAL();
+        iStatus = am_hal_flash_program_main(AM_HAL_FLASH_PROGRAM_KEY,
+                                            &psBuffer->pui32Data[ui32Word],
+                                            &pui32Flash[ui32Word],
+                                            ui32Count);
+        taskEXIT_CRITICAL();
+
+        if (iStatus)
+        {
+            ble_ota_stats.ui32Errors++;
+        }
+
+        ui32Word += ui32Count;
+    }
+
+    ble_ota_stats.ui32Pages++;
+}
+
+static void ble_ota_task(void *pvParameters)
+{
+    ble_ota_buffer_t *psBuffer;
+    TickType_t xWait;
+    bool bIdle = false;
+
+    while (1)
+    {
+        //
+        // Keep erasing ahead of the write cursor while there is nothing to
+        // program, and on to the end of the request once the peer goes
+        // quiet.  A NULL entry only wakes the task up.
+        //
+        xWait = ble_ota_erase_wait(bIdle);
+        if (xQueueReceive(ble_ota_full_queue, &psBuffer, xWait) != pdPASS)
+        {
+            bIdle = bIdle || (xWait != 0);
+            ble_ota_erase_page(ble_ota_erased);
+            continue;
+        }
+
+        bIdle = false;
+
+        if (psBuffer)
+        {
+            ble_ota_program(psBuffer);
+            xQueueSend(ble_ota_free_queue, &psBuffer, portMAX_DELAY);
+        }
+    }
+}
+
+static void ble_ota_kick(void)
+{
+    ble_ota_buffer_t *psBuffer = NULL;
+
+    if (uxQueueMessagesWaiting(ble_ota_full_queue) == 0)
+    {
+        xQueueSend(ble_ota_full_queue, &psBuffer, 0);
+    }
+}
+
+static bool ble_ota_take(uint32_t ui32Page, uint32_t ui32Offset)
+{
+    if (xQueueReceive(ble_ota_free_queue, &ble_ota_fill, 0) != pdPASS)
+    {
+        uint32_t ui32Start = am_hal_stimer_counter_get();
+        uint32_t ui32Us;
+
+        if (xQueueReceive(ble_ota_free_queue, &ble_ota_fill, pdMS_TO_TICKS(BLE_OTA_WAIT_MS)) != pdPASS)
+        {
+            ble_ota_fill = NULL;
+            ble_ota_stats.ui32Timeouts++;
+            return false;
+        }
+
+        ui32Us = (uint32_t)(((uint64_t)(am_hal_stimer_counter_get() - ui32Start) * 1000000) /
+                            BLE_OTA_CLOCK_HZ);
+        ble_ota_stats.ui32Stalls++;
+        if (ui32Us > ble_ota_stats.ui32MaxStallUs)
+        {
+            ble_ota_stats.ui32MaxStallUs = ui32Us;
+        }
+    }
+
+    memset(ble_ota_fill->pui32Data, 0xFF, sizeof(ble_ota_fill->pui32Data));
+    ble_ota_fill->ui32Address = ui32Page;
+    ble_ota_fill->ui32Start = ui32Offset;
+    ble_ota_fill->ui32End = ui32Offset;
+
+    ble_ota_kick();
+
+    return true;
+}
+
+static bool ble_ota_submit(void)
+{
+    bool bResult = true;
+
+    if (ble_ota_fill)
+    {
+        //
+        // A page that cannot be queued is dropped and its buffer recycled.
+        //
+        if (xQueueSend(ble_ota_full_queue, &ble_ota_fill, pdMS_TO_TICKS(BLE_OTA_WAIT_MS)) != pdPASS)
+        {
+            xQueueSend(ble_ota_free_queue, &ble_ota_fill, 0);
+            ble_ota_stats.ui32Timeouts++;
+            bResult = false;
+        }
+        ble_ota_fill = NULL;
+    }
+
+    return bResult;
+}
+
+//
+// Wait until every buffer that is not being filled has been programmed.
+//
+static bool ble_ota_drain(void)
+{
+    ble_ota_buffer_t *psBuffers[BLE_OTA_BUFFERS];
+    uint32_t ui32Count = ble_ota_fill ? BLE_OTA_BUFFERS - 1 : BLE_OTA_BUFFERS;
+    TickType_t xDeadline = xTaskGetTickCount() + pdMS_TO_TICKS(BLE_OTA_WAIT_MS);
+    uint32_t ui32Taken;
+
+    for (ui32Taken = 0; ui32Taken < ui32Count; ui32Taken++)
+    {
+        TickType_t xWait = xDeadline - xTaskGetTickCount();
+
+        if ((xWait > pdMS_TO_TICKS(BLE_OTA_WAIT_MS)) ||
+            (xQueueReceive(ble_ota_free_queue, &psBuffers[ui32Taken], xWait) != pdPASS))
+        {
+            ble_ota_stats.ui32Timeouts++;
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < ui32Taken; i++)
+    {
+        xQueueSend(ble_ota_free_queue, &psBuffers[i], 0);
+    }
+
+    return ui32Taken == ui32Count;
+}
+
+//
+// Everything but the last four bytes seen so far goes into the CRC, those
+// are held back as the candidate trailer.
+//
+static void ble_ota_crc_update(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Feed, ui32Held;
+
+    if ((ble_ota_trailer_len + ui32Size) <= BLE_OTA_CRC_LEN)
+    {
+        memcpy(&ble_ota_trailer[ble_ota_trailer_len], pui8Data, ui32Size);
+        ble_ota_trailer_len += ui32Size;
+        return;
+    }
+
+    ui32Feed = ble_ota_trailer_len + ui32Size - BLE_OTA_CRC_LEN;
+
+    ui32Held = (ui32Feed < ble_ota_trailer_len) ? ui32Feed : ble_ota_trailer_len;
+    ble_ota_crc = CalcCrc32(ble_ota_crc ^ 0xFFFFFFFF, ui32Held, ble_ota_trailer);
+    memmove(ble_ota_trailer, &ble_ota_trailer[ui32Held], ble_ota_trailer_len - ui32Held);
+    ble_ota_trailer_len -= ui32Held;
+
+    ui32Feed -= ui32Held;
+    ble_ota_crc = CalcCrc32(ble_ota_crc ^ 0xFFFFFFFF, ui32Feed, pui8Data);
+
+    memcpy(&ble_ota_trailer[ble_ota_trailer_len], &pui8Data[ui32Feed], ui32Size - ui32Feed);
+    ble_ota_trailer_len = BLE_OTA_CRC_LEN;
+}
+
+static uint8_t ble_ota_validate(void)
+{
+    uint32_t ui32Expected;
+
+    //
+    // At most the final partial page is still being programmed.
+    //
+    if (!ble_ota_drain())
+    {
+        return WDX_FTC_ST_VERIFICATION;
+    }
+
+    if (!ble_ota_crc_valid || (ble_ota_trailer_len != BLE_OTA_CRC_LEN) || ble_ota_stats.ui32Errors)
+    {
+        return WDX_FTC_ST_VERIFICATION;
+    }
+
+    ui32Expected = ble_ota_trailer[0] | (ble_ota_trailer[1] << 8) | (ble_ota_trailer[2] << 16) |
+                   ((uint32_t)ble_ota_trailer[3] << 24);
+
+    return (ui32Expected == ble_ota_crc) ? WDX_FTC_ST_SUCCESS : WDX_FTC_ST_VERIFICATION;
+}
+
+static uint8_t ble_ota_media_erase(uint32_t ui32Address, uint32_t ui32Size)
+{
+    //
+    // Drop any partial page of an abandoned transfer and let the OTA task
+    // erase the region lazily instead of stalling here for all of it.
+    //
+    if (ble_ota_fill)
+    {
+        xQueueSend(ble_ota_free_queue, &ble_ota_fill, 0);
+        ble_ota_fill = NULL;
+    }
+
+    if (!ble_ota_drain())
+    {
+        return WSF_EFS_FAILURE;
+    }
+
+    taskENTER_CRITICAL();
+    ble_ota_cursor = ui32Address;
+    ble_ota_erased = ui32Address;
+    ble_ota_limit = ui32Address + ui32Size;
+    taskEXIT_CRITICAL();
+
+    ble_ota_crc = 0;
+    ble_ota_crc_next = ui32Address;
+    ble_ota_crc_valid = true;
+    ble_ota_trailer_len = 0;
+
+    memset(&ble_ota_stats, 0, sizeof(ble_ota_stats));
+
+    ble_ota_kick();
+
+    return WSF_EFS_SUCCESS;
+}
+
+static uint8_t ble_ota_media_read(uint8_t *pui8Buffer, uint32_t ui32Address, uint32_t ui32Size)
+{
+    uint32_t ui32Erased, ui32Limit;
+
+    //
+    // The pages the task has yet to erase read as erased.  Taken before the
+    // copy so a page erased meanwhile is still covered.
+    //
+    taskENTER_CRITICAL();
+    ui32Erased = ble_ota_erased;
+    ui32Limit = ble_ota_limit;
+    taskEXIT_CRITICAL();
+
+    memcpy(pui8Buffer, (uint8_t *)(uintptr_t)ui32Address, ui32Size);
+
+    for (uint32_t i = 0; i < ui32Size; i++)
+    {
+        if ((ui32Address + i >= ui32Erased) && (ui32Address + i < ui32Limit))
+        {
+            pui8Buffer[i] = 0xFF;
+        }
+    }
+
+    return WSF_EFS_SUCCESS;
+}
+
+static uint8_t ble_ota_media_write(const uint8_t *pui8Buffer, uint32_t ui32Address, uint32_t ui32Size)
+{
+    //
+    // The CRC only covers a put that streams from the erase point onwards.
+    //
+    if (ui32Address != ble_ota_crc_next)
+    {
+        ble_ota_crc_valid = false;
+    }
+    ble_ota_crc_update(pui8Buffer, ui32Size);
+    ble_ota_crc_next = ui32Address + ui32Size;
+    ble_ota_stats.ui32Bytes += ui32Size;
+
+    while (ui32Size)
+    {
+        uint32_t ui32Page = ui32Address & ~(BLE_OTA_PAGE_SIZE - 1);
+        uint32_t ui32Offset = ui32Address - ui32Page;
+        uint32_t ui32Count = BLE_OTA_PAGE_SIZE - ui32Offset;
+
+        if (ble_ota_fill &&
+            ((ble_ota_fill->ui32Address != ui32Page) || (ble_ota_fill->ui32End != ui32Offset)) &&
+            !ble_ota_submit())
+        {
+            ble_ota_crc_valid = false;
+            return WSF_EFS_FAILURE;
+        }
+
+        if (ble_ota_fill == NULL)
+        {
+            ble_ota_cursor = ui32Address;
+            if (!ble_ota_take(ui32Page, ui32Offset))
+            {
+                ble_ota_crc_valid = false;
+                return WSF_EFS_FAILURE;
+            }
+        }
+
+        if (ui32Count > ui32Size)
+        {
+            ui32Count = ui32Size;
+        }
+
+        memcpy((uint8_t *)ble_ota_fill->pui32Data + ui32Offset, pui8Buffer, ui32Count);
+        ble_ota_fill->ui32End = ui32Offset + ui32Count;
+
+        if ((ble_ota_fill->ui32End == BLE_OTA_PAGE_SIZE) && !ble_ota_submit())
+        {
+            ble_ota_crc_valid = false;
+            return WSF_EFS_FAILURE;
+        }
+
+        ui32Address += ui32Count;
+        pui8Buffer += ui32Count;
+        ui32Size -= ui32Count;
+    }
+
+    return WSF_EFS_SUCCESS;
+}
+
+static uint8_t ble_ota_media_command(uint8_t ui8Command, uint32_t ui32Parameter)
+{
+    switch (ui8Command)
+    {
+    case WSF_EFS_WDXS_PUT_COMPLETE_CMD:
+        ble_ota_stats.ui32Crc = ble_ota_crc;
+        if (!ble_ota_submit())
+        {
+            ble_ota_crc_valid = false;
+            return WSF_EFS_FAILURE;
+        }
+        return WSF_EFS_SUCCESS;
+
+    case WSF_EFS_VALIDATE_CMD:
+        return ble_ota_validate();
+
+    default:
+        return WSF_EFS_FAILURE;
+    }
+}
+
+//
+// Replaces the empty default in WDXS and publishes the OTA staging area as
+// a file that can be put, verified, erased and read back.
+//
+void WdxsOtaMediaInit(void)
+{
+    wsfEsfAttributes_t sAttributes;
+
+    WsfEfsRegisterMedia(&ble_ota_media, WDX_OTA_MEDIA);
+
+    sAttributes.type = WSF_EFS_FILE_TYPE_BULK;
+    sAttributes.permissions = WSF_EFS_REMOTE_GET_PERMITTED | WSF_EFS_REMOTE_PUT_PERMITTED |
+                              WSF_EFS_REMOTE_ERASE_PERMITTED | WSF_EFS_REMOTE_VERIFY_PERMITTED |
+                              WSF_EFS_REMOTE_VISIBLE;
+    WstrnCpy(sAttributes.name, "OTA", WSF_EFS_NAME_LEN);
+    WstrnCpy(sAttributes.version, "1.0", WSF_EFS_VERSION_LEN);
+
+    WsfEfsAddFile(OTA_FLASH_MAX_SIZE, WDX_OTA_MEDIA, &sAttributes, 0);
+}
+
+void ble_ota_get_statistics(ble_ota_statistics_t *psStats)
+{
+    taskENTER_CRITICAL();
+    memcpy(psStats, &ble_ota_stats, sizeof(ble_ota_statistics_t));
+    taskEXIT_CRITICAL();
+}
+
+void ble_ota_task_create(uint32_t ui32Priority)
+{
+    ble_ota_buffer_t *psBuffer;
+
+    ble_ota_free_queue = xQueueCreate(BLE_OTA_BUFFERS, sizeof(ble_ota_buffer_t *));
+    ble_ota_full_queue = xQueueCreate(BLE_OTA_BUFFERS + 1, sizeof(ble_ota_buffer_t *));
+
+    for (uint32_t i = 0; i < BLE_OTA_BUFFERS; i++)
+    {
+        psBuffer = &ble_ota_buffers[i];
+        xQueueSend(ble_ota_free_queue, &psBuffer, 0);
+    }
+
+    ble_ota_fill = NULL;
+    ble_ota_cursor = 0;
+    ble_ota_erased = 0;
+    ble_ota_limit = 0;
+    ble_ota_crc_valid = false;
+
+    xTaskCreate(ble_ota_task, "ble ota", BLE_OTA_TASK_STACK, 0, ui32Priority, &ble_ota_task_handle);
+}
@@ -78,17 +78,22 @@ void ble_stack_init(void)
   L2cInit();
   L2cSlaveInit();
 
+  handlerId = WsfOsSetNextHandler(L2cCocHandler);
+  L2cCocHandlerInit(handlerId);
+  L2cCocInit();
+
   handlerId = WsfOsSetNextHandler(AttHandler);
   AttHandlerInit(handlerId);
   AttsInit();
   AttsIndInit();
+  AttsCoalInit();
   AttcInit();
 
   handlerId = WsfOsSetNextHandler(SmpHandler);
   SmpHandlerInit(handlerId);
   SmprInit();
   SmprScInit();
-  HciSetMaxRxAclLen(100);
+  HciSetMaxRxAclLen(251);
 
   handlerId = WsfOsSetNextHandler(AppHandler);
   AppHandlerInit(handlerId);
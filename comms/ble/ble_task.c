@@ -57,7 +57,12 @@
 #include "wdxs/wdxs_api.h"
 #include "tag/tag_api.h"
 
+#include "energy_monitor.h"
+#include "log_task.h"
+#include "radio_coex.h"
+
 #include "ble.h"
+#include "ble_bulk.h"
 #include "ble_stack.h"
 #include "ble_task.h"
 #include "ble_task_cli.h"
@@ -66,8 +71,7 @@ static TaskHandle_t ble_task_handle;
 static QueueHandle_t ble_task_command_queue;
 static uint32_t ble_stack_started;
 
-static wsfBufPoolDesc_t mainPoolDesc[] = {{16, 8}, {32, 4}, {192, 8}, {256, 8}};
-static char wsf_trace_buffer[256];
+static wsfBufPoolDesc_t mainPoolDesc[] = {{16, 8}, {32, 4}, {192, 8}, {280, 8}, {1056, 2}};
 
 void am_ble_isr(void)
 {
@@ -92,12 +96,9 @@ void WsfOsEventNotify(void)
     }
 }
 
-static uint8_t ble_task_tracer(const uint8_t *msg, long unsigned int len)
+static bool_t ble_task_tracer(const uint8_t *msg, uint32_t len)
 {
-    memcpy(wsf_trace_buffer, msg, len);
-    wsf_trace_buffer[len] = 0;
-
-    am_util_stdio_printf(wsf_trace_buffer);
+    log_write_text((const char *)msg, len);
 
     return 1;
 }
@@ -135,7 +136,9 @@ static void ble_stack_start()
     HciDrvHandlerInit(handlerId);
 
     TagStart();
+    ble_bulk_init();
 
+    energy_monitor_ble_enable(true);
     ble_stack_started = true;
 }
 
@@ -150,16 +153,33 @@ static void ble_task_handle_command()
             ble_stack_start();
             return;
         }
+
+        if ((command.eCommand == BLE_BULK_BENCH) && ble_stack_started)
+        {
+            ble_bulk_bench((uint32_t)(uintptr_t)command.pvParameters);
+            return;
+        }
     }
 }
 
 static void ble_task(void *pvParameters)
 {
+    TickType_t xDefer;
+
     ble_stack_started = false;
     ble_task_cli_register();
 
     while (1)
     {
+        // hold back the host while a LoRaWAN radio deadline is close; the
+        // controller keeps the connections and advertising running
+        xDefer = radio_coex_ble_defer();
+        if (xDefer > 0)
+        {
+            xTaskNotifyWait(0, 1, NULL, xDefer);
+            continue;
+        }
+
         ble_task_handle_command();
 
         if (ble_stack_started)
@@ -177,6 +197,7 @@ static void ble_task(void *pvParameters)
 void ble_task_create(uint32_t ui32Priority)
 {
     xTaskCreate(ble_task, "ble", 512, 0, ui32Priority, &ble_task_handle);
+    radio_coex_ble_register(ble_task_handle);
     ble_task_command_queue = xQueueCreate(8, sizeof(ble_command_t));
 }
 
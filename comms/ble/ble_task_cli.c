@@ -46,13 +46,216 @@
 #include <wsf_types.h>
 #include <wsf_trace.h>
 #include <app_api.h>
+#include <att_api.h>
 #include <app_ui.h>
+#include <wdx_defs.h>
+#include <cpm/cpm_api.h>
+
+#include "tag/tag_api.h"
 
 #include "console_task.h"
 #include "ble.h"
+#include "ble_bulk.h"
+#include "ble_ota.h"
 #include "ble_task.h"
 #include "ble_task_cli.h"
 
+//
+// Report the throughput of the last WDXS file transfer.  Run the same
+// transfer with the bulk profile on and off to compare.
+//
+static void ble_task_cli_ota_stats(char *pui8OutBuffer)
+{
+    tagXferStats_t sStats;
+    ble_ota_statistics_t sFlash;
+    uint32_t ui32Bps = 0;
+    uint32_t ui32EventsPerKB = 0;
+    bool_t bBulk;
+
+    bBulk = TagGetXferStats(&sStats);
+    ble_ota_get_statistics(&sFlash);
+
+    if (sStats.durationMs)
+    {
+        ui32Bps = (uint32_t)(((uint64_t)sStats.bytes * 1000) / sStats.durationMs);
+    }
+
+    if (sStats.bytes)
+    {
+        ui32EventsPerKB = (uint32_t)(((uint64_t)sStats.connEvents * 1024) / sStats.bytes);
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nProfile     : %s\r\n"
+                          "Last %s    : %d bytes in %d ms\r\n"
+                          "Throughput  : %d.%02d kB/s\r\n"
+                          "Conn events : %d (%d per kB)\r\n"
+                          "Interval    : %d.%02d ms\r\n"
+                          "PHY         : %s\r\n"
+                          "Data length : %d\r\n"
+                          "ATT MTU     : %d\r\n"
+                          "OTA flash   : %d pages programmed, %d erased, %d errors\r\n"
+                          "OTA stalls  : %d (longest %d us, %d timed out)\r\n"
+                          "OTA CRC     : %08X\r\n",
+                          bBulk ? "bulk" : "default",
+                          (sStats.op == WDX_FTC_OP_GET_REQ) ? "get" : "put",
+                          sStats.bytes,
+                          sStats.durationMs,
+                          ui32Bps / 1024,
+                          ((ui32Bps % 1024) * 100) / 1024,
+                          sStats.connEvents,
+                          ui32EventsPerKB,
+                          (sStats.connInterval * 125) / 100,
+                          (sStats.connInterval * 125) % 100,
+                          (sStats.phy == 2) ? "2M" : (sStats.phy == 3) ? "coded" : "1M",
+                          sStats.txOctets,
+                          sStats.mtu,
+                          sFlash.ui32Pages,
+                          sFlash.ui32Erased,
+                          sFlash.ui32Errors,
+                          sFlash.ui32Stalls,
+                          sFlash.ui32MaxStallUs,
+                          sFlash.ui32Timeouts,
+                          sFlash.ui32Crc);
+}
+
+static void ble_task_cli_ota(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    if (argc < 3)
+    {
+        return;
+    }
+
+    if (strcmp(argv[2], "stats") == 0)
+    {
+        ble_task_cli_ota_stats(pui8OutBuffer);
+    }
+    else if ((strcmp(argv[2], "bulk") == 0) && (argc > 3))
+    {
+        TagBulkEnable(strcmp(argv[3], "on") == 0);
+    }
+}
+
+#define BLE_TASK_CLI_BULK_KB 32
+
+static void ble_task_cli_bulk_path(char *pui8OutBuffer,
+                                   const char *pcName,
+                                   ble_bulk_path_statistics_t *psPath)
+{
+    uint32_t ui32Bps = 0;
+
+    if (psPath->ui32DurationUs)
+    {
+        ui32Bps = (uint32_t)(((uint64_t)psPath->ui32Bytes * 1000000) / psPath->ui32DurationUs);
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer + strlen(pui8OutBuffer),
+                          "%s\r\n"
+                          "  Transfer   : %d bytes in %d ms\r\n"
+                          "  Throughput : %d.%02d kB/s\r\n"
+                          "  Units      : %d of up to %d bytes, %d errors\r\n"
+                          "  Latency    : %d us avg, %d us max\r\n",
+                          pcName,
+                          psPath->ui32Bytes,
+                          psPath->ui32DurationUs / 1000,
+                          ui32Bps / 1024,
+                          ((ui32Bps % 1024) * 100) / 1024,
+                          psPath->ui32Units,
+                          psPath->ui32UnitSize,
+                          psPath->ui32Errors,
+                          psPath->ui32LatencyAvgUs,
+                          psPath->ui32LatencyMaxUs);
+}
+
+//
+// Compare the credit based channel with notifications on the same link.
+// The bench runs in the BLE task, so check back with stats until it is done.
+//
+static void ble_task_cli_bulk(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    ble_bulk_statistics_t sStats;
+
+    if (argc < 3)
+    {
+        return;
+    }
+
+    if (strcmp(argv[2], "bench") == 0)
+    {
+        ble_command_t command;
+        uint32_t ui32KB = BLE_TASK_CLI_BULK_KB;
+
+        if (argc > 3)
+        {
+            ui32KB = strtoul(argv[3], NULL, 0);
+        }
+
+        command.eCommand = BLE_BULK_BENCH;
+        command.pvParameters = (void *)(uintptr_t)(ui32KB * 1024);
+        ble_send_command(&command);
+    }
+    else if (strcmp(argv[2], "stats") == 0)
+    {
+        ble_bulk_get_statistics(&sStats);
+
+        am_util_stdio_sprintf(pui8OutBuffer,
+                              "\r\nChannel    : %s, peer MTU %d\r\n"
+                              "State      : %s\r\n",
+                              sStats.bConnected ? "open" : "closed",
+                              sStats.ui16PeerMtu,
+                              sStats.bRunning ? "running" : "idle");
+        ble_task_cli_bulk_path(pui8OutBuffer, "L2CAP CoC", &sStats.sCoc);
+        ble_task_cli_bulk_path(pui8OutBuffer, "Notification", &sStats.sNotify);
+    }
+}
+
+//
+// Show what the connection parameter manager traded: radio wakeups against
+// the worst case latency of the parameters in use, and where the time went.
+//
+static void ble_task_cli_cpm(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    static const char *pcProfile[CPM_NUM_PROFILES] = {"default", "low power", "throughput"};
+    cpmStats_t sStats;
+    uint32_t ui32Events;
+
+    if (!CpmGetStats(AppConnIsOpen(), &sStats))
+    {
+        strcat(pui8OutBuffer, "\r\nnot connected\r\n");
+        return;
+    }
+
+    ui32Events = sStats.connInterval * (sStats.connLatency + 1);
+    if (ui32Events == 0)
+    {
+        ui32Events = 1;
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nProfile     : %s%s\r\n"
+                          "Interval    : %d.%02d ms, latency %d\r\n"
+                          "Wakeups     : %d.%02d per s\r\n"
+                          "Worst case  : %d.%02d ms\r\n"
+                          "Time        : %d s default, %d s low power, %d s throughput\r\n"
+                          "Traffic     : %d bytes\r\n"
+                          "Switches    : %d (%d failed)\r\n",
+                          pcProfile[sStats.profile],
+                          sStats.hold ? " (held)" : "",
+                          (sStats.connInterval * 125) / 100,
+                          (sStats.connInterval * 125) % 100,
+                          sStats.connLatency,
+                          80000 / ui32Events / 100,
+                          80000 / ui32Events % 100,
+                          (ui32Events * 125) / 100,
+                          (ui32Events * 125) % 100,
+                          sStats.timeMs[CPM_PROFILE_DEFAULT] / 1000,
+                          sStats.timeMs[CPM_PROFILE_LOW_POWER] / 1000,
+                          sStats.timeMs[CPM_PROFILE_THROUGHPUT] / 1000,
+                          sStats.bytes,
+                          sStats.switches,
+                          sStats.failures);
+}
+
 static portBASE_TYPE
 ble_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command);
 
@@ -78,6 +281,10 @@ static void ble_task_cli_help(char *pui8OutBuffer, size_t argc, char **argv)
     strcat(pui8OutBuffer, "\r\n");
     strcat(pui8OutBuffer, "supported commands are:\r\n");
     strcat(pui8OutBuffer, "  adv    <start|stop>\r\n");
+    strcat(pui8OutBuffer, "  bulk   <bench [kB]|stats>\r\n");
+    strcat(pui8OutBuffer, "  cpm    connection parameter manager\r\n");
+    strcat(pui8OutBuffer, "  gatt   <index on|off|bench|coal>\r\n");
+    strcat(pui8OutBuffer, "  ota    <stats|bulk on|bulk off>\r\n");
     strcat(pui8OutBuffer, "  trace  <on|off>\r\n");
     strcat(pui8OutBuffer, "  start\r\n");
 }
@@ -106,6 +313,79 @@ static void ble_task_cli_trace(char *pui8OutBuffer, size_t argc, char **argv)
     }
 }
 
+//
+// Time the attribute lookups of a full discovery of the local database with
+// and without the ATT server index.
+//
+static void ble_task_cli_gatt_bench(char *pui8OutBuffer)
+{
+    uint32_t ui32Start;
+    uint32_t ui32Indexed, ui32Linear;
+    uint16_t ui16Lookups;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    AttsIdxEnable(false);
+    ui32Start = DWT->CYCCNT;
+    ui16Lookups = AttsIdxReplayDiscovery();
+    ui32Linear = DWT->CYCCNT - ui32Start;
+
+    AttsIdxEnable(true);
+    ui32Start = DWT->CYCCNT;
+    AttsIdxReplayDiscovery();
+    ui32Indexed = DWT->CYCCNT - ui32Start;
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nfull discovery, %d lookups\r\n"
+                          "linear  : %d cycles\r\n"
+                          "indexed : %d cycles\r\n",
+                          ui16Lookups,
+                          ui32Linear,
+                          ui32Indexed);
+}
+
+static void ble_task_cli_gatt_coal(char *pui8OutBuffer)
+{
+    attsCoalStats_t sStats;
+
+    AttsCoalGetStats(&sStats);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nnotification coalescing\r\n"
+                          "updates  : %d\r\n"
+                          "merged   : %d\r\n"
+                          "sent     : %d\r\n"
+                          "deferred : %d\r\n"
+                          "dropped  : %d\r\n",
+                          sStats.updates,
+                          sStats.merged,
+                          sStats.sent,
+                          sStats.deferred,
+                          sStats.dropped);
+}
+
+static void ble_task_cli_gatt(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    if (argc < 3)
+    {
+        return;
+    }
+
+    if (strcmp(argv[2], "bench") == 0)
+    {
+        ble_task_cli_gatt_bench(pui8OutBuffer);
+    }
+    else if (strcmp(argv[2], "coal") == 0)
+    {
+        ble_task_cli_gatt_coal(pui8OutBuffer);
+    }
+    else if ((strcmp(argv[2], "index") == 0) && (argc > 3))
+    {
+        AttsIdxEnable(strcmp(argv[3], "on") == 0);
+    }
+}
+
 static portBASE_TYPE
 ble_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
 {
@@ -122,6 +402,22 @@ ble_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *
     {
         ble_task_cli_adv(pui8OutBuffer, argc, argv);
     }
+    else if (strcmp(argv[1], "bulk") == 0)
+    {
+        ble_task_cli_bulk(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "cpm") == 0)
+    {
+        ble_task_cli_cpm(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "gatt") == 0)
+    {
+        ble_task_cli_gatt(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "ota") == 0)
+    {
+        ble_task_cli_ota(pui8OutBuffer, argc, argv);
+    }
     else if (strcmp(argv[1], "trace") == 0)
     {
         ble_task_cli_trace(pui8OutBuffer, argc, argv);
@@ -30,6 +30,23 @@
 extern "C" {
 #endif
 
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! WDXS file transfer statistics */
+typedef struct
+{
+  uint32_t    bytes;                      /*! Bytes moved by the last transfer */
+  uint32_t    durationMs;                 /*! Duration of the last transfer in ms */
+  uint32_t    connEvents;                 /*! Connection events spanned by the last transfer */
+  uint16_t    connInterval;               /*! Connection interval in 1.25ms units */
+  uint16_t    mtu;                        /*! Negotiated ATT MTU */
+  uint16_t    txOctets;                   /*! Negotiated LE data length */
+  uint8_t     phy;                        /*! Transmitter PHY */
+  uint8_t     op;                         /*! File transfer operation, get or put */
+} tagXferStats_t;
+
 /**************************************************************************************************
   Function Declarations
 **************************************************************************************************/
@@ -66,6 +83,28 @@ void TagHandlerInit(wsfHandlerId_t handlerId);
 /*************************************************************************************************/
 void TagHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Enable or disable the bulk transfer profile for WDXS file transfers.
+ *
+ *  \param  enable  TRUE to negotiate DLE, 2M PHY, a large MTU and a short interval.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void TagBulkEnable(bool_t enable);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of the last WDXS file transfer and the current link parameters.
+ *
+ *  \param  pStats  Buffer for the statistics.
+ *
+ *  \return TRUE if the bulk transfer profile is enabled.
+ */
+/*************************************************************************************************/
+bool_t TagGetXferStats(tagXferStats_t *pStats);
+
 #ifdef __cplusplus
 };
 #endif
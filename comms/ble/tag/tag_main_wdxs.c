@@ -51,6 +51,13 @@
 #include "svc_wdxs.h"
 #include "wdxs/wdxs_api.h"
 #include "wdxs/wdxs_main.h"
+#include "cpm/cpm_api.h"
+#include "tag_api.h"
+
+#include "am_mcu_apollo.h"
+
+#include "energy_monitor.h"
+#include "ble_bulk.h"
 
 /**************************************************************************************************
   Macros
@@ -63,11 +70,20 @@
 enum
 {
   TAG_RSSI_TIMER_IND = TAG_MSG_START,     /*! Read RSSI value timer expired */
+  TAG_CPM_TIMER_IND,                      /*! Connection parameter manager sample timer expired */
 };
 
 /*! Read RSSI interval in seconds */
 #define TAG_READ_RSSI_INTERVAL      3
 
+/*! Bulk transfer profile: LE data length in octets and microseconds, and ATT MTU */
+#define TAG_BULK_DATA_LEN           251
+#define TAG_BULK_DATA_TIME          2120
+#define TAG_BULK_MTU                247
+
+/*! Frequency of the STIMER used to time file transfers */
+#define TAG_XFER_CLOCK_HZ           32768
+
 /**************************************************************************************************
   Local Variables
 **************************************************************************************************/
@@ -83,6 +99,13 @@ static struct
   bdAddr_t          peerAddr;                     /* Peer address */
   uint8_t           addrType;                     /* Peer address type */
   appDbHdl_t        dbHdl;                        /* Peer device database record handle */
+  uint16_t          connInterval;                 /* Current connection interval */
+  bool_t            bulkEnabled;                  /* Use the bulk transfer profile for WDXS */
+  bool_t            xferActive;                   /* WDXS file transfer in progress */
+  uint32_t          xferStart;                    /* STIMER count at transfer start */
+  uint32_t          xferMark;                     /* STIMER count at last interval change */
+  uint32_t          xferEvents;                   /* Connection events before xferMark */
+  tagXferStats_t    xferStats;                    /* Statistics of the last transfer */
 } tagCb;
 
 /**************************************************************************************************
@@ -124,6 +147,40 @@ static const appUpdateCfg_t tagUpdateCfg =
   5                                       /*! Number of update attempts before giving up */
 };
 
+/*! traffic driven connection parameters; WDXS file transfers hold the throughput profile */
+static const cpmCfg_t tagCpmCfg =
+{
+  {
+    640,                                  /*! Low power minimum connection interval in 1.25ms units */
+    800,                                  /*! Low power maximum connection interval in 1.25ms units */
+    3,                                    /*! Low power connection latency */
+    600,                                  /*! Low power supervision timeout in 10ms units */
+    0,                                    /*! Minimum CE length */
+    0                                     /*! Maximum CE length */
+  },
+  {
+    6,                                    /*! Throughput minimum connection interval in 1.25ms units */
+    12,                                   /*! Throughput maximum connection interval in 1.25ms units */
+    0,                                    /*! Throughput connection latency */
+    400,                                  /*! Throughput supervision timeout in 10ms units */
+    0,                                    /*! Minimum CE length */
+    0                                     /*! Maximum CE length */
+  },
+  1000,                                   /*! Traffic sample period in ms */
+  2048,                                   /*! Bytes per period that select the throughput profile */
+  64,                                     /*! Bytes per period at or below which the link is idle */
+  5                                       /*! Idle periods before the low power profile */
+};
+
+/*! ATT configurable parameters (increase MTU for the bulk transfer profile) */
+static const attCfg_t tagAttCfg =
+{
+  15,                                     /*! ATT server service discovery connection idle timeout in seconds */
+  TAG_BULK_MTU,                           /*! desired ATT MTU */
+  ATT_MAX_TRANS_TIMEOUT,                  /*! transcation timeout in seconds */
+  4                                       /*! number of queued prepare writes supported by server */
+};
+
 /*! Configurable parameters for service and characteristic discovery */
 static const appDiscCfg_t tagDiscCfg =
 {
@@ -377,6 +434,9 @@ static void tagAttCback(attEvt_t *pEvt)
 {
   attEvt_t *pMsg;
 
+  if (ble_bulk_att_cback(pEvt))
+    return;
+
   if (WdxsAttCback(pEvt))
     return;
 
@@ -925,6 +985,86 @@ static void tagDiscCback(dmConnId_t connId, uint8_t status)
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Account for the connection events of a transfer up to now at the current interval.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void tagXferSegment(void)
+{
+  uint32_t now = am_hal_stimer_counter_get();
+
+  /* one connection event every connInterval * 1.25 ms */
+  if (tagCb.connInterval != 0)
+  {
+    tagCb.xferEvents += (uint32_t) (((uint64_t) (now - tagCb.xferMark) * 800) /
+                                    ((uint64_t) TAG_XFER_CLOCK_HZ * tagCb.connInterval));
+  }
+
+  tagCb.xferMark = now;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WDXS file transfer session callback.  Switches the link to the bulk transfer profile
+ *          while a file get or put is in progress and records the throughput.
+ *
+ *  \param  connId  Connection identifier.
+ *  \param  event   WDXS_FT_EVT_START or WDXS_FT_EVT_END.
+ *  \param  op      File transfer operation.
+ *  \param  len     Requested length on start, number of bytes transferred on end.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void tagXferCback(dmConnId_t connId, uint8_t event, uint8_t op, uint32_t len)
+{
+  if (event == WDXS_FT_EVT_START)
+  {
+    tagCb.xferActive = TRUE;
+    tagCb.xferStart = am_hal_stimer_counter_get();
+    tagCb.xferMark = tagCb.xferStart;
+    tagCb.xferEvents = 0;
+
+    if (tagCb.bulkEnabled)
+    {
+      /* the controller serializes the link layer procedures */
+      DmConnSetDataLen(connId, TAG_BULK_DATA_LEN, TAG_BULK_DATA_TIME);
+      DmSetPhy(connId, HCI_ALL_PHY_ALL_PREFERENCES, HCI_PHY_LE_2M_BIT, HCI_PHY_LE_2M_BIT,
+               HCI_PHY_OPTIONS_NONE);
+      CpmHold(connId, TRUE);
+
+      if (AttGetMtu(connId) < TAG_BULK_MTU)
+      {
+        AttcMtuReq(connId, TAG_BULK_MTU);
+      }
+    }
+  }
+  else if (tagCb.xferActive)
+  {
+    tagXferSegment();
+    tagCb.xferActive = FALSE;
+
+    WsfTaskLock();
+    tagCb.xferStats.op = op;
+    tagCb.xferStats.bytes = len;
+    tagCb.xferStats.durationMs = (uint32_t) (((uint64_t) (tagCb.xferMark - tagCb.xferStart) * 1000) /
+                                             TAG_XFER_CLOCK_HZ);
+    tagCb.xferStats.connEvents = tagCb.xferEvents;
+    WsfTaskUnlock();
+
+    /* restore 1M and let traffic select the connection parameters if the link is still up */
+    if (tagCb.bulkEnabled && DmConnInUse(connId))
+    {
+      DmSetPhy(connId, HCI_ALL_PHY_ALL_PREFERENCES, HCI_PHY_LE_1M_BIT, HCI_PHY_LE_1M_BIT,
+               HCI_PHY_OPTIONS_NONE);
+      CpmHold(connId, FALSE);
+    }
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Process messages from the event handler.
@@ -953,23 +1093,60 @@ static void tagProcMsg(dmEvt_t *pMsg)
       break;
 
     case DM_ADV_START_IND:
+      energy_monitor_ble_advertising(true);
       uiEvent = APP_UI_ADV_START;
       break;
 
     case DM_ADV_STOP_IND:
+      energy_monitor_ble_advertising(false);
       uiEvent = APP_UI_ADV_STOP;
       break;
 
     case DM_CONN_OPEN_IND:
+      energy_monitor_ble_connected(true);
+      tagCb.connInterval = pMsg->connOpen.connInterval;
+      tagCb.xferStats.connInterval = pMsg->connOpen.connInterval;
+      tagCb.xferStats.mtu = ATT_DEFAULT_MTU;
+      tagCb.xferStats.txOctets = HCI_ACL_DEFAULT_LEN;
+      tagCb.xferStats.phy = HCI_PHY_LE_1M_BIT;
       tagOpen(pMsg);
       uiEvent = APP_UI_CONN_OPEN;
       break;
 
     case DM_CONN_CLOSE_IND:
+      energy_monitor_ble_connected(false);
       tagClose(pMsg);
       uiEvent = APP_UI_CONN_CLOSE;
       break;
 
+    case DM_CONN_UPDATE_IND:
+      if (pMsg->hdr.status == HCI_SUCCESS)
+      {
+        if (tagCb.xferActive)
+        {
+          tagXferSegment();
+        }
+
+        tagCb.connInterval = pMsg->connUpdate.connInterval;
+        tagCb.xferStats.connInterval = pMsg->connUpdate.connInterval;
+      }
+      break;
+
+    case DM_PHY_UPDATE_IND:
+      if (pMsg->hdr.status == HCI_SUCCESS)
+      {
+        tagCb.xferStats.phy = pMsg->phyUpdate.txPhy;
+      }
+      break;
+
+    case DM_CONN_DATA_LEN_CHANGE_IND:
+      tagCb.xferStats.txOctets = pMsg->dataLenChange.maxTxOctets;
+      break;
+
+    case ATT_MTU_UPDATE_IND:
+      tagCb.xferStats.mtu = ((attEvt_t *) pMsg)->mtu;
+      break;
+
     case DM_SEC_PAIR_CMPL_IND:
       tagSecPairCmpl(pMsg);
       DmSecGenerateEccKeyReq();
@@ -1012,6 +1189,10 @@ static void tagProcMsg(dmEvt_t *pMsg)
       tagProcRssiTimer(pMsg);
       break;
 
+    case TAG_CPM_TIMER_IND:
+      CpmProcMsg(&pMsg->hdr);
+      break;
+
     case DM_CONN_READ_RSSI_IND:
       /* if successful */
       if (pMsg->hdr.status == HCI_SUCCESS)
@@ -1051,17 +1232,23 @@ void TagHandlerInit(wsfHandlerId_t handlerId)
   tagCb.rssiTimer.handlerId = handlerId;
   tagCb.rssiTimer.msg.event = TAG_RSSI_TIMER_IND;
   tagCb.inProgress = FALSE;
+  tagCb.bulkEnabled = TRUE;
+  tagCb.xferActive = FALSE;
 
   /* Set configuration pointers */
   pAppSlaveCfg = (appSlaveCfg_t *) &tagSlaveCfg;
   pAppAdvCfg = (appAdvCfg_t *) &tagAdvCfg;
   pAppSecCfg = (appSecCfg_t *) &tagSecCfg;
   pAppUpdateCfg = (appUpdateCfg_t *) &tagUpdateCfg;
+
+  /* Initialize the connection parameter manager */
+  CpmInit(handlerId, TAG_CPM_TIMER_IND, &tagCpmCfg);
   pAppDiscCfg = (appDiscCfg_t *) &tagDiscCfg;
   pAppCfg = (appCfg_t *) &tagAppCfg;
 
   /* Set stack configuration pointers */
   pSmpCfg = (smpCfg_t *)&tagSmpCfg;
+  pAttCfg = (attCfg_t *)&tagAttCfg;
 
   /* Initialize application framework */
   AppSlaveInit();
@@ -1111,6 +1298,9 @@ void TagHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
 
       /* process WDXS-related messages */
       WdxsProcDmMsg((dmEvt_t *) pMsg);
+
+      /* process connection parameter manager messages */
+      CpmProcMsg(pMsg);
     }
 
     /* perform profile and user interface-related operations */
@@ -1158,6 +1348,41 @@ void TagStart(void)
   /* Set the WDXS CCC Identifiers */
   WdxsSetCccIdx(WDXS_DC_CH_CCC_IDX, WDXS_AU_CH_CCC_IDX, WDXS_FTC_CH_CCC_IDX, WDXS_FTD_CH_CCC_IDX);
 
+  /* Switch to the bulk transfer profile during file transfers */
+  WdxsFtRegister(tagXferCback);
+
   /* Reset the device */
   DmDevReset();
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Enable or disable the bulk transfer profile for WDXS file transfers.
+ *
+ *  \param  enable  TRUE to negotiate DLE, 2M PHY, a large MTU and a short interval.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void TagBulkEnable(bool_t enable)
+{
+  tagCb.bulkEnabled = enable;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of the last WDXS file transfer and the current link parameters.
+ *
+ *  \param  pStats  Buffer for the statistics.
+ *
+ *  \return TRUE if the bulk transfer profile is enabled.
+ */
+/*************************************************************************************************/
+bool_t TagGetXferStats(tagXferStats_t *pStats)
+{
+  WsfTaskLock();
+  memcpy(pStats, &tagCb.xferStats, sizeof(tagXferStats_t));
+  WsfTaskUnlock();
+
+  return tagCb.bulkEnabled;
+}
@@ -40,10 +40,14 @@
 #include "lorawan_config.h"
 
 #include "console_task.h"
+#include "log_task.h"
 #include "lmh_callbacks.h"
 #include "lorawan.h"
+#include "lorawan_scheduler.h"
 #include "lorawan_task.h"
 
+extern const char *EventInfoStatusStrings[];
+
 static List_t lorawan_receive_callback_list;
 
 static void lmh_rx_callback_service(LmHandlerAppData_t *appData, LmHandlerRxParams_t *params);
@@ -103,16 +107,52 @@ static void lmh_on_join_request(LmHandlerJoinParams_t *params)
 
 static void lmh_on_tx_data(LmHandlerTxParams_t *params)
 {
+    if (params->IsMcpsConfirm)
+    {
+        lorawan_scheduler_airtime(params->TxTimeOnAir);
+    }
+
     am_util_stdio_printf("\r\n");
     DisplayTxUpdate(params);
     console_print_prompt();
 }
 
+//
+// Same output as DisplayRxUpdate() but through the deferred log so that the
+// downlink processing is not held up by the UART.
+//
+static void lmh_display_rx(LmHandlerAppData_t *appData, LmHandlerRxParams_t *params)
+{
+    static const char *const slot_strings[] = {
+        "1", "2", "C", "C Multicast", "B Ping-Slot", "B Multicast Ping-Slot"};
+
+    if (params->IsMcpsIndication == 0)
+    {
+        LOG_PRINTF("\n\r###### ========== MLME-Indication ========== ######\n\r");
+        LOG_PRINTF("STATUS      : %s\n\r", LOG_STRING(EventInfoStatusStrings[params->Status]));
+        return;
+    }
+
+    LOG_PRINTF("\n\r###### ========== MCPS-Indication ========== ######\n\r");
+    LOG_PRINTF("STATUS      : %s\n\r", LOG_STRING(EventInfoStatusStrings[params->Status]));
+    LOG_PRINTF("\n\r###### =====  DOWNLINK FRAME %8u  ===== ######\n\r", params->DownlinkCounter);
+    LOG_PRINTF("RX WINDOW   : %s\n\r", LOG_STRING(slot_strings[params->RxSlot]));
+    LOG_PRINTF("RX PORT     : %d\n\r", appData->Port);
+
+    if (appData->BufferSize != 0)
+    {
+        LOG_PRINTF("RX DATA     : \n\r");
+        LOG_HEX(appData->Buffer, appData->BufferSize);
+    }
+
+    LOG_PRINTF("\n\rDATA RATE   : DR_%d\n\r", params->Datarate);
+    LOG_PRINTF("RX RSSI     : %d\n\r", params->Rssi);
+    LOG_PRINTF("RX SNR      : %d\n\r\n\r", params->Snr);
+}
+
 static void lmh_on_rx_data(LmHandlerAppData_t *appData, LmHandlerRxParams_t *params)
 {
-    am_util_stdio_printf("\r\n");
-    DisplayRxUpdate(appData, params);
-    console_print_prompt();
+    lmh_display_rx(appData, params);
 
     lmh_rx_callback_service(appData, params);
 }
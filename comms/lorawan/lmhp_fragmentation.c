@@ -42,6 +42,7 @@
 
 #include "ota_config.h"
 
+#include "log_task.h"
 #include "lmhp_fragmentation.h"
 #include "lorawan.h"
 #include "lorawan_task.h"
@@ -51,13 +52,12 @@ static uint8_t auth_req_buffer[AUTH_REQ_BUFFER_SIZE];
 
 static void on_frag_progress(uint16_t counter, uint16_t blocks, uint8_t size, uint16_t lost)
 {
-    am_util_stdio_printf("\r\n");
-    am_util_stdio_printf("###### =========== FRAG_DECODER ============ ######\r\n");
-    am_util_stdio_printf("######               PROGRESS                ######\r\n");
-    am_util_stdio_printf("###### ===================================== ######\r\n");
-    am_util_stdio_printf("RECEIVED    : %5d / %5d Fragments\r\n", counter, blocks);
-    am_util_stdio_printf("              %5d / %5d Bytes\r\n", counter * size, blocks * size);
-    am_util_stdio_printf("LOST        :       %7d Fragments\r\n\r\n", lost);
+    LOG_PRINTF("\r\n###### =========== FRAG_DECODER ============ ######\r\n");
+    LOG_PRINTF("######               PROGRESS                ######\r\n");
+    LOG_PRINTF("###### ===================================== ######\r\n");
+    LOG_PRINTF("RECEIVED    : %5d / %5d Fragments\r\n", counter, blocks);
+    LOG_PRINTF("              %5d / %5d Bytes\r\n", counter * size, blocks * size);
+    LOG_PRINTF("LOST        :       %7d Fragments\r\n\r\n", lost);
 }
 
 static void on_frag_done(int32_t status, uint32_t size)
@@ -84,12 +84,15 @@ static void on_frag_done(int32_t status, uint32_t size)
 
 static int8_t frag_decoder_write(uint32_t offset, uint8_t *data, uint32_t size)
 {
-    uint32_t *destination = (uint32_t *)(OTA_FLASH_ADDRESS + offset);
+    uint32_t *destination = (uint32_t *)(uintptr_t)(OTA_FLASH_ADDRESS + offset);
     uint32_t source[64];
     uint32_t length = size >> 2;
 
-    am_util_stdio_printf(
-        "\r\nDecoder Write: 0x%x, 0x%x, %d\r\n", (uint32_t)destination, (uint32_t)source, length);
+    LOG_PRINTF(
+        "\r\nDecoder Write: 0x%x, 0x%x, %d\r\n",
+        (uint32_t)(uintptr_t)destination,
+        (uint32_t)(uintptr_t)source,
+        length);
     memcpy(source, data, size);
 
     taskENTER_CRITICAL();
@@ -66,14 +66,45 @@ typedef struct
     uint8_t *pui8Payload;
 } lorawan_rx_packet_t;
 
+typedef enum
+{
+    LORAWAN_TX_PRIORITY_LOW,
+    LORAWAN_TX_PRIORITY_NORMAL,
+    LORAWAN_TX_PRIORITY_HIGH,
+} lorawan_tx_priority_e;
+
+//
+// Largest application payload.  Uplinks are copied into the transmit queue,
+// so the caller's buffer can be reused as soon as lorawan_transmit returns.
+//
+#define LORAWAN_TX_PAYLOAD_MAX 242
+
 typedef struct 
 {
     LmHandlerMsgTypes_t tType;
     uint32_t    ui32Port;
     uint32_t    ui32Length;
-    uint8_t    *pui8Data;
+    uint8_t     pui8Payload[LORAWAN_TX_PAYLOAD_MAX];
+    uint32_t    ui32Priority;
+    uint32_t    ui32Lifetime;   // ms, 0 for no deadline
+    TickType_t  xTimestamp;
 } lorawan_tx_packet_t;
 
+typedef struct
+{
+    uint32_t ui32Queued;
+    uint32_t ui32QueuedPeak;
+    uint32_t ui32Sent;
+    uint32_t ui32Deferred;
+    uint32_t ui32Expired;
+    uint32_t ui32Overflow;
+    uint32_t ui32Failed;
+    uint32_t ui32NextTxDelay;       // ms
+    uint32_t ui32AirtimeTotal;      // ms
+    uint32_t ui32AirtimeLastHour;   // ms
+    uint32_t ui32AirtimeBudget;     // ms per hour
+} lorawan_tx_statistics_t;
+
 typedef enum
 {
     LORAWAN_PM_SLEEP,
@@ -101,6 +132,13 @@ extern void lorawan_set_nwk_key_by_bytes(const uint8_t *pui8NwkKey);
 extern void lorawan_get_nwk_key(uint8_t *pui8NwkKey);
 
 extern void lorawan_transmit(uint32_t ui32Port, uint32_t ui32Ack, uint32_t ui32Length, uint8_t *pui8Data);
+extern void lorawan_transmit_scheduled(uint32_t ui32Port,
+                                       uint32_t ui32Ack,
+                                       uint32_t ui32Length,
+                                       uint8_t *pui8Data,
+                                       uint32_t ui32Priority,
+                                       uint32_t ui32Lifetime);
+extern void lorawan_get_tx_statistics(lorawan_tx_statistics_t *pStatistics);
 extern QueueHandle_t lorawan_receive_register(uint32_t ui32Port, uint32_t elements);
 extern void lorawan_receive_unregister(QueueHandle_t handle);
 
@@ -0,0 +1,326 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "lorawan_config.h"
+
+#include "lorawan.h"
+#include "lorawan_scheduler.h"
+
+#define AIRTIME_BUCKET_COUNT   (6)
+#define AIRTIME_BUCKET_PERIOD  pdMS_TO_TICKS(10 * 60 * 1000)
+
+//
+// Pending uplinks are kept unordered.  The queue is short so the best
+// candidate is selected by a scan rather than maintaining a sorted list.
+//
+static lorawan_tx_packet_t scheduler_queue[LORAWAN_SCHEDULER_QUEUE_SIZE];
+static uint32_t scheduler_sequence[LORAWAN_SCHEDULER_QUEUE_SIZE];
+static uint32_t scheduler_count;
+static uint32_t scheduler_next_sequence;
+static int32_t scheduler_head_index;
+
+static bool scheduler_deferred;
+static TickType_t scheduler_next_tx;
+
+static uint32_t airtime_bucket[AIRTIME_BUCKET_COUNT];
+static uint32_t airtime_bucket_index;
+static TickType_t airtime_bucket_start;
+
+static lorawan_tx_statistics_t scheduler_statistics;
+
+static bool scheduler_has_deadline(const lorawan_tx_packet_t *pPacket)
+{
+    return pPacket->ui32Lifetime != 0;
+}
+
+static TickType_t scheduler_remaining(const lorawan_tx_packet_t *pPacket, TickType_t xNow)
+{
+    TickType_t xLifetime = pdMS_TO_TICKS(pPacket->ui32Lifetime);
+    TickType_t xElapsed = xNow - pPacket->xTimestamp;
+
+    return (xElapsed >= xLifetime) ? 0 : (xLifetime - xElapsed);
+}
+
+static void scheduler_remove(uint32_t ui32Index)
+{
+    scheduler_count--;
+    if (ui32Index != scheduler_count)
+    {
+        scheduler_queue[ui32Index] = scheduler_queue[scheduler_count];
+        scheduler_sequence[ui32Index] = scheduler_sequence[scheduler_count];
+    }
+    scheduler_head_index = -1;
+    scheduler_statistics.ui32Queued = scheduler_count;
+}
+
+//
+// Drop every message that will not be sent before xTime.
+//
+static void scheduler_expire(TickType_t xNow, TickType_t xTime)
+{
+    uint32_t i = 0;
+
+    while (i < scheduler_count)
+    {
+        lorawan_tx_packet_t *pPacket = &scheduler_queue[i];
+
+        if (scheduler_has_deadline(pPacket) &&
+            (scheduler_remaining(pPacket, xNow) <= (xTime - xNow)))
+        {
+            scheduler_remove(i);
+            scheduler_statistics.ui32Expired++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+static bool scheduler_precedes(uint32_t a, uint32_t b, TickType_t xNow)
+{
+    const lorawan_tx_packet_t *pA = &scheduler_queue[a];
+    const lorawan_tx_packet_t *pB = &scheduler_queue[b];
+
+    if (pA->ui32Priority != pB->ui32Priority)
+    {
+        return pA->ui32Priority > pB->ui32Priority;
+    }
+
+    if (scheduler_has_deadline(pA) && scheduler_has_deadline(pB))
+    {
+        TickType_t xRemainingA = scheduler_remaining(pA, xNow);
+        TickType_t xRemainingB = scheduler_remaining(pB, xNow);
+
+        if (xRemainingA != xRemainingB)
+        {
+            return xRemainingA < xRemainingB;
+        }
+    }
+    else if (scheduler_has_deadline(pA) != scheduler_has_deadline(pB))
+    {
+        return scheduler_has_deadline(pA);
+    }
+
+    return (int32_t)(scheduler_sequence[a] - scheduler_sequence[b]) < 0;
+}
+
+static void airtime_rotate(TickType_t xNow)
+{
+    TickType_t xElapsed = xNow - airtime_bucket_start;
+
+    if (xElapsed >= (AIRTIME_BUCKET_COUNT * AIRTIME_BUCKET_PERIOD))
+    {
+        memset(airtime_bucket, 0, sizeof(airtime_bucket));
+        airtime_bucket_start = xNow;
+        return;
+    }
+
+    while (xElapsed >= AIRTIME_BUCKET_PERIOD)
+    {
+        airtime_bucket_index = (airtime_bucket_index + 1) % AIRTIME_BUCKET_COUNT;
+        airtime_bucket[airtime_bucket_index] = 0;
+        airtime_bucket_start += AIRTIME_BUCKET_PERIOD;
+        xElapsed -= AIRTIME_BUCKET_PERIOD;
+    }
+}
+
+static uint32_t airtime_last_hour(TickType_t xNow)
+{
+    uint32_t ui32Stale = (xNow - airtime_bucket_start) / AIRTIME_BUCKET_PERIOD;
+    uint32_t ui32Sum = 0;
+
+    for (uint32_t i = 0; (i + ui32Stale) < AIRTIME_BUCKET_COUNT; i++)
+    {
+        ui32Sum += airtime_bucket[(airtime_bucket_index + AIRTIME_BUCKET_COUNT - i) %
+                                  AIRTIME_BUCKET_COUNT];
+    }
+
+    return ui32Sum;
+}
+
+void lorawan_scheduler_init(void)
+{
+    memset(&scheduler_statistics, 0, sizeof(lorawan_tx_statistics_t));
+    scheduler_statistics.ui32AirtimeBudget = LORAWAN_SCHEDULER_AIRTIME_BUDGET;
+
+    memset(airtime_bucket, 0, sizeof(airtime_bucket));
+    airtime_bucket_index = 0;
+    airtime_bucket_start = xTaskGetTickCount();
+
+    scheduler_next_sequence = 0;
+    lorawan_scheduler_flush();
+}
+
+void lorawan_scheduler_flush(void)
+{
+    scheduler_count = 0;
+    scheduler_head_index = -1;
+    scheduler_deferred = false;
+    scheduler_statistics.ui32Queued = 0;
+}
+
+bool lorawan_scheduler_enqueue(const lorawan_tx_packet_t *pPacket)
+{
+    if (scheduler_count == LORAWAN_SCHEDULER_QUEUE_SIZE)
+    {
+        lorawan_scheduler_overflow();
+        return false;
+    }
+
+    scheduler_queue[scheduler_count] = *pPacket;
+    scheduler_sequence[scheduler_count] = scheduler_next_sequence++;
+    scheduler_count++;
+    scheduler_head_index = -1;
+
+    scheduler_statistics.ui32Queued = scheduler_count;
+    if (scheduler_count > scheduler_statistics.ui32QueuedPeak)
+    {
+        scheduler_statistics.ui32QueuedPeak = scheduler_count;
+    }
+
+    return true;
+}
+
+lorawan_tx_packet_t *lorawan_scheduler_head(TickType_t xNow)
+{
+    scheduler_expire(xNow, xNow);
+
+    if (scheduler_count == 0)
+    {
+        return NULL;
+    }
+
+    scheduler_head_index = 0;
+    for (uint32_t i = 1; i < scheduler_count; i++)
+    {
+        if (scheduler_precedes(i, scheduler_head_index, xNow))
+        {
+            scheduler_head_index = i;
+        }
+    }
+
+    return &scheduler_queue[scheduler_head_index];
+}
+
+void lorawan_scheduler_pop(void)
+{
+    if (scheduler_head_index >= 0)
+    {
+        scheduler_remove(scheduler_head_index);
+    }
+}
+
+void lorawan_scheduler_defer(TickType_t xNow, uint32_t ui32Delay)
+{
+    scheduler_deferred = true;
+    scheduler_next_tx = xNow + pdMS_TO_TICKS(ui32Delay);
+    scheduler_statistics.ui32Deferred++;
+
+    scheduler_expire(xNow, scheduler_next_tx);
+}
+
+bool lorawan_scheduler_ready(TickType_t xNow)
+{
+    if (scheduler_deferred && ((int32_t)(xNow - scheduler_next_tx) < 0))
+    {
+        return false;
+    }
+
+    scheduler_deferred = false;
+    return true;
+}
+
+TickType_t lorawan_scheduler_timeout(TickType_t xNow)
+{
+    if ((scheduler_count == 0) || !scheduler_deferred)
+    {
+        return portMAX_DELAY;
+    }
+
+    if ((int32_t)(scheduler_next_tx - xNow) <= 0)
+    {
+        return 0;
+    }
+
+    return scheduler_next_tx - xNow;
+}
+
+//
+// Also called from the sender's context when the transmit queue is full.
+//
+void lorawan_scheduler_overflow(void)
+{
+    taskENTER_CRITICAL();
+    scheduler_statistics.ui32Overflow++;
+    taskEXIT_CRITICAL();
+}
+
+void lorawan_scheduler_sent(void)
+{
+    scheduler_statistics.ui32Sent++;
+}
+
+void lorawan_scheduler_failed(void)
+{
+    scheduler_statistics.ui32Failed++;
+}
+
+void lorawan_scheduler_airtime(uint32_t ui32TimeOnAir)
+{
+    airtime_rotate(xTaskGetTickCount());
+    airtime_bucket[airtime_bucket_index] += ui32TimeOnAir;
+    scheduler_statistics.ui32AirtimeTotal += ui32TimeOnAir;
+}
+
+void lorawan_scheduler_statistics(lorawan_tx_statistics_t *pStatistics)
+{
+    TickType_t xNow = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+
+    *pStatistics = scheduler_statistics;
+    pStatistics->ui32AirtimeLastHour = airtime_last_hour(xNow);
+    pStatistics->ui32NextTxDelay = 0;
+    if (scheduler_deferred && ((int32_t)(scheduler_next_tx - xNow) > 0))
+    {
+        pStatistics->ui32NextTxDelay = (scheduler_next_tx - xNow) * portTICK_PERIOD_MS;
+    }
+
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,60 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _LORAWAN_SCHEDULER_H_
+#define _LORAWAN_SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <FreeRTOS.h>
+
+#include "lorawan.h"
+
+extern void lorawan_scheduler_init(void);
+extern void lorawan_scheduler_flush(void);
+
+extern bool lorawan_scheduler_enqueue(const lorawan_tx_packet_t *pPacket);
+extern lorawan_tx_packet_t *lorawan_scheduler_head(TickType_t xNow);
+extern void lorawan_scheduler_pop(void);
+
+extern void lorawan_scheduler_defer(TickType_t xNow, uint32_t ui32Delay);
+extern bool lorawan_scheduler_ready(TickType_t xNow);
+extern TickType_t lorawan_scheduler_timeout(TickType_t xNow);
+
+extern void lorawan_scheduler_overflow(void);
+extern void lorawan_scheduler_sent(void);
+extern void lorawan_scheduler_failed(void);
+extern void lorawan_scheduler_airtime(uint32_t ui32TimeOnAir);
+
+extern void lorawan_scheduler_statistics(lorawan_tx_statistics_t *pStatistics);
+
+#endif
@@ -52,12 +52,17 @@
 #include <LmhpRemoteMcastSetup.h>
 #include <board.h>
 #include <radio.h>
+#include <sx126x.h>
 
 #include "lorawan.h"
 #include "lorawan_config.h"
 
+#include "energy_monitor.h"
+#include "radio_coex.h"
+
 #include "lmh_callbacks.h"
 #include "lmhp_fragmentation.h"
+#include "lorawan_scheduler.h"
 #include "lorawan_task.h"
 #include "lorawan_task_cli.h"
 
@@ -74,7 +79,7 @@ static QueueHandle_t lorawan_task_command_queue;
 static QueueHandle_t lorawan_task_transmit_queue;
 static TimerHandle_t lorawan_spi_port_timer;
 
-#define LM_BUFFER_SIZE 242
+#define LM_BUFFER_SIZE LORAWAN_TX_PAYLOAD_MAX
 static uint8_t psLmDataBuffer[LM_BUFFER_SIZE];
 
 static LmHandlerParams_t lmh_parameters;
@@ -123,32 +128,73 @@ static void lorawan_task_handle_power_management(lorawan_pm_state_e state)
 
 static void lorawan_task_handle_uplink()
 {
+    // Static to keep the payload off the task stack.
+    static lorawan_tx_packet_t packet;
+    lorawan_tx_packet_t *pPacket;
+    TimerTime_t delay;
+    TickType_t now;
+
+    while (xQueueReceive(lorawan_task_transmit_queue, &packet, 0) == pdPASS)
+    {
+        lorawan_scheduler_enqueue(&packet);
+    }
+
     if (LmhpRemoteMcastSessionStateStarted())
     {
         return;
     }
 
-    lorawan_tx_packet_t packet;
-    if (xQueuePeek(lorawan_task_transmit_queue, &packet, 0) == pdPASS)
+    now = xTaskGetTickCount();
+    if (lorawan_scheduler_ready(now) == false)
     {
-        if (LmHandlerIsBusy() == true)
-        {
-            return;
-        }
+        return;
+    }
 
-        xQueueReceive(lorawan_task_transmit_queue, &packet, 0);
+    pPacket = lorawan_scheduler_head(now);
+    if (pPacket == NULL)
+    {
+        return;
+    }
 
-        LmHandlerAppData_t app_data;
+    if (LmHandlerIsBusy() == true)
+    {
+        return;
+    }
 
-        if (packet.ui32Length > 0)
-        {
-            memcpy(psLmDataBuffer, packet.pui8Data, packet.ui32Length);
-        }
-        app_data.Port = packet.ui32Port;
-        app_data.BufferSize = packet.ui32Length;
-        app_data.Buffer = psLmDataBuffer;
+    // Ask the MAC when the bands will have enough credits for this frame at
+    // the current datarate and sleep until then instead of letting the
+    // request fail.
+    if ((LoRaMacQueryNextTxDelay(pPacket->ui32Length, &delay) == LORAMAC_STATUS_OK) &&
+        (delay > 0))
+    {
+        lorawan_scheduler_defer(now, delay);
+        return;
+    }
+
+    LmHandlerAppData_t app_data;
+
+    if (pPacket->ui32Length > 0)
+    {
+        memcpy(psLmDataBuffer, pPacket->pui8Payload, pPacket->ui32Length);
+    }
+    app_data.Port = pPacket->ui32Port;
+    app_data.BufferSize = pPacket->ui32Length;
+    app_data.Buffer = psLmDataBuffer;
 
-        LmHandlerSend(&app_data, packet.tType);
+    energy_monitor_lora_port(pPacket->ui32Port);
+    if (LmHandlerSend(&app_data, pPacket->tType) == LORAMAC_HANDLER_SUCCESS)
+    {
+        lorawan_scheduler_pop();
+        lorawan_scheduler_sent();
+    }
+    else if (LmHandlerGetDutyCycleWaitTime() > 0)
+    {
+        lorawan_scheduler_defer(now, LmHandlerGetDutyCycleWaitTime());
+    }
+    else
+    {
+        lorawan_scheduler_pop();
+        lorawan_scheduler_failed();
     }
 }
 
@@ -251,6 +297,7 @@ void lorawan_stack_stop()
     BoardDeInitMcu();
     lorawan_task_handle_power_management(LORAWAN_PM_SLEEP);
     xQueueReset(lorawan_task_transmit_queue);
+    lorawan_scheduler_flush();
 
     lorawan_stack_started = false;
     lorawan_spi_port_powered = false;
@@ -266,6 +313,50 @@ void lorawan_wake_on_timer_irq()
     lorawan_task_wake();
 }
 
+void lorawan_radio_mode_changed(uint32_t ui32Mode, int8_t i8TxPower)
+{
+    switch (ui32Mode)
+    {
+    case MODE_SLEEP:
+        energy_monitor_lora_state(ENERGY_LORA_SLEEP, 0);
+        break;
+    case MODE_STDBY_RC:
+    case MODE_STDBY_XOSC:
+    case MODE_FS:
+        energy_monitor_lora_state(ENERGY_LORA_STANDBY, 0);
+        break;
+    case MODE_TX:
+        energy_monitor_lora_state(ENERGY_LORA_TX, i8TxPower);
+        break;
+    case MODE_RX:
+    case MODE_RX_DC:
+    case MODE_CAD:
+        energy_monitor_lora_state(ENERGY_LORA_RX, 0);
+        break;
+    }
+}
+
+//
+// Report the next MAC radio deadline to the coexistence arbiter and return
+// how long the task may block.
+//
+static TickType_t lorawan_task_timeout()
+{
+    TimerTime_t deadline = TIMERTIME_T_MAX;
+    TickType_t scheduler;
+    TickType_t coex;
+
+    if (lorawan_stack_started)
+    {
+        LoRaMacQueryNextRadioEvent(&deadline);
+    }
+
+    scheduler = lorawan_scheduler_timeout(xTaskGetTickCount());
+    coex = radio_coex_lorawan_deadline(deadline);
+
+    return (coex < scheduler) ? coex : scheduler;
+}
+
 static void lorawan_task(void *pvParameters)
 {
     lorawan_stack_started = false;
@@ -283,7 +374,7 @@ static void lorawan_task(void *pvParameters)
 
         lorawan_task_handle_power_management(LORAWAN_PM_SLEEP);
 
-        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+        ulTaskNotifyTake(pdFALSE, lorawan_task_timeout());
 
         lorawan_task_handle_power_management(LORAWAN_PM_WAKE);
     }
@@ -292,9 +383,11 @@ static void lorawan_task(void *pvParameters)
 void lorawan_task_create(uint32_t ui32Priority)
 {
     xTaskCreate(lorawan_task, "lorawan", 512, 0, ui32Priority, &lorawan_task_handle);
+    radio_coex_lorawan_register(lorawan_task_handle);
 
     lorawan_task_command_queue = xQueueCreate(8, sizeof(lorawan_command_t));
     lorawan_task_transmit_queue = xQueueCreate(8, sizeof(lorawan_tx_packet_t));
+    lorawan_scheduler_init();
 
     lorawan_spi_port_timer = xTimerCreate(
         "LoRaWAN Port Timer",
@@ -338,31 +431,55 @@ void lorawan_send_command(lorawan_command_t *pCommand)
 }
 
 void lorawan_transmit(uint32_t ui32Port, uint32_t ui32Ack, uint32_t ui32Length, uint8_t *pui8Data)
+{
+    lorawan_transmit_scheduled(
+        ui32Port, ui32Ack, ui32Length, pui8Data, LORAWAN_TX_PRIORITY_NORMAL, 0);
+}
+
+void lorawan_transmit_scheduled(uint32_t ui32Port,
+                                uint32_t ui32Ack,
+                                uint32_t ui32Length,
+                                uint8_t *pui8Data,
+                                uint32_t ui32Priority,
+                                uint32_t ui32Lifetime)
 {
     lorawan_tx_packet_t packet;
 
+    if (ui32Length > LORAWAN_TX_PAYLOAD_MAX)
+    {
+        return;
+    }
+
     packet.tType = ui32Ack ? LORAMAC_HANDLER_CONFIRMED_MSG : LORAMAC_HANDLER_UNCONFIRMED_MSG;
     packet.ui32Port = ui32Port;
     packet.ui32Length = ui32Length;
+    packet.ui32Priority = ui32Priority;
+    packet.ui32Lifetime = ui32Lifetime;
+    packet.xTimestamp = xTaskGetTickCount();
 
     if (ui32Length > 0)
     {
-        packet.pui8Data = pui8Data;
-    }
-    else
-    {
-        packet.pui8Data = NULL;
+        memcpy(packet.pui8Payload, pui8Data, ui32Length);
     }
 
     // prevent context switch until task notification is completed
     //taskENTER_CRITICAL();
 
-    xQueueSend(lorawan_task_transmit_queue, &packet, 0);
+    if (xQueueSend(lorawan_task_transmit_queue, &packet, 0) != pdPASS)
+    {
+        lorawan_scheduler_overflow();
+        return;
+    }
     lorawan_task_wake();
 
     //taskEXIT_CRITICAL();
 }
 
+void lorawan_get_tx_statistics(lorawan_tx_statistics_t *pStatistics)
+{
+    lorawan_scheduler_statistics(pStatistics);
+}
+
 void lorawan_power_management_register(lorawan_power_management_t pHandler)
 {
     lorawan_pm_callback = pHandler;
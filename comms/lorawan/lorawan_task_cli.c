@@ -87,9 +87,9 @@ static void print_hex_array(char *pui8OutBuffer, uint8_t *array, uint32_t length
 
 static void periodic_transmit_callback(TimerHandle_t handle)
 {
-    uint32_t ui32Count = (uint32_t)pvTimerGetTimerID(handle);
+    uint32_t ui32Count = (uint32_t)(uintptr_t)pvTimerGetTimerID(handle);
     ui32Count++;
-    vTimerSetTimerID(handle, (void *)ui32Count);
+    vTimerSetTimerID(handle, (void *)(uintptr_t)ui32Count);
 
     am_util_stdio_sprintf((char *)lorawan_cli_transmit_buffer, "%d", ui32Count);
     uint32_t length = strlen((char *)lorawan_cli_transmit_buffer);
@@ -150,6 +150,7 @@ static void lorawan_task_cli_help(char *pui8OutBuffer, size_t argc, char **argv)
     strcat(pui8OutBuffer, "  keys\r\n");
     strcat(pui8OutBuffer, "  periodic\r\n");
     strcat(pui8OutBuffer, "  send\r\n");
+    strcat(pui8OutBuffer, "  stats    uplink queue and airtime statistics\r\n");
 }
 
 static void lorawan_task_cli_class(char *pui8OutBuffer, size_t argc, char **argv)
@@ -367,6 +368,35 @@ static void lorawan_task_cli_send(char *pui8OutBuffer, size_t argc, char **argv)
     lorawan_transmit(port, ack, length, lorawan_cli_transmit_buffer);
 }
 
+static void lorawan_task_cli_stats(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    lorawan_tx_statistics_t stats;
+
+    lorawan_get_tx_statistics(&stats);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\n\rQueued      : %d (peak %d)\n\r"
+                          "Sent        : %d\n\r"
+                          "Deferred    : %d (next in %d ms)\n\r"
+                          "Dropped     : %d expired, %d overflow, %d failed\n\r"
+                          "Airtime     : %d ms total\n\r"
+                          "Last Hour   : %d / %d ms (%d%%)\n\r",
+                          stats.ui32Queued,
+                          stats.ui32QueuedPeak,
+                          stats.ui32Sent,
+                          stats.ui32Deferred,
+                          stats.ui32NextTxDelay,
+                          stats.ui32Expired,
+                          stats.ui32Overflow,
+                          stats.ui32Failed,
+                          stats.ui32AirtimeTotal,
+                          stats.ui32AirtimeLastHour,
+                          stats.ui32AirtimeBudget,
+                          stats.ui32AirtimeBudget
+                              ? (stats.ui32AirtimeLastHour * 100) / stats.ui32AirtimeBudget
+                              : 0);
+}
+
 static portBASE_TYPE
 lorawan_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
 {
@@ -425,6 +455,10 @@ lorawan_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const ch
     {
         lorawan_task_cli_port(pui8OutBuffer, argc, argv);
     }
+    else if (strcmp(argv[1], "stats") == 0)
+    {
+        lorawan_task_cli_stats(pui8OutBuffer, argc, argv);
+    }
 
     return pdFALSE;
 }
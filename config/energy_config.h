@@ -0,0 +1,84 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _ENERGY_CONFIG_H_
+#define _ENERGY_CONFIG_H_
+
+/*
+ * Time base of the energy accounting.  The STIMER runs from the 32kHz
+ * crystal and keeps counting in deep sleep.
+ */
+#define ENERGY_CLOCK_HZ                 32768
+
+/*
+ * Seconds between forced samples of every subsystem.  Must be well below the
+ * STIMER wrap period of 2^32 / ENERGY_CLOCK_HZ seconds.
+ */
+#define ENERGY_SAMPLE_PERIOD            3600
+
+/*
+ * Supply currents in uA used to integrate charge for each state.  These are
+ * typical figures and should be calibrated against the target board.
+ */
+#define ENERGY_MCU_RUN_CURRENT          290
+#define ENERGY_MCU_SLEEP_CURRENT        100
+#define ENERGY_MCU_DEEP_SLEEP_CURRENT   3
+
+#define ENERGY_LORA_SLEEP_CURRENT       1
+#define ENERGY_LORA_STANDBY_CURRENT     600
+#define ENERGY_LORA_RX_CURRENT          4600
+
+/*
+ * SX1262 transmit current by output power.  The first entry whose power is
+ * greater than or equal to the requested power is used.
+ */
+#define ENERGY_LORA_TX_TABLE                                                   \
+    {                                                                          \
+        {0, 18000}, {10, 32000}, {14, 45000}, {17, 58000}, {20, 84000},        \
+        {22, 118000},                                                          \
+    }
+
+#define ENERGY_BLE_OFF_CURRENT          0
+#define ENERGY_BLE_IDLE_CURRENT         1
+#define ENERGY_BLE_ADVERTISING_CURRENT  60
+#define ENERGY_BLE_CONNECTED_CURRENT    35
+
+/*
+ * Number of LoRaWAN FPorts tracked individually.
+ */
+#define ENERGY_LORAWAN_PORTS            8
+
+/*
+ * FPort used by "energy send" for the binary report uplink.
+ */
+#define ENERGY_REPORT_PORT              10
+
+#endif
@@ -43,4 +43,7 @@
 #define LORAWAN_CLOCK_SOURCE    AM_HAL_STIMER_XTAL_32KHZ
 #define LORAWAN_CLOCK_PERIOD    32768
 
+#define LORAWAN_SCHEDULER_QUEUE_SIZE      (8)
+#define LORAWAN_SCHEDULER_AIRTIME_BUDGET  (36000)   // ms per hour, 1% duty cycle
+
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _SLEEP_CONFIG_H_
+#define _SLEEP_CONFIG_H_
+
+/*
+ * Deep sleep wake latency in us assumed until it has been measured.  Normal
+ * sleep is assumed to wake at once.
+ */
+#define SLEEP_DEEP_LATENCY_US           40
+
+/*
+ * Weight of a new wake latency sample, as a power of two: each sample moves
+ * the estimate by 1/2^SLEEP_LATENCY_SHIFT of its error.
+ */
+#define SLEEP_LATENCY_SHIFT             3
+
+/*
+ * Wake latency samples above this are taken to be a wakeup by another
+ * interrupt rather than by the timer, and discarded.
+ */
+#define SLEEP_LATENCY_MAX_US            2000
+
+/*
+ * Peripherals whose power state changes the cost of a deep sleep: the IOM
+ * of the SX1262 and the console UART.
+ */
+#define SLEEP_RADIO_PERIPH              AM_HAL_PWRCTRL_PERIPH_IOM3
+#define SLEEP_CONSOLE_PERIPH            AM_HAL_PWRCTRL_PERIPH_UART0
+
+/*
+ * Number of idle duration histogram bins.  Bin 0 holds idles under 1 ms,
+ * bin n those from 2^(n-1) ms up to 2^n ms and the last bin everything
+ * longer.
+ */
+#define SLEEP_HISTOGRAM_BINS            12
+
+#endif
@@ -0,0 +1,476 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+
+#include <FreeRTOS.h>
+#include <timers.h>
+
+#include "energy_config.h"
+#include "energy_monitor.h"
+
+#define ENERGY_REPORT_VERSION 1
+
+typedef struct
+{
+    int8_t i8Power;
+    uint32_t ui32Current;
+} energy_tx_current_t;
+
+typedef struct
+{
+    uint32_t ui32State;
+    uint32_t ui32Current;
+    uint32_t ui32Timestamp;
+    uint64_t ui64Charge;
+    uint64_t ui64Time[ENERGY_STATE_MAX];
+} energy_subsystem_t;
+
+static energy_tx_current_t energy_tx_table[] = ENERGY_LORA_TX_TABLE;
+static uint32_t energy_tx_override;
+
+static uint32_t energy_current_table[ENERGY_SUBSYSTEM_MAX][ENERGY_STATE_MAX] = {
+    [ENERGY_SUBSYSTEM_MCU] =
+        {
+            [ENERGY_MCU_RUN] = ENERGY_MCU_RUN_CURRENT,
+            [ENERGY_MCU_SLEEP] = ENERGY_MCU_SLEEP_CURRENT,
+            [ENERGY_MCU_DEEP_SLEEP] = ENERGY_MCU_DEEP_SLEEP_CURRENT,
+        },
+    [ENERGY_SUBSYSTEM_LORAWAN] =
+        {
+            [ENERGY_LORA_SLEEP] = ENERGY_LORA_SLEEP_CURRENT,
+            [ENERGY_LORA_STANDBY] = ENERGY_LORA_STANDBY_CURRENT,
+            [ENERGY_LORA_RX] = ENERGY_LORA_RX_CURRENT,
+        },
+    [ENERGY_SUBSYSTEM_BLE] =
+        {
+            [ENERGY_BLE_OFF] = ENERGY_BLE_OFF_CURRENT,
+            [ENERGY_BLE_IDLE] = ENERGY_BLE_IDLE_CURRENT,
+            [ENERGY_BLE_ADVERTISING] = ENERGY_BLE_ADVERTISING_CURRENT,
+            [ENERGY_BLE_CONNECTED] = ENERGY_BLE_CONNECTED_CURRENT,
+        },
+};
+
+static energy_subsystem_t energy_subsystems[ENERGY_SUBSYSTEM_MAX];
+static energy_port_report_t energy_ports[ENERGY_LORAWAN_PORTS];
+static uint32_t energy_port_index;
+static uint64_t energy_port_idle;
+static uint32_t energy_start;
+static uint64_t energy_elapsed;
+static TimerHandle_t energy_sample_timer;
+
+static bool energy_ble_enabled;
+static bool energy_ble_advertising;
+static bool energy_ble_connected;
+
+static uint32_t energy_tx_current(int8_t i8Power)
+{
+    uint32_t ui32Entries = sizeof(energy_tx_table) / sizeof(energy_tx_table[0]);
+
+    if (energy_tx_override)
+    {
+        return energy_tx_override;
+    }
+
+    for (uint32_t i = 0; i < ui32Entries; i++)
+    {
+        if (i8Power <= energy_tx_table[i].i8Power)
+        {
+            return energy_tx_table[i].ui32Current;
+        }
+    }
+
+    return energy_tx_table[ui32Entries - 1].ui32Current;
+}
+
+//
+// Must be called with interrupts disabled.  Integrates the charge of the
+// state being left and enters the new one.
+//
+static void energy_transition(energy_subsystem_e eSubsystem, uint32_t ui32State, uint32_t ui32Current)
+{
+    energy_subsystem_t *pSubsystem = &energy_subsystems[eSubsystem];
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+    uint32_t ui32Elapsed = ui32Now - pSubsystem->ui32Timestamp;
+    uint64_t ui64Charge = (uint64_t)ui32Elapsed * pSubsystem->ui32Current;
+
+    pSubsystem->ui64Charge += ui64Charge;
+    pSubsystem->ui64Time[pSubsystem->ui32State] += ui32Elapsed;
+
+    //
+    // Only the radio activity of a frame belongs to its port.  Sleep and
+    // standby between frames are charged to the idle bucket.
+    //
+    if (eSubsystem == ENERGY_SUBSYSTEM_LORAWAN)
+    {
+        if ((pSubsystem->ui32State == ENERGY_LORA_TX) || (pSubsystem->ui32State == ENERGY_LORA_RX))
+        {
+            energy_ports[energy_port_index].ui64Charge += ui64Charge;
+        }
+        else
+        {
+            energy_port_idle += ui64Charge;
+        }
+    }
+
+    pSubsystem->ui32State = ui32State;
+    pSubsystem->ui32Current = ui32Current;
+    pSubsystem->ui32Timestamp = ui32Now;
+}
+
+//
+// Must be called with interrupts disabled.  Closes the running interval of
+// every subsystem so that no STIMER delta spans more than one sample period.
+//
+static void energy_settle(void)
+{
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        energy_transition(i, energy_subsystems[i].ui32State, energy_subsystems[i].ui32Current);
+    }
+
+    energy_elapsed += (uint32_t)(energy_subsystems[ENERGY_SUBSYSTEM_MCU].ui32Timestamp - energy_start);
+    energy_start = energy_subsystems[ENERGY_SUBSYSTEM_MCU].ui32Timestamp;
+}
+
+static void energy_sample_callback(TimerHandle_t xTimer)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_settle();
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+static void energy_ble_update(void)
+{
+    energy_ble_state_e eState;
+
+    if (!energy_ble_enabled)
+    {
+        eState = ENERGY_BLE_OFF;
+    }
+    else if (energy_ble_connected)
+    {
+        eState = ENERGY_BLE_CONNECTED;
+    }
+    else if (energy_ble_advertising)
+    {
+        eState = ENERGY_BLE_ADVERTISING;
+    }
+    else
+    {
+        eState = ENERGY_BLE_IDLE;
+    }
+
+    energy_transition(
+        ENERGY_SUBSYSTEM_BLE, eState, energy_current_table[ENERGY_SUBSYSTEM_BLE][eState]);
+}
+
+void energy_monitor_init(void)
+{
+    memset(energy_subsystems, 0, sizeof(energy_subsystems));
+
+    energy_subsystems[ENERGY_SUBSYSTEM_MCU].ui32State = ENERGY_MCU_RUN;
+    energy_subsystems[ENERGY_SUBSYSTEM_LORAWAN].ui32State = ENERGY_LORA_SLEEP;
+    energy_subsystems[ENERGY_SUBSYSTEM_BLE].ui32State = ENERGY_BLE_OFF;
+
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        energy_subsystems[i].ui32Current =
+            energy_current_table[i][energy_subsystems[i].ui32State];
+    }
+
+    energy_ble_enabled = false;
+    energy_ble_advertising = false;
+    energy_ble_connected = false;
+    energy_tx_override = 0;
+
+    energy_monitor_reset();
+
+    //
+    // The STIMER wraps after 2^32 ticks (about 36 hours at 32kHz).  A
+    // subsystem can stay in one state for longer than that, so the deltas
+    // are settled periodically well within one wrap.
+    //
+    energy_sample_timer = xTimerCreate("energy sample",
+                                       pdMS_TO_TICKS(ENERGY_SAMPLE_PERIOD * 1000),
+                                       pdTRUE,
+                                       NULL,
+                                       energy_sample_callback);
+    xTimerStart(energy_sample_timer, 0);
+}
+
+void energy_monitor_reset(void)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        energy_subsystems[i].ui32Timestamp = ui32Now;
+        energy_subsystems[i].ui64Charge = 0;
+        memset(energy_subsystems[i].ui64Time, 0, sizeof(energy_subsystems[i].ui64Time));
+    }
+
+    for (uint32_t i = 0; i < ENERGY_LORAWAN_PORTS; i++)
+    {
+        energy_ports[i].ui32Port = ENERGY_PORT_UNUSED;
+        energy_ports[i].ui64Charge = 0;
+    }
+    energy_ports[0].ui32Port = 0;
+    energy_port_index = 0;
+    energy_port_idle = 0;
+
+    energy_start = ui32Now;
+    energy_elapsed = 0;
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_mcu_state(energy_mcu_state_e eState)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_transition(
+        ENERGY_SUBSYSTEM_MCU, eState, energy_current_table[ENERGY_SUBSYSTEM_MCU][eState]);
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_lora_state(energy_lora_state_e eState, int8_t i8TxPower)
+{
+    uint32_t ui32Current;
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    if (eState == ENERGY_LORA_TX)
+    {
+        ui32Current = energy_tx_current(i8TxPower);
+    }
+    else
+    {
+        ui32Current = energy_current_table[ENERGY_SUBSYSTEM_LORAWAN][eState];
+    }
+    energy_transition(ENERGY_SUBSYSTEM_LORAWAN, eState, ui32Current);
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_lora_port(uint32_t ui32Port)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+    energy_subsystem_t *pSubsystem = &energy_subsystems[ENERGY_SUBSYSTEM_LORAWAN];
+    uint32_t ui32Index = ENERGY_LORAWAN_PORTS - 1;
+
+    //
+    // Settle the charge of the previous frame before switching the port it
+    // is attributed to.  Ports beyond the table size share the last entry.
+    //
+    energy_transition(ENERGY_SUBSYSTEM_LORAWAN, pSubsystem->ui32State, pSubsystem->ui32Current);
+
+    for (uint32_t i = 0; i < ENERGY_LORAWAN_PORTS; i++)
+    {
+        if ((energy_ports[i].ui32Port == ui32Port) ||
+            (energy_ports[i].ui32Port == ENERGY_PORT_UNUSED))
+        {
+            energy_ports[i].ui32Port = ui32Port;
+            ui32Index = i;
+            break;
+        }
+    }
+    energy_port_index = ui32Index;
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_ble_enable(bool bEnable)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_ble_enabled = bEnable;
+    energy_ble_update();
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_ble_advertising(bool bActive)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_ble_advertising = bActive;
+    energy_ble_update();
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_ble_connected(bool bActive)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_ble_connected = bActive;
+    energy_ble_update();
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void energy_monitor_current_set(energy_subsystem_e eSubsystem,
+                                uint32_t ui32State,
+                                uint32_t ui32Current)
+{
+    if ((eSubsystem >= ENERGY_SUBSYSTEM_MAX) || (ui32State >= ENERGY_STATE_MAX))
+    {
+        return;
+    }
+
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+    energy_subsystem_t *pSubsystem = &energy_subsystems[eSubsystem];
+
+    if ((eSubsystem == ENERGY_SUBSYSTEM_LORAWAN) && (ui32State == ENERGY_LORA_TX))
+    {
+        energy_tx_override = ui32Current;
+    }
+    else
+    {
+        energy_current_table[eSubsystem][ui32State] = ui32Current;
+    }
+
+    if (pSubsystem->ui32State == ui32State)
+    {
+        energy_transition(eSubsystem, ui32State, ui32Current);
+    }
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+uint32_t energy_monitor_current_get(energy_subsystem_e eSubsystem, uint32_t ui32State)
+{
+    if ((eSubsystem >= ENERGY_SUBSYSTEM_MAX) || (ui32State >= ENERGY_STATE_MAX))
+    {
+        return 0;
+    }
+
+    if ((eSubsystem == ENERGY_SUBSYSTEM_LORAWAN) && (ui32State == ENERGY_LORA_TX))
+    {
+        return energy_tx_override;
+    }
+
+    return energy_current_table[eSubsystem][ui32State];
+}
+
+void energy_monitor_report(energy_report_t *psReport)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    energy_settle();
+
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        psReport->sSubsystem[i].ui64Charge = energy_subsystems[i].ui64Charge;
+        memcpy(psReport->sSubsystem[i].ui64Time,
+               energy_subsystems[i].ui64Time,
+               sizeof(psReport->sSubsystem[i].ui64Time));
+    }
+
+    memcpy(psReport->sPort, energy_ports, sizeof(energy_ports));
+    psReport->ui64PortIdle = energy_port_idle;
+    psReport->ui64Elapsed = energy_elapsed;
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+uint32_t energy_monitor_to_uah(uint64_t ui64Charge)
+{
+    return (uint32_t)(ui64Charge / ((uint64_t)ENERGY_CLOCK_HZ * 3600));
+}
+
+static uint8_t *energy_encode_u24(uint8_t *pui8Buffer, uint32_t ui32Value)
+{
+    if (ui32Value > 0xFFFFFF)
+    {
+        ui32Value = 0xFFFFFF;
+    }
+
+    *pui8Buffer++ = ui32Value & 0xFF;
+    *pui8Buffer++ = (ui32Value >> 8) & 0xFF;
+    *pui8Buffer++ = (ui32Value >> 16) & 0xFF;
+
+    return pui8Buffer;
+}
+
+//
+// Binary report, little endian:
+//   version (1) | MCU uAh (3) | LoRaWAN uAh (3) | BLE uAh (3) |
+//   { FPort (1) | uAh (3) } for as many ports as fit in ui32Size
+//
+// Port figures cover TX and RX only, the rest of the LoRaWAN total was spent
+// between frames.
+//
+uint32_t energy_monitor_encode(uint8_t *pui8Buffer, uint32_t ui32Size)
+{
+    energy_report_t sReport;
+    uint8_t *pui8Cursor = pui8Buffer;
+
+    if (ui32Size < (1 + ENERGY_SUBSYSTEM_MAX * 3))
+    {
+        return 0;
+    }
+
+    energy_monitor_report(&sReport);
+
+    *pui8Cursor++ = ENERGY_REPORT_VERSION;
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        pui8Cursor = energy_encode_u24(
+            pui8Cursor, energy_monitor_to_uah(sReport.sSubsystem[i].ui64Charge));
+    }
+
+    for (uint32_t i = 0; i < ENERGY_LORAWAN_PORTS; i++)
+    {
+        if (sReport.sPort[i].ui32Port == ENERGY_PORT_UNUSED)
+        {
+            continue;
+        }
+
+        if ((pui8Cursor - pui8Buffer) + 4 > ui32Size)
+        {
+            break;
+        }
+
+        *pui8Cursor++ = sReport.sPort[i].ui32Port & 0xFF;
+        pui8Cursor = energy_encode_u24(pui8Cursor, energy_monitor_to_uah(sReport.sPort[i].ui64Charge));
+    }
+
+    return pui8Cursor - pui8Buffer;
+}
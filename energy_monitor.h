@@ -0,0 +1,121 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _ENERGY_MONITOR_H_
+#define _ENERGY_MONITOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "energy_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    ENERGY_SUBSYSTEM_MCU,
+    ENERGY_SUBSYSTEM_LORAWAN,
+    ENERGY_SUBSYSTEM_BLE,
+    ENERGY_SUBSYSTEM_MAX
+} energy_subsystem_e;
+
+typedef enum
+{
+    ENERGY_MCU_RUN,
+    ENERGY_MCU_SLEEP,
+    ENERGY_MCU_DEEP_SLEEP,
+} energy_mcu_state_e;
+
+typedef enum
+{
+    ENERGY_LORA_SLEEP,
+    ENERGY_LORA_STANDBY,
+    ENERGY_LORA_RX,
+    ENERGY_LORA_TX,
+} energy_lora_state_e;
+
+typedef enum
+{
+    ENERGY_BLE_OFF,
+    ENERGY_BLE_IDLE,
+    ENERGY_BLE_ADVERTISING,
+    ENERGY_BLE_CONNECTED,
+} energy_ble_state_e;
+
+#define ENERGY_STATE_MAX 4
+#define ENERGY_PORT_UNUSED (0xFFFFFFFF)
+
+typedef struct
+{
+    uint64_t ui64Charge;                    // uA * clock ticks
+    uint64_t ui64Time[ENERGY_STATE_MAX];    // clock ticks
+} energy_subsystem_report_t;
+
+typedef struct
+{
+    uint32_t ui32Port;
+    uint64_t ui64Charge;                    // uA * clock ticks
+} energy_port_report_t;
+
+typedef struct
+{
+    uint64_t ui64Elapsed;                   // clock ticks
+    energy_subsystem_report_t sSubsystem[ENERGY_SUBSYSTEM_MAX];
+    energy_port_report_t sPort[ENERGY_LORAWAN_PORTS];
+    uint64_t ui64PortIdle;                  // LoRaWAN charge outside TX and RX
+} energy_report_t;
+
+extern void energy_monitor_init(void);
+extern void energy_monitor_reset(void);
+
+extern void energy_monitor_mcu_state(energy_mcu_state_e eState);
+extern void energy_monitor_lora_state(energy_lora_state_e eState, int8_t i8TxPower);
+extern void energy_monitor_lora_port(uint32_t ui32Port);
+extern void energy_monitor_ble_advertising(bool bActive);
+extern void energy_monitor_ble_connected(bool bActive);
+extern void energy_monitor_ble_enable(bool bEnable);
+
+extern void energy_monitor_current_set(energy_subsystem_e eSubsystem,
+                                       uint32_t ui32State,
+                                       uint32_t ui32Current);
+extern uint32_t energy_monitor_current_get(energy_subsystem_e eSubsystem, uint32_t ui32State);
+
+extern void energy_monitor_report(energy_report_t *psReport);
+extern uint32_t energy_monitor_to_uah(uint64_t ui64Charge);
+extern uint32_t energy_monitor_encode(uint8_t *pui8Buffer, uint32_t ui32Size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
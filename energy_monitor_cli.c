@@ -0,0 +1,273 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <FreeRTOS_CLI.h>
+
+#include <LmHandler.h>
+#include <LoRaMac.h>
+
+#include "lorawan.h"
+
+#include "energy_monitor.h"
+#include "energy_monitor_cli.h"
+
+static portBASE_TYPE energy_monitor_cli_entry(char *pui8OutBuffer,
+                                              size_t ui32OutBufferLength,
+                                              const char *pui8Command);
+
+static CLI_Command_Definition_t energy_monitor_cli_definition = {
+    (const char *const) "energy",
+    (const char *const) "energy :  Energy and Airtime Accounting.\r\n",
+    energy_monitor_cli_entry,
+    -1};
+
+static size_t argc;
+static char *argv[8];
+static char argz[128];
+
+static const char *energy_subsystem_names[ENERGY_SUBSYSTEM_MAX] = {"mcu", "lorawan", "ble"};
+
+static const char *energy_state_names[ENERGY_SUBSYSTEM_MAX][ENERGY_STATE_MAX] = {
+    {"run", "sleep", "deepsleep", NULL},
+    {"sleep", "standby", "rx", "tx"},
+    {"off", "idle", "adv", "conn"},
+};
+
+static energy_report_t energy_report;
+
+#define ENERGY_CLI_BUFFER_SIZE 242
+static uint8_t energy_cli_transmit_buffer[ENERGY_CLI_BUFFER_SIZE];
+
+void energy_monitor_cli_register()
+{
+    FreeRTOS_CLIRegisterCommand(&energy_monitor_cli_definition);
+    argc = 0;
+}
+
+static void help(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    strcat(pui8OutBuffer, "\r\nusage: energy <command>\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "supported commands are:\r\n");
+    strcat(pui8OutBuffer, "  show     charge and time spent in each state\r\n");
+    strcat(pui8OutBuffer, "  ports    LoRaWAN charge per FPort and between frames\r\n");
+    strcat(pui8OutBuffer, "  reset    clear all accumulated figures\r\n");
+    strcat(pui8OutBuffer, "  current  <subsystem> <state> [uA]\r\n");
+    strcat(pui8OutBuffer, "           get or set the current of a state\r\n");
+    strcat(pui8OutBuffer, "           (setting lorawan tx overrides the power table,\r\n");
+    strcat(pui8OutBuffer, "           0 restores it)\r\n");
+    strcat(pui8OutBuffer, "  send     [port] transmit the binary report\r\n");
+}
+
+static int energy_monitor_cli_lookup(const char *const *names, uint32_t count, const char *name)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (names[i] && (strcmp(names[i], name) == 0))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static void energy_monitor_cli_show(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    char line[64];
+
+    energy_monitor_report(&energy_report);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\n\rElapsed : %d s\n\r",
+                          (uint32_t)(energy_report.ui64Elapsed / ENERGY_CLOCK_HZ));
+
+    for (uint32_t i = 0; i < ENERGY_SUBSYSTEM_MAX; i++)
+    {
+        energy_subsystem_report_t *pSubsystem = &energy_report.sSubsystem[i];
+
+        am_util_stdio_sprintf(line,
+                              "\n\r%-8s: %d uAh\n\r",
+                              energy_subsystem_names[i],
+                              energy_monitor_to_uah(pSubsystem->ui64Charge));
+        strcat(pui8OutBuffer, line);
+
+        for (uint32_t j = 0; j < ENERGY_STATE_MAX; j++)
+        {
+            if (energy_state_names[i][j] == NULL)
+            {
+                continue;
+            }
+
+            am_util_stdio_sprintf(line,
+                                  "  %-10s %d ms\n\r",
+                                  energy_state_names[i][j],
+                                  (uint32_t)((pSubsystem->ui64Time[j] * 1000) / ENERGY_CLOCK_HZ));
+            strcat(pui8OutBuffer, line);
+        }
+    }
+}
+
+static void energy_monitor_cli_ports(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    char line[32];
+
+    energy_monitor_report(&energy_report);
+
+    strcpy(pui8OutBuffer, "\n\rPort  Charge\n\r");
+    for (uint32_t i = 0; i < ENERGY_LORAWAN_PORTS; i++)
+    {
+        if (energy_report.sPort[i].ui32Port == ENERGY_PORT_UNUSED)
+        {
+            continue;
+        }
+
+        am_util_stdio_sprintf(line,
+                              "%-4d  %d uAh\n\r",
+                              energy_report.sPort[i].ui32Port,
+                              energy_monitor_to_uah(energy_report.sPort[i].ui64Charge));
+        strcat(pui8OutBuffer, line);
+    }
+
+    am_util_stdio_sprintf(line,
+                          "idle  %d uAh\n\r",
+                          energy_monitor_to_uah(energy_report.ui64PortIdle));
+    strcat(pui8OutBuffer, line);
+}
+
+static void energy_monitor_cli_current(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    if (argc < 4)
+    {
+        help(pui8OutBuffer, argc, argv);
+        return;
+    }
+
+    int subsystem = energy_monitor_cli_lookup(energy_subsystem_names, ENERGY_SUBSYSTEM_MAX, argv[2]);
+    if (subsystem < 0)
+    {
+        am_util_stdio_sprintf(pui8OutBuffer, "\n\rUnknown subsystem %s.\n\r", argv[2]);
+        return;
+    }
+
+    int state = energy_monitor_cli_lookup(energy_state_names[subsystem], ENERGY_STATE_MAX, argv[3]);
+    if (state < 0)
+    {
+        am_util_stdio_sprintf(pui8OutBuffer, "\n\rUnknown state %s.\n\r", argv[3]);
+        return;
+    }
+
+    if (argc == 5)
+    {
+        energy_monitor_current_set(subsystem, state, strtoul(argv[4], NULL, 10));
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\n\r%s %s: %d uA\n\r",
+                          argv[2],
+                          argv[3],
+                          energy_monitor_current_get(subsystem, state));
+}
+
+static void energy_monitor_cli_send(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    LoRaMacTxInfo_t txInfo;
+    uint32_t port = ENERGY_REPORT_PORT;
+    uint32_t size = ENERGY_CLI_BUFFER_SIZE;
+
+    if (argc == 3)
+    {
+        port = strtoul(argv[2], NULL, 10);
+    }
+
+    //
+    // Fit the report into what the current datarate allows.  The summary
+    // always fits the smallest payload of every region.
+    //
+    LoRaMacQueryTxPossible(0, &txInfo);
+    if (txInfo.MaxPossibleApplicationDataSize < size)
+    {
+        size = txInfo.MaxPossibleApplicationDataSize;
+    }
+
+    uint32_t length = energy_monitor_encode(energy_cli_transmit_buffer, size);
+    if (length == 0)
+    {
+        am_util_stdio_sprintf(pui8OutBuffer, "\n\rPayload too small for the report.\n\r");
+        return;
+    }
+
+    lorawan_transmit(port, LORAMAC_HANDLER_UNCONFIRMED_MSG, length, energy_cli_transmit_buffer);
+    am_util_stdio_sprintf(pui8OutBuffer, "\n\rQueued %d bytes on port %d.\n\r", length, port);
+}
+
+portBASE_TYPE
+energy_monitor_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
+{
+    pui8OutBuffer[0] = 0;
+
+    strcpy(argz, pui8Command);
+    FreeRTOS_CLIExtractParameters(argz, &argc, argv);
+
+    if ((argc == 1) || (strcmp(argv[1], "show") == 0))
+    {
+        energy_monitor_cli_show(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "help") == 0)
+    {
+        help(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "ports") == 0)
+    {
+        energy_monitor_cli_ports(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "reset") == 0)
+    {
+        energy_monitor_reset();
+    }
+    else if (strcmp(argv[1], "current") == 0)
+    {
+        energy_monitor_cli_current(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "send") == 0)
+    {
+        energy_monitor_cli_send(pui8OutBuffer, argc, argv);
+    }
+
+    return pdFALSE;
+}
@@ -0,0 +1,339 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "log_config.h"
+
+#include "log_task.h"
+
+#define LOG_BUFFER_WORDS    (LOG_BUFFER_SIZE / 4)
+#define LOG_BUFFER_MASK     (LOG_BUFFER_WORDS - 1)
+
+#if (LOG_BUFFER_WORDS & LOG_BUFFER_MASK) != 0
+#error "LOG_BUFFER_SIZE must be a power of two"
+#endif
+
+//
+// Every record starts with a header word.  The producer writes the header
+// last so the log task never sees a partially written record.  The length
+// is the payload size in bytes, not counting the header.
+//
+#define LOG_HEADER_VALID    (0xA5000000)
+#define LOG_HEADER_MASK     (0xFF000000)
+
+#define LOG_HEADER(type, length)    (LOG_HEADER_VALID | ((type) << 16) | (length))
+#define LOG_HEADER_TYPE(header)     (((header) >> 16) & 0xFF)
+#define LOG_HEADER_LENGTH(header)   ((header) & 0xFFFF)
+#define LOG_RECORD_WORDS(length)    (1 + (((length) + 3) >> 2))
+
+typedef enum
+{
+    LOG_RECORD_PAD,
+    LOG_RECORD_TOKEN,
+    LOG_RECORD_TEXT,
+    LOG_RECORD_DATA,
+} log_record_e;
+
+static TaskHandle_t log_task_handle;
+
+static uint32_t log_buffer[LOG_BUFFER_WORDS];
+
+//
+// Free running word indices.  log_head is advanced by the producers with an
+// exclusive access loop, log_tail only by the log task.
+//
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+
+static volatile uint32_t log_written;
+static volatile uint32_t log_dropped;
+static volatile uint32_t log_peak;
+
+static void log_atomic_increment(volatile uint32_t *pui32Value)
+{
+    uint32_t ui32Value;
+
+    do
+    {
+        ui32Value = __LDREXW(pui32Value);
+    } while (__STREXW(ui32Value + 1, pui32Value));
+}
+
+static void log_wake(void)
+{
+    if (log_task_handle == NULL)
+    {
+        return;
+    }
+
+    if (xPortIsInsideInterrupt())
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(log_task_handle, &xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        xTaskNotifyGive(log_task_handle);
+    }
+}
+
+//
+// Reserve a contiguous record in the ring buffer.  If the record does not fit
+// before the end of the buffer a pad record is placed there first.  Returns
+// NULL when the buffer is full, the message is then dropped rather than
+// blocking the caller.
+//
+static uint32_t *log_reserve(uint32_t ui32Length, bool *pbWake)
+{
+    uint32_t ui32Words = LOG_RECORD_WORDS(ui32Length);
+    uint32_t ui32Head, ui32Position, ui32Pad, ui32Used;
+
+    if (ui32Words > LOG_BUFFER_WORDS / 2)
+    {
+        log_atomic_increment(&log_dropped);
+        return NULL;
+    }
+
+    do
+    {
+        ui32Head = __LDREXW(&log_head);
+        ui32Position = ui32Head & LOG_BUFFER_MASK;
+        ui32Pad = (ui32Position + ui32Words > LOG_BUFFER_WORDS) ? LOG_BUFFER_WORDS - ui32Position : 0;
+        ui32Used = ui32Head + ui32Pad + ui32Words - log_tail;
+
+        if (ui32Used > LOG_BUFFER_WORDS)
+        {
+            __CLREX();
+            log_atomic_increment(&log_dropped);
+            return NULL;
+        }
+    } while (__STREXW(ui32Head + ui32Pad + ui32Words, &log_head));
+
+    *pbWake = (ui32Head == log_tail);
+
+    if (ui32Used > log_peak)
+    {
+        log_peak = ui32Used;
+    }
+
+    if (ui32Pad)
+    {
+        log_buffer[ui32Position] = LOG_HEADER(LOG_RECORD_PAD, (ui32Pad - 1) * sizeof(uint32_t));
+        ui32Position = 0;
+    }
+
+    return &log_buffer[ui32Position];
+}
+
+static void log_commit(uint32_t *pui32Record, uint32_t ui32Type, uint32_t ui32Length, bool bWake)
+{
+    __DMB();
+    pui32Record[0] = LOG_HEADER(ui32Type, ui32Length);
+    log_atomic_increment(&log_written);
+
+    if (bWake)
+    {
+        log_wake();
+    }
+}
+
+void log_write(uint32_t ui32Token, const uint32_t *pui32Args, uint32_t ui32Count)
+{
+    bool bWake;
+
+    if (ui32Count > LOG_MAX_ARGS)
+    {
+        ui32Count = LOG_MAX_ARGS;
+    }
+
+    uint32_t ui32Length = (2 + ui32Count) * sizeof(uint32_t);
+    uint32_t *pui32Record = log_reserve(ui32Length, &bWake);
+    if (pui32Record == NULL)
+    {
+        return;
+    }
+
+    pui32Record[1] = ui32Token;
+    pui32Record[2] = am_hal_stimer_counter_get();
+    for (uint32_t i = 0; i < ui32Count; i++)
+    {
+        pui32Record[3 + i] = pui32Args[i];
+    }
+
+    log_commit(pui32Record, LOG_RECORD_TOKEN, ui32Length, bWake);
+}
+
+static void log_write_bytes(uint32_t ui32Type, const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    bool bWake;
+
+    uint32_t *pui32Record = log_reserve(ui32Length, &bWake);
+    if (pui32Record == NULL)
+    {
+        return;
+    }
+
+    memcpy(&pui32Record[1], pui8Data, ui32Length);
+
+    log_commit(pui32Record, ui32Type, ui32Length, bWake);
+}
+
+void log_write_text(const char *pcText, uint32_t ui32Length)
+{
+    log_write_bytes(LOG_RECORD_TEXT, (const uint8_t *)pcText, ui32Length);
+}
+
+void log_write_data(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    log_write_bytes(LOG_RECORD_DATA, pui8Data, ui32Length);
+}
+
+void log_print_hex(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    for (uint32_t i = 0; i < ui32Length; i++)
+    {
+        am_util_stdio_printf("%02X ", pui8Data[i]);
+    }
+    am_util_stdio_printf("\r\n");
+}
+
+void log_get_statistics(log_statistics_t *psStatistics)
+{
+    psStatistics->ui32Written = log_written;
+    psStatistics->ui32Dropped = log_dropped;
+    psStatistics->ui32Peak = log_peak * sizeof(uint32_t);
+    psStatistics->ui32Size = LOG_BUFFER_SIZE;
+}
+
+//
+// Token records are sent as a single line of hex words prefixed with '~':
+//   ~<token><timestamp><arg0>...<argN>
+// which tools/log_detoken.py expands.  Text records are sent as is and data
+// records as hex bytes.
+//
+static void log_emit(uint32_t ui32Type, uint32_t *pui32Payload, uint32_t ui32Length)
+{
+    static char line[LOG_BUFFER_SIZE / 4];
+    char *pcCursor = line;
+
+    switch (ui32Type)
+    {
+    case LOG_RECORD_TOKEN:
+        *pcCursor++ = '~';
+        for (uint32_t i = 0; i < ui32Length / sizeof(uint32_t); i++)
+        {
+            pcCursor += am_util_stdio_sprintf(pcCursor, "%08X", pui32Payload[i]);
+        }
+        strcpy(pcCursor, "\r\n");
+        break;
+
+    case LOG_RECORD_TEXT:
+        if (ui32Length >= sizeof(line))
+        {
+            ui32Length = sizeof(line) - 1;
+        }
+        memcpy(line, pui32Payload, ui32Length);
+        line[ui32Length] = 0;
+        break;
+
+    case LOG_RECORD_DATA:
+        for (uint32_t i = 0; (i < ui32Length) && (pcCursor - line < sizeof(line) - 6); i++)
+        {
+            pcCursor += am_util_stdio_sprintf(pcCursor, "%02X ", ((uint8_t *)pui32Payload)[i]);
+        }
+        strcpy(pcCursor, "\r\n");
+        break;
+
+    default:
+        return;
+    }
+
+    am_util_stdio_printf("%s", line);
+}
+
+static void log_drain(void)
+{
+    while (log_tail != log_head)
+    {
+        uint32_t ui32Position = log_tail & LOG_BUFFER_MASK;
+        uint32_t ui32Header = log_buffer[ui32Position];
+
+        if ((ui32Header & LOG_HEADER_MASK) != LOG_HEADER_VALID)
+        {
+            // reserved but not yet committed
+            return;
+        }
+
+        uint32_t ui32Length = LOG_HEADER_LENGTH(ui32Header);
+        uint32_t ui32Words = LOG_RECORD_WORDS(ui32Length);
+
+        log_emit(LOG_HEADER_TYPE(ui32Header), &log_buffer[ui32Position + 1], ui32Length);
+
+        //
+        // Clear the record so that stale payload can never be mistaken for
+        // a header once the space is reused.
+        //
+        memset(&log_buffer[ui32Position], 0, ui32Words * sizeof(uint32_t));
+        __DMB();
+        log_tail += ui32Words;
+    }
+}
+
+static void log_task(void *pvParameters)
+{
+    while (1)
+    {
+        //
+        // Poll on the next tick if the drain stopped on a record that is
+        // still being written, otherwise wait for the next message.
+        //
+        ulTaskNotifyTake(pdTRUE, (log_tail != log_head) ? 1 : portMAX_DELAY);
+        log_drain();
+    }
+}
+
+void log_task_create(uint32_t ui32Priority)
+{
+    log_head = 0;
+    log_tail = 0;
+    memset(log_buffer, 0, sizeof(log_buffer));
+
+    xTaskCreate(log_task, "log", LOG_TASK_STACK, 0, ui32Priority, &log_task_handle);
+}
@@ -0,0 +1,95 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _LOG_TASK_H_
+#define _LOG_TASK_H_
+
+#include <stdint.h>
+
+#include <am_util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// LOG_PRINTF() takes a printf style format and up to LOG_MAX_ARGS integer
+// arguments.  With LOG_TOKENIZED defined the format string is placed in the
+// .log_fmt section, which is kept in the ELF file but not programmed, and
+// only its offset and the raw arguments are written to a ring buffer.  The
+// log task sends the records to the console and tools/log_detoken.py turns
+// them back into text using the ELF file.
+//
+// %s is only supported for strings that live in flash such as literals and
+// constant tables, the host reads them from the ELF file.  Pass them through
+// LOG_STRING() so that they are logged by address when tokenized.
+//
+#ifdef LOG_TOKENIZED
+#if UINTPTR_MAX > UINT32_MAX
+#error "LOG_TOKENIZED needs 32-bit addresses for its tokens and %s arguments"
+#endif
+#define LOG_PRINTF(fmt, ...)                                                                       \
+    do                                                                                             \
+    {                                                                                              \
+        static const char log_fmt[] __attribute__((section(".log_fmt"), used)) = fmt;              \
+        const uint32_t log_args[] = {0, ##__VA_ARGS__};                                            \
+        log_write((uint32_t)(uintptr_t)log_fmt, &log_args[1], sizeof(log_args) / sizeof(uint32_t) - 1);       \
+    } while (0)
+#define LOG_HEX(data, length) log_write_data(data, length)
+#define LOG_STRING(s) ((uint32_t)(uintptr_t)(s))
+#else
+#define LOG_PRINTF(fmt, ...) am_util_stdio_printf(fmt, ##__VA_ARGS__)
+#define LOG_HEX(data, length) log_print_hex(data, length)
+#define LOG_STRING(s) (s)
+#endif
+
+typedef struct
+{
+    uint32_t ui32Written;
+    uint32_t ui32Dropped;
+    uint32_t ui32Peak;      // bytes
+    uint32_t ui32Size;      // bytes
+} log_statistics_t;
+
+extern void log_task_create(uint32_t ui32Priority);
+
+extern void log_write(uint32_t ui32Token, const uint32_t *pui32Args, uint32_t ui32Count);
+extern void log_write_text(const char *pcText, uint32_t ui32Length);
+extern void log_write_data(const uint8_t *pui8Data, uint32_t ui32Length);
+extern void log_print_hex(const uint8_t *pui8Data, uint32_t ui32Length);
+
+extern void log_get_statistics(log_statistics_t *psStatistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
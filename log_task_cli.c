@@ -0,0 +1,169 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <FreeRTOS_CLI.h>
+
+#include "log_task.h"
+#include "log_task_cli.h"
+
+#define LOG_BENCH_ITERATIONS 16
+
+static portBASE_TYPE
+log_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command);
+
+static CLI_Command_Definition_t log_task_cli_definition = {
+    (const char *const) "log",
+    (const char *const) "log    :  Deferred Logging Commands.\r\n",
+    log_task_cli_entry,
+    -1};
+
+static size_t argc;
+static char *argv[8];
+static char argz[128];
+
+void log_task_cli_register()
+{
+    FreeRTOS_CLIRegisterCommand(&log_task_cli_definition);
+    argc = 0;
+}
+
+static void help(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    strcat(pui8OutBuffer, "\r\nusage: log <command>\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "supported commands are:\r\n");
+    strcat(pui8OutBuffer, "  stats    ring buffer statistics\r\n");
+    strcat(pui8OutBuffer, "  bench    cycles per call of LOG_PRINTF and am_util_stdio_printf\r\n");
+}
+
+static void log_task_cli_stats(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    log_statistics_t stats;
+
+    log_get_statistics(&stats);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\n\rWritten     : %d\n\r"
+                          "Dropped     : %d\n\r"
+                          "Peak        : %d / %d bytes\n\r"
+#ifdef LOG_TOKENIZED
+                          "Mode        : tokenized\n\r",
+#else
+                          "Mode        : direct\n\r",
+#endif
+                          stats.ui32Written,
+                          stats.ui32Dropped,
+                          stats.ui32Peak,
+                          stats.ui32Size);
+}
+
+//
+// Time the same two argument message through both paths with the DWT cycle
+// counter.  The minimum is the cost without preemption, the average includes
+// whatever ran in between.
+//
+static void log_task_cli_bench(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    uint32_t ui32Start, ui32Cycles;
+    uint32_t ui32LogMin = UINT32_MAX, ui32LogTotal = 0;
+    uint32_t ui32PrintfMin = UINT32_MAX, ui32PrintfTotal = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t i = 0; i < LOG_BENCH_ITERATIONS; i++)
+    {
+        ui32Start = DWT->CYCCNT;
+        am_util_stdio_printf("bench printf %d 0x%08X\r\n", i, ui32Start);
+        ui32Cycles = DWT->CYCCNT - ui32Start;
+
+        ui32PrintfTotal += ui32Cycles;
+        if (ui32Cycles < ui32PrintfMin)
+        {
+            ui32PrintfMin = ui32Cycles;
+        }
+    }
+
+    for (uint32_t i = 0; i < LOG_BENCH_ITERATIONS; i++)
+    {
+        ui32Start = DWT->CYCCNT;
+        LOG_PRINTF("bench log %d 0x%08X\r\n", i, ui32Start);
+        ui32Cycles = DWT->CYCCNT - ui32Start;
+
+        ui32LogTotal += ui32Cycles;
+        if (ui32Cycles < ui32LogMin)
+        {
+            ui32LogMin = ui32Cycles;
+        }
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\n\rcycles per call (min / avg over %d)\n\r"
+                          "am_util_stdio_printf : %d / %d\n\r"
+                          "LOG_PRINTF           : %d / %d\n\r",
+                          LOG_BENCH_ITERATIONS,
+                          ui32PrintfMin,
+                          ui32PrintfTotal / LOG_BENCH_ITERATIONS,
+                          ui32LogMin,
+                          ui32LogTotal / LOG_BENCH_ITERATIONS);
+}
+
+portBASE_TYPE
+log_task_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
+{
+    pui8OutBuffer[0] = 0;
+
+    strcpy(argz, pui8Command);
+    FreeRTOS_CLIExtractParameters(argz, &argc, argv);
+
+    if ((argc == 1) || (strcmp(argv[1], "help") == 0))
+    {
+        help(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "stats") == 0)
+    {
+        log_task_cli_stats(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "bench") == 0)
+    {
+        log_task_cli_bench(pui8OutBuffer, argc, argv);
+    }
+
+    return pdFALSE;
+}
@@ -45,7 +45,12 @@
 
 #include "application_task.h"
 #include "console_task.h"
+#include "energy_monitor.h"
+#include "log_task.h"
+#include "rtos_stats.h"
+#include "sleep_governor.h"
 #include "lorawan_task.h"
+#include "ble_ota.h"
 #include "ble_task.h"
 
 //*****************************************************************************
@@ -58,7 +63,7 @@
 //*****************************************************************************
 uint32_t am_freertos_sleep(uint32_t idleTime)
 {
-    am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_DEEP);
+    sleep_governor_sleep(idleTime);
     return 0;
 }
 
@@ -70,6 +75,7 @@ uint32_t am_freertos_sleep(uint32_t idleTime)
 //*****************************************************************************
 void am_freertos_wakeup(uint32_t idleTime)
 {
+    sleep_governor_wakeup();
 }
 
 void am_gpio_isr(void)
@@ -106,7 +112,7 @@ void vApplicationMallocFailedHook(void)
     //
     while (1)
     {
-        __asm("BKPT #0\n"); // Break into the debugger
+        __BKPT(0); // Break into the debugger
     }
 }
 
@@ -122,7 +128,7 @@ void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
     //
     while (1)
     {
-        __asm("BKPT #0\n"); // Break into the debugger
+        __BKPT(0); // Break into the debugger
     }
 }
 
@@ -149,13 +155,15 @@ void system_setup(void)
     am_hal_rtc_osc_disable();
 
     NVIC_SetPriority(GPIO_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_SetPriority(STIMER_CMPR2_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_SetPriority(STIMER_CMPR3_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_SetPriority(STIMER_CMPR4_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_SetPriority(STIMER_CMPR5_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
+    NVIC_SetPriority(STIMER_CMPR0_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
+    NVIC_SetPriority(STIMER_CMPR1_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
     NVIC_SetPriority(BLE_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
 
     am_hal_interrupt_master_enable();
+
+    energy_monitor_init();
+    sleep_governor_init();
+    rtos_stats_init();
 }
 
 void system_start(void)
@@ -163,7 +171,9 @@ void system_start(void)
     console_task_create(3);
     lorawan_task_create(2);
     ble_task_create(2);
+    ble_ota_task_create(1);
     application_task_create(1);
+    log_task_create(1);
     //
     // Start the scheduler.
     //
@@ -206,6 +206,16 @@ typedef struct
   uint8_t csf;              /*!< Client supported features characteristic value */
   uint8_t changeAwareState; /*!< Client awareness of GATT database changes */
 } attsCsfRec_t;
+
+/*! \brief Notification coalescing statistics. */
+typedef struct
+{
+  uint32_t updates;         /*!< Values passed to AttsHandleValueNtfCoal() */
+  uint32_t merged;          /*!< Values appended to an already queued notification */
+  uint32_t sent;            /*!< Coalesced notifications handed to L2CAP */
+  uint32_t deferred;        /*!< Sends postponed by flow control or busy controller buffers */
+  uint32_t dropped;         /*!< Values discarded for lack of room or buffers */
+} attsCoalStats_t;
 /**@}*/
 
 /** \name ATT Server Callbacks
@@ -984,6 +994,89 @@ void AttsDynAddAttrConst(void *pSvcHandle, const uint8_t *pUuid, const uint8_t *
                          const uint16_t len, uint8_t settings, uint8_t permissions);
 /**@}*/
 
+/** \name ATT Server Database Index
+ *
+ */
+/**@{*/
+/*************************************************************************************************/
+/*!
+ *  \brief  Enable or disable the attribute database index.  The index is enabled by default.
+ *
+ *  \param  enable  TRUE to serve lookups from the index, FALSE to use linear searches.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsIdxEnable(bool_t enable);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Replay the server side lookups of a full GATT discovery of the local database
+ *          without sending any PDUs.
+ *
+ *  \return Number of lookups performed.
+ */
+/*************************************************************************************************/
+uint16_t AttsIdxReplayDiscovery(void);
+/**@}*/
+
+/** \name ATT Server Notification Coalescing
+ *
+ */
+/**@{*/
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize notification coalescing.  Call after AttsInit().
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsCoalInit(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Coalesce notifications of a characteristic value.  Values passed to
+ *          AttsHandleValueNtfCoal() for this handle are appended to one notification per
+ *          connection until it reaches the MTU or the deadline expires.
+ *
+ *  \param  handle      Attribute handle.
+ *  \param  deadlineMs  Longest time a value is held back, in milliseconds.  With zero values
+ *                      are only merged while sending is held off by flow control.
+ *
+ *  \return TRUE if registered, FALSE if the table is full.
+ */
+/*************************************************************************************************/
+bool_t AttsCoalRegister(uint16_t handle, uint16_t deadlineMs);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Queue a value for a coalesced Handle Value Notification.  Handles not registered
+ *          with AttsCoalRegister() are sent with AttsHandleValueNtf().  One ATTS_HANDLE_VALUE_CNF
+ *          is received per notification sent, not per value.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  handle      Attribute handle.
+ *  \param  valueLen    Length of value data.
+ *  \param  pValue      Pointer to value data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsHandleValueNtfCoal(dmConnId_t connId, uint16_t handle, uint16_t valueLen,
+                            uint8_t *pValue);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the notification coalescing statistics.
+ *
+ *  \param  pStats  Returned statistics.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsCoalGetStats(attsCoalStats_t *pStats);
+/**@}*/
+
 /** \name ATT Server Testing
  *
  */
@@ -1140,6 +1140,15 @@ uint16_t HciGetBufSize(void);
 /*************************************************************************************************/
 uint8_t HciGetNumBufs(void);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the number of controller ACL buffers currently free.
+ *
+ *  \return Number of free ACL buffers.
+ */
+/*************************************************************************************************/
+uint8_t HciGetAvailableBufs(void);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Return the states supported by the controller.
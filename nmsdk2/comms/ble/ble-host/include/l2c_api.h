@@ -313,6 +313,20 @@ void L2cRegister(uint16_t cid, l2cDataCback_t dataCback, l2cCtrlCback_t ctrlCbac
 /*************************************************************************************************/
 void L2cDataReq(uint16_t cid, uint16_t handle, uint16_t len, uint8_t *pL2cPacket);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the L2CAP payload bytes sent and received on a connection.  The counters are
+ *          free running; callers work with differences between two reads.
+ *
+ *  \param  connId     DM connection ID.
+ *  \param  pTxBytes   Returned bytes sent.
+ *  \param  pRxBytes   Returned bytes received.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void L2cGetTraffic(dmConnId_t connId, uint32_t *pTxBytes, uint32_t *pRxBytes);
+
 /*************************************************************************************************/
 /*!
 *  \brief  Build and send a signaling packet.
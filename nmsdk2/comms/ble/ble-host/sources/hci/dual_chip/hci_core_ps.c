@@ -250,6 +250,18 @@ uint8_t HciGetNumBufs(void)
   return hciCoreCb.numBufs;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the number of controller ACL buffers currently free.
+ *
+ *  \return Number of free ACL buffers.
+ */
+/*************************************************************************************************/
+uint8_t HciGetAvailableBufs(void)
+{
+  return hciCoreCb.availBufs;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Return the states supported by the controller.
@@ -122,8 +122,13 @@ typedef union
   attcPktParamPrepWrite_t w;
 } attcPktParam_t;
 
-/* verify attcPktParam_t will work in data buffer format described above */
+/* verify attcPktParam_t will work in data buffer format described above; with 64-bit pointers
+ * the prepare write value pointer does not fit and prepare write requests are unsupported */
+#if UINTPTR_MAX > 0xFFFFFFFF
+WSF_CT_ASSERT(sizeof(attcPktParamHandles_t) <= L2C_PAYLOAD_START);
+#else
 WSF_CT_ASSERT(sizeof(attcPktParam_t) <= L2C_PAYLOAD_START);
+#endif
 
 /* API message structure */
 typedef struct
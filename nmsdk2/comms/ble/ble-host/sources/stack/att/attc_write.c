@@ -116,6 +116,9 @@ void AttcPrepareWriteReq(dmConnId_t connId, uint16_t handle, uint16_t offset, ui
   uint8_t         *p;
   uint16_t        bufLen;
 
+  /* the parameters must not overlap the request in the packet */
+  WSF_ASSERT(sizeof(attcPktParamPrepWrite_t) <= L2C_PAYLOAD_START);
+
   if (continuing && valueByRef)
   {
     bufLen = ATT_PREP_WRITE_REQ_BUF_LEN;
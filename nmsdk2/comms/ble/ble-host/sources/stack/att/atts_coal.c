@@ -0,0 +1,489 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  ATT server notification coalescing.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  Each registered handle has one queue per connection.  Values are appended to a single ATT
+ *  buffer sized to the connection MTU, and the buffer goes out as one zero copy notification
+ *  when the next value would not fit or the handle deadline expires.  A send is only made while
+ *  ATT flow is enabled and more than ATTS_COAL_ACL_RESERVE controller ACL buffers are free;
+ *  otherwise it is retried a few milliseconds later and values keep merging in the meantime.
+ *  A value that finds its queue full while sending is held off is dropped.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_trace.h"
+#include "wsf_os.h"
+#include "wsf_timer.h"
+#include "cfg_stack.h"
+#include "hci_api.h"
+#include "att_api.h"
+#include "att_main.h"
+#include "atts_main.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/* Time between send attempts while held off, in milliseconds */
+#define ATTS_COAL_RETRY_MS       5
+
+/* Registration table index for an unregistered handle */
+#define ATTS_COAL_IDX_NONE       0xFF
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/* Registered handle */
+typedef struct
+{
+  uint16_t          handle;                           /* Attribute handle */
+  uint16_t          deadlineMs;                       /* Longest time a value is held back */
+} attsCoalReg_t;
+
+/* Queue of one handle on one connection */
+typedef struct
+{
+  wsfTimer_t        timer;                            /* Deadline and retry timer */
+  uint8_t           *pBuf;                            /* Queued value, NULL if empty */
+  uint16_t          len;                              /* Length of queued value */
+  uint16_t          maxLen;                           /* Size of pBuf */
+  bool_t            retry;                            /* TRUE if a send was held off */
+} attsCoalQueue_t;
+
+/* Control block */
+typedef struct
+{
+  attsCoalReg_t     reg[ATTS_COAL_HDL_MAX];                 /* Registered handles */
+  attsCoalQueue_t   queue[DM_CONN_MAX][ATTS_COAL_HDL_MAX];  /* Queues by connection and handle */
+  attsCoalStats_t   stats;                                  /* Statistics */
+  uint8_t           numReg;                                 /* Number of registered handles */
+} attsCoalCb_t;
+
+/**************************************************************************************************
+  Function Prototypes
+**************************************************************************************************/
+
+static void attsCoalConnCback(attCcb_t *pCcb, dmEvt_t *pDmEvt);
+static void attsCoalMsgCback(wsfMsgHdr_t *pMsg);
+static void attsCoalCtrlCback(wsfMsgHdr_t *pMsg);
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/* Interface to ATT */
+static const attFcnIf_t attsCoalFcnIf =
+{
+  attEmptyDataCback,
+  attsCoalCtrlCback,
+  (attMsgHandler_t) attsCoalMsgCback,
+  attsCoalConnCback
+};
+
+/* Control block */
+static attsCoalCb_t attsCoalCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the registration index of a handle.
+ *
+ *  \param  handle  Attribute handle.
+ *
+ *  \return Registration index or ATTS_COAL_IDX_NONE if not registered.
+ */
+/*************************************************************************************************/
+static uint8_t attsCoalFind(uint16_t handle)
+{
+  uint8_t i;
+
+  for (i = 0; i < attsCoalCb.numReg; i++)
+  {
+    if (attsCoalCb.reg[i].handle == handle)
+    {
+      return i;
+    }
+  }
+
+  return ATTS_COAL_IDX_NONE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check whether a notification can be sent on a connection now.
+ *
+ *  \param  connId  DM connection ID.
+ *
+ *  \return TRUE if ATT flow is enabled and the controller has ACL buffers to spare.
+ */
+/*************************************************************************************************/
+static bool_t attsCoalReady(dmConnId_t connId)
+{
+  if (attCb.ccb[connId - 1].control & ATT_CCB_STATUS_FLOW_DISABLED)
+  {
+    return FALSE;
+  }
+
+  return HciGetAvailableBufs() > ATTS_COAL_ACL_RESERVE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Detach the queued value from a queue.  Called with the task lock held.
+ *
+ *  \param  pQueue  Queue.
+ *  \param  pLen    Returned value length.
+ *
+ *  \return Queued value buffer or NULL if the queue is empty.
+ */
+/*************************************************************************************************/
+static uint8_t *attsCoalTake(attsCoalQueue_t *pQueue, uint16_t *pLen)
+{
+  uint8_t *pBuf = pQueue->pBuf;
+
+  *pLen = pQueue->len;
+  pQueue->pBuf = NULL;
+  pQueue->len = 0;
+  pQueue->retry = FALSE;
+
+  return pBuf;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a detached value as a zero copy notification.
+ *
+ *  \param  connId  DM connection ID.
+ *  \param  idx     Registration index.
+ *  \param  pBuf    Value buffer.
+ *  \param  len     Value length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsCoalSend(dmConnId_t connId, uint8_t idx, uint8_t *pBuf, uint16_t len)
+{
+  WsfTaskLock();
+  attsCoalCb.stats.sent++;
+  WsfTaskUnlock();
+
+  AttsHandleValueNtfZeroCpy(connId, attsCoalCb.reg[idx].handle, len, pBuf);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send the queued value of a queue, or retry later if sending is held off.
+ *
+ *  \param  connId  DM connection ID.
+ *  \param  idx     Registration index.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsCoalFlush(dmConnId_t connId, uint8_t idx)
+{
+  attsCoalQueue_t *pQueue = &attsCoalCb.queue[connId - 1][idx];
+  uint8_t         *pBuf;
+  uint16_t        len;
+
+  if (pQueue->pBuf == NULL)
+  {
+    return;
+  }
+
+  if (!attsCoalReady(connId))
+  {
+    WsfTaskLock();
+    attsCoalCb.stats.deferred++;
+    pQueue->retry = TRUE;
+    WsfTaskUnlock();
+
+    WsfTimerStartMs(&pQueue->timer, ATTS_COAL_RETRY_MS);
+    return;
+  }
+
+  WsfTimerStop(&pQueue->timer);
+
+  WsfTaskLock();
+  pBuf = attsCoalTake(pQueue, &len);
+  WsfTaskUnlock();
+
+  if (pBuf != NULL)
+  {
+    attsCoalSend(connId, idx, pBuf, len);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Connection callback.  Discard the queues of a closed connection.
+ *
+ *  \param  pCcb    ATT control block.
+ *  \param  pDmEvt  DM callback event.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsCoalConnCback(attCcb_t *pCcb, dmEvt_t *pDmEvt)
+{
+  attsCoalQueue_t *pQueue;
+  uint8_t         *pBuf;
+  uint16_t        len;
+  uint8_t         i;
+
+  if (pDmEvt->hdr.event != DM_CONN_CLOSE_IND)
+  {
+    return;
+  }
+
+  for (i = 0, pQueue = attsCoalCb.queue[pCcb->connId - 1]; i < ATTS_COAL_HDL_MAX; i++, pQueue++)
+  {
+    WsfTimerStop(&pQueue->timer);
+
+    WsfTaskLock();
+    pBuf = attsCoalTake(pQueue, &len);
+    WsfTaskUnlock();
+
+    if (pBuf != NULL)
+    {
+      AttMsgFree(pBuf, ATT_PDU_VALUE_NTF);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WSF message handler callback.  Deadline or retry timer expired.
+ *
+ *  \param  pMsg  Timer message; param holds the connection ID and status the handle index.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsCoalMsgCback(wsfMsgHdr_t *pMsg)
+{
+  if (DmConnInUse((dmConnId_t) pMsg->param))
+  {
+    attsCoalFlush((dmConnId_t) pMsg->param, pMsg->status);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  L2CAP control callback.  Send queues held off by flow control as soon as it is
+ *          enabled again.
+ *
+ *  \param  pMsg    Pointer to message structure.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsCoalCtrlCback(wsfMsgHdr_t *pMsg)
+{
+  dmConnId_t connId = (dmConnId_t) pMsg->param;
+  uint8_t    i;
+
+  if ((pMsg->event != L2C_CTRL_FLOW_ENABLE_IND) || !DmConnInUse(connId))
+  {
+    return;
+  }
+
+  for (i = 0; i < attsCoalCb.numReg; i++)
+  {
+    if (attsCoalCb.queue[connId - 1][i].retry)
+    {
+      attsCoalFlush(connId, i);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize notification coalescing.  Call after AttsInit().
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsCoalInit(void)
+{
+  attsCoalQueue_t *pQueue;
+  uint8_t         i, j;
+
+  memset(&attsCoalCb, 0, sizeof(attsCoalCb));
+
+  for (i = 0; i < DM_CONN_MAX; i++)
+  {
+    for (j = 0, pQueue = attsCoalCb.queue[i]; j < ATTS_COAL_HDL_MAX; j++, pQueue++)
+    {
+      pQueue->timer.handlerId = attCb.handlerId;
+      pQueue->timer.msg.event = ATTS_MSG_COAL_TIMEOUT;
+      pQueue->timer.msg.param = i + 1;  /* param stores the conn id */
+      pQueue->timer.msg.status = j;     /* status stores the handle index */
+    }
+  }
+
+  /* set up callback interface */
+  attsCb.pCoal = &attsCoalFcnIf;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Coalesce notifications of a characteristic value.
+ *
+ *  \param  handle      Attribute handle.
+ *  \param  deadlineMs  Longest time a value is held back, in milliseconds.
+ *
+ *  \return TRUE if registered, FALSE if the table is full.
+ */
+/*************************************************************************************************/
+bool_t AttsCoalRegister(uint16_t handle, uint16_t deadlineMs)
+{
+  uint8_t idx = attsCoalFind(handle);
+
+  if (idx == ATTS_COAL_IDX_NONE)
+  {
+    if (attsCoalCb.numReg == ATTS_COAL_HDL_MAX)
+    {
+      ATT_TRACE_WARN1("AttsCoalRegister table full handle:%d", handle);
+      return FALSE;
+    }
+
+    idx = attsCoalCb.numReg++;
+    attsCoalCb.reg[idx].handle = handle;
+  }
+
+  attsCoalCb.reg[idx].deadlineMs = deadlineMs;
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Queue a value for a coalesced Handle Value Notification.
+ *
+ *  \param  connId      DM connection ID.
+ *  \param  handle      Attribute handle.
+ *  \param  valueLen    Length of value data.
+ *  \param  pValue      Pointer to value data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsHandleValueNtfCoal(dmConnId_t connId, uint16_t handle, uint16_t valueLen,
+                            uint8_t *pValue)
+{
+  attsCoalQueue_t *pQueue;
+  uint8_t         *pFull = NULL;
+  uint16_t        fullLen = 0;
+  uint16_t        mtu;
+  uint8_t         idx;
+  bool_t          started = FALSE;
+  bool_t          filled;
+
+  idx = attsCoalFind(handle);
+  mtu = DmConnInUse(connId) ? AttGetMtu(connId) : 0;
+
+  /* unregistered handles, closed connections and oversized values take the normal path */
+  if ((idx == ATTS_COAL_IDX_NONE) || (mtu == 0) || ((valueLen + ATT_VALUE_NTF_LEN) > mtu))
+  {
+    AttsHandleValueNtf(connId, handle, valueLen, pValue);
+    return;
+  }
+
+  pQueue = &attsCoalCb.queue[connId - 1][idx];
+
+  WsfTaskLock();
+
+  attsCoalCb.stats.updates++;
+
+  /* if the value does not fit behind the queued one send that first */
+  if ((pQueue->pBuf != NULL) && ((pQueue->len + valueLen) > pQueue->maxLen))
+  {
+    if (!attsCoalReady(connId))
+    {
+      attsCoalCb.stats.dropped++;
+      WsfTaskUnlock();
+      return;
+    }
+
+    pFull = attsCoalTake(pQueue, &fullLen);
+  }
+
+  if (pQueue->pBuf == NULL)
+  {
+    if ((pQueue->pBuf = AttMsgAlloc(mtu - ATT_VALUE_NTF_LEN, ATT_PDU_VALUE_NTF)) == NULL)
+    {
+      attsCoalCb.stats.dropped++;
+      WsfTaskUnlock();
+
+      if (pFull != NULL)
+      {
+        attsCoalSend(connId, idx, pFull, fullLen);
+      }
+      return;
+    }
+
+    pQueue->maxLen = mtu - ATT_VALUE_NTF_LEN;
+    pQueue->len = 0;
+    started = TRUE;
+  }
+  else
+  {
+    attsCoalCb.stats.merged++;
+  }
+
+  memcpy(pQueue->pBuf + pQueue->len, pValue, valueLen);
+  pQueue->len += valueLen;
+  filled = (pQueue->len == pQueue->maxLen);
+
+  WsfTaskUnlock();
+
+  if (pFull != NULL)
+  {
+    attsCoalSend(connId, idx, pFull, fullLen);
+  }
+
+  if (filled || (attsCoalCb.reg[idx].deadlineMs == 0))
+  {
+    attsCoalFlush(connId, idx);
+  }
+  else if (started)
+  {
+    WsfTimerStartMs(&pQueue->timer, attsCoalCb.reg[idx].deadlineMs);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the notification coalescing statistics.
+ *
+ *  \param  pStats  Returned statistics.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsCoalGetStats(attsCoalStats_t *pStats)
+{
+  WsfTaskLock();
+  memcpy(pStats, &attsCoalCb.stats, sizeof(attsCoalStats_t));
+  WsfTaskUnlock();
+}
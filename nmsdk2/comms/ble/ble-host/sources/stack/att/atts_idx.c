@@ -0,0 +1,447 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  ATT server attribute database index.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The index holds the registered attribute groups in an array sorted by handle and every
+ *  attribute in an array sorted by UUID key and handle, so handle and UUID lookups are binary
+ *  searches instead of walks over the group queue.  16 bit UUIDs, and 128 bit UUIDs built on the
+ *  Bluetooth base UUID, are keyed by their 16 bit value.  Other 128 bit UUIDs are keyed by a fold
+ *  of the UUID; every hit is confirmed with a full UUID compare.
+ *
+ *  The index is rebuilt whenever a group is added or removed.  If the database does not fit the
+ *  index the ATT server falls back to the linear searches.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_trace.h"
+#include "util/bstream.h"
+#include "cfg_stack.h"
+#include "att_api.h"
+#include "att_main.h"
+#include "atts_main.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/* position of the 16 bit value within the base UUID */
+#define ATTS_IDX_BASE_UUID_POS   12
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/* Index entry of a single attribute */
+typedef struct
+{
+  uint16_t          key;                              /* UUID key */
+  uint16_t          handle;                           /* Attribute handle */
+} attsIdxEntry_t;
+
+/* Index control block */
+typedef struct
+{
+  attsGroup_t       *pGroup[ATTS_IDX_MAX_GROUPS];     /* Groups sorted by start handle */
+  attsIdxEntry_t    entry[ATTS_IDX_MAX_ATTR];         /* Attributes sorted by key and handle */
+  uint16_t          numEntries;                       /* Number of attributes in the index */
+  uint8_t           numGroups;                        /* Number of groups in the index */
+  bool_t            valid;                            /* TRUE if the whole database is indexed */
+  bool_t            disabled;                         /* TRUE to use the linear searches */
+} attsIdxCb_t;
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+static const uint8_t attsIdxBaseUuid[ATT_128_UUID_LEN] = {0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00,
+                                                          0x00, 0x80, 0x00, 0x10, 0x00, 0x00,
+                                                          0x00, 0x00, 0x00, 0x00};
+
+static attsIdxCb_t attsIdxCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Compute the index key of a UUID.
+ *
+ *  \param  uuidLen UUID length, either 2 or 16.
+ *  \param  pUuid   Pointer to UUID.
+ *
+ *  \return UUID key.
+ */
+/*************************************************************************************************/
+static uint16_t attsIdxKey(uint8_t uuidLen, const uint8_t *pUuid)
+{
+  uint16_t key;
+  uint16_t word;
+  uint8_t  i;
+
+  /* 16 bit UUID or 128 bit form of a 16 bit UUID */
+  if (uuidLen == ATT_16_UUID_LEN)
+  {
+    BYTES_TO_UINT16(key, pUuid);
+    return key;
+  }
+
+  if ((memcmp(pUuid, attsIdxBaseUuid, ATTS_IDX_BASE_UUID_POS) == 0) &&
+      (pUuid[ATTS_IDX_BASE_UUID_POS + 2] == 0) && (pUuid[ATTS_IDX_BASE_UUID_POS + 3] == 0))
+  {
+    BYTES_TO_UINT16(key, &pUuid[ATTS_IDX_BASE_UUID_POS]);
+    return key;
+  }
+
+  /* fold vendor specific UUID */
+  key = 0;
+  for (i = 0; i < ATT_128_UUID_LEN; i += 2)
+  {
+    BYTES_TO_UINT16(word, &pUuid[i]);
+    key ^= word;
+  }
+
+  return key;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Compare two index entries.
+ *
+ *  \param  pA  First entry.
+ *  \param  pB  Second entry.
+ *
+ *  \return TRUE if pA sorts before pB.
+ */
+/*************************************************************************************************/
+static bool_t attsIdxEntryLess(const attsIdxEntry_t *pA, const attsIdxEntry_t *pB)
+{
+  return (pA->key < pB->key) || ((pA->key == pB->key) && (pA->handle < pB->handle));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the position of the first group ending at or after the given handle.
+ *
+ *  \param  handle  Attribute handle.
+ *
+ *  \return Group position, numGroups if there is none.
+ */
+/*************************************************************************************************/
+static uint8_t attsIdxGroupPos(uint16_t handle)
+{
+  uint8_t lo = 0;
+  uint8_t hi = attsIdxCb.numGroups;
+  uint8_t mid;
+
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
+
+    if (attsIdxCb.pGroup[mid]->endHandle < handle)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Rebuild the index from the attribute group queue.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void attsIdxRebuild(void)
+{
+  attsGroup_t     *pGroup;
+  attsAttr_t      *pAttr;
+  attsIdxEntry_t  entry;
+  uint16_t        handle;
+  uint16_t        i;
+
+  attsIdxCb.numGroups = 0;
+  attsIdxCb.numEntries = 0;
+  attsIdxCb.valid = FALSE;
+
+  /* group queue is already sorted by start handle */
+  for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
+  {
+    if ((attsIdxCb.numGroups == ATTS_IDX_MAX_GROUPS) ||
+        ((attsIdxCb.numEntries + (pGroup->endHandle - pGroup->startHandle + 1)) > ATTS_IDX_MAX_ATTR))
+    {
+      ATT_TRACE_WARN0("ATTS index full, using linear search");
+      return;
+    }
+
+    attsIdxCb.pGroup[attsIdxCb.numGroups++] = pGroup;
+
+    /* insertion sort; the database changes rarely and the index is small */
+    pAttr = pGroup->pAttr;
+    for (handle = pGroup->startHandle; handle <= pGroup->endHandle; handle++, pAttr++)
+    {
+      entry.key = attsIdxKey((pAttr->settings & ATTS_SET_UUID_128) ? ATT_128_UUID_LEN : ATT_16_UUID_LEN,
+                             pAttr->pUuid);
+      entry.handle = handle;
+
+      for (i = attsIdxCb.numEntries; (i > 0) && attsIdxEntryLess(&entry, &attsIdxCb.entry[i - 1]); i--)
+      {
+        attsIdxCb.entry[i] = attsIdxCb.entry[i - 1];
+      }
+      attsIdxCb.entry[i] = entry;
+      attsIdxCb.numEntries++;
+
+      /* special case of max handle value */
+      if (handle == ATT_HANDLE_MAX)
+      {
+        break;
+      }
+    }
+  }
+
+  attsIdxCb.valid = TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check whether lookups can be served from the index.
+ *
+ *  \return TRUE if the index is usable.
+ */
+/*************************************************************************************************/
+bool_t attsIdxReady(void)
+{
+  return attsIdxCb.valid && !attsIdxCb.disabled;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the group containing the given handle or, failing that, the first group after it.
+ *
+ *  \param  handle  Attribute handle.
+ *
+ *  \return Pointer to group or NULL if there are no groups at or after the handle.
+ */
+/*************************************************************************************************/
+attsGroup_t *attsIdxFindGroup(uint16_t handle)
+{
+  uint8_t pos = attsIdxGroupPos(handle);
+
+  return (pos < attsIdxCb.numGroups) ? attsIdxCb.pGroup[pos] : NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the first attribute within the given handle range with a matching UUID.
+ *
+ *  \param  startHandle   Starting attribute handle.
+ *  \param  endHandle     Ending attribute handle.
+ *  \param  uuidLen       UUID length, either 2 or 16.
+ *  \param  pUuid         Pointer to UUID.
+ *  \param  pAttr         Return value pointer to found attribute.
+ *  \param  pAttrGroup    Return value pointer to found attribute's group.
+ *
+ *  \return Attribute handle or ATT_HANDLE_NONE if not found.
+ */
+/*************************************************************************************************/
+uint16_t attsIdxFindUuid(uint16_t startHandle, uint16_t endHandle, uint8_t uuidLen,
+                         uint8_t *pUuid, attsAttr_t **pAttr, attsGroup_t **pAttrGroup)
+{
+  attsIdxEntry_t  target;
+  attsGroup_t     *pGroup;
+  uint16_t        lo = 0;
+  uint16_t        hi = attsIdxCb.numEntries;
+  uint16_t        mid;
+
+  target.key = attsIdxKey(uuidLen, pUuid);
+  target.handle = startHandle;
+
+  /* first entry not less than (key, startHandle) */
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
+
+    if (attsIdxEntryLess(&attsIdxCb.entry[mid], &target))
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  for (; (lo < attsIdxCb.numEntries) && (attsIdxCb.entry[lo].key == target.key) &&
+         (attsIdxCb.entry[lo].handle <= endHandle); lo++)
+  {
+    pGroup = attsIdxFindGroup(attsIdxCb.entry[lo].handle);
+    WSF_ASSERT(pGroup != NULL);
+
+    *pAttr = &pGroup->pAttr[attsIdxCb.entry[lo].handle - pGroup->startHandle];
+
+    /* keys of vendor specific UUIDs may collide */
+    if (attsUuidCmp(*pAttr, uuidLen, pUuid))
+    {
+      *pAttrGroup = pGroup;
+      return attsIdxCb.entry[lo].handle;
+    }
+  }
+
+  return ATT_HANDLE_NONE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the handle of the last attribute in a service group.
+ *
+ *  \param  startHandle   Starting attribute handle of service.
+ *
+ *  \return Service group end handle.
+ */
+/*************************************************************************************************/
+uint16_t attsIdxFindServiceGroupEnd(uint16_t startHandle)
+{
+  attsAttr_t    *pAttr;
+  attsGroup_t   *pGroup;
+  uint16_t      nextHandle;
+  uint16_t      secHandle;
+  uint8_t       pos;
+  uint8_t       primSvcUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_PRIMARY_SERVICE)};
+  uint8_t       secSvcUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_SECONDARY_SERVICE)};
+
+  /* special case for max handle */
+  if (startHandle == ATT_HANDLE_MAX)
+  {
+    return ATT_HANDLE_MAX;
+  }
+
+  /* next primary or secondary service declaration */
+  nextHandle = attsIdxFindUuid(startHandle + 1, ATT_HANDLE_MAX, ATT_16_UUID_LEN, primSvcUuid,
+                               &pAttr, &pGroup);
+  secHandle = attsIdxFindUuid(startHandle + 1, ATT_HANDLE_MAX, ATT_16_UUID_LEN, secSvcUuid,
+                              &pAttr, &pGroup);
+
+  if ((nextHandle == ATT_HANDLE_NONE) || ((secHandle != ATT_HANDLE_NONE) && (secHandle < nextHandle)))
+  {
+    nextHandle = secHandle;
+  }
+
+  /* next service not found; return 0xFFFF as the last handle in the database */
+  if (nextHandle == ATT_HANDLE_NONE)
+  {
+    return ATT_HANDLE_MAX;
+  }
+
+  /* return handle of the attribute before the next service */
+  pos = attsIdxGroupPos(nextHandle);
+  if (nextHandle > attsIdxCb.pGroup[pos]->startHandle)
+  {
+    return nextHandle - 1;
+  }
+
+  if ((pos > 0) && (attsIdxCb.pGroup[pos - 1]->endHandle > startHandle))
+  {
+    return attsIdxCb.pGroup[pos - 1]->endHandle;
+  }
+
+  return startHandle;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Enable or disable the attribute database index.
+ *
+ *  \param  enable  TRUE to serve lookups from the index, FALSE to use the linear searches.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AttsIdxEnable(bool_t enable)
+{
+  attsIdxCb.disabled = !enable;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Replay the server side lookups of a full GATT discovery of the local database.
+ *
+ *  Performs the lookups a client causes with primary service discovery, characteristic
+ *  discovery and descriptor discovery followed by a read of every attribute, without sending
+ *  any PDUs.  Used to measure the cost of the lookups with and without the index.
+ *
+ *  \return Number of lookups performed.
+ */
+/*************************************************************************************************/
+uint16_t AttsIdxReplayDiscovery(void)
+{
+  attsAttr_t    *pAttr;
+  attsGroup_t   *pGroup;
+  uint16_t      svcHandle;
+  uint16_t      svcEnd;
+  uint16_t      handle;
+  uint16_t      lookups = 0;
+  uint8_t       primSvcUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_PRIMARY_SERVICE)};
+  uint8_t       charUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_CHARACTERISTIC)};
+
+  /* read by group type, primary service */
+  svcHandle = ATT_HANDLE_START;
+  while ((svcHandle = attsFindUuidInRange(svcHandle, ATT_HANDLE_MAX, ATT_16_UUID_LEN, primSvcUuid,
+                                          &pAttr, &pGroup)) != ATT_HANDLE_NONE)
+  {
+    svcEnd = attsFindServiceGroupEnd(svcHandle);
+    lookups += 2;
+
+    /* read by type, characteristic */
+    handle = svcHandle;
+    while ((handle = attsFindUuidInRange(handle, svcEnd, ATT_16_UUID_LEN, charUuid,
+                                         &pAttr, &pGroup)) != ATT_HANDLE_NONE)
+    {
+      lookups++;
+      if (handle++ >= svcEnd)
+      {
+        break;
+      }
+    }
+
+    /* find information and read of every attribute in the service */
+    handle = svcHandle;
+    while ((handle = attsFindInRange(handle, svcEnd, &pAttr)) != ATT_HANDLE_NONE)
+    {
+      attsFindByHandle(handle, &pGroup);
+      lookups += 2;
+      if (handle++ >= svcEnd)
+      {
+        break;
+      }
+    }
+
+    if (svcEnd == ATT_HANDLE_MAX)
+    {
+      break;
+    }
+    svcHandle = svcEnd + 1;
+  }
+
+  return lookups;
+}
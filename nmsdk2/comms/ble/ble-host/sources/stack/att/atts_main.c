@@ -28,7 +28,9 @@
 #include "wsf_trace.h"
 #include "wsf_buf.h"
 #include "wsf_msg.h"
+#include "wsf_nvm.h"
 #include "util/bstream.h"
+#include "util/crc32.h"
 #include "util/wstr.h"
 #include "att_api.h"
 #include "att_main.h"
@@ -39,12 +41,47 @@
   Macros
 **************************************************************************************************/
 
+/* NVM dataset holding the last database hash */
+#define ATTS_DBH_NVM_DATASET_ID   0xB000
+
+/* Initial value of the database hash input fingerprint */
+#define ATTS_DBH_CRC_INIT         0xFFFFFFFF
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
 
 /* ATTS control block */
 
+/* Serialized database hash input of an attribute group */
+typedef struct
+{
+  attsGroup_t       *pGroup;                          /* Attribute group, NULL if unused */
+  uint16_t          offset;                           /* Offset of the hash input in buf */
+  uint16_t          len;                              /* Length of the hash input */
+} attsDbhGroup_t;
+
+/* Database hash and the fingerprint of the input it was calculated from */
+typedef struct
+{
+  uint32_t          fingerprint;                      /* CRC of the hash input */
+  uint16_t          len;                              /* Length of the hash input */
+  uint8_t           hash[SEC_CMAC_HASH_LEN];          /* Database hash */
+} attsDbhRecord_t;
+
+/* Database hash control block */
+typedef struct
+{
+  attsDbhGroup_t    group[ATTS_DBH_MAX_GROUPS];       /* Hash input per group */
+  uint8_t           buf[ATTS_DBH_BUF_SIZE];           /* Hash input of all groups, packed */
+  uint16_t          bufUsed;                          /* Bytes of buf in use */
+  attsDbhRecord_t   stored;                           /* Hash stored in NVM */
+  attsDbhRecord_t   pending;                          /* Hash being calculated */
+  bool_t            storedValid;                      /* TRUE if stored holds a hash */
+  bool_t            storedLoaded;                     /* TRUE once NVM has been read */
+  uint8_t           pendingCount;                     /* Number of CMAC calculations in progress */
+} attsDbhCb_t;
+
 /**************************************************************************************************
   Function Prototypes
 **************************************************************************************************/
@@ -58,6 +95,9 @@ static void attsL2cCtrlCback(wsfMsgHdr_t *pMsg);
   Local Variables
 **************************************************************************************************/
 
+/* Database hash control block */
+static attsDbhCb_t attsDbhCb;
+
 /* Interface to ATT */
 static const attFcnIf_t attsFcnIf =
 {
@@ -257,8 +297,9 @@ static void attsConnCback(attCcb_t *pCcb, dmEvt_t *pDmEvt)
     }
   }
 
-  /* pass event to indication interface */
+  /* pass event to indication and coalescing interfaces */
   (*attsCb.pInd->connCback)(pCcb, pDmEvt);
+  (*attsCb.pCoal->connCback)(pCcb, pDmEvt);
 }
 
 /*************************************************************************************************/
@@ -293,6 +334,11 @@ static void attsMsgCback(wsfMsgHdr_t *pMsg)
     /* handle database hash update */
     attsProcessDatabaseHashUpdate((secCmacMsg_t *) pMsg);
   }
+  /* pass event to notification coalescing interface */
+  else if (pMsg->event == ATTS_MSG_COAL_TIMEOUT)
+  {
+    (*attsCb.pCoal->msgCback)(pMsg);
+  }
 }
 
 /*************************************************************************************************/
@@ -306,8 +352,9 @@ static void attsMsgCback(wsfMsgHdr_t *pMsg)
 /*************************************************************************************************/
 static void attsL2cCtrlCback(wsfMsgHdr_t *pMsg)
 {
-  /* pass event to indication interface */
+  /* pass event to indication and coalescing interfaces */
   (*attsCb.pInd->ctrlCback)(pMsg);
+  (*attsCb.pCoal->ctrlCback)(pMsg);
 }
 
 /*************************************************************************************************/
@@ -398,6 +445,7 @@ void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg)
   attsAttr_t *pAttr;
   attsGroup_t *pGroup;
   uint16_t dbhCharHandle;
+  bool_t calculated = FALSE;
 
   /* send to application */
   evt.hdr.event = ATTS_DB_HASH_CALC_CMPL_IND;
@@ -409,16 +457,32 @@ void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg)
   evt.continuing = FALSE;
   evt.mtu = 0;
 
-  /* free plain text buffer */
+  /* free plain text buffer; a stored hash is served without one */
   if (pMsg->pPlainText != NULL)
   {
     WsfBufFree(pMsg->pPlainText);
     pMsg->pPlainText = NULL;
+    calculated = TRUE;
   }
 
   /* copy in little endian */
   evt.pValue = pMsg->pCiphertext;
 
+  /* CMACs complete in order, the last one matches the pending fingerprint */
+  if (calculated && (attsDbhCb.pendingCount > 0) && (--attsDbhCb.pendingCount == 0))
+  {
+    memcpy(attsDbhCb.pending.hash, pMsg->pCiphertext, SEC_CMAC_HASH_LEN);
+
+    if (!attsDbhCb.storedValid ||
+        (memcmp(&attsDbhCb.stored, &attsDbhCb.pending, sizeof(attsDbhRecord_t)) != 0))
+    {
+      attsDbhCb.stored = attsDbhCb.pending;
+      attsDbhCb.storedValid = TRUE;
+      WsfNvmWriteData(ATTS_DBH_NVM_DATASET_ID, (uint8_t *) &attsDbhCb.stored,
+                      sizeof(attsDbhRecord_t), NULL);
+    }
+  }
+
   /* find GATT database handle */
   dbhCharHandle = attsFindUuidInRange(ATT_HANDLE_START, ATT_HANDLE_MAX, ATT_16_UUID_LEN,
                                       (uint8_t *) attGattDbhChUuid, &pAttr, &pGroup);
@@ -571,7 +635,9 @@ void AttsInit(void)
 {
   /* Initialize control block */
   WSF_QUEUE_INIT(&attsCb.groupQueue);
+  attsIdxRebuild();
   attsCb.pInd = &attFcnDefault;
+  attsCb.pCoal = &attFcnDefault;
   attsCb.signMsgCback = (attMsgHandler_t) attEmptyHandler;
 
   /* set up callback interfaces */
@@ -608,28 +674,211 @@ bool_t AttsHashDatabaseString(uint8_t *pKey, uint8_t *pMsg, uint16_t msgLen)
   return SecCmac(pKey, pMsg, msgLen, attCb.handlerId, 0, ATTS_MSG_DBH_CMAC_CMPL);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Serialize the database hash input of an attribute group.
+ *
+ *  \param  pGroup  Attribute group.
+ *  \param  p       Buffer to serialize to, NULL to only get the length.
+ *
+ *  \return Length of the hash input of the group.
+ */
+/*************************************************************************************************/
+static uint16_t attsDbhSerialize(attsGroup_t *pGroup, uint8_t *p)
+{
+  uint16_t len = 0;
+  uint16_t attHandle = pGroup->startHandle;
+
+  /* For each attribute in the service */
+  for (attsAttr_t *pAttr = pGroup->pAttr; attHandle <= pGroup->endHandle; attHandle++, pAttr++)
+  {
+    uint16_t valLen;
+    uint8_t uuidLen = 2;
+
+    valLen = attsIsHashableAttr(pAttr);
+    if (valLen && (p != NULL))
+    {
+      /* Add handle */
+      UINT16_TO_BSTREAM(p, attHandle);
+
+      /* Add attribute type*/
+      if (pAttr->settings & ATTS_SET_UUID_128)
+      {
+        memcpy(p, pAttr->pUuid, 16);
+        p += 16;
+        uuidLen = 16;
+      }
+      else
+      {
+        uint16_t uuid;
+        BYTES_TO_UINT16(uuid, pAttr->pUuid);
+        UINT16_TO_BSTREAM(p,uuid);
+      }
+
+      /* Add Attribute value if required */
+      if (valLen - (uuidLen + 2))
+      {
+        memcpy(p, pAttr->pValue, *pAttr->pLen);
+        p += *pAttr->pLen;
+      }
+    }
+    len += valLen;
+
+    /* special case of max handle value */
+    if (attHandle == ATT_HANDLE_MAX)
+    {
+      break;
+    }
+  }
+
+  return len;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the memoized database hash input of an attribute group, serializing the group if
+ *          it has not been seen before.
+ *
+ *  \param  pGroup  Attribute group.
+ *
+ *  \return Memoized hash input or NULL if it could not be kept.
+ */
+/*************************************************************************************************/
+static attsDbhGroup_t *attsDbhGroupInput(attsGroup_t *pGroup)
+{
+  attsDbhGroup_t *pFree = NULL;
+  uint8_t i;
+
+  for (i = 0; i < ATTS_DBH_MAX_GROUPS; i++)
+  {
+    if (attsDbhCb.group[i].pGroup == pGroup)
+    {
+      return &attsDbhCb.group[i];
+    }
+    else if ((attsDbhCb.group[i].pGroup == NULL) && (pFree == NULL))
+    {
+      pFree = &attsDbhCb.group[i];
+    }
+  }
+
+  if (pFree != NULL)
+  {
+    pFree->len = attsDbhSerialize(pGroup, NULL);
+
+    if (pFree->len <= (ATTS_DBH_BUF_SIZE - attsDbhCb.bufUsed))
+    {
+      pFree->offset = attsDbhCb.bufUsed;
+      attsDbhSerialize(pGroup, &attsDbhCb.buf[pFree->offset]);
+      attsDbhCb.bufUsed += pFree->len;
+      pFree->pGroup = pGroup;
+      return pFree;
+    }
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Discard the memoized database hash input of an attribute group.
+ *
+ *  \param  pGroup  Attribute group.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void attsDbhGroupForget(attsGroup_t *pGroup)
+{
+  attsDbhGroup_t *pInput = NULL;
+  uint16_t end;
+  uint8_t i;
+
+  for (i = 0; i < ATTS_DBH_MAX_GROUPS; i++)
+  {
+    if (attsDbhCb.group[i].pGroup == pGroup)
+    {
+      pInput = &attsDbhCb.group[i];
+      break;
+    }
+  }
+
+  if (pInput == NULL)
+  {
+    return;
+  }
+
+  /* close the gap in buf and move the inputs stored after it down */
+  end = pInput->offset + pInput->len;
+  memmove(&attsDbhCb.buf[pInput->offset], &attsDbhCb.buf[end], attsDbhCb.bufUsed - end);
+  attsDbhCb.bufUsed -= pInput->len;
+
+  for (i = 0; i < ATTS_DBH_MAX_GROUPS; i++)
+  {
+    if ((attsDbhCb.group[i].pGroup != NULL) && (attsDbhCb.group[i].offset >= end))
+    {
+      attsDbhCb.group[i].offset -= pInput->len;
+    }
+  }
+
+  pInput->pGroup = NULL;
+  pInput->offset = 0;
+  pInput->len = 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Complete a database hash calculation with a known hash.
+ *
+ *  \param  pHash   Database hash.
+ *
+ *  \return \ref TRUE if successful, \ref FALSE if not.
+ */
+/*************************************************************************************************/
+static bool_t attsDbhSendHash(const uint8_t *pHash)
+{
+  secCmacMsg_t *pMsg;
+
+  /* complete through the same message as a CMAC so the application sees no difference */
+  if ((pMsg = WsfMsgAlloc(sizeof(secCmacMsg_t) + SEC_CMAC_HASH_LEN)) == NULL)
+  {
+    return FALSE;
+  }
+
+  pMsg->hdr.event = ATTS_MSG_DBH_CMAC_CMPL;
+  pMsg->hdr.status = 0;
+  pMsg->hdr.param = 0;
+  pMsg->pPlainText = NULL;
+  pMsg->pCiphertext = (uint8_t *) (pMsg + 1);
+  memcpy(pMsg->pCiphertext, pHash, SEC_CMAC_HASH_LEN);
+
+  WsfMsgSend(attCb.handlerId, pMsg);
+
+  return TRUE;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Calculate database hash from the GATT database.
  *
  *  \return None.
+ *
+ *  \note   The hash input of each group is serialized once and kept in a static buffer until
+ *          the group is removed or added again. When the input matches the one of the hash stored
+ *          in NVM the stored hash is used without running the CMAC.
  */
 /*************************************************************************************************/
 void AttsCalculateDbHash(void)
 {
   uint16_t msgLen = 0;
   uint8_t *pMsg;
+  attsDbhGroup_t *pInput;
   attsGroup_t *pGroup = (attsGroup_t *) attsCb.groupQueue.pHead;
 
   /* Determine length of message. */
   while (pGroup != NULL)
   {
-    uint8_t numAttrs = (pGroup->endHandle - pGroup->startHandle) + 1;
-
-    for (attsAttr_t *pAttr = pGroup->pAttr; numAttrs != 0; numAttrs--, pAttr++)
-    {
-      msgLen += attsIsHashableAttr(pAttr);
-    }
+    pInput = attsDbhGroupInput(pGroup);
+    msgLen += (pInput != NULL) ? pInput->len : attsDbhSerialize(pGroup, NULL);
 
     pGroup = pGroup->pNext;
   }
@@ -640,54 +889,55 @@ void AttsCalculateDbHash(void)
     pGroup = (attsGroup_t *)attsCb.groupQueue.pHead;
     uint8_t hashingKey[16] = { 0, };
     uint8_t *p = pMsg;
+    uint32_t fingerprint;
 
     /* For each service in services */
     while (pGroup)
     {
-      uint16_t attHandle = pGroup->startHandle;
-
-      /* For each attribute in the service */
-      for (attsAttr_t *pAttr = pGroup->pAttr; attHandle <= pGroup->endHandle; attHandle++, pAttr++)
+      if ((pInput = attsDbhGroupInput(pGroup)) != NULL)
       {
-        uint16_t valLen;
-        uint8_t uuidLen = 2;
-
-        valLen = attsIsHashableAttr(pAttr);
-        if (valLen)
-        {
-          /* Add handle */
-          UINT16_TO_BSTREAM(p, attHandle);
-
-          /* Add attribute type*/
-          if (pAttr->settings & ATTS_SET_UUID_128)
-          {
-            memcpy(p, pAttr->pUuid, 16);
-            p += 16;
-            uuidLen = 16;
-          }
-          else
-          {
-            uint16_t uuid;
-            BYTES_TO_UINT16(uuid, pAttr->pUuid);
-            UINT16_TO_BSTREAM(p,uuid);
-          }
-
-          /* Add Attribute value if required */
-          if (valLen - (uuidLen + 2))
-          {
-            memcpy(p, pAttr->pValue, *pAttr->pLen);
-            p += *pAttr->pLen;
-          }
-        }
+        memcpy(p, &attsDbhCb.buf[pInput->offset], pInput->len);
+        p += pInput->len;
+      }
+      else
+      {
+        p += attsDbhSerialize(pGroup, p);
       }
 
       pGroup = pGroup->pNext;
     }
 
-    /* Send to CMAC */
-    if (AttsHashDatabaseString(hashingKey, pMsg, msgLen))
+    fingerprint = CalcCrc32(ATTS_DBH_CRC_INIT, msgLen, pMsg);
+
+    if (!attsDbhCb.storedLoaded)
     {
-      return;
+      attsDbhCb.storedLoaded = TRUE;
+      attsDbhCb.storedValid = WsfNvmReadData(ATTS_DBH_NVM_DATASET_ID, (uint8_t *) &attsDbhCb.stored,
+                                             sizeof(attsDbhRecord_t), NULL);
+    }
+
+    /* Unchanged database, serve the stored hash */
+    if (attsDbhCb.storedValid && (attsDbhCb.pendingCount == 0) &&
+        (attsDbhCb.stored.fingerprint == fingerprint) && (attsDbhCb.stored.len == msgLen))
+    {
+      WsfBufFree(pMsg);
+
+      if (attsDbhSendHash(attsDbhCb.stored.hash))
+      {
+        return;
+      }
+    }
+    else
+    {
+      attsDbhCb.pending.fingerprint = fingerprint;
+      attsDbhCb.pending.len = msgLen;
+
+      /* Send to CMAC */
+      if (AttsHashDatabaseString(hashingKey, pMsg, msgLen))
+      {
+        attsDbhCb.pendingCount++;
+        return;
+      }
     }
   }
 
@@ -725,8 +975,10 @@ void AttsAddGroup(attsGroup_t *pGroup)
     pElem = pElem->pNext;
   }
 
-  /* insert new group */
+  /* insert new group; a dynamic group may reuse the memory of a removed one */
   WsfQueueInsert(&attsCb.groupQueue, pGroup, pPrev);
+  attsIdxRebuild();
+  attsDbhGroupForget(pGroup);
 
   /* set database hash update status to true until a new hash is generated */
   attsCsfSetHashUpdateStatus(TRUE);
@@ -769,6 +1021,8 @@ void AttsRemoveGroup(uint16_t startHandle)
   if (pElem != NULL)
   {
     WsfQueueRemove(&attsCb.groupQueue, pElem, pPrev);
+    attsIdxRebuild();
+    attsDbhGroupForget(pElem);
   }
   else
   {
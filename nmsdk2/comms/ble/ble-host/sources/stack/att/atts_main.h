@@ -43,7 +43,8 @@ enum
   ATTS_MSG_API_VALUE_IND_NTF,
   ATTS_MSG_IND_TIMEOUT,
   ATTS_MSG_SIGN_CMAC_CMPL,
-  ATTS_MSG_DBH_CMAC_CMPL
+  ATTS_MSG_DBH_CMAC_CMPL,
+  ATTS_MSG_COAL_TIMEOUT
 };
 
 /*!
@@ -102,6 +103,7 @@ typedef struct
 {
   wsfQueue_t        groupQueue;       /* Queue of attribute groups */
   attFcnIf_t const  *pInd;            /* Indication callback interface */
+  attFcnIf_t const  *pCoal;           /* Notification coalescing callback interface */
   attMsgHandler_t   signMsgCback;     /* Signed data callback interface */
   attsAuthorCback_t authorCback;      /* Authorization callback */
   attsCccFcn_t      cccCback;         /* CCC callback */
@@ -143,12 +145,20 @@ attsAttr_t *attsFindByHandle(uint16_t handle, attsGroup_t **pAttrGroup);
 uint16_t attsFindInRange(uint16_t startHandle, uint16_t endHandle, attsAttr_t **pAttr);
 uint16_t attsFindUuidInRange(uint16_t startHandle, uint16_t endHandle, uint8_t uuidLen,
                              uint8_t *pUuid, attsAttr_t **pAttr, attsGroup_t **pAttrGroup);
+uint16_t attsFindServiceGroupEnd(uint16_t startHandle);
 uint8_t attsPermissions(dmConnId_t connId, uint8_t permit, uint16_t handle, uint8_t permissions);
 void attsDiscBusy(attCcb_t *pCcb);
 void attsCheckPendDbHashReadRsp(void);
 void attsProcessDatabaseHashUpdate(secCmacMsg_t *pMsg);
 uint16_t attsIsHashableAttr(attsAttr_t *pAttr);
 
+void attsIdxRebuild(void);
+bool_t attsIdxReady(void);
+attsGroup_t *attsIdxFindGroup(uint16_t handle);
+uint16_t attsIdxFindUuid(uint16_t startHandle, uint16_t endHandle, uint8_t uuidLen,
+                         uint8_t *pUuid, attsAttr_t **pAttr, attsGroup_t **pAttrGroup);
+uint16_t attsIdxFindServiceGroupEnd(uint16_t startHandle);
+
 void attsProcMtuReq(attCcb_t *pCcb, uint16_t len, uint8_t *pPacket);
 void attsProcFindInfoReq(attCcb_t *pCcb, uint16_t len, uint8_t *pPacket);
 void attsProcFindTypeReq(attCcb_t *pCcb, uint16_t len, uint8_t *pPacket);
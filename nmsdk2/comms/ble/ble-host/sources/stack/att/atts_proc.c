@@ -101,6 +101,19 @@ attsAttr_t *attsFindByHandle(uint16_t handle, attsGroup_t **pAttrGroup)
 {
   attsGroup_t   *pGroup;
 
+  /* binary search of the group index */
+  if (attsIdxReady())
+  {
+    pGroup = attsIdxFindGroup(handle);
+    if ((pGroup != NULL) && (handle >= pGroup->startHandle))
+    {
+      *pAttrGroup = pGroup;
+      return &pGroup->pAttr[handle - pGroup->startHandle];
+    }
+
+    return NULL;
+  }
+
   /* iterate over attribute group list */
   for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
   {
@@ -132,6 +145,20 @@ uint16_t attsFindInRange(uint16_t startHandle, uint16_t endHandle, attsAttr_t **
 {
   attsGroup_t   *pGroup;
 
+  /* binary search of the group index */
+  if (attsIdxReady())
+  {
+    pGroup = attsIdxFindGroup(startHandle);
+    if ((pGroup != NULL) && (endHandle >= pGroup->startHandle))
+    {
+      startHandle = WSF_MAX(startHandle, pGroup->startHandle);
+      *pAttr = &pGroup->pAttr[startHandle - pGroup->startHandle];
+      return startHandle;
+    }
+
+    return ATT_HANDLE_NONE;
+  }
+
   /* iterate over attribute group list */
   for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
   {
@@ -52,6 +52,12 @@ uint16_t attsFindUuidInRange(uint16_t startHandle, uint16_t endHandle, uint8_t u
 {
   attsGroup_t *pGroup;
 
+  /* look up the UUID index */
+  if (attsIdxReady())
+  {
+    return attsIdxFindUuid(startHandle, endHandle, uuidLen, pUuid, pAttr, pAttrGroup);
+  }
+
   /* iterate over attribute group list */
   for (pGroup = attsCb.groupQueue.pHead; pGroup != NULL; pGroup = pGroup->pNext)
   {
@@ -109,6 +115,12 @@ uint16_t attsFindServiceGroupEnd(uint16_t startHandle)
   uint8_t       primSvcUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_PRIMARY_SERVICE)};
   uint8_t       secSvcUuid[ATT_16_UUID_LEN] = {UINT16_TO_BYTES(ATT_UUID_SECONDARY_SERVICE)};
 
+  /* look up the UUID index */
+  if (attsIdxReady())
+  {
+    return attsIdxFindServiceGroupEnd(startHandle);
+  }
+
   /* special case for max handle */
   if (startHandle == ATT_HANDLE_MAX)
   {
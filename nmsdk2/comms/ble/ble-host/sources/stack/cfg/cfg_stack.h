@@ -115,6 +115,12 @@ extern "C" {
 #ifndef L2C_COC_REG_MAX
 #define L2C_COC_REG_MAX          4
 #endif
+
+/*! \brief Delay in milliseconds before a connection oriented channel that ran out of buffers
+ *  tries again to send data */
+#ifndef L2C_COC_TX_RETRY_MS
+#define L2C_COC_TX_RETRY_MS      10
+#endif
 /**@}*/
 
 /**************************************************************************************************
@@ -134,6 +140,36 @@ extern "C" {
 #ifndef ATT_NUM_SIMUL_NTF
 #define ATT_NUM_SIMUL_NTF        1
 #endif
+
+/*! \brief Maximum number of attribute groups in the ATT server index */
+#ifndef ATTS_IDX_MAX_GROUPS
+#define ATTS_IDX_MAX_GROUPS      16
+#endif
+
+/*! \brief Maximum number of attributes in the ATT server index */
+#ifndef ATTS_IDX_MAX_ATTR
+#define ATTS_IDX_MAX_ATTR        160
+#endif
+
+/*! \brief Maximum number of attribute groups with a memoized database hash input */
+#ifndef ATTS_DBH_MAX_GROUPS
+#define ATTS_DBH_MAX_GROUPS      16
+#endif
+
+/*! \brief Size in bytes of the memoized database hash input of all attribute groups */
+#ifndef ATTS_DBH_BUF_SIZE
+#define ATTS_DBH_BUF_SIZE        768
+#endif
+
+/*! \brief Maximum number of characteristics with coalesced notifications */
+#ifndef ATTS_COAL_HDL_MAX
+#define ATTS_COAL_HDL_MAX        2
+#endif
+
+/*! \brief Controller ACL buffers left free when sending coalesced notifications */
+#ifndef ATTS_COAL_ACL_RESERVE
+#define ATTS_COAL_ACL_RESERVE    0
+#endif
 /**@}*/
 
 /**************************************************************************************************
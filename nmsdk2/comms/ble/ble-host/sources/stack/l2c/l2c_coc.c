@@ -57,7 +57,8 @@ enum
   L2C_MSG_API_DISCONNECT_REQ,
 
   /* messages from timers */
-  L2C_MSG_COC_REQ_TIMEOUT
+  L2C_MSG_COC_REQ_TIMEOUT,
+  L2C_MSG_COC_TX_RETRY
 };
 
 /**************************************************************************************************
@@ -113,6 +114,7 @@ typedef struct
   l2cRegCb_t        *pRegCb;              /* Pointer to associated registration control block */
   l2cConnCb_t       *pConnCb;             /* Pointer to associated connection control block */
   wsfTimer_t        reqTimer;             /* Signaling request timeout timer */
+  wsfTimer_t        txTimer;              /* Tx retry timer when out of buffers */
   uint8_t           *pTxPkt;              /* Pointer to tx packet in progress */
   uint8_t           *pRxPkt;              /* Pointer to rx packet in progress */
   uint16_t          txTotalLen;           /* Total length of tx data */
@@ -328,6 +330,9 @@ l2cChanCb_t *l2cChanCbAlloc(uint8_t state)
       pCb->state = state;
       pCb->reqTimer.msg.param = pCb->localCid = i + L2C_CID_DYN_MIN;
       pCb->reqTimer.msg.event = L2C_MSG_COC_REQ_TIMEOUT;
+      pCb->txTimer.msg.param = pCb->localCid;
+      pCb->txTimer.msg.event = L2C_MSG_COC_TX_RETRY;
+      pCb->txTimer.handlerId = l2cCocCb.handlerId;
       L2C_TRACE_INFO1("l2cChanCbAlloc cid=0x%04x", pCb->localCid);
 
       return pCb;
@@ -444,6 +449,7 @@ void l2cChanCbDealloc(l2cChanCb_t *pCb)
 
   pCb->state = L2C_CHAN_STATE_UNUSED;
   WsfTimerStop(&pCb->reqTimer);
+  WsfTimerStop(&pCb->txTimer);
   if (pCb->pRxPkt != NULL)
   {
     WsfMsgFree(pCb->pRxPkt);
@@ -916,7 +922,7 @@ static void l2cCocSendData(l2cChanCb_t *pChanCb)
   uint16_t  len;
   uint8_t   *pBuf;
 
-  L2C_TRACE_INFO3("l2cCocSendData pTxPkt:%x peerCredits:%d flowDisabled:%d", (uint32_t)pChanCb->pTxPkt, pChanCb->peerCredits, pChanCb->pConnCb->flowDisabled);
+  L2C_TRACE_INFO3("l2cCocSendData pTxPkt:%x peerCredits:%d flowDisabled:%d", (uint32_t)(uintptr_t)pChanCb->pTxPkt, pChanCb->peerCredits, pChanCb->pConnCb->flowDisabled);
 
   /* while we have data and peer credits and flow is not disabled */
   while (pChanCb->pTxPkt != NULL && pChanCb->peerCredits > 0 && !pChanCb->pConnCb->flowDisabled)
@@ -947,6 +953,12 @@ static void l2cCocSendData(l2cChanCb_t *pChanCb)
         l2cDataCnf(pChanCb, L2C_COC_DATA_SUCCESS);
       }
     }
+    else
+    {
+      /* out of buffers; retry once buffers are freed */
+      WsfTimerStartMs(&pChanCb->txTimer, L2C_COC_TX_RETRY_MS);
+      break;
+    }
   }
 }
 
@@ -1417,6 +1429,8 @@ void l2cCocSignalingCback(uint16_t handle, uint16_t l2cLen, uint8_t *pPacket)
 static void l2cCocCtrlCback(wsfMsgHdr_t *pMsg)
 {
   l2cConnCb_t *pConnCb = l2cConnCbById((dmConnId_t) pMsg->param);
+  l2cChanCb_t *pChanCb = l2cCocCb.chanCb;
+  uint8_t     i;
 
   /* store flow control state */
   pConnCb->flowDisabled = (pMsg->event == L2C_CTRL_FLOW_DISABLE_IND);
@@ -1424,8 +1438,15 @@ static void l2cCocCtrlCback(wsfMsgHdr_t *pMsg)
   /* if flow enabled */
   if (!pConnCb->flowDisabled)
   {
-    /* check for pending data to be sent on this connection */
-    //tbd
+    /* resume segmentation of any packet left on deck on this connection */
+    for (i = 0; i < L2C_COC_CHAN_MAX; i++, pChanCb++)
+    {
+      if ((pChanCb->pConnCb == pConnCb) && (pChanCb->state == L2C_CHAN_STATE_CONNECTED) &&
+          (pChanCb->pTxPkt != NULL))
+      {
+        l2cCocSendData(pChanCb);
+      }
+    }
   }
 }
 
@@ -1591,6 +1612,26 @@ static void l2cCocReqTimeout(wsfMsgHdr_t *pMsg)
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Process a tx retry timeout.
+ *
+ *  \param  pMsg  Message buffer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void l2cCocTxRetry(wsfMsgHdr_t *pMsg)
+{
+  l2cChanCb_t *pChanCb = l2cChanCbByCidState(pMsg->param, L2C_CHAN_STATE_CONNECTED);
+
+  /* resume segmentation of the packet left on deck */
+  if (pChanCb != NULL)
+  {
+    l2cCocSendData(pChanCb);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Initialize L2C connection oriented channel subsystem.
@@ -1655,6 +1696,10 @@ void L2cCocHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
         l2cCocReqTimeout(pMsg);
         break;
 
+      case L2C_MSG_COC_TX_RETRY:
+        l2cCocTxRetry(pMsg);
+        break;
+
       default:
         break;
     }
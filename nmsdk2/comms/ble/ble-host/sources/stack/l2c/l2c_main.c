@@ -142,6 +142,7 @@ static void l2cHciAclCback(uint8_t *pPacket)
   uint16_t  cid;
   uint16_t  l2cLen;
   uint8_t   *p = pPacket;
+  dmConnId_t connId;
 
   /* parse HCI handle and length */
   BSTREAM_TO_UINT16(handle, p);
@@ -164,6 +165,12 @@ static void l2cHciAclCback(uint8_t *pPacket)
     /* parse CID */
     BSTREAM_TO_UINT16(cid, p);
 
+    /* count traffic for the connection */
+    if ((connId = DmConnIdByHandle(handle)) != DM_CONN_ID_NONE)
+    {
+      l2cCb.rxBytes[connId - 1] += l2cLen;
+    }
+
     switch (cid)
     {
       case L2C_CID_LE_SIGNALING:
@@ -336,7 +343,14 @@ void L2cRegister(uint16_t cid, l2cDataCback_t dataCback, l2cCtrlCback_t ctrlCbac
 /*************************************************************************************************/
 void L2cDataReq(uint16_t cid, uint16_t handle, uint16_t len, uint8_t *pPacket)
 {
-  uint8_t *p = pPacket;
+  uint8_t    *p = pPacket;
+  dmConnId_t connId;
+
+  /* count traffic for the connection */
+  if ((connId = DmConnIdByHandle(handle)) != DM_CONN_ID_NONE)
+  {
+    l2cCb.txBytes[connId - 1] += len;
+  }
 
   /* Set HCI header */
   UINT16_TO_BSTREAM(p, handle);
@@ -349,3 +363,23 @@ void L2cDataReq(uint16_t cid, uint16_t handle, uint16_t len, uint8_t *pPacket)
   /* Send to HCI */
   HciSendAclData(pPacket);
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the L2CAP payload bytes sent and received on a connection.  The counters are
+ *          free running; callers work with differences between two reads.
+ *
+ *  \param  connId     DM connection ID.
+ *  \param  pTxBytes   Returned bytes sent.
+ *  \param  pRxBytes   Returned bytes received.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void L2cGetTraffic(dmConnId_t connId, uint32_t *pTxBytes, uint32_t *pRxBytes)
+{
+  WSF_ASSERT((connId > 0) && (connId <= DM_CONN_MAX));
+
+  *pTxBytes = l2cCb.txBytes[connId - 1];
+  *pRxBytes = l2cCb.rxBytes[connId - 1];
+}
@@ -60,6 +60,8 @@ typedef struct
   l2cDataCback_t    masterRxSignalingPkt;     /* Master signaling packet processing function */
   l2cDataCback_t    slaveRxSignalingPkt;      /* Slave signaling packet processing function */
   l2cDataCidCback_t l2cDataCidCback;          /* Data callback for L2CAP on other CIDs */
+  uint32_t          txBytes[DM_CONN_MAX];     /* L2CAP payload bytes sent per connection */
+  uint32_t          rxBytes[DM_CONN_MAX];     /* L2CAP payload bytes received per connection */
   uint8_t           identifier;               /* Signaling request identifier */
 } l2cCb_t;
 
@@ -131,12 +131,11 @@ void AppMeshClearNvm(void);
  *  \brief  Initiate software system reset.
  *
  *  \return None.
+ *
+ *  \remarks Pending Local Config changes are stored before the reset.
  */
 /*************************************************************************************************/
-inline void AppMeshReset(void)
-{
-  /* Stub */
-}
+void AppMeshReset(void);
 
 /*************************************************************************************************/
 /*!
@@ -123,3 +123,18 @@ void AppMeshClearNvm(void)
   MeshLocalCfgEraseNvm();
   MeshRpNvmErase();
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initiate software system reset.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void AppMeshReset(void)
+{
+  /* Store the changes still in the Local Config commit window. */
+  MeshLocalCfgNvmFlush();
+
+  /* Stub */
+}
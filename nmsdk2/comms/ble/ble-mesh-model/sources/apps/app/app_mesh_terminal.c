@@ -43,6 +43,7 @@
 #include "mesh_prv.h"
 #include "mesh_prv_sr_api.h"
 #include "mesh_prv_cl_api.h"
+#include "mesh_local_config.h"
 #include "mesh_lpn_api.h"
 #include "mesh_friend_api.h"
 
@@ -365,6 +366,9 @@ static uint8_t appMeshTerminalResetHandler(uint32_t argc, char **argv)
   {
     if (strcmp(argv[1], "board") == 0)
     {
+      /* Store pending configuration changes. */
+      MeshLocalCfgNvmFlush();
+
       NVIC_SystemReset();
     }
     else if (strcmp(argv[1], "factory") == 0)
@@ -60,6 +60,14 @@
 /*! Publish retransmit steps to time in milliseconds */
 #define RETRANS_STEPS_TO_MS_TIME(steps) ((uint16_t)((steps) + 1) * 50)
 
+/*! Number of opcode dispatch table entries reserved for core models */
+#ifndef MESH_ACC_CORE_MDL_OP_MAX
+#define MESH_ACC_CORE_MDL_OP_MAX        (MESH_CFG_MDL_SR_MAX_OP + MESH_CFG_MDL_CL_MAX_OP)
+#endif
+
+/*! Key of an empty opcode dispatch table slot */
+#define MESH_ACC_OP_KEY_EMPTY           0xFFFFFFFFUL
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -288,64 +296,252 @@ static meshAddress_t meshAccFixedGroupToUnicast(meshAddress_t dst)
 
 /*************************************************************************************************/
 /*!
- *  \brief     Checks if a Mesh message must be sent to a core model and sends it.
+ *  \brief     Builds the opcode dispatch table key of an opcode received by an element.
  *
- *  \param[in] pAccToMdlMsgInfo  Pointer to structure identifying message and information to be sent
- *                               to Mesh models.
- *  \param[in] elemId            Local element identifier.
+ *  \param[in] elemId   Element identifier.
+ *  \param[in] pOpcode  Pointer to the opcode.
  *
- *  \return    None.
+ *  \return    Dispatch table key.
  *
+ *  \remarks   The opcode size is encoded in its first byte, so unused bytes are left zero.
  */
 /*************************************************************************************************/
-static void meshAccSendMsgToCoreMdl(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo, meshElementId_t elemId)
+static inline uint32_t meshAccOpKey(meshElementId_t elemId, const meshMsgOpcode_t *pOpcode)
 {
-  meshAccCoreMdl_t *ptr;
-  uint16_t count;
-  uint8_t opIdx;
+  uint32_t key = ((uint32_t)elemId << 24) | ((uint32_t)pOpcode->opcodeBytes[0] << 16);
 
-  /* Get core models count. */
-  count = WsfQueueCount(&(meshAccCb.coreMdlQueue));
+  if (MESH_OPCODE_SIZE(*pOpcode) > 1)
+  {
+    key |= (uint32_t)pOpcode->opcodeBytes[1] << 8;
+  }
+  if (MESH_OPCODE_SIZE(*pOpcode) > 2)
+  {
+    key |= (uint32_t)pOpcode->opcodeBytes[2];
+  }
 
-  while (count > 0)
+  return key;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Computes the home slot of a key in the opcode dispatch table.
+ *
+ *  \param[in] key  Dispatch table key.
+ *
+ *  \return    Slot index.
+ */
+/*************************************************************************************************/
+static inline uint16_t meshAccOpHash(uint32_t key)
+{
+  /* Multiplicative hashing, the high bits of the product are the best mixed. */
+  return (uint16_t)((key * 0x9E3779B1UL) >> (32 - meshAccCb.opTableBits));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Gets the number of opcode dispatch table slots for the configured models.
+ *
+ *  \param[out] pOutBits  Pointer to memory where log2 of the number of slots is stored or NULL.
+ *
+ *  \return    Number of slots.
+ */
+/*************************************************************************************************/
+static uint16_t meshAccOpTableGetSize(uint8_t *pOutBits)
+{
+  uint32_t numOpcodes = MESH_ACC_CORE_MDL_OP_MAX;
+  uint16_t size = 2;
+  uint8_t bits = 1;
+  uint8_t elemId, modelIdx;
+
+  for (elemId = 0; elemId < pMeshConfig->elementArrayLen; elemId++)
   {
-    /* Get identification information. */
-    ptr = (meshAccCoreMdl_t *)WsfQueueDeq(&(meshAccCb.coreMdlQueue));
+    for (modelIdx = 0; modelIdx < pMeshConfig->pElementArray[elemId].numSigModels; modelIdx++)
+    {
+      numOpcodes += SIG_MODEL_INSTANCE(elemId, modelIdx).opcodeCount;
+    }
+    for (modelIdx = 0; modelIdx < pMeshConfig->pElementArray[elemId].numVendorModels; modelIdx++)
+    {
+      numOpcodes += VENDOR_MODEL_INSTANCE(elemId, modelIdx).opcodeCount;
+    }
+  }
 
-    /* Enqueue back. */
-    WsfQueueEnq(&(meshAccCb.coreMdlQueue), (void *)ptr);
+  /* Keep the load factor at or below one half so probe sequences stay short. */
+  while (size < 2 * numOpcodes)
+  {
+    size <<= 1;
+    bits++;
+  }
 
-    /* Check if registered element matches destination element. */
-    /* Note: pointer cannot be NULL */
-    /* coverity[dereference] */
-    if (ptr->elemId == elemId)
+  if (pOutBits != NULL)
+  {
+    *pOutBits = bits;
+  }
+
+  return size;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Adds an opcode to the dispatch table.
+ *
+ *  \param[in] elemId    Identifier of the element containing the model.
+ *  \param[in] pOpcode   Pointer to the opcode.
+ *  \param[in] pCoreMdl  Pointer to the core model handling the opcode or NULL for a model instance.
+ *  \param[in] idx       Model instance index or core model opcode index.
+ *  \param[in] isSig     TRUE if the model instance is a SIG model.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshAccOpTableInsert(meshElementId_t elemId, const meshMsgOpcode_t *pOpcode,
+                                 meshAccCoreMdl_t *pCoreMdl, uint8_t idx, bool_t isSig)
+{
+  meshAccOpEntry_t *pEntry;
+  uint32_t key = meshAccOpKey(elemId, pOpcode);
+  uint16_t slot;
+
+  /* Always leave a free slot to terminate probe sequences. */
+  if ((meshAccCb.pOpTable == NULL) || ((meshAccCb.opTableCount + 1) >= meshAccCb.opTableSize))
+  {
+    MESH_TRACE_ERR0("MESH ACC: Opcode dispatch table full ");
+    return;
+  }
+
+  slot = meshAccOpHash(key);
+
+  /* Duplicates are kept so that every model handling the opcode is reached. */
+  while (meshAccCb.pOpTable[slot].key != MESH_ACC_OP_KEY_EMPTY)
+  {
+    slot = (slot + 1) & (meshAccCb.opTableSize - 1);
+  }
+
+  pEntry = &meshAccCb.pOpTable[slot];
+  pEntry->key = key;
+  pEntry->pCoreMdl = pCoreMdl;
+  pEntry->idx = idx;
+  pEntry->isSig = isSig;
+
+  meshAccCb.opTableCount++;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief         Finds the next dispatch table entry matching a key.
+ *
+ *  \param[in]     key    Dispatch table key.
+ *  \param[in,out] pSlot  Pointer to the slot to start from. Initialize with ::meshAccOpHash.
+ *                        Updated to continue the search on the next call.
+ *
+ *  \return        Pointer to the entry or NULL if there are no more matches.
+ */
+/*************************************************************************************************/
+static meshAccOpEntry_t *meshAccOpTableFind(uint32_t key, uint16_t *pSlot)
+{
+  meshAccOpEntry_t *pEntry;
+  uint16_t slot = *pSlot;
+
+  while (meshAccCb.pOpTable[slot].key != MESH_ACC_OP_KEY_EMPTY)
+  {
+    pEntry = &meshAccCb.pOpTable[slot];
+    slot = (slot + 1) & (meshAccCb.opTableSize - 1);
+
+    if (pEntry->key == key)
+    {
+      *pSlot = slot;
+      return pEntry;
+    }
+  }
+
+  *pSlot = slot;
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Allocates the opcode dispatch table and adds the opcodes of all configured models.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void meshAccOpTableInit(void)
+{
+  const meshMsgOpcode_t *pOpcodeArray;
+  uint8_t elemId, modelIdx, opIdx;
+
+  meshAccCb.opTableSize = meshAccOpTableGetSize(&meshAccCb.opTableBits);
+  meshAccCb.opTableCount = 0;
+
+  /* Allocate memory. */
+  meshAccCb.pOpTable = (meshAccOpEntry_t *)meshCb.pMemBuff;
+  /* Forward pointer. */
+  meshCb.pMemBuff += MESH_UTILS_ALIGN(meshAccCb.opTableSize * sizeof(meshAccOpEntry_t));
+  /* Decrement used memory. */
+  meshCb.memBuffSize -= MESH_UTILS_ALIGN(meshAccCb.opTableSize * sizeof(meshAccOpEntry_t));
+
+  /* Mark all slots empty. */
+  memset(meshAccCb.pOpTable, 0xFF, meshAccCb.opTableSize * sizeof(meshAccOpEntry_t));
+
+  for (elemId = 0; elemId < pMeshConfig->elementArrayLen; elemId++)
+  {
+    /* SIG models only receive SIG opcodes and vendor models only vendor opcodes. */
+    for (modelIdx = 0; modelIdx < pMeshConfig->pElementArray[elemId].numSigModels; modelIdx++)
     {
-      /* Iterate through the opcode list. */
-      for (opIdx = 0; opIdx < ptr->opcodeArrayLen; opIdx++)
+      pOpcodeArray = SIG_MODEL_INSTANCE(elemId, modelIdx).pRcvdOpcodeArray;
+
+      for (opIdx = 0; (pOpcodeArray != NULL) &&
+                      (opIdx < SIG_MODEL_INSTANCE(elemId, modelIdx).opcodeCount); opIdx++)
       {
-        /* Check if opcodes don't match. */
-        if ((pAccToMdlMsgInfo->opcode.opcodeBytes[0] != ptr->pOpcodeArray[opIdx].opcodeBytes[0]))
+        if (!MESH_OPCODE_IS_VENDOR(pOpcodeArray[opIdx]))
         {
-          continue;
+          meshAccOpTableInsert(elemId, &pOpcodeArray[opIdx], NULL, modelIdx, TRUE);
         }
-        if ((MESH_OPCODE_SIZE(pAccToMdlMsgInfo->opcode) > 1) &&
-            ((pAccToMdlMsgInfo->opcode.opcodeBytes[1] != ptr->pOpcodeArray[opIdx].opcodeBytes[1])))
-        {
-          continue;
-        }
-        if ((MESH_OPCODE_SIZE(pAccToMdlMsgInfo->opcode) > 2) &&
-            ((pAccToMdlMsgInfo->opcode.opcodeBytes[2] != ptr->pOpcodeArray[opIdx].opcodeBytes[2])))
+      }
+    }
+
+    for (modelIdx = 0; modelIdx < pMeshConfig->pElementArray[elemId].numVendorModels; modelIdx++)
+    {
+      pOpcodeArray = VENDOR_MODEL_INSTANCE(elemId, modelIdx).pRcvdOpcodeArray;
+
+      for (opIdx = 0; (pOpcodeArray != NULL) &&
+                      (opIdx < VENDOR_MODEL_INSTANCE(elemId, modelIdx).opcodeCount); opIdx++)
+      {
+        if (MESH_OPCODE_IS_VENDOR(pOpcodeArray[opIdx]))
         {
-          continue;
+          meshAccOpTableInsert(elemId, &pOpcodeArray[opIdx], NULL, modelIdx, FALSE);
         }
-        /* Invoke callback. */
-        ptr->msgRecvCback(opIdx, pAccToMdlMsgInfo->pMsgParam,
-                          pAccToMdlMsgInfo->msgParamLen, pAccToMdlMsgInfo->src, elemId,
-                          pAccToMdlMsgInfo->ttl, pAccToMdlMsgInfo->netKeyIndex);
-        return;
       }
     }
-    count--;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if a Mesh message must be sent to a core model and sends it.
+ *
+ *  \param[in] pAccToMdlMsgInfo  Pointer to structure identifying message and information to be sent
+ *                               to Mesh models.
+ *  \param[in] elemId            Local element identifier.
+ *
+ *  \return    None.
+ *
+ */
+/*************************************************************************************************/
+static void meshAccSendMsgToCoreMdl(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo, meshElementId_t elemId)
+{
+  meshAccOpEntry_t *pEntry;
+  uint32_t key = meshAccOpKey(elemId, &pAccToMdlMsgInfo->opcode);
+  uint16_t slot = meshAccOpHash(key);
+
+  while ((pEntry = meshAccOpTableFind(key, &slot)) != NULL)
+  {
+    if (pEntry->pCoreMdl != NULL)
+    {
+      /* Invoke callback. */
+      pEntry->pCoreMdl->msgRecvCback(pEntry->idx, pAccToMdlMsgInfo->pMsgParam,
+                                     pAccToMdlMsgInfo->msgParamLen, pAccToMdlMsgInfo->src, elemId,
+                                     pAccToMdlMsgInfo->ttl, pAccToMdlMsgInfo->netKeyIndex);
+      return;
+    }
   }
 }
 
@@ -362,6 +558,9 @@ static void meshAccSendMsgToCoreMdl(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo, mes
  *  \param[in] isSig             TRUE if the list to search is SIG models, FALSE otherwise.
  *
  *  \return    None.
+ *
+ *  \remarks   The model instance is found through the opcode dispatch table, so it is known to
+ *             handle the opcode.
  */
 /*************************************************************************************************/
 static void meshAccSendMsgToModelInstance(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo,
@@ -369,20 +568,13 @@ static void meshAccSendMsgToModelInstance(meshAccToMdlMsgInfo_t *pAccToMdlMsgInf
                                           uint8_t modelIdx,
                                           bool_t isSig)
 {
-  const meshMsgOpcode_t *pOpcodeArray;
   wsfHandlerId_t *pHandlerId;
   meshModelId_t mdlId;
-  uint8_t opcodeArrayLen;
-  uint8_t jj;
 
   mdlId.isSigModel = isSig;
 
-  /* Get opcode list. */
   if (mdlId.isSigModel)
   {
-    /* Save opcode list. */
-    pOpcodeArray   = SIG_MODEL_INSTANCE(dstElemId, modelIdx).pRcvdOpcodeArray;
-    opcodeArrayLen = SIG_MODEL_INSTANCE(dstElemId, modelIdx).opcodeCount;
     /* Build generic model Id. */
     mdlId.modelId.sigModelId = SIG_MODEL_INSTANCE(dstElemId, modelIdx).modelId;
     /* Save handler Id. */
@@ -390,60 +582,25 @@ static void meshAccSendMsgToModelInstance(meshAccToMdlMsgInfo_t *pAccToMdlMsgInf
   }
   else
   {
-    /* Save opcode list. */
-    pOpcodeArray   = VENDOR_MODEL_INSTANCE(dstElemId, modelIdx).pRcvdOpcodeArray;
-    opcodeArrayLen = VENDOR_MODEL_INSTANCE(dstElemId, modelIdx).opcodeCount;
     /* Build generic model Id. */
     mdlId.modelId.vendorModelId = VENDOR_MODEL_INSTANCE(dstElemId, modelIdx).modelId;
     /* Save handler Id. */
     pHandlerId = VENDOR_MODEL_INSTANCE(dstElemId, modelIdx).pHandlerId;
   }
 
-  if ((pOpcodeArray != NULL) && (pHandlerId != NULL))
+  if (pHandlerId == NULL)
   {
-    /* Iterate through the opcode list. */
-    for (jj = 0; jj < opcodeArrayLen; jj++)
-    {
-      /* Check if opcodes don't match. */
-      if ((pAccToMdlMsgInfo->opcode.opcodeBytes[0] != pOpcodeArray[jj].opcodeBytes[0]))
-      {
-        continue;
-      }
-      if ((MESH_OPCODE_SIZE(pAccToMdlMsgInfo->opcode) > 1) &&
-          ((pAccToMdlMsgInfo->opcode.opcodeBytes[1] != pOpcodeArray[jj].opcodeBytes[1])))
-      {
-        continue;
-      }
-      if ((MESH_OPCODE_SIZE(pAccToMdlMsgInfo->opcode) > 2) &&
-          ((pAccToMdlMsgInfo->opcode.opcodeBytes[2] != pOpcodeArray[jj].opcodeBytes[2])))
-      {
-        continue;
-      }
-      /* Validate that correct Application Key is used. */
-      if (MeshLocalCfgValidateModelToAppKeyBind(dstElemId, &mdlId, pAccToMdlMsgInfo->appKeyIndex))
-      {
-        /* Send WSF message. */
-        meshAccSendWsfMsgRecvEvt(pAccToMdlMsgInfo, dstElemId, pHandlerId, &mdlId);
-      }
-      /* There should be no duplicates of opcodes for the same model and element. */
-      break;
-    }
+    MESH_TRACE_ERR1("MESH ACC: WSF Handler not installed for model %d ",
+                     (mdlId.isSigModel ? mdlId.modelId.sigModelId :
+                                         mdlId.modelId.vendorModelId));
+    return;
   }
-  else
-  {
-    if(pHandlerId == NULL)
-    {
-      MESH_TRACE_ERR1("MESH ACC: WSF Handler not installed for model %d ",
-                       (mdlId.isSigModel ? mdlId.modelId.sigModelId :
-                                           mdlId.modelId.vendorModelId));
-    }
 
-    if(pOpcodeArray == NULL)
-    {
-      MESH_TRACE_ERR1("MESH ACC: Opcode list NULL for model %d ",
-                      (mdlId.isSigModel ? mdlId.modelId.sigModelId :
-                                          mdlId.modelId.vendorModelId));
-    }
+  /* Validate that correct Application Key is used. */
+  if (MeshLocalCfgValidateModelToAppKeyBind(dstElemId, &mdlId, pAccToMdlMsgInfo->appKeyIndex))
+  {
+    /* Send WSF message. */
+    meshAccSendWsfMsgRecvEvt(pAccToMdlMsgInfo, dstElemId, pHandlerId, &mdlId);
   }
 }
 
@@ -463,11 +620,9 @@ static void meshAccSendMsgToModelInstance(meshAccToMdlMsgInfo_t *pAccToMdlMsgInf
 static void meshAccSendMsgToModelUnicast(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo,
                                          meshElementId_t dstElemId)
 {
-  uint8_t mdlInstanceIdx;
-  /* Check if model is SIG or vendor based on opcode. */
-  bool_t isSigModel = !MESH_OPCODE_IS_VENDOR(pAccToMdlMsgInfo->opcode);
-  uint8_t numModels = isSigModel ? pMeshConfig->pElementArray[dstElemId].numSigModels :
-                                   pMeshConfig->pElementArray[dstElemId].numVendorModels;
+  meshAccOpEntry_t *pEntry;
+  uint32_t key;
+  uint16_t slot;
 
   /* Try to send message to core models only if they are using device keys. */
   if ((pAccToMdlMsgInfo->appKeyIndex == MESH_APPKEY_INDEX_LOCAL_DEV_KEY) ||
@@ -481,10 +636,16 @@ static void meshAccSendMsgToModelUnicast(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo
     return;
   }
 
-  /* Search standalone model list. */
-  for (mdlInstanceIdx = 0; mdlInstanceIdx < numModels; mdlInstanceIdx++)
+  key = meshAccOpKey(dstElemId, &pAccToMdlMsgInfo->opcode);
+  slot = meshAccOpHash(key);
+
+  /* Send to the standalone models of the element handling the opcode. */
+  while ((pEntry = meshAccOpTableFind(key, &slot)) != NULL)
   {
-    meshAccSendMsgToModelInstance(pAccToMdlMsgInfo, dstElemId, mdlInstanceIdx, isSigModel);
+    if (pEntry->pCoreMdl == NULL)
+    {
+      meshAccSendMsgToModelInstance(pAccToMdlMsgInfo, dstElemId, pEntry->idx, pEntry->isSig);
+    }
   }
 }
 
@@ -501,25 +662,34 @@ static void meshAccSendMsgToModelUnicast(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo
 /*************************************************************************************************/
 static void meshAccSendMsgToModelMulticast(meshAccToMdlMsgInfo_t *pAccToMdlMsgInfo)
 {
-  uint8_t elemId, modelIdx;
+  meshAccOpEntry_t *pEntry;
   meshModelId_t mdlId;
-  uint8_t numModels;
-  mdlId.isSigModel = !MESH_OPCODE_IS_VENDOR(pAccToMdlMsgInfo->opcode);
+  uint32_t key;
+  uint16_t slot;
+  uint8_t elemId;
 
   for (elemId = 0; elemId < pMeshConfig->elementArrayLen; elemId++)
   {
-    numModels = mdlId.isSigModel ? pMeshConfig->pElementArray[elemId].numSigModels :
-                                   pMeshConfig->pElementArray[elemId].numVendorModels;
-    for (modelIdx = 0; modelIdx < numModels; modelIdx++)
+    key = meshAccOpKey(elemId, &pAccToMdlMsgInfo->opcode);
+    slot = meshAccOpHash(key);
+
+    /* Only models handling the opcode need their subscription list checked. */
+    while ((pEntry = meshAccOpTableFind(key, &slot)) != NULL)
     {
+      if (pEntry->pCoreMdl != NULL)
+      {
+        continue;
+      }
+
       /* Build generic model id. */
+      mdlId.isSigModel = pEntry->isSig;
       if (mdlId.isSigModel)
       {
-        mdlId.modelId.sigModelId = SIG_MODEL_INSTANCE(elemId,modelIdx).modelId;
+        mdlId.modelId.sigModelId = SIG_MODEL_INSTANCE(elemId, pEntry->idx).modelId;
       }
       else
       {
-        mdlId.modelId.vendorModelId = VENDOR_MODEL_INSTANCE(elemId, modelIdx).modelId;
+        mdlId.modelId.vendorModelId = VENDOR_MODEL_INSTANCE(elemId, pEntry->idx).modelId;
       }
 
       /* Check if model instance is subscribed to destination. */
@@ -527,7 +697,7 @@ static void meshAccSendMsgToModelMulticast(meshAccToMdlMsgInfo_t *pAccToMdlMsgIn
                                                 pAccToMdlMsgInfo->pDstLabelUuid))
       {
         /* Try to send message to model instance. */
-        meshAccSendMsgToModelInstance(pAccToMdlMsgInfo, elemId, modelIdx, mdlId.isSigModel);
+        meshAccSendMsgToModelInstance(pAccToMdlMsgInfo, elemId, pEntry->idx, mdlId.isSigModel);
       }
     }
   }
@@ -985,6 +1155,18 @@ static void meshUtrEventNotifyCback(meshUtrEvent_t event, void *pEventParam)
   Global Functions
 **************************************************************************************************/
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Gets memory required for the opcode dispatch table.
+ *
+ *  \return Opcode dispatch table memory required.
+ */
+/*************************************************************************************************/
+uint32_t MeshAccOpTableGetRequiredMemory(void)
+{
+  return MESH_UTILS_ALIGN(meshAccOpTableGetSize(NULL) * sizeof(meshAccOpEntry_t));
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Initializes the Mesh Access layer.
@@ -1005,6 +1187,9 @@ void MeshAccInit(void)
   WSF_QUEUE_INIT(&(meshAccCb.coreMdlQueue));
   WSF_QUEUE_INIT(&(meshAccCb.msgSendQueue));
 
+  /* Build the opcode dispatch table of the configured models. */
+  meshAccOpTableInit();
+
   /* Uninstall optional feature. */
   meshAccCb.ppChangedCback = meshAccEmptyPpChangedCback;
   meshAccCb.ppWsfMsgCback = meshEmptyAccPpMsgHandler;
@@ -1047,11 +1232,20 @@ void MeshAccRegisterLpn(meshAccFriendAddrFromSubnetCback_t cback)
 /*************************************************************************************************/
 void MeshAccRegisterCoreModel(meshAccCoreMdl_t *pCoreMdl)
 {
+  uint8_t opIdx;
+
   WSF_ASSERT(pCoreMdl != NULL);
   WSF_ASSERT(pCoreMdl->msgRecvCback != NULL);
   WSF_ASSERT(pCoreMdl->pOpcodeArray != NULL);
 
   WsfQueueEnq(&(meshAccCb.coreMdlQueue), (void *)pCoreMdl);
+
+  /* Add the core model opcodes to the dispatch table. */
+  for (opIdx = 0; opIdx < pCoreMdl->opcodeArrayLen; opIdx++)
+  {
+    meshAccOpTableInsert(pCoreMdl->elemId, &pCoreMdl->pOpcodeArray[opIdx], pCoreMdl, opIdx,
+                         pCoreMdl->mdlId.isSigModel);
+  }
 }
 
 /*************************************************************************************************/
@@ -63,6 +63,24 @@ enum meshAccWsfMsgEvents
 /*! Periodic publishing state changed callback */
 typedef void (*meshAccPpChangedCback_t)(meshElementId_t elemId, meshModelId_t *pModelId);
 
+/*! Opcode dispatch table entry. Maps an opcode received by an element to the model handling it. */
+typedef struct meshAccOpEntry_tag
+{
+  uint32_t                 key;                                  /*!< Element identifier and
+                                                                  *   opcode
+                                                                  */
+  meshAccCoreMdl_t         *pCoreMdl;                            /*!< Core model handling the
+                                                                  *   opcode or NULL for a model
+                                                                  *   instance
+                                                                  */
+  uint8_t                  idx;                                  /*!< Model instance index or core
+                                                                  *   model opcode index
+                                                                  */
+  bool_t                   isSig;                                /*!< TRUE if the model instance is
+                                                                  *   a SIG model
+                                                                  */
+} meshAccOpEntry_t;
+
 /*! Mesh Access Control Block */
 typedef struct meshAccCb_tag
 {
@@ -86,6 +104,12 @@ typedef struct meshAccCb_tag
   uint16_t                 tmrUidGen;                            /*!< Timer unique identifier
                                                                   *   generator variable
                                                                   */
+  meshAccOpEntry_t         *pOpTable;                            /*!< Opcode dispatch table */
+  uint16_t                 opTableSize;                          /*!< Number of dispatch table
+                                                                  *   slots, a power of two
+                                                                  */
+  uint16_t                 opTableCount;                         /*!< Number of used slots */
+  uint8_t                  opTableBits;                          /*!< Log2 of opTableSize */
 } meshAccCb_t;
 
 /**************************************************************************************************
@@ -95,6 +119,19 @@ typedef struct meshAccCb_tag
 /*! Control block for Mesh Access */
 extern meshAccCb_t meshAccCb;
 
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Gets memory required for the opcode dispatch table.
+ *
+ *  \return Opcode dispatch table memory required.
+ */
+/*************************************************************************************************/
+uint32_t MeshAccOpTableGetRequiredMemory(void);
+
 #ifdef __cplusplus
 }
 #endif
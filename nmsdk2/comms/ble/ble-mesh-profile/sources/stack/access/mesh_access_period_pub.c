@@ -407,7 +407,8 @@ static void meshAccHandlePpChanged(meshElementId_t elemId, uint8_t modelEntryIdx
 /*************************************************************************************************/
 uint32_t MeshAccGetRequiredMemory(void)
 {
-  return MESH_UTILS_ALIGN(meshAccPpGetNumModels() * sizeof(meshAccPpQueueElem_t));
+  return MESH_UTILS_ALIGN(meshAccPpGetNumModels() * sizeof(meshAccPpQueueElem_t)) +
+         MeshAccOpTableGetRequiredMemory();
 }
 
 /*************************************************************************************************/
@@ -1486,6 +1486,9 @@ void MeshLoadPrvData(const meshPrvData_t* pPrvData)
         MeshLocalCfgUpdateNetKey(pPrvData->netKeyIndex, pPrvData->pNetKey);
       }
 
+      /* Store the provisioning data at once so that a reset cannot leave the node unprovisioned. */
+      MeshLocalCfgNvmFlush();
+
       MESH_TRACE_INFO0("MESH API: Provisioning load success.");
 
       /* Send message to Network Management. */
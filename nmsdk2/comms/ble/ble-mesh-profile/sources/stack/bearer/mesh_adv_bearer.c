@@ -23,6 +23,7 @@
  */
 /*************************************************************************************************/
 
+#include <string.h>
 #include "wsf_types.h"
 #include "wsf_buf.h"
 #include "wsf_msg.h"
@@ -68,19 +69,26 @@
 /*! Structure containing information stored for each item in the queue */
 typedef struct meshAdvQueuedItem_tag
 {
-  uint8_t       *pBrPdu;  /*!< Bearer PDU data */
-  uint8_t       pduLen;   /*!< Bearer PDU length */
-  meshAdvType_t advType;  /*!< Advertising type */
+  uint8_t          *pBrPdu;   /*!< Bearer PDU data */
+  uint16_t         queuedAt;  /*!< Transmission count of the interface when queued */
+  uint8_t          pduLen;    /*!< Bearer PDU length */
+  meshAdvType_t    advType;   /*!< Advertising type */
+  meshAdvTxClass_t txClass;   /*!< Transmit class */
+  uint8_t          refCount;  /*!< Number of send requests merged in this item */
 } meshAdvQueuedItem_t;
 
 /*! Definition of the Advertising TX queue */
 typedef struct meshAdvQueue_tag
 {
-  meshAdvQueuedItem_t queueItem[MESH_ADV_QUEUE_SIZE];  /*!< FIFO queue items */
-  uint8_t             queueSize;                       /*!< Size of the FIFO queue */
-  uint8_t             queueHead;                       /*!< Index of the first element in the
-                                                        *   FIFO queue
-                                                        */
+  meshAdvQueuedItem_t queueItem[MESH_ADV_QUEUE_SIZE];   /*!< Queue items in arrival order */
+  meshAdvQueuedItem_t txItem;                           /*!< Item being sent over-the-air */
+  meshAdvQueueStats_t stats[MESH_ADV_TX_CLASS_MAX];     /*!< Statistics of each class */
+  uint16_t            txCount;                          /*!< Transmissions started */
+  uint8_t             queueSize;                        /*!< Number of queue items */
+  uint8_t             credit[MESH_ADV_TX_CLASS_MAX];    /*!< Sends left to each class in the
+                                                         *   current round
+                                                         */
+  bool_t              txPending;                        /*!< TRUE if txItem is being sent */
 } meshAdvQueue_t;
 
 /*! Definition of the Advertising Interface data  */
@@ -99,6 +107,14 @@ typedef struct meshAdvInterface_tag
   Local Variables
 **************************************************************************************************/
 
+/*! Weight of each transmit class in the advertising TX queue */
+static const uint8_t advTxWeight[MESH_ADV_TX_CLASS_MAX] =
+{
+  MESH_ADV_TX_WEIGHT_OWN,
+  MESH_ADV_TX_WEIGHT_RELAY,
+  MESH_ADV_TX_WEIGHT_BEACON
+};
+
 /*! Mesh Advertising Bearer control block */
 static struct meshAdvCb_tag
 {
@@ -198,101 +214,272 @@ static bool_t meshAdvTransmitPacket(meshAdvInterface_t *pAdvIf, meshAdvType_t ad
 /*************************************************************************************************/
 static void meshAdvQueueInit(meshAdvQueue_t *pQueue)
 {
-  pQueue->queueHead = 0;
-  pQueue->queueSize = 0;
+  memset(pQueue, 0, sizeof(meshAdvQueue_t));
+
+  /* Give every class the credit of a full round */
+  memcpy(pQueue->credit, advTxWeight, sizeof(pQueue->credit));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Signals the upper layer that a queued item has been processed by the bearer.
+ *
+ *  \param[in] pAdvIf  Pointer to interface entry in the interface array.
+ *  \param[in] pItem   Pointer to the processed item.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshAdvItemProcessed(meshAdvInterface_t *pAdvIf, meshAdvQueuedItem_t *pItem)
+{
+  meshAdvBrPduStatus_t pduStatus;
+  uint8_t i;
+
+  /* Callback should be assigned at initialization */
+  WSF_ASSERT(advBrCb.advBrNotifCback != NULL);
+
+  /* Signal the Network layer or Provisioning Bearer that the packet has been processed by the
+   * ADV bearer. This will help the layer remove any references of this packet. Merged requests
+   * hold one reference each.
+   */
+  if (pItem->advType == MESH_AD_TYPE_PACKET || pItem->advType == MESH_AD_TYPE_PB ||
+      pItem->advType == MESH_AD_TYPE_BEACON)
+  {
+    pduStatus.adType = pItem->advType;
+    pduStatus.pPdu = pItem->pBrPdu;
+
+    for (i = 0; i < pItem->refCount; i++)
+    {
+      advBrCb.advBrNotifCback(pAdvIf->advIfId, MESH_ADV_PACKET_PROCESSED,
+                              (meshAdvBrEventParams_t *)&pduStatus);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Removes an item from the specified TX queue.
+ *
+ *  \param[in] pQueue  Pointer to the queue structure.
+ *  \param[in] idx     Index of the item in the queue.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshAdvQueueRemove(meshAdvQueue_t *pQueue, uint8_t idx)
+{
+  /* Keep the remaining items in arrival order */
+  memmove(&pQueue->queueItem[idx], &pQueue->queueItem[idx + 1],
+          (pQueue->queueSize - idx - 1) * sizeof(meshAdvQueuedItem_t));
+
+  /* Decrease queue size by one item */
+  pQueue->queueSize--;
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief     Queues a bearer PDU in the specified TX queue of the advertising interface.
+ *  \brief     Queues a bearer PDU in the TX queue of the advertising interface.
  *
- *  \param[in] pQueue   Pointer to the queue structure.
+ *  \param[in] pAdvIf   Pointer to interface entry in the interface array.
  *  \param[in] advType  ADV type received. See ::meshAdvType.
  *  \param[in] pBrPdu   Pointer to a buffer containing a Mesh Bearer PDU.
  *  \param[in] pduLen   Size of the Mesh ADV Bearer PDU.
+ *  \param[in] txClass  Transmit class of the PDU. See ::meshAdvTxClassValues.
  *
- *  \return    TRUE if queue is not full, FALSE otherwise.
+ *  \return    TRUE if the PDU is queued or merged, FALSE otherwise.
+ *
+ *  \remarks   A PDU still waiting for transmission is not queued twice. The request is merged
+ *             with the queued item instead. When the queue is full a PDU of this node replaces
+ *             the oldest relayed PDU.
  */
 /*************************************************************************************************/
-static bool_t meshAdvQueueAdd(meshAdvQueue_t *pQueue, meshAdvType_t advType,
-                                       const uint8_t *pBrPdu, uint8_t pduLen)
-
+static bool_t meshAdvQueueAdd(meshAdvInterface_t *pAdvIf, meshAdvType_t advType,
+                              const uint8_t *pBrPdu, uint8_t pduLen, meshAdvTxClass_t txClass)
 {
-  uint8_t tail;
+  meshAdvQueue_t *pQueue = &pAdvIf->advTxQueue;
+  meshAdvQueuedItem_t *pItem;
+  uint8_t idx;
 
-  /* Check if queue is not full */
-  if (pQueue->queueSize < MESH_ADV_QUEUE_SIZE)
+  /* Merge with the same PDU if it is still waiting */
+  for (idx = 0; idx < pQueue->queueSize; idx++)
   {
-    tail = (pQueue->queueHead + pQueue->queueSize) % MESH_ADV_QUEUE_SIZE;
-
-    /* Copy in queued data */
-    pQueue->queueItem[tail].advType = advType;
-    pQueue->queueItem[tail].pBrPdu = (uint8_t *)pBrPdu;
-    pQueue->queueItem[tail].pduLen = pduLen;
-
-    /* Increase queue size by one item */
-    pQueue->queueSize++;
+    if ((pQueue->queueItem[idx].pBrPdu == pBrPdu) && (pQueue->queueItem[idx].advType == advType))
+    {
+      pQueue->queueItem[idx].refCount++;
+      pQueue->stats[txClass].merged++;
 
-    return TRUE;
+      return TRUE;
+    }
   }
-  else
+
+  /* Check if queue is full */
+  if (pQueue->queueSize == MESH_ADV_QUEUE_SIZE)
   {
-    return FALSE;
+    if (txClass == MESH_ADV_TX_CLASS_OWN)
+    {
+      /* Search for the oldest relayed PDU */
+      for (idx = 0; idx < pQueue->queueSize; idx++)
+      {
+        if (pQueue->queueItem[idx].txClass == MESH_ADV_TX_CLASS_RELAY)
+        {
+          break;
+        }
+      }
+    }
+    else
+    {
+      idx = pQueue->queueSize;
+    }
+
+    if (idx == pQueue->queueSize)
+    {
+      pQueue->stats[txClass].dropped++;
+
+      return FALSE;
+    }
+
+    /* Make room by dropping the relayed PDU */
+    meshAdvItemProcessed(pAdvIf, &pQueue->queueItem[idx]);
+    meshAdvQueueRemove(pQueue, idx);
+    pQueue->stats[MESH_ADV_TX_CLASS_RELAY].dropped++;
   }
+
+  /* Copy in queued data */
+  pItem = &pQueue->queueItem[pQueue->queueSize];
+  pItem->pBrPdu = (uint8_t *)pBrPdu;
+  pItem->queuedAt = pQueue->txCount;
+  pItem->pduLen = pduLen;
+  pItem->advType = advType;
+  pItem->txClass = txClass;
+  pItem->refCount = 1;
+
+  /* Increase queue size by one item */
+  pQueue->queueSize++;
+  pQueue->stats[txClass].queued++;
+
+  return TRUE;
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief      Peeks the head element in the specified TX queue.
+ *  \brief     Drops the relayed PDUs that waited in the TX queue past the deadline.
  *
- *  \param[in]  pQueue      Pointer to the queue structure.
- *  \param[out] ppPeekItem  Pointer to the address of the peeked item.
+ *  \param[in] pAdvIf  Pointer to interface entry in the interface array.
  *
- *  \return     TRUE if queue is not empty, FALSE otherwise.
+ *  \return    None.
  */
 /*************************************************************************************************/
-static bool_t meshAdvQueuePeekHead(meshAdvQueue_t *pQueue, meshAdvQueuedItem_t **ppPeekItem)
+static void meshAdvQueueDropStale(meshAdvInterface_t *pAdvIf)
 {
-  /* Check if queue is not empty */
-  if (pQueue->queueSize > 0)
-  {
-    /* Peek head item */
-    *ppPeekItem = &pQueue->queueItem[pQueue->queueHead];
+#if (MESH_ADV_RELAY_MAX_WAIT > 0)
+  meshAdvQueue_t *pQueue = &pAdvIf->advTxQueue;
+  uint8_t idx = 0;
 
-    return TRUE;
-  }
-  else
+  while (idx < pQueue->queueSize)
   {
-    return FALSE;
+    if ((pQueue->queueItem[idx].txClass == MESH_ADV_TX_CLASS_RELAY) &&
+        ((uint16_t)(pQueue->txCount - pQueue->queueItem[idx].queuedAt) > MESH_ADV_RELAY_MAX_WAIT))
+    {
+      meshAdvItemProcessed(pAdvIf, &pQueue->queueItem[idx]);
+      meshAdvQueueRemove(pQueue, idx);
+      pQueue->stats[MESH_ADV_TX_CLASS_RELAY].stale++;
+    }
+    else
+    {
+      idx++;
+    }
   }
+#else
+  (void)pAdvIf;
+#endif
 }
 
 /*************************************************************************************************/
 /*!
- *  \brief     Removes the head element from the specified TX queue.
+ *  \brief     Selects the next item to send from the specified TX queue.
  *
  *  \param[in] pQueue  Pointer to the queue structure.
  *
- *  \return    None.
+ *  \return    Index of the item in the queue, or queue size if the queue is empty.
+ *
+ *  \remarks   Classes are served in weighted round robin. A class with items and credit left is
+ *             served in class order and the oldest item of the class is sent. The credits are
+ *             reloaded when no class with items has credit left.
  */
 /*************************************************************************************************/
-static void meshAdvQueueRemoveHead(meshAdvQueue_t *pQueue)
+static uint8_t meshAdvQueueSelect(meshAdvQueue_t *pQueue)
 {
-  /* Check if queue is not empty */
-  if (pQueue->queueSize > 0)
-  {
-    /* Move queue head */
-    pQueue->queueHead++;
+  uint8_t round, txClass, idx;
 
-    /* Roll over queue head if we reach the maximum queue size */
-    if (pQueue->queueHead == MESH_ADV_QUEUE_SIZE)
+  for (round = 0; round < 2; round++)
+  {
+    for (txClass = 0; txClass < MESH_ADV_TX_CLASS_MAX; txClass++)
     {
-      pQueue->queueHead = 0;
+      if (pQueue->credit[txClass] == 0)
+      {
+        continue;
+      }
+
+      for (idx = 0; idx < pQueue->queueSize; idx++)
+      {
+        if (pQueue->queueItem[idx].txClass == txClass)
+        {
+          pQueue->credit[txClass]--;
+
+          return idx;
+        }
+      }
     }
 
-    /* Decrease queue size by one item */
-    pQueue->queueSize--;
+    /* Start a new round */
+    memcpy(pQueue->credit, advTxWeight, sizeof(pQueue->credit));
   }
+
+  return pQueue->queueSize;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Moves the next item to send from the TX queue of the advertising interface to the
+ *             item being sent.
+ *
+ *  \param[in] pAdvIf  Pointer to interface entry in the interface array.
+ *
+ *  \return    TRUE if an item is ready to be sent, FALSE if the queue is empty.
+ */
+/*************************************************************************************************/
+static bool_t meshAdvQueueNext(meshAdvInterface_t *pAdvIf)
+{
+  meshAdvQueue_t *pQueue = &pAdvIf->advTxQueue;
+  meshAdvQueueStats_t *pStats;
+  uint16_t wait;
+  uint8_t idx;
+
+  meshAdvQueueDropStale(pAdvIf);
+
+  idx = meshAdvQueueSelect(pQueue);
+  if (idx == pQueue->queueSize)
+  {
+    return FALSE;
+  }
+
+  pQueue->txItem = pQueue->queueItem[idx];
+  pQueue->txPending = TRUE;
+  meshAdvQueueRemove(pQueue, idx);
+
+  /* Update queue wait statistics */
+  pStats = &pQueue->stats[pQueue->txItem.txClass];
+  wait = pQueue->txCount - pQueue->txItem.queuedAt;
+  pStats->sent++;
+  pStats->waitSum += wait;
+  if (wait > pStats->waitMax)
+  {
+    pStats->waitMax = wait;
+  }
+
+  pQueue->txCount++;
+
+  return TRUE;
 }
 
 /*************************************************************************************************/
@@ -301,39 +488,28 @@ static void meshAdvQueueRemoveHead(meshAdvQueue_t *pQueue)
  *             sending events to the network layer for each queued item.
  *
  *  \param[in] pAdvIf   Pointer to interface entry in the interface array.
- *  \param[in] advType  ADV type received. See ::meshAdvType.
- *  \param[in] pBrPdu   Pointer to a buffer containing a Mesh Bearer PDU.
- *  \param[in] pduLen   Size of the Mesh ADV Bearer PDU.
  *
  *  \return    None.
  */
 /*************************************************************************************************/
 static void meshAdvEmptyQueue(meshAdvInterface_t *pAdvIf)
 {
-  meshAdvQueuedItem_t *pQueuedItem;
+  meshAdvQueue_t *pQueue = &pAdvIf->advTxQueue;
 
-  /* Callback should be assigned at initialization */
-  WSF_ASSERT(advBrCb.advBrNotifCback != NULL);
+  /* Signal the item being sent */
+  if (pQueue->txPending)
+  {
+    meshAdvItemProcessed(pAdvIf, &pQueue->txItem);
+    pQueue->txPending = FALSE;
+  }
 
   /* Go through all queued items and send status to Network layer*/
-  while (meshAdvQueuePeekHead(&pAdvIf->advTxQueue, &pQueuedItem))
+  while (pQueue->queueSize > 0)
   {
-    meshAdvBrPduStatus_t pduStatus;
-
-    /* Signal the Network layer that the packet has been processed by the bearer.
-     * This will help the layer remove any references of this packet.
-     */
-    if (pQueuedItem->advType == MESH_AD_TYPE_PACKET || pQueuedItem->advType == MESH_AD_TYPE_PB ||
-        pQueuedItem->advType == MESH_AD_TYPE_BEACON)
-    {
-      pduStatus.adType = pQueuedItem->advType;
-      pduStatus.pPdu = pQueuedItem->pBrPdu;
-      advBrCb.advBrNotifCback(pAdvIf->advIfId, MESH_ADV_PACKET_PROCESSED,
-                              (meshAdvBrEventParams_t *)&pduStatus);
-    }
+    meshAdvItemProcessed(pAdvIf, &pQueue->queueItem[0]);
 
-    /* Remove peeked item from the queue */
-    meshAdvQueueRemoveHead(&pAdvIf->advTxQueue);
+    /* Remove item from the queue */
+    meshAdvQueueRemove(pQueue, 0);
   }
 }
 
@@ -665,8 +841,7 @@ void MeshAdvSignalInterfaceReady(meshAdvIfId_t advIfId)
   };
 
   uint8_t advIfIndex;
-  meshAdvQueuedItem_t *pQueuedItem = NULL;
-  meshAdvBrPduStatus_t pduStatus;
+  meshAdvInterface_t *pAdvIf;
 
   /* Interface Id should have a valid value */
   WSF_ASSERT(MESH_ADV_IS_VALID_INTERFACE_ID(advIfId));
@@ -682,40 +857,31 @@ void MeshAdvSignalInterfaceReady(meshAdvIfId_t advIfId)
   }
   else
   {
-    /* The packet from the head of the queue was sent. Peek into it */
-    if (meshAdvQueuePeekHead(&(advBrCb.advInterfaces[advIfIndex].advTxQueue), &pQueuedItem))
-    {
-      /* Signal the Network layer or Provisioning Bearer that the packet has been processed by the
-       * ADV bearer. This will help the layer remove any references of this packet.
-       */
-      if (pQueuedItem->advType == MESH_AD_TYPE_PACKET || pQueuedItem->advType == MESH_AD_TYPE_PB ||
-          pQueuedItem->advType == MESH_AD_TYPE_BEACON)
-      {
-        pduStatus.adType = pQueuedItem->advType;
-        pduStatus.pPdu = pQueuedItem->pBrPdu;
-        advBrCb.advBrNotifCback(advIfId, MESH_ADV_PACKET_PROCESSED,
-                                (meshAdvBrEventParams_t *)&pduStatus);
-      }
+    pAdvIf = &(advBrCb.advInterfaces[advIfIndex]);
 
-      /* Remove peeked item from the queue */
-      meshAdvQueueRemoveHead(&(advBrCb.advInterfaces[advIfIndex].advTxQueue));
+    /* The packet being sent was sent. Signal it */
+    if (pAdvIf->advTxQueue.txPending)
+    {
+      meshAdvItemProcessed(pAdvIf, &(pAdvIf->advTxQueue.txItem));
+      pAdvIf->advTxQueue.txPending = FALSE;
     }
 
-    /* Peek next item. If found, send it over-the-air */
-    if (meshAdvQueuePeekHead(&(advBrCb.advInterfaces[advIfIndex].advTxQueue), &pQueuedItem))
+    /* Select next item. If found, send it over-the-air */
+    if (meshAdvQueueNext(pAdvIf))
     {
       /* Interface is available for sending packets over-the-air */
-      if (!meshAdvTransmitPacket(&(advBrCb.advInterfaces[advIfIndex]), pQueuedItem->advType,
-                                  pQueuedItem->pBrPdu, pQueuedItem->pduLen))
+      if (!meshAdvTransmitPacket(pAdvIf, pAdvIf->advTxQueue.txItem.advType,
+                                 pAdvIf->advTxQueue.txItem.pBrPdu,
+                                 pAdvIf->advTxQueue.txItem.pduLen))
       {
         /* Transmit failed. Empty Advertising interface queue */
-        meshAdvEmptyQueue(&(advBrCb.advInterfaces[advIfIndex]));
+        meshAdvEmptyQueue(pAdvIf);
       }
     }
     else
     {
       /* No more queued items. Mark interface as not busy */
-      advBrCb.advInterfaces[advIfIndex].advIfBusy = FALSE;
+      pAdvIf->advIfBusy = FALSE;
     }
   }
 
@@ -731,14 +897,17 @@ void MeshAdvSignalInterfaceReady(meshAdvIfId_t advIfId)
  *  \param[in] advType  ADV type received. See ::meshAdvType
  *  \param[in] pBrPdu   Pointer to a buffer containing a Mesh Bearer PDU.
  *  \param[in] pduLen   Size of the Mesh ADV Bearer PDU.
+ *  \param[in] txClass  Transmit class of the PDU. See ::meshAdvTxClassValues
  *
  *  \return    TRUE if message is sent or queued for later transmission, FALSE otherwise.
  */
 /*************************************************************************************************/
 bool_t MeshAdvSendBrPdu(meshAdvIfId_t advIfId, meshAdvType_t advType, const uint8_t *pBrPdu,
-                        uint8_t pduLen)
+                        uint8_t pduLen, meshAdvTxClass_t txClass)
 {
   uint8_t advIfIndex;
+  meshAdvInterface_t *pAdvIf;
+  meshAdvQueuedItem_t *pTxItem;
 
   /* Interface Id should have a valid value */
   WSF_ASSERT(MESH_ADV_IS_VALID_INTERFACE_ID(advIfId));
@@ -749,8 +918,9 @@ bool_t MeshAdvSendBrPdu(meshAdvIfId_t advIfId, meshAdvType_t advType, const uint
     return FALSE;
   }
 
-  /* Check for valid AD type */
-  if ((advType < MESH_AD_TYPE_PB) || (advType > MESH_AD_TYPE_BEACON))
+  /* Check for valid AD type and transmit class */
+  if ((advType < MESH_AD_TYPE_PB) || (advType > MESH_AD_TYPE_BEACON) ||
+      (txClass >= MESH_ADV_TX_CLASS_MAX))
   {
     return FALSE;
   }
@@ -765,22 +935,69 @@ bool_t MeshAdvSendBrPdu(meshAdvIfId_t advIfId, meshAdvType_t advType, const uint
     return FALSE;
   }
 
+  pAdvIf = &(advBrCb.advInterfaces[advIfIndex]);
+  pTxItem = &(pAdvIf->advTxQueue.txItem);
+
   /* Queue incoming message */
-  if (meshAdvQueueAdd(&(advBrCb.advInterfaces[advIfIndex].advTxQueue), advType, pBrPdu, pduLen))
+  if (!meshAdvQueueAdd(pAdvIf, advType, pBrPdu, pduLen, txClass))
+  {
+    /* Packet cannot be sent or queued */
+    return FALSE;
+  }
+
+  /* Send the selected item while the interface is available. It may not be this packet. */
+  while (!(pAdvIf->advIfBusy) && meshAdvQueueNext(pAdvIf))
   {
-    /* Check availability of interface*/
-    if (!(advBrCb.advInterfaces[advIfIndex].advIfBusy))
+    if (meshAdvTransmitPacket(pAdvIf, pTxItem->advType, pTxItem->pBrPdu, pTxItem->pduLen))
     {
-      /* Interface is available for sending the packet over-the-air */
-      return meshAdvTransmitPacket(&(advBrCb.advInterfaces[advIfIndex]), advType, pBrPdu, pduLen);
+      return TRUE;
     }
-    else
+
+    pAdvIf->advTxQueue.txPending = FALSE;
+
+    if ((pTxItem->pBrPdu == pBrPdu) && (pTxItem->advType == advType))
     {
-      /* Packet remains queued */
-      return TRUE;
+      /* The caller keeps its reference to the packet that failed. Signal the merged ones. */
+      pTxItem->refCount--;
+      meshAdvItemProcessed(pAdvIf, pTxItem);
+      return FALSE;
     }
+
+    /* Signal the queued packet that failed and select the next one */
+    meshAdvItemProcessed(pAdvIf, pTxItem);
   }
 
-  /* Packet cannot be sent or queued */
-  return FALSE;
+  /* Packet remains queued */
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the TX queue statistics of a transmit class on an ADV bearer instance.
+ *
+ *  \param[in]  advIfId  Unique identifier for the interface.
+ *  \param[in]  txClass  Transmit class. See ::meshAdvTxClassValues
+ *  \param[out] pStats   Pointer to the statistics.
+ *
+ *  \return     TRUE if the interface and class are valid, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t MeshAdvGetQueueStats(meshAdvIfId_t advIfId, meshAdvTxClass_t txClass,
+                            meshAdvQueueStats_t *pStats)
+{
+  uint8_t advIfIndex;
+
+  WSF_ASSERT(pStats != NULL);
+
+  /* Get interface ID */
+  advIfIndex = meshAdvGetAdvInterfaceById(advIfId);
+
+  if ((advIfIndex == MESH_ADV_INVALID_INDEX) || (txClass >= MESH_ADV_TX_CLASS_MAX))
+  {
+    return FALSE;
+  }
+
+  *pStats = advBrCb.advInterfaces[advIfIndex].advTxQueue.stats[txClass];
+
+  return TRUE;
 }
@@ -634,6 +634,7 @@ void MeshBrRegisterProxy(meshBrEventNotifyCback_t eventCback, meshBrNwkPduRecvCb
  *  \param[in] brIfId   Unique Mesh Bearer interface ID.
  *  \param[in] pNwkPdu  Pointer to a buffer containing a Mesh Network PDU.
  *  \param[in] pduLen   Size of the Mesh Network PDU.
+ *  \param[in] relay    TRUE if the PDU is relayed or proxied, FALSE if this node originated it.
  *
  *  \return    True if message is sent to the interface, False otherwise.
  *
@@ -641,7 +642,8 @@ void MeshBrRegisterProxy(meshBrEventNotifyCback_t eventCback, meshBrNwkPduRecvCb
  *             See ::meshBrEvent_t and ::meshBrPduStatus_t
  */
 /*************************************************************************************************/
-bool_t MeshBrSendNwkPdu(meshBrInterfaceId_t brIfId, const uint8_t *pNwkPdu, uint8_t pduLen)
+bool_t MeshBrSendNwkPdu(meshBrInterfaceId_t brIfId, const uint8_t *pNwkPdu, uint8_t pduLen,
+                        bool_t relay)
 {
   bool_t ret;
 
@@ -660,7 +662,8 @@ bool_t MeshBrSendNwkPdu(meshBrInterfaceId_t brIfId, const uint8_t *pNwkPdu, uint
     case MESH_ADV_BEARER:
       MESH_TRACE_INFO0("MESH BEARER: Sending PDU to advertising interface");
       ret = MeshAdvSendBrPdu(MESH_BR_IF_TO_ADV_IF(brIfId), MESH_AD_TYPE_PACKET,
-                                   pNwkPdu, pduLen);
+                                   pNwkPdu, pduLen,
+                                   relay ? MESH_ADV_TX_CLASS_RELAY : MESH_ADV_TX_CLASS_OWN);
       break;
 
     case MESH_GATT_BEARER:
@@ -708,7 +711,8 @@ bool_t MeshBrSendBeaconPdu(meshBrInterfaceId_t brIfId, uint8_t *pBeaconData, uin
   {
     case MESH_ADV_BEARER:
       MESH_TRACE_INFO0("MESH BEARER: Sending beacon to advertising interface");
-      ret = MeshAdvSendBrPdu(MESH_BR_IF_TO_ADV_IF(brIfId), MESH_AD_TYPE_BEACON, pBeaconData, dataLen);
+      ret = MeshAdvSendBrPdu(MESH_BR_IF_TO_ADV_IF(brIfId), MESH_AD_TYPE_BEACON, pBeaconData, dataLen,
+                             MESH_ADV_TX_CLASS_BEACON);
       break;
 
     case MESH_GATT_BEARER:
@@ -756,7 +760,8 @@ bool_t MeshBrSendPrvPdu(meshBrInterfaceId_t brIfId, const uint8_t *pPrvPdu, uint
   {
     case MESH_ADV_BEARER:
       MESH_TRACE_INFO0("MESH BEARER: Sending Prv PDU to advertising interface");
-      ret = MeshAdvSendBrPdu(MESH_BR_IF_TO_ADV_IF(brIfId), MESH_AD_TYPE_PB, pPrvPdu, pduLen);
+      ret = MeshAdvSendBrPdu(MESH_BR_IF_TO_ADV_IF(brIfId), MESH_AD_TYPE_PB, pPrvPdu, pduLen,
+                             MESH_ADV_TX_CLASS_OWN);
       break;
 
     case MESH_GATT_BEARER:
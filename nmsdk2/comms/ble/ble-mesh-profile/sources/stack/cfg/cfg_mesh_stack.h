@@ -58,11 +58,69 @@ extern "C" {
 #define MESH_ADV_QUEUE_SIZE               10
 #endif
 
+/*! Weight of the PDUs originated by this node in the advertising TX queue. Shall not be zero */
+#ifndef MESH_ADV_TX_WEIGHT_OWN
+#define MESH_ADV_TX_WEIGHT_OWN            4
+#endif
+
+/*! Weight of the relayed PDUs in the advertising TX queue. Shall not be zero */
+#ifndef MESH_ADV_TX_WEIGHT_RELAY
+#define MESH_ADV_TX_WEIGHT_RELAY          2
+#endif
+
+/*! Weight of the beacons in the advertising TX queue. Shall not be zero */
+#ifndef MESH_ADV_TX_WEIGHT_BEACON
+#define MESH_ADV_TX_WEIGHT_BEACON         1
+#endif
+
+/*! Number of advertising transmissions a relayed PDU may wait in the queue before it is dropped.
+ *  0 disables the deadline.
+ */
+#ifndef MESH_ADV_RELAY_MAX_WAIT
+#define MESH_ADV_RELAY_MAX_WAIT           16
+#endif
+
 /*! Queue size for each GATT interface */
 #ifndef MESH_GATT_QUEUE_SIZE
 #define MESH_GATT_QUEUE_SIZE              5
 #endif
 
+/**************************************************************************************************
+  Lower Transport
+**************************************************************************************************/
+
+/*! Number of segment slots shared by all SAR Rx transactions. One slot holds the payload of one
+ *  segment, so the default admits two messages of the maximum length of 32 segments. Shall not
+ *  exceed 254.
+ */
+#ifndef MESH_SAR_RX_SEG_POOL_SIZE
+#define MESH_SAR_RX_SEG_POOL_SIZE         64
+#endif
+
+/**************************************************************************************************
+  Friend
+**************************************************************************************************/
+
+/*! Number of Friend Queue entries shared by all friendships. Each LPN is guaranteed an equal share
+ *  and may borrow free entries up to the Friend Queue size advertised in the Friend Offer. 0 sizes
+ *  the pool for every friendship to fill its queue at once.
+ */
+#ifndef MESH_FRIEND_QUEUE_POOL_SIZE
+#define MESH_FRIEND_QUEUE_POOL_SIZE       0
+#endif
+
+/**************************************************************************************************
+  Security
+**************************************************************************************************/
+
+/*! Number of Secure Network Beacon authentication values remembered. A received or generated
+ *  beacon with the same NetKey, flags, Network ID and IV index as a remembered one is checked or
+ *  completed without computing the CMAC again.
+ */
+#ifndef MESH_SEC_BEACON_AUTH_CACHE_SIZE
+#define MESH_SEC_BEACON_AUTH_CACHE_SIZE   4
+#endif
+
 /**************************************************************************************************
   Global Functions
 **************************************************************************************************/
@@ -26,6 +26,7 @@
 #include "wsf_types.h"
 #include "wsf_assert.h"
 #include "wsf_msg.h"
+#include "wsf_math.h"
 
 #include "mesh_defs.h"
 #include "mesh_types.h"
@@ -50,6 +51,7 @@
 #include "mesh_friendship_defs.h"
 
 #include "mesh_utils.h"
+#include "cfg_mesh_stack.h"
 
 #include "util/bstream.h"
 #include <string.h>
@@ -79,13 +81,8 @@ void meshFriendResetLpnCtx(uint8_t idx)
   /* Reset establishment information. */
   memset(&(LPN_CTX_PTR(idx)->estabInfo), 0, sizeof(meshFriendEstabInfo_t));
 
-  /* Restore free count. */
-  LPN_CTX_PTR(idx)->pduQueueFreeCount = GET_MAX_NUM_QUEUE_ENTRIES();
-
-  /* Reset the queue. */
-  memset(LPN_CTX_PTR(idx)->pQueuePool, 0,
-         LPN_CTX_PTR(idx)->pduQueueFreeCount * sizeof(meshFriendQueueEntry_t));
-  WSF_QUEUE_INIT(&(LPN_CTX_PTR(idx)->pduQueue));
+  /* Return the queue entries to the pool. */
+  meshFriendQueueFlush(LPN_CTX_PTR(idx));
 
   /* Reset subscription list. */
   memset(LPN_CTX_PTR(idx)->pSubscrAddrList, 0,
@@ -912,6 +909,25 @@ static void meshFriendRegisterCbacks(void)
   Global Functions
 **************************************************************************************************/
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Computes the number of entries in the Friend Queue pool shared by all LPNs.
+ *
+ *  \return Number of entries.
+ */
+/*************************************************************************************************/
+static uint16_t meshFriendGetQueuePoolSize(void)
+{
+  uint16_t maxEntries = GET_MAX_NUM_CTX() * GET_MAX_NUM_QUEUE_ENTRIES();
+
+  if (MESH_FRIEND_QUEUE_POOL_SIZE == 0)
+  {
+    return maxEntries;
+  }
+
+  return WSF_MIN(MESH_FRIEND_QUEUE_POOL_SIZE, maxEntries);
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Computes the required memory to be provided based on the given configuration.
@@ -927,7 +943,7 @@ uint32_t MeshFriendGetRequiredMemory(void)
 
   /* Check number of friendships. */
   if((GET_MAX_NUM_CTX() == 0) || (GET_MAX_NUM_QUEUE_ENTRIES() == 0) ||
-     (GET_MAX_SUBSCR_LIST_SIZE() == 0))
+     (GET_MAX_SUBSCR_LIST_SIZE() == 0) || (meshFriendGetQueuePoolSize() < GET_MAX_NUM_CTX()))
   {
     return MESH_MEM_REQ_INVALID_CFG;
   }
@@ -935,8 +951,7 @@ uint32_t MeshFriendGetRequiredMemory(void)
   /* Compute required memory for each component */
   memCtx = GET_MAX_NUM_CTX() * sizeof(meshFriendLpnCtx_t);
 
-  memFriendQueue = GET_MAX_NUM_CTX() * GET_MAX_NUM_QUEUE_ENTRIES() *
-                   sizeof(meshFriendQueueEntry_t);
+  memFriendQueue = meshFriendGetQueuePoolSize() * sizeof(meshFriendQueueEntry_t);
   memSubscrList = GET_MAX_NUM_CTX() * GET_MAX_SUBSCR_LIST_SIZE() * sizeof(meshAddress_t);
 
   /* Return total while aligning each component. */
@@ -962,6 +977,7 @@ uint32_t MeshFriendMemInit(uint8_t *pFreeMem, uint32_t freeMemSize)
   meshAddress_t          *pSubscrList;
   meshFriendQueueEntry_t *pQueueEntry;
   uint32_t               memCtx, memFriendQueue;
+  uint16_t               entryIdx;
   uint8_t                idx;
   uint32_t               reqMem = MeshFriendGetRequiredMemory();
 
@@ -974,7 +990,7 @@ uint32_t MeshFriendMemInit(uint8_t *pFreeMem, uint32_t freeMemSize)
   /* Compute offset for the Friend Queue pool. */
   memCtx = GET_MAX_NUM_CTX() * sizeof(meshFriendLpnCtx_t);
   /* Compute offset for the Subscription List. */
-  memFriendQueue = GET_MAX_NUM_CTX() * GET_MAX_NUM_QUEUE_ENTRIES() * sizeof(meshFriendQueueEntry_t);
+  memFriendQueue = meshFriendGetQueuePoolSize() * sizeof(meshFriendQueueEntry_t);
 
   /* Reserve memory for the contexts. */
   friendCb.pLpnCtxTbl = (meshFriendLpnCtx_t *)pFreeMem;
@@ -984,17 +1000,35 @@ uint32_t MeshFriendMemInit(uint8_t *pFreeMem, uint32_t freeMemSize)
   /* Reserve memory for the Subscription Lists */
   pSubscrList = (meshAddress_t *)(((uint8_t *)pQueueEntry) + MESH_UTILS_ALIGN(memFriendQueue));
 
+  /* Put all Friend Queue entries in the shared pool. Each LPN is guaranteed an equal share. */
+  friendCb.pQueuePool = pQueueEntry;
+  friendCb.queuePoolSize = meshFriendGetQueuePoolSize();
+  friendCb.queueFreeCount = friendCb.queuePoolSize;
+  friendCb.queueQuota = (uint8_t)WSF_MIN(friendCb.queuePoolSize / GET_MAX_NUM_CTX(),
+                                         GET_MAX_NUM_QUEUE_ENTRIES());
+  WSF_QUEUE_INIT(&(friendCb.queueFree));
+
+  for(entryIdx = 0; entryIdx < friendCb.queuePoolSize; entryIdx++)
+  {
+    pQueueEntry[entryIdx].flags = FRIEND_QUEUE_FLAG_EMPTY;
+    WsfQueueEnq(&(friendCb.queueFree), &(pQueueEntry[entryIdx]));
+  }
+
   /* Configure individual pools and subscription lists. Reset each context. */
   for(idx = 0; idx < GET_MAX_NUM_CTX(); idx++)
   {
     /* Point to start address. */
-    LPN_CTX_PTR(idx)->pQueuePool      = pQueueEntry;
     LPN_CTX_PTR(idx)->pSubscrAddrList = pSubscrList;
 
     /* Advance pointers. */
-    pQueueEntry += GET_MAX_NUM_QUEUE_ENTRIES();
     pSubscrList += GET_MAX_SUBSCR_LIST_SIZE();
 
+    /* Start with an empty Friend Queue. */
+    WSF_QUEUE_INIT(&(LPN_CTX_PTR(idx)->pduQueue));
+    LPN_CTX_PTR(idx)->pAckPendEntry = NULL;
+    LPN_CTX_PTR(idx)->pduQueueCount = 0;
+    LPN_CTX_PTR(idx)->pduQueueUpdtCount = 0;
+
     /* Assign handler id to the timers. */
     LPN_CTX_PTR(idx)->pollTmr.handlerId = meshCb.handlerId;
     LPN_CTX_PTR(idx)->recvDelayTmr.handlerId = meshCb.handlerId;
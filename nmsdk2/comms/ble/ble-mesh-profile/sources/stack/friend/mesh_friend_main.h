@@ -215,11 +215,12 @@ typedef struct meshFriendLpnCtx_tag
   wsfQueue_t              pduQueue;                /*!< WSF Queue used for organizing the Friend
                                                     *   Queue
                                                     */
-  meshFriendQueueEntry_t  *pQueuePool;             /*!< Pool of Friend Queue entries */
+  meshFriendQueueEntry_t  *pAckPendEntry;          /*!< Entry sent and pending ACK */
   meshAddress_t           *pSubscrAddrList;        /*!< Pointer to Subscription List */
   meshAddress_t           lpnAddr;                 /*!< LPN address */
   uint16_t                netKeyIndex;             /*!< NetKey index for identifying sub-net */
-  uint8_t                 pduQueueFreeCount;       /*!< Count of unallocated queue entries */
+  uint8_t                 pduQueueCount;           /*!< Count of entries taken from the pool */
+  uint8_t                 pduQueueUpdtCount;       /*!< Count of Friend Update entries */
   uint8_t                 crtNextFsn;              /*!< Encoding of current and next FSN */
   uint8_t                 transNum;                /*!< Transaction number for Friend Subscription
                                                     */
@@ -247,6 +248,11 @@ typedef struct meshFriendCb_tag
 {
   meshFriendSmIf_t const   *pSm;           /*!< State machine interface */
   meshFriendLpnCtx_t       *pLpnCtxTbl;    /*!< LPN Context table. */
+  meshFriendQueueEntry_t   *pQueuePool;    /*!< Friend Queue entries shared by all LPNs */
+  wsfQueue_t               queueFree;      /*!< Free Friend Queue entries */
+  uint16_t                 queuePoolSize;  /*!< Number of entries in the pool */
+  uint16_t                 queueFreeCount; /*!< Number of free entries in the pool */
+  uint8_t                  queueQuota;     /*!< Entries guaranteed to each LPN */
   meshFriendStates_t       state;          /*!< Friendship module state. */
   uint16_t                 friendCounter;  /*!< Friend counter */
   uint8_t                  recvWindow;     /*!< Receive window */
@@ -284,6 +290,7 @@ void meshFriendQueueAddPdu(meshFriendLpnCtx_t *pCtx, uint8_t ctl, uint8_t ttl, u
 void meshFriendQueueSendNextPdu(meshFriendLpnCtx_t *pCtx);
 void meshFriendQueueRmAckPendPdu(meshFriendLpnCtx_t *pCtx);
 uint8_t meshFriendQueueGetMaxFreeEntries(meshFriendLpnCtx_t *pCtx);
+void meshFriendQueueFlush(meshFriendLpnCtx_t *pCtx);
 
 /* Friend Data Path callbacks. */
 bool_t meshFriendLpnDstCheckCback(meshAddress_t dst, uint16_t netKeyIndex);
@@ -27,6 +27,7 @@
 #include "wsf_trace.h"
 #include "wsf_assert.h"
 #include "wsf_msg.h"
+#include "wsf_math.h"
 
 #include "mesh_defs.h"
 #include "mesh_types.h"
@@ -75,6 +76,85 @@
   Local Functions
 **************************************************************************************************/
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Returns an entry held by an LPN to the shared pool.
+ *
+ *  \param[in] pCtx    Pointer to LPN context.
+ *  \param[in] pEntry  Pointer to an entry that is not in the Friend Queue of the LPN.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshFriendQueueRelease(meshFriendLpnCtx_t *pCtx, meshFriendQueueEntry_t *pEntry)
+{
+  WSF_ASSERT(pCtx->pduQueueCount > 0);
+
+  if (pEntry->flags & FRIEND_QUEUE_FLAG_UPDT_PDU)
+  {
+    pCtx->pduQueueUpdtCount--;
+  }
+
+  if (pEntry == pCtx->pAckPendEntry)
+  {
+    pCtx->pAckPendEntry = NULL;
+  }
+
+  pEntry->flags = FRIEND_QUEUE_FLAG_EMPTY;
+  pCtx->pduQueueCount--;
+
+  WsfQueueEnq(&(friendCb.queueFree), pEntry);
+  friendCb.queueFreeCount++;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Removes an entry from the Friend Queue of an LPN and returns it to the shared pool.
+ *
+ *  \param[in] pCtx    Pointer to LPN context.
+ *  \param[in] pEntry  Pointer to entry.
+ *  \param[in] pPrev   Pointer to the previous entry in the Friend Queue or NULL for the head.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshFriendQueueFree(meshFriendLpnCtx_t *pCtx, meshFriendQueueEntry_t *pEntry,
+                                meshFriendQueueEntry_t *pPrev)
+{
+  WsfQueueRemove(&(pCtx->pduQueue), pEntry, pPrev);
+  meshFriendQueueRelease(pCtx, pEntry);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Counts the entries an LPN can reclaim from LPNs holding more than their quota.
+ *
+ *  \param[in] pCtx  Pointer to LPN context.
+ *
+ *  \return    Number of entries that can be reclaimed.
+ */
+/*************************************************************************************************/
+static uint16_t meshFriendQueueCountReclaimable(meshFriendLpnCtx_t *pCtx)
+{
+  meshFriendLpnCtx_t *pOther;
+  uint16_t count = 0;
+  uint8_t idx;
+
+  for (idx = 0; idx < GET_MAX_NUM_CTX(); idx++)
+  {
+    pOther = LPN_CTX_PTR(idx);
+
+    /* Only borrowed entries that are not Friend Updates can be reclaimed. */
+    if ((pOther != pCtx) && (pOther->pduQueueCount > friendCb.queueQuota))
+    {
+      count += WSF_MIN(pOther->pduQueueCount - friendCb.queueQuota,
+                       pOther->pduQueueCount - pOther->pduQueueUpdtCount);
+    }
+  }
+
+  return count;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Prepares the Friend Queue to accept a new ACK Control PDU .
@@ -122,14 +202,8 @@ static void meshFriendQueuePrepNewAckAdd(meshFriendLpnCtx_t *pCtx, uint32_t ivIn
         if((pEntry->ivIndex < ivIndex) ||
            ((pEntry->ivIndex == ivIndex) && (pEntry->seqNo < seqNo)))
         {
-          /* Invalidate entry by setting address to 0 */
-          pEntry->flags = 0;
-
-          /* Remove from queue */
-          WsfQueueRemove(&(pCtx->pduQueue), pEntry, pPrev);
-
-          /* Increment free count. */
-          pCtx->pduQueueFreeCount++;
+          /* Remove from queue and return to the pool. */
+          meshFriendQueueFree(pCtx, pEntry, pPrev);
 
           return;
         }
@@ -173,14 +247,8 @@ static bool_t meshFriendQueueDiscardOldest(meshFriendLpnCtx_t *pCtx)
     pNext = (meshFriendQueueEntry_t *)(pEntry->pNext);
     if (!(pEntry->flags & FRIEND_QUEUE_FLAG_UPDT_PDU))
     {
-      /* Invalidate entry by setting address to 0 */
-      pEntry->flags = 0;
-
-      /* Remove from queue */
-      WsfQueueRemove(&(pCtx->pduQueue), pEntry, pPrev);
-
-      /* Increment free count. */
-      pCtx->pduQueueFreeCount++;
+      /* Remove from queue and return to the pool. */
+      meshFriendQueueFree(pCtx, pEntry, pPrev);
 
       return TRUE;
     }
@@ -199,26 +267,54 @@ static bool_t meshFriendQueueDiscardOldest(meshFriendLpnCtx_t *pCtx)
  *
  *  \param[in] pCtx  Pointer to LPN context.
  *
- *  \return    None.
+ *  \return    Pointer to entry or NULL if the LPN has to discard one of its own entries first.
+ *
+ *  \note      An LPN takes free entries from the shared pool up to the Friend Queue size. When the
+ *             pool is exhausted an LPN below its quota reclaims the oldest entry of the LPN that
+ *             has borrowed the most.
  */
 /*************************************************************************************************/
 static meshFriendQueueEntry_t *meshFriendQueueAlloc(meshFriendLpnCtx_t *pCtx)
 {
-  uint8_t idx = 0;
-  if(pCtx->pduQueueFreeCount > 0)
+  meshFriendLpnCtx_t *pOther, *pLender = NULL;
+  meshFriendQueueEntry_t *pEntry;
+  uint8_t idx;
+
+  if (pCtx->pduQueueCount >= GET_MAX_NUM_QUEUE_ENTRIES())
+  {
+    return NULL;
+  }
+
+  if ((friendCb.queueFreeCount == 0) && (pCtx->pduQueueCount < friendCb.queueQuota))
   {
-    for(idx = 0; idx < GET_MAX_NUM_QUEUE_ENTRIES(); idx++)
+    /* Find the LPN that has borrowed the most entries. */
+    for (idx = 0; idx < GET_MAX_NUM_CTX(); idx++)
     {
-      if(pCtx->pQueuePool[idx].flags == FRIEND_QUEUE_FLAG_EMPTY)
+      pOther = LPN_CTX_PTR(idx);
+
+      if ((pOther->pduQueueCount > friendCb.queueQuota) &&
+          ((pLender == NULL) || (pOther->pduQueueCount > pLender->pduQueueCount)))
       {
-        pCtx->pduQueueFreeCount--;
-        memset(pCtx->pQueuePool[idx].ltrPdu, 0, sizeof(pCtx->pQueuePool[idx].ltrPdu));
-        return &(pCtx->pQueuePool[idx]);
+        pLender = pOther;
       }
     }
+
+    if (pLender != NULL)
+    {
+      (void)meshFriendQueueDiscardOldest(pLender);
+    }
+  }
+
+  if ((pEntry = WsfQueueDeq(&(friendCb.queueFree))) == NULL)
+  {
+    return NULL;
   }
 
-  return NULL;
+  friendCb.queueFreeCount--;
+  pCtx->pduQueueCount++;
+
+  memset(pEntry->ltrPdu, 0, sizeof(pEntry->ltrPdu));
+  return pEntry;
 }
 
 /*************************************************************************************************/
@@ -251,8 +347,8 @@ void meshFriendQueueAddUpdate(meshFriendLpnCtx_t *pCtx)
   /* Allocate sequence number. */
   if (MeshSeqGetNumber(elem0Addr, &(pEntry->seqNo), TRUE) != MESH_SUCCESS)
   {
-    /* Increment free count since entry is not used. */
-    pCtx->pduQueueFreeCount++;
+    /* Return entry to the pool since it is not used. */
+    meshFriendQueueRelease(pCtx, pEntry);
     return;
   }
 
@@ -262,6 +358,7 @@ void meshFriendQueueAddUpdate(meshFriendLpnCtx_t *pCtx)
   pEntry->ctl = 1;
   pEntry->ttl = 0;
   pEntry->flags = FRIEND_QUEUE_FLAG_UPDT_PDU;
+  pCtx->pduQueueUpdtCount++;
 
   ptr = pEntry->ltrPdu;
 
@@ -413,7 +510,7 @@ void meshFriendQueueSendNextPdu(meshFriendLpnCtx_t *pCtx)
   meshNwkRetVal_t retVal = MESH_SUCCESS;
 
   /* If queue is empty, add an update message. */
-  if(pCtx->pduQueueFreeCount == GET_MAX_NUM_QUEUE_ENTRIES())
+  if(pCtx->pduQueueCount == 0)
   {
     meshFriendQueueAddUpdate(pCtx);
   }
@@ -465,6 +562,7 @@ void meshFriendQueueSendNextPdu(meshFriendLpnCtx_t *pCtx)
 
   /* Mark entry as pending ACK. */
   pEntry->flags |= FRIEND_QUEUE_FLAG_ACK_PEND;
+  pCtx->pAckPendEntry = pEntry;
 
   (void)retVal;
 }
@@ -480,24 +578,18 @@ void meshFriendQueueSendNextPdu(meshFriendLpnCtx_t *pCtx)
 /*************************************************************************************************/
 void meshFriendQueueRmAckPendPdu(meshFriendLpnCtx_t *pCtx)
 {
-  meshFriendQueueEntry_t *pEntry;
+  meshFriendQueueEntry_t *pEntry = pCtx->pAckPendEntry;
 
-  /* Point to start of the queue. */
-  pEntry = (meshFriendQueueEntry_t *)(&(pCtx->pduQueue))->pHead;
-
-  /* Check if the queue is not empty and the ACK pending flag is set as it might have been removed
-   * by another call to discard oldest to make room for newer messages.
+  /* Check if the entry is still queued as it might have been removed by another call to discard
+   * oldest to make room for newer messages.
    */
-  if((pEntry != NULL) && (pEntry->flags & FRIEND_QUEUE_FLAG_ACK_PEND))
+  if(pEntry != NULL)
   {
-    /* Remove from queue. */
-    WsfQueueRemove(&(pCtx->pduQueue), pEntry, NULL);
-
-    /* Reset flags. */
-    pEntry->flags = FRIEND_QUEUE_FLAG_EMPTY;
+    /* Only the head of the queue is ever sent. */
+    WSF_ASSERT(pEntry == (meshFriendQueueEntry_t *)(&(pCtx->pduQueue))->pHead);
 
-    /* Increment free count. */
-    pCtx->pduQueueFreeCount++;
+    /* Remove from queue and return to the pool. */
+    meshFriendQueueFree(pCtx, pEntry, NULL);
   }
 }
 
@@ -512,22 +604,37 @@ void meshFriendQueueRmAckPendPdu(meshFriendLpnCtx_t *pCtx)
 /*************************************************************************************************/
 uint8_t meshFriendQueueGetMaxFreeEntries(meshFriendLpnCtx_t *pCtx)
 {
-  uint8_t updtCnt = 0;
-  meshFriendQueueEntry_t *pEntry;
-
-  /* Point to start of the queue. */
-  pEntry = (meshFriendQueueEntry_t *)(&(pCtx->pduQueue))->pHead;
+  uint16_t avail = friendCb.queueFreeCount;
 
-  while(pEntry != NULL)
+  /* Entries borrowed by other LPNs can be reclaimed up to the quota. */
+  if ((avail < GET_MAX_NUM_QUEUE_ENTRIES()) && (pCtx->pduQueueCount < friendCb.queueQuota))
   {
-    /* Count Friend Update messages. */
-    if(pEntry->flags & FRIEND_QUEUE_FLAG_UPDT_PDU)
-    {
-      updtCnt++;
-    }
-    pEntry = (meshFriendQueueEntry_t *)(pEntry->pNext);
+    avail += WSF_MIN(friendCb.queueQuota - pCtx->pduQueueCount,
+                     meshFriendQueueCountReclaimable(pCtx));
   }
 
   /* Only Friend Updates cannot be removed from the queue. */
-  return GET_MAX_NUM_QUEUE_ENTRIES() - updtCnt;
+  return (uint8_t)(WSF_MIN(avail, GET_MAX_NUM_QUEUE_ENTRIES() - pCtx->pduQueueCount) +
+                   pCtx->pduQueueCount - pCtx->pduQueueUpdtCount);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Returns all entries of the Friend Queue to the shared pool.
+ *
+ *  \param[in] pCtx  Pointer to LPN context.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+void meshFriendQueueFlush(meshFriendLpnCtx_t *pCtx)
+{
+  meshFriendQueueEntry_t *pEntry;
+
+  while ((pEntry = WsfQueueDeq(&(pCtx->pduQueue))) != NULL)
+  {
+    meshFriendQueueRelease(pCtx, pEntry);
+  }
+
+  WSF_ASSERT((pCtx->pduQueueCount == 0) && (pCtx->pAckPendEntry == NULL));
 }
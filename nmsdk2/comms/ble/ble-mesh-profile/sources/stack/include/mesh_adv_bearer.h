@@ -54,9 +54,21 @@ enum meshAdvEventTypes
                                       */
 };
 
+/*! Mesh Advertising Bearer transmit classes. Each class is served in proportion to its weight */
+enum meshAdvTxClassValues
+{
+  MESH_ADV_TX_CLASS_OWN    = 0x00,  /*!< PDUs originated by this node */
+  MESH_ADV_TX_CLASS_RELAY  = 0x01,  /*!< Relayed or proxied Network PDUs */
+  MESH_ADV_TX_CLASS_BEACON = 0x02,  /*!< Beacons */
+  MESH_ADV_TX_CLASS_MAX    = 0x03   /*!< Number of transmit classes */
+};
+
 /*! Mesh ADV type */
 typedef uint8_t meshAdvType_t;
 
+/*! Mesh Advertising Bearer transmit class. See ::meshAdvTxClassValues */
+typedef uint8_t meshAdvTxClass_t;
+
 /*! Mesh Advertising Bearer notification event type. See ::meshAdvEventTypes */
 typedef uint8_t meshAdvEvent_t;
 
@@ -67,6 +79,20 @@ typedef struct meshAdvBrPduStatus_tag
   uint8_t        *pPdu;  /*!< Pointer to the sent PDU mentioned in the event */
 } meshAdvBrPduStatus_t;
 
+/*! Mesh Advertising Bearer TX queue statistics of a transmit class. Queue waits are counted in
+ *  advertising transmissions started on the interface.
+ */
+typedef struct meshAdvQueueStats_tag
+{
+  uint32_t  queued;   /*!< PDUs queued */
+  uint32_t  sent;     /*!< PDUs sent over-the-air */
+  uint32_t  merged;   /*!< PDUs merged with the same PDU still waiting in the queue */
+  uint32_t  dropped;  /*!< PDUs dropped because the queue was full */
+  uint32_t  stale;    /*!< Relayed PDUs dropped because they waited past the deadline */
+  uint32_t  waitSum;  /*!< Sum of the queue waits of the sent PDUs */
+  uint16_t  waitMax;  /*!< Longest queue wait of a sent PDU */
+} meshAdvQueueStats_t;
+
 /*! Mesh Advertising Bearer Event notification union */
 typedef union meshAdvBrEventParams_tag
 {
@@ -197,12 +223,27 @@ void MeshAdvSignalInterfaceReady(meshAdvIfId_t advIfId);
  *  \param[in] advType  ADV type received. See ::meshAdvType
  *  \param[in] pBrPdu   Pointer to a buffer containing a Mesh Bearer PDU.
  *  \param[in] pduLen   Size of the Mesh ADV Bearer PDU.
+ *  \param[in] txClass  Transmit class of the PDU. See ::meshAdvTxClassValues
  *
  *  \return    TRUE if message is sent or queued for later transmission, FALSE otherwise.
  */
 /*************************************************************************************************/
 bool_t MeshAdvSendBrPdu(meshAdvIfId_t advIfId, meshAdvType_t advType,
-                                 const uint8_t *pBrPdu, uint8_t pduLen);
+                                 const uint8_t *pBrPdu, uint8_t pduLen, meshAdvTxClass_t txClass);
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the TX queue statistics of a transmit class on an ADV bearer instance.
+ *
+ *  \param[in]  advIfId  Unique identifier for the interface.
+ *  \param[in]  txClass  Transmit class. See ::meshAdvTxClassValues
+ *  \param[out] pStats   Pointer to the statistics.
+ *
+ *  \return     TRUE if the interface and class are valid, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t MeshAdvGetQueueStats(meshAdvIfId_t advIfId, meshAdvTxClass_t txClass,
+                            meshAdvQueueStats_t *pStats);
 
 #ifdef __cplusplus
 }
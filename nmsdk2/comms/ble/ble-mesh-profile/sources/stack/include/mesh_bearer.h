@@ -275,6 +275,7 @@ void MeshBrRegisterPbBeacon(meshBrEventNotifyCback_t eventCback,
  *  \param[in] brIfId   Unique Mesh Bearer interface ID.
  *  \param[in] pNwkPdu  Pointer to a buffer containing a Mesh Network PDU.
  *  \param[in] pduLen   Size of the Mesh Network PDU.
+ *  \param[in] relay    TRUE if the PDU is relayed or proxied, FALSE if this node originated it.
  *
  *  \return    True if message is sent to the interface, False otherwise.
  *
@@ -282,7 +283,8 @@ void MeshBrRegisterPbBeacon(meshBrEventNotifyCback_t eventCback,
  *             See ::meshBrEvent_t and ::meshBrPduStatus_t
  */
 /*************************************************************************************************/
-bool_t MeshBrSendNwkPdu(meshBrInterfaceId_t brIfId, const uint8_t *pNwkPdu, uint8_t pduLen);
+bool_t MeshBrSendNwkPdu(meshBrInterfaceId_t brIfId, const uint8_t *pNwkPdu, uint8_t pduLen,
+                        bool_t relay);
 
 /*************************************************************************************************/
 /*!
@@ -98,6 +98,29 @@ void MeshLocalCfgInit(void);
 /*************************************************************************************************/
 void MeshLocalCfgRegisterLpn(meshLocalCfgFriendSubscrEventNotifyCback_t friendSubscrEventCback);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Commits all pending Local Config changes to NVM.
+ *
+ *  \return None.
+ *
+ *  \remarks Changes are normally committed when the commit window expires. Call this before a
+ *           planned reset or power down to store them at once.
+ */
+/*************************************************************************************************/
+void MeshLocalCfgNvmFlush(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the Local Config NVM write statistics.
+ *
+ *  \param[out] pOutStats  Pointer to store the statistics.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void MeshLocalCfgGetNvmStats(meshLocalCfgNvmStats_t *pOutStats);
+
 /*************************************************************************************************/
 /*!
  *  \brief     Sets the address for the primary node.
@@ -624,6 +647,18 @@ meshLocalCfgRetVal_t MeshLocalCfgGetSubscrListSize(meshElementId_t elementId,
 /*************************************************************************************************/
 bool_t MeshLocalCfgFindSubscrAddr(meshAddress_t subscrAddr);
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if a destination address is accepted by this node.
+ *
+ *  \param[in] dstAddr  Destination address of a received PDU.
+ *
+ *  \return    TRUE if the address is a local element address, a fixed group address or is in any
+ *             subscription list, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t MeshLocalCfgIsDstAddrAccepted(meshAddress_t dstAddr);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Checks if Subscription Address List is not empty.
@@ -265,6 +265,15 @@ typedef struct meshLocalCfgFriendSubscrEventParams_tag
   uint16_t       idx;            /*!< Index in address list */
 } meshLocalCfgFriendSubscrEventParams_t;
 
+/*! Mesh Local Config NVM write statistics */
+typedef struct meshLocalCfgNvmStats_tag
+{
+  uint32_t       changes;        /*!< Dataset changes requested by the Local Config setters */
+  uint32_t       commits;        /*!< Commits of the dirty datasets */
+  uint32_t       nvmWrites;      /*!< Dataset writes issued to NVM */
+  uint32_t       nvmBytes;       /*!< Dataset bytes written to NVM */
+} meshLocalCfgNvmStats_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -314,6 +314,15 @@ typedef void (*meshSecNwkDeobfDecCback_t)(bool_t isSuccess, bool_t isProxyConfig
                                           uint16_t netKeyIndex, uint32_t ivIndex,
                                           meshAddress_t friendOrLpnAddr, void *pParam);
 
+/*! Secure Network Beacon authentication cache statistics. */
+typedef struct meshSecBeaconCacheStats_tag
+{
+  uint32_t  rxHits;       /*!< Received beacons authenticated from the cache */
+  uint32_t  txHits;       /*!< Generated beacons authenticated from the cache */
+  uint32_t  cmacAvoided;  /*!< CMAC computations avoided by cache hits */
+  uint32_t  cmacCount;    /*!< CMAC computations performed for beacons */
+} meshSecBeaconCacheStats_t;
+
 /*************************************************************************************************/
 /*!
  *  \brief     Mesh Security Secure Network Beacon authentication calculated  callback.
@@ -676,6 +685,47 @@ meshSecRetVal_t MeshSecBeaconAuthenticate(uint8_t *pSecNwkBeacon,
                                           meshSecBeaconAuthCback_t secNwkBeaconAuthCback,
                                           void *pParam);
 
+/*************************************************************************************************/
+/*!
+ *  \brief      Authenticates a received Secure Network Beacon from the authentication cache.
+ *
+ *  \param[in]  pSecNwkBeacon  Pointer to received Secure Network Beacon.
+ *  \param[out] pNetKeyIndex   Global network key index of the key that authenticates the beacon.
+ *  \param[out] pNewKeyUsed    TRUE if the new key authenticates the beacon.
+ *
+ *  \return     TRUE if the beacon matches a cached beacon, FALSE if it must be authenticated with
+ *              MeshSecBeaconAuthenticate().
+ */
+/*************************************************************************************************/
+bool_t MeshSecBeaconAuthCacheMatch(const uint8_t *pSecNwkBeacon, uint16_t *pNetKeyIndex,
+                                   bool_t *pNewKeyUsed);
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Completes a Secure Network Beacon from the authentication cache.
+ *
+ *  \param[in] pSecNwkBeacon  Pointer to 22 byte buffer storing the Secure Network Beacon.
+ *  \param[in] netKeyIndex    Global Network Key identifier.
+ *  \param[in] useNewKey      TRUE if new key should be used for computation.
+ *
+ *  \return    TRUE if the Network ID and authentication value are copied in the beacon, FALSE if
+ *             they must be computed with MeshSecBeaconComputeAuth().
+ */
+/*************************************************************************************************/
+bool_t MeshSecBeaconComputeAuthCached(uint8_t *pSecNwkBeacon, uint16_t netKeyIndex,
+                                      bool_t useNewKey);
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the Secure Network Beacon authentication cache statistics.
+ *
+ *  \param[out] pStats  Pointer to statistics.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void MeshSecBeaconGetCacheStats(meshSecBeaconCacheStats_t *pStats);
+
 /*************************************************************************************************/
 /*!
  *  \brief     Gets the Network ID.
@@ -30,6 +30,7 @@
 #include "wsf_os.h"
 #include "wsf_assert.h"
 #include "wsf_nvm.h"
+#include "wsf_timer.h"
 
 #include "mesh_defs.h"
 #include "mesh_types.h"
@@ -63,6 +64,20 @@
 /*! Invalid Mesh AppKey or NetKey value */
 #define MESH_KEY_INVALID_INDEX                           0xFFFF
 
+/*! Delay in milliseconds during which changes to Local Config datasets are coalesced before they
+ *  are committed to NVM. A value of 0 commits every change immediately.
+ */
+#ifndef MESH_LOCAL_CFG_NVM_COMMIT_DELAY_MS
+#define MESH_LOCAL_CFG_NVM_COMMIT_DELAY_MS               500
+#endif
+
+/*! Number of Local Config NVM datasets */
+#define MESH_LOCAL_CFG_NVM_NUM_DATASETS                  (MESH_LOCAL_CFG_NVM_HB_DATASET_ID - \
+                                                          MESH_LOCAL_CFG_NVM_DATASET_ID + 1)
+
+/*! Multiplier used to hash addresses into the subscription filter */
+#define MESH_LOCAL_CFG_FILTER_HASH_MULT                  0x9E37
+
 /**************************************************************************************************
   Local Variables
 **************************************************************************************************/
@@ -71,6 +86,27 @@
 enum meshLocalCfgWsfMsgEvents
 {
   MESH_LOCAL_CFG_MSG_ATT_TMR_EXPIRED = MESH_LOCAL_CFG_MSG_START, /*!< Attention timer expired */
+  MESH_LOCAL_CFG_MSG_NVM_TMR_EXPIRED,                             /*!< NVM commit timer expired */
+};
+
+/*! Order in which dirty datasets are committed. Lists referenced by index from other datasets
+ *  are written first so that a reset in the middle of a commit never leaves an entry pointing to
+ *  a key or address that is not yet stored. References to removed entries are dropped at init by
+ *  meshLocalCfgNvmRepair().
+ */
+static const uint16_t localCfgNvmCommitOrder[MESH_LOCAL_CFG_NVM_NUM_DATASETS] =
+{
+  MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_HB_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_SEQ_NUMBER_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_SEQ_NUMBER_THRESH_DATASET_ID,
+  MESH_LOCAL_CFG_NVM_DATASET_ID,
 };
 
 /*! Mesh Local Config Local structure */
@@ -148,6 +184,32 @@ static meshLocalCfgModelInfo_t localCfgModel;
 /*! Local Config Subscription List Local structure */
 static meshLocalCfgModelSubscrListInfo_t localCfgSubscrList;
 
+/*! Subscription filter entry */
+typedef struct meshLocalCfgFilterEntry_tag
+{
+  meshAddress_t address;  /*!< Subscribed group or virtual address */
+  uint16_t      count;    /*!< Number of address list entries subscribed with this address */
+} meshLocalCfgFilterEntry_t;
+
+/*! Subscription filter.
+ *
+ *  Open addressed hash set of every group and virtual address with a non-zero subscription
+ *  reference count. Mirrors the address lists so that received PDUs are checked without a scan.
+ */
+static struct meshLocalCfgFilter_tag
+{
+  meshLocalCfgFilterEntry_t *pTable;  /*!< Hash table */
+  uint16_t                  mask;     /*!< Table size minus one, table size is a power of two */
+} localCfgFilter;
+
+/*! Mesh Local Config NVM write-behind control block */
+static struct meshLocalCfgNvm_tag
+{
+  wsfTimer_t                commitTmr;  /*!< Commit timer */
+  uint16_t                  dirtyMask;  /*!< Datasets changed since the last commit */
+  meshLocalCfgNvmStats_t    stats;      /*!< NVM write statistics */
+} localCfgNvm;
+
 /*! Mesh Local Config control block */
 static struct meshLocalCfgCb_tag
 {
@@ -299,6 +361,198 @@ static inline uint16_t meshLocalCfgGetRequiredMemoryNodeIdentityList(uint16_t ne
   return  MESH_UTILS_ALIGN(sizeof(meshLocalCfgNodeIdentityListEntry_t) * netKeyListSize);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Computes the number of entries of the subscription filter.
+ *
+ *  \param[in] numAddr  Total number of entries in the Non-virtual and Virtual Address Lists.
+ *
+ *  \return    Number of entries, a power of two at least twice the number of addresses.
+ */
+/*************************************************************************************************/
+static uint16_t meshLocalCfgGetFilterSize(uint16_t numAddr)
+{
+  uint16_t size = 4;
+
+  while (size < (uint16_t)(numAddr * 2))
+  {
+    size <<= 1;
+  }
+
+  return size;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Computes memory requirements for the subscription filter.
+ *
+ *  \param[in] numAddr  Total number of entries in the Non-virtual and Virtual Address Lists.
+ *
+ *  \return    Required memory in bytes for the subscription filter.
+ */
+/*************************************************************************************************/
+static inline uint16_t meshLocalCfgGetRequiredMemoryFilter(uint16_t numAddr)
+{
+  return  MESH_UTILS_ALIGN(sizeof(meshLocalCfgFilterEntry_t) * meshLocalCfgGetFilterSize(numAddr));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Computes the home slot of an address in the subscription filter.
+ *
+ *  \param[in] address  Group or virtual address.
+ *
+ *  \return    Slot index.
+ */
+/*************************************************************************************************/
+static inline uint16_t meshLocalCfgFilterHash(meshAddress_t address)
+{
+  return (uint16_t)(((uint32_t)address * MESH_LOCAL_CFG_FILTER_HASH_MULT) >> 8) & localCfgFilter.mask;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Adds one subscription reference of an address to the subscription filter.
+ *
+ *  \param[in] address  Group or virtual address.
+ *
+ *  \return    None.
+ *
+ *  \remarks   Two Label UUIDs can hash to the same virtual address, so the filter counts
+ *             references per address rather than per address list entry.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgFilterAdd(meshAddress_t address)
+{
+  uint16_t slot = meshLocalCfgFilterHash(address);
+
+  /* The table is sized for every address list entry so a free slot always exists. */
+  while (localCfgFilter.pTable[slot].address != MESH_ADDR_TYPE_UNASSIGNED)
+  {
+    if (localCfgFilter.pTable[slot].address == address)
+    {
+      localCfgFilter.pTable[slot].count++;
+      return;
+    }
+    slot = (slot + 1) & localCfgFilter.mask;
+  }
+
+  localCfgFilter.pTable[slot].address = address;
+  localCfgFilter.pTable[slot].count = 1;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Removes one subscription reference of an address from the subscription filter.
+ *
+ *  \param[in] address  Group or virtual address.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgFilterRemove(meshAddress_t address)
+{
+  uint16_t slot = meshLocalCfgFilterHash(address);
+  uint16_t next, home;
+
+  while (localCfgFilter.pTable[slot].address != address)
+  {
+    if (localCfgFilter.pTable[slot].address == MESH_ADDR_TYPE_UNASSIGNED)
+    {
+      return;
+    }
+    slot = (slot + 1) & localCfgFilter.mask;
+  }
+
+  if (--localCfgFilter.pTable[slot].count != 0)
+  {
+    return;
+  }
+
+  /* Shift back the entries of the probe sequence so that lookups never need tombstones. */
+  next = slot;
+  for (;;)
+  {
+    localCfgFilter.pTable[slot].address = MESH_ADDR_TYPE_UNASSIGNED;
+
+    do
+    {
+      next = (next + 1) & localCfgFilter.mask;
+
+      if (localCfgFilter.pTable[next].address == MESH_ADDR_TYPE_UNASSIGNED)
+      {
+        return;
+      }
+
+      home = meshLocalCfgFilterHash(localCfgFilter.pTable[next].address);
+    } while (((next - home) & localCfgFilter.mask) < ((next - slot) & localCfgFilter.mask));
+
+    localCfgFilter.pTable[slot] = localCfgFilter.pTable[next];
+    slot = next;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if an address is in the subscription filter.
+ *
+ *  \param[in] address  Address to be searched.
+ *
+ *  \return    TRUE if at least one model is subscribed to the address, FALSE otherwise.
+ */
+/*************************************************************************************************/
+static bool_t meshLocalCfgFilterFind(meshAddress_t address)
+{
+  uint16_t slot = meshLocalCfgFilterHash(address);
+
+  while (localCfgFilter.pTable[slot].address != MESH_ADDR_TYPE_UNASSIGNED)
+  {
+    if (localCfgFilter.pTable[slot].address == address)
+    {
+      return TRUE;
+    }
+    slot = (slot + 1) & localCfgFilter.mask;
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Rebuilds the subscription filter from the address lists.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgFilterRebuild(void)
+{
+  uint16_t i, j;
+
+  memset(localCfgFilter.pTable, 0, sizeof(meshLocalCfgFilterEntry_t) * (localCfgFilter.mask + 1));
+
+  for (i = 0; i < localCfgAddressList.addressListSize; i++)
+  {
+    if (localCfgAddressList.pAddressList[i].address != MESH_ADDR_TYPE_UNASSIGNED)
+    {
+      for (j = 0; j < localCfgAddressList.pAddressList[i].referenceCountSubscr; j++)
+      {
+        meshLocalCfgFilterAdd(localCfgAddressList.pAddressList[i].address);
+      }
+    }
+  }
+
+  for (i = 0; i < localCfgVirtualAddrList.virtualAddrListSize; i++)
+  {
+    if (localCfgVirtualAddrList.pVirtualAddrList[i].address != MESH_ADDR_TYPE_UNASSIGNED)
+    {
+      for (j = 0; j < localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountSubscr; j++)
+      {
+        meshLocalCfgFilterAdd(localCfgVirtualAddrList.pVirtualAddrList[i].address);
+      }
+    }
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Computes total number of models instances based on initial configuration.
@@ -420,6 +674,426 @@ static uint16_t meshLocalCfgSearchModel(meshElementId_t elementId, const meshMod
   return MESH_INVALID_ENTRY_INDEX;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the RAM image of a Local Config NVM dataset.
+ *
+ *  \param[in]  datasetId  NVM dataset identifier.
+ *  \param[out] ppData     Pointer to store the address of the dataset.
+ *
+ *  \return     Length of the dataset in bytes.
+ */
+/*************************************************************************************************/
+static uint16_t meshLocalCfgNvmGetDataset(uint16_t datasetId, uint8_t **ppData)
+{
+  switch (datasetId)
+  {
+    case MESH_LOCAL_CFG_NVM_DATASET_ID:
+      *ppData = (uint8_t *)&localCfg;
+      return sizeof(localCfg);
+    case MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID:
+      *ppData = (uint8_t *)localCfgNetKeyList.pNetKeyList;
+      return sizeof(meshLocalCfgNetKeyListEntry_t) * localCfgNetKeyList.netKeyListSize;
+    case MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID:
+      *ppData = (uint8_t *)localCfgAppKeyList.pAppKeyList;
+      return sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize;
+    case MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID:
+      *ppData = (uint8_t *)localCfgAppKeyBindList.pAppKeyBindList;
+      return sizeof(uint16_t) * localCfgAppKeyBindList.appKeyBindListSize;
+    case MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID:
+      *ppData = (uint8_t *)localCfgAddressList.pAddressList;
+      return sizeof(meshLocalCfgAddressListEntry_t) * localCfgAddressList.addressListSize;
+    case MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID:
+      *ppData = (uint8_t *)localCfgVirtualAddrList.pVirtualAddrList;
+      return sizeof(meshLocalCfgVirtualAddrListEntry_t) * localCfgVirtualAddrList.virtualAddrListSize;
+    case MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID:
+      *ppData = (uint8_t *)localCfgSubscrList.pSubscrList;
+      return sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize;
+    case MESH_LOCAL_CFG_NVM_SEQ_NUMBER_DATASET_ID:
+      *ppData = (uint8_t *)localCfgElement.pSeqNumberArray;
+      return sizeof(meshSeqNumber_t) * localCfgElement.elementArrayLen;
+    case MESH_LOCAL_CFG_NVM_SEQ_NUMBER_THRESH_DATASET_ID:
+      *ppData = (uint8_t *)localCfgElement.pSeqNumberThreshArray;
+      return sizeof(meshSeqNumber_t) * localCfgElement.elementArrayLen;
+    case MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID:
+      *ppData = (uint8_t *)localCfgModel.pModelArray;
+      return sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize;
+    case MESH_LOCAL_CFG_NVM_HB_DATASET_ID:
+      *ppData = (uint8_t *)&localCfgHb;
+      return sizeof(localCfgHb);
+    default:
+      WSF_ASSERT(FALSE);
+      *ppData = NULL;
+      return 0;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if a NetKey or AppKey list entry holds a key.
+ *
+ *  \param[in] entryIdx  Entry index in the key list.
+ *  \param[in] isNetKey  TRUE for the NetKey list, FALSE for the AppKey list.
+ *
+ *  \return    TRUE if the entry holds a key, FALSE otherwise.
+ */
+/*************************************************************************************************/
+static bool_t meshLocalCfgNvmKeyEntryUsed(uint16_t entryIdx, bool_t isNetKey)
+{
+  if (isNetKey)
+  {
+    return (entryIdx < localCfgNetKeyList.netKeyListSize) &&
+           (localCfgNetKeyList.pNetKeyList[entryIdx].netKeyIndex != MESH_KEY_INVALID_INDEX);
+  }
+
+  return (entryIdx < localCfgAppKeyList.appKeyListSize) &&
+         (localCfgAppKeyList.pAppKeyList[entryIdx].appKeyIndex != MESH_KEY_INVALID_INDEX);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if an address list entry holds an address.
+ *
+ *  \param[in] addrIdx        Entry index in the address list.
+ *  \param[in] isVirtualAddr  TRUE for the Virtual Address list, FALSE for the Address list.
+ *
+ *  \return    TRUE if the entry holds an address, FALSE otherwise.
+ */
+/*************************************************************************************************/
+static bool_t meshLocalCfgNvmAddrEntryUsed(uint16_t addrIdx, bool_t isVirtualAddr)
+{
+  if (isVirtualAddr)
+  {
+    return (addrIdx < localCfgVirtualAddrList.virtualAddrListSize) &&
+           (localCfgVirtualAddrList.pVirtualAddrList[addrIdx].address != MESH_ADDR_TYPE_UNASSIGNED);
+  }
+
+  return (addrIdx < localCfgAddressList.addressListSize) &&
+         (localCfgAddressList.pAddressList[addrIdx].address != MESH_ADDR_TYPE_UNASSIGNED);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Counts one reference to an address list entry.
+ *
+ *  \param[in] addrIdx        Entry index in the address list.
+ *  \param[in] isVirtualAddr  TRUE for the Virtual Address list, FALSE for the Address list.
+ *  \param[in] isPublishAddr  TRUE if the address is used for publication.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmAddrEntryRef(uint16_t addrIdx, bool_t isVirtualAddr, bool_t isPublishAddr)
+{
+  if (isVirtualAddr)
+  {
+    if (isPublishAddr)
+    {
+      localCfgVirtualAddrList.pVirtualAddrList[addrIdx].referenceCountPublish++;
+    }
+    else
+    {
+      localCfgVirtualAddrList.pVirtualAddrList[addrIdx].referenceCountSubscr++;
+    }
+  }
+  else
+  {
+    if (isPublishAddr)
+    {
+      localCfgAddressList.pAddressList[addrIdx].referenceCountPublish++;
+    }
+    else
+    {
+      localCfgAddressList.pAddressList[addrIdx].referenceCountSubscr++;
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Disables a model publication.
+ *
+ *  \param[in] pPub  Model publication state.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmClearPublication(meshLocalCfgModelPublication_t *pPub)
+{
+  memset(pPub, 0, sizeof(meshLocalCfgModelPublication_t));
+  pPub->publishAddressIndex = MESH_INVALID_ENTRY_INDEX;
+  pPub->publishAppKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Restores the references between the Local Config datasets after a reset during a
+ *          commit.
+ *
+ *  \return None.
+ *
+ *  \remarks Datasets are committed in ::localCfgNvmCommitOrder, so additions are always safe:
+ *           a key or address is stored before anything that refers to it. A removal is not; a
+ *           reset can store an emptied key or address entry without the datasets that still
+ *           refer to it. The clean-up the Configuration Server does on removal is repeated here:
+ *           - AppKeys bound to a removed NetKey are removed, and Heartbeat publication on it is
+ *             disabled.
+ *           - AppKey binds to a removed AppKey are dropped, and publications that use it are
+ *             disabled.
+ *           - Subscriptions and publications to a removed address are dropped.
+ *           The address reference counts are then recounted from the remaining references, and
+ *           addresses nobody refers to are freed.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmRepair(void)
+{
+  meshLocalCfgModelSubscrListEntry_t *pSubscr;
+  meshLocalCfgModelPublication_t *pPub;
+  meshLocalCfgAppKeyListEntry_t *pAppKey;
+  uint16_t i;
+
+  /* AppKeys and Heartbeat publication on a removed NetKey. */
+  for (i = 0; i < localCfgAppKeyList.appKeyListSize; i++)
+  {
+    pAppKey = &localCfgAppKeyList.pAppKeyList[i];
+
+    if ((pAppKey->appKeyIndex != MESH_KEY_INVALID_INDEX) &&
+        (pAppKey->netKeyEntryIndex != MESH_INVALID_ENTRY_INDEX) &&
+        !meshLocalCfgNvmKeyEntryUsed(pAppKey->netKeyEntryIndex, TRUE))
+    {
+      pAppKey->appKeyIndex = MESH_KEY_INVALID_INDEX;
+      pAppKey->netKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
+      pAppKey->newKeyAvailable = FALSE;
+    }
+  }
+
+  if ((localCfgHb.pubNetKeyEntryIndex != MESH_INVALID_ENTRY_INDEX) &&
+      !meshLocalCfgNvmKeyEntryUsed(localCfgHb.pubNetKeyEntryIndex, TRUE))
+  {
+    localCfgHb.pubNetKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
+    localCfgHb.pubDstAddressIndex = MESH_INVALID_ENTRY_INDEX;
+    localCfgHb.pubCountLog = 0;
+    localCfgHb.pubPeriodLog = 0;
+    localCfgHb.pubTtl = 0;
+  }
+
+  /* AppKey binds and publications on a removed AppKey. */
+  for (i = 0; i < localCfgAppKeyBindList.appKeyBindListSize; i++)
+  {
+    if ((localCfgAppKeyBindList.pAppKeyBindList[i] != MESH_INVALID_ENTRY_INDEX) &&
+        !meshLocalCfgNvmKeyEntryUsed(localCfgAppKeyBindList.pAppKeyBindList[i], FALSE))
+    {
+      localCfgAppKeyBindList.pAppKeyBindList[i] = MESH_INVALID_ENTRY_INDEX;
+    }
+  }
+
+  for (i = 0; i < localCfgModel.modelArraySize; i++)
+  {
+    pPub = &localCfgModel.pModelArray[i].publicationState;
+
+    if ((pPub->publishAppKeyEntryIndex != MESH_INVALID_ENTRY_INDEX) &&
+        !meshLocalCfgNvmKeyEntryUsed(pPub->publishAppKeyEntryIndex, FALSE))
+    {
+      meshLocalCfgNvmClearPublication(pPub);
+    }
+  }
+
+  /* Subscriptions and publications to a removed address. */
+  for (i = 0; i < localCfgSubscrList.subscrListSize; i++)
+  {
+    pSubscr = &localCfgSubscrList.pSubscrList[i];
+
+    if ((pSubscr->subscrAddressIndex != MESH_INVALID_ENTRY_INDEX) &&
+        !meshLocalCfgNvmAddrEntryUsed(pSubscr->subscrAddressIndex, pSubscr->subscrToLabelUuid))
+    {
+      pSubscr->subscrAddressIndex = MESH_INVALID_ENTRY_INDEX;
+    }
+  }
+
+  for (i = 0; i < localCfgModel.modelArraySize; i++)
+  {
+    pPub = &localCfgModel.pModelArray[i].publicationState;
+
+    if ((pPub->publishAddressIndex != MESH_INVALID_ENTRY_INDEX) &&
+        !meshLocalCfgNvmAddrEntryUsed(pPub->publishAddressIndex, pPub->publishToLabelUuid))
+    {
+      pPub->publishAddressIndex = MESH_INVALID_ENTRY_INDEX;
+    }
+  }
+
+  if ((localCfgHb.pubDstAddressIndex != MESH_INVALID_ENTRY_INDEX) &&
+      !meshLocalCfgNvmAddrEntryUsed(localCfgHb.pubDstAddressIndex, FALSE))
+  {
+    localCfgHb.pubDstAddressIndex = MESH_INVALID_ENTRY_INDEX;
+  }
+
+  if ((localCfgHb.subSrcAddressIndex != MESH_INVALID_ENTRY_INDEX) &&
+      !meshLocalCfgNvmAddrEntryUsed(localCfgHb.subSrcAddressIndex, FALSE))
+  {
+    localCfgHb.subSrcAddressIndex = MESH_INVALID_ENTRY_INDEX;
+  }
+
+  if ((localCfgHb.subDstAddressIndex != MESH_INVALID_ENTRY_INDEX) &&
+      !meshLocalCfgNvmAddrEntryUsed(localCfgHb.subDstAddressIndex, FALSE))
+  {
+    localCfgHb.subDstAddressIndex = MESH_INVALID_ENTRY_INDEX;
+  }
+
+  /* Recount the address references; the counts may have been stored ahead of the references. */
+  for (i = 0; i < localCfgAddressList.addressListSize; i++)
+  {
+    localCfgAddressList.pAddressList[i].referenceCountPublish = 0;
+    localCfgAddressList.pAddressList[i].referenceCountSubscr = 0;
+  }
+
+  for (i = 0; i < localCfgVirtualAddrList.virtualAddrListSize; i++)
+  {
+    localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountPublish = 0;
+    localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountSubscr = 0;
+  }
+
+  for (i = 0; i < localCfgSubscrList.subscrListSize; i++)
+  {
+    pSubscr = &localCfgSubscrList.pSubscrList[i];
+
+    if (pSubscr->subscrAddressIndex != MESH_INVALID_ENTRY_INDEX)
+    {
+      meshLocalCfgNvmAddrEntryRef(pSubscr->subscrAddressIndex, pSubscr->subscrToLabelUuid, FALSE);
+    }
+  }
+
+  for (i = 0; i < localCfgModel.modelArraySize; i++)
+  {
+    pPub = &localCfgModel.pModelArray[i].publicationState;
+
+    if (pPub->publishAddressIndex != MESH_INVALID_ENTRY_INDEX)
+    {
+      meshLocalCfgNvmAddrEntryRef(pPub->publishAddressIndex, pPub->publishToLabelUuid, TRUE);
+    }
+  }
+
+  if (localCfgHb.pubDstAddressIndex != MESH_INVALID_ENTRY_INDEX)
+  {
+    meshLocalCfgNvmAddrEntryRef(localCfgHb.pubDstAddressIndex, FALSE, TRUE);
+  }
+
+  if (localCfgHb.subSrcAddressIndex != MESH_INVALID_ENTRY_INDEX)
+  {
+    meshLocalCfgNvmAddrEntryRef(localCfgHb.subSrcAddressIndex, FALSE, FALSE);
+  }
+
+  if (localCfgHb.subDstAddressIndex != MESH_INVALID_ENTRY_INDEX)
+  {
+    meshLocalCfgNvmAddrEntryRef(localCfgHb.subDstAddressIndex, FALSE, FALSE);
+  }
+
+  for (i = 0; i < localCfgAddressList.addressListSize; i++)
+  {
+    if ((localCfgAddressList.pAddressList[i].referenceCountPublish == 0) &&
+        (localCfgAddressList.pAddressList[i].referenceCountSubscr == 0))
+    {
+      localCfgAddressList.pAddressList[i].address = MESH_ADDR_TYPE_UNASSIGNED;
+    }
+  }
+
+  for (i = 0; i < localCfgVirtualAddrList.virtualAddrListSize; i++)
+  {
+    if ((localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountPublish == 0) &&
+        (localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountSubscr == 0))
+    {
+      localCfgVirtualAddrList.pVirtualAddrList[i].address = MESH_ADDR_TYPE_UNASSIGNED;
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Writes every dirty Local Config dataset to NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmCommitAll(void)
+{
+  uint8_t *pData;
+  uint16_t len;
+  uint16_t bit;
+  uint8_t i;
+
+  WsfTimerStop(&localCfgNvm.commitTmr);
+
+  if (localCfgNvm.dirtyMask == 0)
+  {
+    return;
+  }
+
+  for (i = 0; i < MESH_LOCAL_CFG_NVM_NUM_DATASETS; i++)
+  {
+    bit = 1 << (localCfgNvmCommitOrder[i] - MESH_LOCAL_CFG_NVM_DATASET_ID);
+
+    if (localCfgNvm.dirtyMask & bit)
+    {
+      len = meshLocalCfgNvmGetDataset(localCfgNvmCommitOrder[i], &pData);
+
+      WsfNvmWriteData(localCfgNvmCommitOrder[i], pData, len, NULL);
+
+      localCfgNvm.stats.nvmWrites++;
+      localCfgNvm.stats.nvmBytes += len;
+    }
+  }
+
+  localCfgNvm.dirtyMask = 0;
+  localCfgNvm.stats.commits++;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Marks a Local Config dataset as changed and schedules its commit to NVM.
+ *
+ *  \param[in] datasetId  NVM dataset identifier.
+ *
+ *  \return    None.
+ *
+ *  \remarks   Further changes made before the commit timer expires are written with the same
+ *             commit, so a burst of configuration messages rewrites each dataset once.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmCommit(uint16_t datasetId)
+{
+  localCfgNvm.dirtyMask |= 1 << (datasetId - MESH_LOCAL_CFG_NVM_DATASET_ID);
+  localCfgNvm.stats.changes++;
+
+#if (MESH_LOCAL_CFG_NVM_COMMIT_DELAY_MS == 0)
+  meshLocalCfgNvmCommitAll();
+#else
+  /* Start the window on the first change only so a steady stream cannot postpone the commit. */
+  if (!localCfgNvm.commitTmr.isStarted)
+  {
+    WsfTimerStartMs(&localCfgNvm.commitTmr, MESH_LOCAL_CFG_NVM_COMMIT_DELAY_MS);
+  }
+#endif
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Marks a Local Config dataset as changed and commits all pending changes to NVM.
+ *
+ *  \param[in] datasetId  NVM dataset identifier.
+ *
+ *  \return    None.
+ *
+ *  \remarks   Used for state that must never be lost on reset, such as the SEQ number threshold
+ *             and the IV index, which protect against replay of old messages.
+ */
+/*************************************************************************************************/
+static void meshLocalCfgNvmCommitNow(uint16_t datasetId)
+{
+  localCfgNvm.dirtyMask |= 1 << (datasetId - MESH_LOCAL_CFG_NVM_DATASET_ID);
+  localCfgNvm.stats.changes++;
+
+  meshLocalCfgNvmCommitAll();
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Gets the address entry index in the address list.
@@ -536,11 +1210,11 @@ static uint16_t meshLocalCfgSetAddress(meshAddress_t address, const uint8_t *pLa
             }
 
             localCfgVirtualAddrList.pVirtualAddrList[i].referenceCountSubscr++;
+            meshLocalCfgFilterAdd(address);
           }
 
           /* Update Virtual Address entry in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID, (uint8_t *)localCfgVirtualAddrList.pVirtualAddrList,
-                                     sizeof(meshLocalCfgVirtualAddrListEntry_t) * localCfgVirtualAddrList.virtualAddrListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID);
 
           return i;
         }
@@ -574,11 +1248,11 @@ static uint16_t meshLocalCfgSetAddress(meshAddress_t address, const uint8_t *pLa
             }
 
             localCfgAddressList.pAddressList[i].referenceCountSubscr++;
+            meshLocalCfgFilterAdd(address);
           }
 
           /* Update Address entry in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID, (uint8_t *)localCfgAddressList.pAddressList,
-                                     sizeof(meshLocalCfgAddressListEntry_t) * localCfgAddressList.addressListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID);
 
           return i;
         }
@@ -625,6 +1299,7 @@ static void meshLocalCfgRemoveAddress(uint16_t addrEntryIdx, bool_t isVirtualAdd
         if (localCfgVirtualAddrList.pVirtualAddrList[addrEntryIdx].referenceCountSubscr > 0)
         {
           localCfgVirtualAddrList.pVirtualAddrList[addrEntryIdx].referenceCountSubscr--;
+          meshLocalCfgFilterRemove(localCfgVirtualAddrList.pVirtualAddrList[addrEntryIdx].address);
 
           /* Invoke callback if address was removed from subscription list. */
           if (localCfgVirtualAddrList.pVirtualAddrList[addrEntryIdx].referenceCountSubscr == 0)
@@ -645,8 +1320,7 @@ static void meshLocalCfgRemoveAddress(uint16_t addrEntryIdx, bool_t isVirtualAdd
     }
 
     /* Update Virtual Address entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID, (uint8_t *)localCfgVirtualAddrList.pVirtualAddrList,
-                               sizeof(meshLocalCfgVirtualAddrListEntry_t) * localCfgVirtualAddrList.virtualAddrListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID);
   }
   else
   {
@@ -667,6 +1341,7 @@ static void meshLocalCfgRemoveAddress(uint16_t addrEntryIdx, bool_t isVirtualAdd
         if (localCfgAddressList.pAddressList[addrEntryIdx].referenceCountSubscr > 0)
         {
           localCfgAddressList.pAddressList[addrEntryIdx].referenceCountSubscr--;
+          meshLocalCfgFilterRemove(localCfgAddressList.pAddressList[addrEntryIdx].address);
 
           /* Invoke callback if address was removed from subscription list. */
           if ((localCfgAddressList.pAddressList[addrEntryIdx].referenceCountSubscr == 0) &&
@@ -688,8 +1363,7 @@ static void meshLocalCfgRemoveAddress(uint16_t addrEntryIdx, bool_t isVirtualAdd
     }
 
     /* Update Address entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID, (uint8_t *)localCfgAddressList.pAddressList,
-                               sizeof(meshLocalCfgAddressListEntry_t) * localCfgAddressList.addressListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID);
   }
 }
 
@@ -895,6 +1569,10 @@ static void meshLocalCfgWsfHandlerCback(wsfMsgHdr_t *pMsg)
       /* Call timer callback to handle expiration. */
       meshLocalCfgAttentionTimerCback((uint8_t)(pMsg->param));
       break;
+    case MESH_LOCAL_CFG_MSG_NVM_TMR_EXPIRED:
+      /* Commit the changes gathered during the window. */
+      meshLocalCfgNvmCommitAll();
+      break;
     default:
       break;
   }
@@ -949,7 +1627,9 @@ uint32_t MeshLocalCfgGetRequiredMemory(void)
       meshLocalCfgGetRequiredMemoryVirtualAddrList(pMeshConfig->pMemoryConfig->virtualAddrListMaxSize) +
       meshLocalCfgGetRequiredMemoryAppKeyList(pMeshConfig->pMemoryConfig->appKeyListSize) +
       meshLocalCfgGetRequiredMemoryNetKeyList(pMeshConfig->pMemoryConfig->netKeyListSize) +
-      meshLocalCfgGetRequiredMemoryNodeIdentityList(pMeshConfig->pMemoryConfig->netKeyListSize);
+      meshLocalCfgGetRequiredMemoryNodeIdentityList(pMeshConfig->pMemoryConfig->netKeyListSize) +
+      meshLocalCfgGetRequiredMemoryFilter(pMeshConfig->pMemoryConfig->addrListMaxSize +
+                                          pMeshConfig->pMemoryConfig->virtualAddrListMaxSize);
 
   return reqMem;
 }
@@ -1106,6 +1786,17 @@ void MeshLocalCfgInit(void)
   /* Initialize the Model array. */
   memset(localCfgModel.pModelArray, 0, sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize);
 
+  /* Subscription filter Initialization. */
+  /* Save the pointer for the subscription filter. */
+  localCfgFilter.pTable = (meshLocalCfgFilterEntry_t *)pMemBuff;
+  /* Save the subscription filter mask. */
+  localCfgFilter.mask = meshLocalCfgGetFilterSize(pMeshConfig->pMemoryConfig->addrListMaxSize +
+                                                  pMeshConfig->pMemoryConfig->virtualAddrListMaxSize) - 1;
+  /* Increment the memory buffer pointer. */
+  tempVal = meshLocalCfgGetRequiredMemoryFilter(pMeshConfig->pMemoryConfig->addrListMaxSize +
+                                                pMeshConfig->pMemoryConfig->virtualAddrListMaxSize);
+  pMemBuff += tempVal;
+
   /* Forward memory pointer. */
   meshCb.memBuffSize -= (pMemBuff - meshCb.pMemBuff);
   meshCb.pMemBuff = pMemBuff;
@@ -1218,6 +1909,17 @@ void MeshLocalCfgInit(void)
 
   retVal = WsfNvmReadData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
 
+  /* Drop references left behind by a reset during a commit. */
+  meshLocalCfgNvmRepair();
+
+  /* Build the subscription filter from the restored address lists. */
+  meshLocalCfgFilterRebuild();
+
+  /* Initialize the NVM write-behind control block. */
+  memset(&localCfgNvm, 0, sizeof(localCfgNvm));
+  localCfgNvm.commitTmr.msg.event = MESH_LOCAL_CFG_MSG_NVM_TMR_EXPIRED;
+  localCfgNvm.commitTmr.handlerId = meshCb.handlerId;
+
   /* Register friendship callback. */
   localCfgCb.friendSubscrEventCback = meshLocalCfgFriendSubscrEventNotifyCback;
 
@@ -1245,6 +1947,34 @@ void MeshLocalCfgRegisterLpn(meshLocalCfgFriendSubscrEventNotifyCback_t friendSu
   }
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Commits all pending Local Config changes to NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void MeshLocalCfgNvmFlush(void)
+{
+  meshLocalCfgNvmCommitAll();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the Local Config NVM write statistics.
+ *
+ *  \param[out] pOutStats  Pointer to store the statistics.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void MeshLocalCfgGetNvmStats(meshLocalCfgNvmStats_t *pOutStats)
+{
+  WSF_ASSERT(pOutStats != NULL);
+
+  *pOutStats = localCfgNvm.stats;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Sets the address for the primary node.
@@ -1260,7 +1990,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPrimaryNodeAddress(meshAddress_t address)
     {
         localCfg.address = address;
 
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 
         return MESH_SUCCESS;
     }
@@ -1557,8 +2287,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishAddress(meshElementId_t elementId,
         localCfgModel.pModelArray[modelIdx].publicationState.publishToLabelUuid = FALSE;
 
         /* Update Model entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                                   sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
       }
 
       return MESH_SUCCESS;
@@ -1586,8 +2315,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishAddress(meshElementId_t elementId,
         localCfgAddressList.pAddressList[newAddrIdx].referenceCountPublish++;
 
         /* Update Address entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID, (uint8_t *)localCfgAddressList.pAddressList,
-                                   sizeof(meshLocalCfgAddressListEntry_t) * localCfgAddressList.addressListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID);
       }
 
       /* Check again if Address List is full. */
@@ -1608,8 +2336,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishAddress(meshElementId_t elementId,
       localCfgModel.pModelArray[modelIdx].publicationState.publishToLabelUuid = FALSE;
 
       /* Update Model entry in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                                 sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -1723,8 +2450,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishVirtualAddr(meshElementId_t elementId
         localCfgModel.pModelArray[modelIdx].publicationState.publishToLabelUuid = FALSE;
 
         /* Update Model entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                                   sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
       }
 
       return MESH_SUCCESS;
@@ -1750,8 +2476,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishVirtualAddr(meshElementId_t elementId
         localCfgVirtualAddrList.pVirtualAddrList[newAddrIdx].referenceCountPublish++;
 
         /* Update Address entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID, (uint8_t *)localCfgVirtualAddrList.pVirtualAddrList,
-                                   sizeof(meshLocalCfgVirtualAddrListEntry_t) * localCfgVirtualAddrList.virtualAddrListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID);
       }
 
       /* Check again if Address List is full. */
@@ -1772,8 +2497,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishVirtualAddr(meshElementId_t elementId
       localCfgModel.pModelArray[modelIdx].publicationState.publishToLabelUuid = TRUE;
 
       /* Update Model entry in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                                 sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -1813,8 +2537,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishPeriod(meshElementId_t elementId,
     localCfgModel.pModelArray[modelIdx].publicationState.publishPeriodStepRes = stepResolution;
 
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -1895,8 +2618,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishAppKeyIndex(meshElementId_t elementId
         appKeyIdx;
 
       /* Update Model entry in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                                 sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -1928,8 +2650,7 @@ void MeshLocalCfgMdlClearPublishAppKeyIndex(meshElementId_t elementId, const mes
     localCfgModel.pModelArray[modelIdx].publicationState.publishAppKeyEntryIndex
       = MESH_INVALID_ENTRY_INDEX;
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
   }
 }
 
@@ -1997,8 +2718,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishFriendshipCredFlag(meshElementId_t el
     localCfgModel.pModelArray[modelIdx].publicationState.publishFriendshipCred = friendshipCredFlag;
 
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -2065,8 +2785,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishTtl(meshElementId_t elementId,
     localCfgModel.pModelArray[modelIdx].publicationState.publishTtl = publishTtl;
 
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -2131,8 +2850,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishRetransCount(meshElementId_t elementI
     localCfgModel.pModelArray[modelIdx].publicationState.publishRetransCount = retransCount;
 
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -2206,8 +2924,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetPublishRetransIntvlSteps(meshElementId_t ele
       retransSteps;
 
     /* Update Model entry in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID, (uint8_t *)localCfgModel.pModelArray,
-                               sizeof(meshLocalCfgModelEntry_t) * localCfgModel.modelArraySize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_MODEL_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -2311,8 +3028,7 @@ meshLocalCfgRetVal_t MeshLocalCfgAddAddressToSubscrList(meshElementId_t elementI
           localCfgSubscrList.pSubscrList[subscrIdx].subscrToLabelUuid = FALSE;
 
           /* Update Subscription List entry in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                       sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
           return MESH_SUCCESS;
         }
@@ -2345,17 +3061,16 @@ meshLocalCfgRetVal_t MeshLocalCfgAddAddressToSubscrList(meshElementId_t elementI
       {
         /* Increment subscription count. */
         localCfgAddressList.pAddressList[newAddrIdx].referenceCountSubscr++;
+        meshLocalCfgFilterAdd(localCfgAddressList.pAddressList[newAddrIdx].address);
 
         /* Update Address entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID, (uint8_t *)localCfgAddressList.pAddressList,
-                                   sizeof(meshLocalCfgAddressListEntry_t) * localCfgAddressList.addressListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_ADDRESS_DATASET_ID);
 
         localCfgSubscrList.pSubscrList[freeIdx].subscrAddressIndex = newAddrIdx;
         localCfgSubscrList.pSubscrList[freeIdx].subscrToLabelUuid = FALSE;
 
         /* Update Subscription List entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                     sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
         return MESH_SUCCESS;
       }
@@ -2492,8 +3207,7 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveAddressFromSubscrList(meshElementId_t ele
           localCfgSubscrList.pSubscrList[subscrIdx].subscrToLabelUuid = FALSE;
 
           /* Update Subscription List entry in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                       sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
           return MESH_SUCCESS;
         }
@@ -2564,8 +3278,7 @@ meshLocalCfgRetVal_t MeshLocalCfgAddVirtualAddrToSubscrList(meshElementId_t elem
           localCfgSubscrList.pSubscrList[subscrIdx].subscrToLabelUuid = TRUE;
 
           /* Update Subscription List entry in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                       sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
           return MESH_SUCCESS;
         }
@@ -2598,17 +3311,16 @@ meshLocalCfgRetVal_t MeshLocalCfgAddVirtualAddrToSubscrList(meshElementId_t elem
       {
         /* Increment subscription count. */
         localCfgVirtualAddrList.pVirtualAddrList[newAddrIdx].referenceCountSubscr++;
+        meshLocalCfgFilterAdd(localCfgVirtualAddrList.pVirtualAddrList[newAddrIdx].address);
 
         /* Update Address entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID, (uint8_t *)localCfgVirtualAddrList.pVirtualAddrList,
-                                   sizeof(meshLocalCfgVirtualAddrListEntry_t) * localCfgVirtualAddrList.virtualAddrListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_VIRTUAL_ADDR_DATASET_ID);
 
         localCfgSubscrList.pSubscrList[freeIdx].subscrAddressIndex = newAddrIdx;
         localCfgSubscrList.pSubscrList[freeIdx].subscrToLabelUuid = TRUE;
 
         /* Update Subscription List entry in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                     sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
         return MESH_SUCCESS;
       }
@@ -2677,8 +3389,7 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveVirtualAddrFromSubscrList(meshElementId_t
             localCfgSubscrList.pSubscrList[subscrIdx].subscrToLabelUuid = FALSE;
 
             /* Update Subscription List entry in NVM. */
-            WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                         sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+            meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
             return MESH_SUCCESS;
           }
@@ -2739,8 +3450,7 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveAllFromSubscrList(meshElementId_t element
     /* Update Subscription List in NVM. Sync as the Subscription list can be too large to send a
      * WSF message.
      */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID, (uint8_t *)localCfgSubscrList.pSubscrList,
-                                 sizeof(meshLocalCfgModelSubscrListEntry_t) * localCfgSubscrList.subscrListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_SUBSCR_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -2909,36 +3619,43 @@ meshLocalCfgRetVal_t MeshLocalCfgGetSubscrListSize(meshElementId_t elementId,
 /*************************************************************************************************/
 bool_t MeshLocalCfgFindSubscrAddr(meshAddress_t subscrAddr)
 {
-  uint16_t addrIdx;
+  if (MESH_IS_ADDR_UNASSIGNED(subscrAddr))
+  {
+    return FALSE;
+  }
 
-  /* Check if address is Virtual or Non-virtual. */
-  if (!MESH_IS_ADDR_VIRTUAL(subscrAddr))
+  return meshLocalCfgFilterFind(subscrAddr);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Checks if a destination address is accepted by this node.
+ *
+ *  \param[in] dstAddr  Destination address of a received PDU.
+ *
+ *  \return    TRUE if the address is a local element address, a fixed group address or is in any
+ *             subscription list, FALSE otherwise.
+ *
+ *  \remarks   Runs in constant time regardless of the number of subscriptions, so that the
+ *             network layer can decide between local delivery and relay only on every PDU.
+ */
+/*************************************************************************************************/
+bool_t MeshLocalCfgIsDstAddrAccepted(meshAddress_t dstAddr)
+{
+  if (MESH_IS_ADDR_UNICAST(dstAddr))
   {
-    /* Search through non-virtual address list. */
-    for (addrIdx = 0; addrIdx < localCfgAddressList.addressListSize; addrIdx++)
-    {
-      /* Check if subscription addresses match and if reference count is different than 0. */
-      if ((localCfgAddressList.pAddressList[addrIdx].address == subscrAddr) &&
-          (localCfgAddressList.pAddressList[addrIdx].referenceCountSubscr != 0))
-      {
-        return TRUE;
-      }
-    }
+    /* An unprovisioned node owns no unicast address. */
+    return ((localCfg.address != MESH_ADDR_TYPE_UNASSIGNED) &&
+            (dstAddr >= localCfg.address) &&
+            (dstAddr < (localCfg.address + localCfgElement.elementArrayLen)));
   }
-  else
+
+  if (MESH_IS_ADDR_FIXED_GROUP(dstAddr))
   {
-    /* Search through virtual address list. */
-    for (addrIdx = 0; addrIdx < localCfgVirtualAddrList.virtualAddrListSize; addrIdx++)
-    {
-      /* Check if subscription addresses match and if reference count is different than 0. */
-      if ((localCfgVirtualAddrList.pVirtualAddrList[addrIdx].address == subscrAddr) &&
-          (localCfgVirtualAddrList.pVirtualAddrList[addrIdx].referenceCountSubscr != 0))
-      {
-        return TRUE;
-      }
-    }
+    return TRUE;
   }
-  return FALSE;
+
+  return MeshLocalCfgFindSubscrAddr(dstAddr);
 }
 
 /*************************************************************************************************/
@@ -3076,7 +3793,7 @@ void MeshLocalCfgSetDevKey(const uint8_t *pDevKey)
   memcpy(localCfg.deviceKey, pDevKey, MESH_KEY_SIZE_128);
 
   /* Update Local Cfg structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -3133,8 +3850,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetNetKey(uint16_t netKeyIndex, const uint8_t *
     localCfgNetKeyList.pNodeIdentityList[netKeyIdx] = MESH_NODE_IDENTITY_STOPPED;
 
     /* Update NetKey list in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID, (uint8_t *)localCfgNetKeyList.pNetKeyList,
-                                 sizeof(meshLocalCfgNetKeyListEntry_t) * localCfgNetKeyList.netKeyListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -3170,8 +3886,7 @@ meshLocalCfgRetVal_t MeshLocalCfgUpdateNetKey(uint16_t netKeyIndex, const uint8_
       localCfgNetKeyList.pNetKeyList[netKeyIdx].newKeyAvailable = TRUE;
 
       /* Update NetKey list in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID, (uint8_t *)localCfgNetKeyList.pNetKeyList,
-                      sizeof(meshLocalCfgNetKeyListEntry_t) * localCfgNetKeyList.netKeyListSize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -3225,6 +3940,9 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveNetKey(uint16_t netKeyIndex, bool_t remov
         if (netKeyIdx == localCfgAppKeyList.pAppKeyList[appKeyIdx].netKeyEntryIndex)
         {
           localCfgAppKeyList.pAppKeyList[appKeyIdx].netKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
+
+          /* Update AppKey list in NVM. */
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
         }
       }
 
@@ -3234,8 +3952,7 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveNetKey(uint16_t netKeyIndex, bool_t remov
     }
 
     /* Update NetKey list in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID, (uint8_t *)localCfgNetKeyList.pNetKeyList,
-                                 sizeof(meshLocalCfgNetKeyListEntry_t) * localCfgNetKeyList.netKeyListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -3390,8 +4107,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetAppKey(uint16_t appKeyIndex, const uint8_t *
     localCfgAppKeyList.pAppKeyList[appKeyIdx].netKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
 
     /* Update AppKey list in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, (uint8_t *)localCfgAppKeyList.pAppKeyList,
-                                 sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -3426,8 +4142,7 @@ meshLocalCfgRetVal_t MeshLocalCfgUpdateAppKey(uint16_t appKeyIndex, const uint8_
       localCfgAppKeyList.pAppKeyList[appKeyIdx].newKeyAvailable = TRUE;
 
       /* Update AppKey list in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, (uint8_t *)localCfgAppKeyList.pAppKeyList,
-                                   sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -3479,8 +4194,7 @@ meshLocalCfgRetVal_t MeshLocalCfgRemoveAppKey(uint16_t appKeyIndex, bool_t remov
     }
 
     /* Update AppKey list in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, (uint8_t *)localCfgAppKeyList.pAppKeyList,
-                                 sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -3643,8 +4357,7 @@ meshLocalCfgRetVal_t MeshLocalCfgBindAppKeyToModel(meshElementId_t elementId,
         localCfgAppKeyBindList.pAppKeyBindList[freeIdx] = appKeyIdx;
 
         /* Update AppKey Bind list in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID, (uint8_t *)localCfgAppKeyBindList.pAppKeyBindList,
-                                     sizeof(uint16_t) * localCfgAppKeyBindList.appKeyBindListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID);
 
         return MESH_SUCCESS;
       }
@@ -3702,8 +4415,7 @@ void MeshLocalCfgUnbindAppKeyFromModel(meshElementId_t elementId, const meshMode
           localCfgAppKeyBindList.pAppKeyBindList[keyBindIdx] = MESH_INVALID_ENTRY_INDEX;
 
           /* Update AppKey Bind list in NVM. */
-          WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID, (uint8_t *)localCfgAppKeyBindList.pAppKeyBindList,
-                                       sizeof(uint16_t) * localCfgAppKeyBindList.appKeyBindListSize, NULL);
+          meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_BIND_DATASET_ID);
         }
       }
     }
@@ -3885,8 +4597,7 @@ meshLocalCfgRetVal_t MeshLocalCfgBindAppKeyToNetKey(uint16_t appKeyIndex, uint16
       localCfgAppKeyList.pAppKeyList[appKeyIdx].netKeyEntryIndex = netKeyIdx;
 
       /* Update AppKey list in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, (uint8_t *)localCfgAppKeyList.pAppKeyList,
-                                   sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize, NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -3922,8 +4633,7 @@ meshLocalCfgRetVal_t MeshLocalCfgUnbindAppKeyToNetKey(uint16_t appKeyIndex, uint
         localCfgAppKeyList.pAppKeyList[appKeyIdx].netKeyEntryIndex = MESH_INVALID_ENTRY_INDEX;
 
         /* Update AppKey list in NVM. */
-        WsfNvmWriteData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, (uint8_t *)localCfgAppKeyList.pAppKeyList,
-                                     sizeof(meshLocalCfgAppKeyListEntry_t) * localCfgAppKeyList.appKeyListSize, NULL);
+        meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID);
 
         return MESH_SUCCESS;
       }
@@ -4113,7 +4823,7 @@ void MeshLocalCfgSetDefaultTtl(uint8_t defaultTtl)
   localCfg.defaultTtl = defaultTtl;
 
   /* Update Local Cfg structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4144,7 +4854,7 @@ void MeshLocalCfgSetRelayState(meshRelayStates_t relayState)
     localCfg.relayState = relayState;
 
     /* Update Local Cfg structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
   }
 }
 
@@ -4223,7 +4933,7 @@ void MeshLocalCfgSetBeaconState(meshBeaconStates_t beaconState)
     localCfg.beaconState = beaconState;
 
     /* Update Local Cfg structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
   }
 }
 
@@ -4255,7 +4965,7 @@ void MeshLocalCfgSetGattProxyState(meshGattProxyStates_t gattProxyState)
     localCfg.gattProxyState = gattProxyState;
 
     /* Update Local Cfg structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
   }
 }
 
@@ -4337,7 +5047,7 @@ void MeshLocalCfgSetFriendState(meshFriendStates_t friendState)
     localCfg.friendState = friendState;
 
     /* Update Local Cfg structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
   }
 }
 
@@ -4406,8 +5116,7 @@ void MeshLocalCfgSetKeyRefreshState(uint16_t netKeyIndex, meshKeyRefreshStates_t
     localCfgNetKeyList.pNetKeyList[netKeyIdx].keyRefreshState = keyRefreshState;
 
     /* Update NetKey list in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID, (uint8_t *)localCfgNetKeyList.pNetKeyList,
-                                 sizeof(meshLocalCfgNetKeyListEntry_t) * localCfgNetKeyList.netKeyListSize, NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID);
   }
 }
 
@@ -4464,7 +5173,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbPubDst(meshAddress_t dstAddress)
       localCfgHb.pubDstAddressIndex = MESH_INVALID_ENTRY_INDEX;
 
       /* Update Heartbeat structure in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -4497,7 +5206,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbPubDst(meshAddress_t dstAddress)
     localCfgHb.pubDstAddressIndex = newAddrIdx;
 
     /* Update Heartbeat structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -4539,7 +5248,7 @@ void MeshLocalCfgSetHbPubCountLog(uint8_t countLog)
   localCfgHb.pubCountLog = countLog;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4569,7 +5278,7 @@ void MeshLocalCfgSetHbPubPeriodLog(uint8_t periodLog)
   localCfgHb.pubPeriodLog = periodLog;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4598,7 +5307,7 @@ void MeshLocalCfgSetHbPubTtl(uint8_t pubTtl)
   localCfgHb.pubTtl = pubTtl;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4629,7 +5338,7 @@ void MeshLocalCfgSetHbPubFeatures(meshFeatures_t pubFeatures)
     localCfgHb.pubFeatures = pubFeatures;
 
     /* Update Heartbeat structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
   }
 }
 
@@ -4666,7 +5375,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbPubNetKeyIndex(uint16_t netKeyIndex)
     localCfgHb.pubNetKeyEntryIndex = netKeyIdx;
 
     /* Update Heartbeat structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -4726,7 +5435,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbSubSrc(meshAddress_t srcAddress)
       localCfgHb.subSrcAddressIndex = MESH_INVALID_ENTRY_INDEX;
 
       /* Update Heartbeat structure in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -4761,7 +5470,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbSubSrc(meshAddress_t srcAddress)
     localCfgHb.subSrcAddressIndex = newAddrIdx;
 
     /* Update Heartbeat structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -4817,7 +5526,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbSubDst(meshAddress_t dstAddress)
       localCfgHb.subDstAddressIndex = MESH_INVALID_ENTRY_INDEX;
 
       /* Update Heartbeat structure in NVM. */
-      WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+      meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
       return MESH_SUCCESS;
     }
@@ -4850,7 +5559,7 @@ meshLocalCfgRetVal_t MeshLocalCfgSetHbSubDst(meshAddress_t dstAddress)
     localCfgHb.subDstAddressIndex = newAddrIdx;
 
     /* Update Heartbeat structure in NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+    meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 
     return MESH_SUCCESS;
   }
@@ -4891,7 +5600,7 @@ void MeshLocalCfgSetHbSubCountLog(uint8_t countLog)
   localCfgHb.subCountLog = countLog;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4921,7 +5630,7 @@ void MeshLocalCfgSetHbSubPeriodLog(uint8_t periodLog)
   localCfgHb.subPeriodLog = periodLog;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4951,7 +5660,7 @@ void MeshLocalCfgSetHbSubMinHops(uint8_t minHops)
   localCfgHb.subMinHops = minHops;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -4982,7 +5691,7 @@ void MeshLocalCfgSetHbSubMaxHops(uint8_t maxHops)
   localCfgHb.subMaxHops = maxHops;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_HB_DATASET_ID, (uint8_t *)&localCfgHb, sizeof(localCfgHb), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_HB_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5014,7 +5723,7 @@ void MeshLocalCfgSetNwkTransmitCount(uint8_t transCount)
   localCfg.nwkTransCount = transCount;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5045,7 +5754,7 @@ void MeshLocalCfgSetNwkTransmitIntvlSteps(uint8_t intvlSteps)
   localCfg.nwkIntvlSteps = intvlSteps;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5075,7 +5784,7 @@ void MeshLocalCfgSetRelayRetransmitCount(uint8_t retransCount)
   localCfg.relayRetransCount = retransCount;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5106,7 +5815,7 @@ void MeshLocalCfgSetRelayRetransmitIntvlSteps(uint8_t intvlSteps)
   localCfg.relayRetransIntvlSteps = intvlSteps;
 
   /* Update Heartbeat structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommit(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5188,8 +5897,7 @@ void MeshLocalCfgSetSeqNumberThresh(meshElementId_t elementId, meshSeqNumber_t s
       ((seqNumber / MESH_SEQ_NUMBER_NVM_INC) + 1) * MESH_SEQ_NUMBER_NVM_INC;
 
     /* Save the next SEQ number threshold value to NVM. */
-    WsfNvmWriteData(MESH_LOCAL_CFG_NVM_SEQ_NUMBER_THRESH_DATASET_ID, (uint8_t *)localCfgElement.pSeqNumberThreshArray,
-                                 sizeof(meshSeqNumber_t) * localCfgElement.elementArrayLen, NULL);
+    meshLocalCfgNvmCommitNow(MESH_LOCAL_CFG_NVM_SEQ_NUMBER_THRESH_DATASET_ID);
   }
 }
 
@@ -5245,7 +5953,7 @@ void MeshLocalCfgSetIvIndex(uint32_t ivIndex)
   localCfg.ivIndex = ivIndex;
 
   /* Update Local Cfg structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommitNow(MESH_LOCAL_CFG_NVM_DATASET_ID);
 
   /* Signal event to the application. */
   evt.hdr.event = MESH_CORE_EVENT;
@@ -5270,7 +5978,7 @@ void MeshLocalCfgSetIvUpdateInProgress(bool_t ivUpdtInProg)
   localCfg.ivUpdtInProg = (ivUpdtInProg != FALSE) ? TRUE : FALSE;
 
   /* Update Local Cfg structure in NVM. */
-  WsfNvmWriteData(MESH_LOCAL_CFG_NVM_DATASET_ID, (uint8_t *)&localCfg, sizeof(localCfg), NULL);
+  meshLocalCfgNvmCommitNow(MESH_LOCAL_CFG_NVM_DATASET_ID);
 }
 
 /*************************************************************************************************/
@@ -5282,6 +5990,10 @@ void MeshLocalCfgSetIvUpdateInProgress(bool_t ivUpdtInProg)
 /*************************************************************************************************/
 void MeshLocalCfgEraseNvm(void)
 {
+  /* Discard pending changes so that they are not written back after the erase. */
+  WsfTimerStop(&localCfgNvm.commitTmr);
+  localCfgNvm.dirtyMask = 0;
+
   WsfNvmEraseData(MESH_LOCAL_CFG_NVM_DATASET_ID, NULL);
   WsfNvmEraseData(MESH_LOCAL_CFG_NVM_NET_KEY_DATASET_ID, NULL);
   WsfNvmEraseData(MESH_LOCAL_CFG_NVM_APP_KEY_DATASET_ID, NULL);
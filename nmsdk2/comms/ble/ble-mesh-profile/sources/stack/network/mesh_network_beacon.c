@@ -75,7 +75,9 @@
 enum meshNwkBeaconWsfMsgEvents
 {
   /*! Broadcast Timer expired message event */
-  MESH_NWK_BEACON_MSG_BCAST_TMR_EXPIRED = MESH_NWK_BEACON_MSG_START /*!< Beacon timer expired */
+  MESH_NWK_BEACON_MSG_BCAST_TMR_EXPIRED = MESH_NWK_BEACON_MSG_START, /*!< Beacon timer expired */
+  /*! Beacon authentication completed from the cache message event */
+  MESH_NWK_BEACON_MSG_GEN_CACHED                                    /*!< Beacon generated */
 };
 
 /*! Generic function pointer. */
@@ -109,6 +111,13 @@ typedef struct meshNwkBeaconMeta_tag
                                                 */
 } meshNwkBeaconMeta_t;
 
+/*! Beacon authentication completed from the cache message. */
+typedef struct meshNwkBeaconGenCachedMsg_tag
+{
+  wsfMsgHdr_t                     hdr;         /*!< Header structure. */
+  meshNwkBeaconMeta_t             *pBeaconMeta; /*!< Pointer to beacon and meta information. */
+} meshNwkBeaconGenCachedMsg_t;
+
 /**************************************************************************************************
   Local Variables
 **************************************************************************************************/
@@ -146,66 +155,85 @@ static struct meshNwkBeaconCb_tag
 
 static void meshNwkBeaconResumeAuth(void);
 static bool_t meshNwkBeaconGenNext(uint16_t *pIndexer, meshBeaconGenInternalCback_t cback);
+static void secGenCback(bool_t isSuccess, uint8_t *pBeacon, uint16_t netKeyIndex, void *pParam);
 
 /*************************************************************************************************/
 /*!
- *  \brief     Security Beacon authentication callback implementation.
+ *  \brief     Handles the data of an authenticated Secure Network Beacon.
  *
- *  \param[in] isSuccess      TRUE if operation completed successfully.
  *  \param[in] newKeyUsed     TRUE if the new key was used to authenticate.
  *  \param[in] pSecNwkBeacon  Pointer to buffer where the Secure Network Beacon is stored.
  *  \param[in] netKeyIndex    Global network key index associated to the key that successfully
  *                            processed the received Secure Network Beacon.
- *  \param[in] pParam         Pointer to generic callback parameter provided in the request.
  *
  *  \return    None.
  */
 /*************************************************************************************************/
-static void secAuthCback(bool_t isSuccess, bool_t newKeyUsed, uint8_t *pSecNwkBeacon,
-                         uint16_t netKeyIndex, void *pParam)
+static void meshNwkBeaconHandleAuthData(bool_t newKeyUsed, const uint8_t *pSecNwkBeacon,
+                                        uint16_t netKeyIndex)
 {
   uint32_t rxIv;
   bool_t ivUpdate, keyRef;
 
-  if (isSuccess)
-  {
-    /* Extract Key Refresh and IV update flags. */
-    keyRef =  MESH_UTILS_BITMASK_CHK(pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
-                                     (1 << MESH_NWK_BEACON_KEY_REF_FLAG_SHIFT));
-    ivUpdate =  MESH_UTILS_BITMASK_CHK(pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
-                                       (1 << MESH_NWK_BEACON_IV_UPDT_FLAG_SHIFT));
+  /* Extract Key Refresh and IV update flags. */
+  keyRef =  MESH_UTILS_BITMASK_CHK(pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                                   (1 << MESH_NWK_BEACON_KEY_REF_FLAG_SHIFT));
+  ivUpdate =  MESH_UTILS_BITMASK_CHK(pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                                     (1 << MESH_NWK_BEACON_IV_UPDT_FLAG_SHIFT));
 
-    /* Extract IV index. */
-    BYTES_BE_TO_UINT32(rxIv, &pSecNwkBeacon[MESH_NWK_BEACON_IV_START_BYTE]);
+  /* Extract IV index. */
+  BYTES_BE_TO_UINT32(rxIv, &pSecNwkBeacon[MESH_NWK_BEACON_IV_START_BYTE]);
 
 #if ((defined MESH_ENABLE_TEST) && (MESH_ENABLE_TEST==1))
-    if (meshTestCb.listenMask & MESH_TEST_NWK_LISTEN)
+  if (meshTestCb.listenMask & MESH_TEST_NWK_LISTEN)
+  {
+    meshTestSecNwkBeaconRcvdInd_t secNwkBeaconInd;
+    uint8_t *pNwkId;
+
+    secNwkBeaconInd.hdr.event = MESH_TEST_EVENT;
+    secNwkBeaconInd.hdr.param = MESH_TEST_SEC_NWK_BEACON_RCVD_IND;
+    secNwkBeaconInd.hdr.status = MESH_SUCCESS;
+    secNwkBeaconInd.ivUpdate = ivUpdate;
+    secNwkBeaconInd.keyRefresh = keyRef;
+    secNwkBeaconInd.ivi = rxIv;
+    pNwkId = MeshSecNetKeyIndexToNwkId(netKeyIndex);
+
+    if (pNwkId != NULL)
     {
-      meshTestSecNwkBeaconRcvdInd_t secNwkBeaconInd;
-      uint8_t *pNwkId;
-
-      secNwkBeaconInd.hdr.event = MESH_TEST_EVENT;
-      secNwkBeaconInd.hdr.param = MESH_TEST_SEC_NWK_BEACON_RCVD_IND;
-      secNwkBeaconInd.hdr.status = MESH_SUCCESS;
-      secNwkBeaconInd.ivUpdate = ivUpdate;
-      secNwkBeaconInd.keyRefresh = keyRef;
-      secNwkBeaconInd.ivi = rxIv;
-      pNwkId = MeshSecNetKeyIndexToNwkId(netKeyIndex);
-
-      if (pNwkId != NULL)
-      {
-        memcpy(secNwkBeaconInd.networkId, pNwkId, MESH_NWK_ID_NUM_BYTES);
-      }
-      else
-      {
-        memset(secNwkBeaconInd.networkId, 0, MESH_NWK_ID_NUM_BYTES);
-      }
-
-      meshTestCb.testCback((meshTestEvt_t *)&secNwkBeaconInd);
+      memcpy(secNwkBeaconInd.networkId, pNwkId, MESH_NWK_ID_NUM_BYTES);
     }
+    else
+    {
+      memset(secNwkBeaconInd.networkId, 0, MESH_NWK_ID_NUM_BYTES);
+    }
+
+    meshTestCb.testCback((meshTestEvt_t *)&secNwkBeaconInd);
+  }
 #endif
-    /* Call Network Management. */
-    MeshNwkMgmtHandleBeaconData(netKeyIndex, newKeyUsed, rxIv, keyRef, ivUpdate);
+  /* Call Network Management. */
+  MeshNwkMgmtHandleBeaconData(netKeyIndex, newKeyUsed, rxIv, keyRef, ivUpdate);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Security Beacon authentication callback implementation.
+ *
+ *  \param[in] isSuccess      TRUE if operation completed successfully.
+ *  \param[in] newKeyUsed     TRUE if the new key was used to authenticate.
+ *  \param[in] pSecNwkBeacon  Pointer to buffer where the Secure Network Beacon is stored.
+ *  \param[in] netKeyIndex    Global network key index associated to the key that successfully
+ *                            processed the received Secure Network Beacon.
+ *  \param[in] pParam         Pointer to generic callback parameter provided in the request.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void secAuthCback(bool_t isSuccess, bool_t newKeyUsed, uint8_t *pSecNwkBeacon,
+                         uint16_t netKeyIndex, void *pParam)
+{
+  if (isSuccess)
+  {
+    meshNwkBeaconHandleAuthData(newKeyUsed, pSecNwkBeacon, netKeyIndex);
   }
 
   /* Free memory. */
@@ -295,6 +323,8 @@ static void meshNwkBeaconPduRecvCback(meshBrInterfaceId_t brIfId,
                                       const uint8_t *pBeaconData, uint8_t dataLen)
 {
   meshNwkBeaconMeta_t *pBeaconMeta;
+  uint16_t netKeyIndex;
+  bool_t newKeyUsed;
 
   if (dataLen != MESH_NWK_BEACON_NUM_BYTES)
   {
@@ -314,6 +344,13 @@ static void meshNwkBeaconPduRecvCback(meshBrInterfaceId_t brIfId,
     return;
   }
 
+  /* Copies of an already authenticated beacon are accepted without computing the CMAC. */
+  if (MeshSecBeaconAuthCacheMatch(pBeaconData, &netKeyIndex, &newKeyUsed))
+  {
+    meshNwkBeaconHandleAuthData(newKeyUsed, pBeaconData, netKeyIndex);
+    return;
+  }
+
   /* Allocate beacon payload. */
   if ((pBeaconMeta =
        (meshNwkBeaconMeta_t *)WsfBufAlloc(sizeof(meshNwkBeaconMeta_t) + MESH_NWK_BEACON_NUM_BYTES))
@@ -513,6 +550,41 @@ static meshNwkBeaconMeta_t *meshNwkBeaconAllocateBeaconMeta(uint8_t *pBeacon, ui
   return pBeaconMeta;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Starts computing the authentication value of a beacon.
+ *
+ *  \param[in] pBeaconMeta  Pointer to beacon and meta information.
+ *
+ *  \return    MESH_SUCCESS if secGenCback() is called on completion, error otherwise.
+ */
+/*************************************************************************************************/
+static meshSecRetVal_t meshNwkBeaconComputeAuth(meshNwkBeaconMeta_t *pBeaconMeta)
+{
+  meshNwkBeaconGenCachedMsg_t *pMsg;
+  bool_t useNewKey = BEACON_AUTH_WITH_NEW_KEY(pBeaconMeta->netKeyIndex);
+
+  /* A beacon with the fields of a previous one is completed from the cache. Completion is still
+   * signaled from the message handler as callers mark the generation in progress afterwards.
+   */
+  if ((pMsg = WsfMsgAlloc(sizeof(meshNwkBeaconGenCachedMsg_t))) != NULL)
+  {
+    if (MeshSecBeaconComputeAuthCached(pBeaconMeta->pBeacon, pBeaconMeta->netKeyIndex, useNewKey))
+    {
+      pMsg->hdr.event = MESH_NWK_BEACON_MSG_GEN_CACHED;
+      pMsg->pBeaconMeta = pBeaconMeta;
+
+      WsfMsgSend(meshCb.handlerId, pMsg);
+      return MESH_SUCCESS;
+    }
+
+    WsfMsgFree(pMsg);
+  }
+
+  return MeshSecBeaconComputeAuth(pBeaconMeta->pBeacon, pBeaconMeta->netKeyIndex, useNewKey,
+                                  secGenCback, pBeaconMeta);
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Mesh Security Secure Network Beacon authentication calculated callback.
@@ -553,10 +625,7 @@ static void secGenCback(bool_t isSuccess, uint8_t *pBeacon, uint16_t netKeyIndex
   while ((pBeaconMeta = WsfQueueDeq(&meshNwkBeaconCb.txBeaconQueue)) != NULL)
   {
     /* Check if security accepts new request. */
-    if (MeshSecBeaconComputeAuth(pBeaconMeta->pBeacon,
-                                 pBeaconMeta->netKeyIndex, BEACON_AUTH_WITH_NEW_KEY(netKeyIndex),
-                                 secGenCback, pBeaconMeta)
-        == MESH_SUCCESS)
+    if (meshNwkBeaconComputeAuth(pBeaconMeta) == MESH_SUCCESS)
     {
       /* Set generation in progress flag. */
       meshNwkBeaconCb.genInProgr = TRUE;
@@ -773,10 +842,7 @@ static bool_t meshNwkBeaconGenNext(uint16_t *pIndexer, meshBeaconGenInternalCbac
     }
 
     /* Call security to compute authentication. */
-    if(MeshSecBeaconComputeAuth(pBeaconMeta->pBeacon, netKeyIndex,
-                                BEACON_AUTH_WITH_NEW_KEY(netKeyIndex), secGenCback,
-                                pBeaconMeta)
-       != MESH_SUCCESS)
+    if(meshNwkBeaconComputeAuth(pBeaconMeta) != MESH_SUCCESS)
     {
       /* Free memory. */
       WsfBufFree(pBeaconMeta);
@@ -805,6 +871,8 @@ static bool_t meshNwkBeaconGenNext(uint16_t *pIndexer, meshBeaconGenInternalCbac
 /*************************************************************************************************/
 static void meshNwkBeaconWsfMsgHandlerCback(wsfMsgHdr_t *pMsg)
 {
+  meshNwkBeaconMeta_t *pBeaconMeta;
+
   /* Check event type to handle timer expiration. */
   switch(pMsg->event)
   {
@@ -819,6 +887,11 @@ static void meshNwkBeaconWsfMsgHandlerCback(wsfMsgHdr_t *pMsg)
         WsfTimerStartSec(&(meshNwkBeaconCb.bcastTmr), MESH_NWK_BEACON_INTVL_SEC);
       }
       break;
+    case MESH_NWK_BEACON_MSG_GEN_CACHED:
+      /* Complete generation with the authentication value copied from the cache. */
+      pBeaconMeta = ((meshNwkBeaconGenCachedMsg_t *)pMsg)->pBeaconMeta;
+      secGenCback(TRUE, pBeaconMeta->pBeacon, pBeaconMeta->netKeyIndex, pBeaconMeta);
+      break;
     default:
       break;
   }
@@ -964,10 +1037,7 @@ void MeshNwkBeaconTriggerSend(uint16_t netKeyIndex)
   }
 
   /* Call security to compute authentication. */
-  if(MeshSecBeaconComputeAuth(pBeaconMeta->pBeacon, netKeyIndex,
-                              BEACON_AUTH_WITH_NEW_KEY(netKeyIndex), secGenCback,
-                              pBeaconMeta)
-     != MESH_SUCCESS)
+  if(meshNwkBeaconComputeAuth(pBeaconMeta) != MESH_SUCCESS)
   {
     /* Free memory. */
     WsfBufFree(pBeaconMeta);
@@ -1024,10 +1094,7 @@ bool_t MeshNwkBeaconGenOnDemand(uint16_t netKeyIndex, uint8_t *pBuf,
   }
 
   /* Call security to compute authentication. */
-  if(MeshSecBeaconComputeAuth(pBeaconMeta->pBeacon, netKeyIndex,
-                              BEACON_AUTH_WITH_NEW_KEY(netKeyIndex), secGenCback,
-                              pBeaconMeta)
-     != MESH_SUCCESS)
+  if(meshNwkBeaconComputeAuth(pBeaconMeta) != MESH_SUCCESS)
   {
     /* Free memory. */
     WsfBufFree(pBeaconMeta);
@@ -406,10 +406,11 @@ static void meshNetworkManagePduSend(meshNwkPduMeta_t *pNwkPduMeta)
       continue;
     }
 
-    /* Send a PDU reference to the bearer. */
+    /* Send a PDU reference to the bearer. Anything this node did not originate is relayed. */
     if (MeshBrSendNwkPdu(nwkIfCb.interfaces[idx].brIfId,
                          pNwkPduMeta->nwkPdu,
-                         pNwkPduMeta->pduLen))
+                         pNwkPduMeta->pduLen,
+                         !(pNwkPduMeta->nwkPduTag & MESH_NWK_TAG_SEND_ON_ADV_IF)))
     {
       /* Increment reference count. */
       ++(pNwkPduMeta->pduRefCount);
@@ -966,9 +967,6 @@ static void meshNwkTagRxPdu(meshNwkPduRxInfo_t *pNwkPduRxInfo, meshNwkIf_t *pNwk
   /* Declare proxy state. */
   meshGattProxyStates_t proxyState;
 
-  /* Declare element variable. */
-  meshElement_t *pElement = NULL;
-
   /* Get Own Element address. */
   meshAddress_t elem0Addr;
 
@@ -989,25 +987,10 @@ static void meshNwkTagRxPdu(meshNwkPduRxInfo_t *pNwkPduRxInfo, meshNwkIf_t *pNwk
   /* Bearer should always be valid. */
   WSF_ASSERT(pNwkIf != NULL);
 
-  /* If address is unicast check elements. */
-  if (MESH_IS_ADDR_UNICAST(pNwkPduRxInfo->dst))
-  {
-    /* Search address in the element list */
-    MeshLocalCfgGetElementFromAddress(pNwkPduRxInfo->dst, (const meshElement_t**) &pElement);
-
-    if(pElement != NULL)
-    {
-      *pOutFwdToLtr = TRUE;
-    }
-  }
-  else
+  /* Check if the destination is a local element, a fixed group or a subscribed address. */
+  if (MeshLocalCfgIsDstAddrAccepted(pNwkPduRxInfo->dst))
   {
-    /* Check if the non-unicast destination address is in any subscription list. */
-    if (MeshLocalCfgFindSubscrAddr(pNwkPduRxInfo->dst) ||
-        MESH_IS_ADDR_FIXED_GROUP(pNwkPduRxInfo->dst))
-    {
-      *pOutFwdToLtr = TRUE;
-    }
+    *pOutFwdToLtr = TRUE;
   }
 
   /* Check if PDU is not a replay attack on local elements or subscribed addresses. */
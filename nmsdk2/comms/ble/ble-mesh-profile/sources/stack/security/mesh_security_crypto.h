@@ -273,6 +273,7 @@ typedef struct meshSecNwkBeaconAuthReq_tag
                                                    *   are susceptible to removal
                                                    */
   bool_t                   newKeyUsed;            /*!< TRUE if the new Key is currently tested. */
+  uint8_t                  cmacCount;             /*!< CMAC computations spent on the request */
 } meshSecNwkBeaconAuthReq_t;
 
 /*! Request sources for crypto operations. */
@@ -355,6 +356,15 @@ static inline void meshSecBuildNonce(uint8_t nonceType, uint8_t ttlCtlAszMicPad,
   *(pNonceBuff++) = (uint8_t)(ivIndex);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Clears the Secure Network Beacon authentication cache and its statistics.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void meshSecBeaconCacheReset(void);
+
 #ifdef __cplusplus
 }
 #endif
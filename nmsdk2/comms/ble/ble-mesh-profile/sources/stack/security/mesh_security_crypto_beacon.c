@@ -48,12 +48,113 @@
 #include "mesh_security_main.h"
 #include "mesh_security_crypto.h"
 
+#include "cfg_mesh_stack.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! Number of Secure Network Beacon bytes stored in the cache (Flags, Network ID, IV index and
+ *  authentication value).
+ */
+#define MESH_SEC_BEACON_CACHE_NUM_BYTES  (MESH_NWK_BEACON_NUM_BYTES - MESH_NWK_BEACON_FLAGS_BYTE_POS)
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! Secure Network Beacon authentication cache entry. */
+typedef struct meshSecBeaconCacheEntry_tag
+{
+  uint8_t   beacon[MESH_SEC_BEACON_CACHE_NUM_BYTES]; /*!< Authenticated beacon from the Flags */
+  uint16_t  netKeyIndex;                             /*!< NetKey Index of the Beacon Key */
+  uint8_t   cmacCount;                               /*!< CMAC computations the beacon took */
+  bool_t    inUse;                                   /*!< TRUE if the entry is in use */
+} meshSecBeaconCacheEntry_t;
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! Secure Network Beacon authentication cache. */
+static struct meshSecBeaconCache_tag
+{
+  meshSecBeaconCacheEntry_t entries[MESH_SEC_BEACON_AUTH_CACHE_SIZE]; /*!< Cache entries */
+  meshSecBeaconCacheStats_t stats;                                    /*!< Statistics */
+  uint8_t                   nextIdx;                                  /*!< Next entry replaced */
+} secBeaconCache;
+
 /**************************************************************************************************
   Local Functions
 **************************************************************************************************/
 
 static meshSecRetVal_t meshSecTryNextAuthParams(meshSecNwkBeaconAuthReq_t *pReq);
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Finds the Network Key information with available material for a NetKey Index.
+ *
+ *  \param[in] netKeyIndex  Global Network Key identifier.
+ *
+ *  \return    Pointer to Network Key information or NULL if not found.
+ */
+/*************************************************************************************************/
+static meshSecNetKeyInfo_t *meshSecBeaconFindNetKeyInfo(uint16_t netKeyIndex)
+{
+  uint16_t idx;
+
+  for (idx = 0; idx < secMatLocals.netKeyInfoListSize; idx++)
+  {
+    if((secMatLocals.pNetKeyInfoArray[idx].hdr.keyIndex == netKeyIndex) &&
+       (secMatLocals.pNetKeyInfoArray[idx].hdr.flags & MESH_SEC_KEY_CRT_MAT_AVAILABLE))
+    {
+      return &secMatLocals.pNetKeyInfoArray[idx];
+    }
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Stores an authenticated Secure Network Beacon in the cache.
+ *
+ *  \param[in] pSecNwkBeacon  Pointer to Secure Network Beacon.
+ *  \param[in] netKeyIndex    NetKey Index of the Beacon Key that authenticates the beacon.
+ *  \param[in] cmacCount      CMAC computations needed to authenticate the beacon.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshSecBeaconCacheAdd(const uint8_t *pSecNwkBeacon, uint16_t netKeyIndex,
+                                  uint8_t cmacCount)
+{
+  meshSecBeaconCacheEntry_t *pEntry;
+  uint8_t idx;
+
+  for (idx = 0; idx < MESH_SEC_BEACON_AUTH_CACHE_SIZE; idx++)
+  {
+    pEntry = &secBeaconCache.entries[idx];
+
+    if (pEntry->inUse && (pEntry->netKeyIndex == netKeyIndex) &&
+        (memcmp(pEntry->beacon, &pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                MESH_SEC_BEACON_CACHE_NUM_BYTES) == 0x00))
+    {
+      return;
+    }
+  }
+
+  /* Replace the oldest entry. */
+  pEntry = &secBeaconCache.entries[secBeaconCache.nextIdx];
+  secBeaconCache.nextIdx = (secBeaconCache.nextIdx + 1) % MESH_SEC_BEACON_AUTH_CACHE_SIZE;
+
+  memcpy(pEntry->beacon, &pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
+         MESH_SEC_BEACON_CACHE_NUM_BYTES);
+  pEntry->netKeyIndex = netKeyIndex;
+  pEntry->cmacCount = cmacCount;
+  pEntry->inUse = TRUE;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Implementation of the CMAC callback used for computing Beacon Authentication Value.
@@ -92,6 +193,9 @@ static void meshSecBeaconCompCback(const uint8_t *pCmacResult, void *pParam)
     memcpy(&(pReq->pSecBeacon[MESH_NWK_BEACON_NUM_BYTES - MESH_NWK_BEACON_AUTH_NUM_BYTES]),
            pCmacResult,
            MESH_NWK_BEACON_AUTH_NUM_BYTES);
+
+    /* Remember the beacon for the next generation with the same fields. */
+    meshSecBeaconCacheAdd(pReq->pSecBeacon, pReq->netKeyIndex, 1);
   }
 
    /* Invoke user callback. */
@@ -137,6 +241,9 @@ static void meshSecBeaconVerificationCback(const uint8_t *pCmacResult, void *pPa
       /* Clear callback to make request available. */
       pReq->cback = NULL;
 
+      /* Remember the beacon so that copies received from other nodes skip the CMAC. */
+      meshSecBeaconCacheAdd(pReq->pSecBeacon, pReq->netKeyIndex, pReq->cmacCount);
+
       /* Invoke user callback. */
       cback(TRUE, pReq->newKeyUsed, pReq->pSecBeacon, pReq->netKeyIndex, pReq->pParam);
 
@@ -246,6 +353,10 @@ static meshSecRetVal_t meshSecTryNextAuthParams(meshSecNwkBeaconAuthReq_t *pReq)
   /* Increment key search index for the following requests. */
   ++(pReq->keySearchIndex);
 
+  /* Count the computation. */
+  pReq->cmacCount++;
+  secBeaconCache.stats.cmacCount++;
+
   /* Call Toolbox to compute authentication value. */
   return (meshSecRetVal_t)MeshSecToolCmacCalculate(pReq->bk,
                                                    &pReq->pSecBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
@@ -291,7 +402,6 @@ meshSecRetVal_t MeshSecBeaconComputeAuth(uint8_t *pSecNwkBeacon, uint16_t netKey
   meshSecNetKeyInfo_t  *pNetKeyInfo = NULL;
   uint8_t              *pLocalNwkId = NULL;
   meshSecRetVal_t      retVal       = MESH_SUCCESS;
-  uint16_t             idx          = 0;
 
   /* Validate parameters. */
   if((pSecNwkBeacon == NULL) ||
@@ -308,15 +418,7 @@ meshSecRetVal_t MeshSecBeaconComputeAuth(uint8_t *pSecNwkBeacon, uint16_t netKey
   }
 
   /* Search for material matching input NetKey Index. */
-  for (idx = 0; idx < secMatLocals.netKeyInfoListSize; idx++)
-  {
-    if((secMatLocals.pNetKeyInfoArray[idx].hdr.keyIndex == netKeyIndex) &&
-       (secMatLocals.pNetKeyInfoArray[idx].hdr.flags & MESH_SEC_KEY_CRT_MAT_AVAILABLE))
-    {
-      pNetKeyInfo = &secMatLocals.pNetKeyInfoArray[idx];
-      break;
-    }
-  }
+  pNetKeyInfo = meshSecBeaconFindNetKeyInfo(netKeyIndex);
 
   /* Check if no NetKey Index matched. */
   if (pNetKeyInfo == NULL)
@@ -371,6 +473,8 @@ meshSecRetVal_t MeshSecBeaconComputeAuth(uint8_t *pSecNwkBeacon, uint16_t netKey
     /* Set user callback and parameter. */
     secCryptoReq.beaconCompAuthReq.cback = secNwkBeaconGenCback;
     secCryptoReq.beaconCompAuthReq.pParam   = pParam;
+
+    secBeaconCache.stats.cmacCount++;
   }
 
   return retVal;
@@ -415,6 +519,7 @@ meshSecRetVal_t MeshSecBeaconAuthenticate(uint8_t *pSecNwkBeacon,
 
   /* Reset key search index. */
   secCryptoReq.beaconAuthReq.keySearchIndex = 0;
+  secCryptoReq.beaconAuthReq.cmacCount = 0;
 
   /* Store beacon parameter. */
   secCryptoReq.beaconAuthReq.pSecBeacon = pSecNwkBeacon;
@@ -431,3 +536,165 @@ meshSecRetVal_t MeshSecBeaconAuthenticate(uint8_t *pSecNwkBeacon,
 
   return retVal;
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Authenticates a received Secure Network Beacon from the authentication cache.
+ *
+ *  \param[in]  pSecNwkBeacon  Pointer to received Secure Network Beacon.
+ *  \param[out] pNetKeyIndex   Global network key index of the key that authenticates the beacon.
+ *  \param[out] pNewKeyUsed    TRUE if the new key authenticates the beacon.
+ *
+ *  \return     TRUE if the beacon matches a cached beacon, FALSE if it must be authenticated with
+ *              MeshSecBeaconAuthenticate().
+ */
+/*************************************************************************************************/
+bool_t MeshSecBeaconAuthCacheMatch(const uint8_t *pSecNwkBeacon, uint16_t *pNetKeyIndex,
+                                   bool_t *pNewKeyUsed)
+{
+  meshSecBeaconCacheEntry_t *pEntry;
+  meshSecNetKeyInfo_t *pNetKeyInfo;
+  uint8_t idx, entryId;
+
+  for (idx = 0; idx < MESH_SEC_BEACON_AUTH_CACHE_SIZE; idx++)
+  {
+    pEntry = &secBeaconCache.entries[idx];
+
+    if (!pEntry->inUse ||
+        (memcmp(pEntry->beacon, &pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                MESH_SEC_BEACON_CACHE_NUM_BYTES) != 0x00))
+    {
+      continue;
+    }
+
+    /* The key material may have changed since the beacon was authenticated. Find the material
+     * that still has the Network ID of the beacon.
+     */
+    if ((pNetKeyInfo = meshSecBeaconFindNetKeyInfo(pEntry->netKeyIndex)) == NULL)
+    {
+      continue;
+    }
+
+    entryId = pNetKeyInfo->hdr.crtKeyId;
+
+    if (memcmp(&pSecNwkBeacon[MESH_NWK_BEACON_NWK_ID_START_BYTE],
+               pNetKeyInfo->keyMaterial[entryId].networkID, MESH_NWK_ID_NUM_BYTES) != 0x00)
+    {
+      entryId = 1 - entryId;
+
+      if (!(pNetKeyInfo->hdr.flags & MESH_SEC_KEY_UPDT_MAT_AVAILABLE) ||
+          (memcmp(&pSecNwkBeacon[MESH_NWK_BEACON_NWK_ID_START_BYTE],
+                  pNetKeyInfo->keyMaterial[entryId].networkID, MESH_NWK_ID_NUM_BYTES) != 0x00))
+      {
+        continue;
+      }
+    }
+
+    /* 3.10.4.2, 3.10.4.3 In phase 2 (and 3) a node shall only receive Secure Network beacons
+     * secured using the new NetKey.
+     */
+    if ((entryId == pNetKeyInfo->hdr.crtKeyId) &&
+        (MeshLocalCfgGetKeyRefreshPhaseState(pNetKeyInfo->hdr.keyIndex) >
+         MESH_KEY_REFRESH_FIRST_PHASE))
+    {
+      continue;
+    }
+
+    *pNetKeyIndex = pEntry->netKeyIndex;
+    *pNewKeyUsed = (entryId != pNetKeyInfo->hdr.crtKeyId);
+
+    secBeaconCache.stats.rxHits++;
+    secBeaconCache.stats.cmacAvoided += pEntry->cmacCount;
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Completes a Secure Network Beacon from the authentication cache.
+ *
+ *  \param[in] pSecNwkBeacon  Pointer to 22 byte buffer storing the Secure Network Beacon.
+ *  \param[in] netKeyIndex    Global Network Key identifier.
+ *  \param[in] useNewKey      TRUE if new key should be used for computation.
+ *
+ *  \return    TRUE if the Network ID and authentication value are copied in the beacon, FALSE if
+ *             they must be computed with MeshSecBeaconComputeAuth().
+ */
+/*************************************************************************************************/
+bool_t MeshSecBeaconComputeAuthCached(uint8_t *pSecNwkBeacon, uint16_t netKeyIndex,
+                                      bool_t useNewKey)
+{
+  meshSecBeaconCacheEntry_t *pEntry;
+  meshSecNetKeyInfo_t *pNetKeyInfo;
+  uint8_t *pLocalNwkId;
+  uint8_t idx;
+
+  if ((pNetKeyInfo = meshSecBeaconFindNetKeyInfo(netKeyIndex)) == NULL)
+  {
+    return FALSE;
+  }
+
+  if (useNewKey && !(pNetKeyInfo->hdr.flags & MESH_SEC_KEY_UPDT_MAT_AVAILABLE))
+  {
+    return FALSE;
+  }
+
+  pLocalNwkId = useNewKey ? pNetKeyInfo->keyMaterial[1 - pNetKeyInfo->hdr.crtKeyId].networkID :
+                            pNetKeyInfo->keyMaterial[pNetKeyInfo->hdr.crtKeyId].networkID;
+
+  for (idx = 0; idx < MESH_SEC_BEACON_AUTH_CACHE_SIZE; idx++)
+  {
+    pEntry = &secBeaconCache.entries[idx];
+
+    /* Match Flags, Network ID and IV index. */
+    if (pEntry->inUse && (pEntry->netKeyIndex == netKeyIndex) &&
+        (pEntry->beacon[0] == pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS]) &&
+        (memcmp(&pEntry->beacon[MESH_NWK_BEACON_NWK_ID_START_BYTE - MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                pLocalNwkId, MESH_NWK_ID_NUM_BYTES) == 0x00) &&
+        (memcmp(&pEntry->beacon[MESH_NWK_BEACON_IV_START_BYTE - MESH_NWK_BEACON_FLAGS_BYTE_POS],
+                &pSecNwkBeacon[MESH_NWK_BEACON_IV_START_BYTE], sizeof(uint32_t)) == 0x00))
+    {
+      memcpy(&pSecNwkBeacon[MESH_NWK_BEACON_FLAGS_BYTE_POS], pEntry->beacon,
+             MESH_SEC_BEACON_CACHE_NUM_BYTES);
+
+      secBeaconCache.stats.txHits++;
+      secBeaconCache.stats.cmacAvoided += pEntry->cmacCount;
+
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief      Gets the Secure Network Beacon authentication cache statistics.
+ *
+ *  \param[out] pStats  Pointer to statistics.
+ *
+ *  \return     None.
+ */
+/*************************************************************************************************/
+void MeshSecBeaconGetCacheStats(meshSecBeaconCacheStats_t *pStats)
+{
+  if (pStats != NULL)
+  {
+    *pStats = secBeaconCache.stats;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Clears the Secure Network Beacon authentication cache and its statistics.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void meshSecBeaconCacheReset(void)
+{
+  memset(&secBeaconCache, 0, sizeof(secBeaconCache));
+}
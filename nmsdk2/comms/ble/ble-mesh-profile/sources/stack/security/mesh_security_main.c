@@ -221,6 +221,9 @@ void MeshSecInit(void)
   /* Reset Beacon Authentication requests. */
   secCryptoReq.beaconAuthReq.cback     = NULL;
   secCryptoReq.beaconCompAuthReq.cback = NULL;
+
+  /* Forget authenticated beacons. */
+  meshSecBeaconCacheReset();
 }
 
 /*************************************************************************************************/
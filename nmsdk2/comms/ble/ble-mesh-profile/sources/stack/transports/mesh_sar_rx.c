@@ -32,6 +32,7 @@
 #include "wsf_cs.h"
 #include "wsf_trace.h"
 
+#include "cfg_mesh_stack.h"
 #include "mesh_defs.h"
 #include "mesh_types.h"
 #include "mesh_utils.h"
@@ -56,15 +57,17 @@
 
 /*! Pointer to ACC info for the transaction at the specified index */
 #define SAR_RX_TRAN_ACC_INFO(tranIndex) \
-        ((meshLtrAccPduInfo_t *)sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo)
+        (&sarRxCb.pTranInfoTable[tranIndex].pduInfo.accPduInfo)
 
 /*! Pointer to CTL info for the transaction at the specified index */
 #define SAR_RX_TRAN_CTL_INFO(tranIndex) \
-        ((meshLtrCtlPduInfo_t *)sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo)
+        (&sarRxCb.pTranInfoTable[tranIndex].pduInfo.ctlPduInfo)
 
-/*! Gets last entry in the Friend Segment Info array. */
-#define SAR_RX_TRAN_LAST_FRIEND_SEG_INFO(tranIndex) \
-        sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo[sarRxCb.pTranInfoTable[tranIndex].friendSegInfoIdx]
+/*! Maximum number of segments in a transaction */
+#define SAR_RX_MAX_SEGMENTS         (MESH_SEG_N_MASK + 1)
+
+/*! Value of a segment slot reference when the segment was not received */
+#define SAR_RX_SEG_SLOT_NONE        0
 
 /*! Creates the SAR Rx Block Mask with all fragments received */
 #define SAR_RX_BLOCK_MASK(segN)     (((segN) == 31U) ? 0xFFFFFFFFU : (uint32_t)MESH_UTILS_BTMASK_MAKE((segN) + 1))
@@ -112,18 +115,39 @@ enum meshSarRxTranStateValues
 /*! Mesh SAR Rx transaction state data type. See ::meshSarRxTranStateValues */
 typedef uint8_t meshSarRxTranState_t;
 
+/*! Mesh SAR Rx segment slot. Holds the payload of one received segment until the transaction
+ *  is complete.
+ */
+typedef struct meshSarRxSegSlot_tag
+{
+  meshSeqNumber_t           segSeqNo;            /*!< Sequence number of the segment, used to
+                                                  *   rebuild the segments for the Friend Queue.
+                                                  */
+  uint8_t                   data[MESH_ACC_SEG_MAX_LENGTH]; /*!< Segment payload. While the slot
+                                                            *   is free, data[0] links to the
+                                                            *   next free slot.
+                                                            */
+} meshSarRxSegSlot_t;
+
 /*! Mesh SAR Rx reassemble transaction information */
 typedef struct meshSarRxTranInfo_tag
 {
   void                      *pLtrPduInfo;        /*!< Reassembled PDU formatted by the pduType
-                                                  *   parameter.
+                                                  *   parameter. Only allocated once the
+                                                  *   transaction is complete.
                                                   */
-  meshSarRxSegInfoFriend_t  *pFriendSegInfo;     /*!< Reassembled PDU information to reconstruct
-                                                  *   original segments for the Friend Queue.
+  meshSarRxReassembledPduInfo_t pduInfo;         /*!< PDU information gathered while the segments
+                                                  *   are received.
                                                   */
   wsfTimer_t                ackTmr;              /*!< ACK timer */
   wsfTimer_t                incompTmr;           /*!< Incomplete timer */
-  uint8_t                   friendSegInfoIdx;    /*!< Friend segment info index. */
+  uint8_t                   segSlot[SAR_RX_MAX_SEGMENTS]; /*!< Segment slot index plus one for each
+                                                           *   received segment, indexed by SegO.
+                                                           */
+  uint8_t                   segReserved;         /*!< Segment slots reserved in the pool */
+  bool_t                    toFriend;            /*!< TRUE if the PDU is also destined for the
+                                                  *   Friend Queue.
+                                                  */
   meshSarRxTranState_t      state;               /*!< State of this transaction. Only
                                                   *   ::MESH_SAR_RX_TRAN_NOT_STARTED
                                                   *   and ::MESH_SAR_RX_TRAN_IN_PROGRESS
@@ -162,6 +186,14 @@ typedef struct meshSarRxCb_t
   uint8_t                               tranInfoSize;              /*!< Size of the transaction
                                                                     *   info table
                                                                     */
+  meshSarRxSegSlot_t                    *pSegPool;                 /*!< Segment slot pool */
+  uint8_t                               segPoolSize;               /*!< Number of segment slots */
+  uint8_t                               segFreeHead;               /*!< First free slot index plus
+                                                                    *   one, 0 if none
+                                                                    */
+  uint8_t                               segReserved;               /*!< Slots reserved by the
+                                                                    *   transactions in progress
+                                                                    */
 } meshSarRxCb_t;
 
 /**************************************************************************************************
@@ -190,6 +222,188 @@ static inline uint32_t meshSarRxTranInfoGetRequiredMemory(uint8_t tranSize)
   return MESH_UTILS_ALIGN(sizeof(meshSarRxTranInfo_t) * tranSize);
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief     Computes memory requirements for the SAR Rx segment slot pool.
+ *
+ *  \param[in] poolSize  Number of segment slots.
+ *
+ *  \return    Required memory in bytes for the segment slot pool.
+ */
+/*************************************************************************************************/
+static inline uint32_t meshSarRxSegPoolGetRequiredMemory(uint8_t poolSize)
+{
+  return MESH_UTILS_ALIGN(sizeof(meshSarRxSegSlot_t) * poolSize);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Reserves segment slots for a new transaction.
+ *
+ *  \param[in] tranIndex  Index of the SAR Rx transaction in the transaction table.
+ *  \param[in] segN       Last segment number.
+ *
+ *  \return    TRUE if the slots are reserved, FALSE if the pool cannot hold the transaction.
+ *
+ *  \remarks   Reserving every slot of a transaction up front means that an admitted transaction
+ *             always completes, instead of several partial transactions holding the pool until
+ *             they time out.
+ */
+/*************************************************************************************************/
+static bool_t meshSarRxSegReserve(uint8_t tranIndex, uint8_t segN)
+{
+  if (sarRxCb.segReserved + segN + 1 > sarRxCb.segPoolSize)
+  {
+    return FALSE;
+  }
+
+  sarRxCb.segReserved += segN + 1;
+  sarRxCb.pTranInfoTable[tranIndex].segReserved = segN + 1;
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Stores a segment in a slot reserved by its transaction.
+ *
+ *  \param[in] tranIndex  Index of the SAR Rx transaction in the transaction table.
+ *  \param[in] segO       Segment number.
+ *  \param[in] segSeqNo   Sequence number of the segment.
+ *  \param[in] pData      Segment payload.
+ *  \param[in] len        Segment payload length.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshSarRxSegStore(uint8_t tranIndex, uint8_t segO, meshSeqNumber_t segSeqNo,
+                              const uint8_t *pData, uint8_t len)
+{
+  meshSarRxSegSlot_t *pSlot;
+  uint8_t slot = sarRxCb.segFreeHead;
+
+  /* The transaction reserved a slot for every segment, so the free list cannot be empty. */
+  WSF_ASSERT(slot != SAR_RX_SEG_SLOT_NONE);
+
+  pSlot = &sarRxCb.pSegPool[slot - 1];
+  sarRxCb.segFreeHead = pSlot->data[0];
+
+  pSlot->segSeqNo = segSeqNo;
+  memcpy(pSlot->data, pData, len);
+
+  sarRxCb.pTranInfoTable[tranIndex].segSlot[segO] = slot;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Returns the segment slots and the reservation of a transaction to the pool.
+ *
+ *  \param[in] tranIndex  Index of the SAR Rx transaction in the transaction table.
+ *
+ *  \return    None.
+ */
+/*************************************************************************************************/
+static void meshSarRxSegRelease(uint8_t tranIndex)
+{
+  meshSarRxTranInfo_t *pTran = &sarRxCb.pTranInfoTable[tranIndex];
+  uint8_t segO;
+
+  for (segO = 0; segO < SAR_RX_MAX_SEGMENTS; segO++)
+  {
+    if (pTran->segSlot[segO] != SAR_RX_SEG_SLOT_NONE)
+    {
+      sarRxCb.pSegPool[pTran->segSlot[segO] - 1].data[0] = sarRxCb.segFreeHead;
+      sarRxCb.segFreeHead = pTran->segSlot[segO];
+      pTran->segSlot[segO] = SAR_RX_SEG_SLOT_NONE;
+    }
+  }
+
+  sarRxCb.segReserved -= pTran->segReserved;
+  pTran->segReserved = 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief     Gathers the segments of a complete transaction into a contiguous PDU.
+ *
+ *  \param[in] tranIndex  Index of the SAR Rx transaction in the transaction table.
+ *
+ *  \return    Pointer to the Friend Segment Info array if the PDU is destined for the Friend
+ *             Queue, NULL otherwise. The array is allocated in the same buffer as the PDU.
+ *
+ *  \remarks   On success pLtrPduInfo points to the gathered PDU and the segment slots are
+ *             released. pLtrPduInfo is NULL if no buffer is available.
+ */
+/*************************************************************************************************/
+static meshSarRxSegInfoFriend_t *meshSarRxGather(uint8_t tranIndex)
+{
+  meshSarRxTranInfo_t *pTran = &sarRxCb.pTranInfoTable[tranIndex];
+  meshSarRxSegInfoFriend_t *pFriendSegInfo = NULL;
+  uint16_t hdrLen, pduLen, friendOffset;
+  uint8_t segLen, lastSegLen, segO;
+  uint8_t *pBuf, *pPdu;
+
+  if (pTran->pduType == MESH_SAR_RX_TYPE_CTL)
+  {
+    hdrLen = sizeof(meshLtrCtlPduInfo_t);
+    pduLen = pTran->pduInfo.ctlPduInfo.pduLen;
+    segLen = MESH_CTL_SEG_MAX_LENGTH;
+  }
+  else
+  {
+    hdrLen = sizeof(meshLtrAccPduInfo_t);
+    pduLen = pTran->pduInfo.accPduInfo.pduLen;
+    segLen = MESH_ACC_SEG_MAX_LENGTH;
+  }
+
+  lastSegLen = (uint8_t)(pduLen - (pTran->segN * segLen));
+  friendOffset = MESH_UTILS_ALIGN(hdrLen + pduLen);
+
+  pBuf = WsfBufAlloc(friendOffset +
+                     (pTran->toFriend ? (pTran->segN + 1) * sizeof(meshSarRxSegInfoFriend_t) : 0));
+  pTran->pLtrPduInfo = pBuf;
+
+  if (pBuf == NULL)
+  {
+    return NULL;
+  }
+
+  /* Copy PDU information and point it to the data that follows. */
+  memcpy(pBuf, &pTran->pduInfo, hdrLen);
+  pPdu = pBuf + hdrLen;
+
+  if (pTran->pduType == MESH_SAR_RX_TYPE_CTL)
+  {
+    ((meshLtrCtlPduInfo_t *)pBuf)->pUtrCtlPdu = pPdu;
+  }
+  else
+  {
+    ((meshLtrAccPduInfo_t *)pBuf)->pUtrAccPdu = pPdu;
+  }
+
+  if (pTran->toFriend)
+  {
+    pFriendSegInfo = (meshSarRxSegInfoFriend_t *)(pBuf + friendOffset);
+  }
+
+  for (segO = 0; segO <= pTran->segN; segO++)
+  {
+    memcpy(pPdu + (segO * segLen), sarRxCb.pSegPool[pTran->segSlot[segO] - 1].data,
+           (segO == pTran->segN) ? lastSegLen : segLen);
+
+    if (pFriendSegInfo != NULL)
+    {
+      pFriendSegInfo[segO].segO = segO;
+      pFriendSegInfo[segO].segSeqNo = sarRxCb.pSegPool[pTran->segSlot[segO] - 1].segSeqNo;
+      pFriendSegInfo[segO].offset = segO * segLen;
+    }
+  }
+
+  meshSarRxSegRelease(tranIndex);
+
+  return pFriendSegInfo;
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief     Mesh SAR Rx PDU reassembled empty callback.
@@ -272,10 +486,11 @@ static void meshSarRxResetTransaction(uint8_t tranIndex, bool_t obo)
 {
   if (sarRxCb.pTranInfoTable[tranIndex].state != MESH_SAR_RX_TRAN_COMPLETE)
   {
-    /* Free allocated message only if transaction is not completed. When the transaction is
-     * completed, the Upper Transport Layer shall free the message.
+    /* Release segment slots only if transaction is not completed. When the transaction is
+     * completed, the slots were released by the gather and the Upper Transport Layer shall
+     * free the message.
      */
-    WsfBufFree(sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo);
+    meshSarRxSegRelease(tranIndex);
 
     /* Reset SegN to use it in the history */
     sarRxCb.pTranInfoTable[tranIndex].segN = 0;
@@ -299,13 +514,6 @@ static void meshSarRxResetTransaction(uint8_t tranIndex, bool_t obo)
                         obo);
   }
 
-  /* Check if Friendship segment info array is allocated. */
-  if(sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL)
-  {
-    /* Free memory */
-    WsfBufFree(sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo);
-  }
-
   /* Stop timers. */
   WsfTimerStop(&(sarRxCb.pTranInfoTable[tranIndex].ackTmr));
   WsfTimerStop(&(sarRxCb.pTranInfoTable[tranIndex].incompTmr));
@@ -345,10 +553,10 @@ static void meshSarRxSendAck(uint8_t tranIndex)
   /* SEG is set to 0 for Segment ACK messages */
   ltrHdr = MESH_SEG_ACK_OPCODE;
 
-  /* If friendship segment information is present it means
+  /* If the PDU is destined for the Friend Queue it means
    * that we need to send ACK on behalf of an LPN.
    */
-  obo = sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL;
+  obo = sarRxCb.pTranInfoTable[tranIndex].toFriend;
 
   /* Prepare the message for the Network Layer */
   nwkPduTxInfo.dst = sarRxCb.pTranInfoTable[tranIndex].srcAddr;
@@ -541,8 +749,7 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
                                                          uint8_t tranIndex)
 {
   uint16_t seqZero;
-  uint8_t segO, segN;
-  uint8_t *pData;
+  uint8_t segO, segN, segLen;
   uint32_t segZeroSeqNo;
   bool_t tmrStarted = FALSE;
 
@@ -563,9 +770,18 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
   /* Extract SegN field. */
   segN = pNwkPduInfo->pLtrPdu[MESH_SEG_N_PDU_OFFSET] & MESH_SEG_N_MASK;
 
+  /* Compute segment payload length. */
+  segLen = (uint8_t)(pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
+
   /* Check if the transaction needs creating or updating */
   if (sarRxCb.pTranInfoTable[tranIndex].state == MESH_SAR_RX_TRAN_NOT_STARTED)
   {
+    /* Reserve a segment slot for each segment of the transaction. */
+    if (!meshSarRxSegReserve(tranIndex, segN))
+    {
+      return 0;
+    }
+
     /* Create SEQ to be sent to UTR */
     segZeroSeqNo = (pNwkPduInfo->seqNo & (~MESH_SEQ_ZERO_MASK)) + seqZero;
 
@@ -582,30 +798,7 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
       /* This is a CTL message */
       sarRxCb.pTranInfoTable[tranIndex].pduType = MESH_SAR_RX_TYPE_CTL;
 
-      /* Allocate buffer for UTR PDU */
-      sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo = WsfBufAlloc(sizeof(meshLtrCtlPduInfo_t) +
-                                                  (MESH_CTL_SEG_MAX_LENGTH * (segN + 1)));
-
-      /* If no memory is available, return FALSE. */
-      if (sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo == NULL)
-      {
-        return 0;
-      }
-
-      /* Set pointer to PDU */
-      SAR_RX_TRAN_CTL_INFO(tranIndex)->pUtrCtlPdu = ((uint8_t *)SAR_RX_TRAN_CTL_INFO(tranIndex)) +
-                                                    sizeof(meshLtrCtlPduInfo_t);
-
-      /* Set pointer to the data region where the PDU must be appended */
-      pData = ((uint8_t *)(SAR_RX_TRAN_CTL_INFO(tranIndex)->pUtrCtlPdu)) +
-               (segO * MESH_CTL_SEG_MAX_LENGTH);
-
-      /* Copy UTR segment data and update length */
-      memcpy(pData, &pNwkPduInfo->pLtrPdu[MESH_SEG_DATA_PDU_OFFSET],
-             pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-      SAR_RX_TRAN_CTL_INFO(tranIndex)->pduLen = (pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-
-      /* Copy UTR ACC packet information */
+      /* Copy UTR CTL packet information */
       SAR_RX_TRAN_CTL_INFO(tranIndex)->src = pNwkPduInfo->src;
       SAR_RX_TRAN_CTL_INFO(tranIndex)->dst = pNwkPduInfo->dst;
       SAR_RX_TRAN_CTL_INFO(tranIndex)->netKeyIndex = pNwkPduInfo->netKeyIndex;
@@ -621,29 +814,6 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
       /* This is an ACC message */
       sarRxCb.pTranInfoTable[tranIndex].pduType = MESH_SAR_RX_TYPE_ACCESS;
 
-      /* Allocate memory for UTR PDU */
-      sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo = WsfBufAlloc(sizeof(meshLtrAccPduInfo_t) +
-                                                  (MESH_ACC_SEG_MAX_LENGTH * (segN + 1)));
-
-      /* If no memory is available, return FALSE. */
-      if (sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo == NULL)
-      {
-        return 0;
-      }
-
-      /* Set pointer to PDU */
-      SAR_RX_TRAN_ACC_INFO(tranIndex)->pUtrAccPdu = ((uint8_t *)SAR_RX_TRAN_ACC_INFO(tranIndex)) +
-                                                        sizeof(meshLtrAccPduInfo_t);
-
-      /* Set pointer to the data region where the PDU must be appended */
-      pData = ((uint8_t *)(SAR_RX_TRAN_ACC_INFO(tranIndex)->pUtrAccPdu)) +
-              (segO * MESH_ACC_SEG_MAX_LENGTH);
-
-      /* Copy UTR segment data and update length */
-      memcpy(pData, &pNwkPduInfo->pLtrPdu[MESH_SEG_DATA_PDU_OFFSET],
-             pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-      SAR_RX_TRAN_ACC_INFO(tranIndex)->pduLen = (pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-
       /* Copy UTR ACC packet information */
       SAR_RX_TRAN_ACC_INFO(tranIndex)->src = pNwkPduInfo->src;
       SAR_RX_TRAN_ACC_INFO(tranIndex)->dst = pNwkPduInfo->dst;
@@ -683,19 +853,10 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
           return 0;
         }
       }
-      /* Allocate Friend Segment Info. */
-      else if((sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo =
-              (meshSarRxSegInfoFriend_t *)WsfBufAlloc((segN + 1) * sizeof(meshSarRxSegInfoFriend_t)))
-               == NULL)
+      else
       {
-        /* Check if the LPN was the only destination for the PDU. */
-        if(MESH_IS_ADDR_UNICAST(pNwkPduInfo->dst))
-        {
-          /* No other elements needing this. So abort. */
-          meshSarRxResetTransaction(tranIndex, TRUE);
-
-          return 0;
-        }
+        /* Segment information for the Friend Queue is rebuilt from the slots when complete. */
+        sarRxCb.pTranInfoTable[tranIndex].toFriend = TRUE;
       }
     }
 
@@ -711,12 +872,6 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
   {
     /* The transaction is in progress */
 
-    /* If no memory is available, return 0. */
-    if (sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo == NULL)
-    {
-      return 0;
-    }
-
     /* Verify segN, CTL are consistent */
     if ((segN != sarRxCb.pTranInfoTable[tranIndex].segN) ||
        (pNwkPduInfo->ctl != sarRxCb.pTranInfoTable[tranIndex].pduType))
@@ -754,16 +909,6 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
 
     if (sarRxCb.pTranInfoTable[tranIndex].pduType == MESH_SAR_RX_TYPE_CTL)
     {
-      /* This is a CTL message */
-
-      /* Set pointer to the data region where the PDU must be appended */
-      pData = ((uint8_t *)(SAR_RX_TRAN_CTL_INFO(tranIndex)->pUtrCtlPdu)) +
-              (segO * MESH_CTL_SEG_MAX_LENGTH);
-
-      /* Copy UTR segment data and update length */
-      memcpy(pData, &pNwkPduInfo->pLtrPdu[MESH_SEG_DATA_PDU_OFFSET],
-             pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-      SAR_RX_TRAN_CTL_INFO(tranIndex)->pduLen += (pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
       if (SAR_RX_TRAN_CTL_INFO(tranIndex)->gtSeqNo < pNwkPduInfo->seqNo)
       {
         SAR_RX_TRAN_CTL_INFO(tranIndex)->gtSeqNo = pNwkPduInfo->seqNo;
@@ -771,16 +916,6 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
     }
     else
     {
-      /* This is an ACC message */
-
-      /* Set pointer to the data region where the PDU must be appended */
-      pData = (uint8_t *)(SAR_RX_TRAN_ACC_INFO(tranIndex)->pUtrAccPdu) +
-              (segO * MESH_ACC_SEG_MAX_LENGTH);
-
-      /* Copy UTR segment data and update length */
-      memcpy(pData, &pNwkPduInfo->pLtrPdu[MESH_SEG_DATA_PDU_OFFSET],
-             pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
-      SAR_RX_TRAN_ACC_INFO(tranIndex)->pduLen += (pNwkPduInfo->pduLen - MESH_SEG_HEADER_LENGTH);
       if (SAR_RX_TRAN_ACC_INFO(tranIndex)->gtSeqNo < pNwkPduInfo->seqNo)
       {
         SAR_RX_TRAN_ACC_INFO(tranIndex)->gtSeqNo = pNwkPduInfo->seqNo;
@@ -788,31 +923,22 @@ static meshSarRxBlockAck_t meshSarRxAddUpdateTransaction(const meshNwkPduRxInfo_
     }
   }
 
-  /* Update the Block ACK Mask */
-  sarRxCb.pTranInfoTable[tranIndex].blockAckMask |= (1 << segO);
+  /* Store the segment payload in a reserved slot and update length */
+  meshSarRxSegStore(tranIndex, segO, pNwkPduInfo->seqNo,
+                    &pNwkPduInfo->pLtrPdu[MESH_SEG_DATA_PDU_OFFSET], segLen);
 
-  /* Set segment information if needed by Friend module. */
-  if(sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL)
+  if (sarRxCb.pTranInfoTable[tranIndex].pduType == MESH_SAR_RX_TYPE_CTL)
   {
-    SAR_RX_TRAN_LAST_FRIEND_SEG_INFO(tranIndex).segO = segO;
-    SAR_RX_TRAN_LAST_FRIEND_SEG_INFO(tranIndex).segSeqNo = pNwkPduInfo->seqNo;
-    if(pNwkPduInfo->ctl)
-    {
-      /* Compute offset of the segment. */
-      SAR_RX_TRAN_LAST_FRIEND_SEG_INFO(tranIndex).offset =
-          (pData - SAR_RX_TRAN_CTL_INFO(tranIndex)->pUtrCtlPdu);
-    }
-    else
-    {
-      /* Compute offset of the segment. */
-      SAR_RX_TRAN_LAST_FRIEND_SEG_INFO(tranIndex).offset =
-          (pData - SAR_RX_TRAN_ACC_INFO(tranIndex)->pUtrAccPdu);
-    }
-    /* There should never be more than segN + 1 segments. */
-    WSF_ASSERT(sarRxCb.pTranInfoTable[tranIndex].friendSegInfoIdx <= segN);
-    /* Move to next position. */
-    sarRxCb.pTranInfoTable[tranIndex].friendSegInfoIdx++;
+    SAR_RX_TRAN_CTL_INFO(tranIndex)->pduLen += segLen;
   }
+  else
+  {
+    SAR_RX_TRAN_ACC_INFO(tranIndex)->pduLen += segLen;
+  }
+
+  /* Update the Block ACK Mask */
+  sarRxCb.pTranInfoTable[tranIndex].blockAckMask |= (1 << segO);
+
   /* Update timeout only if there is no pending ack for this transaction and the destination
    * was unicast
    */
@@ -887,7 +1013,7 @@ static void meshSarRxIncompTmrCback(uint8_t tranIndex)
 
   /* Timeout transaction */
   meshSarRxResetTransaction(tranIndex,
-                            (sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL));
+                            sarRxCb.pTranInfoTable[tranIndex].toFriend);
 }
 
 /*************************************************************************************************/
@@ -933,6 +1059,7 @@ void MeshSarRxInit(void)
   uint8_t *pMemBuff;
   uint32_t reqMem;
   uint8_t tranIndex;
+  uint8_t slot;
 
   MESH_TRACE_INFO0("MESH SAR RX: Init");
 
@@ -954,6 +1081,23 @@ void MeshSarRxInit(void)
   /* Set Transaction Info table size */
   sarRxCb.tranInfoSize = pMeshConfig->pMemoryConfig->sarRxTranInfoSize;
 
+  /* Save the pointer for the segment slot pool. */
+  sarRxCb.pSegPool = (meshSarRxSegSlot_t *)meshCb.pMemBuff;
+  sarRxCb.segPoolSize = MESH_SAR_RX_SEG_POOL_SIZE;
+
+  /* Reserve memory for the segment slot pool. */
+  reqMem = meshSarRxSegPoolGetRequiredMemory(MESH_SAR_RX_SEG_POOL_SIZE);
+  meshCb.pMemBuff += reqMem;
+  meshCb.memBuffSize -= reqMem;
+
+  /* Link all segment slots in the free list. */
+  for (slot = 0; slot < sarRxCb.segPoolSize; slot++)
+  {
+    sarRxCb.pSegPool[slot].data[0] = (slot + 1 < sarRxCb.segPoolSize) ? slot + 2 : SAR_RX_SEG_SLOT_NONE;
+  }
+  sarRxCb.segFreeHead = (sarRxCb.segPoolSize > 0) ? 1 : SAR_RX_SEG_SLOT_NONE;
+  sarRxCb.segReserved = 0;
+
   /* Store empty callbacks into local structure. */
   sarRxCb.pduReassembledCback = meshSarRxEmptyPduReassembled;
   sarRxCb.lpnDstCheckCback = meshSarRxEmptyLpnDstCheckCback;
@@ -1039,8 +1183,9 @@ void MeshSarRxRegisterFriend(meshSarRxLpnDstCheckCback_t lpnDstCheckCback,
 void MeshSarRxProcessSegment(const meshNwkPduRxInfo_t *pNwkPduInfo)
 {
   uint16_t seqZero;
-  uint8_t segO, segN, tranIndex;
+  uint8_t segO, segN, segMaxLen, tranIndex;
   uint32_t blockAckMask;
+  meshSarRxSegInfoFriend_t *pFriendSegInfo;
   bool_t sendAck;
   bool_t obo;
 
@@ -1075,6 +1220,20 @@ void MeshSarRxProcessSegment(const meshNwkPduRxInfo_t *pNwkPduInfo)
     return;
   }
 
+  /* The segments are gathered at SegO times the maximum segment length, so every segment but the
+   * last one must be full and the last one must not be empty.
+   */
+  segMaxLen = (pNwkPduInfo->ctl == MESH_SAR_RX_TYPE_CTL) ? MESH_CTL_SEG_MAX_LENGTH :
+                                                           MESH_ACC_SEG_MAX_LENGTH;
+
+  if ((pNwkPduInfo->pduLen <= MESH_SEG_HEADER_LENGTH) ||
+      (pNwkPduInfo->pduLen > MESH_SEG_HEADER_LENGTH + segMaxLen) ||
+      ((segO < segN) && (pNwkPduInfo->pduLen != MESH_SEG_HEADER_LENGTH + segMaxLen)))
+  {
+    MESH_TRACE_WARN0("MESH SAR RX: Invalid segment length!");
+    return;
+  }
+
   /* Check SAR Rx Transaction Cache to see if we have an outdated segment. */
   if (!MeshSarRxHistoryCheck(pNwkPduInfo->src, pNwkPduInfo->seqNo, seqZero,
                              SAR_RX_IVI_LSB(pNwkPduInfo->ivIndex), segN, &sendAck, &obo))
@@ -1124,7 +1283,7 @@ void MeshSarRxProcessSegment(const meshNwkPduRxInfo_t *pNwkPduInfo)
          (sarRxCb.pTranInfoTable[tranIndex].seqZero < seqZero)))
     {
       meshSarRxResetTransaction(tranIndex,
-                                (sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL));
+                                sarRxCb.pTranInfoTable[tranIndex].toFriend);
     }
   }
 
@@ -1150,6 +1309,25 @@ void MeshSarRxProcessSegment(const meshNwkPduRxInfo_t *pNwkPduInfo)
 
     if (blockAckMask == SAR_RX_BLOCK_MASK(segN))
     {
+      /* Gather the segments into the contiguous PDU needed by the Upper Transport Layer. */
+      pFriendSegInfo = meshSarRxGather(tranIndex);
+
+      if (sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo == NULL)
+      {
+        MESH_TRACE_WARN0("MESH SAR RX: No memory to gather PDU!");
+
+        meshSarRxResetTransaction(tranIndex, sarRxCb.pTranInfoTable[tranIndex].toFriend);
+
+        /* If the message was unicast send an error ack message */
+        if (MESH_IS_ADDR_UNICAST(pNwkPduInfo->dst))
+        {
+          meshSarRxSendFastAck(pNwkPduInfo, 0,
+                               sarRxCb.lpnDstCheckCback(pNwkPduInfo->dst, pNwkPduInfo->netKeyIndex));
+        }
+
+        return;
+      }
+
       sarRxCb.pTranInfoTable[tranIndex].state = MESH_SAR_RX_TRAN_COMPLETE;
 
       /* If the message was unicast send an ack message */
@@ -1161,11 +1339,11 @@ void MeshSarRxProcessSegment(const meshNwkPduRxInfo_t *pNwkPduInfo)
       /* Received all blocks. Decide upon destination of reassembled PDU. */
 
       /* Check if Friend module requires this PDU. */
-      if(sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo != NULL)
+      if(pFriendSegInfo != NULL)
       {
         sarRxCb.friendPduReassembledCback(sarRxCb.pTranInfoTable[tranIndex].pduType,
                                           sarRxCb.pTranInfoTable[tranIndex].pLtrPduInfo,
-                                          sarRxCb.pTranInfoTable[tranIndex].pFriendSegInfo,
+                                          pFriendSegInfo,
                                           pNwkPduInfo->ivIndex,
                                           seqZero,
                                           sarRxCb.pTranInfoTable[tranIndex].segN);
@@ -1212,6 +1390,7 @@ uint32_t MeshSarRxGetRequiredMemory(void)
 
   /* Compute the required memory. */
   reqMem = meshSarRxTranInfoGetRequiredMemory(pMeshConfig->pMemoryConfig->sarRxTranInfoSize) +
+    meshSarRxSegPoolGetRequiredMemory(MESH_SAR_RX_SEG_POOL_SIZE) +
     MeshSarRxHistoryGetRequiredMemory();
 
   return reqMem;
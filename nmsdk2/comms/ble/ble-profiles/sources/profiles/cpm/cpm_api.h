@@ -0,0 +1,141 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Traffic driven connection parameter manager.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+#ifndef CPM_API_H
+#define CPM_API_H
+
+#include "wsf_timer.h"
+#include "dm_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup CONNECTION_PARAMETER_MANAGER
+ *  \{ */
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/** \name Connection Parameter Profiles
+ *
+ */
+/**@{*/
+#define CPM_PROFILE_DEFAULT       0     /*!< \brief Parameters chosen by the central */
+#define CPM_PROFILE_LOW_POWER     1     /*!< \brief Long interval with slave latency */
+#define CPM_PROFILE_THROUGHPUT    2     /*!< \brief Short interval */
+#define CPM_NUM_PROFILES          3     /*!< \brief Number of profiles */
+/**@}*/
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief Configurable parameters */
+typedef struct
+{
+  hciConnSpec_t       lowPower;         /*!< \brief Low power profile connection parameters */
+  hciConnSpec_t       throughput;       /*!< \brief Throughput profile connection parameters */
+  wsfTimerTicks_t     period;           /*!< \brief Traffic sample period in ms */
+  uint16_t            busyBytes;        /*!< \brief L2CAP bytes in a sample period that select the
+                                             throughput profile */
+  uint16_t            idleBytes;        /*!< \brief L2CAP bytes in a sample period at or below which
+                                             the period counts as idle */
+  uint8_t             idleSamples;      /*!< \brief Consecutive idle periods before the low power
+                                             profile is selected */
+} cpmCfg_t;
+
+/*! \brief Connection statistics */
+typedef struct
+{
+  uint32_t            timeMs[CPM_NUM_PROFILES]; /*!< \brief Time spent in each profile */
+  uint32_t            bytes;            /*!< \brief L2CAP bytes sent and received */
+  uint16_t            switches;         /*!< \brief Profile changes requested */
+  uint16_t            failures;         /*!< \brief Connection updates that failed */
+  uint16_t            connInterval;     /*!< \brief Current connection interval in 1.25 ms units */
+  uint16_t            connLatency;      /*!< \brief Current slave latency */
+  uint8_t             profile;          /*!< \brief Requested profile */
+  bool_t              hold;             /*!< \brief TRUE if held in the throughput profile */
+} cpmStats_t;
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the connection parameter manager.
+ *
+ *  \param  handlerId   WSF handler ID of the application.
+ *  \param  timerEvt    WSF event designated by the application for the sample timer.
+ *  \param  pCfg        Configuration parameters.  Must remain valid.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmInit(wsfHandlerId_t handlerId, uint8_t timerEvt, const cpmCfg_t *pCfg);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Process DM connection events and sample timer messages.  Call from the
+ *          application handler for DM_CONN_OPEN_IND, DM_CONN_CLOSE_IND, DM_CONN_UPDATE_IND
+ *          and the sample timer event.
+ *
+ *  \param  pMsg    Pointer to message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmProcMsg(wsfMsgHdr_t *pMsg);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Hold a connection in the throughput profile regardless of traffic, for transfers
+ *          the application knows about in advance.
+ *
+ *  \param  connId    DM connection ID.
+ *  \param  hold      TRUE to hold, FALSE to return to traffic driven selection.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmHold(dmConnId_t connId, bool_t hold);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of a connection.
+ *
+ *  \param  connId    DM connection ID.
+ *  \param  pStats    Returned statistics.
+ *
+ *  \return TRUE if the connection is managed, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t CpmGetStats(dmConnId_t connId, cpmStats_t *pStats);
+
+/*! \} */    /* CONNECTION_PARAMETER_MANAGER */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* CPM_API_H */
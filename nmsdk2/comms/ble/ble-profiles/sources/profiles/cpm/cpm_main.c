@@ -0,0 +1,342 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Traffic driven connection parameter manager.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  Every sample period the L2CAP bytes sent and received on each connection are compared with
+ *  two thresholds.  A busy period requests the throughput profile at once; the low power profile
+ *  is only requested after a run of idle periods, and periods between the two thresholds keep
+ *  the current profile, so a link does not flap between the two on bursty traffic.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_os.h"
+#include "wsf_trace.h"
+#include "wsf_timer.h"
+#include "dm_api.h"
+#include "l2c_api.h"
+#include "app_api.h"
+#include "cpm_api.h"
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/* Connection control block */
+typedef struct
+{
+  wsfTimer_t          timer;            /* Sample timer */
+  uint32_t            lastBytes;        /* L2CAP byte count at the previous sample */
+  cpmStats_t          stats;            /* Statistics */
+  uint8_t             idle;             /* Consecutive idle samples */
+  bool_t              inUse;            /* TRUE if the connection is managed */
+} cpmCcb_t;
+
+/* Main control block */
+typedef struct
+{
+  cpmCcb_t            ccb[DM_CONN_MAX]; /* Connection control blocks */
+  const cpmCfg_t      *pCfg;            /* Configuration */
+  wsfHandlerId_t      handlerId;        /* Application handler ID */
+  uint8_t             timerEvt;         /* Sample timer event */
+} cpmCb_t;
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/* Control block */
+static cpmCb_t cpmCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the total L2CAP bytes sent and received on a connection.
+ *
+ *  \param  connId    DM connection ID.
+ *
+ *  \return Byte count.
+ */
+/*************************************************************************************************/
+static uint32_t cpmTraffic(dmConnId_t connId)
+{
+  uint32_t tx, rx;
+
+  L2cGetTraffic(connId, &tx, &rx);
+
+  return tx + rx;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Request the connection parameters of a profile.
+ *
+ *  \param  connId    DM connection ID.
+ *  \param  pCcb      Connection control block.
+ *  \param  profile   CPM_PROFILE_LOW_POWER or CPM_PROFILE_THROUGHPUT.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void cpmRequest(dmConnId_t connId, cpmCcb_t *pCcb, uint8_t profile)
+{
+  const hciConnSpec_t *pSpec;
+
+  if (pCcb->stats.profile == profile)
+  {
+    return;
+  }
+
+  pSpec = (profile == CPM_PROFILE_THROUGHPUT) ? &cpmCb.pCfg->throughput : &cpmCb.pCfg->lowPower;
+
+  WsfTaskLock();
+  pCcb->stats.profile = profile;
+  pCcb->stats.switches++;
+  WsfTaskUnlock();
+
+  APP_TRACE_INFO3("CPM: connId=%d profile=%d interval=%d", connId, profile, pSpec->connIntervalMax);
+
+  DmConnUpdate(connId, (hciConnSpec_t *) pSpec);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Sample the traffic of a connection and select a profile.
+ *
+ *  \param  connId    DM connection ID.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void cpmSample(dmConnId_t connId)
+{
+  cpmCcb_t  *pCcb = &cpmCb.ccb[connId - 1];
+  uint32_t  total = cpmTraffic(connId);
+  uint32_t  bytes = total - pCcb->lastBytes;
+
+  pCcb->lastBytes = total;
+
+  WsfTaskLock();
+  pCcb->stats.timeMs[pCcb->stats.profile] += cpmCb.pCfg->period;
+  pCcb->stats.bytes += bytes;
+  WsfTaskUnlock();
+
+  if (pCcb->stats.hold || (bytes >= cpmCb.pCfg->busyBytes))
+  {
+    pCcb->idle = 0;
+    cpmRequest(connId, pCcb, CPM_PROFILE_THROUGHPUT);
+  }
+  else if (bytes <= cpmCb.pCfg->idleBytes)
+  {
+    if (pCcb->idle < cpmCb.pCfg->idleSamples)
+    {
+      pCcb->idle++;
+    }
+
+    if (pCcb->idle >= cpmCb.pCfg->idleSamples)
+    {
+      cpmRequest(connId, pCcb, CPM_PROFILE_LOW_POWER);
+    }
+  }
+  else
+  {
+    pCcb->idle = 0;
+  }
+
+  WsfTimerStartMs(&pCcb->timer, cpmCb.pCfg->period);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the connection parameter manager.
+ *
+ *  \param  handlerId   WSF handler ID of the application.
+ *  \param  timerEvt    WSF event designated by the application for the sample timer.
+ *  \param  pCfg        Configuration parameters.  Must remain valid.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmInit(wsfHandlerId_t handlerId, uint8_t timerEvt, const cpmCfg_t *pCfg)
+{
+  uint8_t i;
+
+  WSF_ASSERT(pCfg->busyBytes > pCfg->idleBytes);
+
+  memset(&cpmCb, 0, sizeof(cpmCb));
+  cpmCb.handlerId = handlerId;
+  cpmCb.timerEvt = timerEvt;
+  cpmCb.pCfg = pCfg;
+
+  for (i = 0; i < DM_CONN_MAX; i++)
+  {
+    cpmCb.ccb[i].timer.handlerId = handlerId;
+    cpmCb.ccb[i].timer.msg.event = timerEvt;
+    cpmCb.ccb[i].timer.msg.param = i + 1;  /* param stores the conn id */
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Process DM connection events and sample timer messages.
+ *
+ *  \param  pMsg    Pointer to message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmProcMsg(wsfMsgHdr_t *pMsg)
+{
+  dmEvt_t   *pDmEvt = (dmEvt_t *) pMsg;
+  dmConnId_t connId = (dmConnId_t) pMsg->param;
+  cpmCcb_t  *pCcb;
+
+  if ((cpmCb.pCfg == NULL) || (connId == DM_CONN_ID_NONE) || (connId > DM_CONN_MAX))
+  {
+    return;
+  }
+
+  pCcb = &cpmCb.ccb[connId - 1];
+
+  if (pMsg->event == cpmCb.timerEvt)
+  {
+    if (pCcb->inUse)
+    {
+      cpmSample(connId);
+    }
+    return;
+  }
+
+  switch (pMsg->event)
+  {
+    case DM_CONN_OPEN_IND:
+      WsfTaskLock();
+      memset(&pCcb->stats, 0, sizeof(cpmStats_t));
+      pCcb->stats.connInterval = pDmEvt->connOpen.connInterval;
+      pCcb->stats.connLatency = pDmEvt->connOpen.connLatency;
+      pCcb->inUse = TRUE;
+      WsfTaskUnlock();
+
+      pCcb->idle = 0;
+      pCcb->lastBytes = cpmTraffic(connId);
+      WsfTimerStartMs(&pCcb->timer, cpmCb.pCfg->period);
+      break;
+
+    case DM_CONN_CLOSE_IND:
+      WsfTimerStop(&pCcb->timer);
+
+      WsfTaskLock();
+      pCcb->inUse = FALSE;
+      WsfTaskUnlock();
+      break;
+
+    case DM_CONN_UPDATE_IND:
+      if (!pCcb->inUse)
+      {
+        break;
+      }
+
+      WsfTaskLock();
+      if (pMsg->status == HCI_SUCCESS)
+      {
+        pCcb->stats.connInterval = pDmEvt->connUpdate.connInterval;
+        pCcb->stats.connLatency = pDmEvt->connUpdate.connLatency;
+      }
+      else
+      {
+        /* let the next sample ask again */
+        pCcb->stats.failures++;
+        pCcb->stats.profile = CPM_PROFILE_DEFAULT;
+      }
+      WsfTaskUnlock();
+
+      /* radio wakeups per 10 s and worst case latency in ms of the parameters in use */
+      APP_TRACE_INFO3("CPM: connId=%d wakeups/10s=%d latency ms=%d", connId,
+                      8000 / (pCcb->stats.connInterval * (pCcb->stats.connLatency + 1)),
+                      (pCcb->stats.connInterval * (pCcb->stats.connLatency + 1) * 5) / 4);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Hold a connection in the throughput profile regardless of traffic.
+ *
+ *  \param  connId    DM connection ID.
+ *  \param  hold      TRUE to hold, FALSE to return to traffic driven selection.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void CpmHold(dmConnId_t connId, bool_t hold)
+{
+  cpmCcb_t *pCcb;
+
+  if ((cpmCb.pCfg == NULL) || (connId == DM_CONN_ID_NONE) || (connId > DM_CONN_MAX))
+  {
+    return;
+  }
+
+  pCcb = &cpmCb.ccb[connId - 1];
+  if (!pCcb->inUse)
+  {
+    return;
+  }
+
+  WsfTaskLock();
+  pCcb->stats.hold = hold;
+  WsfTaskUnlock();
+
+  if (hold)
+  {
+    pCcb->idle = 0;
+    cpmRequest(connId, pCcb, CPM_PROFILE_THROUGHPUT);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the statistics of a connection.
+ *
+ *  \param  connId    DM connection ID.
+ *  \param  pStats    Returned statistics.
+ *
+ *  \return TRUE if the connection is managed, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t CpmGetStats(dmConnId_t connId, cpmStats_t *pStats)
+{
+  bool_t inUse;
+
+  if ((connId == DM_CONN_ID_NONE) || (connId > DM_CONN_MAX))
+  {
+    return FALSE;
+  }
+
+  WsfTaskLock();
+  inUse = cpmCb.ccb[connId - 1].inUse;
+  memcpy(pStats, &cpmCb.ccb[connId - 1].stats, sizeof(cpmStats_t));
+  WsfTaskUnlock();
+
+  return inUse;
+}
@@ -178,6 +178,9 @@ void WdxcFtcSendGetReq(dmConnId_t connId, uint16_t fileHdl, uint32_t offset, uin
 
   handle = wdxcCb.conn[connId - 1].pHdlList[WDXC_FTC_HDL_IDX];
 
+  /* file transfer data is passed to the application against the file being read */
+  wdxcCb.conn[connId - 1].fileHdl = fileHdl;
+
   UINT8_TO_BSTREAM(p, WDX_FTC_OP_GET_REQ);
   UINT16_TO_BSTREAM(p, fileHdl);
 
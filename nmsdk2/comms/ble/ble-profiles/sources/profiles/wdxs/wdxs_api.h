@@ -47,6 +47,32 @@ extern "C" {
 #define WDXS_DEVICE_MODEL               "WDXS App"
 #endif
 
+/** \name File Transfer Session Events
+ *
+ */
+/**@{*/
+#define WDXS_FT_EVT_START               0   /*!< \brief File get or put accepted */
+#define WDXS_FT_EVT_END                 1   /*!< \brief File get or put completed, aborted or lost */
+/**@}*/
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  File transfer session callback.
+ *
+ *  \param  connId  Connection identifier.
+ *  \param  event   \ref WDXS_FT_EVT_START or \ref WDXS_FT_EVT_END.
+ *  \param  op      \ref WDX_FTC_OP_GET_REQ or \ref WDX_FTC_OP_PUT_REQ.
+ *  \param  len     Requested length on start, number of bytes transferred on end.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+typedef void (*wdxsFtCback_t)(dmConnId_t connId, uint8_t event, uint8_t op, uint32_t len);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Called at startup to configure WDXS authentication.
@@ -154,6 +180,19 @@ void WdxsResetSystem(void);
 /*************************************************************************************************/
 void WdxsPhyInit(void);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Register a callback for the start and end of file transfer sessions.  The
+ *          application can use it to switch the connection to a high throughput
+ *          configuration for the duration of a transfer.
+ *
+ *  \param  cback  Callback function or NULL to disable.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WdxsFtRegister(wdxsFtCback_t cback);
+
 /*! \} */    /* WIRELESS_DATA_EXCHANGE_PROFILE */
 
 #ifdef __cplusplus
@@ -62,6 +62,57 @@ static bool_t wdxsFileRead(uint16_t handle, uint32_t offset, uint32_t *pReadLen,
   return eof;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \brief  Notify the application of the start of a file transfer operation.
+ *
+ *  \param  connId    Connection identifier.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wdxsFtStart(dmConnId_t connId)
+{
+  wdxsCb.ftXferLen = wdxsCb.ftLen;
+
+  if (wdxsCb.ftCback != NULL)
+  {
+    (*wdxsCb.ftCback)(connId, WDXS_FT_EVT_START, wdxsCb.ftInProgress, wdxsCb.ftLen);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  End the file transfer operation in progress, if any, and notify the application.
+ *
+ *  \param  connId    Connection identifier.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void wdxsFtEnd(dmConnId_t connId)
+{
+  uint8_t op = wdxsCb.ftInProgress;
+
+  if (op == WDX_FTC_OP_NONE)
+  {
+    return;
+  }
+
+  wdxsCb.ftInProgress = WDX_FTC_OP_NONE;
+
+  if (wdxsCb.ftCback != NULL)
+  {
+    /* an aborted stream is still flagged as a get until its EOF goes out */
+    if (op == WDX_FTC_OP_ABORT)
+    {
+      op = WDX_FTC_OP_GET_REQ;
+    }
+
+    (*wdxsCb.ftCback)(connId, WDXS_FT_EVT_END, op, wdxsCb.ftXferLen - wdxsCb.ftLen);
+  }
+}
+
 /*************************************************************************************************/
 /*!
  *  \brief  Prepare for FTD data.
@@ -83,9 +134,9 @@ static uint8_t wdxsInitializeForPut(dmConnId_t connId, uint16_t handle)
   }
 
   /* Erase on offset of zero */
-  if (wdxsCb.ftOffset == 0)
+  if ((wdxsCb.ftOffset == 0) && (WsfEfsErase(handle) != WSF_EFS_SUCCESS))
   {
-    WsfEfsErase(handle);
+    return WDX_FTC_ST_IN_PROGRESS;
   }
 
   /* set up file put operation */
@@ -200,6 +251,8 @@ static void wdxsFtcProcGetReq(dmConnId_t connId, uint16_t handle, uint16_t len,
     WsfSetEvent(wdxsCb.handlerId, WDXS_EVT_TX_PATH);
 
     status = WDX_FTC_ST_SUCCESS;
+
+    wdxsFtStart(connId);
   }
 
   /* send response */
@@ -240,6 +293,11 @@ static void wdxsFtcProcPutReq(dmConnId_t connId, uint16_t handle, uint16_t len,
 
     /* Initialize transfer*/
     status = wdxsInitializeForPut(connId, handle);
+
+    if (status == WDX_FTC_ST_SUCCESS)
+    {
+      wdxsFtStart(connId);
+    }
   }
 
   APP_TRACE_INFO2("WDXS: FTC PutReq handle=%d status=%d", handle, status);
@@ -305,8 +363,11 @@ static void wdxsFtcProcEraseReq(dmConnId_t connId, uint16_t handle)
   }
   else
   {
-    /* do file erase */
-    WsfEfsErase(handle);
+    /* do file erase, the media may still be busy with a previous transfer */
+    if (WsfEfsErase(handle) != WSF_EFS_SUCCESS)
+    {
+      status = WDX_FTC_ST_IN_PROGRESS;
+    }
   }
 
   /* send response */
@@ -333,7 +394,7 @@ static void wdxsFtcProcAbort(dmConnId_t connId, uint16_t handle)
     }
     else
     {
-      wdxsCb.ftInProgress = WDX_FTC_OP_NONE;
+      wdxsFtEnd(connId);
     }
 
     wdxsCb.ftLen = 0;
@@ -365,7 +426,16 @@ uint8_t wdxsFtdWrite(dmConnId_t connId, uint16_t len, uint8_t *pValue)
   /* verify more data is expected */
   if (wdxsCb.ftLen >= len)
   {
-    WsfEfsPut(wdxsCb.ftHandle, wdxsCb.ftOffset, pValue, len);
+    /* a media that cannot keep up fails the put, abort it and tell the client */
+    if (WsfEfsPut(wdxsCb.ftHandle, wdxsCb.ftOffset, pValue, len) != len)
+    {
+      wdxsFtEnd(connId);
+      wdxsCb.ftLen = 0;
+      wdxsCb.ftOffset = 0;
+      wdxsFtcSendRsp(connId, WDX_FTC_OP_ABORT, wdxsCb.ftHandle, 0);
+
+      return ATT_ERR_UNLIKELY;
+    }
 
     /* update remaining length of put request */
     wdxsCb.ftOffset += len;
@@ -381,7 +451,7 @@ uint8_t wdxsFtdWrite(dmConnId_t connId, uint16_t len, uint8_t *pValue)
       }
 
       /* put req done */
-      wdxsCb.ftInProgress = WDX_FTC_OP_NONE;
+      wdxsFtEnd(connId);
 
       /* send eof */
       wdxsFtcSendRsp(connId, WDX_FTC_OP_EOF, wdxsCb.ftHandle, 0);
@@ -505,7 +575,7 @@ void wdxsFtdSend(dmConnId_t connId)
     /* check if end of transfer reached */
     if (wdxsCb.ftLen == 0 || readLen == 0 || eof || wdxsCb.ftInProgress == WDX_FTC_OP_ABORT)
     {
-      wdxsCb.ftInProgress = WDX_FTC_OP_NONE;
+      wdxsFtEnd(connId);
       wdxsCb.txReadyMask &= ~(WDXS_TX_MASK_FTD_BIT);
     }
 
@@ -516,3 +586,17 @@ void wdxsFtdSend(dmConnId_t connId)
     }
   }
 }
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register a callback for the start and end of file transfer sessions.
+ *
+ *  \param  cback  Callback function or NULL to disable.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WdxsFtRegister(wdxsFtCback_t cback)
+{
+  wdxsCb.ftCback = cback;
+}
@@ -49,8 +49,8 @@ wdxsCb_t wdxsCb;
   Macros
 **************************************************************************************************/
 
-/*! RAM File Media Configuration */
-#define WDXS_RAM_LOCATION         ((uint32_t)WdxsRamBlock)
+/*! RAM File Media Configuration; media addresses are offsets into WdxsRamBlock */
+#define WDXS_RAM_LOCATION         0
 #define WDXS_RAM_SIZE             (WDX_FLIST_MAX_LEN + WDXS_APP_RAM_MEDIA_SIZE)
 #define WDXS_RAM_END              (WDXS_RAM_LOCATION + WDXS_RAM_SIZE)
 
@@ -90,45 +90,45 @@ static const wsfEfsMedia_t WDXS_RamMediaCtrl =
 /*!
  *  \brief  Erase function for the EFS RAM media.
  *
- *  \return none.
+ *  \return WSF_EFS_SUCCESS.
  *
  */
 /*************************************************************************************************/
 static uint8_t WdxsRamErase(uint32_t address, uint32_t size)
 {
-  uint8_t *pMem = (uint8_t *) address;
+  uint8_t *pMem = &WdxsRamBlock[address];
   memset(pMem, 0xFF, size);
-  return TRUE;
+  return WSF_EFS_SUCCESS;
 }
 
 /*************************************************************************************************/
 /*!
  *  \brief  Read function for the EFS RAM media.
  *
- *  \return none.
+ *  \return WSF_EFS_SUCCESS.
  *
  */
 /*************************************************************************************************/
 static uint8_t WdxsRamRead(uint8_t *pBuf, uint32_t address, uint32_t size)
 {
-  uint8_t *pMem = (uint8_t *) address;
+  uint8_t *pMem = &WdxsRamBlock[address];
   memcpy(pBuf, pMem, size);
-  return TRUE;
+  return WSF_EFS_SUCCESS;
 }
 
 /*************************************************************************************************/
 /*!
  *  \brief  Write function for the EFS RAM media.
  *
- *  \return none.
+ *  \return WSF_EFS_SUCCESS.
  *
  */
 /*************************************************************************************************/
 static uint8_t WdxsRamWrite(const uint8_t *pBuf, uint32_t address, uint32_t size)
 {
-  uint8_t *pMem = (uint8_t *) address;
+  uint8_t *pMem = &WdxsRamBlock[address];
   memcpy(pMem, pBuf, size);
-  return TRUE;
+  return WSF_EFS_SUCCESS;
 }
 
 /*************************************************************************************************/
@@ -371,6 +371,9 @@ void WdxsProcDmMsg(dmEvt_t *pEvt)
   switch (pEvt->hdr.event)
   {
     case DM_CONN_CLOSE_IND:
+      /* report a transfer cut short by the disconnect */
+      wdxsFtEnd((dmConnId_t) pEvt->hdr.param);
+
       if (wdxsDcCb.doReset)
       {
         WdxsResetSystem();
@@ -502,9 +505,11 @@ void WdxsHandlerInit(wsfHandlerId_t handlerId)
  *  \param  None
  *
  *  \return None.
+ *
+ *  \note   Empty by default; the application provides the OTA media.
  */
 /*************************************************************************************************/
-void WdxsOtaMediaInit(void)
+__attribute__((weak)) void WdxsOtaMediaInit(void)
 {
 }
 
@@ -122,6 +122,8 @@ typedef struct
   uint8_t           ftcMsgBuf[ATT_DEFAULT_PAYLOAD_LEN]; /*!< \brief message buffer */
   uint8_t           ftInProgress;     /*!< \brief operation in progress */
   uint8_t           ftPrefXferType;   /*!< \brief Preferred transport type */
+  uint32_t          ftXferLen;        /*!< \brief requested length of current operation */
+  wdxsFtCback_t     ftCback;          /*!< \brief file transfer session callback */
 
   /* ccc index */
   uint8_t          dcCccIdx;          /*!< \brief device configuration ccc index */
@@ -211,6 +213,17 @@ void wdxsFtcSend(dmConnId_t connId);
 /*************************************************************************************************/
 void wdxsFtdSend(dmConnId_t connId);
 
+/*************************************************************************************************/
+/*!
+ *  \brief  End the file transfer operation in progress, if any, and notify the application.
+ *
+ *  \param  connId    Connection identifier.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void wdxsFtEnd(dmConnId_t connId);
+
 /*************************************************************************************************/
 /*!
  *  \brief  Transmit to authentication characteristic.
@@ -43,6 +43,11 @@ void srand1( uint32_t seed )
 {
     next = seed;
 }
+
+uint32_t rand1_state( void )
+{
+    return next;
+}
 // Standard random functions redefinition end
 
 int32_t randr( int32_t min, int32_t max )
@@ -91,6 +91,13 @@ typedef union Version_u
  */
 void srand1( uint32_t seed );
 
+/*!
+ * \brief Returns the pseudo random generator state, which srand1 restores
+ *
+ * \retval state Pseudo random generator state
+ */
+uint32_t rand1_state( void );
+
 /*!
  * \brief Computes a random number between min and max
  *
@@ -314,6 +314,12 @@ typedef union uLoRaMacRadioEvents
  */
 LoRaMacRadioEvents_t LoRaMacRadioEvents = { .Value = 0 };
 
+/*!
+ * Class A receive window timing statistics. Kept outside of the MAC context
+ * so that they survive a MAC re-initialization.
+ */
+static LoRaMacRxWindowStats_t RxWindowStats;
+
 /*!
  * \brief Function to be executed on Radio Tx Done event
  */
@@ -826,15 +832,22 @@ static void ProcessRadioTxDone( void )
     GetPhyParams_t getPhy;
     PhyParam_t phyParam;
     SetBandTxDoneParams_t txDone;
+    TimerTime_t txLatency;
 
     if( Nvm.MacGroup2.DeviceClass != CLASS_C )
     {
         Radio.Sleep( );
     }
-    // Setup timers
-    TimerSetValue( &MacCtx.RxWindowTimer1, MacCtx.RxWindow1Delay );
+    // Setup timers.
+    // The radio interrupt is serviced from the MAC process, which may run
+    // well after the transmission ended. Count the receive delays from the
+    // time of the TX done interrupt so that this latency does not push the
+    // windows late.
+    txLatency = TimerGetElapsedTime( TxDoneParams.CurTime );
+
+    TimerSetValue( &MacCtx.RxWindowTimer1, ( MacCtx.RxWindow1Delay > txLatency ) ? ( MacCtx.RxWindow1Delay - txLatency ) : 0 );
     TimerStart( &MacCtx.RxWindowTimer1 );
-    TimerSetValue( &MacCtx.RxWindowTimer2, MacCtx.RxWindow2Delay );
+    TimerSetValue( &MacCtx.RxWindowTimer2, ( MacCtx.RxWindow2Delay > txLatency ) ? ( MacCtx.RxWindow2Delay - txLatency ) : 0 );
     TimerStart( &MacCtx.RxWindowTimer2 );
 
     if( MacCtx.NodeAckRequested == true )
@@ -3139,8 +3152,24 @@ static bool IsReJoin0Required( )
  */
 static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig )
 {
+    TimerTime_t delay = ( rxConfig->RxSlot == RX_SLOT_WIN_1 ) ? MacCtx.RxWindow1Delay : MacCtx.RxWindow2Delay;
+    TimerTime_t late = TimerGetElapsedTime( TxDoneParams.CurTime );
+
     TimerStop( rxTimer );
 
+    // Anything later than the receive error the window was widened for
+    // misses the start of the downlink preamble
+    late = ( late > delay ) ? ( late - delay ) : 0;
+    RxWindowStats.Opened++;
+    if( late > Nvm.MacGroup2.MacParams.SystemMaxRxError )
+    {
+        RxWindowStats.Missed++;
+    }
+    if( late > RxWindowStats.MaxLate )
+    {
+        RxWindowStats.MaxLate = late;
+    }
+
     // Ensure the radio is Idle
     Radio.Standby( );
 
@@ -3895,6 +3924,117 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     }
 }
 
+LoRaMacStatus_t LoRaMacQueryNextTxDelay( uint8_t size, TimerTime_t* delay )
+{
+    // Channel selection state that RegionNextChannel modifies. Static to keep
+    // it off the stack of the caller.
+    static Band_t bands[REGION_NVM_MAX_NB_BANDS];
+    static RegionNvmDataGroup1_t regionGroup1;
+    static uint16_t channelsMask[REGION_NVM_CHANNELS_MASK_SIZE];
+    NextChanParams_t nextChan;
+    TimerTime_t aggregatedTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
+    uint8_t channel = 0;
+    size_t macCmdsSize = 0;
+    uint32_t randState;
+    LoRaMacStatus_t status;
+
+    if( delay == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    *delay = 0;
+
+    if( LoRaMacCommandsGetSizeSerializedCmds( &macCmdsSize ) != LORAMAC_COMMANDS_SUCCESS )
+    {
+        return LORAMAC_STATUS_MAC_COMMAD_ERROR;
+    }
+
+    nextChan.AggrTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
+    nextChan.Datarate = Nvm.MacGroup1.ChannelsDatarate;
+    nextChan.DutyCycleEnabled = Nvm.MacGroup2.DutyCycleOn;
+    nextChan.ElapsedTimeSinceStartUp = SysTimeSub( SysTimeGetMcuTime( ), Nvm.MacGroup2.InitializationTime );
+    nextChan.LastAggrTx = Nvm.MacGroup1.LastTxDoneTime;
+    nextChan.LastTxIsJoinRequest = false;
+    nextChan.Joined = true;
+    nextChan.PktLen = LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE + macCmdsSize + size;
+
+    if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
+    {
+        nextChan.LastTxIsJoinRequest = true;
+        nextChan.Joined = false;
+    }
+
+    // RegionNextChannel refreshes the band time credits and ready flags, may
+    // re-enable the default channels or refill the remaining channels mask,
+    // and draws a random channel. Snapshot that state and put it back so the
+    // query leaves the next real channel selection unchanged. Channel and
+    // aggregated time-off results are discarded.
+    memcpy1( ( uint8_t* )bands, ( uint8_t* )RegionBands, sizeof( bands ) );
+    memcpy1( ( uint8_t* )&regionGroup1, ( uint8_t* )&Nvm.RegionGroup1, sizeof( regionGroup1 ) );
+    memcpy1( ( uint8_t* )channelsMask, ( uint8_t* )Nvm.RegionGroup2.ChannelsMask, sizeof( channelsMask ) );
+    randState = rand1_state( );
+
+    status = RegionNextChannel( Nvm.MacGroup2.Region, &nextChan, &channel, delay, &aggregatedTimeOff );
+
+    memcpy1( ( uint8_t* )RegionBands, ( uint8_t* )bands, sizeof( bands ) );
+    memcpy1( ( uint8_t* )&Nvm.RegionGroup1, ( uint8_t* )&regionGroup1, sizeof( regionGroup1 ) );
+    memcpy1( ( uint8_t* )Nvm.RegionGroup2.ChannelsMask, ( uint8_t* )channelsMask, sizeof( channelsMask ) );
+    srand1( randState );
+
+    if( status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+    {
+        return LORAMAC_STATUS_OK;
+    }
+    return status;
+}
+
+LoRaMacStatus_t LoRaMacQueryNextRadioEvent( TimerTime_t* delay )
+{
+    TimerTime_t next;
+
+    if( delay == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    // A radio operation in progress or an event waiting for the MAC process
+    // is due now. Continuous class C reception is not a deadline.
+    if( ( LoRaMacRadioEvents.Value != 0 ) ||
+        ( ( Radio.GetStatus( ) != RF_IDLE ) && ( MacCtx.RxSlot != RX_SLOT_WIN_CLASS_C ) ) )
+    {
+        *delay = 0;
+        return LORAMAC_STATUS_OK;
+    }
+
+    *delay = TimerGetRemainingTime( &MacCtx.TxDelayedTimer );
+
+    next = TimerGetRemainingTime( &MacCtx.RxWindowTimer1 );
+    if( next < *delay )
+    {
+        *delay = next;
+    }
+
+    next = TimerGetRemainingTime( &MacCtx.RxWindowTimer2 );
+    if( next < *delay )
+    {
+        *delay = next;
+    }
+
+    return LORAMAC_STATUS_OK;
+}
+
+void LoRaMacGetRxWindowStats( LoRaMacRxWindowStats_t* stats )
+{
+    if( stats == NULL )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    *stats = RxWindowStats;
+    CRITICAL_SECTION_END( );
+}
+
 LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_OK;
@@ -2339,6 +2339,25 @@ typedef struct sLoRaMacTxInfo
     uint8_t CurrentPossiblePayloadSize;
 }LoRaMacTxInfo_t;
 
+/*!
+ * LoRaMAC class A receive window timing statistics
+ */
+typedef struct sLoRaMacRxWindowStats
+{
+    /*!
+     * Number of RX1 and RX2 windows opened
+     */
+    uint32_t Opened;
+    /*!
+     * Number of windows opened later than the system maximum rx error
+     */
+    uint32_t Missed;
+    /*!
+     * Worst lateness of a window in ms
+     */
+    TimerTime_t MaxLate;
+}LoRaMacRxWindowStats_t;
+
 /*!
  * LoRaMAC Status
  */
@@ -2611,6 +2630,54 @@ void LoRaMacProcess( void );
  */
 LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo );
 
+/*!
+ * \brief   Queries the time until the next uplink of the given size is allowed
+ *
+ * \details Evaluates the aggregated duty cycle and the band time credits of
+ *          the active region for a frame carrying the given application
+ *          payload at the current datarate, including the time-on-air it
+ *          would consume. The channel selection runs on the live band,
+ *          channels mask and random generator state, which are restored
+ *          before returning, so the MAC state is left as it was.
+ *
+ * \param   [IN] size - Size of application data payload to be send next
+ *
+ * \param   [OUT] delay - Time in ms to wait before the frame can be sent.
+ *                        Zero when the frame can be sent immediately.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_MAC_COMMAD_ERROR,
+ *          \ref LORAMAC_STATUS_NO_CHANNEL_FOUND.
+ */
+LoRaMacStatus_t LoRaMacQueryNextTxDelay( uint8_t size, TimerTime_t* delay );
+
+/*!
+ * \brief   Queries the time until the next radio operation of the MAC
+ *
+ * \details Covers the delayed transmission and the class A receive window
+ *          timers. An operation in progress, or a radio event that the MAC
+ *          process has not handled yet, is reported as due now. Continuous
+ *          class C reception is not reported. The MAC state is not modified.
+ *
+ * \param   [OUT] delay - Time in ms before the next radio operation, 0 when
+ *                        one is due now and TIMERTIME_T_MAX when none is
+ *                        scheduled.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacQueryNextRadioEvent( TimerTime_t* delay );
+
+/*!
+ * \brief   Returns the class A receive window timing statistics
+ *
+ * \param   [OUT] stats - Windows opened, missed and the worst lateness.
+ */
+void LoRaMacGetRxWindowStats( LoRaMacRxWindowStats_t* stats );
+
 /*!
  * \brief   LoRaMAC channel add service
  *
@@ -42,137 +42,210 @@
     }while( 0 );
 
 /*!
- * Timers list head pointer
- */
-static TimerEvent_t *TimerListHead = NULL;
-
-/*!
- * \brief Adds or replace the head timer of the list.
+ * The running timers form a pairing heap ordered by expiry time.  Each timer
+ * links to its first child and next sibling; Prev points to the parent of a
+ * first child and to the previous sibling of the others.  The root is the
+ * next timer to expire.
  *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
- *
- * \param [IN]  obj Timer object to be become the new head
- * \param [IN]  remainingTime Remaining time of the previous head to be replaced
+ * Expiry times are absolute RTC ticks.  They are ordered by their distance
+ * from TimerHeapBase, which never passes a running timer, so the order holds
+ * across the wrap around of the RTC counter.
  */
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj );
+static TimerEvent_t *TimerHeapRoot = NULL;
 
 /*!
- * \brief Adds a timer to the list.
- *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
- *
- * \param [IN]  obj Timer object to be added to the list
- * \param [IN]  remainingTime Remaining time of the running head after which the object may be added
+ * Time reference of the running timers, in RTC ticks
  */
-static void TimerInsertTimer( TimerEvent_t *obj );
+static uint32_t TimerHeapBase = 0;
 
 /*!
- * \brief Sets a timeout with the duration "timestamp"
+ * \brief Sets a timeout at the expiry time of the object
  *
- * \param [IN] timestamp Delay duration
+ * \param [IN] obj Timer object to be the next to expire
  */
 static void TimerSetTimeout( TimerEvent_t *obj );
 
 /*!
- * \brief Check if the Object to be added is not already in the list
+ * \brief Check if the Object to be added is not already in the heap
  *
- * \param [IN] timestamp Delay duration
- * \retval true (the object is already in the list) or false
+ * \param [IN] obj Timer object
+ * \retval true (the object is already in the heap) or false
  */
 static bool TimerExists( TimerEvent_t *obj );
 
-void TimerInit( TimerEvent_t *obj, void ( *callback )( void *context ) )
-{
-    obj->Timestamp = 0;
-    obj->ReloadValue = 0;
-    obj->IsStarted = false;
-    obj->IsNext2Expire = false;
-    obj->Callback = callback;
-    obj->Context = NULL;
-    obj->Next = NULL;
-}
-
-void TimerSetContext( TimerEvent_t *obj, void* context )
+/*!
+ * \brief Time of the object relative to the heap reference
+ */
+static uint32_t TimerHeapKey( TimerEvent_t *obj )
 {
-    obj->Context = context;
+    return obj->Timestamp - TimerHeapBase; // intentional wrap around
 }
 
-void TimerStart( TimerEvent_t *obj )
+/*!
+ * \brief Merges two heaps and returns the root of the result
+ *
+ * \param [IN] a Root of a heap without siblings
+ * \param [IN] b Root of a heap without siblings
+ */
+static TimerEvent_t *TimerHeapMeld( TimerEvent_t *a, TimerEvent_t *b )
 {
-    uint32_t elapsedTime = 0;
+    TimerEvent_t *tmp;
 
-    CRITICAL_SECTION_BEGIN( );
-
-    if( ( obj == NULL ) || ( TimerExists( obj ) == true ) )
+    if( a == NULL )
     {
-        CRITICAL_SECTION_END( );
-        return;
+        return b;
+    }
+    if( b == NULL )
+    {
+        return a;
     }
 
-    obj->Timestamp = obj->ReloadValue;
-    obj->IsStarted = true;
-    obj->IsNext2Expire = false;
+    if( TimerHeapKey( b ) < TimerHeapKey( a ) )
+    {
+        tmp = a;
+        a = b;
+        b = tmp;
+    }
 
-    if( TimerListHead == NULL )
+    // b becomes the first child of a
+    b->Prev = a;
+    b->Sibling = a->Child;
+    if( a->Child != NULL )
     {
-        RtcSetTimerContext( );
-        // Inserts a timer at time now + obj->Timestamp
-        TimerInsertNewHeadTimer( obj );
+        a->Child->Prev = b;
     }
-    else
+    a->Child = b;
+
+    return a;
+}
+
+/*!
+ * \brief Merges a list of siblings into one heap, in pairs from the left
+ *        then from the right to the left
+ *
+ * \param [IN] first First heap of the list
+ */
+static TimerEvent_t *TimerHeapMergePairs( TimerEvent_t *first )
+{
+    TimerEvent_t *pairs = NULL;
+    TimerEvent_t *root = NULL;
+    TimerEvent_t *a;
+    TimerEvent_t *b;
+
+    // First pass: meld the siblings in pairs, stacking the results on pairs
+    while( first != NULL )
     {
-        elapsedTime = RtcGetTimerElapsedTime( );
-        obj->Timestamp += elapsedTime;
+        a = first;
+        b = a->Sibling;
+        first = ( b != NULL ) ? b->Sibling : NULL;
 
-        if( obj->Timestamp < TimerListHead->Timestamp )
-        {
-            TimerInsertNewHeadTimer( obj );
-        }
-        else
+        a->Prev = NULL;
+        a->Sibling = NULL;
+        if( b != NULL )
         {
-            TimerInsertTimer( obj );
+            b->Prev = NULL;
+            b->Sibling = NULL;
         }
+
+        a = TimerHeapMeld( a, b );
+        a->Sibling = pairs;
+        pairs = a;
     }
-    CRITICAL_SECTION_END( );
+
+    // Second pass: meld the pairs into one heap, from the last pair
+    while( pairs != NULL )
+    {
+        a = pairs;
+        pairs = a->Sibling;
+        a->Sibling = NULL;
+
+        root = TimerHeapMeld( root, a );
+    }
+
+    return root;
 }
 
-static void TimerInsertTimer( TimerEvent_t *obj )
+/*!
+ * \brief Removes an object from the heap
+ *
+ * \param [IN] obj Timer object in the heap
+ */
+static void TimerHeapRemove( TimerEvent_t *obj )
 {
-    TimerEvent_t* cur = TimerListHead;
-    TimerEvent_t* next = TimerListHead->Next;
+    TimerEvent_t *children = TimerHeapMergePairs( obj->Child );
 
-    while( cur->Next != NULL )
+    if( obj == TimerHeapRoot )
     {
-        if( obj->Timestamp > next->Timestamp )
+        TimerHeapRoot = children;
+    }
+    else
+    {
+        // Detach the object and its children from its parent or sibling
+        if( obj->Prev->Child == obj )
         {
-            cur = next;
-            next = next->Next;
+            obj->Prev->Child = obj->Sibling;
         }
         else
         {
-            cur->Next = obj;
-            obj->Next = next;
-            return;
+            obj->Prev->Sibling = obj->Sibling;
         }
+        if( obj->Sibling != NULL )
+        {
+            obj->Sibling->Prev = obj->Prev;
+        }
+
+        TimerHeapRoot = TimerHeapMeld( TimerHeapRoot, children );
     }
-    cur->Next = obj;
-    obj->Next = NULL;
+
+    obj->Child = NULL;
+    obj->Sibling = NULL;
+    obj->Prev = NULL;
+}
+
+void TimerInit( TimerEvent_t *obj, void ( *callback )( void *context ) )
+{
+    obj->Timestamp = 0;
+    obj->ReloadValue = 0;
+    obj->IsStarted = false;
+    obj->Callback = callback;
+    obj->Context = NULL;
+    obj->Child = NULL;
+    obj->Sibling = NULL;
+    obj->Prev = NULL;
 }
 
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj )
+void TimerSetContext( TimerEvent_t *obj, void* context )
 {
-    TimerEvent_t* cur = TimerListHead;
+    obj->Context = context;
+}
+
+void TimerStart( TimerEvent_t *obj )
+{
+    uint32_t now;
+
+    CRITICAL_SECTION_BEGIN( );
+
+    if( ( obj == NULL ) || ( TimerExists( obj ) == true ) )
+    {
+        CRITICAL_SECTION_END( );
+        return;
+    }
 
-    if( cur != NULL )
+    now = RtcGetTimerValue( );
+    if( TimerHeapRoot == NULL )
     {
-        cur->IsNext2Expire = false;
+        TimerHeapBase = now;
     }
 
-    obj->Next = cur;
-    TimerListHead = obj;
-    TimerSetTimeout( TimerListHead );
+    obj->Timestamp = now + obj->ReloadValue;
+    obj->IsStarted = true;
+
+    TimerHeapRoot = TimerHeapMeld( TimerHeapRoot, obj );
+    if( TimerHeapRoot == obj )
+    {
+        TimerSetTimeout( obj );
+    }
+    CRITICAL_SECTION_END( );
 }
 
 bool TimerIsStarted( TimerEvent_t *obj )
@@ -183,52 +256,33 @@ bool TimerIsStarted( TimerEvent_t *obj )
 void TimerIrqHandler( void )
 {
     TimerEvent_t* cur;
-    TimerEvent_t* next;
-
-    uint32_t old =  RtcGetTimerContext( );
-    uint32_t now =  RtcSetTimerContext( );
-    uint32_t deltaContext = now - old; // intentional wrap around
+    uint32_t elapsed;
 
-    // Update timeStamp based upon new Time Reference
-    // because delta context should never exceed 2^32
-    if( TimerListHead != NULL )
+    // Execute the callbacks of all the expired objects, including those
+    // started by the callbacks with a short timeout
+    for( ;; )
     {
-        for( cur = TimerListHead; cur->Next != NULL; cur = cur->Next )
+        elapsed = RtcGetTimerValue( ) - TimerHeapBase; // intentional wrap around
+
+        if( ( TimerHeapRoot == NULL ) || ( TimerHeapKey( TimerHeapRoot ) > elapsed ) )
         {
-            next = cur->Next;
-            if( next->Timestamp > deltaContext )
-            {
-                next->Timestamp -= deltaContext;
-            }
-            else
-            {
-                next->Timestamp = 0;
-            }
+            break;
         }
-    }
 
-    // Execute immediately the alarm callback
-    if ( TimerListHead != NULL )
-    {
-        cur = TimerListHead;
-        TimerListHead = TimerListHead->Next;
+        cur = TimerHeapRoot;
+        TimerHeapRemove( cur );
         cur->IsStarted = false;
         ExecuteCallBack( cur->Callback, cur->Context );
     }
 
-    // Remove all the expired object from the list
-    while( ( TimerListHead != NULL ) && ( TimerListHead->Timestamp < RtcGetTimerElapsedTime( ) ) )
-    {
-        cur = TimerListHead;
-        TimerListHead = TimerListHead->Next;
-        cur->IsStarted = false;
-        ExecuteCallBack( cur->Callback, cur->Context );
-    }
+    // Every running object expires after the elapsed time, so moving the
+    // reference up to it keeps the order of the heap
+    TimerHeapBase += elapsed;
 
-    // Start the next TimerListHead if it exists AND NOT running
-    if( ( TimerListHead != NULL ) && ( TimerListHead->IsNext2Expire == false ) )
+    // Start the next TimerHeapRoot if it exists
+    if( TimerHeapRoot != NULL )
     {
-        TimerSetTimeout( TimerListHead );
+        TimerSetTimeout( TimerHeapRoot );
     }
 }
 
@@ -236,11 +290,8 @@ void TimerStop( TimerEvent_t *obj )
 {
     CRITICAL_SECTION_BEGIN( );
 
-    TimerEvent_t* prev = TimerListHead;
-    TimerEvent_t* cur = TimerListHead;
-
-    // List is empty or the obj to stop does not exist
-    if( ( TimerListHead == NULL ) || ( obj == NULL ) )
+    // Heap is empty or the obj to stop does not exist
+    if( ( TimerHeapRoot == NULL ) || ( obj == NULL ) )
     {
         CRITICAL_SECTION_END( );
         return;
@@ -248,57 +299,23 @@ void TimerStop( TimerEvent_t *obj )
 
     obj->IsStarted = false;
 
-    if( TimerListHead == obj ) // Stop the Head
+    if( TimerExists( obj ) == true )
     {
-        if( TimerListHead->IsNext2Expire == true ) // The head is already running
+        if( TimerHeapRoot == obj ) // Stop the running head
         {
-            TimerListHead->IsNext2Expire = false;
-            if( TimerListHead->Next != NULL )
+            TimerHeapRemove( obj );
+            if( TimerHeapRoot != NULL )
             {
-                TimerListHead = TimerListHead->Next;
-                TimerSetTimeout( TimerListHead );
+                TimerSetTimeout( TimerHeapRoot );
             }
             else
             {
                 RtcStopAlarm( );
-                TimerListHead = NULL;
             }
         }
-        else // Stop the head before it is started
-        {
-            if( TimerListHead->Next != NULL )
-            {
-                TimerListHead = TimerListHead->Next;
-            }
-            else
-            {
-                TimerListHead = NULL;
-            }
-        }
-    }
-    else // Stop an object within the list
-    {
-        while( cur != NULL )
+        else
         {
-            if( cur == obj )
-            {
-                if( cur->Next != NULL )
-                {
-                    cur = cur->Next;
-                    prev->Next = cur;
-                }
-                else
-                {
-                    cur = NULL;
-                    prev->Next = cur;
-                }
-                break;
-            }
-            else
-            {
-                prev = cur;
-                cur = cur->Next;
-            }
+            TimerHeapRemove( obj );
         }
     }
     CRITICAL_SECTION_END( );
@@ -306,17 +323,8 @@ void TimerStop( TimerEvent_t *obj )
 
 static bool TimerExists( TimerEvent_t *obj )
 {
-    TimerEvent_t* cur = TimerListHead;
-
-    while( cur != NULL )
-    {
-        if( cur == obj )
-        {
-            return true;
-        }
-        cur = cur->Next;
-    }
-    return false;
+    // Only the root of the heap has no parent or sibling before it
+    return ( obj == TimerHeapRoot ) || ( obj->Prev != NULL );
 }
 
 void TimerReset( TimerEvent_t *obj )
@@ -343,6 +351,29 @@ void TimerSetValue( TimerEvent_t *obj, uint32_t value )
     obj->ReloadValue = ticks;
 }
 
+TimerTime_t TimerGetRemainingTime( TimerEvent_t *obj )
+{
+    int32_t remaining;
+
+    CRITICAL_SECTION_BEGIN( );
+
+    if( ( obj == NULL ) || ( obj->IsStarted == false ) )
+    {
+        CRITICAL_SECTION_END( );
+        return TIMERTIME_T_MAX;
+    }
+
+    remaining = ( int32_t )( obj->Timestamp - RtcGetTimerValue( ) );
+    if( remaining < 0 )
+    {
+        remaining = 0;
+    }
+
+    CRITICAL_SECTION_END( );
+
+    return RtcTick2Ms( ( uint32_t )remaining );
+}
+
 TimerTime_t TimerGetCurrentTime( void )
 {
     uint32_t now = RtcGetTimerValue( );
@@ -364,15 +395,22 @@ TimerTime_t TimerGetElapsedTime( TimerTime_t past )
 
 static void TimerSetTimeout( TimerEvent_t *obj )
 {
-    int32_t minTicks= RtcGetMinimumTimeout( );
-    obj->IsNext2Expire = true;
+    uint32_t minTicks = RtcGetMinimumTimeout( );
+    uint32_t elapsed = RtcSetTimerContext( ) - TimerHeapBase; // intentional wrap around
+    uint32_t timeout = 0;
+
+    if( TimerHeapKey( obj ) > elapsed )
+    {
+        timeout = TimerHeapKey( obj ) - elapsed;
+    }
 
-    // In case deadline too soon
-    if( obj->Timestamp  < ( RtcGetTimerElapsedTime( ) + minTicks ) )
+    // In case deadline too soon.  The expiry time stays as it is, so the
+    // object remains in its place in the heap.
+    if( timeout < minTicks )
     {
-        obj->Timestamp = RtcGetTimerElapsedTime( ) + minTicks;
+        timeout = minTicks;
     }
-    RtcSetAlarm( obj->Timestamp );
+    RtcSetAlarm( timeout );
 }
 
 TimerTime_t TimerTempCompensation( TimerTime_t period, float temperature )
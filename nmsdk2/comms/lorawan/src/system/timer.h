@@ -37,13 +37,14 @@ extern "C"
  */
 typedef struct TimerEvent_s
 {
-    uint32_t Timestamp;                  //! Current timer value
+    uint32_t Timestamp;                  //! Expiry time in RTC ticks
     uint32_t ReloadValue;                //! Timer delay value
     bool IsStarted;                      //! Is the timer currently running
-    bool IsNext2Expire;                  //! Is the next timer to expire
     void ( *Callback )( void* context ); //! Timer IRQ callback function
     void *Context;                       //! User defined data object pointer to pass back
-    struct TimerEvent_s *Next;           //! Pointer to the next Timer object.
+    struct TimerEvent_s *Child;          //! First child in the timer heap
+    struct TimerEvent_s *Sibling;        //! Next sibling in the timer heap
+    struct TimerEvent_s *Prev;           //! Parent or previous sibling in the timer heap
 }TimerEvent_t;
 
 /*!
@@ -117,6 +118,15 @@ void TimerReset( TimerEvent_t *obj );
  */
 void TimerSetValue( TimerEvent_t *obj, uint32_t value );
 
+/*!
+ * \brief Return the time left before a timer object expires
+ *
+ * \param [IN] obj Structure containing the timer object parameters
+ * \retval time    Time in ms before the timer expires, 0 if it is due and
+ *                 TIMERTIME_T_MAX if it is not started
+ */
+TimerTime_t TimerGetRemainingTime( TimerEvent_t *obj );
+
 /*!
  * \brief Read the current time
  *
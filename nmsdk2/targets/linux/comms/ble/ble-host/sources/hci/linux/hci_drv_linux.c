@@ -0,0 +1,1871 @@
+/*************************************************************************************************/
+/*!
+ *  \file   hci_drv_linux.c
+ *
+ *  \brief  HCI driver for the simulated controller.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The driver answers HCI commands itself and exchanges link layer PDUs with the controllers of
+ *  other nodes through the simulation coordinator.  It models what the host can observe: event
+ *  ordering, connection event timing and air time at LE 1M, ACL buffer flow control, and the
+ *  procedures the host drives (connection setup, encryption, data length, connection update,
+ *  feature and version exchange, termination).  Channel selection, retransmission, payload
+ *  encryption and supervision timeouts are not modelled.  Scanning listens continuously, and a
+ *  scannable advertiser sends its scan response data with every advertising PDU.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "wsf_types.h"
+#include "wsf_msg.h"
+#include "wsf_trace.h"
+#include "wsf_assert.h"
+#include "util/bda.h"
+#include "util/bstream.h"
+#include "util/wstr.h"
+#include "hci_defs.h"
+#include "ll_defs.h"
+#include "hci_api.h"
+#include "hci_core.h"
+#include "hci_drv.h"
+#include "hci_drv_linux.h"
+#include "sim_api.h"
+#include "uECC.h"
+#include "aes.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Number of simultaneous connections. */
+#define HCI_DRV_MAX_CONN            4
+
+/*! \brief  Number of controller ACL buffers. */
+#define HCI_DRV_NUM_ACL_BUFS        8
+
+/*! \brief  Size of a controller ACL buffer. */
+#define HCI_DRV_ACL_BUF_SIZE        LL_MAX_DATA_LEN_ABS_MAX
+
+/*! \brief  White list size. */
+#define HCI_DRV_WHITE_LIST_SIZE     8
+
+/*! \brief  Number of advertisers remembered for duplicate filtering. */
+#define HCI_DRV_NUM_DUP_FILT        8
+
+/*! \brief  Received signal strength reported for every PDU. */
+#define HCI_DRV_RSSI                (-50)
+
+/*! \brief  Unassigned company identifier, reserved for testing. */
+#define HCI_DRV_COMP_ID             0xFFFF
+
+/*! \brief  LE 1M PHY. */
+#define HCI_DRV_PHY_LE_1M           1
+
+/*! \brief  Time from the CONNECT_IND to the first connection event in microseconds. */
+#define HCI_DRV_CONN_SETUP_US       2500
+
+/*! \brief  Maximum random advertising delay in microseconds. */
+#define HCI_DRV_ADV_DELAY_US        10000
+
+/*! \brief  Microseconds per 0.625 ms unit. */
+#define HCI_DRV_US_PER_625(n)       ((simTime_t)(n) * 625)
+
+/*! \brief  Microseconds per 1.25 ms unit. */
+#define HCI_DRV_US_PER_1250(n)      ((simTime_t)(n) * 1250)
+
+/*! \brief  Air time of a data channel PDU with the given payload length. */
+#define HCI_DRV_DATA_AIR_US(len, enc) \
+  ((LL_BLE_US_PER_BYTE_1M * ((len) + ((enc) ? LL_DATA_MIC_LEN : 0))) + LL_MIN_PKT_TIME_US_1M)
+
+/*! \brief  Air time of an advertising channel PDU with the given payload length. */
+#define HCI_DRV_ADV_AIR_US(len)     ((LL_BLE_US_PER_BYTE_1M * (len)) + LL_MIN_PKT_TIME_US_1M)
+
+/*! \brief  Length of a CONNECT_IND payload. */
+#define HCI_DRV_CONNECT_IND_LEN     34
+
+/*! \brief  Air PDU channel. */
+enum
+{
+  HCI_DRV_AIR_ADV,                      /*!< Advertising channel PDU. */
+  HCI_DRV_AIR_DATA                      /*!< Data channel PDU. */
+};
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Connection. */
+typedef struct
+{
+  bool_t        inUse;                  /*!< TRUE if connected. */
+  uint16_t      handle;                 /*!< Connection handle. */
+  uint8_t       role;                   /*!< Local role. */
+  uint8_t       peer;                   /*!< Peer node. */
+  uint16_t      interval;               /*!< Connection interval in 1.25 ms units. */
+  uint16_t      latency;                /*!< Slave latency. */
+  uint16_t      supTimeout;             /*!< Supervision timeout in 10 ms units. */
+  simTime_t     anchor;                 /*!< Time of a past or the first connection event. */
+  simTime_t     txFree;                 /*!< End of the last transmission including its ack. */
+  uint16_t      localMaxTx;             /*!< Local maximum transmit octets. */
+  uint16_t      maxTxOctets;            /*!< Effective maximum transmit octets. */
+  uint16_t      maxRxOctets;            /*!< Effective maximum receive octets. */
+  bool_t        encrypted;              /*!< TRUE if encryption is enabled. */
+  uint8_t       ltk[LL_KEY_LEN];        /*!< Master: LTK requested.  Slave: LTK of the master. */
+  bool_t        versionSent;            /*!< TRUE once VERSION_IND was sent. */
+  bool_t        versionReq;             /*!< TRUE while the host waits for the peer version. */
+  bool_t        terminating;            /*!< TRUE once TERMINATE_IND was sent. */
+  uint16_t      updInterval;            /*!< Pending connection update interval. */
+  uint16_t      updLatency;             /*!< Pending connection update latency. */
+  uint16_t      updTimeout;             /*!< Pending connection update supervision timeout. */
+  simAlarm_t    updAlarm;               /*!< Connection update instant. */
+} hciDrvConn_t;
+
+/*! \brief  HCI packet to the host delivered at a later time. */
+typedef struct
+{
+  simAlarm_t    alarm;                  /*!< Delivery alarm. */
+  uint8_t       type;                   /*!< HCI packet type. */
+  uint16_t      len;                    /*!< Packet length. */
+  uint8_t       data[];                 /*!< Packet. */
+} hciDrvPend_t;
+
+/*! \brief  Controller control block. */
+static struct
+{
+  uint8_t       bdAddr[BDA_ADDR_LEN];   /*!< Public address. */
+  uint8_t       randAddr[BDA_ADDR_LEN]; /*!< Random address. */
+  uint32_t      seed;                   /*!< Random number generator state. */
+  uint16_t      nextHandle;             /*!< Next connection handle. */
+  uint16_t      defTxOctets;            /*!< Suggested transmit octets for new connections. */
+  uint64_t      cpuNs;                  /*!< CPU time spent in the controller. */
+
+  /* advertising */
+  bool_t        advEnabled;             /*!< TRUE while advertising. */
+  uint16_t      advInterval;            /*!< Advertising interval in 0.625 ms units. */
+  uint8_t       advType;                /*!< Advertising type. */
+  uint8_t       advOwnAddrType;         /*!< Own address type. */
+  uint8_t       advDataLen;             /*!< Advertising data length. */
+  uint8_t       advData[HCI_ADV_DATA_LEN];      /*!< Advertising data. */
+  uint8_t       scanRspLen;             /*!< Scan response data length. */
+  uint8_t       scanRsp[HCI_SCAN_DATA_LEN];     /*!< Scan response data. */
+  simAlarm_t    advAlarm;               /*!< Next advertising event. */
+
+  /* scanning */
+  bool_t        scanEnabled;            /*!< TRUE while scanning. */
+  uint8_t       scanType;               /*!< Passive or active scanning. */
+  bool_t        filterDup;              /*!< TRUE if duplicates are filtered. */
+  uint8_t       numDup;                 /*!< Number of advertisers reported. */
+  uint8_t       dupAddr[HCI_DRV_NUM_DUP_FILT][BDA_ADDR_LEN];  /*!< Advertisers reported. */
+
+  /* initiating */
+  bool_t        initiating;             /*!< TRUE while creating a connection. */
+  uint8_t       initFilterPolicy;       /*!< Initiator filter policy. */
+  uint8_t       initPeerAddrType;       /*!< Peer address type. */
+  uint8_t       initPeerAddr[BDA_ADDR_LEN];     /*!< Peer address. */
+  uint8_t       initOwnAddrType;        /*!< Own address type. */
+  uint16_t      initInterval;           /*!< Connection interval. */
+  uint16_t      initLatency;            /*!< Slave latency. */
+  uint16_t      initSupTimeout;         /*!< Supervision timeout. */
+
+  /* white list */
+  uint8_t       wlNum;                  /*!< Number of white list entries. */
+  uint8_t       wlAddrType[HCI_DRV_WHITE_LIST_SIZE];              /*!< Entry address types. */
+  uint8_t       wlAddr[HCI_DRV_WHITE_LIST_SIZE][BDA_ADDR_LEN];    /*!< Entry addresses. */
+
+  /* P-256 */
+  uint8_t       privKey[LL_ECC_KEY_LEN];        /*!< Private key, big endian. */
+  bool_t        privKeyValid;           /*!< TRUE once a key pair was generated. */
+
+  hciDrvConn_t  conn[HCI_DRV_MAX_CONN]; /*!< Connections. */
+} hciDrvCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return a pseudo random number.  The generator is seeded per node so that a run is
+ *          reproducible.
+ *
+ *  \return Random number.
+ */
+/*************************************************************************************************/
+static uint32_t hciDrvRand(void)
+{
+  uint32_t x = hciDrvCb.seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+
+  return hciDrvCb.seed = x;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Random number generator used by the ECC library.
+ *
+ *  \param  pDest   Buffer to fill.
+ *  \param  size    Buffer length.
+ *
+ *  \return 1 on success.
+ */
+/*************************************************************************************************/
+static int hciDrvEccRng(uint8_t *pDest, unsigned size)
+{
+  while (size-- > 0)
+  {
+    *pDest++ = (uint8_t) hciDrvRand();
+  }
+
+  return 1;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the own address of the given type.
+ *
+ *  \param  addrType  Own address type.
+ *
+ *  \return Address.
+ */
+/*************************************************************************************************/
+static const uint8_t *hciDrvOwnAddr(uint8_t addrType)
+{
+  return (addrType == HCI_ADDR_TYPE_PUBLIC) ? hciDrvCb.bdAddr : hciDrvCb.randAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Alarm callback delivering a pending HCI packet.
+ *
+ *  \param  pContext  Pending packet.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvPendCback(void *pContext)
+{
+  hciDrvPend_t *pPend = pContext;
+  uint8_t *pBuf;
+
+  if ((pBuf = WsfMsgAlloc(pPend->len)) != NULL)
+  {
+    memcpy(pBuf, pPend->data, pPend->len);
+    hciCoreRecv(pPend->type, pBuf);
+  }
+  else
+  {
+    HCI_TRACE_WARN1("hciDrv out of buffers, type=%u dropped", pPend->type);
+  }
+
+  free(pPend);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an HCI packet to the host.
+ *
+ *  \param  time      Delivery time; the current time or earlier delivers at once.
+ *  \param  type      HCI packet type.
+ *  \param  pData     Packet.
+ *  \param  len       Packet length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvToHost(simTime_t time, uint8_t type, const uint8_t *pData, uint16_t len)
+{
+  hciDrvPend_t *pPend;
+
+  if ((pPend = malloc(sizeof(hciDrvPend_t) + len)) == NULL)
+  {
+    return;
+  }
+
+  pPend->type = type;
+  pPend->len = len;
+  memcpy(pPend->data, pData, len);
+
+  if (time <= SimNodeGetTime())
+  {
+    hciDrvPendCback(pPend);
+  }
+  else
+  {
+    SimNodeAlarmInit(&pPend->alarm, hciDrvPendCback, pPend);
+    SimNodeAlarmStart(&pPend->alarm, time);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an HCI event to the host.
+ *
+ *  \param  time      Delivery time.
+ *  \param  evt       Event code.
+ *  \param  pParam    Event parameters.
+ *  \param  len       Parameter length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvEvt(simTime_t time, uint8_t evt, const uint8_t *pParam, uint8_t len)
+{
+  uint8_t buf[HCI_EVT_HDR_LEN + UINT8_MAX];
+
+  buf[0] = evt;
+  buf[1] = len;
+  memcpy(buf + HCI_EVT_HDR_LEN, pParam, len);
+
+  hciDrvToHost(time, HCI_EVT_TYPE, buf, HCI_EVT_HDR_LEN + len);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a command complete event.
+ *
+ *  \param  opcode    Command opcode.
+ *  \param  pParam    Return parameters, starting with the status.
+ *  \param  len       Return parameter length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCmdCmpl(uint16_t opcode, const uint8_t *pParam, uint8_t len)
+{
+  uint8_t buf[UINT8_MAX];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, 1);
+  UINT16_TO_BSTREAM(p, opcode);
+  memcpy(p, pParam, len);
+
+  hciDrvEvt(0, HCI_CMD_CMPL_EVT, buf, len + 3);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a command complete event carrying only a status.
+ *
+ *  \param  opcode    Command opcode.
+ *  \param  status    Status.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCmdCmplStatus(uint16_t opcode, uint8_t status)
+{
+  hciDrvCmdCmpl(opcode, &status, 1);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a command complete event carrying a status and a connection handle.
+ *
+ *  \param  opcode    Command opcode.
+ *  \param  status    Status.
+ *  \param  handle    Connection handle.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCmdCmplHandle(uint16_t opcode, uint8_t status, uint16_t handle)
+{
+  uint8_t buf[3];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, status);
+  UINT16_TO_BSTREAM(p, handle);
+
+  hciDrvCmdCmpl(opcode, buf, sizeof(buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a command status event.
+ *
+ *  \param  opcode    Command opcode.
+ *  \param  status    Status.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCmdStatus(uint16_t opcode, uint8_t status)
+{
+  uint8_t buf[4];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, status);
+  UINT8_TO_BSTREAM(p, 1);
+  UINT16_TO_BSTREAM(p, opcode);
+
+  hciDrvEvt(0, HCI_CMD_STATUS_EVT, buf, sizeof(buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find a connection by handle.
+ *
+ *  \param  handle    Connection handle.
+ *
+ *  \return Connection or NULL.
+ */
+/*************************************************************************************************/
+static hciDrvConn_t *hciDrvConnByHandle(uint16_t handle)
+{
+  hciDrvConn_t *pConn = hciDrvCb.conn;
+  uint8_t i;
+
+  for (i = 0; i < HCI_DRV_MAX_CONN; i++, pConn++)
+  {
+    if (pConn->inUse && (pConn->handle == handle))
+    {
+      return pConn;
+    }
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find a connection by peer node.
+ *
+ *  \param  peer      Peer node.
+ *
+ *  \return Connection or NULL.
+ */
+/*************************************************************************************************/
+static hciDrvConn_t *hciDrvConnByPeer(uint8_t peer)
+{
+  hciDrvConn_t *pConn = hciDrvCb.conn;
+  uint8_t i;
+
+  for (i = 0; i < HCI_DRV_MAX_CONN; i++, pConn++)
+  {
+    if (pConn->inUse && (pConn->peer == peer))
+    {
+      return pConn;
+    }
+  }
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the time of the first connection event at or after a given time.
+ *
+ *  \param  pConn     Connection.
+ *  \param  time      Earliest time.
+ *
+ *  \return Connection event time.
+ */
+/*************************************************************************************************/
+static simTime_t hciDrvConnEvent(hciDrvConn_t *pConn, simTime_t time)
+{
+  simTime_t intervalUs = HCI_DRV_US_PER_1250(pConn->interval);
+
+  if (time <= pConn->anchor)
+  {
+    return pConn->anchor;
+  }
+
+  return pConn->anchor + ((time - pConn->anchor + intervalUs - 1) / intervalUs) * intervalUs;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Transmit a data channel PDU to the peer.  PDUs queued while the previous one is still
+ *          on the air follow it in the same connection event; otherwise they wait for the next
+ *          connection event.
+ *
+ *  \param  pConn     Connection.
+ *  \param  llid      LLID.
+ *  \param  pPayload  Payload.
+ *  \param  len       Payload length.
+ *
+ *  \return Time the peer has received the PDU.
+ */
+/*************************************************************************************************/
+static simTime_t hciDrvConnTx(hciDrvConn_t *pConn, uint8_t llid, const uint8_t *pPayload,
+                              uint16_t len)
+{
+  uint8_t pdu[2 + LL_MAX_DATA_LEN_ABS_MAX];
+  simTime_t now = SimNodeGetTime();
+  simTime_t start;
+  simTime_t rxTime;
+
+  WSF_ASSERT(len <= LL_MAX_DATA_LEN_ABS_MAX);
+
+  start = (pConn->txFree > now) ? pConn->txFree : hciDrvConnEvent(pConn, now);
+  rxTime = start + HCI_DRV_DATA_AIR_US(len, pConn->encrypted);
+
+  /* the peer acknowledges with an empty PDU */
+  pConn->txFree = rxTime + LL_BLE_TIFS_US + HCI_DRV_DATA_AIR_US(0, pConn->encrypted) +
+                  LL_BLE_TIFS_US;
+
+  pdu[0] = HCI_DRV_AIR_DATA;
+  pdu[1] = llid;
+  memcpy(pdu + 2, pPayload, len);
+
+  SimNodeAirSend(pConn->peer, rxTime, pdu, len + 2);
+
+  return rxTime;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Transmit a control PDU to the peer.
+ *
+ *  \param  pConn     Connection.
+ *  \param  opcode    Control PDU opcode.
+ *  \param  pParam    Parameters.
+ *  \param  len       Parameter length.
+ *
+ *  \return Time the peer has received the PDU.
+ */
+/*************************************************************************************************/
+static simTime_t hciDrvCtrlTx(hciDrvConn_t *pConn, uint8_t opcode, const uint8_t *pParam,
+                              uint8_t len)
+{
+  uint8_t buf[1 + 32];
+
+  WSF_ASSERT(len < sizeof(buf));
+
+  buf[0] = opcode;
+  memcpy(buf + 1, pParam, len);
+
+  return hciDrvConnTx(pConn, LL_LLID_CTRL_PDU, buf, len + 1);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send the local data length limits to the peer.
+ *
+ *  \param  pConn     Connection.
+ *  \param  opcode    LL_PDU_LENGTH_REQ or LL_PDU_LENGTH_RSP.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvLengthTx(hciDrvConn_t *pConn, uint8_t opcode)
+{
+  uint8_t buf[8];
+  uint8_t *p = buf;
+
+  UINT16_TO_BSTREAM(p, LL_MAX_DATA_LEN_ABS_MAX);
+  UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(LL_MAX_DATA_LEN_ABS_MAX));
+  UINT16_TO_BSTREAM(p, pConn->localMaxTx);
+  UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(pConn->localMaxTx));
+
+  hciDrvCtrlTx(pConn, opcode, buf, sizeof(buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send VERSION_IND to the peer.
+ *
+ *  \param  pConn     Connection.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvVersionTx(hciDrvConn_t *pConn)
+{
+  uint8_t buf[5];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, LL_VER_BT_CORE_SPEC_5_0);
+  UINT16_TO_BSTREAM(p, HCI_DRV_COMP_ID);
+  UINT16_TO_BSTREAM(p, 0);
+
+  hciDrvCtrlTx(pConn, LL_PDU_VERSION_IND, buf, sizeof(buf));
+  pConn->versionSent = TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the LE features supported by the controller.
+ *
+ *  \return Supported features.
+ */
+/*************************************************************************************************/
+static uint32_t hciDrvLeSupFeat(void)
+{
+  return HCI_LE_SUP_FEAT_ENCRYPTION | HCI_LE_SUP_FEAT_EXT_REJECT_IND |
+         HCI_LE_SUP_FEAT_SLV_INIT_FEAT_EXCH | HCI_LE_SUP_FEAT_DATA_LEN_EXT;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Free a connection and report its termination to the host.
+ *
+ *  \param  pConn     Connection.
+ *  \param  time      Time of the termination.
+ *  \param  reason    Termination reason.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvConnClose(hciDrvConn_t *pConn, simTime_t time, uint8_t reason)
+{
+  uint8_t buf[4];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+  UINT16_TO_BSTREAM(p, pConn->handle);
+  UINT8_TO_BSTREAM(p, reason);
+
+  hciDrvEvt(time, HCI_DISCONNECT_CMPL_EVT, buf, sizeof(buf));
+
+  SimNodeAlarmStop(&pConn->updAlarm);
+  pConn->inUse = FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Connection update instant.
+ *
+ *  \param  pContext  Connection.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvConnUpdCback(void *pContext)
+{
+  hciDrvConn_t *pConn = pContext;
+  uint8_t buf[10];
+  uint8_t *p = buf;
+
+  pConn->anchor = SimNodeGetTime();
+  pConn->interval = pConn->updInterval;
+  pConn->latency = pConn->updLatency;
+  pConn->supTimeout = pConn->updTimeout;
+
+  UINT8_TO_BSTREAM(p, HCI_LE_CONN_UPDATE_CMPL_EVT);
+  UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+  UINT16_TO_BSTREAM(p, pConn->handle);
+  UINT16_TO_BSTREAM(p, pConn->interval);
+  UINT16_TO_BSTREAM(p, pConn->latency);
+  UINT16_TO_BSTREAM(p, pConn->supTimeout);
+
+  hciDrvEvt(0, HCI_LE_META_EVT, buf, sizeof(buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Open a connection and report it to the host.
+ *
+ *  \param  role          Local role.
+ *  \param  peer          Peer node.
+ *  \param  peerAddrType  Peer address type.
+ *  \param  pPeerAddr     Peer address.
+ *  \param  interval      Connection interval.
+ *  \param  latency       Slave latency.
+ *  \param  supTimeout    Supervision timeout.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvConnOpen(uint8_t role, uint8_t peer, uint8_t peerAddrType,
+                           const uint8_t *pPeerAddr, uint16_t interval, uint16_t latency,
+                           uint16_t supTimeout)
+{
+  hciDrvConn_t *pConn = NULL;
+  uint8_t buf[HCI_LEN_LE_CONN_CMPL];
+  uint8_t *p = buf;
+  uint8_t i;
+
+  for (i = 0; i < HCI_DRV_MAX_CONN; i++)
+  {
+    if (!hciDrvCb.conn[i].inUse)
+    {
+      pConn = &hciDrvCb.conn[i];
+      break;
+    }
+  }
+
+  UINT8_TO_BSTREAM(p, HCI_LE_CONN_CMPL_EVT);
+
+  if (pConn == NULL)
+  {
+    /* both sides run the same controller; the peer runs out of links as well */
+    memset(buf, 0, sizeof(buf));
+    buf[0] = HCI_LE_CONN_CMPL_EVT;
+    buf[1] = HCI_ERR_CONN_LIMIT;
+    hciDrvEvt(0, HCI_LE_META_EVT, buf, sizeof(buf));
+    return;
+  }
+
+  memset(pConn, 0, sizeof(hciDrvConn_t));
+  pConn->inUse = TRUE;
+  pConn->handle = hciDrvCb.nextHandle;
+  pConn->role = role;
+  pConn->peer = peer;
+  pConn->interval = interval;
+  pConn->latency = latency;
+  pConn->supTimeout = supTimeout;
+  pConn->anchor = SimNodeGetTime() + HCI_DRV_CONN_SETUP_US;
+  pConn->localMaxTx = hciDrvCb.defTxOctets;
+  pConn->maxTxOctets = LL_MAX_DATA_LEN_MIN;
+  pConn->maxRxOctets = LL_MAX_DATA_LEN_MIN;
+  SimNodeAlarmInit(&pConn->updAlarm, hciDrvConnUpdCback, pConn);
+
+  hciDrvCb.nextHandle = (hciDrvCb.nextHandle + 1) & HCI_HANDLE_MASK;
+
+  UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+  UINT16_TO_BSTREAM(p, pConn->handle);
+  UINT8_TO_BSTREAM(p, role);
+  UINT8_TO_BSTREAM(p, peerAddrType);
+  BDA_TO_BSTREAM(p, pPeerAddr);
+  UINT16_TO_BSTREAM(p, interval);
+  UINT16_TO_BSTREAM(p, latency);
+  UINT16_TO_BSTREAM(p, supTimeout);
+  UINT8_TO_BSTREAM(p, HCI_CLOCK_20PPM);
+
+  hciDrvEvt(0, HCI_LE_META_EVT, buf, sizeof(buf));
+
+  /* start the data length update procedure when the host suggested longer PDUs */
+  if (pConn->localMaxTx > LL_MAX_DATA_LEN_MIN)
+  {
+    hciDrvLengthTx(pConn, LL_PDU_LENGTH_REQ);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Advertising event.
+ *
+ *  \param  pContext  Unused.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvAdvCback(void *pContext)
+{
+  uint8_t pdu[3 + BDA_ADDR_LEN + 2 + HCI_ADV_DATA_LEN + HCI_SCAN_DATA_LEN];
+  uint8_t *p = pdu;
+  simTime_t now = SimNodeGetTime();
+
+  (void)pContext;
+
+  UINT8_TO_BSTREAM(p, HCI_DRV_AIR_ADV);
+  UINT8_TO_BSTREAM(p, (hciDrvCb.advType == HCI_ADV_TYPE_CONN_DIRECT_LO_DUTY) ?
+                      HCI_ADV_CONN_DIRECT : hciDrvCb.advType);
+  UINT8_TO_BSTREAM(p, hciDrvCb.advOwnAddrType);
+  BDA_TO_BSTREAM(p, hciDrvOwnAddr(hciDrvCb.advOwnAddrType));
+  UINT8_TO_BSTREAM(p, hciDrvCb.advDataLen);
+  memcpy(p, hciDrvCb.advData, hciDrvCb.advDataLen);
+  p += hciDrvCb.advDataLen;
+  UINT8_TO_BSTREAM(p, hciDrvCb.scanRspLen);
+  memcpy(p, hciDrvCb.scanRsp, hciDrvCb.scanRspLen);
+  p += hciDrvCb.scanRspLen;
+
+  SimNodeAirSend(SIM_NODE_BROADCAST,
+                 now + HCI_DRV_ADV_AIR_US(LL_ADV_PREFIX_LEN + hciDrvCb.advDataLen),
+                 pdu, (uint16_t)(p - pdu));
+
+  SimNodeAlarmStart(&hciDrvCb.advAlarm, now + HCI_DRV_US_PER_625(hciDrvCb.advInterval) +
+                                        (hciDrvRand() % HCI_DRV_ADV_DELAY_US));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check whether an address is in the white list.
+ *
+ *  \param  addrType  Address type.
+ *  \param  pAddr     Address.
+ *
+ *  \return TRUE if listed.
+ */
+/*************************************************************************************************/
+static bool_t hciDrvWhiteListed(uint8_t addrType, const uint8_t *pAddr)
+{
+  uint8_t i;
+
+  for (i = 0; i < hciDrvCb.wlNum; i++)
+  {
+    if ((hciDrvCb.wlAddrType[i] == addrType) && BdaCmp(hciDrvCb.wlAddr[i], pAddr))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Report an advertising or scan response PDU to the host.
+ *
+ *  \param  time      Delivery time.
+ *  \param  evtType   Report event type.
+ *  \param  addrType  Advertiser address type.
+ *  \param  pAddr     Advertiser address.
+ *  \param  pData     Data.
+ *  \param  len       Data length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvAdvReport(simTime_t time, uint8_t evtType, uint8_t addrType,
+                            const uint8_t *pAddr, const uint8_t *pData, uint8_t len)
+{
+  uint8_t buf[3 + 1 + BDA_ADDR_LEN + 1 + HCI_ADV_DATA_LEN + 1];
+  uint8_t *p = buf;
+
+  UINT8_TO_BSTREAM(p, HCI_LE_ADV_REPORT_EVT);
+  UINT8_TO_BSTREAM(p, 1);
+  UINT8_TO_BSTREAM(p, evtType);
+  UINT8_TO_BSTREAM(p, addrType);
+  BDA_TO_BSTREAM(p, pAddr);
+  UINT8_TO_BSTREAM(p, len);
+  memcpy(p, pData, len);
+  p += len;
+  UINT8_TO_BSTREAM(p, (uint8_t) HCI_DRV_RSSI);
+
+  hciDrvEvt(time, HCI_LE_META_EVT, buf, (uint8_t)(p - buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Handle an advertising channel PDU from another node.
+ *
+ *  \param  src       Source node.
+ *  \param  pPdu      PDU, after the channel.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvAdvRecv(uint8_t src, const uint8_t *pPdu, uint16_t len)
+{
+  const uint8_t *pAddr;
+  const uint8_t *pAdvData;
+  const uint8_t *pScanRsp;
+  uint8_t evtType;
+  uint8_t addrType;
+  uint8_t advDataLen;
+  uint8_t scanRspLen;
+  uint8_t i;
+  simTime_t now = SimNodeGetTime();
+
+  BSTREAM_TO_UINT8(evtType, pPdu);
+
+  if (evtType == LL_PDU_CONNECT_IND)
+  {
+    uint8_t peerAddrType;
+    uint16_t interval, latency, supTimeout;
+
+    if (!hciDrvCb.advEnabled || (hciDrvCb.advType == HCI_ADV_TYPE_DISC_UNDIRECT) ||
+        (hciDrvCb.advType == HCI_ADV_TYPE_NONCONN_UNDIRECT))
+    {
+      return;
+    }
+
+    BSTREAM_TO_UINT8(peerAddrType, pPdu);
+    pAddr = pPdu;
+    pPdu += BDA_ADDR_LEN;
+    BSTREAM_TO_UINT16(interval, pPdu);
+    BSTREAM_TO_UINT16(latency, pPdu);
+    BSTREAM_TO_UINT16(supTimeout, pPdu);
+
+    /* advertising stops once connected */
+    hciDrvCb.advEnabled = FALSE;
+    SimNodeAlarmStop(&hciDrvCb.advAlarm);
+
+    hciDrvConnOpen(HCI_ROLE_SLAVE, src, peerAddrType, pAddr, interval, latency, supTimeout);
+    return;
+  }
+
+  BSTREAM_TO_UINT8(addrType, pPdu);
+  pAddr = pPdu;
+  pPdu += BDA_ADDR_LEN;
+  BSTREAM_TO_UINT8(advDataLen, pPdu);
+  pAdvData = pPdu;
+  pPdu += advDataLen;
+  BSTREAM_TO_UINT8(scanRspLen, pPdu);
+  pScanRsp = pPdu;
+
+  if (hciDrvCb.initiating &&
+      ((evtType == HCI_ADV_CONN_UNDIRECT) || (evtType == HCI_ADV_CONN_DIRECT)) &&
+      ((hciDrvCb.initFilterPolicy == HCI_FILT_WHITE_LIST) ?
+        hciDrvWhiteListed(addrType, pAddr) :
+        ((hciDrvCb.initPeerAddrType == addrType) && BdaCmp(hciDrvCb.initPeerAddr, pAddr))))
+  {
+    uint8_t pdu[2 + HCI_DRV_CONNECT_IND_LEN];
+    uint8_t *p = pdu;
+    simTime_t txTime = now + LL_BLE_TIFS_US;
+
+    UINT8_TO_BSTREAM(p, HCI_DRV_AIR_ADV);
+    UINT8_TO_BSTREAM(p, LL_PDU_CONNECT_IND);
+    UINT8_TO_BSTREAM(p, hciDrvCb.initOwnAddrType);
+    BDA_TO_BSTREAM(p, hciDrvOwnAddr(hciDrvCb.initOwnAddrType));
+    UINT16_TO_BSTREAM(p, hciDrvCb.initInterval);
+    UINT16_TO_BSTREAM(p, hciDrvCb.initLatency);
+    UINT16_TO_BSTREAM(p, hciDrvCb.initSupTimeout);
+
+    SimNodeAirSend(src, txTime + HCI_DRV_ADV_AIR_US(HCI_DRV_CONNECT_IND_LEN), pdu,
+                   (uint16_t)(p - pdu));
+
+    hciDrvCb.initiating = FALSE;
+    hciDrvConnOpen(HCI_ROLE_MASTER, src, addrType, pAddr, hciDrvCb.initInterval,
+                   hciDrvCb.initLatency, hciDrvCb.initSupTimeout);
+    return;
+  }
+
+  if (!hciDrvCb.scanEnabled)
+  {
+    return;
+  }
+
+  if (hciDrvCb.filterDup)
+  {
+    for (i = 0; i < hciDrvCb.numDup; i++)
+    {
+      if (BdaCmp(hciDrvCb.dupAddr[i], pAddr))
+      {
+        return;
+      }
+    }
+
+    if (hciDrvCb.numDup < HCI_DRV_NUM_DUP_FILT)
+    {
+      BdaCpy(hciDrvCb.dupAddr[hciDrvCb.numDup++], pAddr);
+    }
+  }
+
+  hciDrvAdvReport(now, evtType, addrType, pAddr, pAdvData, advDataLen);
+
+  /* SCAN_REQ and SCAN_RSP follow the advertising PDU */
+  if ((hciDrvCb.scanType == HCI_SCAN_TYPE_ACTIVE) &&
+      ((evtType == HCI_ADV_CONN_UNDIRECT) || (evtType == HCI_ADV_DISC_UNDIRECT)))
+  {
+    now += LL_BLE_TIFS_US + HCI_DRV_ADV_AIR_US(2 * LL_ADV_PREFIX_LEN) + LL_BLE_TIFS_US +
+           HCI_DRV_ADV_AIR_US(LL_ADV_PREFIX_LEN + scanRspLen);
+
+    hciDrvAdvReport(now, HCI_ADV_SCAN_RESPONSE, addrType, pAddr, pScanRsp, scanRspLen);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Handle a control PDU from the peer.
+ *
+ *  \param  pConn     Connection.
+ *  \param  pPdu      Control PDU.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCtrlRecv(hciDrvConn_t *pConn, const uint8_t *pPdu, uint16_t len)
+{
+  uint8_t buf[16];
+  uint8_t *p = buf;
+  uint8_t opcode;
+  simTime_t now = SimNodeGetTime();
+
+  BSTREAM_TO_UINT8(opcode, pPdu);
+
+  switch (opcode)
+  {
+    case LL_PDU_TERMINATE_IND:
+      hciDrvConnClose(pConn, now, pPdu[0]);
+      break;
+
+    case LL_PDU_ENC_REQ:
+      /* the LTK travels with the request so the slave can tell whether the keys match */
+      memcpy(pConn->ltk, pPdu + LL_RAND_LEN + 2, LL_KEY_LEN);
+
+      UINT8_TO_BSTREAM(p, HCI_LE_LTK_REQ_EVT);
+      UINT16_TO_BSTREAM(p, pConn->handle);
+      memcpy(p, pPdu, LL_RAND_LEN + 2);
+      hciDrvEvt(0, HCI_LE_META_EVT, buf, 3 + LL_RAND_LEN + 2);
+      break;
+
+    case LL_PDU_START_ENC_RSP:
+    case LL_PDU_REJECT_IND:
+      {
+        uint8_t status = (opcode == LL_PDU_REJECT_IND) ? pPdu[0] : HCI_SUCCESS;
+        bool_t refresh = pConn->encrypted;
+
+        if (status == HCI_SUCCESS)
+        {
+          pConn->encrypted = TRUE;
+        }
+
+        UINT8_TO_BSTREAM(p, status);
+        UINT16_TO_BSTREAM(p, pConn->handle);
+        if (refresh)
+        {
+          hciDrvEvt(0, HCI_ENC_KEY_REFRESH_CMPL_EVT, buf, 3);
+        }
+        else
+        {
+          UINT8_TO_BSTREAM(p, pConn->encrypted);
+          hciDrvEvt(0, HCI_ENC_CHANGE_EVT, buf, 4);
+        }
+      }
+      break;
+
+    case LL_PDU_LENGTH_REQ:
+    case LL_PDU_LENGTH_RSP:
+      {
+        uint16_t peerMaxRx, peerMaxTx;
+        uint16_t maxTx, maxRx;
+
+        BYTES_TO_UINT16(peerMaxRx, pPdu);
+        BYTES_TO_UINT16(peerMaxTx, pPdu + 4);
+
+        if (opcode == LL_PDU_LENGTH_REQ)
+        {
+          hciDrvLengthTx(pConn, LL_PDU_LENGTH_RSP);
+        }
+
+        maxTx = (pConn->localMaxTx < peerMaxRx) ? pConn->localMaxTx : peerMaxRx;
+        maxRx = (peerMaxTx < LL_MAX_DATA_LEN_ABS_MAX) ? peerMaxTx : LL_MAX_DATA_LEN_ABS_MAX;
+
+        if ((maxTx != pConn->maxTxOctets) || (maxRx != pConn->maxRxOctets))
+        {
+          pConn->maxTxOctets = maxTx;
+          pConn->maxRxOctets = maxRx;
+
+          UINT8_TO_BSTREAM(p, HCI_LE_DATA_LEN_CHANGE_EVT);
+          UINT16_TO_BSTREAM(p, pConn->handle);
+          UINT16_TO_BSTREAM(p, maxTx);
+          UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(maxTx));
+          UINT16_TO_BSTREAM(p, maxRx);
+          UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(maxRx));
+          hciDrvEvt(0, HCI_LE_META_EVT, buf, (uint8_t)(p - buf));
+        }
+      }
+      break;
+
+    case LL_PDU_CONN_UPDATE_IND:
+      {
+        simTime_t instant;
+
+        BSTREAM_TO_UINT16(pConn->updInterval, pPdu);
+        BSTREAM_TO_UINT16(pConn->updLatency, pPdu);
+        BSTREAM_TO_UINT16(pConn->updTimeout, pPdu);
+        BSTREAM_TO_UINT64(instant, pPdu);
+
+        SimNodeAlarmStart(&pConn->updAlarm, instant);
+      }
+      break;
+
+    case LL_PDU_FEATURE_REQ:
+    case LL_PDU_SLV_FEATURE_REQ:
+      UINT32_TO_BSTREAM(p, hciDrvLeSupFeat());
+      UINT32_TO_BSTREAM(p, 0);
+      hciDrvCtrlTx(pConn, LL_PDU_FEATURE_RSP, buf, 8);
+      break;
+
+    case LL_PDU_FEATURE_RSP:
+      UINT8_TO_BSTREAM(p, HCI_LE_READ_REMOTE_FEAT_CMPL_EVT);
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT16_TO_BSTREAM(p, pConn->handle);
+      memcpy(p, pPdu, 8);
+      hciDrvEvt(0, HCI_LE_META_EVT, buf, 12);
+      break;
+
+    case LL_PDU_VERSION_IND:
+      if (!pConn->versionSent)
+      {
+        hciDrvVersionTx(pConn);
+      }
+
+      if (pConn->versionReq)
+      {
+        pConn->versionReq = FALSE;
+
+        UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+        UINT16_TO_BSTREAM(p, pConn->handle);
+        memcpy(p, pPdu, 5);
+        hciDrvEvt(0, HCI_READ_REMOTE_VER_INFO_CMPL_EVT, buf, 8);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Handle a data channel PDU from a peer.
+ *
+ *  \param  src       Source node.
+ *  \param  pPdu      PDU, after the channel.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvDataRecv(uint8_t src, const uint8_t *pPdu, uint16_t len)
+{
+  uint8_t buf[HCI_ACL_HDR_LEN + LL_MAX_DATA_LEN_ABS_MAX];
+  uint8_t *p = buf;
+  hciDrvConn_t *pConn;
+  uint8_t llid;
+
+  /* the connection may already be gone on this side */
+  if ((pConn = hciDrvConnByPeer(src)) == NULL)
+  {
+    return;
+  }
+
+  BSTREAM_TO_UINT8(llid, pPdu);
+  len--;
+
+  if (llid == LL_LLID_CTRL_PDU)
+  {
+    hciDrvCtrlRecv(pConn, pPdu, len);
+    return;
+  }
+
+  UINT16_TO_BSTREAM(p, pConn->handle |
+                       ((llid == LL_LLID_START_PDU) ? HCI_PB_START_C2H : HCI_PB_CONTINUE));
+  UINT16_TO_BSTREAM(p, len);
+  memcpy(p, pPdu, len);
+
+  hciDrvToHost(0, HCI_ACL_TYPE, buf, HCI_ACL_HDR_LEN + len);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Air PDU receive callback.
+ *
+ *  \param  src       Source node.
+ *  \param  pPdu      PDU.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvAirRecv(uint8_t src, const uint8_t *pPdu, uint16_t len)
+{
+  uint64_t start = SimCpuNs();
+  uint64_t link = SimNodeGetLinkCpuNs();
+
+  if (len > 1)
+  {
+    if (pPdu[0] == HCI_DRV_AIR_ADV)
+    {
+      hciDrvAdvRecv(src, pPdu + 1, len - 1);
+    }
+    else
+    {
+      hciDrvDataRecv(src, pPdu + 1, len - 1);
+    }
+  }
+
+  hciDrvCb.cpuNs += (SimCpuNs() - start) - (SimNodeGetLinkCpuNs() - link);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Transmit ACL data from the host, split into data channel PDUs.
+ *
+ *  \param  pData     HCI ACL packet.
+ *  \param  len       Packet length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvAclRecv(const uint8_t *pData, uint16_t len)
+{
+  uint8_t buf[5];
+  uint8_t *p = buf;
+  hciDrvConn_t *pConn;
+  uint16_t handle;
+  uint16_t aclLen;
+  uint16_t chunk;
+  uint8_t llid;
+  simTime_t done = SimNodeGetTime();
+
+  BSTREAM_TO_UINT16(handle, pData);
+  BSTREAM_TO_UINT16(aclLen, pData);
+
+  llid = ((handle & HCI_PB_FLAG_MASK) == HCI_PB_CONTINUE) ? LL_LLID_CONT_PDU : LL_LLID_START_PDU;
+  handle &= HCI_HANDLE_MASK;
+
+  if (((pConn = hciDrvConnByHandle(handle)) == NULL) || pConn->terminating)
+  {
+    /* packet is flushed; the host reclaims the buffer with the disconnection */
+    return;
+  }
+
+  while (aclLen > 0)
+  {
+    chunk = (aclLen < pConn->maxTxOctets) ? aclLen : pConn->maxTxOctets;
+    hciDrvConnTx(pConn, llid, pData, chunk);
+
+    llid = LL_LLID_CONT_PDU;
+    pData += chunk;
+    aclLen -= chunk;
+  }
+
+  /* the buffer is released once the last PDU is acknowledged */
+  if (pConn->txFree > done)
+  {
+    done = pConn->txFree;
+  }
+
+  UINT8_TO_BSTREAM(p, 1);
+  UINT16_TO_BSTREAM(p, handle);
+  UINT16_TO_BSTREAM(p, 1);
+  hciDrvEvt(done, HCI_NUM_CMPL_PKTS_EVT, buf, sizeof(buf));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Execute an HCI command.
+ *
+ *  \param  pCmd      HCI command.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void hciDrvCmdRecv(const uint8_t *pCmd)
+{
+  uint8_t buf[1 + 2 * LL_ECC_KEY_LEN + 1];
+  uint8_t *p = buf;
+  hciDrvConn_t *pConn = NULL;
+  uint16_t opcode;
+  uint16_t handle;
+  uint8_t paramLen;
+
+  BSTREAM_TO_UINT16(opcode, pCmd);
+  BSTREAM_TO_UINT8(paramLen, pCmd);
+  (void)paramLen;
+
+  switch (opcode)
+  {
+    /* configuration */
+    case HCI_OPCODE_RESET:
+      {
+        uint8_t i;
+
+        for (i = 0; i < HCI_DRV_MAX_CONN; i++)
+        {
+          SimNodeAlarmStop(&hciDrvCb.conn[i].updAlarm);
+          hciDrvCb.conn[i].inUse = FALSE;
+        }
+
+        SimNodeAlarmStop(&hciDrvCb.advAlarm);
+        hciDrvCb.advEnabled = FALSE;
+        hciDrvCb.scanEnabled = FALSE;
+        hciDrvCb.initiating = FALSE;
+        hciDrvCb.wlNum = 0;
+        hciDrvCb.defTxOctets = LL_MAX_DATA_LEN_MIN;
+      }
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_READ_BD_ADDR:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      BDA_TO_BSTREAM(p, hciDrvCb.bdAddr);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_BUF_SIZE:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT16_TO_BSTREAM(p, HCI_DRV_ACL_BUF_SIZE);
+      UINT8_TO_BSTREAM(p, HCI_DRV_NUM_ACL_BUFS);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_SUP_STATES:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      memset(p, 0xFF, HCI_LE_STATES_LEN);
+      hciDrvCmdCmpl(opcode, buf, 1 + HCI_LE_STATES_LEN);
+      break;
+
+    case HCI_OPCODE_LE_READ_WHITE_LIST_SIZE:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT8_TO_BSTREAM(p, HCI_DRV_WHITE_LIST_SIZE);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_LOCAL_SUP_FEAT:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT32_TO_BSTREAM(p, hciDrvLeSupFeat());
+      UINT32_TO_BSTREAM(p, 0);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_MAX_DATA_LEN:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT16_TO_BSTREAM(p, LL_MAX_DATA_LEN_ABS_MAX);
+      UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(LL_MAX_DATA_LEN_ABS_MAX));
+      UINT16_TO_BSTREAM(p, LL_MAX_DATA_LEN_ABS_MAX);
+      UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(LL_MAX_DATA_LEN_ABS_MAX));
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_DEF_DATA_LEN:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT16_TO_BSTREAM(p, hciDrvCb.defTxOctets);
+      UINT16_TO_BSTREAM(p, LL_DATA_LEN_TO_TIME_1M(hciDrvCb.defTxOctets));
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_WRITE_DEF_DATA_LEN:
+      BYTES_TO_UINT16(hciDrvCb.defTxOctets, pCmd);
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_READ_LOCAL_VER_INFO:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT8_TO_BSTREAM(p, HCI_VER_BT_CORE_SPEC_5_0);
+      UINT16_TO_BSTREAM(p, 0);
+      UINT8_TO_BSTREAM(p, LL_VER_BT_CORE_SPEC_5_0);
+      UINT16_TO_BSTREAM(p, HCI_DRV_COMP_ID);
+      UINT16_TO_BSTREAM(p, 0);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_READ_ADV_TX_POWER:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT8_TO_BSTREAM(p, 0);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_RAND:
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT32_TO_BSTREAM(p, hciDrvRand());
+      UINT32_TO_BSTREAM(p, hciDrvRand());
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_ENCRYPT:
+      {
+        aes_context ctx;
+        uint8_t key[LL_KEY_LEN];
+        uint8_t data[LL_KEY_LEN];
+
+        /* HCI carries both least significant octet first */
+        WStrReverseCpy(key, pCmd, LL_KEY_LEN);
+        WStrReverseCpy(data, pCmd + LL_KEY_LEN, LL_KEY_LEN);
+
+        aes_set_key(key, LL_KEY_LEN, &ctx);
+        aes_encrypt(data, data, &ctx);
+
+        UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+        WStrReverseCpy(p, data, LL_KEY_LEN);
+        hciDrvCmdCmpl(opcode, buf, 1 + LL_KEY_LEN);
+      }
+      break;
+
+    case HCI_OPCODE_LE_READ_LOCAL_P256_PUB_KEY:
+      {
+        uint8_t pubKey[2 * LL_ECC_KEY_LEN];
+
+        hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+        hciDrvCb.privKeyValid = (uECC_make_key(pubKey, hciDrvCb.privKey) != 0);
+
+        UINT8_TO_BSTREAM(p, HCI_LE_READ_LOCAL_P256_PUB_KEY_CMPL_EVT);
+        UINT8_TO_BSTREAM(p, hciDrvCb.privKeyValid ? HCI_SUCCESS : HCI_ERR_UNSPECIFIED);
+        WStrReverseCpy(p, pubKey, LL_ECC_KEY_LEN);
+        WStrReverseCpy(p + LL_ECC_KEY_LEN, pubKey + LL_ECC_KEY_LEN, LL_ECC_KEY_LEN);
+        hciDrvEvt(0, HCI_LE_META_EVT, buf, 2 + 2 * LL_ECC_KEY_LEN);
+      }
+      break;
+
+    case HCI_OPCODE_LE_GENERATE_DHKEY:
+      {
+        uint8_t pubKey[2 * LL_ECC_KEY_LEN];
+        uint8_t dhKey[LL_ECC_KEY_LEN];
+        uint8_t status = HCI_SUCCESS;
+
+        hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+        WStrReverseCpy(pubKey, pCmd, LL_ECC_KEY_LEN);
+        WStrReverseCpy(pubKey + LL_ECC_KEY_LEN, pCmd + LL_ECC_KEY_LEN, LL_ECC_KEY_LEN);
+
+        if (!hciDrvCb.privKeyValid || !uECC_valid_public_key(pubKey) ||
+            !uECC_shared_secret(pubKey, hciDrvCb.privKey, dhKey))
+        {
+          status = HCI_ERR_INVALID_PARAM;
+          memset(dhKey, 0xFF, sizeof(dhKey));
+        }
+
+        UINT8_TO_BSTREAM(p, HCI_LE_GENERATE_DHKEY_CMPL_EVT);
+        UINT8_TO_BSTREAM(p, status);
+        WStrReverseCpy(p, dhKey, LL_ECC_KEY_LEN);
+        hciDrvEvt(0, HCI_LE_META_EVT, buf, 2 + LL_ECC_KEY_LEN);
+      }
+      break;
+
+    case HCI_OPCODE_LE_SET_RAND_ADDR:
+      BdaCpy(hciDrvCb.randAddr, pCmd);
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    /* white list */
+    case HCI_OPCODE_LE_CLEAR_WHITE_LIST:
+      hciDrvCb.wlNum = 0;
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_ADD_DEV_WHITE_LIST:
+      if (hciDrvWhiteListed(pCmd[0], pCmd + 1))
+      {
+        hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      }
+      else if (hciDrvCb.wlNum < HCI_DRV_WHITE_LIST_SIZE)
+      {
+        hciDrvCb.wlAddrType[hciDrvCb.wlNum] = pCmd[0];
+        BdaCpy(hciDrvCb.wlAddr[hciDrvCb.wlNum++], pCmd + 1);
+        hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      }
+      else
+      {
+        hciDrvCmdCmplStatus(opcode, HCI_ERR_MEMORY_EXCEEDED);
+      }
+      break;
+
+    case HCI_OPCODE_LE_REMOVE_DEV_WHITE_LIST:
+      {
+        uint8_t i;
+
+        for (i = 0; i < hciDrvCb.wlNum; i++)
+        {
+          if ((hciDrvCb.wlAddrType[i] == pCmd[0]) && BdaCmp(hciDrvCb.wlAddr[i], pCmd + 1))
+          {
+            hciDrvCb.wlNum--;
+            hciDrvCb.wlAddrType[i] = hciDrvCb.wlAddrType[hciDrvCb.wlNum];
+            BdaCpy(hciDrvCb.wlAddr[i], hciDrvCb.wlAddr[hciDrvCb.wlNum]);
+            break;
+          }
+        }
+      }
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    /* advertising */
+    case HCI_OPCODE_LE_SET_ADV_PARAM:
+      BSTREAM_TO_UINT16(hciDrvCb.advInterval, pCmd);
+      pCmd += 2;                  /* maximum interval */
+      BSTREAM_TO_UINT8(hciDrvCb.advType, pCmd);
+      BSTREAM_TO_UINT8(hciDrvCb.advOwnAddrType, pCmd);
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_SET_ADV_DATA:
+      hciDrvCb.advDataLen = (pCmd[0] < HCI_ADV_DATA_LEN) ? pCmd[0] : HCI_ADV_DATA_LEN;
+      memcpy(hciDrvCb.advData, pCmd + 1, hciDrvCb.advDataLen);
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_SET_SCAN_RESP_DATA:
+      hciDrvCb.scanRspLen = (pCmd[0] < HCI_SCAN_DATA_LEN) ? pCmd[0] : HCI_SCAN_DATA_LEN;
+      memcpy(hciDrvCb.scanRsp, pCmd + 1, hciDrvCb.scanRspLen);
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_SET_ADV_ENABLE:
+      hciDrvCb.advEnabled = pCmd[0];
+      if (hciDrvCb.advEnabled)
+      {
+        SimNodeAlarmStart(&hciDrvCb.advAlarm,
+                          SimNodeGetTime() + (hciDrvRand() % HCI_DRV_ADV_DELAY_US));
+      }
+      else
+      {
+        SimNodeAlarmStop(&hciDrvCb.advAlarm);
+      }
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    /* scanning */
+    case HCI_OPCODE_LE_SET_SCAN_PARAM:
+      hciDrvCb.scanType = pCmd[0];
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_SET_SCAN_ENABLE:
+      hciDrvCb.scanEnabled = pCmd[0];
+      hciDrvCb.filterDup = pCmd[1];
+      hciDrvCb.numDup = 0;
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    /* connection setup */
+    case HCI_OPCODE_LE_CREATE_CONN:
+      if (hciDrvCb.initiating)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_CMD_DISALLOWED);
+        break;
+      }
+      pCmd += 4;                  /* scan interval and window */
+      BSTREAM_TO_UINT8(hciDrvCb.initFilterPolicy, pCmd);
+      BSTREAM_TO_UINT8(hciDrvCb.initPeerAddrType, pCmd);
+      BSTREAM_TO_BDA(hciDrvCb.initPeerAddr, pCmd);
+      BSTREAM_TO_UINT8(hciDrvCb.initOwnAddrType, pCmd);
+      BSTREAM_TO_UINT16(hciDrvCb.initInterval, pCmd);
+      pCmd += 2;                  /* maximum interval */
+      BSTREAM_TO_UINT16(hciDrvCb.initLatency, pCmd);
+      BSTREAM_TO_UINT16(hciDrvCb.initSupTimeout, pCmd);
+      hciDrvCb.initiating = TRUE;
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+      break;
+
+    case HCI_OPCODE_LE_CREATE_CONN_CANCEL:
+      if (!hciDrvCb.initiating)
+      {
+        hciDrvCmdCmplStatus(opcode, HCI_ERR_CMD_DISALLOWED);
+        break;
+      }
+      hciDrvCb.initiating = FALSE;
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+
+      memset(buf, 0, HCI_LEN_LE_CONN_CMPL);
+      buf[0] = HCI_LE_CONN_CMPL_EVT;
+      buf[1] = HCI_ERR_UNKNOWN_HANDLE;
+      hciDrvEvt(0, HCI_LE_META_EVT, buf, HCI_LEN_LE_CONN_CMPL);
+      break;
+
+    /* connection procedures */
+    case HCI_OPCODE_DISCONNECT:
+      BYTES_TO_UINT16(handle, pCmd);
+      if (((pConn = hciDrvConnByHandle(handle)) == NULL) || pConn->terminating)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_UNKNOWN_HANDLE);
+        break;
+      }
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+      pConn->terminating = TRUE;
+      hciDrvCtrlTx(pConn, LL_PDU_TERMINATE_IND, pCmd + 2, 1);
+      hciDrvConnClose(pConn, pConn->txFree, HCI_ERR_LOCAL_TERMINATED);
+      break;
+
+    case HCI_OPCODE_LE_CONN_UPDATE:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_UNKNOWN_HANDLE);
+      }
+      else if ((pConn->role != HCI_ROLE_MASTER) || pConn->updAlarm.isStarted)
+      {
+        /* no connection parameters request procedure; slaves use L2CAP signaling */
+        hciDrvCmdStatus(opcode, HCI_ERR_CMD_DISALLOWED);
+      }
+      else
+      {
+        simTime_t instant;
+
+        hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+        pCmd += 2;
+        BSTREAM_TO_UINT16(pConn->updInterval, pCmd);
+        pCmd += 2;                /* maximum interval */
+        BSTREAM_TO_UINT16(pConn->updLatency, pCmd);
+        BSTREAM_TO_UINT16(pConn->updTimeout, pCmd);
+
+        instant = hciDrvConnEvent(pConn, SimNodeGetTime()) +
+                  LL_MIN_INSTANT * HCI_DRV_US_PER_1250(pConn->interval);
+
+        UINT16_TO_BSTREAM(p, pConn->updInterval);
+        UINT16_TO_BSTREAM(p, pConn->updLatency);
+        UINT16_TO_BSTREAM(p, pConn->updTimeout);
+        UINT64_TO_BSTREAM(p, instant);
+        hciDrvCtrlTx(pConn, LL_PDU_CONN_UPDATE_IND, buf, (uint8_t)(p - buf));
+
+        SimNodeAlarmStart(&pConn->updAlarm, instant);
+      }
+      break;
+
+    case HCI_OPCODE_LE_START_ENCRYPTION:
+      BYTES_TO_UINT16(handle, pCmd);
+      if (((pConn = hciDrvConnByHandle(handle)) == NULL) || (pConn->role != HCI_ROLE_MASTER))
+      {
+        hciDrvCmdStatus(opcode, (pConn == NULL) ? HCI_ERR_UNKNOWN_HANDLE : HCI_ERR_CMD_DISALLOWED);
+        break;
+      }
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+      /* random number, diversifier and key */
+      hciDrvCtrlTx(pConn, LL_PDU_ENC_REQ, pCmd + 2, LL_RAND_LEN + 2 + LL_KEY_LEN);
+      break;
+
+    case HCI_OPCODE_LE_LTK_REQ_REPL:
+    case HCI_OPCODE_LE_LTK_REQ_NEG_REPL:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdCmplHandle(opcode, HCI_ERR_UNKNOWN_HANDLE, handle);
+        break;
+      }
+      hciDrvCmdCmplHandle(opcode, HCI_SUCCESS, handle);
+
+      if (opcode == HCI_OPCODE_LE_LTK_REQ_NEG_REPL)
+      {
+        uint8_t reason = HCI_ERR_KEY_MISSING;
+
+        hciDrvCtrlTx(pConn, LL_PDU_REJECT_IND, &reason, 1);
+      }
+      else if (memcmp(pConn->ltk, pCmd + 2, LL_KEY_LEN) != 0)
+      {
+        /* the master would fail to decrypt the first encrypted PDU */
+        uint8_t reason = HCI_ERR_MIC_FAILURE;
+
+        pConn->terminating = TRUE;
+        hciDrvCtrlTx(pConn, LL_PDU_TERMINATE_IND, &reason, 1);
+        hciDrvConnClose(pConn, pConn->txFree, HCI_ERR_MIC_FAILURE);
+      }
+      else
+      {
+        bool_t refresh = pConn->encrypted;
+        simTime_t time = hciDrvCtrlTx(pConn, LL_PDU_START_ENC_RSP, NULL, 0);
+
+        pConn->encrypted = TRUE;
+
+        UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+        UINT16_TO_BSTREAM(p, handle);
+        if (refresh)
+        {
+          hciDrvEvt(time, HCI_ENC_KEY_REFRESH_CMPL_EVT, buf, 3);
+        }
+        else
+        {
+          UINT8_TO_BSTREAM(p, TRUE);
+          hciDrvEvt(time, HCI_ENC_CHANGE_EVT, buf, 4);
+        }
+      }
+      break;
+
+    case HCI_OPCODE_LE_SET_DATA_LEN:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdCmplHandle(opcode, HCI_ERR_UNKNOWN_HANDLE, handle);
+        break;
+      }
+      BYTES_TO_UINT16(pConn->localMaxTx, pCmd + 2);
+      hciDrvCmdCmplHandle(opcode, HCI_SUCCESS, handle);
+      hciDrvLengthTx(pConn, LL_PDU_LENGTH_REQ);
+      break;
+
+    case HCI_OPCODE_LE_READ_REMOTE_FEAT:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_UNKNOWN_HANDLE);
+        break;
+      }
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+      UINT32_TO_BSTREAM(p, hciDrvLeSupFeat());
+      UINT32_TO_BSTREAM(p, 0);
+      hciDrvCtrlTx(pConn, (pConn->role == HCI_ROLE_MASTER) ? LL_PDU_FEATURE_REQ :
+                                                             LL_PDU_SLV_FEATURE_REQ, buf, 8);
+      break;
+
+    case HCI_OPCODE_READ_REMOTE_VER_INFO:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_UNKNOWN_HANDLE);
+        break;
+      }
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+      pConn->versionReq = TRUE;
+      if (!pConn->versionSent)
+      {
+        hciDrvVersionTx(pConn);
+      }
+      break;
+
+    case HCI_OPCODE_LE_READ_PHY:
+      BYTES_TO_UINT16(handle, pCmd);
+      UINT8_TO_BSTREAM(p, (hciDrvConnByHandle(handle) != NULL) ? HCI_SUCCESS :
+                                                                 HCI_ERR_UNKNOWN_HANDLE);
+      UINT16_TO_BSTREAM(p, handle);
+      UINT8_TO_BSTREAM(p, HCI_DRV_PHY_LE_1M);
+      UINT8_TO_BSTREAM(p, HCI_DRV_PHY_LE_1M);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_SET_PHY:
+      BYTES_TO_UINT16(handle, pCmd);
+      if ((pConn = hciDrvConnByHandle(handle)) == NULL)
+      {
+        hciDrvCmdStatus(opcode, HCI_ERR_UNKNOWN_HANDLE);
+        break;
+      }
+      hciDrvCmdStatus(opcode, HCI_SUCCESS);
+
+      /* only LE 1M is supported; report the unchanged PHY after the exchange */
+      UINT8_TO_BSTREAM(p, HCI_LE_PHY_UPDATE_CMPL_EVT);
+      UINT8_TO_BSTREAM(p, HCI_SUCCESS);
+      UINT16_TO_BSTREAM(p, handle);
+      UINT8_TO_BSTREAM(p, HCI_DRV_PHY_LE_1M);
+      UINT8_TO_BSTREAM(p, HCI_DRV_PHY_LE_1M);
+      hciDrvEvt(hciDrvConnEvent(pConn, SimNodeGetTime()) + HCI_DRV_US_PER_1250(pConn->interval),
+                HCI_LE_META_EVT, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_READ_RSSI:
+      BYTES_TO_UINT16(handle, pCmd);
+      UINT8_TO_BSTREAM(p, (hciDrvConnByHandle(handle) != NULL) ? HCI_SUCCESS :
+                                                                 HCI_ERR_UNKNOWN_HANDLE);
+      UINT16_TO_BSTREAM(p, handle);
+      UINT8_TO_BSTREAM(p, (uint8_t) HCI_DRV_RSSI);
+      hciDrvCmdCmpl(opcode, buf, (uint8_t)(p - buf));
+      break;
+
+    case HCI_OPCODE_LE_REM_CONN_PARAM_REP:
+    case HCI_OPCODE_LE_REM_CONN_PARAM_NEG_REP:
+    case HCI_OPCODE_WRITE_AUTH_PAYLOAD_TO:
+      BYTES_TO_UINT16(handle, pCmd);
+      hciDrvCmdCmplHandle(opcode, HCI_ERR_CMD_DISALLOWED, handle);
+      break;
+
+    /* accepted without effect */
+    case HCI_OPCODE_SET_EVENT_MASK:
+    case HCI_OPCODE_LE_SET_EVENT_MASK:
+    case HCI_OPCODE_SET_EVENT_MASK_PAGE2:
+    case HCI_OPCODE_LE_SET_HOST_CHAN_CLASS:
+    case HCI_OPCODE_LE_SET_DEF_PHY:
+    case HCI_OPCODE_LE_CLEAR_RES_LIST:
+    case HCI_OPCODE_LE_SET_ADDR_RES_ENABLE:
+    case HCI_OPCODE_LE_SET_RES_PRIV_ADDR_TO:
+      hciDrvCmdCmplStatus(opcode, HCI_SUCCESS);
+      break;
+
+    default:
+      HCI_TRACE_WARN1("hciDrv unsupported opcode=0x%04x", opcode);
+      hciDrvCmdCmplStatus(opcode, HCI_ERR_UNKNOWN_CMD);
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write data the driver.
+ *
+ *  \param  type     HCI packet type
+ *  \param  len      Number of bytes to write.
+ *  \param  pData    Byte array to write.
+ *
+ *  \return Return actual number of data bytes written.
+ */
+/*************************************************************************************************/
+uint16_t hciDrvWrite(uint8_t type, uint16_t len, uint8_t *pData)
+{
+  uint64_t start = SimCpuNs();
+  uint64_t link = SimNodeGetLinkCpuNs();
+
+  if (type == HCI_CMD_TYPE)
+  {
+    hciDrvCmdRecv(pData);
+  }
+  else if (type == HCI_ACL_TYPE)
+  {
+    hciDrvAclRecv(pData, len);
+  }
+
+  /* time spent sending air PDUs is accounted to the link */
+  hciDrvCb.cpuNs += (SimCpuNs() - start) - (SimNodeGetLinkCpuNs() - link);
+
+  return len;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read data bytes from the driver.
+ *
+ *  \param  len      Number of bytes to read.
+ *  \param  pData    Byte array to store data.
+ *
+ *  \return Return actual number of data bytes read.
+ */
+/*************************************************************************************************/
+uint16_t hciDrvRead(uint16_t len, uint8_t *pData)
+{
+  /* the controller delivers packets to the host directly */
+  (void)len;
+  (void)pData;
+
+  return 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Returns TRUE if driver allows MCU to enter low power sleep mode.
+ *
+ *  \return TRUE if ready to sleep, FALSE otherwise.
+ */
+/*************************************************************************************************/
+bool_t hciDrvReadyToSleep(void)
+{
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the simulated controller of this node.  Call after SimNodeInit() and
+ *          before the HCI reset sequence.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void HciDrvSimInit(void)
+{
+  uint8_t nodeId = SimNodeGetId();
+  uint8_t i;
+
+  memset(&hciDrvCb, 0, sizeof(hciDrvCb));
+
+  /* locally administered public address derived from the node */
+  hciDrvCb.bdAddr[0] = nodeId + 1;
+  hciDrvCb.bdAddr[1] = 0x00;
+  hciDrvCb.bdAddr[2] = 0x5F;
+  hciDrvCb.bdAddr[3] = 0x3B;
+  hciDrvCb.bdAddr[4] = 0x18;
+  hciDrvCb.bdAddr[5] = 0x02;
+
+  hciDrvCb.seed = 0x2545F491 ^ ((uint32_t) nodeId * 0x9E3779B9);
+  hciDrvCb.nextHandle = 0x0001;
+  hciDrvCb.defTxOctets = LL_MAX_DATA_LEN_MIN;
+
+  for (i = 0; i < HCI_DRV_MAX_CONN; i++)
+  {
+    SimNodeAlarmInit(&hciDrvCb.conn[i].updAlarm, hciDrvConnUpdCback, &hciDrvCb.conn[i]);
+  }
+
+  SimNodeAlarmInit(&hciDrvCb.advAlarm, hciDrvAdvCback, NULL);
+  SimNodeAirRegister(hciDrvAirRecv);
+  uECC_set_rng(hciDrvEccRng);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time spent in the simulated controller, including its cryptography.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t HciDrvSimGetCpuNs(void)
+{
+  return hciDrvCb.cpuNs;
+}
@@ -0,0 +1,58 @@
+/*************************************************************************************************/
+/*!
+ *  \file   hci_drv_linux.h
+ *
+ *  \brief  HCI driver interface of the simulated controller.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+#ifndef HCI_DRV_LINUX_H
+#define HCI_DRV_LINUX_H
+
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the simulated controller of this node.  Call after SimNodeInit() and
+ *          before the HCI reset sequence.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void HciDrvSimInit(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time spent in the simulated controller, including its cryptography.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t HciDrvSimGetCpuNs(void);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* HCI_DRV_LINUX_H */
@@ -0,0 +1,583 @@
+/*************************************************************************************************/
+/*!
+ *  \file   wsf_nvm.c
+ *
+ *  \brief  NVM service.
+ *
+ *  Copyright (c) 2019 Arm Ltd.
+ *
+ *  Copyright (c) 2019 Packetcraft, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_trace.h"
+#include "wsf_nvm.h"
+#include "util/crc32.h"
+
+#include "ble_config.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! NVM data start address; addresses are offsets into the emulated flash. */
+#define WSF_NVM_START_ADDR                        0
+
+/*! NVM data end address. */
+#define WSF_NVM_END_ADDR                          (WSF_NVM_START_ADDR + \
+                                                   (WSF_NVM_NUM_OF_PAGES * WSF_NVM_PAGE_SIZE))
+
+/*! Flash programming word size. */
+#define WSF_NVM_WORD_SIZE                         4
+
+/*! Reserved filecode. */
+#define WSF_NVM_RESERVED_FILECODE                 ((uint32_t)0)
+
+/* Unused (erased) filecode. */
+#define WSF_NVM_UNUSED_FILECODE                   ((uint32_t)0xFFFFFFFF)
+
+/*! Align value to word boundary. */
+#define WSF_NVM_WORD_ALIGN(x)                     (((x) + (WSF_NVM_WORD_SIZE - 1)) & \
+                                                         ~(WSF_NVM_WORD_SIZE - 1))
+
+#define WSF_NVM_CRC_INIT_VALUE                    0xFEDCBA98
+
+/*! Storage is split into two banks; compaction copies the current records from one to the other. */
+#define WSF_NVM_BANK_PAGES                        (WSF_NVM_NUM_OF_PAGES / 2)
+
+/*! Bank size. */
+#define WSF_NVM_BANK_SIZE                         (WSF_NVM_BANK_PAGES * WSF_NVM_PAGE_SIZE)
+
+/*! Bank address. */
+#define WSF_NVM_BANK_ADDR(bank)                   (WSF_NVM_START_ADDR + ((bank) * WSF_NVM_BANK_SIZE))
+
+/*! Address of the first record of a bank. */
+#define WSF_NVM_RECORD_ADDR(bankAddr)             ((bankAddr) + sizeof(WsfNvmBankHeader_t))
+
+/*! Bank header magic, programmed once the bank holds a complete copy of the records. */
+#define WSF_NVM_BANK_MAGIC                        ((uint32_t)0x4E564D42)
+
+/*! Pointer to an address of the emulated flash. */
+#define WSF_NVM_PTR(addr)                         (&wsfNvmFlash[(addr)])
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief      Header. */
+typedef struct
+{
+  uint32_t          id;         /*!< Stored data ID. */
+  uint32_t          len;        /*!< Stored data length. */
+  uint32_t          headerCrc;  /*!< CRC of this header. */
+  uint32_t          dataCrc;    /*!< CRC of subsequent data. */
+} WsfNvmHeader_t;
+
+/*! \brief      Bank header. */
+typedef struct
+{
+  uint32_t          magic;      /*!< WSF_NVM_BANK_MAGIC on a complete bank. */
+  uint32_t          seq;        /*!< Compaction generation. */
+} WsfNvmBankHeader_t;
+
+WSF_CT_ASSERT((WSF_NVM_NUM_OF_PAGES >= 2) && ((WSF_NVM_NUM_OF_PAGES % 2) == 0));
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! Emulated flash; kept word aligned like the device flash. */
+static uint8_t wsfNvmFlash[WSF_NVM_NUM_OF_PAGES * WSF_NVM_PAGE_SIZE] __attribute__((aligned(WSF_NVM_WORD_SIZE)));
+
+/**************************************************************************************************
+  Local Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read the header at a storage address.
+ *
+ *  \param  storageAddr   Header address.
+ *  \param  bankAddr      Address of the bank holding the header.
+ *  \param  pHeader       Header read.
+ *
+ *  \return TRUE if the address holds a record, FALSE at the end of the used storage.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmReadHeader(uint32_t storageAddr, uint32_t bankAddr, WsfNvmHeader_t *pHeader)
+{
+  if ((storageAddr + sizeof(WsfNvmHeader_t)) > (bankAddr + WSF_NVM_BANK_SIZE))
+  {
+    return FALSE;
+  }
+
+  memcpy(pHeader, WSF_NVM_PTR(storageAddr), sizeof(WsfNvmHeader_t));
+
+  if (pHeader->id == WSF_NVM_UNUSED_FILECODE)
+  {
+    /* Found unused entry at end of used storage. */
+    return FALSE;
+  }
+
+  if ((pHeader->id != WSF_NVM_RESERVED_FILECODE) &&
+      (CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(pHeader->id) + sizeof(pHeader->len),
+                 (uint8_t *)pHeader) != pHeader->headerCrc))
+  {
+    /* Corrupt header, treat the rest of the bank as unusable until compacted. */
+    WSF_TRACE_WARN1("WsfNvm corrupt header at 0x%08x", storageAddr);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check that a storage range is still erased.
+ *
+ *  \param  storageAddr   Word aligned start address.
+ *  \param  len           Range length.
+ *
+ *  \return TRUE if every word of the range is erased.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmIsErased(uint32_t storageAddr, uint32_t len)
+{
+  uint32_t word;
+
+  for (len = WSF_NVM_WORD_ALIGN(len); len > 0; len -= WSF_NVM_WORD_SIZE, storageAddr += WSF_NVM_WORD_SIZE)
+  {
+    memcpy(&word, WSF_NVM_PTR(storageAddr), sizeof(word));
+    if (word != WSF_NVM_UNUSED_FILECODE)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Program data of any alignment and length into flash.
+ *
+ *  \param  storageAddr   Word aligned destination address.
+ *  \param  pData         Data to program.
+ *  \param  len           Data length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmProgram(uint32_t storageAddr, const uint8_t *pData, uint32_t len)
+{
+  uint8_t *pDst = WSF_NVM_PTR(storageAddr);
+
+  WSF_ASSERT((storageAddr + len) <= WSF_NVM_END_ADDR);
+
+  /* Programming can only clear bits, as on the device. */
+  while (len-- > 0)
+  {
+    *pDst++ &= *pData++;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase storage pages.
+ *
+ *  \param  eraseAddr     Address of the first page.
+ *  \param  numOfPages    Number of pages to erase.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmErasePages(uint32_t eraseAddr, uint32_t numOfPages)
+{
+  WSF_ASSERT((eraseAddr + (numOfPages * WSF_NVM_PAGE_SIZE)) <= WSF_NVM_END_ADDR);
+
+  memset(WSF_NVM_PTR(eraseAddr), 0xFF, numOfPages * WSF_NVM_PAGE_SIZE);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase a bank and mark it as holding the records of a compaction generation.
+ *
+ *  \param  bankAddr      Bank address.
+ *  \param  seq           Compaction generation.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmFormat(uint32_t bankAddr, uint32_t seq)
+{
+  WsfNvmBankHeader_t bank;
+
+  bank.magic = WSF_NVM_BANK_MAGIC;
+  bank.seq = seq;
+
+  wsfNvmErasePages(bankAddr, WSF_NVM_BANK_PAGES);
+  wsfNvmProgram(bankAddr, (const uint8_t *)&bank, sizeof(bank));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the bank holding the current records, formatting the storage if neither does.
+ *
+ *  A compaction writes the live records to the spare bank, marks it and only then erases the old
+ *  bank. A bank header is therefore only present on a complete copy; if a reset left both banks
+ *  marked, the newer generation is current.
+ *
+ *  \return Active bank address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmActiveBank(void)
+{
+  WsfNvmBankHeader_t bank0, bank1;
+  bool_t valid0, valid1;
+
+  memcpy(&bank0, WSF_NVM_PTR(WSF_NVM_BANK_ADDR(0)), sizeof(bank0));
+  memcpy(&bank1, WSF_NVM_PTR(WSF_NVM_BANK_ADDR(1)), sizeof(bank1));
+  valid0 = (bank0.magic == WSF_NVM_BANK_MAGIC);
+  valid1 = (bank1.magic == WSF_NVM_BANK_MAGIC);
+
+  if (valid0 && valid1)
+  {
+    return ((int32_t)(bank1.seq - bank0.seq) > 0) ? WSF_NVM_BANK_ADDR(1) : WSF_NVM_BANK_ADDR(0);
+  }
+
+  if (valid1)
+  {
+    return WSF_NVM_BANK_ADDR(1);
+  }
+
+  if (!valid0)
+  {
+    /* Blank storage. */
+    wsfNvmFormat(WSF_NVM_BANK_ADDR(0), 0);
+  }
+
+  return WSF_NVM_BANK_ADDR(0);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the address following the last record of a bank.
+ *
+ *  \param  bankAddr      Bank address.
+ *
+ *  \return Free storage address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmFreeAddr(uint32_t bankAddr)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return storageAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the current record of an ID.
+ *
+ *  A write appends the new record before it scratches out the old one, so after a reset both may
+ *  be present. The last copy whose data is intact is the current one.
+ *
+ *  \param  bankAddr      Bank address.
+ *  \param  id            Stored data ID.
+ *  \param  pHeader       Header of the record found.
+ *
+ *  \return Record address, or 0 if the ID is not stored.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmFind(uint32_t bankAddr, uint32_t id, WsfNvmHeader_t *pHeader)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  uint32_t foundAddr = 0;
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    if ((header.id == id) &&
+        (CalcCrc32(WSF_NVM_CRC_INIT_VALUE, header.len,
+                   WSF_NVM_PTR(storageAddr + sizeof(header))) == header.dataCrc))
+    {
+      *pHeader = header;
+      foundAddr = storageAddr;
+    }
+
+    /* Move to next stored data block and read header. */
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return foundAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Copy the current records to the spare bank and make it the active one.
+ *
+ *  The old bank is only erased once the spare bank holds a complete, marked copy, so a reset
+ *  at any point leaves one bank with every current record.
+ *
+ *  \param  bankAddr      Active bank address.
+ *
+ *  \return New active bank address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmCompact(uint32_t bankAddr)
+{
+  WsfNvmHeader_t header, current;
+  WsfNvmBankHeader_t bank;
+  uint32_t spareAddr = (bankAddr == WSF_NVM_BANK_ADDR(0)) ? WSF_NVM_BANK_ADDR(1) : WSF_NVM_BANK_ADDR(0);
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  uint32_t copyAddr = WSF_NVM_RECORD_ADDR(spareAddr);
+  uint32_t recordLen;
+
+  memcpy(&bank, WSF_NVM_PTR(bankAddr), sizeof(bank));
+
+  /* The spare bank may hold part of an interrupted copy. */
+  wsfNvmErasePages(spareAddr, WSF_NVM_BANK_PAGES);
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    recordLen = WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+
+    if ((header.id != WSF_NVM_RESERVED_FILECODE) &&
+        (wsfNvmFind(bankAddr, header.id, &current) == storageAddr))
+    {
+      wsfNvmProgram(copyAddr, WSF_NVM_PTR(storageAddr), recordLen);
+      copyAddr += recordLen;
+    }
+
+    storageAddr += recordLen;
+  }
+
+  /* Mark the copy complete, then retire the old bank. */
+  bank.magic = WSF_NVM_BANK_MAGIC;
+  bank.seq++;
+  wsfNvmProgram(spareAddr, (const uint8_t *)&bank, sizeof(bank));
+  wsfNvmErasePages(bankAddr, WSF_NVM_BANK_PAGES);
+
+  return spareAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Scratch out the records of an ID stored before an address.
+ *
+ *  \param  bankAddr  Bank address.
+ *  \param  id        Stored data ID.
+ *  \param  endAddr   Address of the first record to keep.
+ *
+ *  \return TRUE if a record was scratched out.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmScratch(uint32_t bankAddr, uint32_t id, uint32_t endAddr)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  bool_t erased = FALSE;
+
+  while ((storageAddr < endAddr) && wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    if (header.id == id)
+    {
+      /* Valid header and matching ID - scratch header out; programming can only clear bits. */
+      header.id = WSF_NVM_RESERVED_FILECODE;
+      header.headerCrc = 0;
+      header.dataCrc = 0;
+      wsfNvmProgram(storageAddr, (const uint8_t *)&header, sizeof(header));
+
+      erased = TRUE;
+    }
+
+    /* Move to next stored data block and read header. */
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return erased;
+}
+
+/**************************************************************************************************
+  Global Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the WSF NVM.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfNvmInit(void)
+{
+  /* The emulated flash starts out erased on every run. */
+  wsfNvmErasePages(WSF_NVM_START_ADDR, WSF_NVM_NUM_OF_PAGES);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read data.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  pData      Buffer to read to.
+ *  \param  len        Data length to read.
+ *  \param  compCback  Read callback.
+ *
+ *  \return if Read NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr;
+  bool_t findId = FALSE;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+
+  storageAddr = wsfNvmFind(wsfNvmActiveBank(), id, &header);
+  if ((storageAddr != 0) && (header.len == len))
+  {
+    memcpy(pData, WSF_NVM_PTR(storageAddr + sizeof(header)), header.len);
+    findId = TRUE;
+  }
+
+  if (compCback)
+  {
+    compCback(findId);
+  }
+  return findId;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Write data.
+ *
+ *  \param  id         Stored data ID.
+ *  \param  pData      Buffer to write.
+ *  \param  len        Data length to write.
+ *  \param  compCback  Write callback.
+ *
+ *  \return if write NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+  WsfNvmHeader_t header;
+  uint32_t bankAddr = wsfNvmActiveBank();
+  uint32_t storageAddr;
+  uint32_t recordLen = WSF_NVM_WORD_ALIGN(len) + sizeof(header);
+  bool_t written = FALSE;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+
+  /* Compact when the bank is full or ends in a record torn by a reset. */
+  storageAddr = wsfNvmFreeAddr(bankAddr);
+  if (((storageAddr + recordLen) > (bankAddr + WSF_NVM_BANK_SIZE)) ||
+      !wsfNvmIsErased(storageAddr, recordLen))
+  {
+    bankAddr = wsfNvmCompact(bankAddr);
+    storageAddr = wsfNvmFreeAddr(bankAddr);
+  }
+
+  if ((storageAddr + recordLen) <= (bankAddr + WSF_NVM_BANK_SIZE))
+  {
+    /* Create a new stored data header and store data */
+    header.id = id;
+    header.len = len;
+    header.headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
+                                 (uint8_t *)&header);
+    header.dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, len, pData);
+
+    wsfNvmProgram(storageAddr, (const uint8_t *)&header, sizeof(header));
+    wsfNvmProgram(storageAddr + sizeof(header), pData, len);
+
+    /* Scratch out the previous copy once the new one is in place. */
+    wsfNvmScratch(bankAddr, id, storageAddr);
+    written = TRUE;
+  }
+  else
+  {
+    WSF_TRACE_ERR1("WsfNvm full, id 0x%08x not written", id);
+  }
+
+  if (compCback)
+  {
+    compCback(written);
+  }
+  return written;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase data.
+ *
+ *  \param  id         Erase ID.
+ *  \param  compCback  Write callback.
+ *
+ *  \return if erase NVM successfully.
+ */
+/*************************************************************************************************/
+bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
+{
+  uint32_t bankAddr = wsfNvmActiveBank();
+  bool_t erased;
+
+  WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
+
+  erased = wsfNvmScratch(bankAddr, id, bankAddr + WSF_NVM_BANK_SIZE);
+
+  if (compCback)
+  {
+    compCback(erased);
+  }
+  return erased;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase sectors.
+ *
+ *  The storage is always cleared as a whole so that the bank headers stay consistent.
+ *
+ *  \param  numOfSectors       Number of sectors to be erased.
+ *  \param  compCback          Erase callback.
+ *
+ *  \return if erase NVM successfully.
+ */
+/*************************************************************************************************/
+void WsfNvmEraseSector(uint32_t numOfSectors, WsfNvmCompEvent_t compCback)
+{
+  if (numOfSectors > 0)
+  {
+    wsfNvmErasePages(WSF_NVM_BANK_ADDR(1), WSF_NVM_BANK_PAGES);
+    wsfNvmFormat(WSF_NVM_BANK_ADDR(0), 0);
+  }
+
+  if (compCback)
+  {
+    compCback(TRUE);
+  }
+}
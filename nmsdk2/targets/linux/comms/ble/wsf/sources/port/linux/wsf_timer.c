@@ -0,0 +1,410 @@
+/*************************************************************************************************/
+/*!
+ *  \file   wsf_timer.c
+ *
+ *  \brief  Timer service.
+ *
+ *  Copyright (c) 2009-2019 Arm Ltd.
+ *
+ *  Copyright (c) 2019 Packetcraft, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+#include <stdint.h>
+
+#include "wsf_types.h"
+#include "wsf_queue.h"
+#include "wsf_timer.h"
+#include "wsf_assert.h"
+#include "wsf_cs.h"
+#include "wsf_trace.h"
+
+#include "sim_api.h"
+
+#include "ble_config.h"
+
+#define CLOCK_PERIOD      WSF_OS_CLOCK_PERIOD
+
+/* convert seconds to timer ticks */
+#define WSF_TIMER_SEC_TO_TICKS(sec)         ((1000 / WSF_MS_PER_TICK) * (sec))
+
+/* convert milliseconds to timer ticks */
+#define WSF_TIMER_MS_TO_TICKS(ms)           ((ms) / WSF_MS_PER_TICK)
+
+#define CLK_TICKS_PER_WSF_TICKS             (WSF_MS_PER_TICK*CLOCK_PERIOD / 1000)
+
+/**************************************************************************************************
+  Global Variables
+**************************************************************************************************/
+
+wsfQueue_t  wsfTimerTimerQueue;     /*!< Timer queue */
+
+/*! \brief  Simulated clock value of the last whole WSF tick accounted for. */
+static simTime_t wsfTimerClkLastTicks = 0;
+
+/*! \brief  Wake up alarm; takes the place of the STIMER compare interrupt. */
+static simAlarm_t wsfTimerAlarm;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Wake up alarm callback.
+ *
+ *  \param  pContext  Unused.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerAlarmCback(void *pContext)
+{
+  (void)pContext;
+
+  WsfTaskSetReady(0, WSF_TIMER_EVENT);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Remove a timer from queue.  Note this function does not lock task scheduling.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerRemove(wsfTimer_t *pTimer)
+{
+  wsfTimer_t  *pElem;
+  wsfTimer_t  *pPrev = NULL;
+
+  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+
+  /* find timer in queue */
+  while (pElem != NULL)
+  {
+    if (pElem == pTimer)
+    {
+      break;
+    }
+    pPrev = pElem;
+    pElem = pElem->pNext;
+  }
+
+  /* if timer found remove from queue */
+  if (pElem != NULL)
+  {
+    WsfQueueRemove(&wsfTimerTimerQueue, pTimer, pPrev);
+
+    pTimer->isStarted = FALSE;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Insert a timer into the queue sorted by the timer expiration.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *  \param  ticks   Timer ticks until expiration.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerInsert(wsfTimer_t *pTimer, wsfTimerTicks_t ticks)
+{
+  wsfTimer_t  *pElem;
+  wsfTimer_t  *pPrev = NULL;
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  /* if timer is already running stop it first */
+  if (pTimer->isStarted)
+  {
+    wsfTimerRemove(pTimer);
+  }
+
+  pTimer->isStarted = TRUE;
+  pTimer->ticks = ticks;
+
+  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+
+  /* find insertion point in queue */
+  while (pElem != NULL)
+  {
+    if (pTimer->ticks < pElem->ticks)
+    {
+      break;
+    }
+    pPrev = pElem;
+    pElem = pElem->pNext;
+  }
+
+  /* insert timer into queue */
+  WsfQueueInsert(&wsfTimerTimerQueue, pTimer, pPrev);
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the timer service.  This function should only be called once
+ *          upon system initialization.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerInit(void)
+{
+  WSF_QUEUE_INIT(&wsfTimerTimerQueue);
+
+  SimNodeAlarmInit(&wsfTimerAlarm, wsfTimerAlarmCback, NULL);
+
+  wsfTimerClkLastTicks = SimNodeGetTime();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start a timer in units of seconds.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *  \param  sec     Seconds until expiration.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerStartSec(wsfTimer_t *pTimer, wsfTimerTicks_t sec)
+{
+  WSF_TRACE_INFO2("WsfTimerStartSec pTimer:0x%x ticks:%u", (uint32_t)(uintptr_t)pTimer, WSF_TIMER_SEC_TO_TICKS(sec));
+
+  /* insert timer into queue */
+  wsfTimerInsert(pTimer, WSF_TIMER_SEC_TO_TICKS(sec));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start a timer in units of milliseconds.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *  \param  ms     Milliseconds until expiration.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerStartMs(wsfTimer_t *pTimer, wsfTimerTicks_t ms)
+{
+  WSF_TRACE_INFO2("WsfTimerStartMs pTimer:0x%x ticks:%u", (uint32_t)(uintptr_t)pTimer, WSF_TIMER_MS_TO_TICKS(ms));
+
+  /* insert timer into queue */
+  wsfTimerInsert(pTimer, WSF_TIMER_MS_TO_TICKS(ms));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Stop a timer.
+ *
+ *  \param  pTimer  Pointer to timer.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerStop(wsfTimer_t *pTimer)
+{
+  WSF_TRACE_INFO1("WsfTimerStop pTimer:0x%x", (uint32_t)(uintptr_t)pTimer);
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  wsfTimerRemove(pTimer);
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Update the timer service with the number of elapsed ticks.
+ *
+ *  \param  ticks  Number of ticks since last update.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerUpdate(wsfTimerTicks_t ticks)
+{
+  wsfTimer_t  *pElem;
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead;
+
+  /* iterate over timer queue */
+  while (pElem != NULL)
+  {
+    /* decrement ticks while preventing underflow */
+    if (pElem->ticks > ticks)
+    {
+      pElem->ticks -= ticks;
+    }
+    else
+    {
+      pElem->ticks = 0;
+
+      /* timer expired; set task for this timer as ready */
+      WsfTaskSetReady(pElem->handlerId, WSF_TIMER_EVENT);
+    }
+
+    pElem = pElem->pNext;
+  }
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the number of ticks until the next timer expiration.  Note that this
+ *          function can return zero even if a timer is running, indicating a timer
+ *          has expired but has not yet been serviced.
+ *
+ *  \param  pTimerRunning   Returns TRUE if a timer is running, FALSE if no timers running.
+ *
+ *  \return The number of ticks until the next timer expiration.
+ */
+/*************************************************************************************************/
+wsfTimerTicks_t WsfTimerNextExpiration(bool_t *pTimerRunning)
+{
+  wsfTimerTicks_t ticks;
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  if (wsfTimerTimerQueue.pHead == NULL)
+  {
+    *pTimerRunning = FALSE;
+    ticks = 0;
+  }
+  else
+  {
+    *pTimerRunning = TRUE;
+    ticks = ((wsfTimer_t *) wsfTimerTimerQueue.pHead)->ticks;
+  }
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+
+  return ticks;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Service expired timers for the given task.
+ *
+ *  \param  taskId      Task ID.
+ *
+ *  \return Pointer to timer or NULL.
+ */
+/*************************************************************************************************/
+wsfTimer_t *WsfTimerServiceExpired(wsfTaskId_t taskId)
+{
+  wsfTimer_t  *pElem;
+  wsfTimer_t  *pPrev = NULL;
+
+  /* Unused parameters */
+  (void)taskId;
+
+  /* task schedule lock */
+  WsfTaskLock();
+
+  /* find expired timers in queue */
+  if (((pElem = (wsfTimer_t *) wsfTimerTimerQueue.pHead) != NULL) &&
+      (pElem->ticks == 0))
+  {
+    /* remove timer from queue */
+    WsfQueueRemove(&wsfTimerTimerQueue, pElem, pPrev);
+
+    pElem->isStarted = FALSE;
+
+    /* task schedule unlock */
+    WsfTaskUnlock();
+
+    WSF_TRACE_INFO1("Timer expired pTimer:0x%x", (uint32_t)(uintptr_t)pElem);
+
+    /* return timer */
+    return pElem;
+  }
+
+  /* task schedule unlock */
+  WsfTaskUnlock();
+
+  return NULL;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Function for checking if there is an active timer and if there is enough time to
+ *          go to sleep and going to sleep.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerSleep(void)
+{
+  wsfTimerTicks_t nextExpiration;
+  bool_t bTimerRunning;
+
+  nextExpiration = WsfTimerNextExpiration(&bTimerRunning);
+
+  if (nextExpiration > 0)
+  {
+    /* Expire on the tick boundary so elapsed whole ticks match the timer queue. */
+    SimNodeAlarmStart(&wsfTimerAlarm,
+                      wsfTimerClkLastTicks + (simTime_t)nextExpiration * CLK_TICKS_PER_WSF_TICKS);
+  }
+  else
+  {
+    SimNodeAlarmStop(&wsfTimerAlarm);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Function for updating WSF timer based on elapsed clock ticks.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void WsfTimerSleepUpdate(void)
+{
+  simTime_t       elapsed;
+  wsfTimerTicks_t wsfElapsed = 0;
+
+  /* Get current clock tick count. */
+  simTime_t current_ticks = SimNodeGetTime();
+
+  if (current_ticks != wsfTimerClkLastTicks)
+  {
+    elapsed = current_ticks - wsfTimerClkLastTicks;
+
+    wsfElapsed = (wsfTimerTicks_t)(elapsed / CLK_TICKS_PER_WSF_TICKS);
+
+    if (wsfElapsed)
+    {
+      /* update last ticks, keeping the partial tick for the next update */
+      wsfTimerClkLastTicks += (simTime_t)wsfElapsed * CLK_TICKS_PER_WSF_TICKS;
+
+      /* update wsf timers */
+      WsfTimerUpdate(wsfElapsed);
+    }
+  }
+}
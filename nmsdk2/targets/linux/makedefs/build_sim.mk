@@ -0,0 +1,40 @@
+SIM_DIR := ./sim
+
+VPATH += $(SIM_DIR)
+VPATH += $(SIM_DIR)/bench
+
+SIM_INC  = $(BLE_INC)
+SIM_INC += -I$(SIM_DIR)/bench
+
+SIM_SRC += sim_air.c
+SIM_SRC += sim_node.c
+SIM_SRC += bench_main.c
+SIM_SRC += bench_master.c
+SIM_SRC += bench_slave.c
+
+SIM_BIN := bench
+
+SIM_OBJS_DBG += $(SIM_SRC:%.c=$(BUILDDIR_DBG)/%.o)
+SIM_DEPS_DBG += $(SIM_SRC:%.c=$(BUILDDIR_DBG)/%.d)
+
+SIM_OBJS_REL += $(SIM_SRC:%.c=$(BUILDDIR_REL)/%.o)
+SIM_DEPS_REL += $(SIM_SRC:%.c=$(BUILDDIR_REL)/%.d)
+
+sim_dbg: $(BUILDDIR_DBG)/$(SIM_BIN)
+
+$(BUILDDIR_DBG)/$(SIM_BIN): $(SIM_OBJS_DBG) $(BUILDDIR_DBG)/$(BLE_LIB_DBG)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(SIM_OBJS_DBG): $(BUILDDIR_DBG)/%.o : %.c $(BLE_CONFIG)
+	$(CC) -c $(CFLAGS_DBG) $(BLE_DEFINES) $(SIM_INC) $< -o $@
+
+sim_rel: $(BUILDDIR_REL)/$(SIM_BIN)
+
+$(BUILDDIR_REL)/$(SIM_BIN): $(SIM_OBJS_REL) $(BUILDDIR_REL)/$(BLE_LIB_REL)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(SIM_OBJS_REL): $(BUILDDIR_REL)/%.o : %.c $(BLE_CONFIG)
+	$(CC) -c $(CFLAGS_REL) $(BLE_DEFINES) $(SIM_INC) $< -o $@
+
+-include $(SIM_DEPS_DBG)
+-include $(SIM_DEPS_REL)
@@ -0,0 +1,39 @@
+TOOLCHAIN ?=
+
+#### Required Executables ####
+SHELL     := /bin/bash
+CC   = $(TOOLCHAIN)gcc
+GCC  = $(TOOLCHAIN)gcc
+CPP  = $(TOOLCHAIN)cpp
+LD   = $(TOOLCHAIN)ld
+OD   = $(TOOLCHAIN)objdump
+RD   = $(TOOLCHAIN)readelf
+AR   = $(TOOLCHAIN)ar
+SIZE = $(TOOLCHAIN)size
+PYTHON = python
+
+SED   = sed
+MKDIR = mkdir
+CP    = cp
+RM    = rm
+
+DEFINES_DBG += -DWSF_TRACE_ENABLED=1
+DEFINES_DBG += -DWSF_ASSERT_ENABLED=1
+
+CFLAGS  = -ffunction-sections -fdata-sections
+CFLAGS += -MMD -MP -std=c99 -Wall
+CFLAGS += $(DEFINES)
+
+CFLAGS_DBG += $(CFLAGS)
+CFLAGS_DBG += $(DEFINES_DBG)
+CFLAGS_DBG += -g -O0
+
+CFLAGS_REL += $(CFLAGS)
+CFLAGS_REL += -O2
+
+LFLAGS  = -Wl,--gc-sections
+
+BUILDDIR_DBG := ./build/debug
+SUFFIX_DBG   := -dbg
+BUILDDIR_REL := ./build/release
+SUFFIX_REL   := -rel
@@ -0,0 +1,145 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host stack benchmark.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The benchmark runs a master and a slave node against each other on the simulated controller.
+ *  Each iteration the master scans, connects, pairs, discovers the GATT database, reads a file
+ *  from the slave over WDXS, has the slave stream data over an L2CAP connection oriented channel
+ *  and disconnects.  Both nodes account the simulated time and the host
+ *  CPU time of every step; CPU time spent in the simulated controller and in the simulation link
+ *  is excluded.
+ */
+/*************************************************************************************************/
+#ifndef BENCH_API_H
+#define BENCH_API_H
+
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Node IDs. */
+#define BENCH_NODE_MASTER         0
+#define BENCH_NODE_SLAVE          1
+#define BENCH_NUM_NODES           2
+
+/*! \brief  Benchmark steps. */
+enum
+{
+  BENCH_STEP_CONNECT,                     /*!< Advertising or scanning until connected. */
+  BENCH_STEP_PAIR,                        /*!< Connected until paired. */
+  BENCH_STEP_DISC,                        /*!< Paired until the GATT database is configured. */
+  BENCH_STEP_WDX,                         /*!< WDXS file get. */
+  BENCH_STEP_COC,                         /*!< Stream over an L2CAP connection oriented channel. */
+  BENCH_STEP_DISCONNECT,                  /*!< Disconnection. */
+  BENCH_STEP_MAX
+};
+
+/*! \brief  L2CAP channel of the stream, set up like the bulk data service of the tag. */
+#define BENCH_COC_PSM             0x0080
+#define BENCH_COC_MPS             247
+#define BENCH_COC_MTU             1024
+#define BENCH_COC_CREDITS         8
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Benchmark configuration. */
+typedef struct
+{
+  uint16_t      iterations;               /*!< Number of iterations. */
+  uint32_t      fileLen;                  /*!< Length of the file read over WDXS. */
+  uint32_t      cocLen;                   /*!< Length of the L2CAP stream, zero to skip it. */
+  bool_t        legacy;                   /*!< TRUE for LE legacy pairing. */
+  bool_t        trace;                    /*!< TRUE to print stack traces. */
+} benchCfg_t;
+
+/**************************************************************************************************
+  Global Variables
+**************************************************************************************************/
+
+/*! \brief  Benchmark configuration. */
+extern benchCfg_t benchCfg;
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Mark the start of a step.
+ *
+ *  \param  step      Benchmark step.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchStepStart(uint8_t step);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Mark the end of a step.  Ignored when the step was not started.
+ *
+ *  \param  step      Benchmark step.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchStepEnd(uint8_t step);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Record a failed check.  The node exits with an error at the end of the simulation.
+ *
+ *  \param  pReason   What went wrong.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchError(const char *pReason);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the stack and application of the master node.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchMasterStart(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the stack and application of the slave node.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchSlaveStart(void);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* BENCH_API_H */
@@ -0,0 +1,430 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host stack benchmark entry point.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "wsf_types.h"
+#include "wsf_os.h"
+#include "wsf_buf.h"
+#include "wsf_heap.h"
+#include "wsf_timer.h"
+#include "wsf_trace.h"
+#include "sim_api.h"
+#include "hci_drv_linux.h"
+#include "bench_api.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Simulated time allowed per iteration in microseconds. */
+#define BENCH_ITER_TIME_LIMIT     (60 * 1000000ULL)
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Step statistics. */
+typedef struct
+{
+  uint32_t      count;                    /*!< Number of completed runs. */
+  simTime_t     simUs;                    /*!< Total simulated time. */
+  uint64_t      cpuNs;                    /*!< Total host CPU time. */
+  simTime_t     startTime;                /*!< Simulated time at the start of the current run. */
+  uint64_t      startCpu;                 /*!< Host CPU time at the start of the current run. */
+  bool_t        active;                   /*!< TRUE while a run is in progress. */
+} benchStep_t;
+
+/**************************************************************************************************
+  Global Variables
+**************************************************************************************************/
+
+/*! \brief  Benchmark configuration. */
+benchCfg_t benchCfg =
+{
+  10,                                     /*!< Iterations */
+  16384,                                  /*!< WDXS file length */
+  65536,                                  /*!< L2CAP stream length */
+  FALSE,                                  /*!< LE secure connections pairing */
+  FALSE                                   /*!< Trace disabled */
+};
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief  Pool runtime configuration; the second largest pool holds an ACL packet or an ATT
+ *          event with a full MTU value, the largest a full L2CAP channel SDU. */
+static wsfBufPoolDesc_t benchPoolDesc[] =
+{
+  { 16,              16 },
+  { 32,              16 },
+  { 80,               8 },
+  { 192,              8 },
+  { 352,             16 },
+  { 1056,             4 }
+};
+
+/*! \brief  Step names. */
+static const char *benchStepName[BENCH_STEP_MAX] =
+{
+  "connect",
+  "pair",
+  "discovery",
+  "wdx get",
+  "l2cap coc",
+  "disconnect"
+};
+
+/*! \brief  Step statistics of this node. */
+static benchStep_t benchStep[BENCH_STEP_MAX];
+
+/*! \brief  Number of failed checks on this node. */
+static uint32_t benchErrors;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time spent in the host stack and application of this node.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+static uint64_t benchHostCpuNs(void)
+{
+  return SimCpuNs() - SimNodeGetLinkCpuNs() - HciDrvSimGetCpuNs();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Mark the start of a step.
+ *
+ *  \param  step      Benchmark step.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchStepStart(uint8_t step)
+{
+  benchStep[step].startTime = SimNodeGetTime();
+  benchStep[step].startCpu = benchHostCpuNs();
+  benchStep[step].active = TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Mark the end of a step.  Ignored when the step was not started.
+ *
+ *  \param  step      Benchmark step.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchStepEnd(uint8_t step)
+{
+  benchStep_t *pStep = &benchStep[step];
+
+  if (pStep->active)
+  {
+    pStep->simUs += SimNodeGetTime() - pStep->startTime;
+    pStep->cpuNs += benchHostCpuNs() - pStep->startCpu;
+    pStep->count++;
+    pStep->active = FALSE;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Record a failed check.  The node exits with an error at the end of the simulation.
+ *
+ *  \param  pReason   What went wrong.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchError(const char *pReason)
+{
+  fprintf(stderr, "bench: node %u at %.3f ms: %s\n", SimNodeGetId(), SimNodeGetTime() / 1000.0,
+          pReason);
+  benchErrors++;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Trace output of a node.
+ *
+ *  \param  pBuf      Message.
+ *  \param  len       Message length.
+ *
+ *  \return TRUE, messages are never dropped.
+ */
+/*************************************************************************************************/
+static bool_t benchTraceWrite(const uint8_t *pBuf, uint32_t len)
+{
+  fprintf(stderr, "%10.3f [%u] %.*s", SimNodeGetTime() / 1000.0, SimNodeGetId(), (int) len,
+          (const char *) pBuf);
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Print the step statistics of this node.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchReport(void)
+{
+  char buf[1024];
+  int len;
+  uint8_t i;
+
+  len = snprintf(buf, sizeof(buf), "%s%-10s %6s %14s %14s\n",
+                 (SimNodeGetId() == BENCH_NODE_MASTER) ? "master\n" : "slave\n",
+                 "step", "runs", "sim ms/run", "cpu us/run");
+
+  for (i = 0; i < BENCH_STEP_MAX; i++)
+  {
+    if (benchStep[i].count == 0)
+    {
+      continue;
+    }
+
+    len += snprintf(buf + len, sizeof(buf) - len, "%-10s %6u %14.3f %14.1f\n",
+                    benchStepName[i], benchStep[i].count,
+                    benchStep[i].simUs / 1000.0 / benchStep[i].count,
+                    benchStep[i].cpuNs / 1000.0 / benchStep[i].count);
+  }
+
+  len += snprintf(buf + len, sizeof(buf) - len, "%-10s %6s %14.3f %14.1f\n", "total", "",
+                  SimNodeGetTime() / 1000.0, benchHostCpuNs() / 1000.0);
+
+  if (benchStep[BENCH_STEP_COC].simUs)
+  {
+    len += snprintf(buf + len, sizeof(buf) - len, "%-10s %6s %14.1f\n", "coc kB/s", "",
+                    (double) benchCfg.cocLen * benchStep[BENCH_STEP_COC].count * 1000000.0 /
+                    1024.0 / benchStep[BENCH_STEP_COC].simUs);
+  }
+
+  len += snprintf(buf + len, sizeof(buf) - len, "\n");
+
+  /* one write keeps the reports of the nodes apart */
+  (void) write(STDOUT_FILENO, buf, len);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run a node until the coordinator stops the simulation.
+ *
+ *  \param  fd        Socket connected to the coordinator.
+ *  \param  nodeId    Node ID.
+ *
+ *  \return Exit status.
+ */
+/*************************************************************************************************/
+static int benchNodeRun(int fd, uint8_t nodeId)
+{
+  uint32_t memUsed;
+
+  SimNodeInit(fd, nodeId);
+  HciDrvSimInit();
+
+  WsfOsInit();
+  memUsed = WsfBufInit(sizeof(benchPoolDesc) / sizeof(benchPoolDesc[0]), benchPoolDesc);
+  WsfHeapAlloc(memUsed);
+  WsfTimerInit();
+
+#if WSF_TRACE_ENABLED == TRUE
+  WsfTraceRegisterHandler(benchTraceWrite);
+  WsfTraceEnable(benchCfg.trace);
+#else
+  (void) benchTraceWrite;
+#endif
+
+  if (nodeId == BENCH_NODE_MASTER)
+  {
+    BenchMasterStart();
+  }
+  else
+  {
+    BenchSlaveStart();
+  }
+
+  for (;;)
+  {
+    wsfOsDispatcher();
+
+    if (wsfOsReadyToSleep() && !SimNodeWait())
+    {
+      break;
+    }
+  }
+
+  benchReport();
+
+  return (benchErrors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Print the command line usage.
+ *
+ *  \param  pName     Program name.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchUsage(const char *pName)
+{
+  fprintf(stderr, "usage: %s [-n iterations] [-f file length] [-c stream length] [-l] [-v]\n"
+                  "  -n  number of iterations (default %u)\n"
+                  "  -f  length of the file read over WDXS (default %u)\n"
+                  "  -c  length of the stream over an L2CAP channel, 0 to skip (default %u)\n"
+                  "  -l  use LE legacy pairing instead of LE secure connections\n"
+                  "  -v  print stack traces to stderr\n",
+          pName, benchCfg.iterations, benchCfg.fileLen, benchCfg.cocLen);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Entry point.  Forks one process per node and coordinates them.
+ *
+ *  \param  argc      Argument count.
+ *  \param  argv      Arguments.
+ *
+ *  \return Exit status.
+ */
+/*************************************************************************************************/
+int main(int argc, char **argv)
+{
+  int sv[BENCH_NUM_NODES][2];
+  int fd[BENCH_NUM_NODES];
+  pid_t pid[BENCH_NUM_NODES];
+  simTime_t end;
+  int status;
+  int result = EXIT_SUCCESS;
+  int opt;
+  uint8_t i, j;
+
+  while ((opt = getopt(argc, argv, "n:f:c:lvh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        benchCfg.iterations = (uint16_t) strtoul(optarg, NULL, 0);
+        break;
+
+      case 'f':
+        benchCfg.fileLen = (uint32_t) strtoul(optarg, NULL, 0);
+        break;
+
+      case 'c':
+        benchCfg.cocLen = (uint32_t) strtoul(optarg, NULL, 0);
+        break;
+
+      case 'l':
+        benchCfg.legacy = TRUE;
+        break;
+
+      case 'v':
+        benchCfg.trace = TRUE;
+        break;
+
+      default:
+        benchUsage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  if (benchCfg.iterations == 0)
+  {
+    benchUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  /* reports are written by the nodes */
+  fflush(stdout);
+
+  for (i = 0; i < BENCH_NUM_NODES; i++)
+  {
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv[i]) < 0)
+    {
+      perror("socketpair");
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (i = 0; i < BENCH_NUM_NODES; i++)
+  {
+    if ((pid[i] = fork()) < 0)
+    {
+      perror("fork");
+      return EXIT_FAILURE;
+    }
+
+    if (pid[i] == 0)
+    {
+      for (j = 0; j < BENCH_NUM_NODES; j++)
+      {
+        close(sv[j][0]);
+        if (j != i)
+        {
+          close(sv[j][1]);
+        }
+      }
+
+      exit(benchNodeRun(sv[i][1], i));
+    }
+
+    close(sv[i][1]);
+    fd[i] = sv[i][0];
+  }
+
+  end = SimAirRun(fd, BENCH_NUM_NODES, benchCfg.iterations * BENCH_ITER_TIME_LIMIT);
+
+  for (i = 0; i < BENCH_NUM_NODES; i++)
+  {
+    if ((waitpid(pid[i], &status, 0) < 0) || !WIFEXITED(status) ||
+        (WEXITSTATUS(status) != EXIT_SUCCESS))
+    {
+      fprintf(stderr, "bench: node %u failed\n", i);
+      result = EXIT_FAILURE;
+    }
+
+    close(fd[i]);
+  }
+
+  if (end == SIM_TIME_NEVER)
+  {
+    fprintf(stderr, "bench: did not complete %u iterations\n", benchCfg.iterations);
+    result = EXIT_FAILURE;
+  }
+
+  return result;
+}
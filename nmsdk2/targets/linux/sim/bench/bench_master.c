@@ -0,0 +1,799 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host stack benchmark master node.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The master follows the data collector sample application: it scans for the slave, connects,
+ *  pairs, discovers and configures the GATT database, then reads the benchmark file over WDXC.
+ *  It then opens an L2CAP connection oriented channel to the slave, checks every byte the slave
+ *  streams over it and disconnects.  Nothing is bonded so every iteration starts from scratch.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include "wsf_types.h"
+#include "wsf_os.h"
+#include "wsf_msg.h"
+#include "wsf_trace.h"
+#include "wsf_assert.h"
+#include "wsf_efs.h"
+#include "util/bstream.h"
+#include "hci_handler.h"
+#include "dm_handler.h"
+#include "l2c_handler.h"
+#include "att_handler.h"
+#include "smp_handler.h"
+#include "ll_defs.h"
+#include "hci_api.h"
+#include "sec_api.h"
+#include "dm_api.h"
+#include "l2c_api.h"
+#include "smp_api.h"
+#include "att_api.h"
+#include "app_api.h"
+#include "app_cfg.h"
+#include "app_ui.h"
+#include "svc_core.h"
+#include "svc_ch.h"
+#include "gap/gap_api.h"
+#include "gatt/gatt_api.h"
+#include "wdx_defs.h"
+#include "wdxc/wdxc_api.h"
+#include "sim_api.h"
+#include "bench_api.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Maximum number of files in the WDXS file listing. */
+#define BENCH_MASTER_MAX_FILES    4
+
+/**************************************************************************************************
+  Configurable Parameters
+**************************************************************************************************/
+
+/*! \brief  Configurable parameters for master; scan until the slave is found. */
+static const appMasterCfg_t benchMasterCfg =
+{
+  96,                                     /*!< The scan interval, in 0.625 ms units */
+  48,                                     /*!< The scan window, in 0.625 ms units  */
+  0,                                      /*!< The scan duration in ms */
+  DM_DISC_MODE_NONE,                      /*!< The GAP discovery mode */
+  DM_SCAN_TYPE_ACTIVE                     /*!< The scan type (active or passive) */
+};
+
+/*! \brief  Security configuration; nothing is bonded so every iteration pairs again. */
+static appSecCfg_t benchMasterSecCfg =
+{
+  DM_AUTH_SC_FLAG,                        /*!< Authentication and bonding flags */
+  0,                                      /*!< Initiator key distribution flags */
+  0,                                      /*!< Responder key distribution flags */
+  FALSE,                                  /*!< TRUE if Out-of-band pairing data is present */
+  TRUE                                    /*!< TRUE to initiate security upon connection */
+};
+
+/*! \brief  SMP security parameter configuration. */
+static const smpCfg_t benchMasterSmpCfg =
+{
+  500,                                    /*!< 'Repeated attempts' timeout in msec */
+  SMP_IO_NO_IN_NO_OUT,                    /*!< I/O Capability */
+  7,                                      /*!< Minimum encryption key length */
+  16,                                     /*!< Maximum encryption key length */
+  1,                                      /*!< Attempts to trigger 'repeated attempts' timeout */
+  0,                                      /*!< Device authentication requirements */
+  64000,                                  /*!< Maximum repeated attempts timeout in msec */
+  64000,                                  /*!< Time msec before attemptExp decreases */
+  2                                       /*!< Repeated attempts multiplier exponent */
+};
+
+/*! \brief  Connection parameters. */
+static const hciConnSpec_t benchMasterConnCfg =
+{
+  12,                                     /*!< Minimum connection interval in 1.25ms units */
+  12,                                     /*!< Maximum connection interval in 1.25ms units */
+  0,                                      /*!< Connection latency */
+  600,                                    /*!< Supervision timeout in 10ms units */
+  0,                                      /*!< Unused */
+  0                                       /*!< Unused */
+};
+
+/*! \brief  Configurable parameters for service and characteristic discovery. */
+static const appDiscCfg_t benchMasterDiscCfg =
+{
+  TRUE,                                   /*!< TRUE to wait for a secure connection before initiating discovery */
+  FALSE                                   /*!< TRUE to fall back on database hash to verify handles when no bond exists. */
+};
+
+/*! \brief  Application configuration. */
+static const appCfg_t benchMasterAppCfg =
+{
+  FALSE,                                  /*!< TRUE to abort service discovery if service not found */
+  TRUE                                    /*!< TRUE to disconnect if ATT transaction times out */
+};
+
+/*! \brief  ATT configurable parameters (increase MTU). */
+static const attCfg_t benchMasterAttCfg =
+{
+  15,                                     /*!< ATT server service discovery connection idle timeout in seconds */
+  241,                                    /*!< desired ATT MTU */
+  ATT_MAX_TRANS_TIMEOUT,                  /*!< transcation timeout in seconds */
+  4                                       /*!< number of queued prepare writes supported by server */
+};
+
+/**************************************************************************************************
+  ATT Client Discovery Data
+**************************************************************************************************/
+
+/*! \brief  Discovery states:  enumeration of services to be discovered. */
+enum
+{
+  BENCH_MASTER_DISC_GATT_SVC,             /*!< GATT service */
+  BENCH_MASTER_DISC_GAP_SVC,              /*!< GAP service */
+  BENCH_MASTER_DISC_WDXC_SVC,             /*!< Arm Ltd. Wireless Data Exchange service */
+  BENCH_MASTER_DISC_SVC_MAX               /*!< Discovery complete */
+};
+
+/*! \brief  Start of each service's handles in the the handle list. */
+#define BENCH_MASTER_DISC_GATT_START    0
+#define BENCH_MASTER_DISC_GAP_START     (BENCH_MASTER_DISC_GATT_START + GATT_HDL_LIST_LEN)
+#define BENCH_MASTER_DISC_WDXC_START    (BENCH_MASTER_DISC_GAP_START + GAP_HDL_LIST_LEN)
+#define BENCH_MASTER_DISC_HDL_LIST_LEN  (BENCH_MASTER_DISC_WDXC_START + WDXC_HDL_LIST_LEN)
+
+/*! \brief  Default value for CCC indications. */
+static const uint8_t benchMasterCccIndVal[2] = {UINT16_TO_BYTES(ATT_CLIENT_CFG_INDICATE)};
+
+/*! \brief  Default value for CCC notifications. */
+static const uint8_t benchMasterCccNtfVal[2] = {UINT16_TO_BYTES(ATT_CLIENT_CFG_NOTIFY)};
+
+/*! \brief  List of characteristics to configure after service discovery. */
+static const attcDiscCfg_t benchMasterDiscCfgList[] =
+{
+  /* Write:  GATT service changed ccc descriptor */
+  {benchMasterCccIndVal, sizeof(benchMasterCccIndVal),
+   (GATT_SC_CCC_HDL_IDX + BENCH_MASTER_DISC_GATT_START)},
+
+  /* Write:  WDXC ccc descriptors */
+  {benchMasterCccNtfVal, sizeof(benchMasterCccNtfVal),
+   (WDXC_DC_CCC_HDL_IDX + BENCH_MASTER_DISC_WDXC_START)},
+  {benchMasterCccNtfVal, sizeof(benchMasterCccNtfVal),
+   (WDXC_FTC_CCC_HDL_IDX + BENCH_MASTER_DISC_WDXC_START)},
+  {benchMasterCccNtfVal, sizeof(benchMasterCccNtfVal),
+   (WDXC_FTD_CCC_HDL_IDX + BENCH_MASTER_DISC_WDXC_START)},
+  {benchMasterCccNtfVal, sizeof(benchMasterCccNtfVal),
+   (WDXC_AU_CCC_HDL_IDX + BENCH_MASTER_DISC_WDXC_START)}
+};
+
+/*! \brief  Characteristic configuration list length. */
+#define BENCH_MASTER_DISC_CFG_LIST_LEN  (sizeof(benchMasterDiscCfgList) / sizeof(attcDiscCfg_t))
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief  Application control block. */
+static struct
+{
+  uint16_t          hdlList[BENCH_MASTER_DISC_HDL_LIST_LEN];  /*!< Cached handle list */
+  wsfEfsFileInfo_t  fileList[BENCH_MASTER_MAX_FILES];         /*!< WDXS file listing */
+  wsfHandlerId_t    handlerId;            /*!< WSF handler ID */
+  uint16_t          iteration;            /*!< Number of completed iterations */
+  uint32_t          rxLen;                /*!< Number of file bytes received */
+  uint32_t          cocRxLen;             /*!< Number of stream bytes received */
+  uint16_t          cocCid;               /*!< Channel of the stream */
+  l2cCocRegId_t     cocRegId;             /*!< Channel registration */
+  uint16_t          fileHdl;              /*!< Handle of the benchmark file */
+  uint8_t           discState;            /*!< Service discovery state */
+  bool_t            doConnect;            /*!< TRUE to connect on scan stop */
+  uint8_t           addrType;             /*!< Address type of the slave */
+  bdAddr_t          addr;                 /*!< Address of the slave */
+} benchMasterCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start scanning for the slave.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterScanStart(void)
+{
+  BenchStepStart(BENCH_STEP_CONNECT);
+
+  benchMasterCb.doConnect = FALSE;
+  AppScanStart(benchMasterCfg.discMode, benchMasterCfg.scanType, benchMasterCfg.scanDuration);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Application DM callback.
+ *
+ *  \param  pDmEvt  DM callback event
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterDmCback(dmEvt_t *pDmEvt)
+{
+  dmEvt_t   *pMsg;
+  uint16_t  len;
+  uint16_t  reportLen;
+
+  if (pDmEvt->hdr.event == DM_SEC_ECC_KEY_IND)
+  {
+    DmSecSetEccKey(&pDmEvt->eccMsg.data.key);
+  }
+  else
+  {
+    len = DmSizeOfEvt(pDmEvt);
+
+    if (pDmEvt->hdr.event == DM_SCAN_REPORT_IND)
+    {
+      reportLen = pDmEvt->scanReport.len;
+    }
+    else
+    {
+      reportLen = 0;
+    }
+
+    if ((pMsg = WsfMsgAlloc(len + reportLen)) != NULL)
+    {
+      memcpy(pMsg, pDmEvt, len);
+      if (pDmEvt->hdr.event == DM_SCAN_REPORT_IND)
+      {
+        pMsg->scanReport.pData = (uint8_t *) ((uint8_t *) pMsg + len);
+        memcpy(pMsg->scanReport.pData, pDmEvt->scanReport.pData, reportLen);
+      }
+      WsfMsgSend(benchMasterCb.handlerId, pMsg);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Application ATT callback.
+ *
+ *  \param  pEvt    ATT callback event
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterAttCback(attEvt_t *pEvt)
+{
+  attEvt_t *pMsg;
+
+  if ((pMsg = WsfMsgAlloc(sizeof(attEvt_t) + pEvt->valueLen)) != NULL)
+  {
+    memcpy(pMsg, pEvt, sizeof(attEvt_t));
+    pMsg->pValue = (uint8_t *) (pMsg + 1);
+    memcpy(pMsg->pValue, pEvt->pValue, pEvt->valueLen);
+    WsfMsgSend(benchMasterCb.handlerId, pMsg);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Handle a scan report.
+ *
+ *  \param  pMsg    Pointer to DM callback event message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterScanReport(dmEvt_t *pMsg)
+{
+  uint8_t *pData;
+
+  if (benchMasterCb.doConnect)
+  {
+    return;
+  }
+
+  /* find vendor-specific advertising data */
+  if ((pData = DmFindAdType(DM_ADV_TYPE_MANUFACTURER, pMsg->scanReport.len,
+                            pMsg->scanReport.pData)) != NULL)
+  {
+    /* check length and vendor ID */
+    if (pData[DM_AD_LEN_IDX] >= 3 && BYTES_UINT16_CMP(&pData[DM_AD_DATA_IDX], HCI_ID_ARM))
+    {
+      /* stop scanning and connect on scan stop */
+      AppScanStop();
+
+      benchMasterCb.addrType = DmHostAddrType(pMsg->scanReport.addrType);
+      memcpy(benchMasterCb.addr, pMsg->scanReport.addr, sizeof(bdAddr_t));
+      benchMasterCb.doConnect = TRUE;
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Open the stream channel, or disconnect if there is no stream.
+ *
+ *  \param  connId    Connection ID.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterCocStart(dmConnId_t connId)
+{
+  if (benchCfg.cocLen == 0)
+  {
+    BenchStepStart(BENCH_STEP_DISCONNECT);
+    AppConnClose(connId);
+    return;
+  }
+
+  BenchStepStart(BENCH_STEP_COC);
+  benchMasterCb.cocRxLen = 0;
+  benchMasterCb.cocCid = L2cCocConnectReq(connId, benchMasterCb.cocRegId, BENCH_COC_PSM);
+  if (benchMasterCb.cocCid == L2C_COC_CID_NONE)
+  {
+    BenchError("l2cap coc connect request failed");
+    AppConnClose(connId);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check received stream data against the pattern sent by the slave.
+ *
+ *  \param  connId    Connection ID.
+ *  \param  len       length of pData in bytes.
+ *  \param  pData     Stream data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterCocData(dmConnId_t connId, uint16_t len, uint8_t *pData)
+{
+  uint16_t i;
+
+  if (benchMasterCb.cocRxLen + len > benchCfg.cocLen)
+  {
+    BenchError("l2cap coc stream too long");
+    AppConnClose(connId);
+    return;
+  }
+
+  for (i = 0; i < len; i++)
+  {
+    if (pData[i] != (uint8_t) (benchMasterCb.cocRxLen + i))
+    {
+      BenchError("l2cap coc stream corrupted");
+      AppConnClose(connId);
+      return;
+    }
+  }
+
+  benchMasterCb.cocRxLen += len;
+  if (benchMasterCb.cocRxLen == benchCfg.cocLen)
+  {
+    BenchStepEnd(BENCH_STEP_COC);
+    BenchStepStart(BENCH_STEP_DISCONNECT);
+    AppConnClose(connId);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  L2CAP connection oriented channel callback.
+ *
+ *  \param  pMsg    Channel event.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterCocCback(l2cCocEvt_t *pMsg)
+{
+  switch (pMsg->hdr.event)
+  {
+    case L2C_COC_DATA_IND:
+      if (pMsg->dataInd.cid == benchMasterCb.cocCid)
+      {
+        benchMasterCocData((dmConnId_t) pMsg->hdr.param, pMsg->dataInd.dataLen,
+                           pMsg->dataInd.pData);
+      }
+      break;
+
+    case L2C_COC_DISCONNECT_IND:
+      if (pMsg->disconnectInd.cid != benchMasterCb.cocCid)
+      {
+        break;
+      }
+
+      /* the channel only goes down early when it was refused or the link was lost */
+      benchMasterCb.cocCid = L2C_COC_CID_NONE;
+      if (benchMasterCb.cocRxLen < benchCfg.cocLen)
+      {
+        BenchError("l2cap coc channel closed early");
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the initiator of the stream channel.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterCocInit(void)
+{
+  l2cCocReg_t reg;
+
+  reg.psm = 0;
+  reg.mps = BENCH_COC_MPS;
+  reg.mtu = BENCH_COC_MTU;
+  reg.credits = BENCH_COC_CREDITS;
+  reg.authoriz = FALSE;
+  reg.secLevel = DM_SEC_LEVEL_NONE;
+  reg.role = L2C_COC_ROLE_INITIATOR;
+
+  benchMasterCb.cocCid = L2C_COC_CID_NONE;
+  benchMasterCb.cocRegId = L2cCocRegister(benchMasterCocCback, &reg);
+  WSF_ASSERT(benchMasterCb.cocRegId != L2C_COC_REG_ID_NONE);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WDXC file transfer data callback.
+ *
+ *  \param  connId    Connection ID.
+ *  \param  handle    Handle of the file.
+ *  \param  len       length of pData in bytes.
+ *  \param  pData     File data.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterFtdCback(dmConnId_t connId, uint16_t handle, uint16_t len, uint8_t *pData)
+{
+  benchMasterCb.rxLen += len;
+
+  /* WDXS only sends EOF when the request runs past the end of the file */
+  if ((handle == benchMasterCb.fileHdl) && (benchMasterCb.rxLen == benchCfg.fileLen))
+  {
+    BenchStepEnd(BENCH_STEP_WDX);
+    benchMasterCocStart(connId);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WDXC file transfer control callback.
+ *
+ *  \param  connId    Connection ID.
+ *  \param  handle    Handle of the file.
+ *  \param  op        Control operation.
+ *  \param  status    Status of operation.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterFtcCback(dmConnId_t connId, uint16_t handle, uint8_t op, uint8_t status)
+{
+  uint8_t i;
+
+  if (op != WDX_FTC_OP_EOF)
+  {
+    return;
+  }
+
+  if (handle == WDX_FLIST_HANDLE)
+  {
+    /* file discovery complete; get the benchmark file */
+    for (i = 0; i < BENCH_MASTER_MAX_FILES; i++)
+    {
+      if (strcmp((const char *) benchMasterCb.fileList[i].attributes.name, "Bench") == 0)
+      {
+        benchMasterCb.fileHdl = benchMasterCb.fileList[i].handle;
+        benchMasterCb.rxLen = 0;
+        WdxcFtcSendGetReq(connId, benchMasterCb.fileHdl, 0, benchCfg.fileLen, 0);
+        return;
+      }
+    }
+
+    APP_TRACE_WARN0("bench: file not found");
+    AppConnClose(connId);
+  }
+  else if (handle == benchMasterCb.fileHdl)
+  {
+    /* the file is shorter than requested */
+    APP_TRACE_WARN2("bench: received %u of %u bytes", benchMasterCb.rxLen, benchCfg.fileLen);
+    AppConnClose(connId);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Discovery callback.
+ *
+ *  \param  connId    Connection identifier.
+ *  \param  status    Service or configuration status.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterDiscCback(dmConnId_t connId, uint8_t status)
+{
+  switch(status)
+  {
+    case APP_DISC_INIT:
+      /* set handle list when initialization requested */
+      AppDiscSetHdlList(connId, BENCH_MASTER_DISC_HDL_LIST_LEN, benchMasterCb.hdlList);
+      break;
+
+    case APP_DISC_READ_DATABASE_HASH:
+      /* read peer's database hash */
+      AppDiscReadDatabaseHash(connId);
+      break;
+
+    case APP_DISC_SEC_REQUIRED:
+      /* initiate security */
+      AppMasterSecurityReq(connId);
+      break;
+
+    case APP_DISC_START:
+      /* initialize discovery state */
+      benchMasterCb.discState = BENCH_MASTER_DISC_GATT_SVC;
+
+      /* discover GATT service */
+      GattDiscover(connId, &benchMasterCb.hdlList[BENCH_MASTER_DISC_GATT_START]);
+      break;
+
+    case APP_DISC_FAILED:
+    case APP_DISC_CMPL:
+      /* next discovery state */
+      benchMasterCb.discState++;
+
+      if (benchMasterCb.discState == BENCH_MASTER_DISC_GAP_SVC)
+      {
+        /* discover GAP service */
+        GapDiscover(connId, &benchMasterCb.hdlList[BENCH_MASTER_DISC_GAP_START]);
+      }
+      else if (benchMasterCb.discState == BENCH_MASTER_DISC_WDXC_SVC)
+      {
+        WdxcWdxsDiscover(connId, &benchMasterCb.hdlList[BENCH_MASTER_DISC_WDXC_START]);
+      }
+      else
+      {
+        /* discovery complete */
+        AppDiscComplete(connId, APP_DISC_CMPL);
+
+        /* start configuration */
+        AppDiscConfigure(connId, APP_DISC_CFG_START, BENCH_MASTER_DISC_CFG_LIST_LEN,
+                         (attcDiscCfg_t *) benchMasterDiscCfgList, BENCH_MASTER_DISC_HDL_LIST_LEN,
+                         benchMasterCb.hdlList);
+      }
+      break;
+
+    case APP_DISC_CFG_CMPL:
+      AppDiscComplete(connId, status);
+
+      BenchStepEnd(BENCH_STEP_DISC);
+      BenchStepStart(BENCH_STEP_WDX);
+      memset(benchMasterCb.fileList, 0, sizeof(benchMasterCb.fileList));
+      WdxcDiscoverFiles(connId, benchMasterCb.fileList, BENCH_MASTER_MAX_FILES);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Process messages from the event handler.
+ *
+ *  \param  pMsg    Pointer to message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterProcMsg(dmEvt_t *pMsg)
+{
+  switch(pMsg->hdr.event)
+  {
+    case DM_RESET_CMPL_IND:
+      AttsCalculateDbHash();
+      DmSecGenerateEccKeyReq();
+      DmConnSetConnSpec((hciConnSpec_t *) &benchMasterConnCfg);
+      benchMasterScanStart();
+      break;
+
+    case DM_SCAN_STOP_IND:
+      if (benchMasterCb.doConnect)
+      {
+        AppConnOpen(benchMasterCb.addrType, benchMasterCb.addr, APP_DB_HDL_NONE);
+      }
+      break;
+
+    case DM_SCAN_REPORT_IND:
+      benchMasterScanReport(pMsg);
+      break;
+
+    case DM_CONN_OPEN_IND:
+      BenchStepEnd(BENCH_STEP_CONNECT);
+      BenchStepStart(BENCH_STEP_PAIR);
+      break;
+
+    case DM_CONN_CLOSE_IND:
+      BenchStepEnd(BENCH_STEP_DISCONNECT);
+
+      if (++benchMasterCb.iteration < benchCfg.iterations)
+      {
+        benchMasterScanStart();
+      }
+      else
+      {
+        SimNodeFinish();
+      }
+      break;
+
+    case DM_SEC_PAIR_CMPL_IND:
+      DmSecGenerateEccKeyReq();
+      BenchStepEnd(BENCH_STEP_PAIR);
+      BenchStepStart(BENCH_STEP_DISC);
+      break;
+
+    case DM_SEC_PAIR_FAIL_IND:
+      APP_TRACE_WARN1("bench: pairing failed, status=0x%02x", pMsg->hdr.status);
+      DmSecGenerateEccKeyReq();
+      break;
+
+    case DM_SEC_AUTH_REQ_IND:
+      AppHandlePasskey(&pMsg->authReq);
+      break;
+
+    case DM_SEC_COMPARE_IND:
+      AppHandleNumericComparison(&pMsg->cnfInd);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WSF event handler for application.
+ *
+ *  \param  event   WSF event mask.
+ *  \param  pMsg    WSF message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchMasterHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
+{
+  if (pMsg != NULL)
+  {
+    /* process ATT messages */
+    if (pMsg->event <= ATT_CBACK_END)
+    {
+      /* process discovery-related ATT messages */
+      AppDiscProcAttMsg((attEvt_t *) pMsg);
+
+      /* process server-related ATT messages */
+      AppServerProcAttMsg(pMsg);
+    }
+    /* process DM messages */
+    else if (pMsg->event <= DM_CBACK_END)
+    {
+      /* process advertising and connection-related messages */
+      AppMasterProcDmMsg((dmEvt_t *) pMsg);
+
+      /* process security-related messages */
+      AppMasterSecProcDmMsg((dmEvt_t *) pMsg);
+
+      /* process discovery-related messages */
+      AppDiscProcDmMsg((dmEvt_t *) pMsg);
+    }
+
+    /* perform profile operations */
+    benchMasterProcMsg((dmEvt_t *) pMsg);
+
+    /* perform wdxc operations */
+    WdxcProcMsg((wsfMsgHdr_t *) pMsg);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the stack and application of the master node.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchMasterStart(void)
+{
+  wsfHandlerId_t handlerId;
+
+  if (benchCfg.legacy)
+  {
+    benchMasterSecCfg.auth = 0;
+  }
+
+  SecInit();
+  SecAesInit();
+  SecCmacInit();
+  SecEccInit();
+
+  handlerId = WsfOsSetNextHandler(HciHandler);
+  HciHandlerInit(handlerId);
+
+  handlerId = WsfOsSetNextHandler(DmHandler);
+  DmDevVsInit(0);
+  DmConnInit();
+  DmScanInit();
+  DmConnMasterInit();
+  DmSecInit();
+  DmSecLescInit();
+  DmPrivInit();
+  DmHandlerInit(handlerId);
+
+  handlerId = WsfOsSetNextHandler(L2cSlaveHandler);
+  L2cSlaveHandlerInit(handlerId);
+  L2cInit();
+  L2cMasterInit();
+
+  handlerId = WsfOsSetNextHandler(L2cCocHandler);
+  L2cCocHandlerInit(handlerId);
+  L2cCocInit();
+
+  handlerId = WsfOsSetNextHandler(AttHandler);
+  AttHandlerInit(handlerId);
+  AttsInit();
+  AttsIndInit();
+  AttcInit();
+
+  handlerId = WsfOsSetNextHandler(SmpHandler);
+  SmpHandlerInit(handlerId);
+  SmpiInit();
+  SmpiScInit();
+  HciSetMaxRxAclLen(LL_MAX_DATA_LEN_ABS_MAX);
+
+  handlerId = WsfOsSetNextHandler(AppHandler);
+  AppHandlerInit(handlerId);
+
+  benchMasterCb.handlerId = WsfOsSetNextHandler(benchMasterHandler);
+  pAppMasterCfg = (appMasterCfg_t *) &benchMasterCfg;
+  pAppSecCfg = &benchMasterSecCfg;
+  pAppDiscCfg = (appDiscCfg_t *) &benchMasterDiscCfg;
+  pAppCfg = (appCfg_t *) &benchMasterAppCfg;
+  pSmpCfg = (smpCfg_t *) &benchMasterSmpCfg;
+  pAttCfg = (attCfg_t *) &benchMasterAttCfg;
+  AppMasterInit();
+  AppDiscInit();
+
+  DmRegister(benchMasterDmCback);
+  DmConnRegister(DM_CLIENT_ID_APP, benchMasterDmCback);
+  AttRegister(benchMasterAttCback);
+  AppDiscRegister(benchMasterDiscCback);
+
+  SvcCoreAddGroup();
+  WdxcInit(benchMasterFtdCback, benchMasterFtcCback);
+  benchMasterCocInit();
+
+  DmDevReset();
+}
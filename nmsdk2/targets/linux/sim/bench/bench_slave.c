@@ -0,0 +1,670 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host stack benchmark slave node.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The slave follows the data transmitter sample application: it advertises, accepts pairing
+ *  and serves a file over WDXS.  The file lives in a RAM media in place of the OTA media.  It
+ *  accepts L2CAP connection oriented channels and streams a pattern over them one SDU at a
+ *  time, the next one as soon as L2CAP confirms the previous one.
+ */
+/*************************************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "wsf_types.h"
+#include "wsf_os.h"
+#include "wsf_msg.h"
+#include "wsf_trace.h"
+#include "wsf_assert.h"
+#include "wsf_efs.h"
+#include "util/bstream.h"
+#include "util/wstr.h"
+#include "hci_handler.h"
+#include "dm_handler.h"
+#include "l2c_handler.h"
+#include "att_handler.h"
+#include "smp_handler.h"
+#include "ll_defs.h"
+#include "hci_api.h"
+#include "sec_api.h"
+#include "dm_api.h"
+#include "l2c_api.h"
+#include "smp_api.h"
+#include "att_api.h"
+#include "app_api.h"
+#include "app_cfg.h"
+#include "app_ui.h"
+#include "svc_ch.h"
+#include "svc_core.h"
+#include "svc_wdxs.h"
+#include "gatt/gatt_api.h"
+#include "wdx_defs.h"
+#include "wdxs/wdxs_api.h"
+#include "bench_api.h"
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Enumeration of client characteristic configuration descriptors. */
+enum
+{
+  BENCH_SLAVE_WDXS_DC_CCC_IDX,            /*!< WDXS device configuration */
+  BENCH_SLAVE_WDXS_FTC_CCC_IDX,           /*!< WDXS file transfer control */
+  BENCH_SLAVE_WDXS_FTD_CCC_IDX,           /*!< WDXS file transfer data */
+  BENCH_SLAVE_WDXS_AU_CCC_IDX,            /*!< WDXS authentication */
+  BENCH_SLAVE_GATT_SC_CCC_IDX,            /*!< GATT service changed */
+  BENCH_SLAVE_NUM_CCC_IDX
+};
+
+/**************************************************************************************************
+  Configurable Parameters
+**************************************************************************************************/
+
+/*! \brief  Advertising until connected, every 20 ms. */
+static const appAdvCfg_t benchSlaveAdvCfg =
+{
+  {    0,     0,     0},                  /*!< Advertising durations in ms */
+  {   32,     0,     0}                   /*!< Advertising intervals in 0.625 ms units */
+};
+
+/*! \brief  Configurable parameters for slave. */
+static const appSlaveCfg_t benchSlaveCfg =
+{
+  1,                                      /*!< Maximum connections */
+};
+
+/*! \brief  Security configuration; nothing is bonded so every iteration pairs again. */
+static appSecCfg_t benchSlaveSecCfg =
+{
+  DM_AUTH_SC_FLAG,                        /*!< Authentication and bonding flags */
+  0,                                      /*!< Initiator key distribution flags */
+  0,                                      /*!< Responder key distribution flags */
+  FALSE,                                  /*!< TRUE if Out-of-band pairing data is present */
+  FALSE                                   /*!< TRUE to initiate security upon connection */
+};
+
+/*! \brief  SMP security parameter configuration. */
+static const smpCfg_t benchSlaveSmpCfg =
+{
+  500,                                    /*!< 'Repeated attempts' timeout in msec */
+  SMP_IO_NO_IN_NO_OUT,                    /*!< I/O Capability */
+  7,                                      /*!< Minimum encryption key length */
+  16,                                     /*!< Maximum encryption key length */
+  1,                                      /*!< Attempts to trigger 'repeated attempts' timeout */
+  0,                                      /*!< Device authentication requirements */
+  64000,                                  /*!< Maximum repeated attempts timeout in msec */
+  64000,                                  /*!< Time msec before attemptExp decreases */
+  2                                       /*!< Repeated attempts multiplier exponent */
+};
+
+/*! \brief  Connection parameter update disabled. */
+static const appUpdateCfg_t benchSlaveUpdateCfg =
+{
+  0,                                      /*!< Connection idle period in ms before attempting
+                                               connection parameter update; set to zero to disable */
+  640,                                    /*!< Minimum connection interval in 1.25ms units */
+  800,                                    /*!< Maximum connection interval in 1.25ms units */
+  3,                                      /*!< Connection latency */
+  900,                                    /*!< Supervision timeout in 10ms units */
+  5                                       /*!< Number of update attempts before giving up */
+};
+
+/*! \brief  ATT configurable parameters (increase MTU). */
+static const attCfg_t benchSlaveAttCfg =
+{
+  15,                                     /*!< ATT server service discovery connection idle timeout in seconds */
+  241,                                    /*!< desired ATT MTU */
+  ATT_MAX_TRANS_TIMEOUT,                  /*!< transcation timeout in seconds */
+  4                                       /*!< number of queued prepare writes supported by server */
+};
+
+/**************************************************************************************************
+  Advertising Data
+**************************************************************************************************/
+
+/*! \brief  Advertising data. */
+static const uint8_t benchSlaveAdvData[] =
+{
+  /*! flags */
+  2,                                      /*!< length */
+  DM_ADV_TYPE_FLAGS,                      /*!< AD type */
+  DM_FLAG_LE_GENERAL_DISC |               /*!< flags */
+  DM_FLAG_LE_BREDR_NOT_SUP,
+
+  /*! manufacturer specific data */
+  3,                                      /*!< length */
+  DM_ADV_TYPE_MANUFACTURER,               /*!< AD type */
+  UINT16_TO_BYTES(HCI_ID_ARM)             /*!< company ID */
+};
+
+/*! \brief  Scan response data. */
+static const uint8_t benchSlaveScanData[] =
+{
+  /*! device name */
+  6,                                      /*!< length */
+  DM_ADV_TYPE_LOCAL_NAME,                 /*!< AD type */
+  'B',
+  'e',
+  'n',
+  'c',
+  'h'
+};
+
+/**************************************************************************************************
+  Client Characteristic Configuration Descriptors
+**************************************************************************************************/
+
+/*! \brief  Client characteristic configuration descriptors settings. */
+static const attsCccSet_t benchSlaveCccSet[BENCH_SLAVE_NUM_CCC_IDX] =
+{
+  /* cccd handle          value range               security level */
+  {WDXS_DC_CH_CCC_HDL,    ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},
+  {WDXS_FTC_CH_CCC_HDL,   ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},
+  {WDXS_FTD_CH_CCC_HDL,   ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},
+  {WDXS_AU_CH_CCC_HDL,    ATT_CLIENT_CFG_NOTIFY,    DM_SEC_LEVEL_NONE},
+  {GATT_SC_CH_CCC_HDL,    ATT_CLIENT_CFG_INDICATE,  DM_SEC_LEVEL_NONE}
+};
+
+/**************************************************************************************************
+  Local Variables
+**************************************************************************************************/
+
+/*! \brief  Application control block. */
+static struct
+{
+  wsfHandlerId_t    handlerId;            /*!< WSF handler ID */
+  uint8_t           *pFile;               /*!< File media storage */
+  uint16_t          cocCid;               /*!< Channel of the stream */
+  uint16_t          cocSduLen;            /*!< SDU length of the stream */
+  uint32_t          cocTxLen;             /*!< Number of stream bytes handed to L2CAP */
+  uint8_t           cocSdu[BENCH_COC_MTU];  /*!< SDU being sent */
+} benchSlaveCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  File media erase.
+ *
+ *  \param  address   Address in media to start erasing.
+ *  \param  size      Number of bytes to erase.
+ *
+ *  \return Status of the operation.
+ */
+/*************************************************************************************************/
+static uint8_t benchSlaveMediaErase(uint32_t address, uint32_t size)
+{
+  memset(benchSlaveCb.pFile + address, 0xFF, size);
+
+  return WSF_EFS_SUCCESS;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  File media read.
+ *
+ *  \param  pBuf      Buffer to hold data.
+ *  \param  address   Address in media to read from.
+ *  \param  size      Size of pBuf in bytes.
+ *
+ *  \return Status of the operation.
+ */
+/*************************************************************************************************/
+static uint8_t benchSlaveMediaRead(uint8_t *pBuf, uint32_t address, uint32_t size)
+{
+  memcpy(pBuf, benchSlaveCb.pFile + address, size);
+
+  return WSF_EFS_SUCCESS;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  File media write.
+ *
+ *  \param  pBuf      Buffer with data to be written.
+ *  \param  address   Address in media to write to.
+ *  \param  size      Size of pBuf in bytes.
+ *
+ *  \return Status of the operation.
+ */
+/*************************************************************************************************/
+static uint8_t benchSlaveMediaWrite(const uint8_t *pBuf, uint32_t address, uint32_t size)
+{
+  memcpy(benchSlaveCb.pFile + address, pBuf, size);
+
+  return WSF_EFS_SUCCESS;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the file media and add the file read by the master.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveFileInit(void)
+{
+  static wsfEfsMedia_t media;
+  wsfEsfAttributes_t attr;
+  wsfEfsHandle_t handle;
+  uint8_t block[64];
+  uint32_t offset;
+  uint16_t len;
+  uint16_t i;
+
+  benchSlaveCb.pFile = malloc(benchCfg.fileLen);
+  WSF_ASSERT(benchSlaveCb.pFile != NULL);
+
+  media.startAddress = 0;
+  media.endAddress = benchCfg.fileLen;
+  media.pageSize = 0;
+  media.erase = benchSlaveMediaErase;
+  media.read = benchSlaveMediaRead;
+  media.write = benchSlaveMediaWrite;
+  WsfEfsRegisterMedia(&media, WDX_OTA_MEDIA);
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type = WSF_EFS_FILE_TYPE_BULK;
+  attr.permissions = WSF_EFS_REMOTE_VISIBLE | WSF_EFS_REMOTE_GET_PERMITTED |
+                     WSF_EFS_LOCAL_PUT_PERMITTED;
+  WstrnCpy(attr.name, "Bench", WSF_EFS_NAME_LEN);
+  WstrnCpy(attr.version, "1.0", WSF_EFS_VERSION_LEN);
+
+  handle = WsfEfsAddFile(benchCfg.fileLen, WDX_OTA_MEDIA, &attr, 0);
+  WSF_ASSERT(handle != WSF_EFS_INVALID_HANDLE);
+
+  /* fill the file so that its size is the requested length */
+  for (offset = 0; offset < benchCfg.fileLen; offset += len)
+  {
+    len = (benchCfg.fileLen - offset < sizeof(block)) ? (uint16_t)(benchCfg.fileLen - offset) :
+                                                       sizeof(block);
+    for (i = 0; i < len; i++)
+    {
+      block[i] = (uint8_t)(offset + i);
+    }
+
+    WsfEfsPut(handle, offset, block, len);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WDXS file transfer callback.
+ *
+ *  \param  connId    Connection identifier.
+ *  \param  event     WDXS_FT_EVT_START or WDXS_FT_EVT_END.
+ *  \param  op        File transfer operation.
+ *  \param  len       Requested length on start, bytes transferred on end.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveFtCback(dmConnId_t connId, uint8_t event, uint8_t op, uint32_t len)
+{
+  if (event == WDXS_FT_EVT_START)
+  {
+    /* the file listing comes first */
+    BenchStepEnd(BENCH_STEP_DISC);
+    BenchStepStart(BENCH_STEP_WDX);
+  }
+  else if ((op == WDX_FTC_OP_GET_REQ) && (len == benchCfg.fileLen))
+  {
+    BenchStepEnd(BENCH_STEP_WDX);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Hand the next SDU of the stream to L2CAP.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveCocSend(void)
+{
+  uint16_t len;
+  uint16_t i;
+
+  if (benchSlaveCb.cocTxLen == benchCfg.cocLen)
+  {
+    BenchStepEnd(BENCH_STEP_COC);
+    return;
+  }
+
+  len = benchSlaveCb.cocSduLen;
+  if (benchCfg.cocLen - benchSlaveCb.cocTxLen < len)
+  {
+    len = (uint16_t) (benchCfg.cocLen - benchSlaveCb.cocTxLen);
+  }
+
+  for (i = 0; i < len; i++)
+  {
+    benchSlaveCb.cocSdu[i] = (uint8_t) (benchSlaveCb.cocTxLen + i);
+  }
+
+  benchSlaveCb.cocTxLen += len;
+  L2cCocDataReq(benchSlaveCb.cocCid, len, benchSlaveCb.cocSdu);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  L2CAP connection oriented channel callback.
+ *
+ *  \param  pMsg    Channel event.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveCocCback(l2cCocEvt_t *pMsg)
+{
+  switch (pMsg->hdr.event)
+  {
+    case L2C_COC_CONNECT_IND:
+      BenchStepStart(BENCH_STEP_COC);
+
+      benchSlaveCb.cocCid = pMsg->connectInd.cid;
+      benchSlaveCb.cocSduLen = (pMsg->connectInd.peerMtu < BENCH_COC_MTU) ?
+                               pMsg->connectInd.peerMtu : BENCH_COC_MTU;
+      benchSlaveCb.cocTxLen = 0;
+      benchSlaveCocSend();
+      break;
+
+    case L2C_COC_DISCONNECT_IND:
+      if (pMsg->disconnectInd.cid == benchSlaveCb.cocCid)
+      {
+        benchSlaveCb.cocCid = L2C_COC_CID_NONE;
+      }
+      break;
+
+    case L2C_COC_DATA_CNF:
+      if (pMsg->dataCnf.cid != benchSlaveCb.cocCid)
+      {
+        break;
+      }
+
+      if (pMsg->hdr.status == L2C_COC_DATA_SUCCESS)
+      {
+        benchSlaveCocSend();
+      }
+      else
+      {
+        BenchError("l2cap coc data request failed");
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the acceptor of the stream channel.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveCocInit(void)
+{
+  l2cCocReg_t reg;
+
+  reg.psm = BENCH_COC_PSM;
+  reg.mps = BENCH_COC_MPS;
+  reg.mtu = BENCH_COC_MTU;
+  reg.credits = BENCH_COC_CREDITS;
+  reg.authoriz = FALSE;
+  reg.secLevel = DM_SEC_LEVEL_NONE;
+  reg.role = L2C_COC_ROLE_ACCEPTOR;
+
+  benchSlaveCb.cocCid = L2C_COC_CID_NONE;
+  L2cCocRegister(benchSlaveCocCback, &reg);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Application DM callback.
+ *
+ *  \param  pDmEvt  DM callback event
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveDmCback(dmEvt_t *pDmEvt)
+{
+  dmEvt_t   *pMsg;
+  uint16_t  len;
+
+  if (pDmEvt->hdr.event == DM_SEC_ECC_KEY_IND)
+  {
+    DmSecSetEccKey(&pDmEvt->eccMsg.data.key);
+  }
+  else
+  {
+    len = DmSizeOfEvt(pDmEvt);
+
+    if ((pMsg = WsfMsgAlloc(len)) != NULL)
+    {
+      memcpy(pMsg, pDmEvt, len);
+      WsfMsgSend(benchSlaveCb.handlerId, pMsg);
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Application ATT callback.
+ *
+ *  \param  pEvt    ATT callback event
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveAttCback(attEvt_t *pEvt)
+{
+  WdxsAttCback(pEvt);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Application ATTS client characteristic configuration callback.
+ *
+ *  \param  pEvt    CCC callback event
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveCccCback(attsCccEvt_t *pEvt)
+{
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Process messages from the event handler.
+ *
+ *  \param  pMsg    Pointer to message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveProcMsg(dmEvt_t *pMsg)
+{
+  switch(pMsg->hdr.event)
+  {
+    case DM_RESET_CMPL_IND:
+      AttsCalculateDbHash();
+      DmSecGenerateEccKeyReq();
+
+      AppAdvSetData(APP_ADV_DATA_CONNECTABLE, sizeof(benchSlaveAdvData),
+                    (uint8_t *) benchSlaveAdvData);
+      AppAdvSetData(APP_SCAN_DATA_CONNECTABLE, sizeof(benchSlaveScanData),
+                    (uint8_t *) benchSlaveScanData);
+      AppAdvStart(APP_MODE_CONNECTABLE);
+      break;
+
+    case DM_ADV_START_IND:
+      BenchStepStart(BENCH_STEP_CONNECT);
+      break;
+
+    case DM_CONN_OPEN_IND:
+      BenchStepEnd(BENCH_STEP_CONNECT);
+      BenchStepStart(BENCH_STEP_PAIR);
+      break;
+
+    case DM_SEC_PAIR_CMPL_IND:
+      DmSecGenerateEccKeyReq();
+      BenchStepEnd(BENCH_STEP_PAIR);
+      BenchStepStart(BENCH_STEP_DISC);
+      break;
+
+    case DM_SEC_PAIR_FAIL_IND:
+      APP_TRACE_WARN1("bench: pairing failed, status=0x%02x", pMsg->hdr.status);
+      DmSecGenerateEccKeyReq();
+      break;
+
+    case DM_SEC_AUTH_REQ_IND:
+      AppHandlePasskey(&pMsg->authReq);
+      break;
+
+    case DM_SEC_COMPARE_IND:
+      AppHandleNumericComparison(&pMsg->cnfInd);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  WSF event handler for application.
+ *
+ *  \param  event   WSF event mask.
+ *  \param  pMsg    WSF message.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void benchSlaveHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
+{
+  if (pMsg != NULL)
+  {
+    if (pMsg->event >= ATT_CBACK_START && pMsg->event <= ATT_CBACK_END)
+    {
+      AppServerProcAttMsg(pMsg);
+    }
+    else if (pMsg->event >= DM_CBACK_START && pMsg->event <= DM_CBACK_END)
+    {
+      AppSlaveProcDmMsg((dmEvt_t *) pMsg);
+      AppSlaveSecProcDmMsg((dmEvt_t *) pMsg);
+      WdxsProcDmMsg((dmEvt_t *) pMsg);
+    }
+
+    benchSlaveProcMsg((dmEvt_t *) pMsg);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize the stack and application of the slave node.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void BenchSlaveStart(void)
+{
+  wsfHandlerId_t handlerId;
+
+  if (benchCfg.legacy)
+  {
+    benchSlaveSecCfg.auth = 0;
+  }
+
+  SecInit();
+  SecAesInit();
+  SecCmacInit();
+  SecEccInit();
+
+  handlerId = WsfOsSetNextHandler(HciHandler);
+  HciHandlerInit(handlerId);
+
+  handlerId = WsfOsSetNextHandler(DmHandler);
+  DmDevVsInit(0);
+  DmConnInit();
+  DmAdvInit();
+  DmConnSlaveInit();
+  DmSecInit();
+  DmSecLescInit();
+  DmPrivInit();
+  DmHandlerInit(handlerId);
+
+  handlerId = WsfOsSetNextHandler(L2cSlaveHandler);
+  L2cSlaveHandlerInit(handlerId);
+  L2cInit();
+  L2cSlaveInit();
+
+  handlerId = WsfOsSetNextHandler(L2cCocHandler);
+  L2cCocHandlerInit(handlerId);
+  L2cCocInit();
+
+  handlerId = WsfOsSetNextHandler(AttHandler);
+  AttHandlerInit(handlerId);
+  AttsInit();
+  AttsIndInit();
+
+  handlerId = WsfOsSetNextHandler(SmpHandler);
+  SmpHandlerInit(handlerId);
+  SmprInit();
+  SmprScInit();
+  HciSetMaxRxAclLen(LL_MAX_DATA_LEN_ABS_MAX);
+
+  handlerId = WsfOsSetNextHandler(AppHandler);
+  AppHandlerInit(handlerId);
+
+  benchSlaveCb.handlerId = WsfOsSetNextHandler(benchSlaveHandler);
+  pAppSlaveCfg = (appSlaveCfg_t *) &benchSlaveCfg;
+  pAppAdvCfg = (appAdvCfg_t *) &benchSlaveAdvCfg;
+  pAppSecCfg = &benchSlaveSecCfg;
+  pAppUpdateCfg = (appUpdateCfg_t *) &benchSlaveUpdateCfg;
+  pSmpCfg = (smpCfg_t *) &benchSlaveSmpCfg;
+  pAttCfg = (attCfg_t *) &benchSlaveAttCfg;
+  AppSlaveInit();
+  AppServerInit();
+
+  handlerId = WsfOsSetNextHandler(WdxsHandler);
+  WdxsHandlerInit(handlerId);
+
+  DmRegister(benchSlaveDmCback);
+  DmConnRegister(DM_CLIENT_ID_APP, benchSlaveDmCback);
+  AttRegister(benchSlaveAttCback);
+  AttConnRegister(AppServerConnCback);
+  AttsCccRegister(BENCH_SLAVE_NUM_CCC_IDX, (attsCccSet_t *) benchSlaveCccSet,
+                  benchSlaveCccCback);
+
+  SvcCoreGattCbackRegister(GattReadCback, GattWriteCback);
+  SvcCoreAddGroup();
+  GattSetSvcChangedIdx(BENCH_SLAVE_GATT_SC_CCC_IDX);
+
+  benchSlaveFileInit();
+  WdxsSetCccIdx(BENCH_SLAVE_WDXS_DC_CCC_IDX, BENCH_SLAVE_WDXS_AU_CCC_IDX,
+                BENCH_SLAVE_WDXS_FTC_CCC_IDX, BENCH_SLAVE_WDXS_FTD_CCC_IDX);
+  WdxsFtRegister(benchSlaveFtCback);
+
+  benchSlaveCocInit();
+
+  DmDevReset();
+}
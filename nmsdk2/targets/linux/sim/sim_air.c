@@ -0,0 +1,353 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host simulation coordinator.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  The coordinator is a conservative discrete event scheduler.  It waits until every node has
+ *  reported idle, then advances the clock to the earliest node alarm or pending air PDU and wakes
+ *  the nodes due at that time.  A node is handed at most one air PDU per wake up; further PDUs due
+ *  at the same time follow as soon as it is idle again.  PDUs for one node are delivered in time
+ *  order and, at equal times, in the order they were sent, so a run is reproducible.
+ */
+/*************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "wsf_types.h"
+#include "sim_api.h"
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Pending air PDU. */
+typedef struct simAirPdu_tag
+{
+  struct simAirPdu_tag  *pNext;           /*!< Next PDU, sorted by delivery time. */
+  simTime_t             time;             /*!< Delivery time. */
+  uint8_t               src;              /*!< Source node. */
+  uint8_t               dst;              /*!< Destination node. */
+  uint16_t              len;              /*!< PDU length. */
+  uint8_t               pdu[];            /*!< PDU. */
+} simAirPdu_t;
+
+/*! \brief  Coordinator control block. */
+static struct
+{
+  const int     *pFd;                     /*!< Node sockets. */
+  uint8_t       numNodes;                 /*!< Number of nodes. */
+  simTime_t     now;                      /*!< Current time. */
+  simTime_t     wake[SIM_MAX_NODES];      /*!< Requested wake time of idle nodes. */
+  bool_t        running[SIM_MAX_NODES];   /*!< TRUE while a node is not idle. */
+  simAirPdu_t   *pPending;                /*!< Pending air PDUs. */
+  bool_t        finished;                 /*!< A node ended the simulation. */
+  bool_t        failed;                   /*!< A node went away. */
+} simAirCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a message to a node.
+ *
+ *  \param  node      Node ID.
+ *  \param  type      Message type.
+ *  \param  pPdu      Air PDU or NULL.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simAirSend(uint8_t node, uint8_t type, const simAirPdu_t *pPdu)
+{
+  simMsgHdr_t hdr;
+  struct iovec iov[2];
+  struct msghdr msg;
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = type;
+  hdr.time = simAirCb.now;
+  hdr.dst = node;
+
+  iov[0].iov_base = &hdr;
+  iov[0].iov_len = sizeof(hdr);
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 1;
+
+  if (pPdu != NULL)
+  {
+    hdr.src = pPdu->src;
+    hdr.len = pPdu->len;
+    iov[1].iov_base = (void *) pPdu->pdu;
+    iov[1].iov_len = pPdu->len;
+    msg.msg_iovlen = 2;
+  }
+
+  /* A node that already exited is noticed when its socket is read. */
+  (void) sendmsg(simAirCb.pFd[node], &msg, MSG_NOSIGNAL);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Queue an air PDU for one node.
+ *
+ *  \param  pHdr      Message header of the PDU.
+ *  \param  dst       Destination node.
+ *  \param  pData     PDU.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simAirQueue(const simMsgHdr_t *pHdr, uint8_t dst, const uint8_t *pData)
+{
+  simAirPdu_t *pPdu;
+  simAirPdu_t **ppElem;
+
+  if ((pPdu = malloc(sizeof(simAirPdu_t) + pHdr->len)) == NULL)
+  {
+    simAirCb.failed = TRUE;
+    return;
+  }
+
+  pPdu->time = (pHdr->time < simAirCb.now) ? simAirCb.now : pHdr->time;
+  pPdu->src = pHdr->src;
+  pPdu->dst = dst;
+  pPdu->len = pHdr->len;
+  memcpy(pPdu->pdu, pData, pHdr->len);
+
+  /* Keep send order among PDUs with equal delivery time. */
+  for (ppElem = &simAirCb.pPending; *ppElem != NULL; ppElem = &(*ppElem)->pNext)
+  {
+    if (pPdu->time < (*ppElem)->time)
+    {
+      break;
+    }
+  }
+
+  pPdu->pNext = *ppElem;
+  *ppElem = pPdu;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read one message from a running node.
+ *
+ *  \param  node      Node ID.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simAirRecv(uint8_t node)
+{
+  static uint8_t buf[sizeof(simMsgHdr_t) + SIM_AIR_MAX_LEN];
+  simMsgHdr_t hdr;
+  ssize_t len;
+  uint8_t dst;
+
+  if ((len = recv(simAirCb.pFd[node], buf, sizeof(buf), 0)) < (ssize_t) sizeof(simMsgHdr_t))
+  {
+    fprintf(stderr, "sim: node %u exited\n", node);
+    simAirCb.running[node] = FALSE;
+    simAirCb.failed = TRUE;
+    return;
+  }
+
+  memcpy(&hdr, buf, sizeof(hdr));
+
+  switch (hdr.type)
+  {
+    case SIM_MSG_SLEEP:
+      simAirCb.running[node] = FALSE;
+      simAirCb.wake[node] = hdr.time;
+      break;
+
+    case SIM_MSG_AIR:
+      hdr.src = node;
+      for (dst = 0; dst < simAirCb.numNodes; dst++)
+      {
+        if ((dst != node) && ((hdr.dst == SIM_NODE_BROADCAST) || (hdr.dst == dst)))
+        {
+          simAirQueue(&hdr, dst, buf + sizeof(simMsgHdr_t));
+        }
+      }
+      break;
+
+    case SIM_MSG_FINISH:
+      simAirCb.finished = TRUE;
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Wait until every node is idle.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simAirWaitIdle(void)
+{
+  struct pollfd pfd[SIM_MAX_NODES];
+  uint8_t map[SIM_MAX_NODES];
+  uint8_t num;
+  uint8_t i;
+
+  for (;;)
+  {
+    num = 0;
+    for (i = 0; i < simAirCb.numNodes; i++)
+    {
+      if (simAirCb.running[i])
+      {
+        pfd[num].fd = simAirCb.pFd[i];
+        pfd[num].events = POLLIN;
+        map[num++] = i;
+      }
+    }
+
+    if ((num == 0) || simAirCb.failed)
+    {
+      return;
+    }
+
+    if (poll(pfd, num, -1) < 0)
+    {
+      simAirCb.failed = TRUE;
+      return;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+      if (pfd[i].revents != 0)
+      {
+        simAirRecv(map[i]);
+      }
+    }
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run the coordinator until a node finishes the simulation.
+ *
+ *  \param  pFd       Sockets connected to each node, indexed by node ID.
+ *  \param  numNodes  Number of nodes.
+ *  \param  limit     Simulated time at which to give up.
+ *
+ *  \return Simulated time at the end, or SIM_TIME_NEVER if every node went idle for good or the
+ *          limit was reached.
+ */
+/*************************************************************************************************/
+simTime_t SimAirRun(const int *pFd, uint8_t numNodes, simTime_t limit)
+{
+  simAirPdu_t **ppElem;
+  simAirPdu_t *pPdu;
+  simTime_t next;
+  simTime_t result;
+  uint8_t i;
+
+  memset(&simAirCb, 0, sizeof(simAirCb));
+  simAirCb.pFd = pFd;
+  simAirCb.numNodes = numNodes;
+
+  /* Nodes start out running their initialization. */
+  for (i = 0; i < numNodes; i++)
+  {
+    simAirCb.running[i] = TRUE;
+  }
+
+  for (;;)
+  {
+    simAirWaitIdle();
+
+    if (simAirCb.finished || simAirCb.failed)
+    {
+      break;
+    }
+
+    /* Advance to the earliest event of any node. */
+    next = (simAirCb.pPending != NULL) ? simAirCb.pPending->time : SIM_TIME_NEVER;
+    for (i = 0; i < numNodes; i++)
+    {
+      if (simAirCb.wake[i] < next)
+      {
+        next = simAirCb.wake[i];
+      }
+    }
+
+    if ((next == SIM_TIME_NEVER) || (next > limit))
+    {
+      break;
+    }
+
+    simAirCb.now = next;
+
+    /* Wake every node due, handing over its oldest PDU. */
+    for (i = 0; i < numNodes; i++)
+    {
+      for (ppElem = &simAirCb.pPending; (pPdu = *ppElem) != NULL; ppElem = &pPdu->pNext)
+      {
+        if ((pPdu->time > simAirCb.now) || (pPdu->dst == i))
+        {
+          break;
+        }
+      }
+
+      if ((pPdu != NULL) && (pPdu->time <= simAirCb.now))
+      {
+        *ppElem = pPdu->pNext;
+        simAirSend(i, SIM_MSG_AIR, pPdu);
+        free(pPdu);
+        simAirCb.running[i] = TRUE;
+      }
+      else if (simAirCb.wake[i] <= simAirCb.now)
+      {
+        simAirSend(i, SIM_MSG_WAKE, NULL);
+        simAirCb.running[i] = TRUE;
+      }
+    }
+  }
+
+  result = (simAirCb.finished && !simAirCb.failed) ? simAirCb.now : SIM_TIME_NEVER;
+
+  /* Stop every node once it is idle. */
+  simAirCb.failed = FALSE;
+  simAirWaitIdle();
+
+  for (i = 0; i < numNodes; i++)
+  {
+    simAirSend(i, SIM_MSG_STOP, NULL);
+  }
+
+  while ((pPdu = simAirCb.pPending) != NULL)
+  {
+    simAirCb.pPending = pPdu->pNext;
+    free(pPdu);
+  }
+
+  return result;
+}
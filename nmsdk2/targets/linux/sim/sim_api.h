@@ -0,0 +1,249 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host simulation interface.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  Every simulated device (node) is a separate process running one instance of WSF and the host
+ *  stack.  Nodes share a simulated clock with microsecond resolution that only moves forward
+ *  while every node is idle.  A coordinator process owns the clock and carries air PDUs between
+ *  nodes; a node exchanges messages with it over a sequenced packet socket.
+ *
+ *  A node blocks in SimNodeWait() when it has nothing left to do.  The coordinator then advances
+ *  the clock to the earliest pending alarm or air PDU of any node and wakes that node up.  Alarms
+ *  take the place of timer interrupts; the callback runs with the clock set to the alarm time.
+ */
+/*************************************************************************************************/
+#ifndef SIM_API_H
+#define SIM_API_H
+
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************************************
+  Macros
+**************************************************************************************************/
+
+/*! \brief  Maximum number of nodes. */
+#define SIM_MAX_NODES             8
+
+/*! \brief  Destination of an air PDU heard by every other node. */
+#define SIM_NODE_BROADCAST        0xFF
+
+/*! \brief  Maximum length of an air PDU. */
+#define SIM_AIR_MAX_LEN           300
+
+/*! \brief  Time value that never expires. */
+#define SIM_TIME_NEVER            UINT64_MAX
+
+/*! \brief  Link message types. */
+enum
+{
+  SIM_MSG_SLEEP,                          /*!< Node to coordinator: idle until the given time. */
+  SIM_MSG_WAKE,                           /*!< Coordinator to node: clock advanced. */
+  SIM_MSG_AIR,                            /*!< Air PDU, in either direction. */
+  SIM_MSG_FINISH,                         /*!< Node to coordinator: end the simulation. */
+  SIM_MSG_STOP                            /*!< Coordinator to node: exit. */
+};
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Simulated time in microseconds. */
+typedef uint64_t simTime_t;
+
+/*! \brief  Link message header. */
+typedef struct
+{
+  simTime_t     time;                     /*!< Wake time, current time or air delivery time. */
+  uint8_t       type;                     /*!< Message type. */
+  uint8_t       src;                      /*!< Source node of an air PDU. */
+  uint8_t       dst;                      /*!< Destination node of an air PDU. */
+  uint8_t       rsvd;                     /*!< Reserved. */
+  uint16_t      len;                      /*!< Length of the payload following the header. */
+} simMsgHdr_t;
+
+/*! \brief  Air PDU receive callback. */
+typedef void (*simAirCback_t)(uint8_t src, const uint8_t *pPdu, uint16_t len);
+
+/*! \brief  Alarm callback. */
+typedef void (*simAlarmCback_t)(void *pContext);
+
+/*! \brief  Alarm. */
+typedef struct simAlarm_tag
+{
+  struct simAlarm_tag *pNext;             /*!< Next alarm in the pending list. */
+  simTime_t           time;               /*!< Expiration time. */
+  simAlarmCback_t     cback;              /*!< Expiration callback. */
+  void                *pContext;          /*!< Callback context. */
+  bool_t              isStarted;          /*!< TRUE if pending. */
+} simAlarm_t;
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Attach this process to the coordinator as a node.
+ *
+ *  \param  fd        Socket connected to the coordinator.
+ *  \param  nodeId    Node ID.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeInit(int fd, uint8_t nodeId);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the ID of this node.
+ *
+ *  \return Node ID.
+ */
+/*************************************************************************************************/
+uint8_t SimNodeGetId(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the simulated time.
+ *
+ *  \return Current time in microseconds.
+ */
+/*************************************************************************************************/
+simTime_t SimNodeGetTime(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the air PDU receive callback.
+ *
+ *  \param  cback     Callback.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirRegister(simAirCback_t cback);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an air PDU.
+ *
+ *  \param  dst       Destination node or SIM_NODE_BROADCAST.
+ *  \param  time      Delivery time, no earlier than the current time.
+ *  \param  pPdu      PDU.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirSend(uint8_t dst, simTime_t time, const uint8_t *pPdu, uint16_t len);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  cback     Expiration callback.
+ *  \param  pContext  Callback context.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmInit(simAlarm_t *pAlarm, simAlarmCback_t cback, void *pContext);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start or restart an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  time      Absolute expiration time.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStart(simAlarm_t *pAlarm, simTime_t time);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Stop an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStop(simAlarm_t *pAlarm);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Idle until an alarm expires or an air PDU arrives, then run its callback.
+ *
+ *  \return FALSE if the coordinator stopped the simulation, TRUE otherwise.
+ */
+/*************************************************************************************************/
+bool_t SimNodeWait(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Ask the coordinator to stop all nodes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeFinish(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time this process spent in the simulation link.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimNodeGetLinkCpuNs(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time consumed by this process.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimCpuNs(void);
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run the coordinator until a node finishes the simulation.
+ *
+ *  \param  pFd       Sockets connected to each node, indexed by node ID.
+ *  \param  numNodes  Number of nodes.
+ *  \param  limit     Simulated time at which to give up.
+ *
+ *  \return Simulated time at the end, or SIM_TIME_NEVER if every node went idle for good or the
+ *          limit was reached.
+ */
+/*************************************************************************************************/
+simTime_t SimAirRun(const int *pFd, uint8_t numNodes, simTime_t limit);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* SIM_API_H */
@@ -0,0 +1,363 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Host simulation node link.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "sim_api.h"
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Node control block. */
+static struct
+{
+  int             fd;                     /*!< Coordinator socket. */
+  uint8_t         nodeId;                 /*!< Node ID. */
+  simTime_t       now;                    /*!< Current time. */
+  simAlarm_t      *pAlarms;               /*!< Pending alarms sorted by time. */
+  simAirCback_t   airCback;               /*!< Air PDU receive callback. */
+  uint64_t        linkCpuNs;              /*!< CPU time spent in the link. */
+} simNodeCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time consumed by this process.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimCpuNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send a message to the coordinator.
+ *
+ *  \param  pHdr      Message header.
+ *  \param  pData     Payload or NULL.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simNodeSend(simMsgHdr_t *pHdr, const uint8_t *pData)
+{
+  struct iovec iov[2];
+  struct msghdr msg;
+
+  iov[0].iov_base = pHdr;
+  iov[0].iov_len = sizeof(simMsgHdr_t);
+  iov[1].iov_base = (void *) pData;
+  iov[1].iov_len = pHdr->len;
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = (pHdr->len > 0) ? 2 : 1;
+
+  if (sendmsg(simNodeCb.fd, &msg, 0) < 0)
+  {
+    /* Coordinator is gone; nothing sensible left to do. */
+    exit(EXIT_FAILURE);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run the callbacks of all alarms expired at the current time.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simNodeServiceAlarms(void)
+{
+  simAlarm_t *pAlarm;
+
+  while (((pAlarm = simNodeCb.pAlarms) != NULL) && (pAlarm->time <= simNodeCb.now))
+  {
+    simNodeCb.pAlarms = pAlarm->pNext;
+    pAlarm->isStarted = FALSE;
+    pAlarm->cback(pAlarm->pContext);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Attach this process to the coordinator as a node.
+ *
+ *  \param  fd        Socket connected to the coordinator.
+ *  \param  nodeId    Node ID.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeInit(int fd, uint8_t nodeId)
+{
+  memset(&simNodeCb, 0, sizeof(simNodeCb));
+  simNodeCb.fd = fd;
+  simNodeCb.nodeId = nodeId;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the ID of this node.
+ *
+ *  \return Node ID.
+ */
+/*************************************************************************************************/
+uint8_t SimNodeGetId(void)
+{
+  return simNodeCb.nodeId;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the simulated time.
+ *
+ *  \return Current time in microseconds.
+ */
+/*************************************************************************************************/
+simTime_t SimNodeGetTime(void)
+{
+  return simNodeCb.now;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the air PDU receive callback.
+ *
+ *  \param  cback     Callback.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirRegister(simAirCback_t cback)
+{
+  simNodeCb.airCback = cback;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an air PDU.
+ *
+ *  \param  dst       Destination node or SIM_NODE_BROADCAST.
+ *  \param  time      Delivery time, no earlier than the current time.
+ *  \param  pPdu      PDU.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirSend(uint8_t dst, simTime_t time, const uint8_t *pPdu, uint16_t len)
+{
+  simMsgHdr_t hdr;
+  uint64_t start = SimCpuNs();
+
+  WSF_ASSERT(len <= SIM_AIR_MAX_LEN);
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = SIM_MSG_AIR;
+  hdr.time = (time < simNodeCb.now) ? simNodeCb.now : time;
+  hdr.src = simNodeCb.nodeId;
+  hdr.dst = dst;
+  hdr.len = len;
+
+  simNodeSend(&hdr, pPdu);
+
+  simNodeCb.linkCpuNs += SimCpuNs() - start;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  cback     Expiration callback.
+ *  \param  pContext  Callback context.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmInit(simAlarm_t *pAlarm, simAlarmCback_t cback, void *pContext)
+{
+  memset(pAlarm, 0, sizeof(simAlarm_t));
+  pAlarm->cback = cback;
+  pAlarm->pContext = pContext;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start or restart an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  time      Absolute expiration time.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStart(simAlarm_t *pAlarm, simTime_t time)
+{
+  simAlarm_t **ppElem;
+
+  SimNodeAlarmStop(pAlarm);
+
+  pAlarm->time = time;
+  pAlarm->isStarted = TRUE;
+
+  /* Alarms with equal times expire in the order they were started. */
+  for (ppElem = &simNodeCb.pAlarms; *ppElem != NULL; ppElem = &(*ppElem)->pNext)
+  {
+    if (time < (*ppElem)->time)
+    {
+      break;
+    }
+  }
+
+  pAlarm->pNext = *ppElem;
+  *ppElem = pAlarm;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Stop an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStop(simAlarm_t *pAlarm)
+{
+  simAlarm_t **ppElem;
+
+  if (!pAlarm->isStarted)
+  {
+    return;
+  }
+
+  for (ppElem = &simNodeCb.pAlarms; *ppElem != NULL; ppElem = &(*ppElem)->pNext)
+  {
+    if (*ppElem == pAlarm)
+    {
+      *ppElem = pAlarm->pNext;
+      break;
+    }
+  }
+
+  pAlarm->isStarted = FALSE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Idle until an alarm expires or an air PDU arrives, then run its callback.
+ *
+ *  \return FALSE if the coordinator stopped the simulation, TRUE otherwise.
+ */
+/*************************************************************************************************/
+bool_t SimNodeWait(void)
+{
+  static uint8_t buf[sizeof(simMsgHdr_t) + SIM_AIR_MAX_LEN];
+  simMsgHdr_t hdr;
+  uint64_t start = SimCpuNs();
+  ssize_t len;
+
+  /* Alarms already due expire without a round trip. */
+  if ((simNodeCb.pAlarms != NULL) && (simNodeCb.pAlarms->time <= simNodeCb.now))
+  {
+    simNodeServiceAlarms();
+    return TRUE;
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = SIM_MSG_SLEEP;
+  hdr.time = (simNodeCb.pAlarms != NULL) ? simNodeCb.pAlarms->time : SIM_TIME_NEVER;
+  simNodeSend(&hdr, NULL);
+
+  if ((len = recv(simNodeCb.fd, buf, sizeof(buf), 0)) < (ssize_t) sizeof(simMsgHdr_t))
+  {
+    return FALSE;
+  }
+
+  memcpy(&hdr, buf, sizeof(hdr));
+  simNodeCb.linkCpuNs += SimCpuNs() - start;
+
+  if (hdr.type == SIM_MSG_STOP)
+  {
+    return FALSE;
+  }
+
+  WSF_ASSERT(hdr.time >= simNodeCb.now);
+  simNodeCb.now = hdr.time;
+
+  simNodeServiceAlarms();
+
+  if ((hdr.type == SIM_MSG_AIR) && (simNodeCb.airCback != NULL))
+  {
+    simNodeCb.airCback(hdr.src, buf + sizeof(simMsgHdr_t), hdr.len);
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Ask the coordinator to stop all nodes.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeFinish(void)
+{
+  simMsgHdr_t hdr;
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.type = SIM_MSG_FINISH;
+  hdr.time = simNodeCb.now;
+
+  simNodeSend(&hdr, NULL);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time this process spent in the simulation link.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimNodeGetLinkCpuNs(void)
+{
+  return simNodeCb.linkCpuNs;
+}
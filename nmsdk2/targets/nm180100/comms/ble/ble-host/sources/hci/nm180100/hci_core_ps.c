@@ -262,6 +262,20 @@ uint8_t HciGetNumBufs(void)
   return hciCoreCb.numBufs;
 }
 
+/*************************************************************************************************/
+/*!
+ *  \fn     HciGetAvailableBufs
+ *
+ *  \brief  Return the number of controller ACL buffers currently free.
+ *
+ *  \return Number of free ACL buffers.
+ */
+/*************************************************************************************************/
+uint8_t HciGetAvailableBufs(void)
+{
+  return hciCoreCb.availBufs;
+}
+
 /*************************************************************************************************/
 /*!
  *  \fn     HciGetSupStates
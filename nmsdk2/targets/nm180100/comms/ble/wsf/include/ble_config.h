@@ -39,6 +39,8 @@
 
 #define WSF_NVM_NUM_OF_PAGES    2
 #define WSF_NVM_PAGE_SIZE       AM_HAL_FLASH_PAGE_SIZE
-#define WSF_NVM_START_ADDR      (AM_HAL_FLASH_LARGEST_VALID_ADDR + 1 - ((WSF_NVM_NUM_OF_PAGES + 4) * AM_HAL_FLASH_PAGE_SIZE))
+// The second flash instance is the OTA staging area; keep the NVM pages at the
+// end of the first instance, just below the LoRaWAN EEPROM emulation pages.
+#define WSF_NVM_START_ADDR      (AM_HAL_FLASH_INSTANCE_SIZE - ((WSF_NVM_NUM_OF_PAGES + 2) * AM_HAL_FLASH_PAGE_SIZE))
 
 #endif
\ No newline at end of file
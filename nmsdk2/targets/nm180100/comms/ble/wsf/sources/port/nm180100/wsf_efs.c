@@ -444,7 +444,10 @@ uint16_t WsfEfsPut(wsfEfsHandle_t handle, uint32_t offset, const uint8_t *pBuffe
             len = (uint16_t) (pFile->maxSize - offset);
           }
 
-          wsfEfsMediaTbl[media]->write(pBuffer, address, len);
+          if (wsfEfsMediaTbl[media]->write(pBuffer, address, len) != WSF_EFS_SUCCESS)
+          {
+            return 0;
+          }
 
           /* If writing to the end of the file, update the file size */
           if (offset + len > pFile->size)
@@ -22,31 +22,62 @@
  */
 /*************************************************************************************************/
 
+#include <string.h>
+
+#include "am_mcu_apollo.h"
+
 #include "wsf_types.h"
 #include "wsf_assert.h"
+#include "wsf_trace.h"
 #include "wsf_nvm.h"
 #include "util/crc32.h"
 
+#include "ble_config.h"
+
 /**************************************************************************************************
   Macros
 **************************************************************************************************/
 
-/*! NVM data start address. */
-#define WSF_NVM_START_ADDR                        0x0000
+/*! NVM data end address. */
+#define WSF_NVM_END_ADDR                          (WSF_NVM_START_ADDR + \
+                                                   (WSF_NVM_NUM_OF_PAGES * WSF_NVM_PAGE_SIZE))
+
+/*! Flash programming word size. */
+#define WSF_NVM_WORD_SIZE                         4
 
 /*! Reserved filecode. */
 #define WSF_NVM_RESERVED_FILECODE                 ((uint32_t)0)
 
 /* Unused (erased) filecode. */
-/* TODO: May depend on flash type */
 #define WSF_NVM_UNUSED_FILECODE                   ((uint32_t)0xFFFFFFFF)
 
 /*! Align value to word boundary. */
-#define WSF_NVM_WORD_ALIGN(x)                     (((x) + (PAL_NVM_WORD_SIZE - 1)) & \
-                                                         ~(PAL_NVM_WORD_SIZE - 1))
+#define WSF_NVM_WORD_ALIGN(x)                     (((x) + (WSF_NVM_WORD_SIZE - 1)) & \
+                                                         ~(WSF_NVM_WORD_SIZE - 1))
 
 #define WSF_NVM_CRC_INIT_VALUE                    0xFEDCBA98
 
+/*! Storage is split into two banks; compaction copies the current records from one to the other. */
+#define WSF_NVM_BANK_PAGES                        (WSF_NVM_NUM_OF_PAGES / 2)
+
+/*! Bank size. */
+#define WSF_NVM_BANK_SIZE                         (WSF_NVM_BANK_PAGES * WSF_NVM_PAGE_SIZE)
+
+/*! Bank address. */
+#define WSF_NVM_BANK_ADDR(bank)                   (WSF_NVM_START_ADDR + ((bank) * WSF_NVM_BANK_SIZE))
+
+/*! Address of the first record of a bank. */
+#define WSF_NVM_RECORD_ADDR(bankAddr)             ((bankAddr) + sizeof(WsfNvmBankHeader_t))
+
+/*! Bank header magic, programmed once the bank holds a complete copy of the records. */
+#define WSF_NVM_BANK_MAGIC                        ((uint32_t)0x4E564D42)
+
+/*! Pointer to a storage address. */
+#define WSF_NVM_PTR(addr)                         ((uint8_t *)(uintptr_t)(addr))
+
+/*! Words programmed per flash call when copying unaligned data. */
+#define WSF_NVM_PROGRAM_WORDS                     16
+
 /**************************************************************************************************
   Data Types
 **************************************************************************************************/
@@ -60,6 +91,342 @@ typedef struct
   uint32_t          dataCrc;    /*!< CRC of subsequent data. */
 } WsfNvmHeader_t;
 
+/*! \brief      Bank header. */
+typedef struct
+{
+  uint32_t          magic;      /*!< WSF_NVM_BANK_MAGIC on a complete bank. */
+  uint32_t          seq;        /*!< Compaction generation. */
+} WsfNvmBankHeader_t;
+
+WSF_CT_ASSERT((WSF_NVM_NUM_OF_PAGES >= 2) && ((WSF_NVM_NUM_OF_PAGES % 2) == 0));
+
+/**************************************************************************************************
+  Local Functions
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Read the header at a storage address.
+ *
+ *  \param  storageAddr   Header address.
+ *  \param  bankAddr      Address of the bank holding the header.
+ *  \param  pHeader       Header read.
+ *
+ *  \return TRUE if the address holds a record, FALSE at the end of the used storage.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmReadHeader(uint32_t storageAddr, uint32_t bankAddr, WsfNvmHeader_t *pHeader)
+{
+  if ((storageAddr + sizeof(WsfNvmHeader_t)) > (bankAddr + WSF_NVM_BANK_SIZE))
+  {
+    return FALSE;
+  }
+
+  memcpy(pHeader, WSF_NVM_PTR(storageAddr), sizeof(WsfNvmHeader_t));
+
+  if (pHeader->id == WSF_NVM_UNUSED_FILECODE)
+  {
+    /* Found unused entry at end of used storage. */
+    return FALSE;
+  }
+
+  if ((pHeader->id != WSF_NVM_RESERVED_FILECODE) &&
+      (CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(pHeader->id) + sizeof(pHeader->len),
+                 (uint8_t *)pHeader) != pHeader->headerCrc))
+  {
+    /* Corrupt header, treat the rest of the bank as unusable until compacted. */
+    WSF_TRACE_WARN1("WsfNvm corrupt header at 0x%08x", storageAddr);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Check that a storage range is still erased.
+ *
+ *  \param  storageAddr   Word aligned start address.
+ *  \param  len           Range length.
+ *
+ *  \return TRUE if every word of the range is erased.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmIsErased(uint32_t storageAddr, uint32_t len)
+{
+  uint32_t word;
+
+  for (len = WSF_NVM_WORD_ALIGN(len); len > 0; len -= WSF_NVM_WORD_SIZE, storageAddr += WSF_NVM_WORD_SIZE)
+  {
+    memcpy(&word, WSF_NVM_PTR(storageAddr), sizeof(word));
+    if (word != WSF_NVM_UNUSED_FILECODE)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Program data of any alignment and length into flash.
+ *
+ *  \param  storageAddr   Word aligned destination address.
+ *  \param  pData         Data to program.
+ *  \param  len           Data length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmProgram(uint32_t storageAddr, const uint8_t *pData, uint32_t len)
+{
+  uint32_t words[WSF_NVM_PROGRAM_WORDS];
+  uint32_t chunk;
+
+  while (len > 0)
+  {
+    chunk = (len < sizeof(words)) ? len : sizeof(words);
+
+    /* pad the last word with the erased value */
+    memset(words, 0xFF, sizeof(words));
+    memcpy(words, pData, chunk);
+
+    am_hal_flash_program_main(AM_HAL_FLASH_PROGRAM_KEY, words, (uint32_t *)(uintptr_t)storageAddr,
+                              WSF_NVM_WORD_ALIGN(chunk) / WSF_NVM_WORD_SIZE);
+
+    storageAddr += WSF_NVM_WORD_ALIGN(chunk);
+    pData += chunk;
+    len -= chunk;
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase storage pages.
+ *
+ *  \param  eraseAddr     Address of the first page.
+ *  \param  numOfPages    Number of pages to erase.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmErasePages(uint32_t eraseAddr, uint32_t numOfPages)
+{
+  for (; (numOfPages > 0) && (eraseAddr < WSF_NVM_END_ADDR); numOfPages--, eraseAddr += WSF_NVM_PAGE_SIZE)
+  {
+    am_hal_flash_page_erase(AM_HAL_FLASH_PROGRAM_KEY,
+                            AM_HAL_FLASH_ADDR2INST(eraseAddr),
+                            AM_HAL_FLASH_ADDR2PAGE(eraseAddr));
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Erase a bank and mark it as holding the records of a compaction generation.
+ *
+ *  \param  bankAddr      Bank address.
+ *  \param  seq           Compaction generation.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfNvmFormat(uint32_t bankAddr, uint32_t seq)
+{
+  WsfNvmBankHeader_t bank;
+
+  bank.magic = WSF_NVM_BANK_MAGIC;
+  bank.seq = seq;
+
+  wsfNvmErasePages(bankAddr, WSF_NVM_BANK_PAGES);
+  wsfNvmProgram(bankAddr, (const uint8_t *)&bank, sizeof(bank));
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the bank holding the current records, formatting the storage if neither does.
+ *
+ *  A compaction writes the live records to the spare bank, marks it and only then erases the old
+ *  bank. A bank header is therefore only present on a complete copy; if a reset left both banks
+ *  marked, the newer generation is current.
+ *
+ *  \return Active bank address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmActiveBank(void)
+{
+  WsfNvmBankHeader_t bank0, bank1;
+  bool_t valid0, valid1;
+
+  memcpy(&bank0, WSF_NVM_PTR(WSF_NVM_BANK_ADDR(0)), sizeof(bank0));
+  memcpy(&bank1, WSF_NVM_PTR(WSF_NVM_BANK_ADDR(1)), sizeof(bank1));
+  valid0 = (bank0.magic == WSF_NVM_BANK_MAGIC);
+  valid1 = (bank1.magic == WSF_NVM_BANK_MAGIC);
+
+  if (valid0 && valid1)
+  {
+    return ((int32_t)(bank1.seq - bank0.seq) > 0) ? WSF_NVM_BANK_ADDR(1) : WSF_NVM_BANK_ADDR(0);
+  }
+
+  if (valid1)
+  {
+    return WSF_NVM_BANK_ADDR(1);
+  }
+
+  if (!valid0)
+  {
+    /* Blank storage. */
+    wsfNvmFormat(WSF_NVM_BANK_ADDR(0), 0);
+  }
+
+  return WSF_NVM_BANK_ADDR(0);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Get the address following the last record of a bank.
+ *
+ *  \param  bankAddr      Bank address.
+ *
+ *  \return Free storage address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmFreeAddr(uint32_t bankAddr)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return storageAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Find the current record of an ID.
+ *
+ *  A write appends the new record before it scratches out the old one, so after a reset both may
+ *  be present. The last copy whose data is intact is the current one.
+ *
+ *  \param  bankAddr      Bank address.
+ *  \param  id            Stored data ID.
+ *  \param  pHeader       Header of the record found.
+ *
+ *  \return Record address, or 0 if the ID is not stored.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmFind(uint32_t bankAddr, uint32_t id, WsfNvmHeader_t *pHeader)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  uint32_t foundAddr = 0;
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    if ((header.id == id) &&
+        (CalcCrc32(WSF_NVM_CRC_INIT_VALUE, header.len,
+                   WSF_NVM_PTR(storageAddr + sizeof(header))) == header.dataCrc))
+    {
+      *pHeader = header;
+      foundAddr = storageAddr;
+    }
+
+    /* Move to next stored data block and read header. */
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return foundAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Copy the current records to the spare bank and make it the active one.
+ *
+ *  The old bank is only erased once the spare bank holds a complete, marked copy, so a reset
+ *  at any point leaves one bank with every current record.
+ *
+ *  \param  bankAddr      Active bank address.
+ *
+ *  \return New active bank address.
+ */
+/*************************************************************************************************/
+static uint32_t wsfNvmCompact(uint32_t bankAddr)
+{
+  WsfNvmHeader_t header, current;
+  WsfNvmBankHeader_t bank;
+  uint32_t spareAddr = (bankAddr == WSF_NVM_BANK_ADDR(0)) ? WSF_NVM_BANK_ADDR(1) : WSF_NVM_BANK_ADDR(0);
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  uint32_t copyAddr = WSF_NVM_RECORD_ADDR(spareAddr);
+  uint32_t recordLen;
+
+  memcpy(&bank, WSF_NVM_PTR(bankAddr), sizeof(bank));
+
+  /* The spare bank may hold part of an interrupted copy. */
+  wsfNvmErasePages(spareAddr, WSF_NVM_BANK_PAGES);
+
+  while (wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    recordLen = WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+
+    if ((header.id != WSF_NVM_RESERVED_FILECODE) &&
+        (wsfNvmFind(bankAddr, header.id, &current) == storageAddr))
+    {
+      wsfNvmProgram(copyAddr, WSF_NVM_PTR(storageAddr), recordLen);
+      copyAddr += recordLen;
+    }
+
+    storageAddr += recordLen;
+  }
+
+  /* Mark the copy complete, then retire the old bank. */
+  bank.magic = WSF_NVM_BANK_MAGIC;
+  bank.seq++;
+  wsfNvmProgram(spareAddr, (const uint8_t *)&bank, sizeof(bank));
+  wsfNvmErasePages(bankAddr, WSF_NVM_BANK_PAGES);
+
+  return spareAddr;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Scratch out the records of an ID stored before an address.
+ *
+ *  \param  bankAddr  Bank address.
+ *  \param  id        Stored data ID.
+ *  \param  endAddr   Address of the first record to keep.
+ *
+ *  \return TRUE if a record was scratched out.
+ */
+/*************************************************************************************************/
+static bool_t wsfNvmScratch(uint32_t bankAddr, uint32_t id, uint32_t endAddr)
+{
+  WsfNvmHeader_t header;
+  uint32_t storageAddr = WSF_NVM_RECORD_ADDR(bankAddr);
+  bool_t erased = FALSE;
+
+  while ((storageAddr < endAddr) && wsfNvmReadHeader(storageAddr, bankAddr, &header))
+  {
+    if (header.id == id)
+    {
+      /* Valid header and matching ID - scratch header out; programming can only clear bits. */
+      header.id = WSF_NVM_RESERVED_FILECODE;
+      header.headerCrc = 0;
+      header.dataCrc = 0;
+      wsfNvmProgram(storageAddr, (const uint8_t *)&header, sizeof(header));
+
+      erased = TRUE;
+    }
+
+    /* Move to next stored data block and read header. */
+    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
+  }
+
+  return erased;
+}
+
 /**************************************************************************************************
   Global Functions
 **************************************************************************************************/
@@ -73,6 +440,7 @@ typedef struct
 /*************************************************************************************************/
 void WsfNvmInit(void)
 {
+
 }
 
 /*************************************************************************************************/
@@ -90,54 +458,17 @@ void WsfNvmInit(void)
 bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
 {
   WsfNvmHeader_t header;
-  uint32_t headerCrc, dataCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
+  uint32_t storageAddr;
   bool_t findId = FALSE;
 
   WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
 
-  /* Read first header. */
-  memcpy(&header, (const void *)storageAddr, sizeof(header));
-
-  do
+  storageAddr = wsfNvmFind(wsfNvmActiveBank(), id, &header);
+  if ((storageAddr != 0) && (header.len == len))
   {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
-    {
-      /* Found unused entry at end of used storage. */
-      break;
-    }
-
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
-    {
-      /* Calculate CRC of header itself. */
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
-
-      if (headerCrc != header.headerCrc)
-      {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
-        break;
-      }
-      else if ((header.id == id) && (header.len == len))
-      {
-        /* Valid header and matching ID - read data after header. */
-        storageAddr += sizeof(header);
-        memcpy(pData, (const void *)storageAddr, sizeof(header.len));
-        dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, header.len, pData);
-        if (dataCrc == header.dataCrc)
-        {
-          findId = TRUE;
-        }
-        break;
-      }
-    }
-
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    memcpy(&header, (const void *)storageAddr, sizeof(header));
-  } while(1);
+    memcpy(pData, WSF_NVM_PTR(storageAddr + sizeof(header)), header.len);
+    findId = TRUE;
+  }
 
   if (compCback)
   {
@@ -161,70 +492,48 @@ bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent
 bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
 {
   WsfNvmHeader_t header;
-  uint32_t headerCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
+  uint32_t bankAddr = wsfNvmActiveBank();
+  uint32_t storageAddr;
+  uint32_t recordLen = WSF_NVM_WORD_ALIGN(len) + sizeof(header);
+  bool_t written = FALSE;
 
   WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
 
-  /* Read first header. */
-  memcpy(&header, (const void *)storageAddr, sizeof(header));
-
-  do
+  /* Compact when the bank is full or ends in a record torn by a reset. */
+  storageAddr = wsfNvmFreeAddr(bankAddr);
+  if (((storageAddr + recordLen) > (bankAddr + WSF_NVM_BANK_SIZE)) ||
+      !wsfNvmIsErased(storageAddr, recordLen))
   {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
-    {
-      /* Found unused entry at end of used storage. */
-      break;
-    }
-
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
-    {
-      /* Calculate CRC of header itself. */
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
-
-      if (headerCrc != header.headerCrc)
-      {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
-        break;
-      }
-      else if (header.id == id)
-      {
-        /* Valid header and matching ID - scratch header out. */
-        header.id = WSF_NVM_RESERVED_FILECODE;
-        header.headerCrc = 0;
-        header.dataCrc = 0;
-        am_hal_flash_program_main(
-          AM_HAL_FLASH_PROGRAM_KEY, (uint32_t *)&header,
-          (uint32_t *)storageAddr, sizeof(header) / WSF_FLASH_WORD_SIZE);
-      }
-    }
+    bankAddr = wsfNvmCompact(bankAddr);
+    storageAddr = wsfNvmFreeAddr(bankAddr);
+  }
 
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    memcpy(&header, (const void *)storageAddr, sizeof(header));
-  } while(1);
-
-  /* After cycling through all headers, create a new stored data header and store data */
-  header.id = id;
-  header.len = len;
-  header.headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                               (uint8_t *)&header);
-  header.dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, len, pData);
-  am_hal_flash_program_main(
-    AM_HAL_FLASH_PROGRAM_KEY, (uint32_t *)&header,
-    (uint32_t *)storageAddr, sizeof(header) / WSF_FLASH_WORD_SIZE);
-  am_hal_flash_program_main(
-    AM_HAL_FLASH_PROGRAM_KEY, (uint32_t *)pData,
-    (uint32_t *)(storageAddr + sizeof(header)), len / WSF_FLASH_WORD_SIZE);
+  if ((storageAddr + recordLen) <= (bankAddr + WSF_NVM_BANK_SIZE))
+  {
+    /* Create a new stored data header and store data */
+    header.id = id;
+    header.len = len;
+    header.headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
+                                 (uint8_t *)&header);
+    header.dataCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, len, pData);
+
+    wsfNvmProgram(storageAddr, (const uint8_t *)&header, sizeof(header));
+    wsfNvmProgram(storageAddr + sizeof(header), pData, len);
+
+    /* Scratch out the previous copy once the new one is in place. */
+    wsfNvmScratch(bankAddr, id, storageAddr);
+    written = TRUE;
+  }
+  else
+  {
+    WSF_TRACE_ERR1("WsfNvm full, id 0x%08x not written", id);
+  }
 
   if (compCback)
   {
-    compCback(TRUE);
+    compCback(written);
   }
-  return TRUE;
+  return written;
 }
 
 /*************************************************************************************************/
@@ -239,53 +548,12 @@ bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCo
 /*************************************************************************************************/
 bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
 {
-  WsfNvmHeader_t header;
-  uint32_t headerCrc;
-  uint32_t storageAddr = WSF_NVM_START_ADDR;
-  bool_t erased = FALSE;
+  uint32_t bankAddr = wsfNvmActiveBank();
+  bool_t erased;
 
   WSF_ASSERT(!((id == WSF_NVM_RESERVED_FILECODE) || (id == WSF_NVM_UNUSED_FILECODE)));
 
-  /* Read first header. */
-  memcpy(&header, (const void *)storageAddr, sizeof(header));
-
-  do
-  {
-    if (header.id == WSF_NVM_UNUSED_FILECODE)
-    {
-      /* Found unused entry at end of used storage. */
-      break;
-    }
-
-    /* Iterate through stored data headers, looking for existing matching stored data header. */
-    if (header.id != WSF_NVM_RESERVED_FILECODE)
-    {
-      headerCrc = CalcCrc32(WSF_NVM_CRC_INIT_VALUE, sizeof(header.id) + sizeof(header.len),
-                            (uint8_t *)&header);
-
-      if (headerCrc != header.headerCrc)
-      {
-        /* Corrupt header. */
-        /* TODO: Catastrophic failure? */
-        break;
-      }
-      else if (header.id == id)
-      {
-        header.id = WSF_NVM_RESERVED_FILECODE;
-        header.headerCrc = 0;
-        header.dataCrc = 0;
-        am_hal_flash_program_main(
-          AM_HAL_FLASH_PROGRAM_KEY, (uint32_t *)&header,
-          (uint32_t *)storageAddr, sizeof(header) / WSF_FLASH_WORD_SIZE);
-
-        erased = TRUE;
-      }
-    }
-
-    /* Move to next stored data block and read header. */
-    storageAddr += WSF_NVM_WORD_ALIGN(header.len) + sizeof(header);
-    memcpy(&header, (const void *)storageAddr, sizeof(header));
-  } while(1);
+  erased = wsfNvmScratch(bankAddr, id, bankAddr + WSF_NVM_BANK_SIZE);
 
   if (compCback)
   {
@@ -298,6 +566,8 @@ bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
 /*!
  *  \brief  Erase sectors.
  *
+ *  The storage is always cleared as a whole so that the bank headers stay consistent.
+ *
  *  \param  numOfSectors       Number of sectors to be erased.
  *  \param  compCback          Erase callback.
  *
@@ -306,13 +576,10 @@ bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
 /*************************************************************************************************/
 void WsfNvmEraseSector(uint32_t numOfSectors, WsfNvmCompEvent_t compCback)
 {
-  PalNvmEraseSector(numOfSectors * PAL_NVM_SECTOR_SIZE, WSF_NVM_START_ADDR);
-  for (uint32_t eraseAddr = WSF_NVM_START_ADDR; eraseAddr < wsfNvmCb.availAddr; eraseAddr += wsfNvmCb.sectorSize)
+  if (numOfSectors > 0)
   {
-    am_hal_flash_page_erase(
-        AM_HAL_FLASH_PROGRAM_KEY,
-        AM_HAL_FLASH_ADDR2INST(eraseAddr),
-        AM_HAL_FLASH_ADDR2PAGE(eraseAddr));
+    wsfNvmErasePages(WSF_NVM_BANK_ADDR(1), WSF_NVM_BANK_PAGES);
+    wsfNvmFormat(WSF_NVM_BANK_ADDR(0), 0);
   }
 
   if (compCback)
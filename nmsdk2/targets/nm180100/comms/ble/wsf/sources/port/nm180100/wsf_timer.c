@@ -22,6 +22,7 @@
  */
 /*************************************************************************************************/
 #include "am_mcu_apollo.h"
+#include "stimer_mux.h"
 
 #include "wsf_types.h"
 #include "wsf_queue.h"
@@ -52,20 +53,15 @@ wsfQueue_t  wsfTimerTimerQueue;     /*!< Timer queue */
 /*! \brief  Last RTC value read. */
 static uint32_t wsfTimerRtcLastTicks = 0;
 
-void am_stimer_cmpr4_isr(void)
-{
-  am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREE);
-
-  am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPAREF);
-  am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREF);
-
-  WsfTaskSetReady(0, WSF_TIMER_EVENT);
-}
-
-void am_stimer_cmpr5_isr(void)
+/*************************************************************************************************/
+/*!
+ *  \brief  STIMER deadline handler, called from the compare interrupt.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void wsfTimerStimerHandler(void)
 {
-  am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREF);
-
   WsfTaskSetReady(0, WSF_TIMER_EVENT);
 }
 
@@ -164,20 +160,10 @@ void WsfTimerInit(void)
 {
   WSF_QUEUE_INIT(&wsfTimerTimerQueue);
 
-  am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREE);
-  am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREF);
-  NVIC_EnableIRQ(STIMER_CMPR4_IRQn);
-  NVIC_EnableIRQ(STIMER_CMPR5_IRQn);
-
-  uint32_t oldCfg = am_hal_stimer_config(AM_HAL_STIMER_CFG_FREEZE);
-
-  am_hal_stimer_config(
-      (oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE | CTIMER_STCFG_CLKSEL_Msk))
-      | CLOCK_SOURCE
-      | AM_HAL_STIMER_CFG_COMPARE_E_ENABLE
-      | AM_HAL_STIMER_CFG_COMPARE_F_ENABLE
-      );
-
+  /* WSF timers have a resolution of one WSF tick, so their wakeup may be
+   * shared with any STIMER deadline up to one tick later. */
+  stimer_mux_init(CLOCK_SOURCE);
+  stimer_mux_register(STIMER_MUX_WSF, wsfTimerStimerHandler, CLK_TICKS_PER_WSF_TICKS);
 
   wsfTimerRtcLastTicks = am_hal_stimer_counter_get();
 }
@@ -378,23 +364,11 @@ void WsfTimerSleep(void)
   if (nextExpiration > 0)
   {
     uint32_t sleep_ticks = nextExpiration * CLK_TICKS_PER_WSF_TICKS;
-    am_hal_stimer_compare_delta_set(4, sleep_ticks);
-    am_hal_stimer_compare_delta_set(5, sleep_ticks+1);
-
-    /* enable RTC interrupt */
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREE);
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREF);
-
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREE);
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREF);
+    stimer_mux_start(STIMER_MUX_WSF, am_hal_stimer_counter_get() + sleep_ticks);
   }
   else
   {
-    am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPAREE);
-    am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPAREF);
-
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREE);
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREF);
+    stimer_mux_stop(STIMER_MUX_WSF);
   }
 }
 
@@ -701,6 +701,7 @@ static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
     TxParams.TxPower = mcpsConfirm->TxPower;
     TxParams.Channel = mcpsConfirm->Channel;
     TxParams.AckReceived = mcpsConfirm->AckReceived;
+    TxParams.TxTimeOnAir = mcpsConfirm->TxTimeOnAir;
 
     LmHandlerCallbacks->OnTxData( &TxParams );
 
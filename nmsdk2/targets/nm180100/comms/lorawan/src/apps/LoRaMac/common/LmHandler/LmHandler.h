@@ -51,6 +51,7 @@ typedef struct LmHandlerTxParams_s
     LmHandlerAppData_t AppData;
     int8_t TxPower;
     uint8_t Channel;
+    TimerTime_t TxTimeOnAir;
 }LmHandlerTxParams_t;
 
 typedef struct LmHandlerRxParams_s
@@ -26,27 +26,27 @@
 #include "eeprom_emulation.h"
 #include "lorawan_eeprom_config.h"
 
-uint8_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+LmnStatus_t EepromMcuWriteBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
 {
     eeprom_write_array_len(&lorawan_eeprom_handle, addr + 1, buffer, size);
-    return 1;
+    return LMN_STATUS_OK;
 }
 
-uint8_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
+LmnStatus_t EepromMcuReadBuffer( uint16_t addr, uint8_t *buffer, uint16_t size )
 {
     if (!eeprom_read_array_len(&lorawan_eeprom_handle, addr + 1, buffer, size))
     {
-        return 0;
+        return LMN_STATUS_ERROR;
     }
 
-    return 1;
+    return LMN_STATUS_OK;
 }
 
 void EepromMcuSetDeviceAddr( uint8_t addr )
 {
 }
 
-uint8_t EepromMcuGetDeviceAddr( void )
+LmnStatus_t EepromMcuGetDeviceAddr( void )
 {
     return 0;
 }
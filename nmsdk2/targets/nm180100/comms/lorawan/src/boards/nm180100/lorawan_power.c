@@ -37,4 +37,9 @@ void lorawan_wake_on_timer_irq(void)  __attribute ((weak, alias("lorawan_wake"))
 void lorawan_wake(void)
 {
 
-}
\ No newline at end of file
+}
+
+__attribute ((weak)) void lorawan_radio_mode_changed(uint32_t ui32Mode, int8_t i8TxPower)
+{
+
+}
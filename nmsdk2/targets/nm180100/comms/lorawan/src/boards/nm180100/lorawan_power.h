@@ -32,7 +32,15 @@
 #ifndef __LORAWAN_POWER_H__
 #define __LORAWAN_POWER_H__
 
+#include <stdint.h>
+
 extern void lorawan_wake_on_radio_irq(void);
 extern void lorawan_wake_on_timer_irq(void);
 
+//
+// Called on every SX126x operating mode change.  ui32Mode is a
+// RadioOperatingModes_t and i8TxPower the last configured TX power in dBm.
+//
+extern void lorawan_radio_mode_changed(uint32_t ui32Mode, int8_t i8TxPower);
+
 #endif
\ No newline at end of file
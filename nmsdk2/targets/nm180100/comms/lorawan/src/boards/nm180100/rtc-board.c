@@ -42,6 +42,7 @@
 
 #include "lorawan_power.h"
 #include "lorawan_config.h"
+#include "stimer_mux.h"
 
 // The typical transition time from deep-sleep to run mode is 25us (Chapter 22.4).
 // A single alarm tick using a 32.768kHz crystal is about 30.5us.  At the nominal
@@ -69,53 +70,23 @@ typedef struct {
 static RtcTimerContext_t RtcTimerContext;
 static uint32_t rtc_backup[2];
 
-void am_stimer_cmpr2_isr(void)
+static void RtcAlarmHandler(void)
 {
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREC);
-
-    am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPARED);
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPARED);
-
     if (RtcTimerContext.Running) {
-        if (am_hal_stimer_counter_get() >= RtcTimerContext.Alarm_Ticks) {
-            RtcTimerContext.Running = false;
-            TimerIrqHandler();
-            
-            lorawan_wake_on_timer_irq();
-        }
-    }
-}
-
-void am_stimer_cmpr3_isr(void)
-{
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPARED);
+        RtcTimerContext.Running = false;
+        TimerIrqHandler();
 
-    if (RtcTimerContext.Running) {
-        if (am_hal_stimer_counter_get() >= RtcTimerContext.Alarm_Ticks) {
-            RtcTimerContext.Running = false;
-            TimerIrqHandler();
-            
-            lorawan_wake_on_timer_irq();
-        }
+        lorawan_wake_on_timer_irq();
     }
 }
 
 void RtcInit(void)
 {
     if (RtcInitialized == false) {
-        am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREC);
-        am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPARED);
-        NVIC_EnableIRQ(STIMER_CMPR2_IRQn);
-        NVIC_EnableIRQ(STIMER_CMPR3_IRQn);
-
-        uint32_t oldCfg = am_hal_stimer_config(AM_HAL_STIMER_CFG_FREEZE);
-
-        am_hal_stimer_config(
-            (oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE | CTIMER_STCFG_CLKSEL_Msk))
-            | CLOCK_SOURCE
-            | AM_HAL_STIMER_CFG_COMPARE_C_ENABLE
-            | AM_HAL_STIMER_CFG_COMPARE_D_ENABLE
-            );
+        // The receive windows are timed to the tick, so the alarm is
+        // never delayed to share a wakeup.
+        stimer_mux_init(CLOCK_SOURCE);
+        stimer_mux_register(STIMER_MUX_LORAWAN, RtcAlarmHandler, 0);
 
         RtcSetTimerContext();
 
@@ -165,11 +136,7 @@ void RtcSetAlarm(uint32_t timeout) { RtcStartAlarm(timeout); }
 
 void RtcStopAlarm(void)
 {
-    am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPAREC);
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREC);
-
-    am_hal_stimer_int_disable(AM_HAL_STIMER_INT_COMPARED);
-    am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPARED);
+    stimer_mux_stop(STIMER_MUX_LORAWAN);
 
     RtcTimerContext.Running = false;
 }
@@ -181,14 +148,14 @@ void RtcStartAlarm(uint32_t timeout)
     // timeout is already in ticks
     RtcTimerContext.Alarm_Ticks = timeout;
 
-    uint32_t relative = timeout - RtcGetTimerElapsedTime();
+    // The timer list wakes up early for an alarm beyond the reach of the
+    // STIMER compare and sets it again.
+    if (timeout > STIMER_MUX_MAX_DELTA) {
+        timeout = STIMER_MUX_MAX_DELTA;
+    }
 
     RtcTimerContext.Running     = true;
-    am_hal_stimer_compare_delta_set(2, relative);
-    am_hal_stimer_compare_delta_set(3, relative+1);
-
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREC);
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPARED);
+    stimer_mux_start(STIMER_MUX_LORAWAN, RtcTimerContext.Ref_Ticks + timeout);
 }
 
 uint32_t RtcGetTimerValue(void) { return am_hal_stimer_counter_get(); }
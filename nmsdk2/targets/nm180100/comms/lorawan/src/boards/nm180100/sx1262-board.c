@@ -85,6 +85,7 @@ static am_hal_iom_config_t SX126xSpi;
 void *SX126xHandle;
 
 static RadioOperatingModes_t OperatingMode;
+static int8_t OperatingTxPower;
 
 static void (*SX126xL3RadioIrqHandle)(void *) = NULL;
 
@@ -297,6 +298,7 @@ RadioOperatingModes_t SX126xGetOperatingMode(void) { return OperatingMode; }
 void SX126xSetOperatingMode(RadioOperatingModes_t mode)
 {
     OperatingMode = mode;
+    lorawan_radio_mode_changed(mode, OperatingTxPower);
 }
 
 void SX126xReset(void)
@@ -394,6 +396,7 @@ void SX126xReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
 
 void SX126xSetRfTxPower(int8_t power)
 {
+    OperatingTxPower = power;
     SX126xSetTxParams(power, RADIO_RAMP_40_US);
 }
 
@@ -1,4 +1,7 @@
 RTOS	:= $(SDK_ROOT)/rtos/FreeRTOS
 RTOS_LIB_DBG  := librtos$(SUFFIX_DBG).a
 RTOS_LIB_REL  := librtos$(SUFFIX_REL).a
-FREERTOS_CONFIG ?= $(RTOS)/../../targets/nm180100/rtos/FreeRTOS/FreeRTOSConfig.h
\ No newline at end of file
+FREERTOS_CONFIG ?= $(RTOS)/../../targets/nm180100/rtos/FreeRTOS/FreeRTOSConfig.h
+
+# FreeRTOS heap implementation, heap_4 or heap_tlsf
+RTOS_HEAP ?= heap_4
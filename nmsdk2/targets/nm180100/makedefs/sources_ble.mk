@@ -27,6 +27,7 @@ VPATH += $(BLE)/ble-profiles/sources/profiles/atps
 VPATH += $(BLE)/ble-profiles/sources/profiles/bas
 VPATH += $(BLE)/ble-profiles/sources/profiles/blpc
 VPATH += $(BLE)/ble-profiles/sources/profiles/blps
+VPATH += $(BLE)/ble-profiles/sources/profiles/cpm
 VPATH += $(BLE)/ble-profiles/sources/profiles/cpp
 VPATH += $(BLE)/ble-profiles/sources/profiles/cscp
 VPATH += $(BLE)/ble-profiles/sources/profiles/dis
@@ -61,6 +62,7 @@ BLE_SRC += atps_main.c
 BLE_SRC += bas_main.c
 BLE_SRC += blpc_main.c
 BLE_SRC += blps_main.c
+BLE_SRC += cpm_main.c
 BLE_SRC += cpps_main.c
 BLE_SRC += cscps_main.c
 BLE_SRC += dis_main.c
@@ -145,8 +147,10 @@ BLE_SRC += attc_read.c
 BLE_SRC += attc_sign.c
 BLE_SRC += attc_write.c
 BLE_SRC += atts_ccc.c
+BLE_SRC += atts_coal.c
 BLE_SRC += atts_csf.c
 BLE_SRC += atts_dyn.c
+BLE_SRC += atts_idx.c
 BLE_SRC += atts_ind.c
 BLE_SRC += atts_main.c
 BLE_SRC += atts_proc.c
@@ -247,7 +251,7 @@ BLE_SRC += wsf_detoken.c
 BLE_SRC += wsf_efs.c
 BLE_SRC += wsf_heap.c
 BLE_SRC += wsf_msg.c
-#BLE_SRC += wsf_nvm.c
+BLE_SRC += wsf_nvm.c
 BLE_SRC += wsf_os.c
 BLE_SRC += wsf_queue.c
 BLE_SRC += wsf_timer.c
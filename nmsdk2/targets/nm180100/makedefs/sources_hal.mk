@@ -49,4 +49,5 @@ HAL_SRC += am_util_string.c
 HAL_SRC += am_util_time.c
 
 VPATH += ./utils
-HAL_SRC += eeprom_emulation.c
\ No newline at end of file
+HAL_SRC += eeprom_emulation.c
+HAL_SRC += stimer_mux.c
\ No newline at end of file
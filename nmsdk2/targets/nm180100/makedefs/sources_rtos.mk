@@ -9,7 +9,7 @@ RTOS_SRC += queue.c
 RTOS_SRC += stream_buffer.c
 RTOS_SRC += tasks.c
 RTOS_SRC += timers.c
-RTOS_SRC += heap_4.c
+RTOS_SRC += $(RTOS_HEAP).c
 RTOS_SRC += port.c
 
 RTOS_SRC += FreeRTOS_CLI.c
\ No newline at end of file
@@ -0,0 +1,520 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Two level segregated fit (TLSF) implementation of pvPortMalloc() and
+ * vPortFree().  Free blocks are kept in size classes indexed by a first level
+ * (power of two) and a second level (linear subdivision of that power of two)
+ * with a bitmap for each level, so finding a suitable block, splitting and
+ * coalescing are all constant time operations.
+ *
+ * Select it instead of heap_4.c with RTOS_HEAP := heap_tlsf.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#if ( portBYTE_ALIGNMENT != 8 )
+    #error heap_tlsf.c assumes an 8 byte alignment
+#endif
+
+/* Second level subdivisions per power of two, 16 gives a worst case internal
+ * fragmentation of about 6%. */
+#define tlsfSL_INDEX_COUNT_LOG2    ( 4 )
+#define tlsfSL_INDEX_COUNT         ( 1U << tlsfSL_INDEX_COUNT_LOG2 )
+
+#define tlsfALIGN_SIZE_LOG2        ( 3 )
+#define tlsfALIGN_SIZE             ( 1U << tlsfALIGN_SIZE_LOG2 )
+
+/* Blocks below tlsfSMALL_BLOCK_SIZE share the first level and are split in
+ * tlsfALIGN_SIZE steps. */
+#define tlsfFL_INDEX_SHIFT         ( tlsfSL_INDEX_COUNT_LOG2 + tlsfALIGN_SIZE_LOG2 )
+#define tlsfSMALL_BLOCK_SIZE       ( 1U << tlsfFL_INDEX_SHIFT )
+
+/* Only as many first level classes as the heap can use. */
+#if ( configTOTAL_HEAP_SIZE < ( 64 * 1024 ) )
+    #define tlsfFL_INDEX_MAX       ( 16 )
+#elif ( configTOTAL_HEAP_SIZE < ( 128 * 1024 ) )
+    #define tlsfFL_INDEX_MAX       ( 17 )
+#elif ( configTOTAL_HEAP_SIZE < ( 256 * 1024 ) )
+    #define tlsfFL_INDEX_MAX       ( 18 )
+#else
+    #define tlsfFL_INDEX_MAX       ( 19 )
+#endif
+#define tlsfFL_INDEX_COUNT         ( tlsfFL_INDEX_MAX - tlsfFL_INDEX_SHIFT + 1 )
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Every block starts with its size and a pointer to the physically preceding
+ * block.  The free list links are only valid while the block is free and
+ * overlap the start of the user data otherwise. */
+typedef struct A_BLOCK_HEADER
+{
+    size_t xBlockSize;                         /*<< Size including this header, the low bits hold flags. */
+    struct A_BLOCK_HEADER * pxPrevPhysBlock;   /*<< Block immediately before this one in memory. */
+    struct A_BLOCK_HEADER * pxNextFreeBlock;   /*<< Next block in the same size class. */
+    struct A_BLOCK_HEADER * pxPrevFreeBlock;   /*<< Previous block in the same size class. */
+} BlockHeader_t;
+
+#define tlsfBLOCK_FREE_BIT         ( ( size_t ) 1 )
+#define tlsfBLOCK_SIZE_MASK        ( ~( ( size_t ) tlsfALIGN_SIZE - 1 ) )
+
+#define tlsfBLOCK_OVERHEAD         ( offsetof( BlockHeader_t, pxNextFreeBlock ) )
+#define tlsfBLOCK_SIZE_MIN         ( sizeof( BlockHeader_t ) )
+#define tlsfBLOCK_SIZE_MAX         ( ( size_t ) 1 << tlsfFL_INDEX_MAX )
+
+#define tlsfBLOCK_SIZE( pxBlock )          ( ( pxBlock )->xBlockSize & tlsfBLOCK_SIZE_MASK )
+#define tlsfBLOCK_IS_FREE( pxBlock )       ( ( ( pxBlock )->xBlockSize & tlsfBLOCK_FREE_BIT ) != 0 )
+#define tlsfBLOCK_NEXT( pxBlock )          ( ( BlockHeader_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + tlsfBLOCK_SIZE( pxBlock ) ) )
+#define tlsfBLOCK_TO_POINTER( pxBlock )    ( ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + tlsfBLOCK_OVERHEAD ) )
+#define tlsfPOINTER_TO_BLOCK( pv )         ( ( BlockHeader_t * ) ( ( ( uint8_t * ) ( pv ) ) - tlsfBLOCK_OVERHEAD ) )
+
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+static void prvInsertFreeBlock( BlockHeader_t * pxBlock ) PRIVILEGED_FUNCTION;
+static void prvRemoveFreeBlock( BlockHeader_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+PRIVILEGED_DATA static uint32_t ulFirstLevelBitmap = 0;
+PRIVILEGED_DATA static uint32_t ulSecondLevelBitmap[ tlsfFL_INDEX_COUNT ];
+PRIVILEGED_DATA static BlockHeader_t * pxFreeBlocks[ tlsfFL_INDEX_COUNT ][ tlsfSL_INDEX_COUNT ];
+
+/* Zero sized, allocated block marking the end of the heap so the last real
+ * block never tries to coalesce past it. */
+PRIVILEGED_DATA static BlockHeader_t * pxEnd = NULL;
+
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t prvFindLastSet( uint32_t ulValue )
+{
+    return 31U - ( uint32_t ) __builtin_clz( ulValue );
+}
+
+static portFORCE_INLINE uint32_t prvFindFirstSet( uint32_t ulValue )
+{
+    return ( uint32_t ) __builtin_ctz( ulValue );
+}
+
+/* Size class holding blocks of exactly xSize bytes. */
+static portFORCE_INLINE void prvMappingInsert( size_t xSize,
+                                               uint32_t * pulFirst,
+                                               uint32_t * pulSecond )
+{
+    uint32_t ulFirst, ulSecond;
+
+    if( xSize < tlsfSMALL_BLOCK_SIZE )
+    {
+        ulFirst = 0;
+        ulSecond = ( uint32_t ) xSize / ( tlsfSMALL_BLOCK_SIZE / tlsfSL_INDEX_COUNT );
+    }
+    else
+    {
+        ulFirst = prvFindLastSet( ( uint32_t ) xSize );
+        ulSecond = ( ( uint32_t ) xSize >> ( ulFirst - tlsfSL_INDEX_COUNT_LOG2 ) ) ^ tlsfSL_INDEX_COUNT;
+        ulFirst -= ( tlsfFL_INDEX_SHIFT - 1 );
+    }
+
+    *pulFirst = ulFirst;
+    *pulSecond = ulSecond;
+}
+
+/* First size class whose blocks are all at least xSize bytes. */
+static portFORCE_INLINE void prvMappingSearch( size_t xSize,
+                                               uint32_t * pulFirst,
+                                               uint32_t * pulSecond )
+{
+    if( xSize >= tlsfSMALL_BLOCK_SIZE )
+    {
+        xSize += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xSize ) - tlsfSL_INDEX_COUNT_LOG2 ) ) - 1;
+    }
+
+    prvMappingInsert( xSize, pulFirst, pulSecond );
+}
+
+static BlockHeader_t * prvFindSuitableBlock( uint32_t ulFirst,
+                                             uint32_t ulSecond )
+{
+    uint32_t ulSecondMap;
+    uint32_t ulFirstMap;
+
+    if( ulFirst >= tlsfFL_INDEX_COUNT )
+    {
+        return NULL;
+    }
+
+    ulSecondMap = ulSecondLevelBitmap[ ulFirst ] & ( ~0UL << ulSecond );
+
+    if( ulSecondMap == 0 )
+    {
+        /* Nothing left in this first level, take the smallest larger one. */
+        ulFirstMap = ulFirstLevelBitmap & ( ~0UL << ( ulFirst + 1 ) );
+
+        if( ulFirstMap == 0 )
+        {
+            return NULL;
+        }
+
+        ulFirst = prvFindFirstSet( ulFirstMap );
+        ulSecondMap = ulSecondLevelBitmap[ ulFirst ];
+    }
+
+    ulSecond = prvFindFirstSet( ulSecondMap );
+
+    return pxFreeBlocks[ ulFirst ][ ulSecond ];
+}
+
+/* Blocks in the class a request maps to may still be large enough, which
+ * matters once the heap is nearly full and only one large block is left. */
+static BlockHeader_t * prvFindFitInClass( size_t xSize )
+{
+    BlockHeader_t * pxBlock;
+    uint32_t ulFirst, ulSecond;
+
+    prvMappingInsert( xSize, &ulFirst, &ulSecond );
+
+    if( ulFirst >= tlsfFL_INDEX_COUNT )
+    {
+        return NULL;
+    }
+
+    for( pxBlock = pxFreeBlocks[ ulFirst ][ ulSecond ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+    {
+        if( tlsfBLOCK_SIZE( pxBlock ) >= xSize )
+        {
+            break;
+        }
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockHeader_t * pxBlock )
+{
+    uint32_t ulFirst, ulSecond;
+
+    prvMappingInsert( tlsfBLOCK_SIZE( pxBlock ), &ulFirst, &ulSecond );
+
+    pxBlock->xBlockSize |= tlsfBLOCK_FREE_BIT;
+    pxBlock->pxPrevFreeBlock = NULL;
+    pxBlock->pxNextFreeBlock = pxFreeBlocks[ ulFirst ][ ulSecond ];
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock;
+    }
+
+    pxFreeBlocks[ ulFirst ][ ulSecond ] = pxBlock;
+    ulFirstLevelBitmap |= ( 1UL << ulFirst );
+    ulSecondLevelBitmap[ ulFirst ] |= ( 1UL << ulSecond );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockHeader_t * pxBlock )
+{
+    uint32_t ulFirst, ulSecond;
+
+    prvMappingInsert( tlsfBLOCK_SIZE( pxBlock ), &ulFirst, &ulSecond );
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+    }
+
+    if( pxBlock->pxPrevFreeBlock != NULL )
+    {
+        pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        pxFreeBlocks[ ulFirst ][ ulSecond ] = pxBlock->pxNextFreeBlock;
+
+        if( pxBlock->pxNextFreeBlock == NULL )
+        {
+            ulSecondLevelBitmap[ ulFirst ] &= ~( 1UL << ulSecond );
+
+            if( ulSecondLevelBitmap[ ulFirst ] == 0 )
+            {
+                ulFirstLevelBitmap &= ~( 1UL << ulFirst );
+            }
+        }
+    }
+
+    pxBlock->xBlockSize &= ~tlsfBLOCK_FREE_BIT;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockHeader_t * pxBlock = NULL;
+    BlockHeader_t * pxRemainder;
+    uint32_t ulFirst, ulSecond;
+    size_t xBlockSize;
+    void * pvReturn = NULL;
+
+    vTaskSuspendAll();
+    {
+        if( pxEnd == NULL )
+        {
+            prvHeapInit();
+        }
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize < ( tlsfBLOCK_SIZE_MAX - tlsfBLOCK_OVERHEAD ) ) )
+        {
+            xWantedSize = ( xWantedSize + tlsfBLOCK_OVERHEAD + tlsfALIGN_SIZE - 1 ) & tlsfBLOCK_SIZE_MASK;
+
+            if( xWantedSize < tlsfBLOCK_SIZE_MIN )
+            {
+                xWantedSize = tlsfBLOCK_SIZE_MIN;
+            }
+
+            prvMappingSearch( xWantedSize, &ulFirst, &ulSecond );
+            pxBlock = prvFindSuitableBlock( ulFirst, ulSecond );
+
+            if( pxBlock == NULL )
+            {
+                pxBlock = prvFindFitInClass( xWantedSize );
+            }
+        }
+
+        if( pxBlock != NULL )
+        {
+            prvRemoveFreeBlock( pxBlock );
+            xBlockSize = tlsfBLOCK_SIZE( pxBlock );
+
+            /* Return the tail of the block to the heap if it is large enough
+             * to be a block of its own. */
+            if( ( xBlockSize - xWantedSize ) >= tlsfBLOCK_SIZE_MIN )
+            {
+                pxRemainder = ( BlockHeader_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                pxRemainder->xBlockSize = xBlockSize - xWantedSize;
+                pxRemainder->pxPrevPhysBlock = pxBlock;
+                tlsfBLOCK_NEXT( pxRemainder )->pxPrevPhysBlock = pxRemainder;
+                prvInsertFreeBlock( pxRemainder );
+
+                pxBlock->xBlockSize = xWantedSize;
+                xBlockSize = xWantedSize;
+            }
+
+            xFreeBytesRemaining -= xBlockSize;
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+
+            xNumberOfSuccessfulAllocations++;
+            pvReturn = tlsfBLOCK_TO_POINTER( pxBlock );
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+        {
+            if( pvReturn == NULL )
+            {
+                extern void vApplicationMallocFailedHook( void );
+                vApplicationMallocFailedHook();
+            }
+        }
+    #endif
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    BlockHeader_t * pxBlock;
+    BlockHeader_t * pxNeighbour;
+
+    if( pv == NULL )
+    {
+        return;
+    }
+
+    pxBlock = tlsfPOINTER_TO_BLOCK( pv );
+
+    /* Check the block is actually allocated. */
+    configASSERT( !tlsfBLOCK_IS_FREE( pxBlock ) );
+
+    if( tlsfBLOCK_IS_FREE( pxBlock ) )
+    {
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        xFreeBytesRemaining += tlsfBLOCK_SIZE( pxBlock );
+        traceFREE( pv, tlsfBLOCK_SIZE( pxBlock ) );
+
+        /* Coalesce with the physically adjacent blocks if they are free. */
+        pxNeighbour = pxBlock->pxPrevPhysBlock;
+
+        if( ( pxNeighbour != NULL ) && tlsfBLOCK_IS_FREE( pxNeighbour ) )
+        {
+            prvRemoveFreeBlock( pxNeighbour );
+            pxNeighbour->xBlockSize += tlsfBLOCK_SIZE( pxBlock );
+            pxBlock = pxNeighbour;
+        }
+
+        pxNeighbour = tlsfBLOCK_NEXT( pxBlock );
+
+        if( tlsfBLOCK_IS_FREE( pxNeighbour ) )
+        {
+            prvRemoveFreeBlock( pxNeighbour );
+            pxBlock->xBlockSize += tlsfBLOCK_SIZE( pxNeighbour );
+        }
+
+        tlsfBLOCK_NEXT( pxBlock )->pxPrevPhysBlock = pxBlock;
+        prvInsertFreeBlock( pxBlock );
+
+        xNumberOfSuccessfulFrees++;
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockHeader_t * pxFirstBlock = ( BlockHeader_t * ) ucHeap;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE & tlsfBLOCK_SIZE_MASK;
+
+    /* One free block spanning the heap followed by the end marker, which only
+     * needs the size and previous block fields. */
+    pxFirstBlock->xBlockSize = xTotalHeapSize - tlsfBLOCK_OVERHEAD;
+    pxFirstBlock->pxPrevPhysBlock = NULL;
+
+    pxEnd = tlsfBLOCK_NEXT( pxFirstBlock );
+    pxEnd->xBlockSize = 0;
+    pxEnd->pxPrevPhysBlock = pxFirstBlock;
+
+    prvInsertFreeBlock( pxFirstBlock );
+
+    xFreeBytesRemaining = tlsfBLOCK_SIZE( pxFirstBlock );
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockHeader_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    uint32_t ulFirst, ulSecond;
+
+    vTaskSuspendAll();
+    {
+        for( ulFirst = 0; ulFirst < tlsfFL_INDEX_COUNT; ulFirst++ )
+        {
+            for( ulSecond = 0; ulSecond < tlsfSL_INDEX_COUNT; ulSecond++ )
+            {
+                for( pxBlock = pxFreeBlocks[ ulFirst ][ ulSecond ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+                {
+                    xBlocks++;
+
+                    if( tlsfBLOCK_SIZE( pxBlock ) > xMaxSize )
+                    {
+                        xMaxSize = tlsfBLOCK_SIZE( pxBlock );
+                    }
+
+                    if( tlsfBLOCK_SIZE( pxBlock ) < xMinSize )
+                    {
+                        xMinSize = tlsfBLOCK_SIZE( pxBlock );
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
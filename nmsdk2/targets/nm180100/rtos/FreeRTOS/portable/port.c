@@ -35,12 +35,14 @@
 
 /* hardware includes */
 #include "am_mcu_apollo.h"
-
-// A Possible clock glitch could rarely cause the Stimer interrupt to be lost.
-// Set up a backup comparator to handle this case
-#define AM_FREERTOS_STIMER_BACKUP
+#include "stimer_mux.h"
 
 //#define FREERTOS_STIMER_DIAGS
+#if configGENERATE_RUN_TIME_STATS == 1
+volatile uint32_t ulPortContextSwitchCount = 0;
+volatile uint32_t ulPortSleepTime = 0;
+#endif
+
 #ifdef AM_FREERTOS_STIMER_DIAGS
 uint32_t gF_stimerHistory[256][4];
 uint8_t gF_stimerHistoryCount = 0;
@@ -926,6 +928,19 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
     gF_stimerGetHistoryCount++;
 #endif
     elapsed_time = curTime - g_lastSTimerVal;
+
+    // The core wakes at the earliest deadline of any STIMER client, so that
+    // deadline rather than the next task unblock bounds the time spent asleep.
+    uint32_t ulSleepValue = ulReloadValue;
+    uint32_t ulNextDeadline;
+    if (stimer_mux_next(STIMER_MUX_RTOS, &ulNextDeadline))
+    {
+        int32_t lNext = (int32_t)(ulNextDeadline - g_lastSTimerVal);
+        if (lNext < (int32_t)ulSleepValue)
+        {
+            ulSleepValue = (lNext > 0) ? lNext : 0;
+        }
+    }
 #else
     am_hal_ctimer_stop(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
     // Adjust for the time already elapsed
@@ -947,15 +962,13 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 	}
 	else
 	{
+#ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
+        // Move the tick deadline out to the next task unblock
+        stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulReloadValue);
+#else
         // Adjust for the time already elapsed
         ulReloadValue -= elapsed_time;
         // Initialize new timeout value
-#ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
-        am_hal_stimer_compare_delta_set(0, ulReloadValue);
-#ifdef AM_FREERTOS_STIMER_BACKUP
-        am_hal_stimer_compare_delta_set(1, ulReloadValue+1);
-#endif
-#else
         am_hal_ctimer_clear(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
         am_hal_ctimer_compare_set(configCTIMER_NUM, AM_HAL_CTIMER_BOTH, 0, ulReloadValue);
         am_hal_ctimer_start(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
@@ -965,8 +978,14 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 		set its parameter to 0 to indicate that its implementation contains
 		its own wait for interrupt or wait for event instruction, and so wfi
 		should not be executed again.  However, the original expected idle
-		time variable must remain unmodified, so a copy is taken. */
+		time variable must remain unmodified, so a copy is taken.  With the
+		STIMER tick the copy holds the ticks until the next wakeup of any
+		timer. */
+#ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
+		xModifiableIdleTime = ulSleepValue / ulTimerCountsForOneTick;
+#else
 		xModifiableIdleTime = xExpectedIdleTime;
+#endif
 
 		configPRE_SLEEP_PROCESSING( xModifiableIdleTime );       // Turn OFF all Periphials in this function
 
@@ -987,8 +1006,10 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 
 #ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
         New_Timer = am_hal_stimer_counter_get();
+#if configGENERATE_RUN_TIME_STATS == 1
+        ulPortSleepTime += New_Timer - curTime;
+#endif
         Delta_Sleep = (signed long) New_Timer - (signed long) g_lastSTimerVal;
-        g_lastSTimerVal = New_Timer - Delta_Sleep%ulTimerCountsForOneTick;
 #else
         am_hal_ctimer_stop(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
         New_Timer = am_hal_ctimer_read(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
@@ -1008,22 +1029,22 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 
         Delta_Sleep /= ulTimerCountsForOneTick;
 
+#ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
+        // An interrupt taken on wake-up may delay this past the next task
+        // unblock.  Step no further and leave the rest to the tick handler.
+        if (Delta_Sleep > xExpectedIdleTime)
+        {
+            Delta_Sleep = xExpectedIdleTime;
+        }
+        g_lastSTimerVal += Delta_Sleep * ulTimerCountsForOneTick;
+#endif
+
         // Correct System Tick after Sleep
         vTaskStepTick( Delta_Sleep );
 
 		/* Restart System Tick */
 #ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
-
-        // Clear the interrupt - to avoid extra tick counting in ISR
-#ifdef AM_FREERTOS_STIMER_BACKUP
-        am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREA | AM_HAL_STIMER_INT_COMPAREB);
-#else
-        am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREA);
-#endif
-        am_hal_stimer_compare_delta_set(0, ulTimerCountsForOneTick);
-#ifdef AM_FREERTOS_STIMER_BACKUP
-        am_hal_stimer_compare_delta_set(1, ulTimerCountsForOneTick+1);
-#endif
+        stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
 #else
         am_hal_ctimer_clear(configCTIMER_NUM, AM_HAL_CTIMER_BOTH);
         am_hal_ctimer_compare_set(configCTIMER_NUM, AM_HAL_CTIMER_BOTH, 0, ulTimerCountsForOneTick);
@@ -1046,7 +1067,8 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 //
 // Events associated with STimer CMP0 Interrupt
 //
-//  This is the FreeRTOS System Timer
+//  This is the FreeRTOS System Timer.  The tick is the STIMER_MUX_RTOS client
+//  of the STIMER compare multiplexer, which owns compare A and B.
 //
 //  Real Time events must be controlled by FreeRTOS as the Stimer is also used for sleep functions.
 //  At any time the Stimer->Cmp0 interrupt can be a regular Tick interrupt or
@@ -1060,8 +1082,8 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 //
 //
 //*****************************************************************************
-void
-xPortStimerTickHandler(uint32_t delta)
+static void
+xPortStimerTickHandler(void)
 {
     uint32_t remainder = 0;
     uint32_t curSTimer;
@@ -1070,19 +1092,17 @@ xPortStimerTickHandler(uint32_t delta)
     BaseType_t ctxtSwitchReqd = pdFALSE;
 
     curSTimer = am_hal_stimer_counter_get();
-    //
-    // Configure the STIMER->COMPARE_0
-    //
-    am_hal_stimer_compare_delta_set(0, (ulTimerCountsForOneTick-delta));
-#ifdef AM_FREERTOS_STIMER_BACKUP
-    am_hal_stimer_compare_delta_set(1, (ulTimerCountsForOneTick-delta+1));
-#endif
-    
+
     timerCounts = curSTimer - g_lastSTimerVal;
     numTicksElapsed = timerCounts/ulTimerCountsForOneTick;
     remainder = timerCounts % ulTimerCountsForOneTick;
     g_lastSTimerVal = curSTimer - remainder;
 
+    //
+    // Set the deadline of the next tick
+    //
+    stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
+
     //
     // This is a timer a0 interrupt, perform the necessary functions
     // for the tick ISR.
@@ -1112,57 +1132,6 @@ xPortStimerTickHandler(uint32_t delta)
 }
 
 
-//*****************************************************************************
-//
-// Interrupt handler for the STIMER module Compare 0.
-//
-//*****************************************************************************
-void
-am_stimer_cmpr0_isr(void)
-{
-
-    //
-    // Check the timer interrupt status.
-    //
-    uint32_t ui32Status = am_hal_stimer_int_status_get(false);
-    if (ui32Status & AM_HAL_STIMER_INT_COMPAREA)
-    {
-        am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREA);
-
-        //
-        // Run handlers for the various possible timer events.
-        //
-        xPortStimerTickHandler(0);
-    }
-}
-
-#ifdef AM_FREERTOS_STIMER_BACKUP
-uint32_t gNumCmpB = 0;
-//*****************************************************************************
-//
-// Interrupt handler for the STIMER module Compare 0.
-//
-//*****************************************************************************
-void
-am_stimer_cmpr1_isr(void)
-{
-
-    //
-    // Check the timer interrupt status.
-    //
-    uint32_t ui32Status = am_hal_stimer_int_status_get(false);
-    if (ui32Status & AM_HAL_STIMER_INT_COMPAREB)
-    {
-        am_hal_stimer_int_clear(AM_HAL_STIMER_INT_COMPAREB);
-        gNumCmpB++;
-        //
-        // Run handlers for the various possible timer events.
-        //
-        xPortStimerTickHandler(1);
-    }
-}
-#endif
-
 #else // Use CTimer
 //*****************************************************************************
 //
@@ -1208,67 +1177,33 @@ xPortCTimer0TickHandler(void)
 void vPortSetupTimerInterrupt( void )
 {
 #ifdef AM_FREERTOS_USE_STIMER_FOR_TICK
-    uint32_t oldCfg;
     /* Calculate the constants required to configure the tick interrupt. */
     #if configUSE_TICKLESS_IDLE == 2
     {
         ulTimerCountsForOneTick = (configSTIMER_CLOCK_HZ /configTICK_RATE_HZ) ; //( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ );
-#ifdef AM_FREERTOS_STIMER_BACKUP
-        xMaximumPossibleSuppressedTicks = portMAX_32_BIT_NUMBER / ulTimerCountsForOneTick - 1;
-#else
-        xMaximumPossibleSuppressedTicks = portMAX_32_BIT_NUMBER / ulTimerCountsForOneTick;
-#endif
+        xMaximumPossibleSuppressedTicks = STIMER_MUX_MAX_DELTA / ulTimerCountsForOneTick - 1;
     }
     #endif /* configUSE_TICKLESS_IDLE */
+
     //
-    //
-    //
-#ifdef AM_FREERTOS_STIMER_BACKUP
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREA | AM_HAL_STIMER_INT_COMPAREB);
-#else
-    am_hal_stimer_int_enable(AM_HAL_STIMER_INT_COMPAREA);
-#endif
-    
-    //
-    // Enable the timer interrupt in the NVIC, making sure to use the
-    // appropriate priority level.
+    // The compare interrupts are shared with the other STIMER clients, so
+    // they run at the kernel priority.
     //
 #if AM_CMSIS_REGS
     NVIC_SetPriority(STIMER_CMPR0_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_EnableIRQ(STIMER_CMPR0_IRQn);
-#else // AM_CMSIS_REGS
-    am_hal_interrupt_priority_set(AM_HAL_INTERRUPT_STIMER_CMPR0, configKERNEL_INTERRUPT_PRIORITY);
-    am_hal_interrupt_enable(AM_HAL_INTERRUPT_STIMER_CMPR0);
-#endif // AM_CMSIS_REGS
-#ifdef AM_FREERTOS_STIMER_BACKUP
-#if AM_CMSIS_REGS
     NVIC_SetPriority(STIMER_CMPR1_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
-    NVIC_EnableIRQ(STIMER_CMPR1_IRQn);
 #else // AM_CMSIS_REGS
+    am_hal_interrupt_priority_set(AM_HAL_INTERRUPT_STIMER_CMPR0, configKERNEL_INTERRUPT_PRIORITY);
     am_hal_interrupt_priority_set(AM_HAL_INTERRUPT_STIMER_CMPR1, configKERNEL_INTERRUPT_PRIORITY);
-    am_hal_interrupt_enable(AM_HAL_INTERRUPT_STIMER_CMPR1);
 #endif // AM_CMSIS_REGS
-#endif
+
     //
-    // Configure the STIMER
+    // Configure the STIMER and schedule the first tick
     //
-    oldCfg = am_hal_stimer_config(AM_HAL_STIMER_CFG_FREEZE);
+    stimer_mux_init(configSTIMER_CLOCK);
+    stimer_mux_register(STIMER_MUX_RTOS, xPortStimerTickHandler, 0);
     g_lastSTimerVal = am_hal_stimer_counter_get();
-    am_hal_stimer_compare_delta_set(0, ulTimerCountsForOneTick);
-#ifdef AM_FREERTOS_STIMER_BACKUP
-    am_hal_stimer_compare_delta_set(1, ulTimerCountsForOneTick+1);
-#if AM_CMSIS_REGS
-    am_hal_stimer_config((oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE | CTIMER_STCFG_CLKSEL_Msk)) | configSTIMER_CLOCK | AM_HAL_STIMER_CFG_COMPARE_A_ENABLE | AM_HAL_STIMER_CFG_COMPARE_B_ENABLE);
-#else // AM_CMSIS_REGS
-    am_hal_stimer_config((oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE|AM_REG_CTIMER_STCFG_CLKSEL_M)) | configSTIMER_CLOCK | AM_HAL_STIMER_CFG_COMPARE_A_ENABLE | AM_HAL_STIMER_CFG_COMPARE_B_ENABLE);
-#endif // AM_CMSIS_REGS
-#else
-#if AM_CMSIS_REGS
-    am_hal_stimer_config((oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE | CTIMER_STCFG_CLKSEL_Msk)) | configSTIMER_CLOCK | AM_HAL_STIMER_CFG_COMPARE_A_ENABLE);
-#else // AM_CMSIS_REGS
-    am_hal_stimer_config((oldCfg & ~(AM_HAL_STIMER_CFG_FREEZE|AM_REG_CTIMER_STCFG_CLKSEL_M)) | configSTIMER_CLOCK | AM_HAL_STIMER_CFG_COMPARE_A_ENABLE);
-#endif // AM_CMSIS_REGS
-    
+    stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
 #endif
 #else
 
@@ -125,6 +125,14 @@
     #endif
 /*-----------------------------------------------------------*/
 
+/* Run time statistics.  Both counters wrap and are meant to be sampled and
+ * differenced.  The sleep time is in run time counter units. */
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        extern volatile uint32_t ulPortContextSwitchCount;
+        extern volatile uint32_t ulPortSleepTime;
+    #endif
+/*-----------------------------------------------------------*/
+
 /* Architecture specific optimisations. */
     #ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
         #define configUSE_PORT_OPTIMISED_TASK_SELECTION    1
@@ -154,9 +154,9 @@ static int eeprom_page_transfer(eeprom_handle_t *pHandle, uint16_t virtual_addre
             am_hal_flash_page_erase(
                 AM_HAL_FLASH_PROGRAM_KEY,
                 AM_HAL_FLASH_ADDR2INST(
-                    (uint32_t)(pHandle->pages[pHandle->receiving_page].pui32StartAddress)),
+                    (uint32_t)(uintptr_t)(pHandle->pages[pHandle->receiving_page].pui32StartAddress)),
                 AM_HAL_FLASH_ADDR2PAGE(
-                    (uint32_t)(pHandle->pages[pHandle->receiving_page].pui32StartAddress)));
+                    (uint32_t)(uintptr_t)(pHandle->pages[pHandle->receiving_page].pui32StartAddress)));
         }
     }
 
@@ -251,9 +251,9 @@ static int eeprom_page_transfer(eeprom_handle_t *pHandle, uint16_t virtual_addre
     status = am_hal_flash_page_erase(
         AM_HAL_FLASH_PROGRAM_KEY,
         AM_HAL_FLASH_ADDR2INST(
-            (uint32_t)(pHandle->pages[pHandle->active_page].pui32StartAddress)),
+            (uint32_t)(uintptr_t)(pHandle->pages[pHandle->active_page].pui32StartAddress)),
         AM_HAL_FLASH_ADDR2PAGE(
-            (uint32_t)(pHandle->pages[pHandle->active_page].pui32StartAddress)));
+            (uint32_t)(uintptr_t)(pHandle->pages[pHandle->active_page].pui32StartAddress)));
     if (status != 0)
     {
         return status;
@@ -300,8 +300,8 @@ uint32_t eeprom_init(uint32_t ui32StartAddress, uint32_t ui32NumberOfPages, eepr
     {
         uint32_t ui32PageStart = ui32StartAddress + i * AM_HAL_FLASH_PAGE_SIZE;
         uint32_t ui32PageEnd = ui32PageStart + (AM_HAL_FLASH_PAGE_SIZE) - 4;
-        pHandle->pages[i].pui32StartAddress = (uint32_t *)(ui32PageStart);
-        pHandle->pages[i].pui32EndAddress = (uint32_t *)(ui32PageEnd);
+        pHandle->pages[i].pui32StartAddress = (uint32_t *)(uintptr_t)(ui32PageStart);
+        pHandle->pages[i].pui32EndAddress = (uint32_t *)(uintptr_t)(ui32PageEnd);
     }
 
     /* Check status of each page */
@@ -329,9 +329,9 @@ uint32_t eeprom_init(uint32_t ui32StartAddress, uint32_t ui32NumberOfPages, eepr
             // Validate if the page is really erased, and erase it if not.
             if (!eeprom_page_validate_empty(&(pHandle->pages[i]))) {
                 am_hal_flash_page_erase(AM_HAL_FLASH_PROGRAM_KEY,
-                                        AM_HAL_FLASH_ADDR2INST((uint32_t)(
+                                        AM_HAL_FLASH_ADDR2INST((uint32_t)(uintptr_t)(
                                             pHandle->pages[i].pui32StartAddress)),
-                                        AM_HAL_FLASH_ADDR2PAGE((uint32_t)(
+                                        AM_HAL_FLASH_ADDR2PAGE((uint32_t)(uintptr_t)(
                                             pHandle->pages[i].pui32StartAddress)));
             }
             break;
@@ -339,8 +339,8 @@ uint32_t eeprom_init(uint32_t ui32StartAddress, uint32_t ui32NumberOfPages, eepr
             // Undefined page status, erase page.
             am_hal_flash_page_erase(
                 AM_HAL_FLASH_PROGRAM_KEY,
-                AM_HAL_FLASH_ADDR2INST((uint32_t)(pHandle->pages[i].pui32StartAddress)),
-                AM_HAL_FLASH_ADDR2PAGE((uint32_t)(pHandle->pages[i].pui32StartAddress)));
+                AM_HAL_FLASH_ADDR2INST((uint32_t)(uintptr_t)(pHandle->pages[i].pui32StartAddress)),
+                AM_HAL_FLASH_ADDR2PAGE((uint32_t)(uintptr_t)(pHandle->pages[i].pui32StartAddress)));
             break;
         }
     }
@@ -374,8 +374,8 @@ uint32_t eeprom_format(eeprom_handle_t *pHandle)
         {
             status = am_hal_flash_page_erase(
                 AM_HAL_FLASH_PROGRAM_KEY,
-                AM_HAL_FLASH_ADDR2INST((uint32_t)(pHandle->pages[i].pui32StartAddress)),
-                AM_HAL_FLASH_ADDR2PAGE((uint32_t)(pHandle->pages[i].pui32StartAddress)));
+                AM_HAL_FLASH_ADDR2INST((uint32_t)(uintptr_t)(pHandle->pages[i].pui32StartAddress)),
+                AM_HAL_FLASH_ADDR2PAGE((uint32_t)(uintptr_t)(pHandle->pages[i].pui32StartAddress)));
             if (status != 0)
             {
                 return false;
@@ -0,0 +1,326 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+
+#include "stimer_mux.h"
+
+//
+// am_hal_stimer_compare_delta_set() disables the compare while it writes the
+// new value, so a delta of one or two counts can be missed.
+//
+#define STIMER_MUX_MIN_DELTA 3
+
+#define STIMER_MUX_INT (AM_HAL_STIMER_INT_COMPAREA | AM_HAL_STIMER_INT_COMPAREB)
+
+typedef struct
+{
+    stimer_mux_handler_t pfnHandler;
+    uint32_t ui32Tolerance;
+    uint32_t ui32Deadline;
+    bool bActive;
+} stimer_mux_client_t;
+
+static stimer_mux_client_t g_psStimerMuxClients[STIMER_MUX_CLIENTS];
+static stimer_mux_stats_t g_sStimerMuxStats;
+static bool g_bStimerMuxInitialized;
+static bool g_bStimerMuxServicing;
+
+//
+// Client whose deadline the compare is programmed for, or STIMER_MUX_CLIENTS
+// when the compare is idle.
+//
+static stimer_mux_client_e g_eStimerMuxOwner = STIMER_MUX_CLIENTS;
+
+//
+// Counter value the compare is programmed for, valid while it has an owner.
+//
+static uint32_t g_ui32StimerMuxWakeup;
+
+//
+// Program the compare for the latest time that meets every pending deadline
+// within its tolerance.  Called with interrupts disabled.
+//
+static void stimer_mux_program(void)
+{
+    int64_t i64Wakeup = STIMER_MUX_MAX_DELTA;
+    stimer_mux_client_e eOwner = STIMER_MUX_CLIENTS;
+    uint32_t ui32Now;
+
+    //
+    // The interrupt handler programs the compare once all the expired
+    // deadlines have been served.
+    //
+    if (g_bStimerMuxServicing)
+    {
+        return;
+    }
+
+    ui32Now = am_hal_stimer_counter_get();
+
+    for (uint32_t i = 0; i < STIMER_MUX_CLIENTS; i++)
+    {
+        stimer_mux_client_t *psClient = &g_psStimerMuxClients[i];
+
+        if (!psClient->bActive)
+        {
+            continue;
+        }
+
+        int64_t i64Latest = (int32_t)(psClient->ui32Deadline - ui32Now);
+        i64Latest += psClient->ui32Tolerance;
+
+        if ((eOwner == STIMER_MUX_CLIENTS) || (i64Latest < i64Wakeup))
+        {
+            i64Wakeup = i64Latest;
+            eOwner = (stimer_mux_client_e)i;
+        }
+    }
+
+    g_eStimerMuxOwner = eOwner;
+
+    if (eOwner == STIMER_MUX_CLIENTS)
+    {
+        am_hal_stimer_int_disable(STIMER_MUX_INT);
+        am_hal_stimer_int_clear(STIMER_MUX_INT);
+        return;
+    }
+
+    if (i64Wakeup < STIMER_MUX_MIN_DELTA)
+    {
+        i64Wakeup = STIMER_MUX_MIN_DELTA;
+    }
+    else if (i64Wakeup > STIMER_MUX_MAX_DELTA)
+    {
+        i64Wakeup = STIMER_MUX_MAX_DELTA;
+    }
+
+    g_ui32StimerMuxWakeup = ui32Now + (uint32_t)i64Wakeup;
+    am_hal_stimer_compare_delta_set(0, (uint32_t)i64Wakeup);
+    am_hal_stimer_compare_delta_set(1, (uint32_t)i64Wakeup + 1);
+    am_hal_stimer_int_clear(STIMER_MUX_INT);
+    am_hal_stimer_int_enable(STIMER_MUX_INT);
+}
+
+//
+// Serve every expired deadline, including those a handler sets in the past,
+// then program the compare for the next one.
+//
+static void stimer_mux_service(void)
+{
+    bool bExpired;
+
+    AM_CRITICAL_BEGIN
+    g_bStimerMuxServicing = true;
+    g_sStimerMuxStats.ui32Wakeups++;
+    if (g_eStimerMuxOwner != STIMER_MUX_CLIENTS)
+    {
+        g_sStimerMuxStats.pui32Wakeups[g_eStimerMuxOwner]++;
+    }
+    AM_CRITICAL_END
+
+    do
+    {
+        bExpired = false;
+
+        for (uint32_t i = 0; i < STIMER_MUX_CLIENTS; i++)
+        {
+            stimer_mux_client_t *psClient = &g_psStimerMuxClients[i];
+            stimer_mux_handler_t pfnHandler = NULL;
+
+            AM_CRITICAL_BEGIN
+            if (psClient->bActive &&
+                ((int32_t)(psClient->ui32Deadline - am_hal_stimer_counter_get()) <= 0))
+            {
+                psClient->bActive = false;
+                pfnHandler = psClient->pfnHandler;
+
+                g_sStimerMuxStats.pui32Expiries[i]++;
+                if (i != g_eStimerMuxOwner)
+                {
+                    g_sStimerMuxStats.pui32Coalesced[i]++;
+                }
+            }
+            AM_CRITICAL_END
+
+            if (pfnHandler)
+            {
+                bExpired = true;
+                pfnHandler();
+            }
+        }
+    } while (bExpired);
+
+    AM_CRITICAL_BEGIN
+    g_bStimerMuxServicing = false;
+    stimer_mux_program();
+    AM_CRITICAL_END
+}
+
+void am_stimer_cmpr0_isr(void)
+{
+    if (am_hal_stimer_int_status_get(false) & AM_HAL_STIMER_INT_COMPAREA)
+    {
+        am_hal_stimer_int_clear(STIMER_MUX_INT);
+        stimer_mux_service();
+    }
+}
+
+//
+// A possible clock glitch can rarely cause the compare A interrupt to be
+// lost.  Compare B is set one count later as its backup.
+//
+void am_stimer_cmpr1_isr(void)
+{
+    if (am_hal_stimer_int_status_get(false) & AM_HAL_STIMER_INT_COMPAREB)
+    {
+        am_hal_stimer_int_clear(STIMER_MUX_INT);
+        g_sStimerMuxStats.ui32Backup++;
+        stimer_mux_service();
+    }
+}
+
+void stimer_mux_init(uint32_t ui32ClockSource)
+{
+    AM_CRITICAL_BEGIN
+    if (!g_bStimerMuxInitialized)
+    {
+        uint32_t ui32OldCfg = am_hal_stimer_config(AM_HAL_STIMER_CFG_FREEZE);
+
+        am_hal_stimer_config((ui32OldCfg & ~(AM_HAL_STIMER_CFG_FREEZE | CTIMER_STCFG_CLKSEL_Msk)) |
+                             ui32ClockSource | AM_HAL_STIMER_CFG_COMPARE_A_ENABLE |
+                             AM_HAL_STIMER_CFG_COMPARE_B_ENABLE);
+
+        NVIC_EnableIRQ(STIMER_CMPR0_IRQn);
+        NVIC_EnableIRQ(STIMER_CMPR1_IRQn);
+
+        g_bStimerMuxInitialized = true;
+    }
+    AM_CRITICAL_END
+}
+
+void stimer_mux_register(stimer_mux_client_e eClient,
+                         stimer_mux_handler_t pfnHandler,
+                         uint32_t ui32Tolerance)
+{
+    if (eClient >= STIMER_MUX_CLIENTS)
+    {
+        return;
+    }
+
+    AM_CRITICAL_BEGIN
+    g_psStimerMuxClients[eClient].pfnHandler = pfnHandler;
+    g_psStimerMuxClients[eClient].ui32Tolerance = ui32Tolerance;
+    AM_CRITICAL_END
+}
+
+void stimer_mux_start(stimer_mux_client_e eClient, uint32_t ui32Deadline)
+{
+    if (eClient >= STIMER_MUX_CLIENTS)
+    {
+        return;
+    }
+
+    AM_CRITICAL_BEGIN
+    g_psStimerMuxClients[eClient].ui32Deadline = ui32Deadline;
+    g_psStimerMuxClients[eClient].bActive = true;
+    stimer_mux_program();
+    AM_CRITICAL_END
+}
+
+void stimer_mux_stop(stimer_mux_client_e eClient)
+{
+    if (eClient >= STIMER_MUX_CLIENTS)
+    {
+        return;
+    }
+
+    AM_CRITICAL_BEGIN
+    if (g_psStimerMuxClients[eClient].bActive)
+    {
+        g_psStimerMuxClients[eClient].bActive = false;
+        stimer_mux_program();
+    }
+    AM_CRITICAL_END
+}
+
+bool stimer_mux_next(stimer_mux_client_e eExclude, uint32_t *pui32Deadline)
+{
+    bool bFound = false;
+    int32_t i32Next = 0;
+
+    AM_CRITICAL_BEGIN
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+
+    for (uint32_t i = 0; i < STIMER_MUX_CLIENTS; i++)
+    {
+        stimer_mux_client_t *psClient = &g_psStimerMuxClients[i];
+
+        if ((i == eExclude) || !psClient->bActive)
+        {
+            continue;
+        }
+
+        int32_t i32Delta = (int32_t)(psClient->ui32Deadline - ui32Now);
+        if (!bFound || (i32Delta < i32Next))
+        {
+            i32Next = i32Delta;
+            *pui32Deadline = psClient->ui32Deadline;
+            bFound = true;
+        }
+    }
+    AM_CRITICAL_END
+
+    return bFound;
+}
+
+bool stimer_mux_wakeup(uint32_t *pui32Wakeup)
+{
+    bool bPending;
+
+    AM_CRITICAL_BEGIN
+    bPending = (g_eStimerMuxOwner != STIMER_MUX_CLIENTS);
+    *pui32Wakeup = g_ui32StimerMuxWakeup;
+    AM_CRITICAL_END
+
+    return bPending;
+}
+
+void stimer_mux_stats_get(stimer_mux_stats_t *psStats)
+{
+    AM_CRITICAL_BEGIN
+    memcpy(psStats, &g_sStimerMuxStats, sizeof(*psStats));
+    AM_CRITICAL_END
+}
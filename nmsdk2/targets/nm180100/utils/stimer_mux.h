@@ -0,0 +1,116 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _STIMER_MUX_H_
+#define _STIMER_MUX_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// The STIMER compare multiplexer owns compare A, with compare B as its
+// backup, and serves the deadlines of every timer client from them.  A
+// client registers a handler and a tolerance, then sets absolute STIMER
+// deadlines.  The compare is programmed for the latest time that still
+// meets every pending deadline plus its tolerance, so deadlines that fall
+// close together share one wakeup.  Handlers run from the compare interrupt.
+//
+typedef enum
+{
+    STIMER_MUX_RTOS,
+    STIMER_MUX_LORAWAN,
+    STIMER_MUX_WSF,
+    STIMER_MUX_CLIENTS
+} stimer_mux_client_e;
+
+typedef void (*stimer_mux_handler_t)(void);
+
+typedef struct
+{
+    // Compare interrupts taken, and those taken on the backup compare.
+    uint32_t ui32Wakeups;
+    uint32_t ui32Backup;
+
+    // Wakeups programmed for the deadline of each client.
+    uint32_t pui32Wakeups[STIMER_MUX_CLIENTS];
+
+    // Deadlines of each client served, and those served by a wakeup that
+    // was programmed for another client.
+    uint32_t pui32Expiries[STIMER_MUX_CLIENTS];
+    uint32_t pui32Coalesced[STIMER_MUX_CLIENTS];
+} stimer_mux_stats_t;
+
+//
+// Deadlines are compared with the counter as signed differences, so they
+// must be set less than this many counts ahead.
+//
+#define STIMER_MUX_MAX_DELTA 0x7FFFFFFF
+
+//
+// Configure the STIMER with the given clock and enable the compare
+// interrupts.  Every client calls it; only the first call configures.
+//
+extern void stimer_mux_init(uint32_t ui32ClockSource);
+
+extern void stimer_mux_register(stimer_mux_client_e eClient,
+                                stimer_mux_handler_t pfnHandler,
+                                uint32_t ui32Tolerance);
+
+//
+// Set or clear the deadline of a client.  Setting a deadline replaces the
+// previous one.  A deadline already passed is served at once.
+//
+extern void stimer_mux_start(stimer_mux_client_e eClient, uint32_t ui32Deadline);
+extern void stimer_mux_stop(stimer_mux_client_e eClient);
+
+//
+// Earliest pending deadline over all clients but the one given, or over
+// all clients with STIMER_MUX_CLIENTS.  Returns false if there is none.
+//
+extern bool stimer_mux_next(stimer_mux_client_e eExclude, uint32_t *pui32Deadline);
+
+//
+// Counter value the compare is programmed to wake the core at.  Returns
+// false if no deadline is pending.
+//
+extern bool stimer_mux_wakeup(uint32_t *pui32Wakeup);
+
+extern void stimer_mux_stats_get(stimer_mux_stats_t *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
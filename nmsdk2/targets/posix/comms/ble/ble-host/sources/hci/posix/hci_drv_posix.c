@@ -0,0 +1,173 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "am_mcu_apollo.h"
+
+#include "wsf_types.h"
+#include "wsf_os.h"
+#include "hci_drv.h"
+#include "hci_drv_apollo.h"
+#include "hci_drv_apollo3.h"
+#include "hci_drv_linux.h"
+#include "sim_local.h"
+
+//*****************************************************************************
+//
+// HCI driver of the host application.
+//
+// The controller is the simulated controller of the host benchmark, linked
+// in as hci_drv_linux.c and running alone on the air of sim_local.c.  It
+// answers commands synchronously from hciDrvWrite().  Its alarms pend the
+// BLE interrupt, whose handler wakes the driver handler in the BLE task, so
+// that the controller only ever runs in the BLE task as on the part.
+//
+//*****************************************************************************
+
+//
+// Handler ID of HciDrvHandler.
+//
+static wsfHandlerId_t g_HciDrvHandleID = 0;
+
+//*****************************************************************************
+//
+// Boot the radio.
+//
+//*****************************************************************************
+uint32_t
+HciDrvRadioBoot(bool bColdBoot)
+{
+    HciDrvSimInit();
+
+    NVIC_EnableIRQ(BLE_IRQn);
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// Shut down the radio.
+//
+//*****************************************************************************
+void
+HciDrvRadioShutdown(void)
+{
+    NVIC_DisableIRQ(BLE_IRQn);
+}
+
+//*****************************************************************************
+//
+// Save the handler ID of the HciDrvHandler.
+//
+//*****************************************************************************
+void
+HciDrvHandlerInit(wsfHandlerId_t handlerId)
+{
+    g_HciDrvHandleID = handlerId;
+}
+
+//*****************************************************************************
+//
+// BLE interrupt: a controller alarm expired.
+//
+//*****************************************************************************
+void
+HciDrvIntService(void)
+{
+    WsfSetEvent(g_HciDrvHandleID, 1);
+}
+
+//*****************************************************************************
+//
+// Run the expired controller alarms.
+//
+//*****************************************************************************
+void
+HciDrvHandler(wsfEventMask_t event, wsfMsgHdr_t *pMsg)
+{
+    SimLocalServiceAlarms();
+}
+
+//*****************************************************************************
+//
+// Register an error handler for the HCI driver.  The simulated controller
+// does not fail.
+//
+//*****************************************************************************
+void
+HciDrvErrorHandlerSet(hci_drv_error_handler_t pfnErrorHandler)
+{
+}
+
+//*****************************************************************************
+//
+// Vendor specific commands.  The simulated controller has no radio to tune
+// and derives its address from the node ID.
+//
+//*****************************************************************************
+bool_t
+HciVscSetRfPowerLevelEx(txPowerLevel_t txPowerlevel)
+{
+    return (txPowerlevel < TX_POWER_LEVEL_INVALID);
+}
+
+void
+HciVscConstantTransmission(uint8_t txchannel)
+{
+}
+
+void
+HciVscCarrierWaveMode(uint8_t txchannel)
+{
+}
+
+bool_t
+HciVscSetCustom_BDAddr(uint8_t *bd_addr)
+{
+    return false;
+}
+
+void
+HciVscUpdateBDAddress(void)
+{
+}
+
+void
+HciDrvBleSleepSet(bool enable)
+{
+}
+
+void
+HciDrvEmptyWriteQueue(void)
+{
+}
@@ -0,0 +1,324 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Single node simulation link for the host application.
+ *
+ *  The simulated controller of the host benchmark runs as the only node of the air.  Simulated
+ *  time is the virtual time of the CPU emulation.  Alarms are kept sorted by time and the
+ *  earliest one is armed as an emulation event that pends the BLE interrupt; the driver handler
+ *  then runs the expired callbacks in the BLE task.  PDUs sent to the air are dropped.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "sim_api.h"
+#include "sim_local.h"
+
+/**************************************************************************************************
+  Data Types
+**************************************************************************************************/
+
+/*! \brief  Node control block. */
+static struct
+{
+  simAlarm_t            *pAlarms;         /*!< Pending alarms sorted by time. */
+  simAirCback_t         airCback;         /*!< Air PDU receive callback. */
+  am_hal_posix_event_t  event;            /*!< Expiration of the earliest alarm. */
+  bool_t                initialized;      /*!< TRUE once the event is initialized. */
+} simLocalCb;
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Pend the BLE interrupt when the earliest alarm expires.
+ *
+ *  \param  pArg      Unused.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simLocalEventCback(void *pArg)
+{
+  NVIC_SetPendingIRQ(BLE_IRQn);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Arm the event for the earliest alarm.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+static void simLocalArm(void)
+{
+  if (!simLocalCb.initialized)
+  {
+    am_hal_posix_event_init(&simLocalCb.event, simLocalEventCback, NULL);
+    simLocalCb.initialized = TRUE;
+  }
+
+  if (simLocalCb.pAlarms == NULL)
+  {
+    am_hal_posix_event_stop(&simLocalCb.event);
+  }
+  else
+  {
+    am_hal_posix_event_start(&simLocalCb.event, simLocalCb.pAlarms->time * 1000);
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time consumed by this process.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimCpuNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Attach this process to the coordinator as a node.  There is no coordinator.
+ *
+ *  \param  fd        Unused.
+ *  \param  nodeId    Unused.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeInit(int fd, uint8_t nodeId)
+{
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the ID of this node.
+ *
+ *  \return Node ID.
+ */
+/*************************************************************************************************/
+uint8_t SimNodeGetId(void)
+{
+  return 0;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the simulated time.
+ *
+ *  \return Current time in microseconds.
+ */
+/*************************************************************************************************/
+simTime_t SimNodeGetTime(void)
+{
+  return am_hal_posix_time_ns() / 1000;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Register the air PDU receive callback.
+ *
+ *  \param  cback     Callback.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirRegister(simAirCback_t cback)
+{
+  simLocalCb.airCback = cback;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Send an air PDU.  Nobody listens.
+ *
+ *  \param  dst       Destination node or SIM_NODE_BROADCAST.
+ *  \param  time      Delivery time, no earlier than the current time.
+ *  \param  pPdu      PDU.
+ *  \param  len       PDU length.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAirSend(uint8_t dst, simTime_t time, const uint8_t *pPdu, uint16_t len)
+{
+  WSF_ASSERT(len <= SIM_AIR_MAX_LEN);
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Initialize an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  cback     Expiration callback.
+ *  \param  pContext  Callback context.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmInit(simAlarm_t *pAlarm, simAlarmCback_t cback, void *pContext)
+{
+  memset(pAlarm, 0, sizeof(simAlarm_t));
+  pAlarm->cback = cback;
+  pAlarm->pContext = pContext;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Start or restart an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *  \param  time      Absolute expiration time.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStart(simAlarm_t *pAlarm, simTime_t time)
+{
+  simAlarm_t **ppElem;
+
+  SimNodeAlarmStop(pAlarm);
+
+  pAlarm->time = time;
+  pAlarm->isStarted = TRUE;
+
+  /* Alarms with equal times expire in the order they were started. */
+  for (ppElem = &simLocalCb.pAlarms; *ppElem != NULL; ppElem = &(*ppElem)->pNext)
+  {
+    if (time < (*ppElem)->time)
+    {
+      break;
+    }
+  }
+
+  pAlarm->pNext = *ppElem;
+  *ppElem = pAlarm;
+
+  if (simLocalCb.pAlarms == pAlarm)
+  {
+    simLocalArm();
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Stop an alarm.
+ *
+ *  \param  pAlarm    Alarm.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeAlarmStop(simAlarm_t *pAlarm)
+{
+  simAlarm_t **ppElem;
+  bool_t isFirst = (simLocalCb.pAlarms == pAlarm);
+
+  if (!pAlarm->isStarted)
+  {
+    return;
+  }
+
+  for (ppElem = &simLocalCb.pAlarms; *ppElem != NULL; ppElem = &(*ppElem)->pNext)
+  {
+    if (*ppElem == pAlarm)
+    {
+      *ppElem = pAlarm->pNext;
+      break;
+    }
+  }
+
+  pAlarm->isStarted = FALSE;
+
+  if (isFirst)
+  {
+    simLocalArm();
+  }
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run the callbacks of all alarms expired at the current time.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimLocalServiceAlarms(void)
+{
+  simTime_t now = SimNodeGetTime();
+  simAlarm_t *pAlarm;
+
+  while (((pAlarm = simLocalCb.pAlarms) != NULL) && (pAlarm->time <= now))
+  {
+    simLocalCb.pAlarms = pAlarm->pNext;
+    pAlarm->isStarted = FALSE;
+    pAlarm->cback(pAlarm->pContext);
+  }
+
+  simLocalArm();
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Idle until an alarm expires.  Not used; the RTOS idles the node.
+ *
+ *  \return TRUE.
+ */
+/*************************************************************************************************/
+bool_t SimNodeWait(void)
+{
+  SimLocalServiceAlarms();
+
+  return TRUE;
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Ask the coordinator to stop all nodes.  There is no coordinator.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimNodeFinish(void)
+{
+}
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Return the CPU time this process spent in the simulation link.
+ *
+ *  \return CPU time in nanoseconds.
+ */
+/*************************************************************************************************/
+uint64_t SimNodeGetLinkCpuNs(void)
+{
+  return 0;
+}
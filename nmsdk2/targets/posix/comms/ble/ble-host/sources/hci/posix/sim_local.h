@@ -0,0 +1,49 @@
+/*************************************************************************************************/
+/*!
+ *  \file
+ *
+ *  \brief  Single node simulation link for the host application.
+ *
+ *  Copyright (c) 2022 Northern Mechatronics, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+/*************************************************************************************************/
+#ifndef SIM_LOCAL_H
+#define SIM_LOCAL_H
+
+#include "wsf_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************************************
+  Function Declarations
+**************************************************************************************************/
+
+/*************************************************************************************************/
+/*!
+ *  \brief  Run the callbacks of all alarms expired at the current time.  The BLE interrupt is
+ *          pended whenever the earliest alarm expires.
+ *
+ *  \return None.
+ */
+/*************************************************************************************************/
+void SimLocalServiceAlarms(void);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* SIM_LOCAL_H */
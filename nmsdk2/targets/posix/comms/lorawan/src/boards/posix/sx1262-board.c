@@ -0,0 +1,649 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <radio.h>
+#include <sx126x-board.h>
+#include <utilities.h>
+
+#include "am_hal_posix.h"
+#include "lorawan_power.h"
+
+//*****************************************************************************
+//
+// SX1262 board support for the host build.
+//
+// The radio is a command level model of the chip behind the same board API
+// as the nm180100 board.  Commands complete at once, so BUSY never rises.
+// Transmissions end with TX_DONE after their time on air, receptions hear
+// nothing and end with RX_TX_TIMEOUT, and channel activity detection never
+// detects activity.  DIO1 follows the masked IRQ status on the GPIO model so
+// that the radio interrupt path is the one of the part.
+//
+//*****************************************************************************
+#define SX1262_IOM_MODULE 3
+#define RADIO_NRESET      44
+#define RADIO_BUSY        39
+#define RADIO_DIO1        40
+
+#define SX1262_BUFFER_SIZE     256
+#define SX1262_REGISTER_SIZE   0x1000
+#define SX1262_PARAMS_SIZE     9
+
+// Step of the TX and RX timeouts in nanoseconds.
+#define SX1262_TIMEOUT_STEP_NS 15625
+
+// Packet RSSI and instantaneous RSSI reported, in -0.5 dBm units.
+#define SX1262_RSSI_PKT        200
+#define SX1262_RSSI_INST       240
+
+static const am_hal_gpio_pincfg_t s_RADIO_DIO1 = {
+    .uFuncSel       = AM_HAL_PIN_40_GPIO,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_2MA,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eIntDir        = AM_HAL_GPIO_PIN_INTDIR_LO2HI};
+
+typedef struct
+{
+    RadioOperatingModes_t eMode;
+    RadioPacketTypes_t ePacketType;
+    uint8_t pui8ModulationParams[SX1262_PARAMS_SIZE];
+    uint8_t pui8PacketParams[SX1262_PARAMS_SIZE];
+    uint8_t pui8CadParams[7];
+    uint8_t ui8SymbolTimeout;
+    uint8_t ui8TxBase;
+    uint8_t ui8RxBase;
+    uint16_t ui16IrqMask;
+    uint16_t ui16Dio1Mask;
+    uint16_t ui16IrqStatus;
+    uint8_t pui8Buffer[SX1262_BUFFER_SIZE];
+    uint8_t pui8Registers[SX1262_REGISTER_SIZE];
+    am_hal_posix_event_t sEvent;
+    uint16_t ui16EventIrq;
+} sx1262_model_t;
+
+static sx1262_model_t g_sSX1262;
+
+static am_hal_iom_config_t SX126xSpi;
+void *SX126xHandle;
+
+static RadioOperatingModes_t OperatingMode;
+static int8_t OperatingTxPower;
+
+static void (*SX126xL3RadioIrqHandle)(void *) = NULL;
+
+//*****************************************************************************
+//
+// Chip model.  Called with the HAL lock held.
+//
+//*****************************************************************************
+static void sx1262_dio1_update(void)
+{
+    am_hal_gpio_posix_input_set(RADIO_DIO1,
+                                (g_sSX1262.ui16IrqStatus & g_sSX1262.ui16Dio1Mask) != 0);
+}
+
+static void sx1262_irq_set(uint16_t ui16Irq)
+{
+    g_sSX1262.ui16IrqStatus |= ui16Irq & g_sSX1262.ui16IrqMask;
+    sx1262_dio1_update();
+}
+
+static void sx1262_event_handler(void *pArg)
+{
+    g_sSX1262.eMode = MODE_STDBY_RC;
+    sx1262_irq_set(g_sSX1262.ui16EventIrq);
+}
+
+static void sx1262_event_start(uint64_t ui64DelayNs, uint16_t ui16Irq)
+{
+    g_sSX1262.ui16EventIrq = ui16Irq;
+    am_hal_posix_event_start(&g_sSX1262.sEvent, am_hal_posix_time_ns() + ui64DelayNs);
+}
+
+static void sx1262_reset(void)
+{
+    am_hal_posix_event_stop(&g_sSX1262.sEvent);
+
+    memset(&g_sSX1262, 0, sizeof(g_sSX1262));
+    am_hal_posix_event_init(&g_sSX1262.sEvent, sx1262_event_handler, NULL);
+
+    g_sSX1262.eMode = MODE_STDBY_RC;
+    g_sSX1262.ePacketType = PACKET_TYPE_GFSK;
+    g_sSX1262.pui8Registers[REG_LR_SYNCWORD] = 0x14;
+    g_sSX1262.pui8Registers[REG_LR_SYNCWORD + 1] = 0x24;
+
+    sx1262_dio1_update();
+}
+
+//
+// Duration of one LoRa symbol in nanoseconds.
+//
+static uint64_t sx1262_lora_symbol_ns(void)
+{
+    static const uint32_t pui32BandwidthHz[] = {
+        7810, 15630, 31250, 62500, 125000, 250000, 500000, 0, 10420, 20830, 41670};
+    uint8_t ui8SpreadingFactor = g_sSX1262.pui8ModulationParams[0];
+    uint8_t ui8Bandwidth = g_sSX1262.pui8ModulationParams[1];
+    uint32_t ui32BandwidthHz = 125000;
+
+    if ((ui8Bandwidth < sizeof(pui32BandwidthHz) / sizeof(pui32BandwidthHz[0])) &&
+        pui32BandwidthHz[ui8Bandwidth])
+    {
+        ui32BandwidthHz = pui32BandwidthHz[ui8Bandwidth];
+    }
+
+    return (((uint64_t)1 << ui8SpreadingFactor) * 1000000000ULL) / ui32BandwidthHz;
+}
+
+//
+// Time on air of the configured packet in nanoseconds.
+//
+static uint64_t sx1262_time_on_air_ns(void)
+{
+    uint8_t *pui8Mod = g_sSX1262.pui8ModulationParams;
+    uint8_t *pui8Pkt = g_sSX1262.pui8PacketParams;
+
+    if (g_sSX1262.ePacketType == PACKET_TYPE_LORA)
+    {
+        int32_t i32SpreadingFactor = pui8Mod[0];
+        int32_t i32CodingRate = pui8Mod[2];
+        int32_t i32LowDatarate = pui8Mod[3] ? 1 : 0;
+        int32_t i32Preamble = (pui8Pkt[0] << 8) | pui8Pkt[1];
+        int32_t i32Implicit = pui8Pkt[2] ? 1 : 0;
+        int32_t i32Length = pui8Pkt[3];
+        int32_t i32Crc = pui8Pkt[4] ? 1 : 0;
+
+        int32_t i32Num = 8 * i32Length - 4 * i32SpreadingFactor + 28 + 16 * i32Crc - 20 * i32Implicit;
+        int32_t i32Den = 4 * (i32SpreadingFactor - 2 * i32LowDatarate);
+        int32_t i32Symbols = 8;
+
+        if ((i32Num > 0) && (i32Den > 0))
+        {
+            i32Symbols += ((i32Num + i32Den - 1) / i32Den) * (i32CodingRate + 4);
+        }
+
+        // The preamble is followed by 4.25 symbols of sync word.
+        return ((uint64_t)(4 * (i32Preamble + i32Symbols) + 17) * sx1262_lora_symbol_ns()) / 4;
+    }
+    else
+    {
+        uint32_t ui32BitrateReg = (pui8Mod[0] << 16) | (pui8Mod[1] << 8) | pui8Mod[2];
+        uint64_t ui64Bits = ((pui8Pkt[0] << 8) | pui8Pkt[1]) + pui8Pkt[3] +
+                            (pui8Pkt[5] ? 8 : 0) + 8 * pui8Pkt[6] +
+                            ((pui8Pkt[7] == RADIO_CRC_OFF) ? 0 : 16);
+
+        if (ui32BitrateReg == 0)
+        {
+            return 0;
+        }
+
+        // The bit rate register is 32 * Fxtal / bit rate with a 32 MHz crystal.
+        return (ui64Bits * ui32BitrateReg * 1000ULL) / 1024ULL;
+    }
+}
+
+static uint32_t sx1262_timeout_get(uint8_t *pui8Buffer)
+{
+    return (pui8Buffer[0] << 16) | (pui8Buffer[1] << 8) | pui8Buffer[2];
+}
+
+static void sx1262_rx_start(uint32_t ui32Timeout)
+{
+    uint64_t ui64TimeoutNs = 0;
+
+    g_sSX1262.eMode = MODE_RX;
+
+    if (ui32Timeout == 0xFFFFFF)
+    {
+        // Continuous reception of nothing.
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+        return;
+    }
+
+    if (ui32Timeout)
+    {
+        ui64TimeoutNs = (uint64_t)ui32Timeout * SX1262_TIMEOUT_STEP_NS;
+    }
+
+    if ((g_sSX1262.ePacketType == PACKET_TYPE_LORA) && g_sSX1262.ui8SymbolTimeout)
+    {
+        uint64_t ui64SymbolsNs = g_sSX1262.ui8SymbolTimeout * sx1262_lora_symbol_ns();
+
+        if ((ui64TimeoutNs == 0) || (ui64SymbolsNs < ui64TimeoutNs))
+        {
+            ui64TimeoutNs = ui64SymbolsNs;
+        }
+    }
+
+    if (ui64TimeoutNs)
+    {
+        sx1262_event_start(ui64TimeoutNs, IRQ_RX_TX_TIMEOUT);
+    }
+    else
+    {
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+    }
+}
+
+static void sx1262_command(RadioCommands_t command, uint8_t *pui8Buffer, uint16_t ui16Size)
+{
+    switch (command)
+    {
+    case RADIO_SET_SLEEP:
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+        g_sSX1262.eMode = MODE_SLEEP;
+        break;
+
+    case RADIO_SET_STANDBY:
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+        g_sSX1262.eMode = (pui8Buffer[0] == STDBY_XOSC) ? MODE_STDBY_XOSC : MODE_STDBY_RC;
+        break;
+
+    case RADIO_SET_FS:
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+        g_sSX1262.eMode = MODE_FS;
+        break;
+
+    case RADIO_SET_TX:
+        g_sSX1262.eMode = MODE_TX;
+        sx1262_event_start(sx1262_time_on_air_ns(), IRQ_TX_DONE);
+        break;
+
+    case RADIO_SET_TXCONTINUOUSWAVE:
+    case RADIO_SET_TXCONTINUOUSPREAMBLE:
+        am_hal_posix_event_stop(&g_sSX1262.sEvent);
+        g_sSX1262.eMode = MODE_TX;
+        break;
+
+    case RADIO_SET_RX:
+        sx1262_rx_start(sx1262_timeout_get(pui8Buffer));
+        break;
+
+    case RADIO_SET_RXDUTYCYCLE:
+        sx1262_rx_start(0xFFFFFF);
+        break;
+
+    case RADIO_SET_CAD:
+        g_sSX1262.eMode = MODE_CAD;
+        sx1262_event_start((1ULL << (g_sSX1262.pui8CadParams[0] & 0x7)) * sx1262_lora_symbol_ns(),
+                           IRQ_CAD_DONE);
+        break;
+
+    case RADIO_SET_PACKETTYPE:
+        g_sSX1262.ePacketType = (RadioPacketTypes_t)pui8Buffer[0];
+        break;
+
+    case RADIO_SET_MODULATIONPARAMS:
+        memcpy(g_sSX1262.pui8ModulationParams, pui8Buffer,
+               (ui16Size < SX1262_PARAMS_SIZE) ? ui16Size : SX1262_PARAMS_SIZE);
+        break;
+
+    case RADIO_SET_PACKETPARAMS:
+        memcpy(g_sSX1262.pui8PacketParams, pui8Buffer,
+               (ui16Size < SX1262_PARAMS_SIZE) ? ui16Size : SX1262_PARAMS_SIZE);
+        break;
+
+    case RADIO_SET_CADPARAMS:
+        memcpy(g_sSX1262.pui8CadParams, pui8Buffer,
+               (ui16Size < sizeof(g_sSX1262.pui8CadParams)) ? ui16Size : sizeof(g_sSX1262.pui8CadParams));
+        break;
+
+    case RADIO_SET_BUFFERBASEADDRESS:
+        g_sSX1262.ui8TxBase = pui8Buffer[0];
+        g_sSX1262.ui8RxBase = pui8Buffer[1];
+        break;
+
+    case RADIO_SET_LORASYMBTIMEOUT:
+        g_sSX1262.ui8SymbolTimeout = pui8Buffer[0];
+        break;
+
+    case RADIO_CFG_DIOIRQ:
+        g_sSX1262.ui16IrqMask = (pui8Buffer[0] << 8) | pui8Buffer[1];
+        g_sSX1262.ui16Dio1Mask = (pui8Buffer[2] << 8) | pui8Buffer[3];
+        sx1262_dio1_update();
+        break;
+
+    case RADIO_CLR_IRQSTATUS:
+        g_sSX1262.ui16IrqStatus &= ~((pui8Buffer[0] << 8) | pui8Buffer[1]);
+        sx1262_dio1_update();
+        break;
+
+    default:
+        // Configuration without an observable effect on the model.
+        break;
+    }
+}
+
+static uint8_t sx1262_query(RadioCommands_t command, uint8_t *pui8Buffer, uint16_t ui16Size)
+{
+    uint8_t pui8Reply[6] = {0};
+
+    switch (command)
+    {
+    case RADIO_GET_PACKETTYPE:
+        pui8Reply[0] = g_sSX1262.ePacketType;
+        break;
+
+    case RADIO_GET_IRQSTATUS:
+        pui8Reply[0] = g_sSX1262.ui16IrqStatus >> 8;
+        pui8Reply[1] = g_sSX1262.ui16IrqStatus & 0xFF;
+        break;
+
+    case RADIO_GET_RXBUFFERSTATUS:
+        pui8Reply[0] = 0;
+        pui8Reply[1] = g_sSX1262.ui8RxBase;
+        break;
+
+    case RADIO_GET_PACKETSTATUS:
+        pui8Reply[0] = SX1262_RSSI_PKT;
+        pui8Reply[1] = 0;
+        pui8Reply[2] = SX1262_RSSI_PKT;
+        break;
+
+    case RADIO_GET_RSSIINST:
+        pui8Reply[0] = SX1262_RSSI_INST;
+        break;
+
+    default:
+        break;
+    }
+
+    if (pui8Buffer)
+    {
+        memcpy(pui8Buffer, pui8Reply, (ui16Size < sizeof(pui8Reply)) ? ui16Size : sizeof(pui8Reply));
+    }
+
+    // Chip mode and a successful command status.
+    switch (g_sSX1262.eMode)
+    {
+    case MODE_STDBY_XOSC:
+        return (0x3 << 4) | (0x1 << 1);
+    case MODE_FS:
+        return (0x4 << 4) | (0x1 << 1);
+    case MODE_RX:
+    case MODE_CAD:
+        return (0x5 << 4) | (0x1 << 1);
+    case MODE_TX:
+        return (0x6 << 4) | (0x1 << 1);
+    default:
+        return (0x2 << 4) | (0x1 << 1);
+    }
+}
+
+static void sx1262_registers_read(uint16_t ui16Address, uint8_t *pui8Buffer, uint16_t ui16Size)
+{
+    for (uint16_t i = 0; i < ui16Size; i++)
+    {
+        uint16_t ui16Register = (ui16Address + i) % SX1262_REGISTER_SIZE;
+
+        if ((ui16Register >= RANDOM_NUMBER_GENERATORBASEADDR) &&
+            (ui16Register < RANDOM_NUMBER_GENERATORBASEADDR + 4))
+        {
+            pui8Buffer[i] = rand() & 0xFF;
+        }
+        else
+        {
+            pui8Buffer[i] = g_sSX1262.pui8Registers[ui16Register];
+        }
+    }
+}
+
+static void sx1262_registers_write(uint16_t ui16Address, const uint8_t *pui8Buffer,
+                                   uint16_t ui16Size)
+{
+    for (uint16_t i = 0; i < ui16Size; i++)
+    {
+        g_sSX1262.pui8Registers[(ui16Address + i) % SX1262_REGISTER_SIZE] = pui8Buffer[i];
+    }
+}
+
+//*****************************************************************************
+//
+// Board API.
+//
+//*****************************************************************************
+void SX126xIoInit(void)
+{
+    am_hal_gpio_pinconfig(RADIO_NRESET, g_AM_HAL_GPIO_OUTPUT);
+    am_hal_gpio_pinconfig(RADIO_BUSY, g_AM_HAL_GPIO_INPUT);
+    am_hal_gpio_pinconfig(RADIO_DIO1, s_RADIO_DIO1);
+
+    SX126xSpi.eInterfaceMode = AM_HAL_IOM_SPI_MODE;
+    SX126xSpi.ui32ClockFreq  = AM_HAL_IOM_4MHZ;
+    SX126xSpi.eSpiMode       = AM_HAL_IOM_SPI_MODE_0;
+
+    am_hal_iom_initialize(SX1262_IOM_MODULE, &SX126xHandle);
+    am_hal_iom_power_ctrl(SX126xHandle, AM_HAL_SYSCTRL_WAKE, false);
+    am_hal_iom_configure(SX126xHandle, &SX126xSpi);
+    am_hal_iom_enable(SX126xHandle);
+
+    am_hal_posix_lock();
+    sx1262_reset();
+    am_hal_posix_unlock();
+}
+
+void SX126xIoIrqHandler(void)
+{
+    if (SX126xL3RadioIrqHandle)
+    {
+        SX126xL3RadioIrqHandle(NULL);
+    }
+
+    lorawan_wake_on_radio_irq();
+}
+
+void SX126xIoIrqInit(DioIrqHandler dioIrq)
+{
+    SX126xL3RadioIrqHandle = dioIrq;
+    am_hal_gpio_interrupt_register(RADIO_DIO1, SX126xIoIrqHandler);
+    am_hal_gpio_interrupt_clear(AM_HAL_GPIO_BIT(RADIO_DIO1));
+    am_hal_gpio_interrupt_enable(AM_HAL_GPIO_BIT(RADIO_DIO1));
+    NVIC_EnableIRQ(GPIO_IRQn);
+}
+
+void SX126xIoDeInit(void)
+{
+    am_hal_gpio_interrupt_disable(AM_HAL_GPIO_BIT(RADIO_DIO1));
+    am_hal_gpio_interrupt_clear(AM_HAL_GPIO_BIT(RADIO_DIO1));
+
+    am_hal_iom_disable(SX126xHandle);
+    am_hal_iom_power_ctrl(SX126xHandle, AM_HAL_SYSCTRL_DEEPSLEEP, false);
+    am_hal_iom_uninitialize(SX126xHandle);
+
+    am_hal_gpio_pinconfig(RADIO_NRESET, g_AM_HAL_GPIO_DISABLE);
+    am_hal_gpio_pinconfig(RADIO_BUSY, g_AM_HAL_GPIO_DISABLE);
+    am_hal_gpio_pinconfig(RADIO_DIO1, g_AM_HAL_GPIO_DISABLE);
+}
+
+void SX126xIoTcxoInit(void) {}
+
+uint32_t SX126xGetBoardTcxoWakeupTime(void) { return 0; }
+
+void SX126xIoRfSwitchInit(void) { SX126xSetDio2AsRfSwitchCtrl(true); }
+
+RadioOperatingModes_t SX126xGetOperatingMode(void) { return OperatingMode; }
+
+void SX126xSetOperatingMode(RadioOperatingModes_t mode)
+{
+    OperatingMode = mode;
+    lorawan_radio_mode_changed(mode, OperatingTxPower);
+}
+
+void SX126xReset(void)
+{
+    am_hal_gpio_state_write(RADIO_NRESET, AM_HAL_GPIO_OUTPUT_CLEAR);
+    am_util_delay_us(100);
+
+    am_hal_posix_lock();
+    sx1262_reset();
+    am_hal_posix_unlock();
+
+    am_hal_gpio_state_write(RADIO_NRESET, AM_HAL_GPIO_OUTPUT_SET);
+    am_util_delay_us(100);
+}
+
+void SX126xWaitOnBusy(void)
+{
+    // The model completes every command at once.
+}
+
+void SX126xWakeup(void)
+{
+    CRITICAL_SECTION_BEGIN();
+
+    am_hal_posix_lock();
+    g_sSX1262.eMode = MODE_STDBY_RC;
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+    SX126xSetOperatingMode(MODE_STDBY_RC);
+    CRITICAL_SECTION_END();
+}
+
+void SX126xWriteCommand(RadioCommands_t command, uint8_t *buffer, uint16_t size)
+{
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    sx1262_command(command, buffer, size);
+    am_hal_posix_unlock();
+
+    if (command != RADIO_SET_SLEEP) {
+        SX126xWaitOnBusy();
+    }
+}
+
+uint8_t SX126xReadCommand(RadioCommands_t command, uint8_t *buffer,
+                          uint16_t size)
+{
+    uint8_t status;
+
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    status = sx1262_query(command, buffer, size);
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+
+    return status;
+}
+
+void SX126xWriteRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
+{
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    sx1262_registers_write(address, buffer, size);
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+}
+
+void SX126xWriteRegister(uint16_t address, uint8_t value)
+{
+    SX126xWriteRegisters(address, &value, 1);
+}
+
+void SX126xReadRegisters(uint16_t address, uint8_t *buffer, uint16_t size)
+{
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    sx1262_registers_read(address, buffer, size);
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+}
+
+uint8_t SX126xReadRegister(uint16_t address)
+{
+    uint8_t data;
+
+    SX126xReadRegisters(address, &data, 1);
+    return data;
+}
+
+void SX126xWriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
+{
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    for (uint16_t i = 0; i < size; i++)
+    {
+        g_sSX1262.pui8Buffer[(uint8_t)(offset + i)] = buffer[i];
+    }
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+}
+
+void SX126xReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size)
+{
+    SX126xCheckDeviceReady();
+
+    am_hal_posix_lock();
+    for (uint16_t i = 0; i < size; i++)
+    {
+        buffer[i] = g_sSX1262.pui8Buffer[(uint8_t)(offset + i)];
+    }
+    am_hal_posix_unlock();
+
+    SX126xWaitOnBusy();
+}
+
+void SX126xSetRfTxPower(int8_t power)
+{
+    OperatingTxPower = power;
+    SX126xSetTxParams(power, RADIO_RAMP_40_US);
+}
+
+uint8_t SX126xGetDeviceId(void) { return SX1262; }
+
+void SX126xAntSwOn(void) {}
+
+void SX126xAntSwOff(void) {}
+
+bool SX126xCheckRfFrequency(uint32_t frequency) { return true; }
+
+uint32_t SX126xGetDio1PinState()
+{
+    uint32_t value;
+    am_hal_gpio_state_read(RADIO_DIO1, AM_HAL_GPIO_INPUT_READ, &value);
+
+    return value;
+}
@@ -0,0 +1,263 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+//*****************************************************************************
+//
+// Host model of the flash.  The main array is a file mapped at its address
+// on the part, so code that reads flash through a pointer works unchanged
+// and the contents survive a reset or a new run.  The file is NMSDK_FLASH,
+// or flash.bin in the working directory, and is created erased.
+//
+// The boot loader and the start of the application image are not mapped:
+// Linux does not allow mappings below vm.mmap_min_addr, 64 kB by default,
+// and nothing on the host reads them.
+//
+// Programming clears bits the way it does on the part.  Erase and program
+// take no virtual time.
+//
+//*****************************************************************************
+#define FLASH_MAP_START     0x10000
+#define FLASH_MAP_END       (AM_HAL_FLASH_ADDR + AM_HAL_FLASH_TOTAL_SIZE)
+
+//
+// Cycles taken by one iteration of the delay loop in the boot ROM.
+//
+#define FLASH_DELAY_CYCLES  3
+
+__attribute__((constructor)) static void
+am_hal_flash_posix_init(void)
+{
+    const char *pcPath = getenv("NMSDK_FLASH");
+    struct stat sStat;
+    void *pvFlash;
+    int iFile;
+
+    if (pcPath == NULL)
+    {
+        pcPath = "flash.bin";
+    }
+
+    iFile = open(pcPath, O_RDWR | O_CREAT, 0644);
+    if ((iFile < 0) || (fstat(iFile, &sStat) != 0))
+    {
+        perror(pcPath);
+        exit(EXIT_FAILURE);
+    }
+
+    if (sStat.st_size < FLASH_MAP_END)
+    {
+        static const uint8_t pui8Erased[AM_HAL_FLASH_PAGE_SIZE] =
+            {[0 ... AM_HAL_FLASH_PAGE_SIZE - 1] = 0xFF};
+        off_t iOffset = sStat.st_size & ~(off_t)(AM_HAL_FLASH_PAGE_SIZE - 1);
+
+        while (iOffset < FLASH_MAP_END)
+        {
+            if (pwrite(iFile, pui8Erased, sizeof(pui8Erased), iOffset) != sizeof(pui8Erased))
+            {
+                perror(pcPath);
+                exit(EXIT_FAILURE);
+            }
+            iOffset += sizeof(pui8Erased);
+        }
+    }
+
+    pvFlash = mmap((void *)FLASH_MAP_START, FLASH_MAP_END - FLASH_MAP_START,
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, iFile,
+                   FLASH_MAP_START);
+    if (pvFlash != (void *)FLASH_MAP_START)
+    {
+        fprintf(stderr, "%s: cannot map at 0x%x, check vm.mmap_min_addr\n", pcPath,
+                FLASH_MAP_START);
+        exit(EXIT_FAILURE);
+    }
+
+    close(iFile);
+}
+
+static bool
+flash_range_valid(uint32_t ui32Address, uint32_t ui32Bytes)
+{
+    return (ui32Address >= FLASH_MAP_START) && (ui32Address <= FLASH_MAP_END) &&
+           (ui32Bytes <= FLASH_MAP_END - ui32Address);
+}
+
+static uint32_t
+flash_address(const void *pvAddress)
+{
+    return (uint32_t)(uintptr_t)pvAddress;
+}
+
+//*****************************************************************************
+//
+// Erase and program.
+//
+//*****************************************************************************
+int
+am_hal_flash_page_erase(uint32_t ui32ProgramKey, uint32_t ui32FlashInst, uint32_t ui32PageNum)
+{
+    uint32_t ui32Address = AM_HAL_FLASH_ADDR + ui32FlashInst * AM_HAL_FLASH_INSTANCE_SIZE +
+                           ui32PageNum * AM_HAL_FLASH_PAGE_SIZE;
+
+    if (ui32ProgramKey != AM_HAL_FLASH_PROGRAM_KEY)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    if ((ui32FlashInst >= AM_HAL_FLASH_NUM_INSTANCES) ||
+        (ui32PageNum >= AM_HAL_FLASH_INSTANCE_PAGES) ||
+        !flash_range_valid(ui32Address, AM_HAL_FLASH_PAGE_SIZE))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    memset((void *)(uintptr_t)ui32Address, 0xFF, AM_HAL_FLASH_PAGE_SIZE);
+
+    return 0;
+}
+
+int
+am_hal_flash_mass_erase(uint32_t ui32ProgramKey, uint32_t ui32FlashInst)
+{
+    for (uint32_t ui32Page = 0; ui32Page < AM_HAL_FLASH_INSTANCE_PAGES; ui32Page++)
+    {
+        uint32_t ui32Address = AM_HAL_FLASH_ADDR + ui32FlashInst * AM_HAL_FLASH_INSTANCE_SIZE +
+                               ui32Page * AM_HAL_FLASH_PAGE_SIZE;
+
+        if (flash_range_valid(ui32Address, AM_HAL_FLASH_PAGE_SIZE))
+        {
+            int iResult = am_hal_flash_page_erase(ui32ProgramKey, ui32FlashInst, ui32Page);
+            if (iResult)
+            {
+                return iResult;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int
+am_hal_flash_program_main(uint32_t ui32ProgramKey, uint32_t *pui32Src, uint32_t *pui32Dst,
+                          uint32_t ui32NumWords)
+{
+    if (ui32ProgramKey != AM_HAL_FLASH_PROGRAM_KEY)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    if (!flash_range_valid(flash_address(pui32Dst), ui32NumWords * 4))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    for (uint32_t i = 0; i < ui32NumWords; i++)
+    {
+        pui32Dst[i] &= pui32Src[i];
+    }
+
+    return 0;
+}
+
+int
+am_hal_flash_clear_bits(uint32_t ui32ProgramKey, uint32_t *pui32Addr, uint32_t ui32BitMask)
+{
+    uint32_t ui32Value = ~ui32BitMask;
+
+    return am_hal_flash_program_main(ui32ProgramKey, &ui32Value, pui32Addr, 1);
+}
+
+void
+am_hal_flash_store_ui32(uint32_t *pui32Address, uint32_t ui32Data)
+{
+    *pui32Address = ui32Data;
+}
+
+uint32_t
+am_hal_flash_load_ui32(uint32_t *pui32Address)
+{
+    return *pui32Address;
+}
+
+//*****************************************************************************
+//
+// Delays wait for the virtual time the boot ROM loop would have taken.
+//
+//*****************************************************************************
+void
+am_hal_flash_delay(uint32_t ui32Iterations)
+{
+    am_hal_clkgen_status_t sStatus;
+    uint64_t ui64Until;
+
+    am_hal_clkgen_status_get(&sStatus);
+    ui64Until = am_hal_posix_time_ns() +
+                (uint64_t)ui32Iterations * FLASH_DELAY_CYCLES * 1000000000ULL /
+                sStatus.ui32SysclkFreq;
+
+    while (am_hal_posix_time_ns() < ui64Until)
+    {
+    }
+}
+
+uint32_t
+am_hal_flash_delay_status_check(uint32_t ui32usMaxDelay, uint32_t ui32Address,
+                                uint32_t ui32Mask, uint32_t ui32Value, bool bIsEqual)
+{
+    while (1)
+    {
+        if (bIsEqual == ((*(volatile uint32_t *)(uintptr_t)ui32Address & ui32Mask) == ui32Value))
+        {
+            return AM_HAL_STATUS_SUCCESS;
+        }
+
+        if (ui32usMaxDelay-- == 0)
+        {
+            return AM_HAL_STATUS_TIMEOUT;
+        }
+
+        am_hal_flash_delay(FLASH_CYCLES_US(1));
+    }
+}
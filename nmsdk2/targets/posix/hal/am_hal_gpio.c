@@ -0,0 +1,493 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+//*****************************************************************************
+//
+// Host model of the GPIO pads.  Each pad has an output latch, an output
+// enable and an input level that peripheral models drive with
+// am_hal_gpio_posix_input_set().  Edges on an input enabled pad raise the
+// configured interrupt.
+//
+//*****************************************************************************
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_DISABLE =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_2MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_TRISTATE =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_2MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_TRISTATE
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT_PULLUP =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN,
+    .ePullup        = AM_HAL_GPIO_PIN_PULLUP_WEAK
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT_PULLUP_1_5 =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN,
+    .ePullup        = AM_HAL_GPIO_PIN_PULLUP_1_5K
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT_PULLUP_6 =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN,
+    .ePullup        = AM_HAL_GPIO_PIN_PULLUP_6K
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT_PULLUP_12 =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN,
+    .ePullup        = AM_HAL_GPIO_PIN_PULLUP_12K
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_INPUT_PULLUP_24 =
+{
+    .uFuncSel       = 3,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_DISABLE,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN,
+    .ePullup        = AM_HAL_GPIO_PIN_PULLUP_24K
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_OUTPUT =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_2MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_OUTPUT_4 =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_4MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_OUTPUT_8 =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_8MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_OUTPUT_12 =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_12MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL
+};
+
+const am_hal_gpio_pincfg_t g_AM_HAL_GPIO_OUTPUT_WITH_READ =
+{
+    .uFuncSel       = 3,
+    .eDriveStrength = AM_HAL_GPIO_PIN_DRIVESTRENGTH_2MA,
+    .eGPOutcfg      = AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL,
+    .eGPInput       = AM_HAL_GPIO_PIN_INPUT_ENABLE,
+    .eGPRdZero      = AM_HAL_GPIO_PIN_RDZERO_READPIN
+};
+
+typedef struct
+{
+    am_hal_gpio_pincfg_t psConfig[AM_HAL_GPIO_MAX_PADS];
+    uint64_t ui64Output;
+    uint64_t ui64OutputEnable;
+    uint64_t ui64Input;
+    uint64_t ui64IntEnable;
+    uint64_t ui64IntStatus;
+    am_hal_gpio_handler_t ppfnHandler[AM_HAL_GPIO_MAX_PADS];
+    am_hal_gpio_handler_adv_t ppfnHandlerAdv[AM_HAL_GPIO_MAX_PADS];
+    void *ppHandlerCtxt[AM_HAL_GPIO_MAX_PADS];
+} gpio_state_t;
+
+static gpio_state_t g_sGpio;
+
+#define GPIO_PIN_VALID(n)   ((n) < AM_HAL_GPIO_MAX_PADS)
+#define GPIO_PIN_BIT(n)     ((uint64_t)1 << (n))
+
+uint32_t
+am_hal_gpio_pinconfig(uint32_t ui32Pin, am_hal_gpio_pincfg_t sPincfg)
+{
+    if (!GPIO_PIN_VALID(ui32Pin))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    am_hal_posix_lock();
+
+    g_sGpio.psConfig[ui32Pin] = sPincfg;
+
+    if ((sPincfg.eGPOutcfg == AM_HAL_GPIO_PIN_OUTCFG_PUSHPULL) ||
+        (sPincfg.eGPOutcfg == AM_HAL_GPIO_PIN_OUTCFG_OPENDRAIN))
+    {
+        g_sGpio.ui64OutputEnable |= GPIO_PIN_BIT(ui32Pin);
+    }
+    else
+    {
+        g_sGpio.ui64OutputEnable &= ~GPIO_PIN_BIT(ui32Pin);
+    }
+
+    //
+    // An unconnected pad with a pullup reads high.
+    //
+    if (sPincfg.ePullup && (sPincfg.ePullup != AM_HAL_GPIO_PIN_PULLDOWN))
+    {
+        g_sGpio.ui64Input |= GPIO_PIN_BIT(ui32Pin);
+    }
+
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_fast_pinconfig(uint64_t ui64PinMask, am_hal_gpio_pincfg_t bfGpioCfg,
+                           uint32_t ui32Masks[])
+{
+    (void)ui32Masks;
+
+    for (uint32_t i = 0; i < AM_HAL_GPIO_MAX_PADS; i++)
+    {
+        if (ui64PinMask & GPIO_PIN_BIT(i))
+        {
+            am_hal_gpio_pinconfig(i, bfGpioCfg);
+        }
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_state_read(uint32_t ui32Pin, am_hal_gpio_read_type_e eReadType,
+                       uint32_t *pui32RetVal)
+{
+    if (!GPIO_PIN_VALID(ui32Pin) || (pui32RetVal == NULL))
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_lock();
+
+    switch (eReadType)
+    {
+    case AM_HAL_GPIO_INPUT_READ:
+        if (g_sGpio.psConfig[ui32Pin].eGPInput != AM_HAL_GPIO_PIN_INPUT_ENABLE)
+        {
+            *pui32RetVal = 0;
+        }
+        else if (g_sGpio.ui64OutputEnable & GPIO_PIN_BIT(ui32Pin))
+        {
+            *pui32RetVal = (g_sGpio.ui64Output >> ui32Pin) & 1;
+        }
+        else
+        {
+            *pui32RetVal = (g_sGpio.ui64Input >> ui32Pin) & 1;
+        }
+        break;
+
+    case AM_HAL_GPIO_OUTPUT_READ:
+        *pui32RetVal = (g_sGpio.ui64Output >> ui32Pin) & 1;
+        break;
+
+    case AM_HAL_GPIO_ENABLE_READ:
+        *pui32RetVal = (g_sGpio.ui64OutputEnable >> ui32Pin) & 1;
+        break;
+
+    default:
+        am_hal_posix_unlock();
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_state_write(uint32_t ui32Pin, am_hal_gpio_write_type_e eWriteType)
+{
+    if (!GPIO_PIN_VALID(ui32Pin))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    am_hal_posix_lock();
+
+    switch (eWriteType)
+    {
+    case AM_HAL_GPIO_OUTPUT_CLEAR:
+        g_sGpio.ui64Output &= ~GPIO_PIN_BIT(ui32Pin);
+        break;
+    case AM_HAL_GPIO_OUTPUT_SET:
+        g_sGpio.ui64Output |= GPIO_PIN_BIT(ui32Pin);
+        break;
+    case AM_HAL_GPIO_OUTPUT_TOGGLE:
+        g_sGpio.ui64Output ^= GPIO_PIN_BIT(ui32Pin);
+        break;
+    case AM_HAL_GPIO_OUTPUT_TRISTATE_DISABLE:
+        g_sGpio.ui64OutputEnable |= GPIO_PIN_BIT(ui32Pin);
+        break;
+    case AM_HAL_GPIO_OUTPUT_TRISTATE_ENABLE:
+        g_sGpio.ui64OutputEnable &= ~GPIO_PIN_BIT(ui32Pin);
+        break;
+    case AM_HAL_GPIO_OUTPUT_TRISTATE_TOGGLE:
+        g_sGpio.ui64OutputEnable ^= GPIO_PIN_BIT(ui32Pin);
+        break;
+    default:
+        am_hal_posix_unlock();
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+void
+am_hal_gpio_posix_input_set(uint32_t ui32Pin, bool bLevel)
+{
+    if (!GPIO_PIN_VALID(ui32Pin))
+    {
+        return;
+    }
+
+    am_hal_posix_lock();
+
+    uint64_t ui64Bit = GPIO_PIN_BIT(ui32Pin);
+    bool bOld = (g_sGpio.ui64Input & ui64Bit) != 0;
+
+    if (bLevel)
+    {
+        g_sGpio.ui64Input |= ui64Bit;
+    }
+    else
+    {
+        g_sGpio.ui64Input &= ~ui64Bit;
+    }
+
+    const am_hal_gpio_pincfg_t *psConfig = &g_sGpio.psConfig[ui32Pin];
+    if ((bOld != bLevel) && (psConfig->eGPInput == AM_HAL_GPIO_PIN_INPUT_ENABLE))
+    {
+        bool bEdge;
+
+        switch (psConfig->eIntDir)
+        {
+        case AM_HAL_GPIO_PIN_INTDIR_LO2HI:
+            bEdge = bLevel;
+            break;
+        case AM_HAL_GPIO_PIN_INTDIR_HI2LO:
+            bEdge = !bLevel;
+            break;
+        case AM_HAL_GPIO_PIN_INTDIR_BOTH:
+            bEdge = true;
+            break;
+        default:
+            bEdge = false;
+            break;
+        }
+
+        if (bEdge)
+        {
+            g_sGpio.ui64IntStatus |= ui64Bit;
+            if (g_sGpio.ui64IntEnable & ui64Bit)
+            {
+                NVIC_SetPendingIRQ(GPIO_IRQn);
+            }
+        }
+    }
+
+    am_hal_posix_unlock();
+}
+
+uint32_t
+am_hal_gpio_interrupt_enable(uint64_t ui64InterruptMask)
+{
+    am_hal_posix_lock();
+    g_sGpio.ui64IntEnable |= ui64InterruptMask;
+    if (g_sGpio.ui64IntStatus & ui64InterruptMask)
+    {
+        NVIC_SetPendingIRQ(GPIO_IRQn);
+    }
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_disable(uint64_t ui64InterruptMask)
+{
+    am_hal_posix_lock();
+    g_sGpio.ui64IntEnable &= ~ui64InterruptMask;
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_clear(uint64_t ui64InterruptMask)
+{
+    am_hal_posix_lock();
+    g_sGpio.ui64IntStatus &= ~ui64InterruptMask;
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_status_get(bool bEnabledOnly, uint64_t *pui64IntStatus)
+{
+    if (pui64IntStatus == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_lock();
+    *pui64IntStatus = g_sGpio.ui64IntStatus;
+    if (bEnabledOnly)
+    {
+        *pui64IntStatus &= g_sGpio.ui64IntEnable;
+    }
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_register(uint32_t ui32GPIONumber, am_hal_gpio_handler_t pfnHandler)
+{
+    if (!GPIO_PIN_VALID(ui32GPIONumber))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    g_sGpio.ppfnHandler[ui32GPIONumber] = pfnHandler;
+    g_sGpio.ppfnHandlerAdv[ui32GPIONumber] = NULL;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_register_adv(uint32_t ui32GPIONumber,
+                                   am_hal_gpio_handler_adv_t pfnHandler, void *pCtxt)
+{
+    if (!GPIO_PIN_VALID(ui32GPIONumber))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    g_sGpio.ppfnHandler[ui32GPIONumber] = NULL;
+    g_sGpio.ppfnHandlerAdv[ui32GPIONumber] = pfnHandler;
+    g_sGpio.ppHandlerCtxt[ui32GPIONumber] = pCtxt;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_gpio_interrupt_service(uint64_t ui64Status)
+{
+    uint32_t ui32RetStatus = AM_HAL_STATUS_SUCCESS;
+
+    if (ui64Status & ~(GPIO_PIN_BIT(AM_HAL_GPIO_MAX_PADS) - 1))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    if (ui64Status == 0)
+    {
+        return AM_HAL_STATUS_FAIL;
+    }
+
+    while (ui64Status)
+    {
+        uint32_t ui32Pin = __builtin_ctzll(ui64Status);
+        ui64Status &= ui64Status - 1;
+
+        if (g_sGpio.ppfnHandler[ui32Pin])
+        {
+            g_sGpio.ppfnHandler[ui32Pin]();
+        }
+        else if (g_sGpio.ppfnHandlerAdv[ui32Pin])
+        {
+            g_sGpio.ppfnHandlerAdv[ui32Pin](g_sGpio.ppHandlerCtxt[ui32Pin]);
+        }
+        else
+        {
+            ui32RetStatus = AM_HAL_STATUS_INVALID_OPERATION;
+        }
+    }
+
+    return ui32RetStatus;
+}
+
+bool
+am_hal_gpio_isinput(uint32_t ui32Pin)
+{
+    return GPIO_PIN_VALID(ui32Pin) &&
+           (g_sGpio.psConfig[ui32Pin].eGPInput == AM_HAL_GPIO_PIN_INPUT_ENABLE);
+}
+
+uint32_t
+am_hal_gpio_isgpio(uint32_t ui32Pin)
+{
+    return GPIO_PIN_VALID(ui32Pin) && (g_sGpio.psConfig[ui32Pin].uFuncSel == 3);
+}
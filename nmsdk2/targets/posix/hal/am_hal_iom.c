@@ -0,0 +1,167 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "am_mcu_apollo.h"
+
+//*****************************************************************************
+//
+// Host IOM.  No device is attached to any module: transfers complete at once,
+// writes are discarded and reads return the idle level of the bus.  Board
+// code for the host models its devices above this layer.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Module;
+    bool bEnabled;
+    bool bInUse;
+} iom_state_t;
+
+static iom_state_t g_psIom[AM_REG_IOM_NUM_MODULES];
+
+uint32_t
+am_hal_iom_initialize(uint32_t ui32Module, void **ppHandle)
+{
+    if ((ui32Module >= AM_REG_IOM_NUM_MODULES) || (ppHandle == NULL))
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    if (g_psIom[ui32Module].bInUse)
+    {
+        *ppHandle = NULL;
+        return AM_HAL_STATUS_INVALID_OPERATION;
+    }
+
+    g_psIom[ui32Module].ui32Module = ui32Module;
+    g_psIom[ui32Module].bInUse = true;
+    *ppHandle = &g_psIom[ui32Module];
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_iom_uninitialize(void *pHandle)
+{
+    iom_state_t *psIom = pHandle;
+
+    if (psIom == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    psIom->bEnabled = false;
+    psIom->bInUse = false;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_iom_configure(void *pHandle, am_hal_iom_config_t *psConfig)
+{
+    (void)psConfig;
+
+    return pHandle ? AM_HAL_STATUS_SUCCESS : AM_HAL_STATUS_INVALID_HANDLE;
+}
+
+uint32_t
+am_hal_iom_enable(void *pHandle)
+{
+    iom_state_t *psIom = pHandle;
+
+    if (psIom == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    psIom->bEnabled = true;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_iom_disable(void *pHandle)
+{
+    iom_state_t *psIom = pHandle;
+
+    if (psIom == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    psIom->bEnabled = false;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_iom_power_ctrl(void *pHandle, am_hal_sysctrl_power_state_e ePowerState, bool bRetainState)
+{
+    iom_state_t *psIom = pHandle;
+    am_hal_pwrctrl_periph_e ePeripheral;
+
+    (void)bRetainState;
+
+    if (psIom == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    ePeripheral = (am_hal_pwrctrl_periph_e)(AM_HAL_PWRCTRL_PERIPH_IOM0 + psIom->ui32Module);
+    if (ePowerState == AM_HAL_SYSCTRL_WAKE)
+    {
+        return am_hal_pwrctrl_periph_enable(ePeripheral);
+    }
+
+    return am_hal_pwrctrl_periph_disable(ePeripheral);
+}
+
+uint32_t
+am_hal_iom_blocking_transfer(void *pHandle, am_hal_iom_transfer_t *psTransaction)
+{
+    iom_state_t *psIom = pHandle;
+
+    if ((psIom == NULL) || !psIom->bEnabled)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    if ((psTransaction->eDirection == AM_HAL_IOM_RX) && psTransaction->pui32RxBuffer)
+    {
+        memset(psTransaction->pui32RxBuffer, 0xFF, psTransaction->ui32NumBytes);
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
@@ -0,0 +1,840 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+//*****************************************************************************
+//
+// Emulation parameters.
+//
+//*****************************************************************************
+#define AM_HAL_POSIX_DOORBELL       SIGUSR1
+#define AM_HAL_POSIX_EXCEPTIONS     (16 + 32)
+#define AM_HAL_POSIX_CPU_HZ         48000000ULL
+#define AM_HAL_POSIX_SHUTDOWN_MAX   8
+
+//
+// The vector table of the application, indexed by exception number.
+//
+extern void (* const g_am_pfnVectors[])(void);
+
+//*****************************************************************************
+//
+// Globals.
+//
+//*****************************************************************************
+static pthread_mutex_t g_sLock;
+static pthread_cond_t g_sCpuCond;
+static pthread_cond_t g_sTimerCond;
+static pthread_t g_sCpuThread;
+static pthread_t g_sTimerThread;
+
+//
+// NVIC state, one bit per exception number.  Written with the lock held.
+//
+static volatile uint64_t g_ui64Pending;
+static volatile uint64_t g_ui64Enabled;
+static uint8_t g_pui8Priority[AM_HAL_POSIX_EXCEPTIONS];
+static uint32_t g_ui32PriorityGroup;
+static bool g_bCpuIdle;
+
+static am_hal_posix_event_t *g_psEvents;
+
+//
+// Virtual time is the host time since start-up scaled by the speed, plus the
+// time skipped while the CPU was idle.
+//
+static uint64_t g_ui64HostStart;
+static double g_dSpeed = 1.0;
+static bool g_bSpeedMax;
+static uint64_t g_ui64Skipped;
+
+static char **g_ppcArgv;
+
+static void (*g_pfnShutdown[AM_HAL_POSIX_SHUTDOWN_MAX])(void);
+static uint32_t g_ui32ShutdownCount;
+
+static DWT_Type g_sDwt;
+static uint32_t g_ui32DwtLast;
+static uint64_t g_ui64DwtBase;
+CoreDebug_Type g_am_hal_posix_core_debug;
+
+//
+// Per thread CPU registers.  A thread that does not own the CPU keeps the
+// doorbell blocked.
+//
+static __thread uint32_t t_ui32Primask;
+static __thread uint32_t t_ui32Ipsr;
+static __thread uint32_t t_ui32LockDepth;
+
+//
+// Local exclusive monitor.  STREX succeeds if the word still holds the value
+// LDREX read, which is how the global monitor behaves for the lock-free
+// producers that use it.  Exception entry clears it, as on the part.
+//
+static __thread volatile uint32_t *t_pui32Exclusive;
+static __thread uint32_t t_ui32ExclusiveValue;
+
+//*****************************************************************************
+//
+// Block or unblock the doorbell of the calling thread.
+//
+//*****************************************************************************
+static void
+doorbell_mask(int iHow)
+{
+    sigset_t sSet;
+
+    sigemptyset(&sSet);
+    sigaddset(&sSet, AM_HAL_POSIX_DOORBELL);
+    pthread_sigmask(iHow, &sSet, NULL);
+}
+
+//*****************************************************************************
+//
+// Ring the doorbell of the CPU owner.  Called with the lock held.
+//
+//*****************************************************************************
+static void
+doorbell_ring(void)
+{
+    pthread_cond_broadcast(&g_sCpuCond);
+    pthread_kill(g_sCpuThread, AM_HAL_POSIX_DOORBELL);
+}
+
+//*****************************************************************************
+//
+// Take the highest priority pending and enabled exception.  Equal priorities
+// are taken in exception number order.  Called with the lock held.
+//
+//*****************************************************************************
+static int
+exception_next(void)
+{
+    uint64_t ui64Ready = g_ui64Pending & g_ui64Enabled;
+    int iBest = -1;
+
+    while (ui64Ready)
+    {
+        int i = __builtin_ctzll(ui64Ready);
+        ui64Ready &= ui64Ready - 1;
+
+        if ((iBest < 0) || (g_pui8Priority[i] < g_pui8Priority[iBest]))
+        {
+            iBest = i;
+        }
+    }
+
+    if (iBest >= 0)
+    {
+        g_ui64Pending &= ~(1ULL << iBest);
+    }
+
+    return iBest;
+}
+
+//*****************************************************************************
+//
+// Run the pending exceptions.  The RTOS port may switch tasks from PendSV, in
+// which case this thread resumes here once it owns the CPU again.
+//
+//*****************************************************************************
+static void
+exception_dispatch(void)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&g_sLock);
+        int iException = exception_next();
+        pthread_mutex_unlock(&g_sLock);
+
+        if (iException < 0)
+        {
+            return;
+        }
+
+        uint32_t ui32Primask = t_ui32Primask;
+        t_ui32Primask = 0;
+        t_ui32Ipsr = iException;
+
+        g_am_pfnVectors[iException]();
+
+        t_ui32Ipsr = 0;
+        t_ui32Primask = ui32Primask;
+        t_pui32Exclusive = NULL;
+    }
+}
+
+static void
+doorbell_handler(int iSignal)
+{
+    int iErrno = errno;
+
+    (void)iSignal;
+
+    if ((t_ui32Ipsr == 0) && (t_ui32Primask == 0) && (t_ui32LockDepth == 0) &&
+        pthread_equal(pthread_self(), g_sCpuThread))
+    {
+        exception_dispatch();
+    }
+
+    errno = iErrno;
+}
+
+//*****************************************************************************
+//
+// Time.
+//
+//*****************************************************************************
+uint64_t
+am_hal_posix_host_ns(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return (uint64_t)sTime.tv_sec * 1000000000ULL + (uint64_t)sTime.tv_nsec;
+}
+
+uint64_t
+am_hal_posix_time_ns(void)
+{
+    uint64_t ui64Host = am_hal_posix_host_ns() - g_ui64HostStart;
+
+    return (uint64_t)(ui64Host * g_dSpeed) + __atomic_load_n(&g_ui64Skipped, __ATOMIC_ACQUIRE);
+}
+
+//*****************************************************************************
+//
+// Lock.
+//
+//*****************************************************************************
+void
+am_hal_posix_lock(void)
+{
+    if ((t_ui32LockDepth++ == 0) && (t_ui32Primask == 0) && (t_ui32Ipsr == 0))
+    {
+        doorbell_mask(SIG_BLOCK);
+    }
+
+    pthread_mutex_lock(&g_sLock);
+}
+
+void
+am_hal_posix_unlock(void)
+{
+    pthread_mutex_unlock(&g_sLock);
+
+    if ((--t_ui32LockDepth == 0) && (t_ui32Primask == 0) && (t_ui32Ipsr == 0))
+    {
+        doorbell_mask(SIG_UNBLOCK);
+    }
+}
+
+//*****************************************************************************
+//
+// Events.
+//
+//*****************************************************************************
+void
+am_hal_posix_event_init(am_hal_posix_event_t *psEvent,
+                        am_hal_posix_event_handler_t pfnHandler, void *pArg)
+{
+    memset(psEvent, 0, sizeof(am_hal_posix_event_t));
+    psEvent->pfnHandler = pfnHandler;
+    psEvent->pArg = pArg;
+}
+
+void
+am_hal_posix_event_stop(am_hal_posix_event_t *psEvent)
+{
+    am_hal_posix_lock();
+
+    if (psEvent->bActive)
+    {
+        am_hal_posix_event_t **ppsLink = &g_psEvents;
+
+        while (*ppsLink != psEvent)
+        {
+            ppsLink = &(*ppsLink)->psNext;
+        }
+
+        *ppsLink = psEvent->psNext;
+        psEvent->bActive = false;
+    }
+
+    am_hal_posix_unlock();
+}
+
+void
+am_hal_posix_event_start(am_hal_posix_event_t *psEvent, uint64_t ui64Time)
+{
+    am_hal_posix_lock();
+
+    am_hal_posix_event_stop(psEvent);
+
+    am_hal_posix_event_t **ppsLink = &g_psEvents;
+    while (*ppsLink && ((*ppsLink)->ui64Time <= ui64Time))
+    {
+        ppsLink = &(*ppsLink)->psNext;
+    }
+
+    psEvent->ui64Time = ui64Time;
+    psEvent->psNext = *ppsLink;
+    psEvent->bActive = true;
+    *ppsLink = psEvent;
+
+    if (g_psEvents == psEvent)
+    {
+        pthread_cond_signal(&g_sTimerCond);
+    }
+
+    am_hal_posix_unlock();
+}
+
+//*****************************************************************************
+//
+// The timer thread runs the events.  At maximum speed it skips the virtual
+// time to the next event whenever the CPU waits for an interrupt.
+//
+//*****************************************************************************
+static void *
+timer_thread(void *pArg)
+{
+    (void)pArg;
+
+    pthread_mutex_lock(&g_sLock);
+
+    for (;;)
+    {
+        uint64_t ui64Now = am_hal_posix_time_ns();
+        am_hal_posix_event_t *psEvent = g_psEvents;
+
+        if (psEvent == NULL)
+        {
+            pthread_cond_wait(&g_sTimerCond, &g_sLock);
+            continue;
+        }
+
+        if (psEvent->ui64Time <= ui64Now)
+        {
+            g_psEvents = psEvent->psNext;
+            psEvent->bActive = false;
+            psEvent->pfnHandler(psEvent->pArg);
+            continue;
+        }
+
+        if (g_bSpeedMax && g_bCpuIdle && !(g_ui64Pending & g_ui64Enabled))
+        {
+            __atomic_add_fetch(&g_ui64Skipped, psEvent->ui64Time - ui64Now, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        uint64_t ui64Wait = (uint64_t)((psEvent->ui64Time - ui64Now) / g_dSpeed) + 1;
+        uint64_t ui64Deadline = am_hal_posix_host_ns() + ui64Wait;
+        struct timespec sDeadline =
+        {
+            .tv_sec = ui64Deadline / 1000000000ULL,
+            .tv_nsec = ui64Deadline % 1000000000ULL,
+        };
+
+        pthread_cond_timedwait(&g_sTimerCond, &g_sLock, &sDeadline);
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// Threads.
+//
+//*****************************************************************************
+typedef struct
+{
+    void *(*pfnEntry)(void *);
+    void *pArg;
+} thread_start_t;
+
+static void *
+thread_trampoline(void *pArg)
+{
+    thread_start_t sStart = *(thread_start_t *)pArg;
+
+    free(pArg);
+
+    //
+    // The doorbell is blocked from the creating thread.
+    //
+    t_ui32Primask = 1;
+
+    return sStart.pfnEntry(sStart.pArg);
+}
+
+int
+am_hal_posix_thread_create(pthread_t *psThread, void *(*pfnEntry)(void *), void *pArg)
+{
+    sigset_t sSet, sOld;
+    int iResult;
+
+    thread_start_t *psStart = malloc(sizeof(thread_start_t));
+    if (psStart == NULL)
+    {
+        return ENOMEM;
+    }
+
+    psStart->pfnEntry = pfnEntry;
+    psStart->pArg = pArg;
+
+    sigemptyset(&sSet);
+    sigaddset(&sSet, AM_HAL_POSIX_DOORBELL);
+    pthread_sigmask(SIG_BLOCK, &sSet, &sOld);
+    iResult = pthread_create(psThread, NULL, thread_trampoline, psStart);
+    pthread_sigmask(SIG_SETMASK, &sOld, NULL);
+
+    if (iResult != 0)
+    {
+        free(psStart);
+    }
+
+    return iResult;
+}
+
+void
+am_hal_posix_cpu_set(pthread_t sThread)
+{
+    am_hal_posix_lock();
+
+    g_sCpuThread = sThread;
+    if (g_ui64Pending & g_ui64Enabled)
+    {
+        doorbell_ring();
+    }
+
+    am_hal_posix_unlock();
+}
+
+char **
+am_hal_posix_argv(void)
+{
+    return g_ppcArgv;
+}
+
+//*****************************************************************************
+//
+// Shutdown.
+//
+//*****************************************************************************
+void
+am_hal_posix_shutdown_register(void (*pfnShutdown)(void))
+{
+    am_hal_posix_lock();
+
+    if (g_ui32ShutdownCount < AM_HAL_POSIX_SHUTDOWN_MAX)
+    {
+        g_pfnShutdown[g_ui32ShutdownCount++] = pfnShutdown;
+    }
+
+    am_hal_posix_unlock();
+}
+
+static void
+shutdown_run(void)
+{
+    for (uint32_t i = 0; i < g_ui32ShutdownCount; i++)
+    {
+        g_pfnShutdown[i]();
+    }
+}
+
+static void
+shutdown_signal(int iSignal)
+{
+    shutdown_run();
+    signal(iSignal, SIG_DFL);
+    raise(iSignal);
+}
+
+//*****************************************************************************
+//
+// Start-up.  Runs before main() on the thread that becomes the CPU.
+//
+//*****************************************************************************
+__attribute__((constructor)) static void
+am_hal_posix_init(int argc, char **argv, char **envp)
+{
+    pthread_mutexattr_t sMutexAttr;
+    pthread_condattr_t sCondAttr;
+    struct sigaction sAction;
+
+    (void)argc;
+    (void)envp;
+    g_ppcArgv = argv;
+
+    pthread_mutexattr_init(&sMutexAttr);
+    pthread_mutexattr_settype(&sMutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&g_sLock, &sMutexAttr);
+    pthread_mutexattr_destroy(&sMutexAttr);
+
+    pthread_condattr_init(&sCondAttr);
+    pthread_condattr_setclock(&sCondAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_sCpuCond, &sCondAttr);
+    pthread_cond_init(&g_sTimerCond, &sCondAttr);
+    pthread_condattr_destroy(&sCondAttr);
+
+    const char *pcSpeed = getenv("NMSDK_SPEED");
+    if (pcSpeed && (strcmp(pcSpeed, "max") == 0))
+    {
+        g_bSpeedMax = true;
+    }
+    else if (pcSpeed && (atof(pcSpeed) > 0))
+    {
+        g_dSpeed = atof(pcSpeed);
+    }
+
+    g_ui64HostStart = am_hal_posix_host_ns();
+    g_sCpuThread = pthread_self();
+
+    //
+    // The system exceptions are always enabled.
+    //
+    g_ui64Enabled = (1ULL << 16) - 1;
+
+    memset(&sAction, 0, sizeof(sAction));
+    sAction.sa_handler = doorbell_handler;
+    sAction.sa_flags = SA_RESTART;
+    sigemptyset(&sAction.sa_mask);
+    sigaction(AM_HAL_POSIX_DOORBELL, &sAction, NULL);
+
+    sAction.sa_handler = shutdown_signal;
+    sAction.sa_flags = SA_RESETHAND;
+    sigaction(SIGINT, &sAction, NULL);
+    sigaction(SIGTERM, &sAction, NULL);
+    atexit(shutdown_run);
+
+    if (am_hal_posix_thread_create(&g_sTimerThread, timer_thread, NULL) != 0)
+    {
+        perror("am_hal_posix: timer thread");
+        exit(EXIT_FAILURE);
+    }
+}
+
+//*****************************************************************************
+//
+// Core intrinsics.
+//
+//*****************************************************************************
+void
+__disable_irq(void)
+{
+    if ((t_ui32Primask == 0) && (t_ui32Ipsr == 0) && (t_ui32LockDepth == 0))
+    {
+        doorbell_mask(SIG_BLOCK);
+    }
+
+    t_ui32Primask = 1;
+}
+
+void
+__enable_irq(void)
+{
+    if (t_ui32Primask == 0)
+    {
+        return;
+    }
+
+    t_ui32Primask = 0;
+
+    if ((t_ui32Ipsr == 0) && (t_ui32LockDepth == 0))
+    {
+        //
+        // Anything pended while masked is taken as soon as the doorbell is
+        // unblocked.
+        //
+        if ((g_ui64Pending & g_ui64Enabled) && pthread_equal(pthread_self(), g_sCpuThread))
+        {
+            pthread_kill(pthread_self(), AM_HAL_POSIX_DOORBELL);
+        }
+
+        doorbell_mask(SIG_UNBLOCK);
+    }
+}
+
+uint32_t
+__get_PRIMASK(void)
+{
+    return t_ui32Primask;
+}
+
+void
+__set_PRIMASK(uint32_t priMask)
+{
+    if (priMask & 1)
+    {
+        __disable_irq();
+    }
+    else
+    {
+        __enable_irq();
+    }
+}
+
+uint32_t
+__get_IPSR(void)
+{
+    return t_ui32Ipsr;
+}
+
+void
+__WFI(void)
+{
+    am_hal_posix_lock();
+
+    if (!(g_ui64Pending & g_ui64Enabled))
+    {
+        g_bCpuIdle = true;
+        pthread_cond_signal(&g_sTimerCond);
+
+        while (!(g_ui64Pending & g_ui64Enabled))
+        {
+            pthread_cond_wait(&g_sCpuCond, &g_sLock);
+        }
+
+        g_bCpuIdle = false;
+    }
+
+    am_hal_posix_unlock();
+}
+
+uint32_t
+__LDREXW(volatile uint32_t *addr)
+{
+    t_pui32Exclusive = addr;
+    t_ui32ExclusiveValue = __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+
+    return t_ui32ExclusiveValue;
+}
+
+uint32_t
+__STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t ui32Expected = t_ui32ExclusiveValue;
+    bool bMatch = (t_pui32Exclusive == addr);
+
+    t_pui32Exclusive = NULL;
+
+    if (bMatch && __atomic_compare_exchange_n(addr, &ui32Expected, value, false,
+                                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+void
+__CLREX(void)
+{
+    t_pui32Exclusive = NULL;
+}
+
+void
+__BKPT(uint32_t value)
+{
+    (void)value;
+
+    shutdown_run();
+    raise(SIGTRAP);
+}
+
+//*****************************************************************************
+//
+// Data Watchpoint and Trace.  A write to CYCCNT rebases the counter.
+//
+//*****************************************************************************
+DWT_Type *
+am_hal_posix_dwt(void)
+{
+    uint64_t ui64Cycles = (am_hal_posix_host_ns() - g_ui64HostStart) * AM_HAL_POSIX_CPU_HZ /
+                          1000000000ULL;
+
+    if (g_sDwt.CYCCNT != g_ui32DwtLast)
+    {
+        g_ui64DwtBase = ui64Cycles - g_sDwt.CYCCNT;
+    }
+
+    g_ui32DwtLast = (uint32_t)(ui64Cycles - g_ui64DwtBase);
+    g_sDwt.CYCCNT = g_ui32DwtLast;
+
+    return &g_sDwt;
+}
+
+//*****************************************************************************
+//
+// NVIC.
+//
+//*****************************************************************************
+static inline uint64_t
+exception_bit(IRQn_Type IRQn)
+{
+    int iException = (int)IRQn + 16;
+
+    if ((iException < 0) || (iException >= AM_HAL_POSIX_EXCEPTIONS))
+    {
+        return 0;
+    }
+
+    return 1ULL << iException;
+}
+
+void
+NVIC_SetPriorityGrouping(uint32_t PriorityGroup)
+{
+    g_ui32PriorityGroup = PriorityGroup & 7;
+}
+
+uint32_t
+NVIC_GetPriorityGrouping(void)
+{
+    return g_ui32PriorityGroup;
+}
+
+void
+NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    uint64_t ui64Bit = exception_bit(IRQn);
+
+    am_hal_posix_lock();
+    g_ui64Enabled |= ui64Bit;
+    if (g_ui64Pending & ui64Bit)
+    {
+        doorbell_ring();
+    }
+    am_hal_posix_unlock();
+}
+
+uint32_t
+NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    return (g_ui64Enabled & exception_bit(IRQn)) ? 1 : 0;
+}
+
+void
+NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn < 0)
+    {
+        return;
+    }
+
+    am_hal_posix_lock();
+    g_ui64Enabled &= ~exception_bit(IRQn);
+    am_hal_posix_unlock();
+}
+
+uint32_t
+NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    return (g_ui64Pending & exception_bit(IRQn)) ? 1 : 0;
+}
+
+void
+NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    uint64_t ui64Bit = exception_bit(IRQn);
+
+    am_hal_posix_lock();
+    g_ui64Pending |= ui64Bit;
+    if (g_ui64Enabled & ui64Bit)
+    {
+        doorbell_ring();
+    }
+    am_hal_posix_unlock();
+}
+
+void
+NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    am_hal_posix_lock();
+    g_ui64Pending &= ~exception_bit(IRQn);
+    am_hal_posix_unlock();
+}
+
+uint32_t
+NVIC_GetActive(IRQn_Type IRQn)
+{
+    return (t_ui32Ipsr == (uint32_t)(IRQn + 16)) ? 1 : 0;
+}
+
+void
+NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    if (exception_bit(IRQn))
+    {
+        g_pui8Priority[IRQn + 16] = (uint8_t)priority;
+    }
+}
+
+uint32_t
+NVIC_GetPriority(IRQn_Type IRQn)
+{
+    return exception_bit(IRQn) ? g_pui8Priority[IRQn + 16] : 0;
+}
+
+//*****************************************************************************
+//
+// A system reset starts the executable again.  The flash file is shared and
+// survives it.
+//
+//*****************************************************************************
+void
+NVIC_SystemReset(void)
+{
+    __disable_irq();
+
+    shutdown_run();
+    fflush(NULL);
+
+    execv("/proc/self/exe", g_ppcArgv);
+
+    perror("am_hal_posix: reset");
+    _exit(EXIT_FAILURE);
+}
@@ -0,0 +1,143 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//*****************************************************************************
+//
+// Apollo3 CPU emulation for the host build.
+//
+// The emulated CPU is owned by one host thread at a time: the main thread
+// until the scheduler starts, then the thread of the running RTOS task.
+// PRIMASK is the owner's mask of the doorbell signal.  Peripheral models
+// pend interrupts from any thread; the owner takes the doorbell and runs the
+// pending vectors in priority order from the signal handler, which is where
+// the RTOS port switches tasks.
+//
+// Time is virtual.  It runs at NMSDK_SPEED times the host clock (default 1),
+// or, with NMSDK_SPEED=max, at the host clock while the CPU is busy and skips
+// ahead to the next event while it sleeps in __WFI().
+//
+//*****************************************************************************
+#ifndef AM_HAL_POSIX_H
+#define AM_HAL_POSIX_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "am_mcu_apollo.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//
+// Virtual time value that never expires.
+//
+#define AM_HAL_POSIX_TIME_NEVER     UINT64_MAX
+
+//
+// Event run by the timer thread at a virtual time, with the HAL lock held.
+//
+typedef void (*am_hal_posix_event_handler_t)(void *pArg);
+
+typedef struct am_hal_posix_event_s
+{
+    struct am_hal_posix_event_s *psNext;
+    uint64_t ui64Time;
+    am_hal_posix_event_handler_t pfnHandler;
+    void *pArg;
+    bool bActive;
+} am_hal_posix_event_t;
+
+//
+// Virtual time in nanoseconds since start-up.
+//
+extern uint64_t am_hal_posix_time_ns(void);
+
+//
+// Host time in nanoseconds, for profiling.
+//
+extern uint64_t am_hal_posix_host_ns(void);
+
+//
+// The HAL lock serializes the peripheral models against the timer and input
+// threads.  It also masks the doorbell of the calling thread so that a task
+// is never switched out while holding it.  The lock is recursive.
+//
+extern void am_hal_posix_lock(void);
+extern void am_hal_posix_unlock(void);
+
+//
+// Events.  Starting an active event reschedules it.
+//
+extern void am_hal_posix_event_init(am_hal_posix_event_t *psEvent,
+                                    am_hal_posix_event_handler_t pfnHandler,
+                                    void *pArg);
+extern void am_hal_posix_event_start(am_hal_posix_event_t *psEvent, uint64_t ui64Time);
+extern void am_hal_posix_event_stop(am_hal_posix_event_t *psEvent);
+
+//
+// Hand the CPU to another thread.  Used by the RTOS port when it switches
+// tasks; the caller must not be interruptible.
+//
+extern void am_hal_posix_cpu_set(pthread_t sThread);
+
+//
+// Start a helper thread with the doorbell blocked.
+//
+extern int am_hal_posix_thread_create(pthread_t *psThread, void *(*pfnEntry)(void *),
+                                      void *pArg);
+
+//
+// Drive a GPIO input from a peripheral model.  An edge on a pin with its
+// interrupt enabled pends GPIO_IRQn.
+//
+extern void am_hal_gpio_posix_input_set(uint32_t ui32Pin, bool bLevel);
+
+//
+// Path of the executable and its arguments, for NVIC_SystemReset().
+//
+extern char **am_hal_posix_argv(void);
+
+//
+// Register a function that returns a host resource to its original state.
+// It runs before NVIC_SystemReset() starts the executable again and when the
+// process exits or is interrupted.
+//
+extern void am_hal_posix_shutdown_register(void (*pfnShutdown)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AM_HAL_POSIX_H
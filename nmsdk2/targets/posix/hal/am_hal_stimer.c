@@ -0,0 +1,395 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+//*****************************************************************************
+//
+// Host model of the system timer.  The counter is derived from the virtual
+// time at the selected clock; each enabled compare schedules an event at the
+// time the counter reaches it.  Only the compare, overflow and NVRAM functions
+// are modelled; captures read as zero.
+//
+//*****************************************************************************
+#define STIMER_COMPARES     8
+#define STIMER_NVRAMS       4
+
+typedef struct
+{
+    uint32_t ui32Config;
+    uint64_t ui64BaseNs;
+    uint64_t ui64BaseCount;
+    uint32_t pui32Compare[STIMER_COMPARES];
+    am_hal_posix_event_t psCompare[STIMER_COMPARES];
+    am_hal_posix_event_t sOverflow;
+    uint32_t ui32IntEnable;
+    uint32_t ui32IntStatus;
+    uint32_t pui32Nvram[STIMER_NVRAMS];
+    bool bInitialized;
+} stimer_state_t;
+
+static stimer_state_t g_sSTimer;
+
+static uint32_t
+stimer_clock_hz(uint32_t ui32Config)
+{
+    switch (_FLD2VAL(CTIMER_STCFG_CLKSEL, ui32Config))
+    {
+    case CTIMER_STCFG_CLKSEL_HFRC_DIV16:
+        return 3000000;
+    case CTIMER_STCFG_CLKSEL_HFRC_DIV256:
+        return 187500;
+    case CTIMER_STCFG_CLKSEL_XTAL_DIV1:
+        return 32768;
+    case CTIMER_STCFG_CLKSEL_XTAL_DIV2:
+        return 16384;
+    case CTIMER_STCFG_CLKSEL_XTAL_DIV32:
+    case CTIMER_STCFG_CLKSEL_LFRC_DIV1:
+        return 1024;
+    default:
+        return 0;
+    }
+}
+
+static bool
+stimer_running(void)
+{
+    return !(g_sSTimer.ui32Config & (CTIMER_STCFG_FREEZE_Msk | CTIMER_STCFG_CLEAR_Msk)) &&
+           (stimer_clock_hz(g_sSTimer.ui32Config) != 0);
+}
+
+static uint64_t
+stimer_count(uint64_t ui64Now)
+{
+    if (!stimer_running())
+    {
+        return g_sSTimer.ui64BaseCount;
+    }
+
+    return g_sSTimer.ui64BaseCount +
+           (uint64_t)((unsigned __int128)(ui64Now - g_sSTimer.ui64BaseNs) *
+                      stimer_clock_hz(g_sSTimer.ui32Config) / 1000000000ULL);
+}
+
+//
+// Virtual time at which the counter reaches a count.
+//
+static uint64_t
+stimer_count_time(uint64_t ui64Count)
+{
+    uint64_t ui64Hz = stimer_clock_hz(g_sSTimer.ui32Config);
+
+    return g_sSTimer.ui64BaseNs +
+           (uint64_t)(((unsigned __int128)(ui64Count - g_sSTimer.ui64BaseCount) * 1000000000ULL +
+                       ui64Hz - 1) / ui64Hz);
+}
+
+static void
+stimer_int_pend(uint32_t ui32Interrupt)
+{
+    ui32Interrupt &= g_sSTimer.ui32IntEnable;
+
+    for (uint32_t i = 0; i < STIMER_COMPARES; i++)
+    {
+        if (ui32Interrupt & (AM_HAL_STIMER_INT_COMPAREA << i))
+        {
+            NVIC_SetPendingIRQ((IRQn_Type)(STIMER_CMPR0_IRQn + i));
+        }
+    }
+
+    if (ui32Interrupt & ~((AM_HAL_STIMER_INT_COMPAREA << STIMER_COMPARES) - 1))
+    {
+        NVIC_SetPendingIRQ(STIMER_IRQn);
+    }
+}
+
+static void
+stimer_schedule(uint32_t ui32Compare, uint64_t ui64Now)
+{
+    am_hal_posix_event_t *psEvent = &g_sSTimer.psCompare[ui32Compare];
+
+    if (!stimer_running() ||
+        !(g_sSTimer.ui32Config & (AM_HAL_STIMER_CFG_COMPARE_A_ENABLE << ui32Compare)))
+    {
+        am_hal_posix_event_stop(psEvent);
+        return;
+    }
+
+    //
+    // The compare matches when the counter next equals it, a full period
+    // later if it equals it now.
+    //
+    uint64_t ui64Count = stimer_count(ui64Now);
+    uint64_t ui64Delta = (uint32_t)(g_sSTimer.pui32Compare[ui32Compare] - (uint32_t)ui64Count);
+    if (ui64Delta == 0)
+    {
+        ui64Delta = 1ULL << 32;
+    }
+
+    am_hal_posix_event_start(psEvent, stimer_count_time(ui64Count + ui64Delta));
+}
+
+static void
+stimer_schedule_overflow(uint64_t ui64Now)
+{
+    if (!stimer_running())
+    {
+        am_hal_posix_event_stop(&g_sSTimer.sOverflow);
+        return;
+    }
+
+    uint64_t ui64Count = stimer_count(ui64Now);
+    am_hal_posix_event_start(&g_sSTimer.sOverflow,
+                             stimer_count_time((ui64Count | 0xFFFFFFFFULL) + 1));
+}
+
+static void
+stimer_schedule_all(uint64_t ui64Now)
+{
+    for (uint32_t i = 0; i < STIMER_COMPARES; i++)
+    {
+        stimer_schedule(i, ui64Now);
+    }
+
+    stimer_schedule_overflow(ui64Now);
+}
+
+static void
+stimer_compare_event(void *pArg)
+{
+    uint32_t ui32Compare = (uint32_t)(uintptr_t)pArg;
+
+    g_sSTimer.ui32IntStatus |= AM_HAL_STIMER_INT_COMPAREA << ui32Compare;
+    stimer_int_pend(AM_HAL_STIMER_INT_COMPAREA << ui32Compare);
+    stimer_schedule(ui32Compare, am_hal_posix_time_ns());
+}
+
+static void
+stimer_overflow_event(void *pArg)
+{
+    (void)pArg;
+
+    g_sSTimer.ui32IntStatus |= AM_HAL_STIMER_INT_OVERFLOW;
+    stimer_int_pend(AM_HAL_STIMER_INT_OVERFLOW);
+    stimer_schedule_overflow(am_hal_posix_time_ns());
+}
+
+//
+// Called with the lock held.
+//
+static void
+stimer_init(void)
+{
+    if (g_sSTimer.bInitialized)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < STIMER_COMPARES; i++)
+    {
+        am_hal_posix_event_init(&g_sSTimer.psCompare[i], stimer_compare_event,
+                                (void *)(uintptr_t)i);
+    }
+
+    am_hal_posix_event_init(&g_sSTimer.sOverflow, stimer_overflow_event, NULL);
+    g_sSTimer.ui64BaseNs = am_hal_posix_time_ns();
+    g_sSTimer.bInitialized = true;
+}
+
+uint32_t
+am_hal_stimer_config(uint32_t ui32STimerConfig)
+{
+    uint32_t ui32CurrVal;
+
+    am_hal_posix_lock();
+    stimer_init();
+
+    uint64_t ui64Now = am_hal_posix_time_ns();
+    g_sSTimer.ui64BaseCount = stimer_count(ui64Now);
+    g_sSTimer.ui64BaseNs = ui64Now;
+
+    ui32CurrVal = g_sSTimer.ui32Config;
+    g_sSTimer.ui32Config = ui32STimerConfig;
+    if (ui32STimerConfig & CTIMER_STCFG_CLEAR_Msk)
+    {
+        g_sSTimer.ui64BaseCount = 0;
+    }
+
+    stimer_schedule_all(ui64Now);
+    am_hal_posix_unlock();
+
+    return ui32CurrVal;
+}
+
+uint32_t
+am_hal_stimer_counter_get(void)
+{
+    uint32_t ui32Count;
+
+    am_hal_posix_lock();
+    stimer_init();
+    ui32Count = (uint32_t)stimer_count(am_hal_posix_time_ns());
+    am_hal_posix_unlock();
+
+    return ui32Count;
+}
+
+void
+am_hal_stimer_counter_clear(void)
+{
+    am_hal_stimer_config(am_hal_stimer_config(AM_HAL_STIMER_CFG_CLEAR) & ~CTIMER_STCFG_CLEAR_Msk);
+}
+
+void
+am_hal_stimer_compare_delta_set(uint32_t ui32CmprInstance, uint32_t ui32Delta)
+{
+    if (ui32CmprInstance >= STIMER_COMPARES)
+    {
+        return;
+    }
+
+    am_hal_posix_lock();
+    stimer_init();
+
+    uint64_t ui64Now = am_hal_posix_time_ns();
+    g_sSTimer.pui32Compare[ui32CmprInstance] = (uint32_t)stimer_count(ui64Now) + ui32Delta;
+    stimer_schedule(ui32CmprInstance, ui64Now);
+
+    am_hal_posix_unlock();
+}
+
+uint32_t
+am_hal_stimer_compare_get(uint32_t ui32CmprInstance)
+{
+    if (ui32CmprInstance >= STIMER_COMPARES)
+    {
+        return 0;
+    }
+
+    return g_sSTimer.pui32Compare[ui32CmprInstance];
+}
+
+void
+am_hal_stimer_capture_start(uint32_t ui32CaptureNum, uint32_t ui32GPIONumber, bool bPolarity)
+{
+    (void)ui32CaptureNum;
+    (void)ui32GPIONumber;
+    (void)bPolarity;
+}
+
+void
+am_hal_stimer_capture_stop(uint32_t ui32CaptureNum)
+{
+    (void)ui32CaptureNum;
+}
+
+uint32_t
+am_hal_stimer_capture_get(uint32_t ui32CaptureNum)
+{
+    (void)ui32CaptureNum;
+
+    return 0;
+}
+
+void
+am_hal_stimer_nvram_set(uint32_t ui32NvramNum, uint32_t ui32NvramVal)
+{
+    if (ui32NvramNum < STIMER_NVRAMS)
+    {
+        g_sSTimer.pui32Nvram[ui32NvramNum] = ui32NvramVal;
+    }
+}
+
+uint32_t
+am_hal_stimer_nvram_get(uint32_t ui32NvramNum)
+{
+    return (ui32NvramNum < STIMER_NVRAMS) ? g_sSTimer.pui32Nvram[ui32NvramNum] : 0;
+}
+
+void
+am_hal_stimer_int_enable(uint32_t ui32Interrupt)
+{
+    am_hal_posix_lock();
+    g_sSTimer.ui32IntEnable |= ui32Interrupt;
+    stimer_int_pend(g_sSTimer.ui32IntStatus & ui32Interrupt);
+    am_hal_posix_unlock();
+}
+
+uint32_t
+am_hal_stimer_int_enable_get(void)
+{
+    return g_sSTimer.ui32IntEnable;
+}
+
+void
+am_hal_stimer_int_disable(uint32_t ui32Interrupt)
+{
+    am_hal_posix_lock();
+    g_sSTimer.ui32IntEnable &= ~ui32Interrupt;
+    am_hal_posix_unlock();
+}
+
+void
+am_hal_stimer_int_set(uint32_t ui32Interrupt)
+{
+    am_hal_posix_lock();
+    g_sSTimer.ui32IntStatus |= ui32Interrupt;
+    stimer_int_pend(ui32Interrupt);
+    am_hal_posix_unlock();
+}
+
+void
+am_hal_stimer_int_clear(uint32_t ui32Interrupt)
+{
+    am_hal_posix_lock();
+    g_sSTimer.ui32IntStatus &= ~ui32Interrupt;
+    am_hal_posix_unlock();
+}
+
+uint32_t
+am_hal_stimer_int_status_get(bool bEnabledOnly)
+{
+    uint32_t ui32Status;
+
+    am_hal_posix_lock();
+    ui32Status = g_sSTimer.ui32IntStatus;
+    if (bEnabledOnly)
+    {
+        ui32Status &= g_sSTimer.ui32IntEnable;
+    }
+    am_hal_posix_unlock();
+
+    return ui32Status;
+}
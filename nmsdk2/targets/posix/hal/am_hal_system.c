@@ -0,0 +1,374 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define _DEFAULT_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+//*****************************************************************************
+//
+// Host versions of the blocks the SDK and the application only configure:
+// clock generator, cache, power control, RTC oscillator, system control,
+// MCU control and the debug trace units.  They keep enough state to answer
+// the status queries and otherwise succeed.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Clock generator.
+//
+//*****************************************************************************
+static uint32_t g_ui32SysclkFreq = AM_HAL_CLKGEN_FREQ_MAX_HZ;
+static uint32_t g_ui32RtcOsc = AM_HAL_CLKGEN_STATUS_RTCOSC_LFRC;
+
+uint32_t
+am_hal_clkgen_control(am_hal_clkgen_control_e eControl, void *pArgs)
+{
+    (void)pArgs;
+
+    switch (eControl)
+    {
+    case AM_HAL_CLKGEN_CONTROL_SYSCLK_MAX:
+        g_ui32SysclkFreq = AM_HAL_CLKGEN_FREQ_MAX_HZ;
+        break;
+
+    case AM_HAL_CLKGEN_CONTROL_SYSCLK_DIV2:
+        g_ui32SysclkFreq = AM_HAL_CLKGEN_FREQ_MAX_HZ / 2;
+        break;
+
+    default:
+        break;
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_clkgen_status_get(am_hal_clkgen_status_t *psStatus)
+{
+    if (psStatus == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    psStatus->ui32SysclkFreq = g_ui32SysclkFreq;
+    psStatus->eRTCOSC = g_ui32RtcOsc;
+    psStatus->bXtalFailure = false;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// Cache controller.
+//
+//*****************************************************************************
+const am_hal_cachectrl_config_t am_hal_cachectrl_defaults =
+{
+    .bLRU                       = 0,
+    .eDescript                  = AM_HAL_CACHECTRL_DESCR_1WAY_128B_1024E,
+    .eMode                      = AM_HAL_CACHECTRL_CONFIG_MODE_INSTR_DATA,
+};
+
+uint32_t
+am_hal_cachectrl_config(const am_hal_cachectrl_config_t *psConfig)
+{
+    (void)psConfig;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_cachectrl_enable(void)
+{
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// Power control.  Only the peripheral power domains that are switched on
+// are tracked, so that the application can see what is powered.
+//
+//*****************************************************************************
+static uint32_t g_ui32PwrctrlPeriphEnabled;
+
+uint32_t
+am_hal_pwrctrl_periph_enable(am_hal_pwrctrl_periph_e ePeripheral)
+{
+    if (ePeripheral >= AM_HAL_PWRCTRL_PERIPH_MAX)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_lock();
+    g_ui32PwrctrlPeriphEnabled |= (1UL << ePeripheral);
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_pwrctrl_periph_disable(am_hal_pwrctrl_periph_e ePeripheral)
+{
+    if (ePeripheral >= AM_HAL_PWRCTRL_PERIPH_MAX)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    am_hal_posix_lock();
+    g_ui32PwrctrlPeriphEnabled &= ~(1UL << ePeripheral);
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_pwrctrl_periph_enabled(am_hal_pwrctrl_periph_e ePeripheral, uint32_t *pui32Enabled)
+{
+    if ((ePeripheral >= AM_HAL_PWRCTRL_PERIPH_MAX) || (pui32Enabled == NULL))
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    *pui32Enabled = (g_ui32PwrctrlPeriphEnabled >> ePeripheral) & 1;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_pwrctrl_low_power_init(void)
+{
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// RTC.  The calendar is the host clock; setting it is ignored.
+//
+//*****************************************************************************
+void
+am_hal_rtc_osc_select(uint32_t ui32OSC)
+{
+    g_ui32RtcOsc = (ui32OSC == AM_HAL_RTC_OSC_XT) ? AM_HAL_CLKGEN_STATUS_RTCOSC_XTAL
+                                                  : AM_HAL_CLKGEN_STATUS_RTCOSC_LFRC;
+}
+
+void
+am_hal_rtc_osc_enable(void)
+{
+}
+
+void
+am_hal_rtc_osc_disable(void)
+{
+}
+
+void
+am_hal_rtc_time_set(am_hal_rtc_time_t *pTime)
+{
+    (void)pTime;
+}
+
+uint32_t
+am_hal_rtc_time_get(am_hal_rtc_time_t *pTime)
+{
+    struct timespec sNow;
+    struct tm sTime;
+
+    clock_gettime(CLOCK_REALTIME, &sNow);
+    gmtime_r(&sNow.tv_sec, &sTime);
+
+    memset(pTime, 0, sizeof(*pTime));
+    pTime->ui32CenturyEnable = 1;
+    pTime->ui32Century = (sTime.tm_year >= 100);
+    pTime->ui32Weekday = sTime.tm_wday;
+    pTime->ui32Year = sTime.tm_year % 100;
+    pTime->ui32Month = sTime.tm_mon + 1;
+    pTime->ui32DayOfMonth = sTime.tm_mday;
+    pTime->ui32Hour = sTime.tm_hour;
+    pTime->ui32Minute = sTime.tm_min;
+    pTime->ui32Second = sTime.tm_sec;
+    pTime->ui32Hundredths = sNow.tv_nsec / 10000000;
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// System control.  Sleep waits for an interrupt; deep sleep is not
+// distinguished.
+//
+//*****************************************************************************
+uint32_t g_am_hal_sysctrl_sleep_count = 0;
+
+void
+am_hal_sysctrl_sleep(bool bSleepDeep)
+{
+    (void)bSleepDeep;
+
+    g_am_hal_sysctrl_sleep_count++;
+
+    __WFI();
+}
+
+void
+am_hal_sysctrl_fpu_enable(void)
+{
+}
+
+void
+am_hal_sysctrl_fpu_disable(void)
+{
+}
+
+void
+am_hal_sysctrl_fpu_stacking_enable(bool bLazy)
+{
+    (void)bLazy;
+}
+
+//*****************************************************************************
+//
+// MCU control.  Reports an Apollo3 Blue rev B1 so that the device
+// identification matches the part.
+//
+// The chip revision macros of the HAL read CHIPREV directly, so the register
+// page of the block is mapped at its address with the revision filled in.
+//
+//*****************************************************************************
+#define MCUCTRL_MAP_SIZE    4096
+
+__attribute__((constructor)) static void
+am_hal_mcuctrl_posix_init(void)
+{
+    void *pvMcuctrl = mmap((void *)MCUCTRL_BASE, MCUCTRL_MAP_SIZE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (pvMcuctrl != (void *)MCUCTRL_BASE)
+    {
+        fprintf(stderr, "am_hal_mcuctrl: cannot map at 0x%x\n", (unsigned)MCUCTRL_BASE);
+        exit(EXIT_FAILURE);
+    }
+
+    MCUCTRL->CHIPREV = 0x21;
+}
+
+uint32_t
+am_hal_mcuctrl_info_get(am_hal_mcuctrl_infoget_e eInfoGet, void *pInfo)
+{
+    if (pInfo == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    switch (eInfoGet)
+    {
+    case AM_HAL_MCUCTRL_INFO_DEVICEID:
+    {
+        am_hal_mcuctrl_device_t *psDevice = pInfo;
+
+        memset(psDevice, 0, sizeof(*psDevice));
+        psDevice->ui32ChipPN = 0x06000000;
+        psDevice->ui32ChipID0 = (uint32_t)gethostid();
+        psDevice->ui32ChipID1 = (uint32_t)getpid();
+        psDevice->ui32ChipRev = 0x21;
+        psDevice->ui32VendorID = ('A' << 24) | ('M' << 16) | ('B' << 8) | ('Q' << 0);
+        psDevice->ui32FlashSize = AM_HAL_FLASH_TOTAL_SIZE;
+        psDevice->ui32SRAMSize = 384 * 1024;
+        psDevice->ui32JedecPN = 0x0C0;
+        psDevice->ui32JedecJEPID = 0x9B;
+        psDevice->ui32JedecCHIPREV = 0x21;
+        psDevice->ui32JedecCID = 0xB105100D;
+        break;
+    }
+
+    default:
+        return AM_HAL_STATUS_INVALID_OPERATION;
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// ITM and TPIU.  ITM prints go to standard error.
+//
+//*****************************************************************************
+void
+am_hal_itm_enable(void)
+{
+}
+
+void
+am_hal_itm_disable(void)
+{
+}
+
+void
+am_hal_itm_print(char *pcString)
+{
+    size_t uLength = strlen(pcString);
+
+    while (uLength)
+    {
+        ssize_t iWritten = write(STDERR_FILENO, pcString, uLength);
+
+        if (iWritten <= 0)
+        {
+            break;
+        }
+
+        pcString += iWritten;
+        uLength -= iWritten;
+    }
+}
+
+void
+am_hal_tpiu_enable(am_hal_tpiu_config_t *psConfig)
+{
+    (void)psConfig;
+}
+
+void
+am_hal_tpiu_disable(void)
+{
+}
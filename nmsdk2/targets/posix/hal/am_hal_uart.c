@@ -0,0 +1,457 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+
+// After the HAL, whose CTIMER registers have fields named like the baud rate
+// macros.
+#include <termios.h>
+
+//*****************************************************************************
+//
+// Host model of the UART.  Module 0 is the console: transmitted bytes go to
+// standard output as soon as they are written and an input thread feeds
+// standard input into the receive FIFO.  Module 1 transmits into nothing and
+// never receives.
+//
+// Received bytes raise RX_TMOUT, as a short burst of keystrokes does on the
+// hardware.  When standard input is a terminal it is switched to
+// non-canonical mode without echo for the life of the process; the console
+// task does its own echo and line editing.
+//
+//*****************************************************************************
+#define UART_MODULES        2
+#define UART_RX_FIFO_SIZE   1024
+
+typedef struct
+{
+    uint32_t ui32Module;
+    bool bInitialized;
+    bool bPowered;
+    uint32_t ui32IntEnable;
+    uint32_t ui32IntStatus;
+    uint8_t pui8RxFifo[UART_RX_FIFO_SIZE];
+    uint32_t ui32RxHead;
+    uint32_t ui32RxCount;
+} uart_state_t;
+
+static uart_state_t g_sUart[UART_MODULES];
+
+static pthread_t g_sInputThread;
+static bool g_bInputStarted;
+static bool g_bTermiosSaved;
+static struct termios g_sTermios;
+
+//*****************************************************************************
+//
+// Terminal handling.
+//
+//*****************************************************************************
+static void
+uart_terminal_restore(void)
+{
+    if (g_bTermiosSaved)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &g_sTermios);
+    }
+}
+
+static void
+uart_terminal_raw(void)
+{
+    struct termios sRaw;
+
+    if (!isatty(STDIN_FILENO) || (tcgetattr(STDIN_FILENO, &g_sTermios) != 0))
+    {
+        return;
+    }
+
+    g_bTermiosSaved = true;
+    am_hal_posix_shutdown_register(uart_terminal_restore);
+
+    sRaw = g_sTermios;
+    sRaw.c_lflag &= ~(ICANON | ECHO);
+    sRaw.c_cc[VMIN] = 1;
+    sRaw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &sRaw);
+}
+
+//*****************************************************************************
+//
+// Interrupts.  Called with the lock held.
+//
+//*****************************************************************************
+static void
+uart_int_update(uart_state_t *psUart)
+{
+    if (psUart->ui32IntStatus & psUart->ui32IntEnable)
+    {
+        NVIC_SetPendingIRQ((IRQn_Type)(UART0_IRQn + psUart->ui32Module));
+    }
+}
+
+//*****************************************************************************
+//
+// The input thread.  Bytes that do not fit in the FIFO are dropped, as an
+// overrun would drop them.
+//
+//*****************************************************************************
+static void *
+uart_input_thread(void *pArg)
+{
+    uart_state_t *psUart = (uart_state_t *)pArg;
+    uint8_t pui8Buffer[64];
+
+    for (;;)
+    {
+        ssize_t iRead = read(STDIN_FILENO, pui8Buffer, sizeof(pui8Buffer));
+
+        if (iRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (iRead == 0)
+        {
+            break;
+        }
+
+        am_hal_posix_lock();
+
+        for (ssize_t i = 0; i < iRead; i++)
+        {
+            if (psUart->ui32RxCount == UART_RX_FIFO_SIZE)
+            {
+                psUart->ui32IntStatus |= AM_HAL_UART_INT_OVER_RUN;
+                break;
+            }
+
+            uint32_t ui32Tail = (psUart->ui32RxHead + psUart->ui32RxCount) % UART_RX_FIFO_SIZE;
+            psUart->pui8RxFifo[ui32Tail] = pui8Buffer[i];
+            psUart->ui32RxCount++;
+        }
+
+        psUart->ui32IntStatus |= AM_HAL_UART_INT_RX_TMOUT;
+        uart_int_update(psUart);
+
+        am_hal_posix_unlock();
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// Module functions.
+//
+//*****************************************************************************
+uint32_t
+am_hal_uart_initialize(uint32_t ui32Module, void **ppHandle)
+{
+    if (ui32Module >= UART_MODULES)
+    {
+        return AM_HAL_STATUS_OUT_OF_RANGE;
+    }
+
+    if (ppHandle == NULL)
+    {
+        return AM_HAL_STATUS_INVALID_ARG;
+    }
+
+    uart_state_t *psUart = &g_sUart[ui32Module];
+
+    am_hal_posix_lock();
+
+    psUart->ui32Module = ui32Module;
+    psUart->bInitialized = true;
+    psUart->ui32IntEnable = 0;
+    psUart->ui32IntStatus = 0;
+
+    if ((ui32Module == 0) && !g_bInputStarted)
+    {
+        g_bInputStarted = true;
+        uart_terminal_raw();
+        am_hal_posix_thread_create(&g_sInputThread, uart_input_thread, psUart);
+    }
+
+    am_hal_posix_unlock();
+
+    *ppHandle = psUart;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_deinitialize(void *pHandle)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    am_hal_posix_lock();
+    psUart->bInitialized = false;
+    psUart->ui32IntEnable = 0;
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_power_control(void *pHandle, am_hal_sysctrl_power_state_e ePowerState,
+                          bool bRetainState)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    (void)bRetainState;
+    psUart->bPowered = (ePowerState == AM_HAL_SYSCTRL_WAKE);
+
+    if (psUart->bPowered)
+    {
+        return am_hal_pwrctrl_periph_enable(
+            (am_hal_pwrctrl_periph_e)(AM_HAL_PWRCTRL_PERIPH_UART0 + psUart->ui32Module));
+    }
+
+    return am_hal_pwrctrl_periph_disable(
+        (am_hal_pwrctrl_periph_e)(AM_HAL_PWRCTRL_PERIPH_UART0 + psUart->ui32Module));
+}
+
+uint32_t
+am_hal_uart_configure(void *pHandle, const am_hal_uart_config_t *psConfig)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    //
+    // As on the hardware, a receive queue turns on the receive interrupts.
+    //
+    if (psConfig->pui8RxBuffer && psConfig->ui32RxBufferSize)
+    {
+        am_hal_uart_interrupt_enable(psUart, AM_HAL_UART_INT_RX | AM_HAL_UART_INT_RX_TMOUT);
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// Transfers.  Writes complete at once; reads return what the FIFO holds.
+//
+//*****************************************************************************
+static uint32_t
+uart_write(uart_state_t *psUart, const uint8_t *pui8Data, uint32_t ui32NumBytes)
+{
+    uint32_t ui32Written = 0;
+
+    if (psUart->ui32Module != 0)
+    {
+        return ui32NumBytes;
+    }
+
+    while (ui32Written < ui32NumBytes)
+    {
+        ssize_t iResult = write(STDOUT_FILENO, pui8Data + ui32Written,
+                                ui32NumBytes - ui32Written);
+        if (iResult < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        ui32Written += (uint32_t)iResult;
+    }
+
+    return ui32Written;
+}
+
+static uint32_t
+uart_read(uart_state_t *psUart, uint8_t *pui8Data, uint32_t ui32NumBytes)
+{
+    uint32_t ui32Read = 0;
+
+    am_hal_posix_lock();
+
+    while ((ui32Read < ui32NumBytes) && psUart->ui32RxCount)
+    {
+        pui8Data[ui32Read++] = psUart->pui8RxFifo[psUart->ui32RxHead];
+        psUart->ui32RxHead = (psUart->ui32RxHead + 1) % UART_RX_FIFO_SIZE;
+        psUart->ui32RxCount--;
+    }
+
+    am_hal_posix_unlock();
+
+    return ui32Read;
+}
+
+uint32_t
+am_hal_uart_transfer(void *pHandle, const am_hal_uart_transfer_t *pTransfer)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+    uint32_t ui32Transferred;
+
+    if (!psUart || !psUart->bInitialized)
+    {
+        return AM_HAL_STATUS_INVALID_HANDLE;
+    }
+
+    switch (pTransfer->ui32Direction)
+    {
+    case AM_HAL_UART_WRITE:
+        ui32Transferred = uart_write(psUart, pTransfer->pui8Data, pTransfer->ui32NumBytes);
+        break;
+
+    case AM_HAL_UART_READ:
+        ui32Transferred = uart_read(psUart, pTransfer->pui8Data, pTransfer->ui32NumBytes);
+        break;
+
+    default:
+        return AM_HAL_STATUS_INVALID_OPERATION;
+    }
+
+    if (pTransfer->pui32BytesTransferred)
+    {
+        *pTransfer->pui32BytesTransferred = ui32Transferred;
+    }
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_tx_flush(void *pHandle)
+{
+    (void)pHandle;
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_flags_get(void *pHandle, uint32_t *pui32Flags)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    *pui32Flags = psUart->ui32RxCount ? AM_HAL_UART_FR_TX_EMPTY
+                                      : (AM_HAL_UART_FR_TX_EMPTY | AM_HAL_UART_FR_RX_EMPTY);
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// Interrupt functions.  Receive status stays raised while the FIFO holds
+// data, so a read that leaves bytes behind is followed by another interrupt.
+//
+//*****************************************************************************
+uint32_t
+am_hal_uart_interrupt_enable(void *pHandle, uint32_t ui32IntMask)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    am_hal_posix_lock();
+    psUart->ui32IntEnable |= ui32IntMask;
+    uart_int_update(psUart);
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_interrupt_disable(void *pHandle, uint32_t ui32IntMask)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    am_hal_posix_lock();
+    psUart->ui32IntEnable &= ~ui32IntMask;
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_interrupt_clear(void *pHandle, uint32_t ui32IntMask)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    am_hal_posix_lock();
+    psUart->ui32IntStatus &= ~ui32IntMask;
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_interrupt_status_get(void *pHandle, uint32_t *pui32Status, bool bEnabledOnly)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    am_hal_posix_lock();
+    *pui32Status = psUart->ui32IntStatus;
+    if (bEnabledOnly)
+    {
+        *pui32Status &= psUart->ui32IntEnable;
+    }
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
+
+uint32_t
+am_hal_uart_interrupt_service(void *pHandle, uint32_t ui32Status, uint32_t *pui32UartTxIdle)
+{
+    uart_state_t *psUart = (uart_state_t *)pHandle;
+
+    (void)ui32Status;
+
+    if (pui32UartTxIdle)
+    {
+        *pui32UartTxIdle = true;
+    }
+
+    am_hal_posix_lock();
+    if (psUart->ui32RxCount)
+    {
+        psUart->ui32IntStatus |= AM_HAL_UART_INT_RX_TMOUT;
+    }
+    am_hal_posix_unlock();
+
+    return AM_HAL_STATUS_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//*****************************************************************************
+//
+// Host replacement for the CMSIS Cortex-M4 core header.
+//
+// apollo3.h includes this file after defining IRQn_Type.  It provides the
+// subset of the core peripheral API used by the SDK and the application, on
+// top of the CPU emulation in am_hal_posix.c.  PRIMASK, the NVIC and the
+// active exception number are emulated; register blocks that are only
+// configured (SCB, SysTick, MPU, FPU) are not.
+//
+//*****************************************************************************
+#ifndef CORE_CM4_H
+#define CORE_CM4_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define __CM4_CMSIS_VERSION_MAIN    (5U)
+#define __CM4_CMSIS_VERSION_SUB     (0U)
+#define __CORTEX_M                  (4U)
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+#define __IM    volatile const
+#define __OM    volatile
+#define __IOM   volatile
+
+#ifndef __ASM
+#define __ASM                       __asm
+#endif
+#ifndef __INLINE
+#define __INLINE                    inline
+#endif
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE             static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+#define __STATIC_FORCEINLINE        __attribute__((always_inline)) static inline
+#endif
+#ifndef __NO_RETURN
+#define __NO_RETURN                 __attribute__((__noreturn__))
+#endif
+#ifndef __USED
+#define __USED                      __attribute__((used))
+#endif
+#ifndef __WEAK
+#define __WEAK                      __attribute__((weak))
+#endif
+#ifndef __PACKED
+#define __PACKED                    __attribute__((packed, aligned(1)))
+#endif
+#ifndef __ALIGNED
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+#endif
+
+#define _VAL2FLD(field, value)    (((uint32_t)(value) << field ## _Pos) & field ## _Msk)
+#define _FLD2VAL(field, value)    (((uint32_t)(value) & field ## _Msk) >> field ## _Pos)
+
+//*****************************************************************************
+//
+// Data Watchpoint and Trace.  Only the cycle counter is emulated; it counts
+// host time at configCPU_CLOCK_HZ.
+//
+//*****************************************************************************
+typedef struct
+{
+    __IOM uint32_t CTRL;
+    __IOM uint32_t CYCCNT;
+    __IOM uint32_t CPICNT;
+    __IOM uint32_t EXCCNT;
+    __IOM uint32_t SLEEPCNT;
+    __IOM uint32_t LSUCNT;
+    __IOM uint32_t FOLDCNT;
+    __IM  uint32_t PCSR;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Pos              0U
+#define DWT_CTRL_CYCCNTENA_Msk              (1UL << DWT_CTRL_CYCCNTENA_Pos)
+
+typedef struct
+{
+    __IOM uint32_t DHCSR;
+    __OM  uint32_t DCRSR;
+    __IOM uint32_t DCRDR;
+    __IOM uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Pos          24U
+#define CoreDebug_DEMCR_TRCENA_Msk          (1UL << CoreDebug_DEMCR_TRCENA_Pos)
+
+extern DWT_Type *am_hal_posix_dwt(void);
+extern CoreDebug_Type g_am_hal_posix_core_debug;
+
+#define DWT                                 (am_hal_posix_dwt())
+#define CoreDebug                           (&g_am_hal_posix_core_debug)
+
+//*****************************************************************************
+//
+// NVIC.  Negative IRQ numbers address the system exceptions; only PendSV can
+// be pended.
+//
+//*****************************************************************************
+extern void NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
+extern uint32_t NVIC_GetPriorityGrouping(void);
+extern void NVIC_EnableIRQ(IRQn_Type IRQn);
+extern uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn);
+extern void NVIC_DisableIRQ(IRQn_Type IRQn);
+extern uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+extern void NVIC_SetPendingIRQ(IRQn_Type IRQn);
+extern void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+extern uint32_t NVIC_GetActive(IRQn_Type IRQn);
+extern void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+extern uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+extern __NO_RETURN void NVIC_SystemReset(void);
+
+//*****************************************************************************
+//
+// Core intrinsics.
+//
+//*****************************************************************************
+extern void __enable_irq(void);
+extern void __disable_irq(void);
+extern uint32_t __get_PRIMASK(void);
+extern void __set_PRIMASK(uint32_t priMask);
+extern uint32_t __get_IPSR(void);
+extern void __WFI(void);
+extern void __BKPT(uint32_t value);
+extern uint32_t __LDREXW(volatile uint32_t *addr);
+extern uint32_t __STREXW(uint32_t value, volatile uint32_t *addr);
+extern void __CLREX(void);
+
+#define __WFE()                             __WFI()
+#define __SEV()
+#define __NOP()                             __asm volatile ("" ::: "memory")
+#define __ISB()                             __asm volatile ("" ::: "memory")
+#define __DSB()                             __sync_synchronize()
+#define __DMB()                             __sync_synchronize()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CORE_CM4_H
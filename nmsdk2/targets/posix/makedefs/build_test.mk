@@ -0,0 +1,167 @@
+TEST_DIR := ./test
+TEST_BUILD := $(BUILDDIR_DBG)/test
+
+VPATH += $(TEST_DIR)/timer
+VPATH += $(TEST_DIR)/sar
+VPATH += $(TEST_DIR)/heap
+VPATH += $(TEST_DIR)/localcfg
+
+TIMER_TEST_INC  = -I$(TEST_DIR)/timer
+TIMER_TEST_INC += -I$(LORAWAN)/src/boards
+TIMER_TEST_INC += -I$(LORAWAN)/src/system
+
+#
+# The reference list and a second copy of its model are built with the list
+# timer.h ahead of the system one and every timer and RTC function renamed.
+#
+TIMER_LIST_INC  = -include $(TEST_DIR)/timer/list/timer_list.h
+TIMER_LIST_INC += -I$(TEST_DIR)/timer/list
+TIMER_LIST_INC += $(TIMER_TEST_INC)
+
+TIMER_TEST_SRC += timer_test.c
+TIMER_TEST_SRC += timer_model.c
+TIMER_TEST_SRC += timer.c
+
+TIMER_TEST_BIN := timer_test
+
+TIMER_TEST_BUILD := $(TEST_BUILD)
+
+TIMER_TEST_OBJS  = $(TIMER_TEST_SRC:%.c=$(TIMER_TEST_BUILD)/%.o)
+TIMER_TEST_OBJS += $(TIMER_TEST_BUILD)/timer_model_list.o
+TIMER_TEST_OBJS += $(TIMER_TEST_BUILD)/timer_list.o
+
+TIMER_TEST_DEPS = $(TIMER_TEST_OBJS:%.o=%.d)
+
+#
+# Mesh SAR Rx against the per transaction buffer it replaced.  The stack copy
+# and the copy under sar/buffer share a file name, so both get their own rule.
+#
+MESH := $(BLE)/ble-mesh-profile
+
+SAR_TEST_INC  = -I$(TEST_DIR)/sar
+SAR_TEST_INC += -I$(MESH)/include
+SAR_TEST_INC += -I$(MESH)/sources/stack/include
+SAR_TEST_INC += -I$(MESH)/sources/stack/cfg
+SAR_TEST_INC += -I$(BLE)/ble-host/sources/stack/cfg
+SAR_TEST_INC += -I$(BLE)/ble-host/include
+SAR_TEST_INC += -I$(BLE)/../../targets/nm180100/comms/ble/wsf/include
+SAR_TEST_INC += -I$(BLE)/../../targets/nm180100/comms/ble/wsf/include/util
+
+SAR_TEST_DEFINES = -DWSF_ASSERT_ENABLED=1
+
+SAR_BUFFER_INC  = -include $(TEST_DIR)/sar/buffer/sar_buffer.h
+SAR_BUFFER_INC += $(SAR_TEST_INC)
+
+SAR_TEST_SRC += sar_test.c
+SAR_TEST_SRC += sar_model.c
+SAR_TEST_SRC += sar_stub.c
+
+SAR_TEST_BIN := sar_test
+
+SAR_TEST_OBJS  = $(SAR_TEST_SRC:%.c=$(TEST_BUILD)/%.o)
+SAR_TEST_OBJS += $(TEST_BUILD)/sar_rx_pool.o
+SAR_TEST_OBJS += $(TEST_BUILD)/sar_model_buffer.o
+SAR_TEST_OBJS += $(TEST_BUILD)/sar_rx_buffer.o
+
+SAR_TEST_DEPS = $(SAR_TEST_OBJS:%.o=%.d)
+
+#
+# heap_4 against heap_tlsf, both built with the FreeRTOSConfig.h of the test,
+# which sets the heap size of the nm180100 target.
+#
+HEAP_TEST_INC  = -I$(TEST_DIR)/heap
+HEAP_TEST_INC += -I$(RTOS)/kernel/include
+HEAP_TEST_INC += -I./rtos/FreeRTOS/portable
+
+HEAP_TLSF_INC  = -include $(TEST_DIR)/heap/heap_tlsf.h
+HEAP_TLSF_INC += $(HEAP_TEST_INC)
+
+HEAP_TEST_SRC += heap_test.c
+HEAP_TEST_SRC += heap_model.c
+HEAP_TEST_SRC += heap_4.c
+
+HEAP_TEST_BIN := heap_test
+
+HEAP_TEST_OBJS  = $(HEAP_TEST_SRC:%.c=$(TEST_BUILD)/%.o)
+HEAP_TEST_OBJS += $(TEST_BUILD)/heap_model_tlsf.o
+HEAP_TEST_OBJS += $(TEST_BUILD)/heap_tlsf.o
+
+HEAP_TEST_DEPS = $(HEAP_TEST_OBJS:%.o=%.d)
+
+#
+# Mesh Local Config against a RAM NVM that keeps its datasets across a
+# simulated reset.
+#
+LOCALCFG_TEST_SRC += localcfg_test.c
+
+LOCALCFG_TEST_BIN := localcfg_test
+
+LOCALCFG_TEST_OBJS  = $(LOCALCFG_TEST_SRC:%.c=$(TEST_BUILD)/%.o)
+LOCALCFG_TEST_OBJS += $(TEST_BUILD)/mesh_local_config.o
+
+LOCALCFG_TEST_DEPS = $(LOCALCFG_TEST_OBJS:%.o=%.d)
+
+test: $(TIMER_TEST_BUILD)/$(TIMER_TEST_BIN) $(TEST_BUILD)/$(SAR_TEST_BIN) $(TEST_BUILD)/$(HEAP_TEST_BIN) \
+      $(TEST_BUILD)/$(LOCALCFG_TEST_BIN)
+	$(TIMER_TEST_BUILD)/$(TIMER_TEST_BIN)
+	$(TEST_BUILD)/$(SAR_TEST_BIN)
+	$(TEST_BUILD)/$(HEAP_TEST_BIN)
+	$(TEST_BUILD)/$(LOCALCFG_TEST_BIN)
+
+$(TEST_BUILD):
+	$(MKDIR) -p "$@"
+
+$(TIMER_TEST_BUILD)/$(TIMER_TEST_BIN): $(TIMER_TEST_OBJS)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(TIMER_TEST_SRC:%.c=$(TIMER_TEST_BUILD)/%.o): $(TIMER_TEST_BUILD)/%.o : %.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(TIMER_TEST_INC) $< -o $@
+
+$(TIMER_TEST_BUILD)/timer_model_list.o: $(TEST_DIR)/timer/timer_model.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(TIMER_LIST_INC) $< -o $@
+
+$(TIMER_TEST_BUILD)/timer_list.o: $(TEST_DIR)/timer/list/timer.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(TIMER_LIST_INC) $< -o $@
+
+$(TEST_BUILD)/$(SAR_TEST_BIN): $(SAR_TEST_OBJS)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(SAR_TEST_SRC:%.c=$(TEST_BUILD)/%.o): $(TEST_BUILD)/%.o : %.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_TEST_INC) $< -o $@
+
+$(TEST_BUILD)/sar_rx_pool.o: $(MESH)/sources/stack/transports/mesh_sar_rx.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_TEST_INC) $< -o $@
+
+$(TEST_BUILD)/sar_model_buffer.o: $(TEST_DIR)/sar/sar_model.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_BUFFER_INC) $< -o $@
+
+$(TEST_BUILD)/sar_rx_buffer.o: $(TEST_DIR)/sar/buffer/mesh_sar_rx.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_BUFFER_INC) $< -o $@
+
+$(TEST_BUILD)/$(HEAP_TEST_BIN): $(HEAP_TEST_OBJS)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(HEAP_TEST_SRC:%.c=$(TEST_BUILD)/%.o): $(TEST_BUILD)/%.o : %.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_REL) $(HEAP_TEST_INC) $< -o $@
+
+$(TEST_BUILD)/heap_model_tlsf.o: $(TEST_DIR)/heap/heap_model.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_REL) $(HEAP_TLSF_INC) $< -o $@
+
+# The end marker of heap_tlsf only holds the size and previous block fields,
+# which -Warray-bounds cannot tell from a whole header.
+$(TEST_BUILD)/heap_tlsf.o: ../nm180100/rtos/FreeRTOS/portable/heap_tlsf.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_REL) -Wno-array-bounds $(HEAP_TLSF_INC) $< -o $@
+
+$(TEST_BUILD)/$(LOCALCFG_TEST_BIN): $(LOCALCFG_TEST_OBJS)
+	$(CC) $(LFLAGS) $^ -o $@
+
+$(LOCALCFG_TEST_SRC:%.c=$(TEST_BUILD)/%.o): $(TEST_BUILD)/%.o : %.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_TEST_INC) $< -o $@
+
+$(TEST_BUILD)/mesh_local_config.o: $(MESH)/sources/stack/local_config/mesh_local_config.c | $(TEST_BUILD)
+	$(CC) -c $(CFLAGS_DBG) $(SAR_TEST_DEFINES) $(SAR_TEST_INC) $< -o $@
+
+-include $(TIMER_TEST_DEPS)
+-include $(SAR_TEST_DEPS)
+-include $(HEAP_TEST_DEPS)
+-include $(LOCALCFG_TEST_DEPS)
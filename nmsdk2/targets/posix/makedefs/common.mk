@@ -0,0 +1,45 @@
+TOOLCHAIN ?=
+
+#### Required Executables ####
+SHELL     := /bin/bash
+CC   = $(TOOLCHAIN)gcc
+GCC  = $(TOOLCHAIN)gcc
+CPP  = $(TOOLCHAIN)cpp
+LD   = $(TOOLCHAIN)ld
+OD   = $(TOOLCHAIN)objdump
+RD   = $(TOOLCHAIN)readelf
+AR   = $(TOOLCHAIN)ar
+SIZE = $(TOOLCHAIN)size
+PYTHON = python
+
+SED   = sed
+MKDIR = mkdir
+CP    = cp
+RM    = rm
+
+DEFINES += -Dgcc
+DEFINES += -DAM_PART_APOLLO3
+DEFINES += -DAM_PACKAGE_BGA
+DEFINES += -DPART_apollo3
+
+DEFINES_DBG += -DAM_ASSERT_INVALID_THRESHOLD=0
+DEFINES_DBG += -DAM_DEBUG_ASSERT
+DEFINES_DBG += -DAM_DEBUG_PRINTF
+
+CFLAGS  = -ffunction-sections -fdata-sections
+CFLAGS += -MMD -MP -std=c99 -Wall -pthread
+CFLAGS += $(DEFINES)
+
+CFLAGS_DBG += $(CFLAGS)
+CFLAGS_DBG += $(DEFINES_DBG)
+CFLAGS_DBG += -g -O0
+
+CFLAGS_REL += $(CFLAGS)
+CFLAGS_REL += -O2
+
+LFLAGS  = -pthread -Wl,--gc-sections
+
+BUILDDIR_DBG := ./build/debug
+SUFFIX_DBG   := -dbg
+BUILDDIR_REL := ./build/release
+SUFFIX_REL   := -rel
@@ -0,0 +1,3 @@
+HAL := $(SDK_ROOT)/hal/ambiq
+HAL_LIB_DBG  := libhal$(SUFFIX_DBG).a
+HAL_LIB_REL  := libhal$(SUFFIX_REL).a
\ No newline at end of file
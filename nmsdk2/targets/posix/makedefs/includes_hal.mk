@@ -0,0 +1,10 @@
+HAL_INC += -I$(HAL)/../../targets/posix/hal/cmsis
+HAL_INC += -I$(HAL)/CMSIS/AmbiqMicro/Include
+HAL_INC += -I$(HAL)/CMSIS/ARM/Include
+HAL_INC += -I$(HAL)/mcu/apollo3
+HAL_INC += -I$(HAL)/mcu/apollo3/hal
+HAL_INC += -I$(HAL)/mcu/apollo3/regs
+HAL_INC += -I$(HAL)/utils
+HAL_INC += -I$(HAL)/../../targets/posix/hal
+HAL_INC += -I$(HAL)/../../targets/nm180100/utils
+
@@ -0,0 +1,6 @@
+RTOS_DEFINES += -DAM_FREERTOS
+
+RTOS_INC += -I$(RTOS)/kernel/include
+RTOS_INC += -I$(RTOS)/cli
+RTOS_INC += -I$(RTOS)/../../targets/posix/rtos/FreeRTOS/portable
+RTOS_INC += -I$(dir $(FREERTOS_CONFIG))
@@ -0,0 +1,267 @@
+VPATH += $(BLE)/ble-profiles/sources/apps/app
+VPATH += $(BLE)/ble-profiles/sources/apps/app/common
+
+BLE_SRC += app_disc.c
+BLE_SRC += app_main.c
+BLE_SRC += app_master.c
+BLE_SRC += app_master_ae.c
+BLE_SRC += app_master_leg.c
+BLE_SRC += app_server.c
+BLE_SRC += app_slave.c
+BLE_SRC += app_slave_ae.c
+BLE_SRC += app_slave_leg.c
+BLE_SRC += app_terminal.c
+BLE_SRC += app_db.c
+BLE_SRC += app_hw.c
+BLE_SRC += app_ui.c
+BLE_SRC += ui_console.c
+BLE_SRC += ui_lcd.c
+BLE_SRC += ui_main.c
+BLE_SRC += ui_platform.c
+BLE_SRC += ui_timer.c
+ 
+
+VPATH += $(BLE)/ble-profiles/sources/profiles/anpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/atpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/atps
+VPATH += $(BLE)/ble-profiles/sources/profiles/bas
+VPATH += $(BLE)/ble-profiles/sources/profiles/blpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/blps
+VPATH += $(BLE)/ble-profiles/sources/profiles/cpm
+VPATH += $(BLE)/ble-profiles/sources/profiles/cpp
+VPATH += $(BLE)/ble-profiles/sources/profiles/cscp
+VPATH += $(BLE)/ble-profiles/sources/profiles/dis
+VPATH += $(BLE)/ble-profiles/sources/profiles/fmpl
+VPATH += $(BLE)/ble-profiles/sources/profiles/gap
+VPATH += $(BLE)/ble-profiles/sources/profiles/gatt
+VPATH += $(BLE)/ble-profiles/sources/profiles/glpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/glps
+VPATH += $(BLE)/ble-profiles/sources/profiles/hid
+VPATH += $(BLE)/ble-profiles/sources/profiles/hrpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/hrps
+VPATH += $(BLE)/ble-profiles/sources/profiles/htpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/htps
+VPATH += $(BLE)/ble-profiles/sources/profiles/paspc
+VPATH += $(BLE)/ble-profiles/sources/profiles/plxpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/plxps
+VPATH += $(BLE)/ble-profiles/sources/profiles/rscp
+VPATH += $(BLE)/ble-profiles/sources/profiles/scpps
+VPATH += $(BLE)/ble-profiles/sources/profiles/sensor
+VPATH += $(BLE)/ble-profiles/sources/profiles/tipc
+VPATH += $(BLE)/ble-profiles/sources/profiles/udsc
+VPATH += $(BLE)/ble-profiles/sources/profiles/uribeacon
+VPATH += $(BLE)/ble-profiles/sources/profiles/wdxc
+VPATH += $(BLE)/ble-profiles/sources/profiles/wdxs
+VPATH += $(BLE)/ble-profiles/sources/profiles/wpc
+VPATH += $(BLE)/ble-profiles/sources/profiles/wspc
+VPATH += $(BLE)/ble-profiles/sources/profiles/wsps
+
+BLE_SRC += anpc_main.c
+BLE_SRC += atpc_main.c
+BLE_SRC += atps_main.c
+BLE_SRC += bas_main.c
+BLE_SRC += blpc_main.c
+BLE_SRC += blps_main.c
+BLE_SRC += cpm_main.c
+BLE_SRC += cpps_main.c
+BLE_SRC += cscps_main.c
+BLE_SRC += dis_main.c
+BLE_SRC += fmpl_main.c
+BLE_SRC += gap_main.c
+BLE_SRC += gatt_main.c
+BLE_SRC += glpc_main.c
+BLE_SRC += glps_db.c
+BLE_SRC += glps_main.c
+BLE_SRC += hid_main.c
+BLE_SRC += hrpc_main.c
+BLE_SRC += hrps_main.c
+BLE_SRC += htpc_main.c
+BLE_SRC += htps_main.c
+BLE_SRC += paspc_main.c
+BLE_SRC += plxpc_main.c
+BLE_SRC += plxps_db.c
+BLE_SRC += plxps_main.c
+BLE_SRC += rscps_main.c
+BLE_SRC += scpps_main.c
+BLE_SRC += gyro_main.c
+BLE_SRC += temp_main.c
+BLE_SRC += tipc_main.c
+BLE_SRC += udsc_main.c
+BLE_SRC += uricfg_main.c
+BLE_SRC += wdxc_ft.c
+BLE_SRC += wdxc_main.c
+BLE_SRC += wdxc_stream.c
+BLE_SRC += wdxs_au.c
+BLE_SRC += wdxs_dc.c
+BLE_SRC += wdxs_ft.c
+BLE_SRC += wdxs_main.c
+BLE_SRC += wdxs_phy.c
+BLE_SRC += wdxs_stream.c
+BLE_SRC += wpc_main.c
+BLE_SRC += wspc_main.c
+BLE_SRC += wsps_main.c
+
+
+VPATH += $(BLE)/ble-profiles/sources/services
+
+BLE_SRC += svc_alert.c
+BLE_SRC += svc_batt.c
+BLE_SRC += svc_bps.c
+BLE_SRC += svc_core.c
+BLE_SRC += svc_cps.c
+BLE_SRC += svc_cscs.c
+BLE_SRC += svc_cte.c
+BLE_SRC += svc_dis.c
+BLE_SRC += svc_gls.c
+BLE_SRC += svc_gyro.c
+BLE_SRC += svc_hid.c
+BLE_SRC += svc_hrs.c
+BLE_SRC += svc_hts.c
+BLE_SRC += svc_ipss.c
+BLE_SRC += svc_plxs.c
+BLE_SRC += svc_px.c
+BLE_SRC += svc_rscs.c
+BLE_SRC += svc_scpss.c
+BLE_SRC += svc_temp.c
+BLE_SRC += svc_time.c
+BLE_SRC += svc_uricfg.c
+BLE_SRC += svc_wdxs.c
+BLE_SRC += svc_wp.c
+BLE_SRC += svc_wss.c
+
+
+VPATH += $(BLE)/ble-host/sources/stack/att
+VPATH += $(BLE)/ble-host/sources/stack/cfg
+VPATH += $(BLE)/ble-host/sources/stack/dm
+VPATH += $(BLE)/ble-host/sources/stack/hci
+VPATH += $(BLE)/ble-host/sources/stack/l2c
+VPATH += $(BLE)/ble-host/sources/stack/smp
+VPATH += $(BLE)/ble-host/sources/sec/common
+
+BLE_SRC += att_main.c
+BLE_SRC += att_uuid.c
+BLE_SRC += attc_disc.c
+BLE_SRC += attc_main.c
+BLE_SRC += attc_proc.c
+BLE_SRC += attc_read.c
+BLE_SRC += attc_sign.c
+BLE_SRC += attc_write.c
+BLE_SRC += atts_ccc.c
+BLE_SRC += atts_coal.c
+BLE_SRC += atts_csf.c
+BLE_SRC += atts_dyn.c
+BLE_SRC += atts_idx.c
+BLE_SRC += atts_ind.c
+BLE_SRC += atts_main.c
+BLE_SRC += atts_proc.c
+BLE_SRC += atts_read.c
+BLE_SRC += atts_sign.c
+BLE_SRC += atts_write.c
+BLE_SRC += cfg_stack.c
+BLE_SRC += dm_adv.c
+BLE_SRC += dm_adv_ae.c
+BLE_SRC += dm_adv_leg.c
+BLE_SRC += dm_conn.c
+BLE_SRC += dm_conn_cte.c
+BLE_SRC += dm_conn_master.c
+BLE_SRC += dm_conn_master_ae.c
+BLE_SRC += dm_conn_master_leg.c
+BLE_SRC += dm_conn_slave.c
+BLE_SRC += dm_conn_slave_ae.c
+BLE_SRC += dm_conn_slave_leg.c
+BLE_SRC += dm_conn_sm.c
+BLE_SRC += dm_dev.c
+BLE_SRC += dm_dev_priv.c
+BLE_SRC += dm_main.c
+BLE_SRC += dm_past.c
+BLE_SRC += dm_phy.c
+BLE_SRC += dm_priv.c
+BLE_SRC += dm_scan.c
+BLE_SRC += dm_scan_ae.c
+BLE_SRC += dm_scan_leg.c
+BLE_SRC += dm_sec.c
+BLE_SRC += dm_sec_lesc.c
+BLE_SRC += dm_sec_master.c
+BLE_SRC += dm_sec_slave.c
+BLE_SRC += dm_sync_ae.c
+BLE_SRC += hci_main.c
+BLE_SRC += l2c_coc.c
+BLE_SRC += l2c_main.c
+BLE_SRC += l2c_master.c
+BLE_SRC += l2c_slave.c
+BLE_SRC += smp_act.c
+BLE_SRC += smp_db.c
+BLE_SRC += smp_main.c
+BLE_SRC += smp_non.c
+BLE_SRC += smp_sc_act.c
+BLE_SRC += smp_sc_main.c
+BLE_SRC += smpi_act.c
+BLE_SRC += smpi_sc_act.c
+BLE_SRC += smpi_sc_sm.c
+BLE_SRC += smpi_sm.c
+BLE_SRC += smpr_act.c
+BLE_SRC += smpr_sc_act.c
+BLE_SRC += smpr_sc_sm.c
+BLE_SRC += smpr_sm.c
+BLE_SRC += sec_aes.c
+BLE_SRC += sec_aes_rev.c
+BLE_SRC += sec_ccm_hci.c
+BLE_SRC += sec_cmac_hci.c
+BLE_SRC += sec_ecc_debug.c
+BLE_SRC += sec_ecc_hci.c
+BLE_SRC += sec_main.c
+
+
+VPATH += ../nm180100/comms/ble/ble-host/sources/hci/nm180100
+VPATH += ../nm180100/comms/ble/ble-host/sources/hci/nm180100/apollo3
+VPATH += ./comms/ble/ble-host/sources/hci/posix
+VPATH += ../linux/comms/ble/ble-host/sources/hci/linux
+
+BLE_SRC += hci_core.c
+BLE_SRC += hci_tr.c
+BLE_SRC += hci_cmd.c
+BLE_SRC += hci_cmd_ae.c
+BLE_SRC += hci_cmd_cte.c
+BLE_SRC += hci_cmd_past.c
+BLE_SRC += hci_cmd_phy.c
+BLE_SRC += hci_core_ps.c
+BLE_SRC += hci_evt.c
+BLE_SRC += hci_vs_apollo3.c
+BLE_SRC += hci_vs_ae.c
+BLE_SRC += hci_drv_posix.c
+BLE_SRC += hci_drv_linux.c
+BLE_SRC += sim_local.c
+
+
+VPATH += $(BLE)/wsf/sources/util
+
+BLE_SRC += bda.c
+BLE_SRC += bstream.c
+BLE_SRC += calc128.c
+BLE_SRC += crc32.c
+BLE_SRC += fcs.c
+BLE_SRC += prand.c
+BLE_SRC += print.c
+BLE_SRC += terminal.c
+BLE_SRC += wstr.c
+
+VPATH += ./comms/ble/wsf/sources/port/posix
+VPATH += ../nm180100/comms/ble/wsf/sources/port/nm180100
+
+BLE_SRC += wsf_assert.c
+BLE_SRC += wsf_buf.c
+#BLE_SRC += wsf_bufio.c
+BLE_SRC += wsf_cs.c
+BLE_SRC += wsf_detoken.c
+BLE_SRC += wsf_efs.c
+BLE_SRC += wsf_heap.c
+BLE_SRC += wsf_msg.c
+BLE_SRC += wsf_nvm.c
+BLE_SRC += wsf_os.c
+BLE_SRC += wsf_queue.c
+BLE_SRC += wsf_timer.c
+BLE_SRC += wsf_trace.c
+
+VPATH += $(BLE)/thirdparty/uecc
+
+BLE_SRC += uECC.c
\ No newline at end of file
@@ -0,0 +1,27 @@
+# The host HAL comes first so that it replaces the SDK HAL module of the
+# same name.
+VPATH += ./hal
+VPATH += $(HAL)/mcu/apollo3/hal
+VPATH += $(HAL)/utils
+
+HAL_SRC += am_hal_posix.c
+HAL_SRC += am_hal_ctimer.c
+HAL_SRC += am_hal_flash.c
+HAL_SRC += am_hal_gpio.c
+HAL_SRC += am_hal_interrupt.c
+HAL_SRC += am_hal_iom.c
+HAL_SRC += am_hal_queue.c
+HAL_SRC += am_hal_stimer.c
+HAL_SRC += am_hal_system.c
+HAL_SRC += am_hal_uart.c
+
+HAL_SRC += am_util_debug.c
+HAL_SRC += am_util_delay.c
+HAL_SRC += am_util_id.c
+HAL_SRC += am_util_stdio.c
+HAL_SRC += am_util_string.c
+HAL_SRC += am_util_time.c
+
+VPATH += ../nm180100/utils
+HAL_SRC += eeprom_emulation.c
+HAL_SRC += stimer_mux.c
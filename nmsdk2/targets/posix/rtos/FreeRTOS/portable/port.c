@@ -0,0 +1,547 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the host build.
+ *
+ * Every task runs on its own host thread and only the thread that owns the
+ * emulated core makes progress; the others are parked on a condition
+ * variable.  PendSV picks the next task with vTaskSwitchContext(), hands the
+ * core to its thread and parks the current one, so a task is only ever
+ * switched out from an exception, as on the part.  The tick comes from the
+ * STIMER model exactly as in the nm180100 port.
+ *----------------------------------------------------------*/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* hardware includes */
+#include "am_mcu_apollo.h"
+#include "am_hal_posix.h"
+#include "stimer_mux.h"
+
+#if configGENERATE_RUN_TIME_STATS == 1
+volatile uint32_t ulPortContextSwitchCount = 0;
+volatile uint32_t ulPortSleepTime = 0;
+#endif
+
+#if configOVERRIDE_DEFAULT_TICK_CONFIGURATION != 1 || configUSE_TICKLESS_IDLE != 2 || !defined(AM_FREERTOS_USE_STIMER_FOR_TICK)
+#error "The host port supports only the STIMER tick with configUSE_TICKLESS_IDLE = 2"
+#endif
+
+#ifndef configSTIMER_CLOCK_HZ
+// Default
+#define configSTIMER_CLOCK_HZ   32768
+#define configSTIMER_CLOCK      AM_HAL_STIMER_XTAL_32KHZ
+#endif
+
+/* The Stimer is a 32-bit counter. */
+#define portMAX_32_BIT_NUMBER		( 0xffffffffUL )
+
+/* PendSV runs at the lowest priority. */
+#define portPENDSV_PRIORITY			( NVIC_configKERNEL_INTERRUPT_PRIORITY )
+
+// Keeps the snapshot of the STimer corresponding to last tick update
+static uint32_t g_lastSTimerVal = 0;
+
+/*
+ * Host thread of a task.  A pointer to it is the only thing kept on the task
+ * stack.
+ */
+typedef struct
+{
+	pthread_t xThread;
+	pthread_cond_t xCond;
+	BaseType_t xRun;
+	BaseType_t xExit;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+} Thread_t;
+
+/*
+ * Serializes the hand-over between task threads.
+ */
+static pthread_mutex_t xThreadMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * The kernel keeps the top of stack as the first member of the TCB.
+ */
+extern void * volatile pxCurrentTCB;
+
+/*
+ * Setup the timer to generate the tick interrupts.
+ */
+void vPortSetupTimerInterrupt( void );
+
+/*
+ * Exception handlers.
+ */
+void xPortPendSVHandler( void );
+
+/*
+ * Used to catch tasks that attempt to return from their implementing function.
+ */
+static void prvTaskExitError( void );
+
+/*-----------------------------------------------------------*/
+
+/* Each task maintains its own interrupt status in the critical nesting
+variable. */
+static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
+
+/*-----------------------------------------------------------*/
+
+static Thread_t *prvGetThread( void *pxTCB )
+{
+	StackType_t *pxTopOfStack = *( StackType_t ** ) pxTCB;
+	Thread_t *pxThread;
+
+	memcpy( &pxThread, pxTopOfStack, sizeof( pxThread ) );
+
+	return pxThread;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Park the calling thread until it is given the core again.  Called with
+ * xThreadMutex held.  A deleted task's thread ends here.
+ */
+static void prvThreadWait( Thread_t *pxThread )
+{
+	while( pxThread->xRun == pdFALSE )
+	{
+		pthread_cond_wait( &pxThread->xCond, &xThreadMutex );
+	}
+
+	if( pxThread->xExit != pdFALSE )
+	{
+		pthread_mutex_unlock( &xThreadMutex );
+		pthread_cond_destroy( &pxThread->xCond );
+		free( pxThread );
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvThreadEntry( void *pvParameters )
+{
+	Thread_t *pxThread = pvParameters;
+
+	pthread_mutex_lock( &xThreadMutex );
+	prvThreadWait( pxThread );
+	pthread_mutex_unlock( &xThreadMutex );
+
+	/* Tasks start with interrupts enabled. */
+	__enable_irq();
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	prvTaskExitError();
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	Thread_t *pxThread = malloc( sizeof( Thread_t ) );
+
+	configASSERT( pxThread != NULL );
+
+	pxThread->xRun = pdFALSE;
+	pxThread->xExit = pdFALSE;
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pthread_cond_init( &pxThread->xCond, NULL );
+
+	configASSERT( am_hal_posix_thread_create( &pxThread->xThread, prvThreadEntry, pxThread ) == 0 );
+	pthread_detach( pxThread->xThread );
+
+	/* Keep the pointer 8 byte aligned, as the kernel aligned the top. */
+	pxTopOfStack -= 2;
+	memcpy( pxTopOfStack, &pxThread, sizeof( pxThread ) );
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+	Thread_t *pxThread = prvGetThread( pxTCB );
+
+	/* The thread is parked, either before its task started or in PendSV. */
+	pthread_mutex_lock( &xThreadMutex );
+	pxThread->xExit = pdTRUE;
+	pxThread->xRun = pdTRUE;
+	pthread_cond_signal( &pxThread->xCond );
+	pthread_mutex_unlock( &xThreadMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskExitError( void )
+{
+volatile uint32_t ulDummy = 0;
+
+	/* A function that implements a task must not exit or attempt to return to
+	its caller as there is nothing to return to.  If a task wants to exit it
+	should instead call vTaskDelete( NULL ).
+
+	Artificially force an assert() to be triggered if configASSERT() is
+	defined, then stop here so application writers can catch the error. */
+	configASSERT( uxCriticalNesting == ~0UL );
+	portDISABLE_INTERRUPTS();
+	while( ulDummy == 0 )
+	{
+		__WFI();
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+BaseType_t xPortStartScheduler( void )
+{
+	Thread_t *pxThread;
+
+	/* Make PendSV the same priority as the kernel. */
+	NVIC_SetPriority( PendSV_IRQn, portPENDSV_PRIORITY );
+
+	/* Start the timer that generates the tick ISR.  Interrupts are disabled
+	here already. */
+	vPortSetupTimerInterrupt();
+
+	/* Initialise the critical nesting count ready for the first task. */
+	uxCriticalNesting = 0;
+
+	/* Hand the core to the first task and park the thread that ran main(). */
+	pxThread = prvGetThread( pxCurrentTCB );
+
+	__disable_irq();
+	am_hal_posix_cpu_set( pxThread->xThread );
+
+	pthread_mutex_lock( &xThreadMutex );
+	pxThread->xRun = pdTRUE;
+	pthread_cond_signal( &pxThread->xCond );
+	pthread_mutex_unlock( &xThreadMutex );
+
+	for( ;; )
+	{
+		pause();
+	}
+
+	/* Should not get here! */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	/* Not implemented in ports where there is nothing to return to.
+	Artificially force an assert. */
+	configASSERT( uxCriticalNesting == 1000UL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	/* Set a PendSV to request a context switch. */
+	NVIC_SetPendingIRQ( PendSV_IRQn );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	portDISABLE_INTERRUPTS();
+	uxCriticalNesting++;
+
+	/* This is not the interrupt safe version of the enter critical function so
+	assert() if it is being called from an interrupt context.  Only API
+	functions that end in "FromISR" can be used in an interrupt.  Only assert if
+	the critical nesting count is 1 to protect against recursive calls if the
+	assert function also uses a critical section. */
+	if( uxCriticalNesting == 1 )
+	{
+		configASSERT( xPortIsInsideInterrupt() == pdFALSE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	configASSERT( uxCriticalNesting );
+	uxCriticalNesting--;
+	if( uxCriticalNesting == 0 )
+	{
+		portENABLE_INTERRUPTS();
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortSetInterruptMask( void )
+{
+	uint32_t ulOriginalMask = __get_PRIMASK();
+
+	__disable_irq();
+
+	return ulOriginalMask;
+}
+/*-----------------------------------------------------------*/
+
+void xPortPendSVHandler( void )
+{
+	Thread_t *pxOld = prvGetThread( pxCurrentTCB );
+	Thread_t *pxNew;
+
+	vTaskSwitchContext();
+
+	pxNew = prvGetThread( pxCurrentTCB );
+	if( pxNew == pxOld )
+	{
+		return;
+	}
+
+	am_hal_posix_cpu_set( pxNew->xThread );
+
+	pthread_mutex_lock( &xThreadMutex );
+	pxNew->xRun = pdTRUE;
+	pthread_cond_signal( &pxNew->xCond );
+	pxOld->xRun = pdFALSE;
+	prvThreadWait( pxOld );
+	pthread_mutex_unlock( &xThreadMutex );
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char *pcFile, int iLine )
+{
+	__disable_irq();
+	fprintf( stderr, "ASSERT %s:%d\n", pcFile, iLine );
+	__BKPT( 0 );
+}
+/*-----------------------------------------------------------*/
+
+/*-----------------------------------------------------------
+ * STIMER tick and tickless idle, as in the nm180100 port.
+ *----------------------------------------------------------*/
+
+uint32_t ulTimerCountsForOneTick = 0;
+/*
+ * The maximum number of tick periods that can be suppressed is limited by the
+ * resolution of the Tick timer.
+ */
+static uint32_t xMaximumPossibleSuppressedTicks = 0;
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+	uint32_t ulReloadValue;
+    uint32_t New_Timer, Delta_Sleep;
+	TickType_t xModifiableIdleTime;
+    uint32_t elapsed_time;
+
+	/* Make sure the SysTick reload value does not overflow the counter. */
+	if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+	{
+		xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+	}
+
+	/* Calculate the reload value required to wait xExpectedIdleTime
+	tick periods.  -1 is used because this code will execute part way
+	through one of the tick periods. */
+	ulReloadValue =  ulTimerCountsForOneTick * ( xExpectedIdleTime - 1 );
+
+	/* Enter a critical section but don't use the taskENTER_CRITICAL()
+	method as that will mask interrupts that should exit sleep mode. */
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+    // Adjust for the time already elapsed
+    uint32_t curTime = am_hal_stimer_counter_get();
+    elapsed_time = curTime - g_lastSTimerVal;
+
+    // The core wakes at the earliest deadline of any STIMER client, so that
+    // deadline rather than the next task unblock bounds the time spent asleep.
+    uint32_t ulSleepValue = ulReloadValue;
+    uint32_t ulNextDeadline;
+    if (stimer_mux_next(STIMER_MUX_RTOS, &ulNextDeadline))
+    {
+        int32_t lNext = (int32_t)(ulNextDeadline - g_lastSTimerVal);
+        if (lNext < (int32_t)ulSleepValue)
+        {
+            ulSleepValue = (lNext > 0) ? lNext : 0;
+        }
+    }
+
+	/* If a context switch is pending or a task is waiting for the scheduler
+	to be unsuspended then abandon the low power entry. */
+    /* Abandon low power entry if the sleep time is too short */
+	if( (eTaskConfirmSleepModeStatus() == eAbortSleep) || ((elapsed_time + ulTimerCountsForOneTick) > ulReloadValue) )
+	{
+		/* Re-enable interrupts - see comments above __disable_irq() above. */
+		__enable_irq();
+	}
+	else
+	{
+        // Move the tick deadline out to the next task unblock
+        stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulReloadValue);
+
+		/* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
+		set its parameter to 0 to indicate that its implementation contains
+		its own wait for interrupt or wait for event instruction, and so wfi
+		should not be executed again.  However, the original expected idle
+		time variable must remain unmodified, so a copy is taken.  The copy
+		holds the ticks until the next wakeup of any timer. */
+		xModifiableIdleTime = ulSleepValue / ulTimerCountsForOneTick;
+
+		configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+		if( xModifiableIdleTime > 0 )
+		{
+			__DSB();
+			__WFI();
+			__ISB();
+		}
+
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+        // Before renable interrupts, check how many ticks the processor has been in SLEEP
+        // Adjust xTickCount via vTaskStepTick( Delta_Sleep )
+        // to keep xTickCount up to date, as if ticks have been running all along
+        New_Timer = am_hal_stimer_counter_get();
+#if configGENERATE_RUN_TIME_STATS == 1
+        ulPortSleepTime += New_Timer - curTime;
+#endif
+        Delta_Sleep = (signed long) New_Timer - (signed long) g_lastSTimerVal;
+        Delta_Sleep /= ulTimerCountsForOneTick;
+
+        // The host may run this thread well after the compare fired.  Step no
+        // further than the next unblock time and leave the remaining ticks to
+        // the tick handler.
+        if (Delta_Sleep > xExpectedIdleTime)
+        {
+            Delta_Sleep = xExpectedIdleTime;
+        }
+        g_lastSTimerVal += Delta_Sleep * ulTimerCountsForOneTick;
+
+        // Correct System Tick after Sleep
+        vTaskStepTick( Delta_Sleep );
+
+		/* Restart System Tick */
+        stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
+
+		/* Re-enable interrupts - see comments above __disable_irq() above. */
+		__enable_irq();
+	}
+}
+
+//*****************************************************************************
+//
+// Events associated with STimer CMP0 Interrupt
+//
+// This is the FreeRTOS System Timer, the STIMER_MUX_RTOS client of the
+// STIMER compare multiplexer.  See the nm180100 port.
+//
+//*****************************************************************************
+static void
+xPortStimerTickHandler(void)
+{
+    uint32_t remainder = 0;
+    uint32_t curSTimer;
+    uint32_t timerCounts;
+    uint32_t numTicksElapsed;
+    BaseType_t ctxtSwitchReqd = pdFALSE;
+
+    curSTimer = am_hal_stimer_counter_get();
+
+    timerCounts = curSTimer - g_lastSTimerVal;
+    numTicksElapsed = timerCounts/ulTimerCountsForOneTick;
+    remainder = timerCounts % ulTimerCountsForOneTick;
+    g_lastSTimerVal = curSTimer - remainder;
+
+    //
+    // Set the deadline of the next tick
+    //
+    stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
+
+    (void) portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        //
+        // Increment RTOS tick
+        // Allowing for need to increment the tick more than one... to avoid accumulation of
+        // error in case of interrupt latencies
+        //
+        while (numTicksElapsed--)
+        {
+            ctxtSwitchReqd = (( xTaskIncrementTick() != pdFALSE ) ? pdTRUE : ctxtSwitchReqd);
+        }
+        if ( ctxtSwitchReqd != pdFALSE )
+        {
+            //
+            // A context switch is required.  Context switching is
+            // performed in the PendSV interrupt. Pend the PendSV
+            // interrupt.
+            //
+            NVIC_SetPendingIRQ(PendSV_IRQn);
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(0);
+}
+
+void vPortSetupTimerInterrupt( void )
+{
+    /* Calculate the constants required to configure the tick interrupt. */
+    ulTimerCountsForOneTick = (configSTIMER_CLOCK_HZ /configTICK_RATE_HZ);
+    xMaximumPossibleSuppressedTicks = STIMER_MUX_MAX_DELTA / ulTimerCountsForOneTick - 1;
+
+    //
+    // The compare interrupts are shared with the other STIMER clients, so
+    // they run at the kernel priority.
+    //
+    NVIC_SetPriority(STIMER_CMPR0_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
+    NVIC_SetPriority(STIMER_CMPR1_IRQn, NVIC_configKERNEL_INTERRUPT_PRIORITY);
+
+    //
+    // Configure the STIMER and schedule the first tick
+    //
+    stimer_mux_init(configSTIMER_CLOCK);
+    stimer_mux_register(STIMER_MUX_RTOS, xPortStimerTickHandler, 0);
+    g_lastSTimerVal = am_hal_stimer_counter_get();
+    stimer_mux_start(STIMER_MUX_RTOS, g_lastSTimerVal + ulTimerCountsForOneTick);
+}
@@ -0,0 +1,446 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "heap_model.h"
+
+//*****************************************************************************
+//
+// Replays the same allocation traces against heap_4 and heap_tlsf at the heap
+// size of the nm180100 target.  A trace is a list of allocations and frees of
+// numbered slots, generated up front, so an allocation that fails on one heap
+// leaves the trace of the other unchanged.
+//
+//   bench   the trace of "top heap bench": 32 slots, mostly 8 to 127 bytes,
+//           one in eight up to 511 bytes.
+//   stacks  task stacks, control blocks and queues allocated at start up
+//           and kept, then list items, messages and the odd large buffer
+//           coming and going, as in the running application.
+//   churn   128 slots of 8 to 2047 bytes, evenly spread over the powers of
+//           two, to drive both heaps into fragmentation.
+//
+// Every block is filled and checked before it is freed, must be aligned and
+// must not overlap another.  After each replay everything is freed and the
+// heap must be back to one free block of its initial size.
+//
+// Each trace is replayed HEAP_TEST_REPLAYS times and every call keeps its
+// fastest time, which takes out most of the host noise.  The times include
+// reading the host clock and show the shape more than the cycles on target.
+//
+//*****************************************************************************
+#define HEAP_TEST_REPLAYS    5
+#define HEAP_TEST_SLOTS      128
+#define HEAP_TEST_OPERATIONS 200000
+#define HEAP_TEST_NO_CALL    UINT32_MAX
+
+typedef struct
+{
+    uint16_t ui16Slot;
+    uint16_t ui16Size;
+} heap_test_op_t;
+
+typedef struct
+{
+    const char *pcName;
+    uint32_t (*pfnGenerate)(heap_test_op_t *psOps);
+} heap_test_trace_t;
+
+typedef struct
+{
+    uint32_t ui32Allocations;
+    uint32_t ui32Failed;
+    uint32_t ui32MinFree;
+    uint64_t ui64Fragmentation;
+    uint64_t ui64MallocNs;
+    uint64_t ui64FreeNs;
+    uint32_t ui32MallocMaxNs;
+    uint32_t ui32FreeMaxNs;
+    uint32_t ui32Frees;
+} heap_test_result_t;
+
+static heap_test_op_t heap_test_ops[HEAP_TEST_OPERATIONS];
+static uint32_t heap_test_ns[HEAP_TEST_OPERATIONS];
+static bool heap_test_live[HEAP_TEST_SLOTS];
+static uint32_t heap_test_random;
+static bool heap_test_failed;
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void vApplicationMallocFailedHook(void)
+{
+}
+
+void vAssertCalled(const char *pcFileName, int iLine)
+{
+    printf("heap: assertion failed at %s:%d\n", pcFileName, iLine);
+    abort();
+}
+
+static uint32_t heap_test_rand(void)
+{
+    heap_test_random = heap_test_random * 1664525 + 1013904223;
+
+    return heap_test_random;
+}
+
+//
+// Frees the slot if the trace has it allocated, allocates it otherwise.
+//
+static uint32_t heap_test_toggle(heap_test_op_t *psOp, uint32_t ui32Slot, uint32_t ui32Size)
+{
+    psOp->ui16Slot = ui32Slot;
+    psOp->ui16Size = heap_test_live[ui32Slot] ? 0 : ui32Size;
+    heap_test_live[ui32Slot] = !heap_test_live[ui32Slot];
+
+    return 1;
+}
+
+static uint32_t heap_test_bench(heap_test_op_t *psOps)
+{
+    uint32_t n = 0;
+
+    heap_test_random = 0x2545F491;
+    for (uint32_t i = 0; i < 1024; i++)
+    {
+        uint32_t ui32Seed = heap_test_rand();
+        uint32_t ui32Slot = (ui32Seed >> 8) % 32;
+        uint32_t ui32Size = 8 + ((ui32Seed >> 16) % ((ui32Seed & 0x7) ? 120 : 504));
+
+        n += heap_test_toggle(&psOps[n], ui32Slot, ui32Size);
+    }
+
+    return n;
+}
+
+static uint32_t heap_test_stacks(heap_test_op_t *psOps)
+{
+    static const uint16_t pui16Startup[] = {
+        4096, 96, 2048, 96, 2048, 96, 1536, 96, 1024, 96, 1024, 96, 768, 96, 512, 96,
+        208,  1104, 1104, 336, 592, 48,  48,  48,  48,
+    };
+    uint32_t ui32Startup = sizeof(pui16Startup) / sizeof(pui16Startup[0]);
+    uint32_t n = 0;
+
+    heap_test_random = 0x6C078965;
+    for (uint32_t i = 0; i < ui32Startup; i++)
+    {
+        n += heap_test_toggle(&psOps[n], i, pui16Startup[i]);
+    }
+
+    while (n < HEAP_TEST_OPERATIONS)
+    {
+        uint32_t ui32Seed = heap_test_rand();
+        uint32_t ui32Class = (ui32Seed >> 24) % 100;
+        uint32_t ui32Slot, ui32Size;
+
+        if (ui32Class < 70)
+        {
+            // list items and small control blocks
+            ui32Slot = 32 + (ui32Seed >> 8) % 48;
+            ui32Size = 20 + 4 * ((ui32Seed >> 16) % 8);
+        }
+        else if (ui32Class < 96)
+        {
+            // messages and short lived queues
+            ui32Slot = 80 + (ui32Seed >> 8) % 32;
+            ui32Size = 64 + (ui32Seed >> 12) % 448;
+        }
+        else
+        {
+            // the odd large buffer
+            ui32Slot = 112 + (ui32Seed >> 8) % 8;
+            ui32Size = 1024 + (ui32Seed >> 12) % 3072;
+        }
+
+        n += heap_test_toggle(&psOps[n], ui32Slot, ui32Size);
+    }
+
+    return n;
+}
+
+static uint32_t heap_test_churn(heap_test_op_t *psOps)
+{
+    uint32_t n = 0;
+
+    heap_test_random = 0x41C64E6D;
+    while (n < HEAP_TEST_OPERATIONS)
+    {
+        uint32_t ui32Seed = heap_test_rand();
+        uint32_t ui32Order = 3 + (ui32Seed >> 28) % 8;
+        uint32_t ui32Size = (1U << ui32Order) + ((ui32Seed >> 8) & ((1U << ui32Order) - 1));
+
+        n += heap_test_toggle(&psOps[n], (ui32Seed >> 20) % HEAP_TEST_SLOTS, ui32Size);
+    }
+
+    return n;
+}
+
+static const heap_test_trace_t heap_test_traces[] = {
+    {"bench", heap_test_bench},
+    {"stacks", heap_test_stacks},
+    {"churn", heap_test_churn},
+};
+
+static uint32_t heap_test_elapsed(const struct timespec *psStart, const struct timespec *psEnd)
+{
+    return (uint32_t)((psEnd->tv_sec - psStart->tv_sec) * 1000000000L +
+                      (psEnd->tv_nsec - psStart->tv_nsec));
+}
+
+static void heap_test_fail(const heap_model_t *psModel, const char *pcTrace, uint32_t ui32Op,
+                           const char *pcWhat)
+{
+    if (!heap_test_failed)
+    {
+        printf("heap: %s %s operation %u: %s\n", psModel->pcName, pcTrace, ui32Op, pcWhat);
+    }
+    heap_test_failed = true;
+}
+
+static void heap_test_replay(const heap_model_t *psModel, const char *pcTrace, uint32_t ui32Ops,
+                             uint32_t ui32Replay, heap_test_result_t *psResult)
+{
+    uint8_t *pui8Slots[HEAP_TEST_SLOTS];
+    uint16_t pui16Size[HEAP_TEST_SLOTS];
+    HeapStats_t sStats;
+    size_t xInitial;
+    struct timespec sStart, sEnd;
+
+    memset(pui8Slots, 0, sizeof(pui8Slots));
+    memset(psResult, 0, sizeof(*psResult));
+
+    //
+    // Both heaps set themselves up on the first allocation, so make one
+    // before taking the free size the replay has to return to.
+    //
+    psModel->pfnFree(psModel->pfnMalloc(1));
+    psModel->pfnStats(&sStats);
+    xInitial = sStats.xAvailableHeapSpaceInBytes;
+    psResult->ui32MinFree = xInitial;
+
+    for (uint32_t i = 0; i < ui32Ops; i++)
+    {
+        const heap_test_op_t *psOp = &heap_test_ops[i];
+        uint8_t *pui8Block = pui8Slots[psOp->ui16Slot];
+        uint8_t ui8Fill = (uint8_t)(psOp->ui16Slot * 31 + 7);
+        uint32_t ui32Ns;
+
+        if (psOp->ui16Size == 0)
+        {
+            if (pui8Block == NULL)
+            {
+                heap_test_ns[i] = HEAP_TEST_NO_CALL;
+                continue;
+            }
+
+            for (uint32_t j = 0; j < pui16Size[psOp->ui16Slot]; j++)
+            {
+                if (pui8Block[j] != ui8Fill)
+                {
+                    heap_test_fail(psModel, pcTrace, i, "block overwritten");
+                    break;
+                }
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &sStart);
+            psModel->pfnFree(pui8Block);
+            clock_gettime(CLOCK_MONOTONIC, &sEnd);
+        }
+        else
+        {
+            clock_gettime(CLOCK_MONOTONIC, &sStart);
+            pui8Block = psModel->pfnMalloc(psOp->ui16Size);
+            clock_gettime(CLOCK_MONOTONIC, &sEnd);
+        }
+
+        ui32Ns = heap_test_elapsed(&sStart, &sEnd);
+        if ((ui32Replay == 0) || (ui32Ns < heap_test_ns[i]))
+        {
+            heap_test_ns[i] = ui32Ns;
+        }
+
+        if (psOp->ui16Size == 0)
+        {
+            pui8Slots[psOp->ui16Slot] = NULL;
+            psResult->ui32Frees++;
+        }
+        else if (pui8Block == NULL)
+        {
+            psResult->ui32Failed++;
+        }
+        else
+        {
+            if ((uintptr_t)pui8Block & portBYTE_ALIGNMENT_MASK)
+            {
+                heap_test_fail(psModel, pcTrace, i, "block not aligned");
+            }
+
+            memset(pui8Block, ui8Fill, psOp->ui16Size);
+            pui8Slots[psOp->ui16Slot] = pui8Block;
+            pui16Size[psOp->ui16Slot] = psOp->ui16Size;
+            psResult->ui32Allocations++;
+        }
+
+        psModel->pfnStats(&sStats);
+        if (sStats.xAvailableHeapSpaceInBytes < psResult->ui32MinFree)
+        {
+            psResult->ui32MinFree = sStats.xAvailableHeapSpaceInBytes;
+        }
+        if (sStats.xAvailableHeapSpaceInBytes)
+        {
+            psResult->ui64Fragmentation += 1000 - (uint64_t)sStats.xSizeOfLargestFreeBlockInBytes *
+                                                      1000 / sStats.xAvailableHeapSpaceInBytes;
+        }
+    }
+
+    for (uint32_t i = 0; i < HEAP_TEST_SLOTS; i++)
+    {
+        psModel->pfnFree(pui8Slots[i]);
+    }
+
+    psModel->pfnStats(&sStats);
+    if ((sStats.xAvailableHeapSpaceInBytes != xInitial) || (sStats.xNumberOfFreeBlocks != 1))
+    {
+        heap_test_fail(psModel, pcTrace, ui32Ops, "heap not whole after freeing every block");
+    }
+}
+
+static void heap_test_run(const heap_model_t *psModel, const heap_test_trace_t *psTrace,
+                          uint32_t ui32Ops)
+{
+    heap_test_result_t sResult, sFirst;
+
+    for (uint32_t r = 0; r < HEAP_TEST_REPLAYS; r++)
+    {
+        heap_test_replay(psModel, psTrace->pcName, ui32Ops, r, &sResult);
+
+        if (r == 0)
+        {
+            sFirst = sResult;
+        }
+        else if ((sResult.ui32Failed != sFirst.ui32Failed) ||
+                 (sResult.ui32MinFree != sFirst.ui32MinFree))
+        {
+            heap_test_fail(psModel, psTrace->pcName, ui32Ops, "replays differ");
+        }
+    }
+
+    for (uint32_t i = 0; i < ui32Ops; i++)
+    {
+        if (heap_test_ns[i] == HEAP_TEST_NO_CALL)
+        {
+            continue;
+        }
+
+        if (heap_test_ops[i].ui16Size)
+        {
+            sResult.ui64MallocNs += heap_test_ns[i];
+            if (heap_test_ns[i] > sResult.ui32MallocMaxNs)
+            {
+                sResult.ui32MallocMaxNs = heap_test_ns[i];
+            }
+        }
+        else
+        {
+            sResult.ui64FreeNs += heap_test_ns[i];
+            if (heap_test_ns[i] > sResult.ui32FreeMaxNs)
+            {
+                sResult.ui32FreeMaxNs = heap_test_ns[i];
+            }
+        }
+    }
+
+    printf("%-7s %-7s %7u %7u %8u %6u.%u%% %7u / %-6u %5u / %u\n",
+           psTrace->pcName,
+           psModel->pcName,
+           sResult.ui32Allocations,
+           sResult.ui32Failed,
+           sResult.ui32MinFree,
+           (uint32_t)(sResult.ui64Fragmentation / ui32Ops / 10),
+           (uint32_t)(sResult.ui64Fragmentation / ui32Ops % 10),
+           (uint32_t)(sResult.ui64MallocNs / (sResult.ui32Allocations + sResult.ui32Failed)),
+           sResult.ui32MallocMaxNs,
+           (uint32_t)(sResult.ui64FreeNs / (sResult.ui32Frees ? sResult.ui32Frees : 1)),
+           sResult.ui32FreeMaxNs);
+}
+
+int main(int argc, char **argv)
+{
+    const heap_model_t *psModels[] = {&heap_model_4, &heap_model_tlsf};
+
+    printf("trace   heap     allocs  failed min free  frag avg  malloc ns avg / max  free ns avg / max\n");
+
+    for (uint32_t i = 0; i < sizeof(heap_test_traces) / sizeof(heap_test_traces[0]); i++)
+    {
+        uint32_t ui32Ops;
+
+        memset(heap_test_live, 0, sizeof(heap_test_live));
+        ui32Ops = heap_test_traces[i].pfnGenerate(heap_test_ops);
+
+        for (uint32_t j = 0; j < sizeof(psModels) / sizeof(psModels[0]); j++)
+        {
+            heap_test_run(psModels[j], &heap_test_traces[i], ui32Ops);
+        }
+    }
+
+    if (heap_test_failed)
+    {
+        return 1;
+    }
+
+    printf("heap: every block intact and both heaps whole after each replay\n");
+
+    return 0;
+}
@@ -0,0 +1,378 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_msg.h"
+#include "wsf_nvm.h"
+#include "wsf_timer.h"
+#include "mesh_defs.h"
+#include "mesh_api.h"
+#include "mesh_types.h"
+#include "mesh_main.h"
+#include "mesh_local_config_types.h"
+#include "mesh_local_config.h"
+
+//*****************************************************************************
+//
+// A RAM NVM that holds the datasets of Local Config across a simulated reset,
+// and the commit timer, which the test expires by hand.
+//
+//*****************************************************************************
+#define LOCALCFG_TEST_DATASETS  11
+#define LOCALCFG_TEST_DATA_MAX  1024
+#define LOCALCFG_TEST_MEMORY    16384
+#define LOCALCFG_TEST_MODELS    4
+#define LOCALCFG_TEST_SUBSCR    5
+#define LOCALCFG_TEST_ELEMENTS  2
+#define LOCALCFG_TEST_ADDRESS   0x0010
+#define LOCALCFG_TEST_GROUP     0xC000
+
+typedef struct
+{
+    bool bStored;
+    uint16_t ui16Length;
+    uint8_t pui8Data[LOCALCFG_TEST_DATA_MAX];
+} localcfg_test_dataset_t;
+
+meshCb_t meshCb;
+meshConfig_t *pMeshConfig;
+
+static localcfg_test_dataset_t localcfg_test_nvm[LOCALCFG_TEST_DATASETS];
+static uint32_t localcfg_test_writes;
+static wsfTimer_t *localcfg_test_timer;
+static uint8_t localcfg_test_memory[LOCALCFG_TEST_MEMORY];
+static meshSigModel_t localcfg_test_models[LOCALCFG_TEST_MODELS];
+static meshElement_t localcfg_test_elements[LOCALCFG_TEST_ELEMENTS];
+static meshMemoryConfig_t localcfg_test_memory_config = {
+    .addrListMaxSize = 24,
+    .virtualAddrListMaxSize = 4,
+    .appKeyListSize = 2,
+    .netKeyListSize = 2,
+};
+static meshConfig_t localcfg_test_config;
+static bool localcfg_test_failed;
+
+static localcfg_test_dataset_t *localcfg_test_dataset(uint32_t ui32Id)
+{
+    if ((ui32Id < MESH_LOCAL_CFG_NVM_DATASET_ID) ||
+        (ui32Id >= MESH_LOCAL_CFG_NVM_DATASET_ID + LOCALCFG_TEST_DATASETS))
+    {
+        printf("localcfg: unexpected NVM dataset 0x%04x\n", (unsigned)ui32Id);
+        abort();
+    }
+
+    return &localcfg_test_nvm[ui32Id - MESH_LOCAL_CFG_NVM_DATASET_ID];
+}
+
+bool_t WsfNvmReadData(uint32_t id, uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+    localcfg_test_dataset_t *psDataset = localcfg_test_dataset(id);
+
+    if (!psDataset->bStored)
+    {
+        return FALSE;
+    }
+
+    memcpy(pData, psDataset->pui8Data, (len < psDataset->ui16Length) ? len : psDataset->ui16Length);
+
+    return TRUE;
+}
+
+bool_t WsfNvmWriteData(uint32_t id, const uint8_t *pData, uint16_t len, WsfNvmCompEvent_t compCback)
+{
+    localcfg_test_dataset_t *psDataset = localcfg_test_dataset(id);
+
+    if (len > LOCALCFG_TEST_DATA_MAX)
+    {
+        printf("localcfg: dataset 0x%04x of %u bytes does not fit the test NVM\n", (unsigned)id,
+               len);
+        abort();
+    }
+
+    memcpy(psDataset->pui8Data, pData, len);
+    psDataset->ui16Length = len;
+    psDataset->bStored = true;
+    localcfg_test_writes++;
+
+    return TRUE;
+}
+
+bool_t WsfNvmEraseData(uint32_t id, WsfNvmCompEvent_t compCback)
+{
+    localcfg_test_dataset(id)->bStored = false;
+
+    return TRUE;
+}
+
+void WsfTimerStartMs(wsfTimer_t *pTimer, wsfTimerTicks_t ms)
+{
+    pTimer->isStarted = TRUE;
+    localcfg_test_timer = pTimer;
+}
+
+void WsfTimerStartSec(wsfTimer_t *pTimer, wsfTimerTicks_t sec)
+{
+    pTimer->isStarted = TRUE;
+}
+
+void WsfTimerStop(wsfTimer_t *pTimer)
+{
+    pTimer->isStarted = FALSE;
+}
+
+void WsfAssert(const char *pFile, uint16_t line)
+{
+    printf("localcfg: assertion failed at %s:%u\n", pFile, line);
+    abort();
+}
+
+static void localcfg_test_event(meshEvt_t *pEvt)
+{
+}
+
+//*****************************************************************************
+//
+// Starts Local Config from what the RAM NVM holds, as after a reset.  The
+// statistics start again from zero.
+//
+//*****************************************************************************
+static void localcfg_test_start(void)
+{
+    memset(&meshCb, 0, sizeof(meshCb));
+    memset(localcfg_test_memory, 0, sizeof(localcfg_test_memory));
+
+    for (uint32_t i = 0; i < LOCALCFG_TEST_MODELS; i++)
+    {
+        localcfg_test_models[i].modelId = 0x1000 + i;
+        localcfg_test_models[i].subscrListSize = LOCALCFG_TEST_SUBSCR;
+        localcfg_test_models[i].appKeyBindListSize = 2;
+    }
+
+    //
+    // The second element has no models.  It only widens the unicast range
+    // owned by the node.
+    //
+    memset(localcfg_test_elements, 0, sizeof(localcfg_test_elements));
+    localcfg_test_elements[0].numSigModels = LOCALCFG_TEST_MODELS;
+    localcfg_test_elements[0].pSigModelArray = localcfg_test_models;
+    localcfg_test_config.pElementArray = localcfg_test_elements;
+    localcfg_test_config.elementArrayLen = LOCALCFG_TEST_ELEMENTS;
+    localcfg_test_config.pMemoryConfig = &localcfg_test_memory_config;
+
+    pMeshConfig = &localcfg_test_config;
+    meshCb.pMemBuff = localcfg_test_memory;
+    meshCb.memBuffSize = sizeof(localcfg_test_memory);
+    meshCb.evtCback = localcfg_test_event;
+
+    if (MeshLocalCfgGetRequiredMemory() > sizeof(localcfg_test_memory))
+    {
+        printf("localcfg: Local Config needs more than %u bytes\n", LOCALCFG_TEST_MEMORY);
+        abort();
+    }
+
+    localcfg_test_timer = NULL;
+    localcfg_test_writes = 0;
+    MeshLocalCfgInit();
+}
+
+static void localcfg_test_expect(bool bCondition, const char *pcStep, const char *pcWhat)
+{
+    if (!bCondition)
+    {
+        printf("localcfg: %s: %s\n", pcStep, pcWhat);
+        localcfg_test_failed = true;
+    }
+}
+
+static void localcfg_test_report(const char *pcStep)
+{
+    meshLocalCfgNvmStats_t sStats;
+
+    MeshLocalCfgGetNvmStats(&sStats);
+
+    printf("%-24s %7u  %7u  %7u  %7u B\n", pcStep, sStats.changes, sStats.commits,
+           sStats.nvmWrites, sStats.nvmBytes);
+
+    localcfg_test_expect(sStats.nvmWrites == localcfg_test_writes, pcStep,
+                         "NVM writes differ from the statistics");
+}
+
+//*****************************************************************************
+//
+// The configuration a provisioner sends to a new node in one burst.
+//
+//*****************************************************************************
+static void localcfg_test_configure(void)
+{
+    uint8_t pui8Key[MESH_KEY_SIZE_128] = {1};
+    meshModelId_t sModelId;
+
+    MeshLocalCfgSetPrimaryNodeAddress(LOCALCFG_TEST_ADDRESS);
+    MeshLocalCfgSetDevKey(pui8Key);
+    MeshLocalCfgSetNetKey(0, pui8Key);
+    MeshLocalCfgSetAppKey(0, pui8Key);
+    MeshLocalCfgBindAppKeyToNetKey(0, 0);
+
+    for (uint32_t i = 0; i < LOCALCFG_TEST_MODELS; i++)
+    {
+        sModelId.isSigModel = TRUE;
+        sModelId.modelId.sigModelId = 0x1000 + i;
+
+        MeshLocalCfgBindAppKeyToModel(0, &sModelId, 0);
+
+        for (uint32_t j = 0; j < LOCALCFG_TEST_SUBSCR; j++)
+        {
+            MeshLocalCfgAddAddressToSubscrList(0, &sModelId,
+                                               LOCALCFG_TEST_GROUP + i * LOCALCFG_TEST_SUBSCR + j);
+        }
+
+        MeshLocalCfgSetPublishAddress(0, &sModelId, LOCALCFG_TEST_GROUP + 0x100);
+        MeshLocalCfgSetPublishAppKeyIndex(0, &sModelId, 0);
+        MeshLocalCfgSetPublishTtl(0, &sModelId, 5);
+    }
+
+    MeshLocalCfgSetDefaultTtl(7);
+    MeshLocalCfgSetRelayState(MESH_RELAY_FEATURE_ENABLED);
+}
+
+int main(int argc, char **argv)
+{
+    meshLocalCfgNvmStats_t sStats;
+    meshAddress_t ui16Address;
+    uint32_t ui32Writes;
+
+    printf("step                     changes  commits   writes    bytes\n");
+
+    //
+    // A burst of configuration is held in the commit window, then a flush
+    // writes each changed dataset once.
+    //
+    localcfg_test_start();
+    localcfg_test_configure();
+    localcfg_test_report("configure");
+
+    MeshLocalCfgGetNvmStats(&sStats);
+    localcfg_test_expect(sStats.commits == 0, "configure", "committed inside the window");
+    localcfg_test_expect((localcfg_test_timer != NULL) && localcfg_test_timer->isStarted,
+                         "configure", "commit timer not started");
+
+    MeshLocalCfgNvmFlush();
+    localcfg_test_report("flush");
+
+    MeshLocalCfgGetNvmStats(&sStats);
+    localcfg_test_expect(sStats.commits == 1, "flush", "not one commit");
+    localcfg_test_expect(sStats.nvmWrites <= LOCALCFG_TEST_DATASETS, "flush",
+                         "a dataset was written more than once");
+    localcfg_test_expect(!localcfg_test_timer->isStarted, "flush", "commit timer still running");
+
+    ui32Writes = localcfg_test_writes;
+    MeshLocalCfgNvmFlush();
+    localcfg_test_report("flush again");
+    localcfg_test_expect(localcfg_test_writes == ui32Writes, "flush again",
+                         "wrote with nothing pending");
+
+    //
+    // After a reset the configuration comes back from NVM.
+    //
+    localcfg_test_start();
+    localcfg_test_report("reset");
+
+    MeshLocalCfgGetAddrFromElementId(0, &ui16Address);
+    localcfg_test_expect(ui16Address == LOCALCFG_TEST_ADDRESS, "reset", "address lost");
+    localcfg_test_expect(MeshLocalCfgGetDefaultTtl() == 7, "reset", "default TTL lost");
+    localcfg_test_expect(MeshLocalCfgIsDstAddrAccepted(LOCALCFG_TEST_GROUP + 19), "reset",
+                         "subscription lost");
+    localcfg_test_expect(!MeshLocalCfgIsDstAddrAccepted(LOCALCFG_TEST_GROUP + 20), "reset",
+                         "unsubscribed group accepted");
+    localcfg_test_expect(MeshLocalCfgIsDstAddrAccepted(LOCALCFG_TEST_ADDRESS + 1), "reset",
+                         "second element address rejected");
+    localcfg_test_expect(!MeshLocalCfgIsDstAddrAccepted(LOCALCFG_TEST_ADDRESS + 2), "reset",
+                         "foreign unicast accepted");
+
+    //
+    // A change still in the window is lost by a reset without a flush, and
+    // kept by one with.
+    //
+    MeshLocalCfgSetDefaultTtl(9);
+    localcfg_test_start();
+    localcfg_test_expect(MeshLocalCfgGetDefaultTtl() == 7, "reset in window",
+                         "change stored without a commit");
+
+    MeshLocalCfgSetDefaultTtl(9);
+    MeshLocalCfgNvmFlush();
+    localcfg_test_report("flush before reset");
+    localcfg_test_start();
+    localcfg_test_expect(MeshLocalCfgGetDefaultTtl() == 9, "flush before reset",
+                         "change lost");
+
+    //
+    // The commit timer writes the window on expiry.
+    //
+    MeshLocalCfgSetDefaultTtl(3);
+    ui32Writes = localcfg_test_writes;
+    meshCb.localCfgMsgCback(&localcfg_test_timer->msg);
+    localcfg_test_report("timer expired");
+    localcfg_test_expect(localcfg_test_writes == ui32Writes + 1, "timer expired",
+                         "changed dataset not written once");
+
+    //
+    // An erase drops the window, so a flush after it cannot bring the
+    // configuration back.
+    //
+    MeshLocalCfgSetDefaultTtl(5);
+    MeshLocalCfgEraseNvm();
+    ui32Writes = localcfg_test_writes;
+    MeshLocalCfgNvmFlush();
+    localcfg_test_report("erase");
+    localcfg_test_expect(localcfg_test_writes == ui32Writes, "erase", "wrote after the erase");
+
+    localcfg_test_start();
+    MeshLocalCfgGetAddrFromElementId(0, &ui16Address);
+    localcfg_test_expect(ui16Address == MESH_ADDR_TYPE_UNASSIGNED, "erase",
+                         "address survived the erase");
+    localcfg_test_expect(!MeshLocalCfgIsDstAddrAccepted(0x0001), "erase",
+                         "unicast accepted while unprovisioned");
+
+    if (localcfg_test_failed)
+    {
+        return 1;
+    }
+
+    printf("localcfg: pending changes stored by a flush, dropped by an erase\n");
+
+    return 0;
+}
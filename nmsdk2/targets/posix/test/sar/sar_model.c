@@ -0,0 +1,71 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wsf_types.h"
+#include "mesh_defs.h"
+#include "mesh_types.h"
+#include "mesh_network.h"
+#include "mesh_lower_transport.h"
+#include "mesh_sar_rx.h"
+
+#include "sar_model.h"
+
+//*****************************************************************************
+//
+// The buffer build renames the SAR Rx functions and selects its model through
+// sar_buffer.h.
+//
+//*****************************************************************************
+#ifndef SAR_MODEL
+#define SAR_MODEL      sar_model_pool
+#define SAR_MODEL_NAME "pool"
+#endif
+
+static void sar_model_init(void)
+{
+    MeshSarRxInit();
+    MeshSarRxRegister(sar_test_reassembled);
+    MeshSarRxRegisterFriend(sar_test_lpn_dst, sar_test_friend_reassembled);
+}
+
+static void sar_model_process(const meshNwkPduRxInfo_t *psPdu)
+{
+    MeshSarRxProcessSegment(psPdu);
+}
+
+const sar_model_t SAR_MODEL = {
+    SAR_MODEL_NAME,
+    sar_model_init,
+    sar_model_process,
+};
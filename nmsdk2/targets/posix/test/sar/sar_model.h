@@ -0,0 +1,88 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _SAR_MODEL_H_
+#define _SAR_MODEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wsf_types.h"
+#include "mesh_defs.h"
+#include "mesh_types.h"
+#include "mesh_network.h"
+#include "mesh_lower_transport.h"
+#include "mesh_sar_rx.h"
+
+//*****************************************************************************
+//
+// One SAR Rx implementation driven by the SAR test.  sar_model.c is built once
+// against the segment slot pool in the stack and once against the copy of the
+// per transaction buffer it replaced.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    void (*pfnInit)(void);
+    void (*pfnProcess)(const meshNwkPduRxInfo_t *psPdu);
+} sar_model_t;
+
+extern const sar_model_t sar_model_pool;
+extern const sar_model_t sar_model_buffer;
+
+//
+// WSF and mesh stubs in sar_stub.c.  The WSF buffer pools follow the sizes
+// of the mesh applications and are filled smallest fit first.
+//
+extern uint32_t sar_test_now;
+extern uint32_t sar_test_wsf_peak;
+extern uint32_t sar_test_wsf_failed;
+extern uint32_t sar_test_overflows;
+extern uint32_t sar_test_busy_acks;
+extern meshAddress_t sar_test_busy_dst;
+
+extern void sar_test_reset(void);
+extern uint32_t sar_test_static_memory(void);
+extern void sar_test_run_timers(void);
+
+//
+// Called from the SAR Rx callbacks.
+//
+extern void sar_test_reassembled(meshSarRxPduType_t pduType,
+                                 const meshSarRxReassembledPduInfo_t *pReasPduInfo);
+extern bool_t sar_test_lpn_dst(meshAddress_t dst, uint16_t netKeyIndex);
+extern void sar_test_friend_reassembled(meshSarRxPduType_t pduType,
+                                        const meshSarRxReassembledPduInfo_t *pReasPduInfo,
+                                        const meshSarRxSegInfoFriend_t *pSegInfoArray,
+                                        uint32_t ivIndex, uint16_t seqZero, uint8_t segN);
+
+#endif
@@ -0,0 +1,328 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wsf_types.h"
+#include "wsf_assert.h"
+#include "wsf_buf.h"
+#include "wsf_cs.h"
+#include "wsf_timer.h"
+#include "mesh_defs.h"
+#include "mesh_api.h"
+#include "mesh_types.h"
+#include "mesh_error_codes.h"
+#include "mesh_main.h"
+#include "mesh_network.h"
+#include "mesh_local_config_types.h"
+#include "mesh_local_config.h"
+#include "mesh_seq_manager.h"
+#include "mesh_sar_rx_history.h"
+
+#include "sar_model.h"
+
+//*****************************************************************************
+//
+// WSF buffer pools.  Every buffer is followed by guard bytes that are checked
+// when it is freed, so a write past the requested length is counted even when
+// it stays inside the pool buffer.
+//
+//*****************************************************************************
+#define SAR_STUB_POOLS      6
+#define SAR_STUB_BUFFERS    64
+#define SAR_STUB_GUARD      256
+#define SAR_STUB_GUARD_BYTE 0xA5
+#define SAR_STUB_TIMERS     32
+#define SAR_STUB_MEMORY     16384
+
+typedef struct
+{
+    uint8_t *pui8Buffer;
+    uint16_t ui16Length;
+    uint8_t ui8Pool;
+} sar_stub_buffer_t;
+
+static const uint16_t sar_stub_pool_length[SAR_STUB_POOLS] = {16, 32, 64, 128, 256, 512};
+static const uint8_t sar_stub_pool_count[SAR_STUB_POOLS] = {8, 8, 8, 4, 4, 2};
+
+static uint8_t sar_stub_pool_used[SAR_STUB_POOLS];
+static sar_stub_buffer_t sar_stub_buffers[SAR_STUB_BUFFERS];
+static uint32_t sar_stub_wsf_used;
+
+static wsfTimer_t *sar_stub_timers[SAR_STUB_TIMERS];
+static uint32_t sar_stub_expiry[SAR_STUB_TIMERS];
+
+static uint8_t sar_stub_memory[SAR_STUB_MEMORY];
+static meshMemoryConfig_t sar_stub_memory_config;
+static meshConfig_t sar_stub_config;
+
+uint32_t sar_test_now;
+uint32_t sar_test_wsf_peak;
+uint32_t sar_test_wsf_failed;
+uint32_t sar_test_overflows;
+uint32_t sar_test_busy_acks;
+meshAddress_t sar_test_busy_dst;
+
+meshCb_t meshCb;
+meshConfig_t *pMeshConfig;
+
+void *WsfBufAlloc(uint16_t len)
+{
+    for (uint8_t i = 0; i < SAR_STUB_POOLS; i++)
+    {
+        if ((len > sar_stub_pool_length[i]) || (sar_stub_pool_used[i] == sar_stub_pool_count[i]))
+        {
+            continue;
+        }
+
+        for (uint32_t j = 0; j < SAR_STUB_BUFFERS; j++)
+        {
+            if (sar_stub_buffers[j].pui8Buffer == NULL)
+            {
+                sar_stub_buffers[j].pui8Buffer = malloc(len + SAR_STUB_GUARD);
+                sar_stub_buffers[j].ui16Length = len;
+                sar_stub_buffers[j].ui8Pool = i;
+                memset(sar_stub_buffers[j].pui8Buffer + len, SAR_STUB_GUARD_BYTE, SAR_STUB_GUARD);
+
+                sar_stub_pool_used[i]++;
+                sar_stub_wsf_used += sar_stub_pool_length[i];
+                if (sar_stub_wsf_used > sar_test_wsf_peak)
+                {
+                    sar_test_wsf_peak = sar_stub_wsf_used;
+                }
+
+                return sar_stub_buffers[j].pui8Buffer;
+            }
+        }
+    }
+
+    sar_test_wsf_failed++;
+    return NULL;
+}
+
+void WsfBufFree(void *pBuf)
+{
+    sar_stub_buffer_t *psBuffer = NULL;
+
+    for (uint32_t j = 0; j < SAR_STUB_BUFFERS; j++)
+    {
+        if ((pBuf != NULL) && (sar_stub_buffers[j].pui8Buffer == pBuf))
+        {
+            psBuffer = &sar_stub_buffers[j];
+        }
+    }
+
+    if (psBuffer == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < SAR_STUB_GUARD; i++)
+    {
+        if (psBuffer->pui8Buffer[psBuffer->ui16Length + i] != SAR_STUB_GUARD_BYTE)
+        {
+            sar_test_overflows++;
+            break;
+        }
+    }
+
+    sar_stub_pool_used[psBuffer->ui8Pool]--;
+    sar_stub_wsf_used -= sar_stub_pool_length[psBuffer->ui8Pool];
+
+    free(psBuffer->pui8Buffer);
+    psBuffer->pui8Buffer = NULL;
+}
+
+void WsfCsEnter(void)
+{
+}
+
+void WsfCsExit(void)
+{
+}
+
+void WsfAssert(const char *pFile, uint16_t line)
+{
+    printf("sar: assertion failed at %s:%u\n", pFile, line);
+    abort();
+}
+
+void WsfTimerStartMs(wsfTimer_t *pTimer, wsfTimerTicks_t ms)
+{
+    int32_t i32Free = -1;
+
+    for (int32_t i = 0; i < SAR_STUB_TIMERS; i++)
+    {
+        if (sar_stub_timers[i] == pTimer)
+        {
+            i32Free = i;
+            break;
+        }
+
+        if ((sar_stub_timers[i] == NULL) && (i32Free < 0))
+        {
+            i32Free = i;
+        }
+    }
+
+    WSF_ASSERT(i32Free >= 0);
+
+    sar_stub_timers[i32Free] = pTimer;
+    sar_stub_expiry[i32Free] = sar_test_now + ms;
+    pTimer->isStarted = TRUE;
+}
+
+void WsfTimerStop(wsfTimer_t *pTimer)
+{
+    for (uint32_t i = 0; i < SAR_STUB_TIMERS; i++)
+    {
+        if (sar_stub_timers[i] == pTimer)
+        {
+            sar_stub_timers[i] = NULL;
+        }
+    }
+
+    pTimer->isStarted = FALSE;
+}
+
+void sar_test_run_timers(void)
+{
+    for (uint32_t i = 0; i < SAR_STUB_TIMERS; i++)
+    {
+        if ((sar_stub_timers[i] != NULL) && ((int32_t)(sar_test_now - sar_stub_expiry[i]) >= 0))
+        {
+            wsfTimer_t *pTimer = sar_stub_timers[i];
+
+            sar_stub_timers[i] = NULL;
+            pTimer->isStarted = FALSE;
+            meshCb.sarRxMsgCback(&pTimer->msg);
+        }
+    }
+}
+
+void sar_test_reset(void)
+{
+    for (uint32_t j = 0; j < SAR_STUB_BUFFERS; j++)
+    {
+        free(sar_stub_buffers[j].pui8Buffer);
+    }
+
+    memset(sar_stub_buffers, 0, sizeof(sar_stub_buffers));
+    memset(sar_stub_pool_used, 0, sizeof(sar_stub_pool_used));
+    memset(sar_stub_timers, 0, sizeof(sar_stub_timers));
+    sar_stub_wsf_used = 0;
+
+    sar_test_now = 0;
+    sar_test_wsf_peak = 0;
+    sar_test_wsf_failed = 0;
+    sar_test_overflows = 0;
+    sar_test_busy_acks = 0;
+    sar_test_busy_dst = MESH_ADDR_TYPE_UNASSIGNED;
+
+    sar_stub_memory_config.sarRxTranInfoSize = 8;
+    sar_stub_memory_config.maxNumFriendQueueEntries = 64;
+    sar_stub_config.pMemoryConfig = &sar_stub_memory_config;
+    pMeshConfig = &sar_stub_config;
+
+    memset(&meshCb, 0, sizeof(meshCb));
+    meshCb.pMemBuff = sar_stub_memory;
+    meshCb.memBuffSize = sizeof(sar_stub_memory);
+}
+
+uint32_t sar_test_static_memory(void)
+{
+    return sizeof(sar_stub_memory) - meshCb.memBuffSize;
+}
+
+//*****************************************************************************
+//
+// Mesh stubs.  A segment acknowledgement with an empty BlockAck tells the
+// sender that its transaction was not admitted.
+//
+//*****************************************************************************
+uint8_t MeshLocalCfgGetDefaultTtl(void)
+{
+    return 5;
+}
+
+meshLocalCfgRetVal_t MeshLocalCfgGetAddrFromElementId(meshElementId_t elementId,
+                                                      meshAddress_t *pAddress)
+{
+    *pAddress = 0x0001;
+    return MESH_SUCCESS;
+}
+
+meshNwkRetVal_t MeshNwkSendLtrPdu(const meshNwkPduTxInfo_t *pNwkPduTxInfo)
+{
+    if (pNwkPduTxInfo->ctl && (pNwkPduTxInfo->utrPduLen == MESH_SEG_ACK_PDU_LENGTH) &&
+        (pNwkPduTxInfo->pUtrPdu[2] == 0) && (pNwkPduTxInfo->pUtrPdu[3] == 0) &&
+        (pNwkPduTxInfo->pUtrPdu[4] == 0) && (pNwkPduTxInfo->pUtrPdu[5] == 0))
+    {
+        sar_test_busy_dst = pNwkPduTxInfo->dst;
+        sar_test_busy_acks++;
+    }
+
+    return MESH_SUCCESS;
+}
+
+meshSeqRetVal_t MeshSeqGetNumber(meshAddress_t srcAddr, meshSeqNumber_t *pOutSeqNo, bool_t autoInc)
+{
+    *pOutSeqNo = 0;
+    return MESH_SUCCESS;
+}
+
+uint32_t MeshSarRxHistoryGetRequiredMemory(void)
+{
+    return 0;
+}
+
+void MeshSarRxHistoryInit(void)
+{
+}
+
+bool_t MeshSarRxHistoryCheck(meshAddress_t srcAddr, uint32_t seqNo, uint16_t seqZero,
+                             uint8_t iviLsb, uint8_t segN, bool_t *pOutSendAck, bool_t *pOutObo)
+{
+    *pOutSendAck = FALSE;
+    *pOutObo = FALSE;
+    return TRUE;
+}
+
+void MeshSarRxHistoryAdd(meshAddress_t srcAddr, uint32_t seqNo, uint8_t iviLsb, uint8_t segN,
+                         bool_t obo)
+{
+}
+
+void MeshSarRxHistoryCleanupOld(meshAddress_t srcAddr, uint16_t seqZero, uint8_t iviLsb)
+{
+}
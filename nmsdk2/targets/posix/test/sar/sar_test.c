@@ -0,0 +1,432 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wsf_types.h"
+#include "wsf_buf.h"
+#include "mesh_defs.h"
+#include "mesh_types.h"
+#include "mesh_network.h"
+#include "mesh_lower_transport.h"
+#include "mesh_sar_rx.h"
+
+#include "sar_model.h"
+
+//*****************************************************************************
+//
+// Runs mesh SAR Rx with the segment slot pool and the per transaction buffer
+// it replaced on the same seeded traffic.  Several senders each send one
+// segmented access message at a time, segments in random order, half of them
+// to a group that a Low Power Node subscribes to.  A sender that is answered
+// with an empty BlockAck gives up on its message.  Every reassembled PDU is
+// checked byte for byte, every entry of a Friend segment table against the
+// sequence number of its segment, and every WSF buffer for writes past its
+// end.
+//
+// Malformed segments are sent to the pool: a segment before the last one
+// that is not full, an empty or oversized last segment and a segment shorter
+// than its header.  None of them may complete a message, and a valid message
+// from the same sender must still be reassembled afterwards.
+//
+//*****************************************************************************
+#define SAR_TEST_STEPS      200000
+#define SAR_TEST_SENDERS    8
+#define SAR_TEST_FIRST_SRC  0x0100
+#define SAR_TEST_UNICAST    0x0001
+#define SAR_TEST_LPN_GROUP  0xC000
+#define SAR_TEST_IDLE_MS    100
+#define SAR_TEST_STEP_MS    2
+#define SAR_TEST_IDLE       0xFF
+#define SAR_TEST_SEG_MAX    (MESH_SEG_N_MASK + 1)
+#define SAR_TEST_PDU_MAX    (MESH_SEG_HEADER_LENGTH + MESH_ACC_SEG_MAX_LENGTH)
+
+#define SAR_TEST_ACC_FULL   (MESH_SEG_HEADER_LENGTH + MESH_ACC_SEG_MAX_LENGTH)
+#define SAR_TEST_CTL_FULL   (MESH_SEG_HEADER_LENGTH + MESH_CTL_SEG_MAX_LENGTH)
+
+typedef struct
+{
+    uint32_t ui32Senders;
+    uint32_t ui32MaxSegN;
+} sar_test_traffic_t;
+
+typedef struct
+{
+    uint32_t ui32Started;
+    uint32_t ui32Completed;
+    uint32_t ui32Busy;
+    uint32_t ui32WsfPeak;
+    uint32_t ui32Static;
+} sar_test_result_t;
+
+typedef struct
+{
+    meshAddress_t ui16Src;
+    uint32_t ui32Seq;
+    uint8_t ui8SegN;
+    uint8_t ui8Next;
+    uint8_t pui8Order[SAR_TEST_SEG_MAX];
+    uint32_t ui32Idle;
+} sar_test_sender_t;
+
+typedef struct
+{
+    const char *pcName;
+    uint8_t ui8Ctl;
+    uint8_t ui8SegN;
+    uint8_t pui8PduLen[3];
+} sar_test_malformed_t;
+
+static const sar_test_traffic_t sar_test_traffic[] = {
+    {4, 7},
+    {8, 7},
+    {8, 31},
+};
+
+static const sar_test_malformed_t sar_test_malformed[] = {
+    {"short first segment", 0, 1, {MESH_SEG_HEADER_LENGTH + 1, MESH_SEG_HEADER_LENGTH + 1}},
+    {"short middle segment", 0, 2, {SAR_TEST_ACC_FULL, MESH_SEG_HEADER_LENGTH + 5, SAR_TEST_ACC_FULL}},
+    {"empty last segment", 0, 1, {SAR_TEST_ACC_FULL, MESH_SEG_HEADER_LENGTH}},
+    {"truncated segment", 0, 0, {MESH_SEG_HEADER_LENGTH - 1}},
+    {"oversized control segment", 1, 1, {SAR_TEST_CTL_FULL, SAR_TEST_ACC_FULL}},
+    {"short control segment", 1, 1, {MESH_SEG_HEADER_LENGTH + 5, MESH_SEG_HEADER_LENGTH + 5}},
+};
+
+static uint16_t sar_test_length[SAR_TEST_SENDERS];
+static uint32_t sar_test_random;
+static uint32_t sar_test_completed;
+static uint32_t sar_test_corrupted;
+static uint32_t sar_test_friend_bad;
+static bool sar_test_failed;
+
+static uint32_t sar_test_hash(uint32_t ui32Value)
+{
+    ui32Value ^= ui32Value >> 16;
+    ui32Value *= 0x7FEB352D;
+    ui32Value ^= ui32Value >> 15;
+    ui32Value *= 0x846CA68B;
+    ui32Value ^= ui32Value >> 16;
+
+    return ui32Value;
+}
+
+static uint32_t sar_test_rand(void)
+{
+    sar_test_random = sar_test_hash(sar_test_random + 0x9E3779B9);
+
+    return sar_test_random;
+}
+
+static uint8_t sar_test_byte(meshAddress_t ui16Src, uint32_t ui32Seq, uint32_t ui32Offset)
+{
+    return (uint8_t)(ui16Src * 7 + ui32Seq * 13 + ui32Offset);
+}
+
+void sar_test_reassembled(meshSarRxPduType_t pduType,
+                          const meshSarRxReassembledPduInfo_t *pReasPduInfo)
+{
+    const meshLtrAccPduInfo_t *psAcc = &pReasPduInfo->accPduInfo;
+    uint32_t ui32Sender = psAcc->src - SAR_TEST_FIRST_SRC;
+
+    sar_test_completed++;
+
+    if ((pduType != MESH_SAR_RX_TYPE_ACCESS) || (ui32Sender >= SAR_TEST_SENDERS) ||
+        (psAcc->pduLen != sar_test_length[ui32Sender]))
+    {
+        sar_test_corrupted++;
+    }
+    else
+    {
+        for (uint16_t i = 0; i < psAcc->pduLen; i++)
+        {
+            if (psAcc->pUtrAccPdu[i] != sar_test_byte(psAcc->src, psAcc->seqNo, i))
+            {
+                sar_test_corrupted++;
+                break;
+            }
+        }
+    }
+
+    WsfBufFree((void *)pReasPduInfo);
+}
+
+bool_t sar_test_lpn_dst(meshAddress_t dst, uint16_t netKeyIndex)
+{
+    return dst == SAR_TEST_LPN_GROUP;
+}
+
+void sar_test_friend_reassembled(meshSarRxPduType_t pduType,
+                                 const meshSarRxReassembledPduInfo_t *pReasPduInfo,
+                                 const meshSarRxSegInfoFriend_t *pSegInfoArray,
+                                 uint32_t ivIndex, uint16_t seqZero, uint8_t segN)
+{
+    for (uint8_t segO = 0; segO <= segN; segO++)
+    {
+        const meshSarRxSegInfoFriend_t *psSeg = &pSegInfoArray[segO];
+
+        if ((psSeg->offset != psSeg->segO * MESH_ACC_SEG_MAX_LENGTH) ||
+            (psSeg->segSeqNo != pReasPduInfo->accPduInfo.seqNo + psSeg->segO))
+        {
+            sar_test_friend_bad++;
+            break;
+        }
+    }
+}
+
+//
+// Sends one segment of the message starting at ui32Seq.  The payload follows
+// the message pattern from the offset of a full segment ui8SegO.
+//
+static void sar_test_send(const sar_model_t *psModel, meshAddress_t ui16Src, meshAddress_t ui16Dst,
+                          uint32_t ui32Seq, uint8_t ui8Ctl, uint8_t ui8SegO, uint8_t ui8SegN,
+                          uint8_t ui8PduLen)
+{
+    uint8_t pui8Pdu[SAR_TEST_PDU_MAX];
+    uint8_t ui8SegMax = ui8Ctl ? MESH_CTL_SEG_MAX_LENGTH : MESH_ACC_SEG_MAX_LENGTH;
+    uint16_t ui16SeqZero = ui32Seq & MESH_SEQ_ZERO_MASK;
+    meshNwkPduRxInfo_t sPdu;
+
+    memset(pui8Pdu, 0, sizeof(pui8Pdu));
+    pui8Pdu[0] = 0x80;
+    pui8Pdu[1] = (ui16SeqZero >> 6) & 0x7F;
+    pui8Pdu[2] = ((ui16SeqZero & 0x3F) << 2) | (ui8SegO >> 3);
+    pui8Pdu[3] = ((ui8SegO & 0x07) << 5) | ui8SegN;
+
+    for (uint8_t i = MESH_SEG_HEADER_LENGTH; i < ui8PduLen; i++)
+    {
+        pui8Pdu[i] = sar_test_byte(ui16Src, ui32Seq, ui8SegO * ui8SegMax + i - MESH_SEG_HEADER_LENGTH);
+    }
+
+    memset(&sPdu, 0, sizeof(sPdu));
+    sPdu.pLtrPdu = pui8Pdu;
+    sPdu.pduLen = ui8PduLen;
+    sPdu.ctl = ui8Ctl;
+    sPdu.ttl = 5;
+    sPdu.src = ui16Src;
+    sPdu.dst = ui16Dst;
+    sPdu.seqNo = ui32Seq + ui8SegO;
+
+    psModel->pfnProcess(&sPdu);
+}
+
+static void sar_test_start(const sar_model_t *psModel)
+{
+    sar_test_reset();
+    psModel->pfnInit();
+
+    sar_test_random = 1;
+    sar_test_completed = 0;
+    sar_test_corrupted = 0;
+    sar_test_friend_bad = 0;
+}
+
+static void sar_test_check(const sar_model_t *psModel, const char *pcWhat)
+{
+    if (sar_test_corrupted || sar_test_friend_bad || sar_test_overflows)
+    {
+        printf("sar: %s %s: %u corrupted, %u bad Friend tables, %u buffer overflows\n",
+               psModel->pcName, pcWhat, sar_test_corrupted, sar_test_friend_bad,
+               sar_test_overflows);
+        sar_test_failed = true;
+    }
+}
+
+static void sar_test_run(const sar_model_t *psModel, const sar_test_traffic_t *psTraffic,
+                         sar_test_result_t *psResult)
+{
+    sar_test_sender_t psSenders[SAR_TEST_SENDERS];
+
+    sar_test_start(psModel);
+    memset(psResult, 0, sizeof(*psResult));
+    psResult->ui32Static = sar_test_static_memory();
+
+    memset(psSenders, 0, sizeof(psSenders));
+    for (uint32_t i = 0; i < psTraffic->ui32Senders; i++)
+    {
+        psSenders[i].ui16Src = SAR_TEST_FIRST_SRC + i;
+        psSenders[i].ui32Seq = 1000 * i;
+        psSenders[i].ui8Next = SAR_TEST_IDLE;
+    }
+
+    for (uint32_t ui32Step = 0; ui32Step < SAR_TEST_STEPS; ui32Step++)
+    {
+        uint32_t ui32Sender = sar_test_rand() % psTraffic->ui32Senders;
+        sar_test_sender_t *psSender = &psSenders[ui32Sender];
+        meshAddress_t ui16Dst;
+        uint8_t ui8SegO, ui8PduLen;
+
+        sar_test_now += SAR_TEST_STEP_MS;
+        sar_test_run_timers();
+
+        if (psSender->ui8Next == SAR_TEST_IDLE)
+        {
+            if ((int32_t)(psSender->ui32Idle - sar_test_now) > 0)
+            {
+                continue;
+            }
+
+            psSender->ui8SegN = sar_test_rand() % (psTraffic->ui32MaxSegN + 1);
+            sar_test_length[ui32Sender] = psSender->ui8SegN * MESH_ACC_SEG_MAX_LENGTH + 1 +
+                                          sar_test_rand() % MESH_ACC_SEG_MAX_LENGTH;
+
+            for (uint8_t i = 0; i <= psSender->ui8SegN; i++)
+            {
+                psSender->pui8Order[i] = i;
+            }
+
+            for (uint8_t i = psSender->ui8SegN; i > 0; i--)
+            {
+                uint8_t j = sar_test_rand() % (i + 1);
+                uint8_t ui8SegO = psSender->pui8Order[i];
+
+                psSender->pui8Order[i] = psSender->pui8Order[j];
+                psSender->pui8Order[j] = ui8SegO;
+            }
+
+            psSender->ui32Seq += SAR_TEST_SEG_MAX;
+            psSender->ui8Next = 0;
+            psResult->ui32Started++;
+        }
+
+        ui8SegO = psSender->pui8Order[psSender->ui8Next];
+        ui8PduLen = MESH_SEG_HEADER_LENGTH +
+                    ((ui8SegO == psSender->ui8SegN) ?
+                         sar_test_length[ui32Sender] - ui8SegO * MESH_ACC_SEG_MAX_LENGTH :
+                         MESH_ACC_SEG_MAX_LENGTH);
+        ui16Dst = (psSender->ui16Src & 1) ? SAR_TEST_LPN_GROUP : SAR_TEST_UNICAST;
+
+        sar_test_busy_dst = MESH_ADDR_TYPE_UNASSIGNED;
+        sar_test_send(psModel, psSender->ui16Src, ui16Dst, psSender->ui32Seq, 0, ui8SegO,
+                      psSender->ui8SegN, ui8PduLen);
+
+        if (sar_test_busy_dst == psSender->ui16Src)
+        {
+            psSender->ui8Next = SAR_TEST_IDLE;
+            psSender->ui32Idle = sar_test_now + SAR_TEST_IDLE_MS;
+            psResult->ui32Busy++;
+        }
+        else if (++psSender->ui8Next > psSender->ui8SegN)
+        {
+            psSender->ui8Next = SAR_TEST_IDLE;
+            psSender->ui32Idle = sar_test_now + SAR_TEST_IDLE_MS;
+        }
+    }
+
+    psResult->ui32Completed = sar_test_completed;
+    psResult->ui32WsfPeak = sar_test_wsf_peak;
+
+    sar_test_check(psModel, "traffic");
+}
+
+static void sar_test_reject(const sar_model_t *psModel)
+{
+    const meshAddress_t ui16Src = SAR_TEST_FIRST_SRC;
+    uint32_t ui32Seq = 0;
+
+    sar_test_start(psModel);
+
+    for (uint32_t i = 0; i < sizeof(sar_test_malformed) / sizeof(sar_test_malformed[0]); i++)
+    {
+        const sar_test_malformed_t *psCase = &sar_test_malformed[i];
+
+        ui32Seq += SAR_TEST_SEG_MAX;
+        sar_test_length[0] = 0;
+        for (uint8_t ui8SegO = 0; ui8SegO <= psCase->ui8SegN; ui8SegO++)
+        {
+            sar_test_send(psModel, ui16Src, SAR_TEST_UNICAST, ui32Seq, psCase->ui8Ctl, ui8SegO,
+                          psCase->ui8SegN, psCase->pui8PduLen[ui8SegO]);
+        }
+
+        if (sar_test_completed)
+        {
+            printf("sar: %s %s reassembled\n", psModel->pcName, psCase->pcName);
+            sar_test_failed = true;
+        }
+
+        sar_test_check(psModel, psCase->pcName);
+        sar_test_completed = 0;
+        sar_test_corrupted = 0;
+        sar_test_overflows = 0;
+
+        // A valid message from the same sender, last segment short
+        ui32Seq += SAR_TEST_SEG_MAX;
+        sar_test_length[0] = MESH_ACC_SEG_MAX_LENGTH + 5;
+        sar_test_send(psModel, ui16Src, SAR_TEST_UNICAST, ui32Seq, 0, 1, 1,
+                      MESH_SEG_HEADER_LENGTH + 5);
+        sar_test_send(psModel, ui16Src, SAR_TEST_UNICAST, ui32Seq, 0, 0, 1, SAR_TEST_ACC_FULL);
+
+        if (sar_test_completed != 1)
+        {
+            printf("sar: %s %s: valid message not reassembled\n", psModel->pcName,
+                   psCase->pcName);
+            sar_test_failed = true;
+        }
+
+        sar_test_check(psModel, "valid message");
+        sar_test_completed = 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const sar_model_t *psModels[] = {&sar_model_buffer, &sar_model_pool};
+    sar_test_result_t sResult;
+
+    sar_test_reject(&sar_model_pool);
+
+    printf("senders/segN  model   started  completed  busy   peak WSF  static\n");
+
+    for (uint32_t i = 0; i < sizeof(sar_test_traffic) / sizeof(sar_test_traffic[0]); i++)
+    {
+        for (uint32_t j = 0; j < sizeof(psModels) / sizeof(psModels[0]); j++)
+        {
+            sar_test_run(psModels[j], &sar_test_traffic[i], &sResult);
+
+            printf("%u / 0..%-6u %-7s %7u  %9u  %5u  %6u B  %4u B\n",
+                   sar_test_traffic[i].ui32Senders, sar_test_traffic[i].ui32MaxSegN,
+                   psModels[j]->pcName, sResult.ui32Started, sResult.ui32Completed,
+                   sResult.ui32Busy, sResult.ui32WsfPeak, sResult.ui32Static);
+        }
+    }
+
+    if (sar_test_failed)
+    {
+        return 1;
+    }
+
+    printf("sar: no PDU corrupted, malformed segments rejected\n");
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+//
+// Forced into the build of the reference list and of its copy of
+// timer_model.c, so the two timer implementations link into one test.
+// timer.c and timer.h next to this file are the sorted list as it was before
+// the pairing heap, kept unchanged.
+//
+#ifndef _TIMER_LIST_H_
+#define _TIMER_LIST_H_
+
+#define TIMER_MODEL             timer_model_list
+#define TIMER_MODEL_NAME        "list"
+#define TIMER_MODEL_ALARM_REACH UINT32_MAX
+
+#define TimerInit               ListTimerInit
+#define TimerSetContext         ListTimerSetContext
+#define TimerStart              ListTimerStart
+#define TimerIsStarted          ListTimerIsStarted
+#define TimerIrqHandler         ListTimerIrqHandler
+#define TimerStop               ListTimerStop
+#define TimerReset              ListTimerReset
+#define TimerSetValue           ListTimerSetValue
+#define TimerGetRemainingTime   ListTimerGetRemainingTime
+#define TimerGetCurrentTime     ListTimerGetCurrentTime
+#define TimerGetElapsedTime     ListTimerGetElapsedTime
+#define TimerTempCompensation   ListTimerTempCompensation
+#define TimerProcess            ListTimerProcess
+
+#define RtcInit                 ListRtcInit
+#define RtcGetMinimumTimeout    ListRtcGetMinimumTimeout
+#define RtcMs2Tick              ListRtcMs2Tick
+#define RtcTick2Ms              ListRtcTick2Ms
+#define RtcDelayMs              ListRtcDelayMs
+#define RtcSetAlarm             ListRtcSetAlarm
+#define RtcStopAlarm            ListRtcStopAlarm
+#define RtcStartAlarm           ListRtcStartAlarm
+#define RtcSetTimerContext      ListRtcSetTimerContext
+#define RtcGetTimerContext      ListRtcGetTimerContext
+#define RtcGetCalendarTime      ListRtcGetCalendarTime
+#define RtcGetTimerValue        ListRtcGetTimerValue
+#define RtcGetTimerElapsedTime  ListRtcGetTimerElapsedTime
+#define RtcBkupWrite            ListRtcBkupWrite
+#define RtcBkupRead             ListRtcBkupRead
+#define RtcProcess              ListRtcProcess
+#define RtcTempCompensation     ListRtcTempCompensation
+
+#endif
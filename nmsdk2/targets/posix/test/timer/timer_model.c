@@ -0,0 +1,167 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utilities.h"
+#include "board.h"
+#include "rtc-board.h"
+#include "timer.h"
+
+#include "timer_model.h"
+
+//*****************************************************************************
+//
+// The list build renames the timer and RTC functions and selects its model
+// through timer_list.h.  Like rtc-board, the fake RTC cuts an alarm short at
+// the reach of the compare so the heap wakes up early and sets it again; the
+// list predates that and gets the full range.
+//
+//*****************************************************************************
+#ifndef TIMER_MODEL
+#define TIMER_MODEL             timer_model_heap
+#define TIMER_MODEL_NAME        "heap"
+#define TIMER_MODEL_ALARM_REACH (1UL << 20)
+#endif
+
+#define TIMER_MODEL_MIN_TIMEOUT 3
+
+static TimerEvent_t timer_model_timers[TIMER_MODEL_TIMERS];
+
+static uint32_t timer_model_context;
+static uint32_t timer_model_alarm;
+static bool timer_model_armed;
+
+uint32_t RtcGetMinimumTimeout(void) { return TIMER_MODEL_MIN_TIMEOUT; }
+
+uint32_t RtcMs2Tick(TimerTime_t milliseconds) { return timer_test_ms2tick(milliseconds); }
+
+TimerTime_t RtcTick2Ms(uint32_t tick) { return timer_test_tick2ms(tick); }
+
+void RtcSetAlarm(uint32_t timeout)
+{
+    if (timeout > TIMER_MODEL_ALARM_REACH)
+    {
+        timeout = TIMER_MODEL_ALARM_REACH;
+    }
+
+    timer_model_alarm = timer_model_context + timeout;
+    timer_model_armed = true;
+}
+
+void RtcStopAlarm(void) { timer_model_armed = false; }
+
+uint32_t RtcSetTimerContext(void)
+{
+    timer_model_context = timer_test_counter;
+
+    return timer_model_context;
+}
+
+uint32_t RtcGetTimerContext(void) { return timer_model_context; }
+
+uint32_t RtcGetTimerValue(void) { return timer_test_counter; }
+
+uint32_t RtcGetTimerElapsedTime(void) { return timer_test_counter - timer_model_context; }
+
+TimerTime_t RtcTempCompensation(TimerTime_t period, float temperature) { return period; }
+
+void RtcProcess(void) {}
+
+static void timer_model_callback(void *pvContext)
+{
+    timer_test_fired(&TIMER_MODEL, (uint32_t)(uintptr_t)pvContext);
+}
+
+static void timer_model_init(void)
+{
+    //
+    // Leave nothing behind from the previous sequence.
+    //
+    for (uint32_t i = 0; i < TIMER_MODEL_TIMERS; i++)
+    {
+        TimerStop(&timer_model_timers[i]);
+    }
+
+    for (uint32_t i = 0; i < TIMER_MODEL_TIMERS; i++)
+    {
+        TimerInit(&timer_model_timers[i], timer_model_callback);
+        TimerSetContext(&timer_model_timers[i], (void *)(uintptr_t)i);
+    }
+
+    timer_model_context = timer_test_counter;
+    timer_model_armed = false;
+}
+
+static uint32_t timer_model_start(uint32_t ui32Id, uint32_t ui32Ms)
+{
+    TimerSetValue(&timer_model_timers[ui32Id], ui32Ms);
+    TimerStart(&timer_model_timers[ui32Id]);
+
+    return timer_model_timers[ui32Id].ReloadValue;
+}
+
+static void timer_model_stop(uint32_t ui32Id) { TimerStop(&timer_model_timers[ui32Id]); }
+
+static bool timer_model_is_started(uint32_t ui32Id)
+{
+    return TimerIsStarted(&timer_model_timers[ui32Id]);
+}
+
+static uint32_t timer_model_remaining(uint32_t ui32Id)
+{
+    return TimerGetRemainingTime(&timer_model_timers[ui32Id]);
+}
+
+static bool timer_model_alarm_get(uint32_t *pui32Alarm)
+{
+    *pui32Alarm = timer_model_alarm;
+
+    return timer_model_armed;
+}
+
+static void timer_model_irq(void)
+{
+    timer_model_armed = false;
+    TimerIrqHandler();
+}
+
+const timer_model_t TIMER_MODEL = {
+    TIMER_MODEL_NAME,
+    timer_model_init,
+    timer_model_start,
+    timer_model_stop,
+    timer_model_is_started,
+    timer_model_remaining,
+    timer_model_alarm_get,
+    timer_model_irq,
+};
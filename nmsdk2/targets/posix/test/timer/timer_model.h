@@ -0,0 +1,76 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _TIMER_MODEL_H_
+#define _TIMER_MODEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// One timer implementation driven by the timer test.  timer_model.c is built
+// once against the system timer and once against the reference list, each
+// copy with its own fake RTC on the shared test counter.
+//
+//*****************************************************************************
+#define TIMER_MODEL_TIMERS 24
+
+typedef struct
+{
+    const char *pcName;
+    void (*pfnInit)(void);
+    uint32_t (*pfnStart)(uint32_t ui32Id, uint32_t ui32Ms);
+    void (*pfnStop)(uint32_t ui32Id);
+    bool (*pfnIsStarted)(uint32_t ui32Id);
+    uint32_t (*pfnRemaining)(uint32_t ui32Id);
+
+    bool (*pfnAlarm)(uint32_t *pui32Alarm);
+    void (*pfnIrq)(void);
+} timer_model_t;
+
+extern const timer_model_t timer_model_heap;
+extern const timer_model_t timer_model_list;
+
+//
+// Test counter shared by both fake RTCs, in ticks of 1/32768 s.
+//
+extern uint32_t timer_test_counter;
+
+extern uint32_t timer_test_ms2tick(uint32_t ui32Ms);
+extern uint32_t timer_test_tick2ms(uint32_t ui32Ticks);
+
+//
+// Called from the timer callbacks.
+//
+extern void timer_test_fired(const timer_model_t *psModel, uint32_t ui32Id);
+
+#endif
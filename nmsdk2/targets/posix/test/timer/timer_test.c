@@ -0,0 +1,471 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timer.h"
+
+#include "timer_model.h"
+
+//*****************************************************************************
+//
+// Runs the LoRaMac system timers (a pairing heap) and the sorted list they
+// replaced side by side on seeded random sequences of start, stop, remaining
+// time and elapsing time.  Each sequence starts just below a counter wrap.
+//
+// The test keeps the expiry of every timer it starts.  No timer may fire
+// before its expiry.  The heap must fire each one within the minimum timeout
+// after it, report its remaining time exactly and agree on which timers run.
+//
+// In the odd sequences some timers restart themselves from their callback,
+// and some start a child timer that only their callback touches.  A parent is
+// only restarted once its child is idle, so the order within a tie cannot
+// change what runs next.  The list fires all but one timer of a tie up to the
+// minimum timeout late, and a restart carries that on, so the two are only
+// held to the same order of fires, ties taken as a group, in the even
+// sequences.
+//
+//*****************************************************************************
+#define TIMER_TEST_SEQUENCES   400
+#define TIMER_TEST_OPERATIONS  2000
+#define TIMER_TEST_PARENTS     16
+#define TIMER_TEST_MIN_TIMEOUT 3
+#define TIMER_TEST_MAX_FIRES   (4 * TIMER_TEST_OPERATIONS)
+
+#define TIMER_TEST_SELF(id)    (((id) < TIMER_TEST_PARENTS) && (((id) % 4) == 0))
+#define TIMER_TEST_PARENT(id)  (((id) < TIMER_TEST_PARENTS) && (((id) % 4) == 1))
+#define TIMER_TEST_CHILD(id)   (TIMER_TEST_PARENTS + ((id) / 4))
+
+typedef struct
+{
+    uint32_t ui32Id;
+    uint32_t ui32Expiry;
+} timer_test_fire_t;
+
+typedef struct
+{
+    const timer_model_t *psModel;
+    uint32_t pui32Expiry[TIMER_MODEL_TIMERS];
+    uint32_t pui32Starts[TIMER_MODEL_TIMERS];
+    bool pbRunning[TIMER_MODEL_TIMERS];
+    timer_test_fire_t psFires[TIMER_TEST_MAX_FIRES];
+    uint32_t ui32Fires;
+} timer_test_state_t;
+
+uint32_t timer_test_counter;
+
+static timer_test_state_t timer_test_states[2] = {
+    {.psModel = &timer_model_heap},
+    {.psModel = &timer_model_list},
+};
+
+static uint32_t timer_test_seed;
+static uint32_t timer_test_random;
+static uint32_t timer_test_operation;
+static bool timer_test_restart;
+static bool timer_test_failed;
+
+void BoardCriticalSectionBegin(uint32_t *mask) { (void)mask; }
+
+void BoardCriticalSectionEnd(uint32_t *mask) { (void)mask; }
+
+uint32_t timer_test_ms2tick(uint32_t ui32Ms) { return (uint32_t)(((uint64_t)ui32Ms << 15) / 1000); }
+
+uint32_t timer_test_tick2ms(uint32_t ui32Ticks)
+{
+    return (uint32_t)(((uint64_t)ui32Ticks * 1000) >> 15);
+}
+
+static void timer_test_fail(const char *pcModel, const char *pcWhat, uint32_t ui32Id)
+{
+    if (!timer_test_failed)
+    {
+        printf("seed %u operation %u %s: timer %u %s at %08X\n",
+               timer_test_seed,
+               timer_test_operation,
+               pcModel,
+               ui32Id,
+               pcWhat,
+               timer_test_counter);
+    }
+    timer_test_failed = true;
+}
+
+static uint32_t timer_test_hash(uint32_t ui32Value)
+{
+    ui32Value ^= ui32Value >> 16;
+    ui32Value *= 0x7FEB352D;
+    ui32Value ^= ui32Value >> 15;
+    ui32Value *= 0x846CA68B;
+    ui32Value ^= ui32Value >> 16;
+
+    return ui32Value;
+}
+
+static uint32_t timer_test_rand(void)
+{
+    timer_test_random = timer_test_hash(timer_test_random + 0x9E3779B9);
+
+    return timer_test_random;
+}
+
+//
+// Mostly short timeouts, some below the minimum timeout, whole seconds that
+// tie with each other and a few beyond the reach of the RTC alarm.
+//
+static uint32_t timer_test_duration(uint32_t ui32Random)
+{
+    uint32_t ui32Value = timer_test_hash(ui32Random);
+
+    switch (ui32Random % 6)
+    {
+    case 0:
+        return ui32Value % 3;
+    case 1:
+        return 1 + ui32Value % 50;
+    case 2:
+        return 1 + ui32Value % 2000;
+    case 3:
+        return 1 + ui32Value % 60000;
+    case 4:
+        return 1000 * (1 + ui32Value % 4);
+    default:
+        return 1 + ui32Value % 600000;
+    }
+}
+
+static void timer_test_start(timer_test_state_t *psState, uint32_t ui32Id, uint32_t ui32Ms)
+{
+    uint32_t ui32Ticks = psState->psModel->pfnStart(ui32Id, ui32Ms);
+
+    psState->pui32Expiry[ui32Id] = timer_test_counter + ui32Ticks;
+    psState->pui32Starts[ui32Id]++;
+    psState->pbRunning[ui32Id] = true;
+}
+
+static void timer_test_stop(timer_test_state_t *psState, uint32_t ui32Id)
+{
+    psState->psModel->pfnStop(ui32Id);
+    psState->pbRunning[ui32Id] = false;
+}
+
+//
+// Holds the heap to the expiries the test keeps.
+//
+static void timer_test_check(void)
+{
+    timer_test_state_t *psHeap = &timer_test_states[0];
+
+    for (uint32_t i = 0; i < TIMER_MODEL_TIMERS; i++)
+    {
+        int32_t i32Remaining = (int32_t)(psHeap->pui32Expiry[i] - timer_test_counter);
+
+        if (psHeap->psModel->pfnIsStarted(i) != psHeap->pbRunning[i])
+        {
+            timer_test_fail("heap", "differs in its running state", i);
+        }
+        else if (psHeap->pbRunning[i] && (i32Remaining < -TIMER_TEST_MIN_TIMEOUT))
+        {
+            timer_test_fail("heap", "has not fired", i);
+        }
+    }
+}
+
+void timer_test_fired(const timer_model_t *psModel, uint32_t ui32Id)
+{
+    timer_test_state_t *psState = (psModel == &timer_model_heap) ? &timer_test_states[0]
+                                                                 : &timer_test_states[1];
+    uint32_t ui32Expiry = psState->pui32Expiry[ui32Id];
+    uint32_t ui32Late = timer_test_counter - ui32Expiry;
+
+    if ((int32_t)ui32Late < 0)
+    {
+        timer_test_fail(psModel->pcName, "fired early", ui32Id);
+    }
+    else if ((psModel == &timer_model_heap) && (ui32Late > TIMER_TEST_MIN_TIMEOUT))
+    {
+        timer_test_fail(psModel->pcName, "fired late", ui32Id);
+    }
+
+    psState->pbRunning[ui32Id] = false;
+
+    if (psState->ui32Fires < TIMER_TEST_MAX_FIRES)
+    {
+        psState->psFires[psState->ui32Fires].ui32Id = ui32Id;
+        psState->psFires[psState->ui32Fires].ui32Expiry = ui32Expiry;
+        psState->ui32Fires++;
+    }
+
+    if (!timer_test_restart)
+    {
+        return;
+    }
+
+    //
+    // The next timeout only depends on the timer and how often it started,
+    // so both implementations restart with the same one.
+    //
+    if (TIMER_TEST_SELF(ui32Id))
+    {
+        timer_test_start(psState,
+                         ui32Id,
+                         timer_test_duration(timer_test_seed * 131 + ui32Id * 7919 +
+                                             psState->pui32Starts[ui32Id]));
+    }
+    else if (TIMER_TEST_PARENT(ui32Id))
+    {
+        uint32_t ui32Child = TIMER_TEST_CHILD(ui32Id);
+
+        timer_test_start(psState,
+                         ui32Child,
+                         timer_test_duration(timer_test_seed * 131 + ui32Child * 7919 +
+                                             psState->pui32Starts[ui32Child]));
+    }
+}
+
+//
+// Fires the due alarms of both implementations in time order up to the
+// target time.  Alarms within the minimum timeout after it go off as well,
+// so the list is done with a tie before the next operation.
+//
+static void timer_test_elapse(uint32_t ui32Ticks)
+{
+    uint32_t ui32Target = timer_test_counter + ui32Ticks;
+
+    while (true)
+    {
+        timer_test_state_t *psNext = NULL;
+        uint32_t ui32Next = ui32Target + TIMER_TEST_MIN_TIMEOUT;
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint32_t ui32Alarm;
+
+            if (timer_test_states[i].psModel->pfnAlarm(&ui32Alarm) &&
+                ((int32_t)(ui32Alarm - ui32Next) <= 0) &&
+                ((psNext == NULL) || ((int32_t)(ui32Alarm - ui32Next) < 0)))
+            {
+                psNext = &timer_test_states[i];
+                ui32Next = ui32Alarm;
+            }
+        }
+
+        if (psNext == NULL)
+        {
+            break;
+        }
+
+        //
+        // An alarm set for the past goes off straight away.
+        //
+        if ((int32_t)(ui32Next - timer_test_counter) > 0)
+        {
+            timer_test_counter = ui32Next;
+        }
+        psNext->psModel->pfnIrq();
+    }
+
+    if ((int32_t)(ui32Target - timer_test_counter) > 0)
+    {
+        timer_test_counter = ui32Target;
+    }
+}
+
+static int timer_test_fire_compare(const void *pvA, const void *pvB)
+{
+    const timer_test_fire_t *psA = pvA;
+    const timer_test_fire_t *psB = pvB;
+
+    return (int)psA->ui32Id - (int)psB->ui32Id;
+}
+
+//
+// Timers with the same expiry may fire in either order.
+//
+static void timer_test_sort_ties(timer_test_state_t *psState)
+{
+    uint32_t ui32Start = 0;
+
+    for (uint32_t i = 1; i <= psState->ui32Fires; i++)
+    {
+        if ((i == psState->ui32Fires) ||
+            (psState->psFires[i].ui32Expiry != psState->psFires[ui32Start].ui32Expiry))
+        {
+            qsort(&psState->psFires[ui32Start],
+                  i - ui32Start,
+                  sizeof(timer_test_fire_t),
+                  timer_test_fire_compare);
+            ui32Start = i;
+        }
+    }
+}
+
+static void timer_test_compare_fires(void)
+{
+    timer_test_state_t *psHeap = &timer_test_states[0];
+    timer_test_state_t *psList = &timer_test_states[1];
+
+    timer_test_sort_ties(psHeap);
+    timer_test_sort_ties(psList);
+
+    for (uint32_t i = 0; (i < psHeap->ui32Fires) && (i < psList->ui32Fires); i++)
+    {
+        if (memcmp(&psHeap->psFires[i], &psList->psFires[i], sizeof(timer_test_fire_t)))
+        {
+            timer_test_fail("heap", "fired out of order", psHeap->psFires[i].ui32Id);
+            return;
+        }
+    }
+
+    if (psHeap->ui32Fires != psList->ui32Fires)
+    {
+        timer_test_fail("heap", "fired a different number of times", TIMER_MODEL_TIMERS);
+    }
+}
+
+static void timer_test_sequence(uint32_t ui32Seed)
+{
+    timer_test_state_t *psHeap = &timer_test_states[0];
+    timer_test_state_t *psList = &timer_test_states[1];
+
+    timer_test_seed = ui32Seed;
+    timer_test_random = ui32Seed;
+    timer_test_restart = (ui32Seed & 1) != 0;
+
+    //
+    // Start within a minute of the counter wrap, or of the sign change for
+    // half of the sequences.
+    //
+    timer_test_counter = ((ui32Seed & 2) ? 0x7FFFFFFF : 0xFFFFFFFF) -
+                         (timer_test_rand() % (60 * 32768));
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        timer_test_states[i].psModel->pfnInit();
+        memset(timer_test_states[i].pui32Starts, 0, sizeof(timer_test_states[i].pui32Starts));
+        memset(timer_test_states[i].pbRunning, 0, sizeof(timer_test_states[i].pbRunning));
+        timer_test_states[i].ui32Fires = 0;
+    }
+
+    for (timer_test_operation = 0; timer_test_operation < TIMER_TEST_OPERATIONS;
+         timer_test_operation++)
+    {
+        uint32_t ui32Op = timer_test_rand() % 100;
+        uint32_t ui32Id = timer_test_rand() % TIMER_TEST_PARENTS;
+
+        if (ui32Op < 40)
+        {
+            uint32_t ui32Ms = timer_test_duration(timer_test_rand());
+
+            if (TIMER_TEST_PARENT(ui32Id) &&
+                psHeap->psModel->pfnIsStarted(TIMER_TEST_CHILD(ui32Id)))
+            {
+                continue;
+            }
+
+            timer_test_start(psHeap, ui32Id, ui32Ms);
+            timer_test_start(psList, ui32Id, ui32Ms);
+        }
+        else if (ui32Op < 55)
+        {
+            timer_test_stop(psHeap, ui32Id);
+            timer_test_stop(psList, ui32Id);
+        }
+        else if (ui32Op < 60)
+        {
+            uint32_t ui32Expected = TIMERTIME_T_MAX;
+
+            ui32Id = timer_test_rand() % TIMER_MODEL_TIMERS;
+            if (psHeap->pbRunning[ui32Id])
+            {
+                int32_t i32Remaining = (int32_t)(psHeap->pui32Expiry[ui32Id] - timer_test_counter);
+
+                ui32Expected = timer_test_tick2ms((i32Remaining > 0) ? (uint32_t)i32Remaining : 0);
+            }
+
+            if (psHeap->psModel->pfnRemaining(ui32Id) != ui32Expected)
+            {
+                timer_test_fail("heap", "reports a different remaining time", ui32Id);
+            }
+        }
+        else
+        {
+            timer_test_elapse(timer_test_rand() % ((ui32Op < 90) ? 3000 : 300000));
+        }
+
+        timer_test_check();
+
+        if (timer_test_failed)
+        {
+            return;
+        }
+    }
+
+    if (!timer_test_restart)
+    {
+        timer_test_compare_fires();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ui32First = 1;
+    uint32_t ui32Count = TIMER_TEST_SEQUENCES;
+    uint32_t ui32Fires = 0;
+
+    if (argc > 1)
+    {
+        ui32Count = strtoul(argv[1], NULL, 0);
+    }
+
+    if (argc > 2)
+    {
+        ui32First = strtoul(argv[2], NULL, 0);
+    }
+
+    for (uint32_t i = ui32First; i < ui32First + ui32Count; i++)
+    {
+        timer_test_sequence(i);
+        if (timer_test_failed)
+        {
+            return 1;
+        }
+        ui32Fires += timer_test_states[0].ui32Fires;
+    }
+
+    printf("timer: %u sequences, %u timers fired, heap and list agree\n", ui32Count, ui32Fires);
+
+    return 0;
+}
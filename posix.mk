@@ -0,0 +1,150 @@
+#******************************************************************************
+#
+# Host build of the application.
+#
+# Builds the application and the SDK for the posix target, which runs the
+# FreeRTOS task graph on host threads over a model of the Apollo3 and of the
+# radios.  The result is an executable for latency profiling and soak tests:
+#
+#   make -f posix.mk
+#   ./build/posix/debug/nmapp-dbg
+#
+# The SDK libraries are installed under the posix target and the objects are
+# kept apart from the firmware build under ./build/posix.
+#
+#******************************************************************************
+include application.mk
+
+TARGET := $(NMSDK)/targets/posix
+SRC    := $(filter-out startup_gcc.c,$(SRC)) startup_posix.c
+
+# Log tokens are offsets into the .log_fmt section of the firmware ELF file,
+# which the host build does not have; the host logs text.
+DEFINES := $(filter-out -DLOG_TOKENIZED,$(DEFINES))
+
+SDK_ROOT := $(NMSDK)
+include $(TARGET)/makedefs/common.mk
+include $(TARGET)/makedefs/defs_hal.mk
+include $(TARGET)/makedefs/defs_rtos.mk
+include $(TARGET)/makedefs/defs_lorawan.mk
+include $(TARGET)/makedefs/defs_ble.mk
+include $(TARGET)/makedefs/includes_hal.mk
+include $(TARGET)/makedefs/includes_rtos.mk
+include $(TARGET)/makedefs/includes_lorawan.mk
+include $(TARGET)/makedefs/includes_ble.mk
+
+BUILDDIR_DBG := ./build/posix/debug
+BUILDDIR_REL := ./build/posix/release
+
+BSP_GENERATOR := ./tools/bsp_generator/pinconfig.py
+
+BSP_H := $(BSP_DIR)/am_bsp_pins.h
+BSP_C := $(BSP_DIR)/am_bsp_pins.c
+
+INCLUDES += -I$(BSP_DIR)
+VPATH    += $(BSP_DIR)
+SRC += am_bsp_pins.c
+
+INCLUDES += -I./bsp
+VPATH    += ./bsp
+SRC += am_bsp.c
+
+CFLAGS_DBG += $(INCLUDES) $(HAL_INC) $(RTOS_INC) $(LORAWAN_INC) $(BLE_INC)
+CFLAGS_REL += $(INCLUDES) $(HAL_INC) $(RTOS_INC) $(LORAWAN_INC) $(BLE_INC)
+
+LIBS_DBG += $(HAL_LIB_DBG)
+LIBS_DBG += $(RTOS_LIB_DBG)
+LIBS_DBG += $(LORAWAN_LIB_DBG)
+LIBS_DBG += $(BLE_LIB_DBG)
+SDK_LIBS_DBG = $(LIBS_DBG:%.a=$(TARGET)/lib/%.a)
+
+LFLAGS_DBG += $(LFLAGS)
+LFLAGS_DBG += -Wl,--start-group
+LFLAGS_DBG += -L$(TARGET)/lib
+LFLAGS_DBG += $(patsubst lib%.a,-l%,$(subst :, , $(LIBS_DBG)))
+LFLAGS_DBG += -Wl,--end-group
+LFLAGS_DBG += -lm
+
+LIBS_REL += $(HAL_LIB_REL)
+LIBS_REL += $(RTOS_LIB_REL)
+LIBS_REL += $(LORAWAN_LIB_REL)
+LIBS_REL += $(BLE_LIB_REL)
+SDK_LIBS_REL = $(LIBS_REL:%.a=$(TARGET)/lib/%.a)
+
+LFLAGS_REL += $(LFLAGS)
+LFLAGS_REL += -Wl,--start-group
+LFLAGS_REL += -L$(TARGET)/lib
+LFLAGS_REL += $(patsubst lib%.a,-l%,$(subst :, , $(LIBS_REL)))
+LFLAGS_REL += -Wl,--end-group
+LFLAGS_REL += -lm
+
+SDK_CONFIGS += FREERTOS_CONFIG=$(FREERTOS_CONFIG)
+SDK_CONFIGS += LORAWAN_CONFIG=$(LORAWAN_CONFIG)
+SDK_CONFIGS += BLE_CONFIG=$(BLE_CONFIG)
+SDK_CONFIGS += RTOS_HEAP=$(RTOS_HEAP)
+
+all: debug release
+
+nmsdk:
+	$(MAKE) -C $(TARGET) install $(SDK_CONFIGS)
+
+#
+# The SDK libraries are installed by the nmsdk target.  Both goals build it
+# first, so that a parallel make links against the installed libraries.
+#
+$(SDK_LIBS_DBG) $(SDK_LIBS_REL): nmsdk
+
+bsp: $(BSP_H) $(BSP_C)
+
+$(BSP_H): $(BSP_SRC)
+	$(PYTHON) $(BSP_GENERATOR) $< h > $@
+
+$(BSP_C): $(BSP_SRC)
+	$(PYTHON) $(BSP_GENERATOR) $< c > $@
+
+OBJS_DBG += $(SRC:%.c=$(BUILDDIR_DBG)/%.o)
+DEPS_DBG += $(SRC:%.c=$(BUILDDIR_DBG)/%.d)
+OUTPUT_DBG := $(BUILDDIR_DBG)/$(OUTPUT)$(SUFFIX_DBG)
+
+debug: nmsdk bsp $(BUILDDIR_DBG) $(OUTPUT_DBG)
+
+$(BUILDDIR_DBG):
+	$(MKDIR) -p "$@"
+
+$(OUTPUT_DBG): $(OBJS_DBG) $(SDK_LIBS_DBG)
+	$(CC) -o $@ $(OBJS_DBG) $(LFLAGS_DBG)
+
+$(OBJS_DBG): $(BUILDDIR_DBG)/%.o : %.c | $(BUILDDIR_DBG) bsp
+	$(CC) -c $(CFLAGS_DBG) $< -o $@
+
+OBJS_REL += $(SRC:%.c=$(BUILDDIR_REL)/%.o)
+DEPS_REL += $(SRC:%.c=$(BUILDDIR_REL)/%.d)
+OUTPUT_REL := $(BUILDDIR_REL)/$(OUTPUT)$(SUFFIX_REL)
+
+release: nmsdk bsp $(BUILDDIR_REL) $(OUTPUT_REL)
+
+$(BUILDDIR_REL):
+	$(MKDIR) -p "$@"
+
+$(OUTPUT_REL): $(OBJS_REL) $(SDK_LIBS_REL)
+	$(CC) -o $@ $(OBJS_REL) $(LFLAGS_REL)
+
+$(OBJS_REL): $(BUILDDIR_REL)/%.o : %.c | $(BUILDDIR_REL) bsp
+	$(CC) -c $(CFLAGS_REL) $< -o $@
+
+clean-sdk:
+	$(MAKE) -C $(TARGET) uninstall
+	$(MAKE) -C $(TARGET) clean
+
+clean-debug:
+	$(RM) -rf $(BUILDDIR_DBG)
+
+clean-release:
+	$(RM) -rf $(BUILDDIR_REL)
+
+clean:
+	$(RM) -rf ./build/posix
+
+-include $(DEPS_DBG) $(DEPS_REL)
+
+.PHONY: all debug release nmsdk bsp clean clean-sdk clean-debug clean-release
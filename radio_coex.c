@@ -0,0 +1,188 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <LoRaMac.h>
+
+#include "coex_config.h"
+#include "radio_coex.h"
+
+//
+// The LoRaWAN MAC opens its receive windows from the STIMER interrupt, but
+// the end of a transmission and the end of a receive window are picked up
+// by the LoRaWAN task.  Both radio tasks share a priority and time slicing
+// is disabled, so a long BLE host dispatch (an ECC computation, a burst of
+// ATT traffic) delays the LoRaWAN task until the BLE task blocks.
+//
+// Before the LoRaWAN task blocks it reports the time to its next radio
+// deadline.  Within COEX_GUARD_MS of it the arbiter raises the LoRaWAN task
+// above the BLE task and holds back the BLE host dispatch, bounded by
+// COEX_BLE_DEFER_MAX_MS, until the MAC has handled the radio operation.
+//
+static TaskHandle_t radio_coex_lorawan_task;
+static UBaseType_t radio_coex_lorawan_priority;
+static TaskHandle_t radio_coex_ble_task;
+
+static volatile bool radio_coex_active;
+static TickType_t radio_coex_start;
+
+static bool radio_coex_ble_deferring;
+static TickType_t radio_coex_ble_defer_start;
+
+static radio_coex_statistics_t radio_coex_statistics;
+
+void radio_coex_lorawan_register(TaskHandle_t xTask)
+{
+    radio_coex_lorawan_task = xTask;
+    radio_coex_lorawan_priority = uxTaskPriorityGet(xTask);
+}
+
+void radio_coex_ble_register(TaskHandle_t xTask)
+{
+    radio_coex_ble_task = xTask;
+}
+
+//
+// Called by the LoRaWAN task before it blocks with the time in ms to the
+// next MAC radio deadline.  Returns the longest time the task may block
+// before the arbiter needs to see it again.
+//
+TickType_t radio_coex_lorawan_deadline(uint32_t ui32Delay)
+{
+    TickType_t xNow = xTaskGetTickCount();
+
+    if (ui32Delay <= COEX_GUARD_MS)
+    {
+        if (!radio_coex_active)
+        {
+            taskENTER_CRITICAL();
+            radio_coex_active = true;
+            radio_coex_start = xNow;
+            radio_coex_statistics.ui32Windows++;
+            taskEXIT_CRITICAL();
+
+            vTaskPrioritySet(radio_coex_lorawan_task, COEX_LORAWAN_BOOST_PRIORITY);
+        }
+
+        // the radio and timer interrupts wake the task from here on
+        return portMAX_DELAY;
+    }
+
+    if (radio_coex_active)
+    {
+        taskENTER_CRITICAL();
+        radio_coex_active = false;
+        radio_coex_statistics.ui32ProtectedMs += (xNow - radio_coex_start) * portTICK_PERIOD_MS;
+        taskEXIT_CRITICAL();
+
+        vTaskPrioritySet(radio_coex_lorawan_task, radio_coex_lorawan_priority);
+
+        // resume the held back BLE work
+        if (radio_coex_ble_task)
+        {
+            xTaskNotify(radio_coex_ble_task, 0, eNoAction);
+        }
+    }
+
+    if (ui32Delay == UINT32_MAX)
+    {
+        return portMAX_DELAY;
+    }
+
+    return (ui32Delay - COEX_GUARD_MS) / portTICK_PERIOD_MS;
+}
+
+//
+// Called by the BLE task before each host dispatch.  Returns zero when the
+// dispatch may run, otherwise the time to wait before asking again.
+//
+TickType_t radio_coex_ble_defer(void)
+{
+    TickType_t xNow = xTaskGetTickCount();
+    TickType_t xHeld;
+
+    if (!radio_coex_active)
+    {
+        radio_coex_ble_deferring = false;
+        return 0;
+    }
+
+    if (!radio_coex_ble_deferring)
+    {
+        radio_coex_ble_deferring = true;
+        radio_coex_ble_defer_start = xNow;
+
+        taskENTER_CRITICAL();
+        radio_coex_statistics.ui32Deferred++;
+        taskEXIT_CRITICAL();
+    }
+
+    xHeld = xNow - radio_coex_ble_defer_start;
+    if (xHeld >= pdMS_TO_TICKS(COEX_BLE_DEFER_MAX_MS))
+    {
+        // let one dispatch through before holding back again
+        radio_coex_ble_deferring = false;
+
+        taskENTER_CRITICAL();
+        radio_coex_statistics.ui32Forced++;
+        taskEXIT_CRITICAL();
+
+        return 0;
+    }
+
+    return pdMS_TO_TICKS(COEX_BLE_DEFER_MAX_MS) - xHeld;
+}
+
+bool radio_coex_protected(void)
+{
+    return radio_coex_active;
+}
+
+void radio_coex_get_statistics(radio_coex_statistics_t *pStatistics)
+{
+    LoRaMacRxWindowStats_t sRxWindow;
+
+    LoRaMacGetRxWindowStats(&sRxWindow);
+
+    taskENTER_CRITICAL();
+    memcpy(pStatistics, &radio_coex_statistics, sizeof(radio_coex_statistics_t));
+    taskEXIT_CRITICAL();
+
+    pStatistics->ui32RxOpened = sRxWindow.Opened;
+    pStatistics->ui32RxMissed = sRxWindow.Missed;
+    pStatistics->ui32RxMaxLate = sRxWindow.MaxLate;
+}
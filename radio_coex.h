@@ -0,0 +1,69 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _RADIO_COEX_H_
+#define _RADIO_COEX_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t ui32Windows;       // protected windows entered
+    uint32_t ui32Deferred;      // BLE dispatches held back
+    uint32_t ui32Forced;        // deferrals cut short by COEX_BLE_DEFER_MAX_MS
+    uint32_t ui32ProtectedMs;   // total time spent protected
+    uint32_t ui32RxOpened;      // LoRaWAN class A windows opened
+    uint32_t ui32RxMissed;      // windows opened too late to catch a downlink
+    uint32_t ui32RxMaxLate;     // worst window lateness in ms
+} radio_coex_statistics_t;
+
+extern void radio_coex_lorawan_register(TaskHandle_t xTask);
+extern void radio_coex_ble_register(TaskHandle_t xTask);
+
+extern TickType_t radio_coex_lorawan_deadline(uint32_t ui32Delay);
+extern TickType_t radio_coex_ble_defer(void);
+
+extern bool radio_coex_protected(void);
+extern void radio_coex_get_statistics(radio_coex_statistics_t *pStatistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <FreeRTOS_CLI.h>
+
+#include "radio_coex.h"
+#include "radio_coex_cli.h"
+
+static portBASE_TYPE
+radio_coex_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command);
+
+static CLI_Command_Definition_t radio_coex_cli_definition = {
+    (const char *const) "coex",
+    (const char *const) "coex   :  LoRaWAN and BLE Coexistence Statistics.\r\n",
+    radio_coex_cli_entry,
+    -1};
+
+static size_t argc;
+static char *argv[8];
+static char argz[128];
+
+void radio_coex_cli_register()
+{
+    FreeRTOS_CLIRegisterCommand(&radio_coex_cli_definition);
+    argc = 0;
+}
+
+static void help(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    strcat(pui8OutBuffer, "\r\nusage: coex [command]\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "without a command the arbiter statistics are shown.\r\n");
+}
+
+static void radio_coex_cli_show(char *pui8OutBuffer)
+{
+    radio_coex_statistics_t sStatistics;
+
+    radio_coex_get_statistics(&sStatistics);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nState       : %s\r\n"
+                          "Windows     : %d (%d ms protected)\r\n"
+                          "BLE held    : %d (%d forced)\r\n"
+                          "RX windows  : %d opened, %d missed\r\n"
+                          "Worst late  : %d ms\r\n",
+                          radio_coex_protected() ? "protected" : "idle",
+                          sStatistics.ui32Windows,
+                          sStatistics.ui32ProtectedMs,
+                          sStatistics.ui32Deferred,
+                          sStatistics.ui32Forced,
+                          sStatistics.ui32RxOpened,
+                          sStatistics.ui32RxMissed,
+                          sStatistics.ui32RxMaxLate);
+}
+
+static portBASE_TYPE
+radio_coex_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
+{
+    pui8OutBuffer[0] = 0;
+
+    strcpy(argz, pui8Command);
+    FreeRTOS_CLIExtractParameters(argz, &argc, argv);
+
+    if (argc == 1)
+    {
+        radio_coex_cli_show(pui8OutBuffer);
+    }
+    else
+    {
+        help(pui8OutBuffer, argc, argv);
+    }
+
+    return pdFALSE;
+}
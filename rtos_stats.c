@@ -0,0 +1,102 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+
+#include "rtos_stats.h"
+
+static rtos_stats_isr_t rtos_stats_isr[RTOS_STATS_ISR_VECTORS];
+
+void rtos_stats_init(void)
+{
+    memset(rtos_stats_isr, 0, sizeof(rtos_stats_isr));
+
+    //
+    // The DWT cycle counter gives the ISR timing the resolution that the
+    // 32kHz run time counter lacks.
+    //
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void rtos_stats_isr_get(uint32_t ui32Vector, rtos_stats_isr_t *psStats)
+{
+    if (ui32Vector >= RTOS_STATS_ISR_VECTORS)
+    {
+        memset(psStats, 0, sizeof(rtos_stats_isr_t));
+        return;
+    }
+
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+    *psStats = rtos_stats_isr[ui32Vector];
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void rtos_stats_isr_clear_max(void)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+    for (uint32_t i = 0; i < RTOS_STATS_ISR_VECTORS; i++)
+    {
+        rtos_stats_isr[i].ui32CyclesMax = 0;
+    }
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+#ifdef ISR_PROFILING
+extern void (*const g_am_pfnPeripheralHandlers[])(void);
+
+//
+// Common entry for all peripheral vectors.  Each vector only ever updates its
+// own entry and cannot preempt itself so no locking is needed here.  The time
+// of a nested higher priority interrupt is included in the preempted one.
+//
+void am_isr_profile(void)
+{
+    uint32_t ui32Vector = (__get_IPSR() - 16) & (RTOS_STATS_ISR_VECTORS - 1);
+    rtos_stats_isr_t *psStats = &rtos_stats_isr[ui32Vector];
+    uint32_t ui32Start = DWT->CYCCNT;
+
+    g_am_pfnPeripheralHandlers[ui32Vector]();
+
+    uint32_t ui32Cycles = DWT->CYCCNT - ui32Start;
+
+    psStats->ui32Count++;
+    psStats->ui64Cycles += ui32Cycles;
+    if (ui32Cycles > psStats->ui32CyclesMax)
+    {
+        psStats->ui32CyclesMax = ui32Cycles;
+    }
+}
+#endif
@@ -0,0 +1,479 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <FreeRTOS_CLI.h>
+#include <task.h>
+
+#include "rtos_stats.h"
+#include "rtos_stats_cli.h"
+#include "stimer_mux.h"
+
+#define RTOS_STATS_CLI_MAX_TASKS 12
+
+#define RTOS_STATS_CLI_HEAP_SLOTS      32
+#define RTOS_STATS_CLI_HEAP_OPERATIONS 1024
+#define RTOS_STATS_CLI_HEAP_RESERVE    4096
+
+static portBASE_TYPE
+rtos_stats_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command);
+
+static CLI_Command_Definition_t rtos_stats_cli_definition = {
+    (const char *const) "top",
+    (const char *const) "top    :  Task, Heap, Sleep, Interrupt and Timer Statistics.\r\n",
+    rtos_stats_cli_entry,
+    -1};
+
+static size_t argc;
+static char *argv[8];
+static char argz[128];
+
+static const char *rtos_stats_isr_names[RTOS_STATS_ISR_VECTORS] = {
+    "BROWNOUT", "WATCHDOG", "RTC",     "VCOMP",   "IOS",     "IOSACC",  "IOM0",    "IOM1",
+    "IOM2",     "IOM3",     "IOM4",    "IOM5",    "BLE",     "GPIO",    "CTIMER",  "UART0",
+    "UART1",    "SCARD",    "ADC",     "PDM",     "MSPI0",   "SW0",     "STIMER",  "STIMER0",
+    "STIMER1",  "STIMER2",  "STIMER3", "STIMER4", "STIMER5", "STIMER6", "STIMER7", "CLKGEN",
+};
+
+static const char *rtos_stats_cli_timer_names[STIMER_MUX_CLIENTS] = {
+    "RTOS", "LORAWAN", "WSF",
+};
+
+//
+// Snapshot of the previous invocation.  Every figure is reported as the
+// difference against it so "top" shows the activity since it was last run.
+//
+typedef struct
+{
+    UBaseType_t uxTaskNumber;
+    uint32_t ui32RunTime;
+} rtos_stats_cli_task_t;
+
+static TaskStatus_t rtos_stats_cli_status[RTOS_STATS_CLI_MAX_TASKS];
+static rtos_stats_cli_task_t rtos_stats_cli_tasks[RTOS_STATS_CLI_MAX_TASKS];
+static rtos_stats_isr_t rtos_stats_cli_isr[RTOS_STATS_ISR_VECTORS];
+static uint32_t rtos_stats_cli_timestamp;
+static uint32_t rtos_stats_cli_switches;
+static uint32_t rtos_stats_cli_sleep;
+static stimer_mux_stats_t rtos_stats_cli_timer;
+
+void rtos_stats_cli_register()
+{
+    FreeRTOS_CLIRegisterCommand(&rtos_stats_cli_definition);
+    argc = 0;
+}
+
+static void help(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    strcat(pui8OutBuffer, "\r\nusage: top [command]\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "without a command the statistics since the previous\r\n");
+    strcat(pui8OutBuffer, "invocation are shown.\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "supported commands are:\r\n");
+    strcat(pui8OutBuffer, "  heap     heap usage and fragmentation\r\n");
+    strcat(pui8OutBuffer, "  heap bench\r\n");
+    strcat(pui8OutBuffer, "           time a replayed allocation trace\r\n");
+    strcat(pui8OutBuffer, "  reset    clear the worst case interrupt times\r\n");
+}
+
+static void rtos_stats_cli_append(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *line)
+{
+    if (strlen(pui8OutBuffer) + strlen(line) < ui32OutBufferLength)
+    {
+        strcat(pui8OutBuffer, line);
+    }
+}
+
+static uint32_t rtos_stats_cli_permille(uint32_t ui32Part, uint32_t ui32Total)
+{
+    if (ui32Total == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)ui32Part * 1000) / ui32Total);
+}
+
+static uint32_t rtos_stats_cli_last_runtime(UBaseType_t uxTaskNumber)
+{
+    for (uint32_t i = 0; i < RTOS_STATS_CLI_MAX_TASKS; i++)
+    {
+        if (rtos_stats_cli_tasks[i].uxTaskNumber == uxTaskNumber)
+        {
+            return rtos_stats_cli_tasks[i].ui32RunTime;
+        }
+    }
+
+    return 0;
+}
+
+static char rtos_stats_cli_state(eTaskState eState)
+{
+    switch (eState)
+    {
+    case eRunning:
+        return 'X';
+    case eReady:
+        return 'R';
+    case eBlocked:
+        return 'B';
+    case eSuspended:
+        return 'S';
+    default:
+        return 'D';
+    }
+}
+
+static void rtos_stats_cli_top(char *pui8OutBuffer, size_t ui32OutBufferLength)
+{
+    char line[80];
+    uint32_t ui32Total;
+    UBaseType_t uxCount;
+    TaskHandle_t xIdle = xTaskGetIdleTaskHandle();
+
+    uint32_t ui32Switches = ulPortContextSwitchCount;
+    uint32_t ui32Sleep = ulPortSleepTime;
+    uxCount = uxTaskGetSystemState(rtos_stats_cli_status, RTOS_STATS_CLI_MAX_TASKS, &ui32Total);
+
+    uint32_t ui32Interval = ui32Total - rtos_stats_cli_timestamp;
+    uint32_t ui32Idle = 0;
+    uint32_t ui32Seconds = ui32Interval / configSTIMER_CLOCK_HZ;
+
+    for (UBaseType_t i = 0; i < uxCount; i++)
+    {
+        if (rtos_stats_cli_status[i].xHandle == xIdle)
+        {
+            ui32Idle = rtos_stats_cli_status[i].ulRunTimeCounter -
+                       rtos_stats_cli_last_runtime(rtos_stats_cli_status[i].xTaskNumber);
+        }
+    }
+
+    uint32_t ui32Cpu = 1000 - rtos_stats_cli_permille(ui32Idle, ui32Interval);
+    uint32_t ui32SleepPermille = rtos_stats_cli_permille(ui32Sleep - rtos_stats_cli_sleep, ui32Interval);
+    uint32_t ui32SwitchRate = ui32Seconds ? (ui32Switches - rtos_stats_cli_switches) / ui32Seconds
+                                          : ui32Switches - rtos_stats_cli_switches;
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nInterval %d s  CPU %d.%d%%  Sleep %d.%d%%  Switches %d/s\r\n",
+                          ui32Seconds,
+                          ui32Cpu / 10,
+                          ui32Cpu % 10,
+                          ui32SleepPermille / 10,
+                          ui32SleepPermille % 10,
+                          ui32SwitchRate);
+
+    rtos_stats_cli_append(
+        pui8OutBuffer, ui32OutBufferLength, "\r\nTask             Pri State  CPU%   Stack free\r\n");
+    for (UBaseType_t i = 0; i < uxCount; i++)
+    {
+        TaskStatus_t *psStatus = &rtos_stats_cli_status[i];
+        uint32_t ui32Permille = rtos_stats_cli_permille(
+            psStatus->ulRunTimeCounter - rtos_stats_cli_last_runtime(psStatus->xTaskNumber),
+            ui32Interval);
+
+        am_util_stdio_sprintf(line,
+                              "%-16s %-3d %c     %3d.%d   %d\r\n",
+                              psStatus->pcTaskName,
+                              psStatus->uxCurrentPriority,
+                              rtos_stats_cli_state(psStatus->eCurrentState),
+                              ui32Permille / 10,
+                              ui32Permille % 10,
+                              psStatus->usStackHighWaterMark * sizeof(StackType_t));
+        rtos_stats_cli_append(pui8OutBuffer, ui32OutBufferLength, line);
+    }
+
+#ifdef ISR_PROFILING
+    rtos_stats_cli_append(
+        pui8OutBuffer, ui32OutBufferLength, "\r\nISR          Count/s  Time us/s  Max us\r\n");
+    for (uint32_t i = 0; i < RTOS_STATS_ISR_VECTORS; i++)
+    {
+        rtos_stats_isr_t sIsr;
+
+        rtos_stats_isr_get(i, &sIsr);
+        if (sIsr.ui32Count == rtos_stats_cli_isr[i].ui32Count)
+        {
+            continue;
+        }
+
+        uint32_t ui32Count = sIsr.ui32Count - rtos_stats_cli_isr[i].ui32Count;
+        uint32_t ui32Micros = (uint32_t)((sIsr.ui64Cycles - rtos_stats_cli_isr[i].ui64Cycles) /
+                                         (configCPU_CLOCK_HZ / 1000000));
+
+        am_util_stdio_sprintf(line,
+                              "%-12s %-8d %-10d %d\r\n",
+                              rtos_stats_isr_names[i],
+                              ui32Seconds ? ui32Count / ui32Seconds : ui32Count,
+                              ui32Seconds ? ui32Micros / ui32Seconds : ui32Micros,
+                              sIsr.ui32CyclesMax / (configCPU_CLOCK_HZ / 1000000));
+        rtos_stats_cli_append(pui8OutBuffer, ui32OutBufferLength, line);
+
+        rtos_stats_cli_isr[i] = sIsr;
+    }
+#endif
+
+    //
+    // A wakeup is charged to the client whose deadline it was programmed
+    // for; the deadlines of other clients it served count as coalesced.
+    //
+    stimer_mux_stats_t sTimer;
+    stimer_mux_stats_get(&sTimer);
+
+    rtos_stats_cli_append(
+        pui8OutBuffer, ui32OutBufferLength, "\r\nTimer        Wakeups/s  Expiries/s  Coalesced\r\n");
+    for (uint32_t i = 0; i < STIMER_MUX_CLIENTS; i++)
+    {
+        uint32_t ui32Client = sTimer.pui32Wakeups[i] - rtos_stats_cli_timer.pui32Wakeups[i];
+        uint32_t ui32Expiries = sTimer.pui32Expiries[i] - rtos_stats_cli_timer.pui32Expiries[i];
+
+        am_util_stdio_sprintf(line,
+                              "%-12s %-10d %-11d %d\r\n",
+                              rtos_stats_cli_timer_names[i],
+                              ui32Seconds ? ui32Client / ui32Seconds : ui32Client,
+                              ui32Seconds ? ui32Expiries / ui32Seconds : ui32Expiries,
+                              sTimer.pui32Coalesced[i] - rtos_stats_cli_timer.pui32Coalesced[i]);
+        rtos_stats_cli_append(pui8OutBuffer, ui32OutBufferLength, line);
+    }
+
+    uint32_t ui32Wakeups = sTimer.ui32Wakeups - rtos_stats_cli_timer.ui32Wakeups;
+    am_util_stdio_sprintf(line,
+                          "%-12s %-10d %-11s %d backup\r\n",
+                          "Total",
+                          ui32Seconds ? ui32Wakeups / ui32Seconds : ui32Wakeups,
+                          "",
+                          sTimer.ui32Backup - rtos_stats_cli_timer.ui32Backup);
+    rtos_stats_cli_append(pui8OutBuffer, ui32OutBufferLength, line);
+    rtos_stats_cli_timer = sTimer;
+
+    for (UBaseType_t i = 0; i < RTOS_STATS_CLI_MAX_TASKS; i++)
+    {
+        rtos_stats_cli_tasks[i].uxTaskNumber = (i < uxCount) ? rtos_stats_cli_status[i].xTaskNumber : 0;
+        rtos_stats_cli_tasks[i].ui32RunTime = (i < uxCount) ? rtos_stats_cli_status[i].ulRunTimeCounter : 0;
+    }
+    rtos_stats_cli_timestamp = ui32Total;
+    rtos_stats_cli_switches = ui32Switches;
+    rtos_stats_cli_sleep = ui32Sleep;
+}
+
+static void rtos_stats_cli_heap(char *pui8OutBuffer, size_t ui32OutBufferLength)
+{
+    HeapStats_t sStats;
+
+    vPortGetHeapStats(&sStats);
+
+    //
+    // Fragmentation is the share of the free memory that cannot be handed
+    // out in a single allocation.
+    //
+    uint32_t ui32Fragmentation = 0;
+    if (sStats.xAvailableHeapSpaceInBytes)
+    {
+        ui32Fragmentation = 1000 - rtos_stats_cli_permille(sStats.xSizeOfLargestFreeBlockInBytes,
+                                                           sStats.xAvailableHeapSpaceInBytes);
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nHeap size      %d\r\n"
+                          "Free           %d\r\n"
+                          "Minimum free   %d\r\n"
+                          "Largest block  %d\r\n"
+                          "Smallest block %d\r\n"
+                          "Free blocks    %d\r\n"
+                          "Fragmentation  %d.%d%%\r\n"
+                          "Allocations    %d\r\n"
+                          "Frees          %d\r\n",
+                          configTOTAL_HEAP_SIZE,
+                          sStats.xAvailableHeapSpaceInBytes,
+                          sStats.xMinimumEverFreeBytesRemaining,
+                          sStats.xSizeOfLargestFreeBlockInBytes,
+                          sStats.xNumberOfFreeBlocks ? sStats.xSizeOfSmallestFreeBlockInBytes : 0,
+                          sStats.xNumberOfFreeBlocks,
+                          ui32Fragmentation / 10,
+                          ui32Fragmentation % 10,
+                          sStats.xNumberOfSuccessfulAllocations,
+                          sStats.xNumberOfSuccessfulFrees);
+}
+
+typedef struct
+{
+    uint32_t ui32Min;
+    uint32_t ui32Max;
+    uint32_t ui32Total;
+    uint32_t ui32Count;
+} rtos_stats_cli_cycles_t;
+
+static void rtos_stats_cli_cycles_add(rtos_stats_cli_cycles_t *psCycles, uint32_t ui32Cycles)
+{
+    if (ui32Cycles < psCycles->ui32Min)
+    {
+        psCycles->ui32Min = ui32Cycles;
+    }
+    if (ui32Cycles > psCycles->ui32Max)
+    {
+        psCycles->ui32Max = ui32Cycles;
+    }
+    psCycles->ui32Total += ui32Cycles;
+    psCycles->ui32Count++;
+}
+
+//
+// Replay a fixed pseudo-random trace of allocations and frees with the mixed
+// sizes typical of the stacks (mostly small buffers, a few large ones) and
+// time each call with interrupts off.  The trace is seeded identically every
+// run so heap_4 and heap_tlsf builds can be compared directly.
+//
+// The bench shares the heap with the running stacks.  An allocation is only
+// made if the largest free block keeps RTOS_STATS_CLI_HEAP_RESERVE bytes
+// beyond it, and is skipped otherwise, so the stacks keep room to allocate and
+// pvPortMalloc() never fails into the malloc failed hook.  The scheduler is
+// suspended from the check to the allocation so no other task gets between.
+//
+static void rtos_stats_cli_heap_bench(char *pui8OutBuffer, size_t ui32OutBufferLength)
+{
+    void *pvSlots[RTOS_STATS_CLI_HEAP_SLOTS];
+    rtos_stats_cli_cycles_t sMalloc = {UINT32_MAX, 0, 0, 0};
+    rtos_stats_cli_cycles_t sFree = {UINT32_MAX, 0, 0, 0};
+    HeapStats_t sHeapStats;
+    uint32_t ui32Seed = 0x2545F491;
+    uint32_t ui32Skipped = 0;
+    uint32_t ui32Start, ui32Cycles, ui32Critical;
+
+    memset(pvSlots, 0, sizeof(pvSlots));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t i = 0; i < RTOS_STATS_CLI_HEAP_OPERATIONS; i++)
+    {
+        ui32Seed = ui32Seed * 1664525 + 1013904223;
+
+        uint32_t ui32Slot = (ui32Seed >> 8) % RTOS_STATS_CLI_HEAP_SLOTS;
+        uint32_t ui32Size = 8 + ((ui32Seed >> 16) % ((ui32Seed & 0x7) ? 120 : 504));
+
+        if (pvSlots[ui32Slot])
+        {
+            ui32Critical = am_hal_interrupt_master_disable();
+            ui32Start = DWT->CYCCNT;
+            vPortFree(pvSlots[ui32Slot]);
+            ui32Cycles = DWT->CYCCNT - ui32Start;
+            am_hal_interrupt_master_set(ui32Critical);
+
+            pvSlots[ui32Slot] = NULL;
+            rtos_stats_cli_cycles_add(&sFree, ui32Cycles);
+            continue;
+        }
+
+        vTaskSuspendAll();
+
+        vPortGetHeapStats(&sHeapStats);
+        if (sHeapStats.xSizeOfLargestFreeBlockInBytes < ui32Size + RTOS_STATS_CLI_HEAP_RESERVE)
+        {
+            xTaskResumeAll();
+            ui32Skipped++;
+            continue;
+        }
+
+        ui32Critical = am_hal_interrupt_master_disable();
+        ui32Start = DWT->CYCCNT;
+        pvSlots[ui32Slot] = pvPortMalloc(ui32Size);
+        ui32Cycles = DWT->CYCCNT - ui32Start;
+        am_hal_interrupt_master_set(ui32Critical);
+
+        xTaskResumeAll();
+
+        if (pvSlots[ui32Slot])
+        {
+            rtos_stats_cli_cycles_add(&sMalloc, ui32Cycles);
+        }
+    }
+
+    for (uint32_t i = 0; i < RTOS_STATS_CLI_HEAP_SLOTS; i++)
+    {
+        vPortFree(pvSlots[i]);
+    }
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\ncycles per call (min / avg / max)\r\n"
+                          "pvPortMalloc : %d / %d / %d (%d calls, %d skipped)\r\n"
+                          "vPortFree    : %d / %d / %d (%d calls)\r\n",
+                          sMalloc.ui32Min,
+                          sMalloc.ui32Count ? sMalloc.ui32Total / sMalloc.ui32Count : 0,
+                          sMalloc.ui32Max,
+                          sMalloc.ui32Count,
+                          ui32Skipped,
+                          sFree.ui32Min,
+                          sFree.ui32Count ? sFree.ui32Total / sFree.ui32Count : 0,
+                          sFree.ui32Max,
+                          sFree.ui32Count);
+}
+
+portBASE_TYPE
+rtos_stats_cli_entry(char *pui8OutBuffer, size_t ui32OutBufferLength, const char *pui8Command)
+{
+    pui8OutBuffer[0] = 0;
+
+    strcpy(argz, pui8Command);
+    FreeRTOS_CLIExtractParameters(argz, &argc, argv);
+
+    if (argc == 1)
+    {
+        rtos_stats_cli_top(pui8OutBuffer, ui32OutBufferLength);
+    }
+    else if (strcmp(argv[1], "help") == 0)
+    {
+        help(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "heap") == 0)
+    {
+        if ((argc > 2) && (strcmp(argv[2], "bench") == 0))
+        {
+            rtos_stats_cli_heap_bench(pui8OutBuffer, ui32OutBufferLength);
+        }
+        else
+        {
+            rtos_stats_cli_heap(pui8OutBuffer, ui32OutBufferLength);
+        }
+    }
+    else if (strcmp(argv[1], "reset") == 0)
+    {
+        rtos_stats_isr_clear_max();
+    }
+
+    return pdFALSE;
+}
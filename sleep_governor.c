@@ -0,0 +1,357 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+
+#include <FreeRTOS.h>
+
+#include "stimer_mux.h"
+
+#include "energy_monitor.h"
+#include "sleep_config.h"
+#include "sleep_governor.h"
+
+//
+// Normal sleep only gates the core clock.  Deep sleep also stops the HFRC
+// and powers down the flash, so the core draws less but takes longer to
+// wake.  Deep sleep pays off once the idle time is long enough for the
+// current saved while asleep to make up for the extra wake time spent at
+// run current:
+//
+//   T_be = (L_deep - L_normal) * (I_run - I_deep) / (I_sleep - I_deep)
+//
+// The wake latencies are learned from the timer wakeups: the STIMER compare
+// is programmed for a known counter value and the counter is read again as
+// soon as the core is back.  The clocks and state a powered peripheral
+// needs restored add to that latency, so the latencies and T_be are kept
+// for each set of powered peripherals.  The currents are taken from the
+// energy monitor.
+//
+
+//
+// Latencies are kept in STIMER counts with this many fractional bits.
+//
+#define SLEEP_GOVERNOR_FRACTION 8
+
+static volatile sleep_policy_e sleep_governor_policy;
+
+static uint32_t sleep_governor_latency[SLEEP_PERIPH_SETS][SLEEP_MODE_MAX];
+static uint32_t sleep_governor_samples[SLEEP_PERIPH_SETS][SLEEP_MODE_MAX];
+static uint32_t sleep_governor_break_even[SLEEP_PERIPH_SETS];
+static uint32_t sleep_governor_latency_max;
+
+static uint32_t sleep_governor_sleeps[SLEEP_MODE_MAX];
+static uint32_t sleep_governor_early[SLEEP_MODE_MAX];
+static uint32_t sleep_governor_histogram[SLEEP_HISTOGRAM_BINS][SLEEP_MODE_MAX];
+
+//
+// The sleep in progress.
+//
+static sleep_mode_e sleep_governor_mode;
+static uint32_t sleep_governor_set;
+static uint32_t sleep_governor_start;
+static uint32_t sleep_governor_target;
+static bool sleep_governor_timed;
+
+static uint32_t sleep_governor_us_to_latency(uint32_t ui32Us)
+{
+    return (uint32_t)((((uint64_t)ui32Us * configSTIMER_CLOCK_HZ) << SLEEP_GOVERNOR_FRACTION) /
+                      1000000);
+}
+
+static uint32_t sleep_governor_latency_to_us(uint32_t ui32Latency)
+{
+    return (uint32_t)((((uint64_t)ui32Latency * 1000000) / configSTIMER_CLOCK_HZ) >>
+                      SLEEP_GOVERNOR_FRACTION);
+}
+
+static uint32_t sleep_governor_counts_to_us(uint32_t ui32Counts)
+{
+    uint64_t ui64Us = (uint64_t)ui32Counts * 1000000 / configSTIMER_CLOCK_HZ;
+
+    return (ui64Us > UINT32_MAX) ? UINT32_MAX : (uint32_t)ui64Us;
+}
+
+static uint32_t sleep_governor_periph_set(void)
+{
+    uint32_t ui32Set = 0;
+    uint32_t ui32Enabled;
+
+    if ((am_hal_pwrctrl_periph_enabled(SLEEP_RADIO_PERIPH, &ui32Enabled) ==
+         AM_HAL_STATUS_SUCCESS) &&
+        ui32Enabled)
+    {
+        ui32Set |= SLEEP_PERIPH_RADIO;
+    }
+
+    if ((am_hal_pwrctrl_periph_enabled(SLEEP_CONSOLE_PERIPH, &ui32Enabled) ==
+         AM_HAL_STATUS_SUCCESS) &&
+        ui32Enabled)
+    {
+        ui32Set |= SLEEP_PERIPH_CONSOLE;
+    }
+
+    return ui32Set;
+}
+
+//
+// Recompute the break-even idle time, in STIMER counts, of a peripheral
+// set.
+//
+static void sleep_governor_break_even_update(uint32_t ui32Set)
+{
+    uint32_t ui32Run = energy_monitor_current_get(ENERGY_SUBSYSTEM_MCU, ENERGY_MCU_RUN);
+    uint32_t ui32Sleep = energy_monitor_current_get(ENERGY_SUBSYSTEM_MCU, ENERGY_MCU_SLEEP);
+    uint32_t ui32Deep = energy_monitor_current_get(ENERGY_SUBSYSTEM_MCU, ENERGY_MCU_DEEP_SLEEP);
+    uint32_t ui32Extra = 0;
+    uint64_t ui64BreakEven;
+
+    if (ui32Sleep <= ui32Deep)
+    {
+        sleep_governor_break_even[ui32Set] = UINT32_MAX;
+        return;
+    }
+
+    if (ui32Run < ui32Sleep)
+    {
+        ui32Run = ui32Sleep;
+    }
+
+    if (sleep_governor_latency[ui32Set][SLEEP_MODE_DEEP] >
+        sleep_governor_latency[ui32Set][SLEEP_MODE_NORMAL])
+    {
+        ui32Extra = sleep_governor_latency[ui32Set][SLEEP_MODE_DEEP] -
+                    sleep_governor_latency[ui32Set][SLEEP_MODE_NORMAL];
+    }
+
+    ui64BreakEven = (uint64_t)ui32Extra * (ui32Run - ui32Deep) / (ui32Sleep - ui32Deep);
+    ui64BreakEven >>= SLEEP_GOVERNOR_FRACTION;
+
+    sleep_governor_break_even[ui32Set] =
+        (ui64BreakEven > UINT32_MAX) ? UINT32_MAX : (uint32_t)ui64BreakEven;
+}
+
+static void sleep_governor_learn(uint32_t ui32Latency)
+{
+    uint32_t *pui32Latency = &sleep_governor_latency[sleep_governor_set][sleep_governor_mode];
+    uint32_t *pui32Samples = &sleep_governor_samples[sleep_governor_set][sleep_governor_mode];
+
+    ui32Latency <<= SLEEP_GOVERNOR_FRACTION;
+
+    //
+    // The first measurement replaces the assumed latency; later ones are
+    // averaged in.
+    //
+    if (*pui32Samples == 0)
+    {
+        *pui32Latency = ui32Latency;
+    }
+    else
+    {
+        int32_t i32Error = (int32_t)ui32Latency - (int32_t)*pui32Latency;
+        *pui32Latency += i32Error / (1 << SLEEP_LATENCY_SHIFT);
+    }
+    (*pui32Samples)++;
+
+    sleep_governor_break_even_update(sleep_governor_set);
+}
+
+static uint32_t sleep_governor_histogram_bin(uint32_t ui32Counts)
+{
+    uint32_t ui32Ms = (uint32_t)((uint64_t)ui32Counts * 1000 / configSTIMER_CLOCK_HZ);
+    uint32_t ui32Bin;
+
+    if (ui32Ms == 0)
+    {
+        return 0;
+    }
+
+    ui32Bin = 32 - __builtin_clz(ui32Ms);
+
+    return (ui32Bin < SLEEP_HISTOGRAM_BINS) ? ui32Bin : SLEEP_HISTOGRAM_BINS - 1;
+}
+
+void sleep_governor_init(void)
+{
+    sleep_governor_policy = SLEEP_POLICY_AUTO;
+    sleep_governor_latency_max = sleep_governor_us_to_latency(SLEEP_LATENCY_MAX_US) >>
+                                 SLEEP_GOVERNOR_FRACTION;
+
+    for (uint32_t i = 0; i < SLEEP_PERIPH_SETS; i++)
+    {
+        sleep_governor_latency[i][SLEEP_MODE_NORMAL] = 0;
+        sleep_governor_latency[i][SLEEP_MODE_DEEP] =
+            sleep_governor_us_to_latency(SLEEP_DEEP_LATENCY_US);
+        sleep_governor_samples[i][SLEEP_MODE_NORMAL] = 0;
+        sleep_governor_samples[i][SLEEP_MODE_DEEP] = 0;
+        sleep_governor_break_even_update(i);
+    }
+
+    sleep_governor_clear_statistics();
+}
+
+void sleep_governor_sleep(uint32_t ui32IdleTicks)
+{
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+    uint32_t ui32Expected;
+    sleep_mode_e eMode;
+
+    //
+    // The STIMER compare bounds the sleep more closely than the idle ticks,
+    // which count from the last tick and round down.
+    //
+    sleep_governor_timed = stimer_mux_wakeup(&sleep_governor_target);
+    if (sleep_governor_timed)
+    {
+        int32_t i32Delta = (int32_t)(sleep_governor_target - ui32Now);
+        ui32Expected = (i32Delta > 0) ? (uint32_t)i32Delta : 0;
+    }
+    else
+    {
+        uint64_t ui64Expected =
+            (uint64_t)ui32IdleTicks * configSTIMER_CLOCK_HZ / configTICK_RATE_HZ;
+        ui32Expected = (ui64Expected > UINT32_MAX) ? UINT32_MAX : (uint32_t)ui64Expected;
+    }
+
+    sleep_governor_set = sleep_governor_periph_set();
+
+    switch (sleep_governor_policy)
+    {
+    case SLEEP_POLICY_NORMAL:
+        eMode = SLEEP_MODE_NORMAL;
+        break;
+    case SLEEP_POLICY_DEEP:
+        eMode = SLEEP_MODE_DEEP;
+        break;
+    default:
+        eMode = (ui32Expected > sleep_governor_break_even[sleep_governor_set])
+                    ? SLEEP_MODE_DEEP
+                    : SLEEP_MODE_NORMAL;
+        break;
+    }
+
+    sleep_governor_mode = eMode;
+    sleep_governor_start = ui32Now;
+    sleep_governor_sleeps[eMode]++;
+
+    if (eMode == SLEEP_MODE_DEEP)
+    {
+        energy_monitor_mcu_state(ENERGY_MCU_DEEP_SLEEP);
+        am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_DEEP);
+    }
+    else
+    {
+        energy_monitor_mcu_state(ENERGY_MCU_SLEEP);
+        am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_NORMAL);
+    }
+}
+
+void sleep_governor_wakeup(void)
+{
+    uint32_t ui32Now = am_hal_stimer_counter_get();
+    int32_t i32Late = (int32_t)(ui32Now - sleep_governor_target);
+
+    energy_monitor_mcu_state(ENERGY_MCU_RUN);
+
+    sleep_governor_histogram[sleep_governor_histogram_bin(ui32Now - sleep_governor_start)]
+                            [sleep_governor_mode]++;
+
+    //
+    // Only a wakeup by the compare measures the wake latency.  Anything
+    // that wakes the core before it, or long after it, is another
+    // interrupt.
+    //
+    if (!sleep_governor_timed || (i32Late < 0))
+    {
+        sleep_governor_early[sleep_governor_mode]++;
+    }
+    else if ((uint32_t)i32Late <= sleep_governor_latency_max)
+    {
+        sleep_governor_learn((uint32_t)i32Late);
+    }
+}
+
+void sleep_governor_policy_set(sleep_policy_e ePolicy)
+{
+    sleep_governor_policy = ePolicy;
+}
+
+sleep_policy_e sleep_governor_policy_get(void)
+{
+    return sleep_governor_policy;
+}
+
+void sleep_governor_get_statistics(sleep_governor_statistics_t *psStatistics)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    memcpy(psStatistics->pui32Sleeps, sleep_governor_sleeps, sizeof(sleep_governor_sleeps));
+    memcpy(psStatistics->pui32Early, sleep_governor_early, sizeof(sleep_governor_early));
+    memcpy(psStatistics->ppui32Histogram,
+           sleep_governor_histogram,
+           sizeof(sleep_governor_histogram));
+    memcpy(psStatistics->ppui32Samples, sleep_governor_samples, sizeof(sleep_governor_samples));
+
+    for (uint32_t i = 0; i < SLEEP_PERIPH_SETS; i++)
+    {
+        for (uint32_t j = 0; j < SLEEP_MODE_MAX; j++)
+        {
+            psStatistics->ppui32LatencyUs[i][j] =
+                sleep_governor_latency_to_us(sleep_governor_latency[i][j]);
+        }
+
+        //
+        // Pick up any change to the currents made since the last sample.
+        //
+        sleep_governor_break_even_update(i);
+        psStatistics->pui32BreakEvenUs[i] =
+            (sleep_governor_break_even[i] == UINT32_MAX)
+                ? UINT32_MAX
+                : sleep_governor_counts_to_us(sleep_governor_break_even[i]);
+    }
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
+
+void sleep_governor_clear_statistics(void)
+{
+    uint32_t ui32Critical = am_hal_interrupt_master_disable();
+
+    memset(sleep_governor_sleeps, 0, sizeof(sleep_governor_sleeps));
+    memset(sleep_governor_early, 0, sizeof(sleep_governor_early));
+    memset(sleep_governor_histogram, 0, sizeof(sleep_governor_histogram));
+
+    am_hal_interrupt_master_set(ui32Critical);
+}
@@ -0,0 +1,100 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _SLEEP_GOVERNOR_H_
+#define _SLEEP_GOVERNOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sleep_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    SLEEP_MODE_NORMAL,
+    SLEEP_MODE_DEEP,
+    SLEEP_MODE_MAX
+} sleep_mode_e;
+
+typedef enum
+{
+    SLEEP_POLICY_AUTO,
+    SLEEP_POLICY_NORMAL,
+    SLEEP_POLICY_DEEP,
+} sleep_policy_e;
+
+//
+// Peripherals powered at the time of a sleep, as a set of flags.  The wake
+// latency and the break-even point are learned for each set.
+//
+#define SLEEP_PERIPH_RADIO      (1 << 0)
+#define SLEEP_PERIPH_CONSOLE    (1 << 1)
+#define SLEEP_PERIPH_SETS       4
+
+typedef struct
+{
+    uint32_t pui32Sleeps[SLEEP_MODE_MAX];       // sleeps entered in each mode
+    uint32_t pui32Early[SLEEP_MODE_MAX];        // woken by an interrupt before the timer
+    uint32_t ppui32Histogram[SLEEP_HISTOGRAM_BINS][SLEEP_MODE_MAX];
+
+    uint32_t ppui32LatencyUs[SLEEP_PERIPH_SETS][SLEEP_MODE_MAX];
+    uint32_t ppui32Samples[SLEEP_PERIPH_SETS][SLEEP_MODE_MAX];
+    uint32_t pui32BreakEvenUs[SLEEP_PERIPH_SETS];  // UINT32_MAX if deep sleep never pays
+} sleep_governor_statistics_t;
+
+extern void sleep_governor_init(void);
+
+//
+// Called by the idle task with interrupts disabled.  Picks a sleep mode for
+// the expected idle time in RTOS ticks and sleeps.
+//
+extern void sleep_governor_sleep(uint32_t ui32IdleTicks);
+
+//
+// Called by the idle task on wakeup, before interrupts are enabled again.
+//
+extern void sleep_governor_wakeup(void);
+
+extern void sleep_governor_policy_set(sleep_policy_e ePolicy);
+extern sleep_policy_e sleep_governor_policy_get(void);
+
+extern void sleep_governor_get_statistics(sleep_governor_statistics_t *psStatistics);
+extern void sleep_governor_clear_statistics(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
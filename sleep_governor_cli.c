@@ -0,0 +1,226 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <am_mcu_apollo.h>
+#include <am_util.h>
+
+#include <FreeRTOS.h>
+#include <FreeRTOS_CLI.h>
+
+#include "sleep_governor.h"
+#include "sleep_governor_cli.h"
+
+static portBASE_TYPE sleep_governor_cli_entry(char *pui8OutBuffer,
+                                              size_t ui32OutBufferLength,
+                                              const char *pui8Command);
+
+static CLI_Command_Definition_t sleep_governor_cli_definition = {
+    (const char *const) "sleep",
+    (const char *const) "sleep  :  Sleep Mode Governor.\r\n",
+    sleep_governor_cli_entry,
+    -1};
+
+static size_t argc;
+static char *argv[8];
+static char argz[128];
+
+static const char *sleep_policy_names[] = {"auto", "normal", "deep"};
+
+static const char *sleep_periph_set_names[SLEEP_PERIPH_SETS] = {
+    "none", "radio", "console", "radio+console"};
+
+static sleep_governor_statistics_t sleep_governor_cli_statistics;
+
+void sleep_governor_cli_register()
+{
+    FreeRTOS_CLIRegisterCommand(&sleep_governor_cli_definition);
+    argc = 0;
+}
+
+static void help(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    strcat(pui8OutBuffer, "\r\nusage: sleep <command>\r\n");
+    strcat(pui8OutBuffer, "\r\n");
+    strcat(pui8OutBuffer, "supported commands are:\r\n");
+    strcat(pui8OutBuffer, "  show     sleeps, wake latencies and break-even points\r\n");
+    strcat(pui8OutBuffer, "  hist     idle durations by sleep mode\r\n");
+    strcat(pui8OutBuffer, "  policy   [auto|normal|deep] get or set the sleep mode policy\r\n");
+    strcat(pui8OutBuffer, "  clear    clear the sleep counts and the histogram\r\n");
+}
+
+static void sleep_governor_cli_show(char *pui8OutBuffer)
+{
+    sleep_governor_statistics_t *psStatistics = &sleep_governor_cli_statistics;
+    char line[80];
+
+    sleep_governor_get_statistics(psStatistics);
+
+    am_util_stdio_sprintf(pui8OutBuffer,
+                          "\r\nPolicy : %s\r\n"
+                          "Normal : %d sleeps (%d early)\r\n"
+                          "Deep   : %d sleeps (%d early)\r\n"
+                          "\r\nPowered        Normal us (n)    Deep us (n)      Break-even us\r\n",
+                          sleep_policy_names[sleep_governor_policy_get()],
+                          psStatistics->pui32Sleeps[SLEEP_MODE_NORMAL],
+                          psStatistics->pui32Early[SLEEP_MODE_NORMAL],
+                          psStatistics->pui32Sleeps[SLEEP_MODE_DEEP],
+                          psStatistics->pui32Early[SLEEP_MODE_DEEP]);
+
+    for (uint32_t i = 0; i < SLEEP_PERIPH_SETS; i++)
+    {
+        char normal[20];
+        char deep[20];
+
+        am_util_stdio_sprintf(normal,
+                              "%d (%d)",
+                              psStatistics->ppui32LatencyUs[i][SLEEP_MODE_NORMAL],
+                              psStatistics->ppui32Samples[i][SLEEP_MODE_NORMAL]);
+        am_util_stdio_sprintf(deep,
+                              "%d (%d)",
+                              psStatistics->ppui32LatencyUs[i][SLEEP_MODE_DEEP],
+                              psStatistics->ppui32Samples[i][SLEEP_MODE_DEEP]);
+
+        if (psStatistics->pui32BreakEvenUs[i] == UINT32_MAX)
+        {
+            am_util_stdio_sprintf(
+                line, "%-14s %-16s %-16s never\r\n", sleep_periph_set_names[i], normal, deep);
+        }
+        else
+        {
+            am_util_stdio_sprintf(line,
+                                  "%-14s %-16s %-16s %d\r\n",
+                                  sleep_periph_set_names[i],
+                                  normal,
+                                  deep,
+                                  psStatistics->pui32BreakEvenUs[i]);
+        }
+        strcat(pui8OutBuffer, line);
+    }
+}
+
+static void sleep_governor_cli_histogram(char *pui8OutBuffer)
+{
+    sleep_governor_statistics_t *psStatistics = &sleep_governor_cli_statistics;
+    char line[64];
+
+    sleep_governor_get_statistics(psStatistics);
+
+    strcpy(pui8OutBuffer, "\r\nIdle ms          Normal       Deep\r\n");
+
+    for (uint32_t i = 0; i < SLEEP_HISTOGRAM_BINS; i++)
+    {
+        char range[16];
+
+        if (i == 0)
+        {
+            strcpy(range, "< 1");
+        }
+        else if (i == 1)
+        {
+            strcpy(range, "1");
+        }
+        else if (i == SLEEP_HISTOGRAM_BINS - 1)
+        {
+            am_util_stdio_sprintf(range, ">= %d", 1 << (i - 1));
+        }
+        else
+        {
+            am_util_stdio_sprintf(range, "%d - %d", 1 << (i - 1), (1 << i) - 1);
+        }
+
+        am_util_stdio_sprintf(line,
+                              "%-14s %8d %10d\r\n",
+                              range,
+                              psStatistics->ppui32Histogram[i][SLEEP_MODE_NORMAL],
+                              psStatistics->ppui32Histogram[i][SLEEP_MODE_DEEP]);
+        strcat(pui8OutBuffer, line);
+    }
+}
+
+static void sleep_governor_cli_policy(char *pui8OutBuffer, size_t argc, char **argv)
+{
+    if (argc == 3)
+    {
+        for (uint32_t i = 0; i < sizeof(sleep_policy_names) / sizeof(sleep_policy_names[0]); i++)
+        {
+            if (strcmp(argv[2], sleep_policy_names[i]) == 0)
+            {
+                sleep_governor_policy_set((sleep_policy_e)i);
+                am_util_stdio_sprintf(pui8OutBuffer, "\r\nPolicy : %s\r\n", sleep_policy_names[i]);
+                return;
+            }
+        }
+
+        help(pui8OutBuffer, argc, argv);
+        return;
+    }
+
+    am_util_stdio_sprintf(
+        pui8OutBuffer, "\r\nPolicy : %s\r\n", sleep_policy_names[sleep_governor_policy_get()]);
+}
+
+static portBASE_TYPE sleep_governor_cli_entry(char *pui8OutBuffer,
+                                              size_t ui32OutBufferLength,
+                                              const char *pui8Command)
+{
+    pui8OutBuffer[0] = 0;
+
+    strcpy(argz, pui8Command);
+    FreeRTOS_CLIExtractParameters(argz, &argc, argv);
+
+    if ((argc == 1) || (strcmp(argv[1], "show") == 0))
+    {
+        sleep_governor_cli_show(pui8OutBuffer);
+    }
+    else if (strcmp(argv[1], "hist") == 0)
+    {
+        sleep_governor_cli_histogram(pui8OutBuffer);
+    }
+    else if (strcmp(argv[1], "policy") == 0)
+    {
+        sleep_governor_cli_policy(pui8OutBuffer, argc, argv);
+    }
+    else if (strcmp(argv[1], "clear") == 0)
+    {
+        sleep_governor_clear_statistics();
+    }
+    else
+    {
+        help(pui8OutBuffer, argc, argv);
+    }
+
+    return pdFALSE;
+}
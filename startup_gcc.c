@@ -98,6 +98,13 @@ extern void am_clkgen_isr(void)       __attribute ((weak, alias ("am_default_isr
 
 extern void am_default_isr(void)      __attribute ((weak));
 
+#ifdef ISR_PROFILING
+extern void am_isr_profile(void);
+#define ISR_VECTOR(handler)     am_isr_profile
+#else
+#define ISR_VECTOR(handler)     handler
+#endif
+
 //*****************************************************************************
 //
 // The entry point for the application.
@@ -147,6 +154,50 @@ void (* const g_am_pfnVectors[])(void) =
     //
     // Peripheral Interrupts
     //
+    ISR_VECTOR(am_brownout_isr),            //  0: Brownout (rstgen)
+    ISR_VECTOR(am_watchdog_isr),            //  1: Watchdog
+    ISR_VECTOR(am_rtc_isr),                 //  2: RTC
+    ISR_VECTOR(am_vcomp_isr),               //  3: Voltage Comparator
+    ISR_VECTOR(am_ioslave_ios_isr),         //  4: I/O Slave general
+    ISR_VECTOR(am_ioslave_acc_isr),         //  5: I/O Slave access
+    ISR_VECTOR(am_iomaster0_isr),           //  6: I/O Master 0
+    ISR_VECTOR(am_iomaster1_isr),           //  7: I/O Master 1
+    ISR_VECTOR(am_iomaster2_isr),           //  8: I/O Master 2
+    ISR_VECTOR(am_iomaster3_isr),           //  9: I/O Master 3
+    ISR_VECTOR(am_iomaster4_isr),           // 10: I/O Master 4
+    ISR_VECTOR(am_iomaster5_isr),           // 11: I/O Master 5
+    ISR_VECTOR(am_ble_isr),                 // 12: BLEIF
+    ISR_VECTOR(am_gpio_isr),                // 13: GPIO
+    ISR_VECTOR(am_ctimer_isr),              // 14: CTIMER
+    ISR_VECTOR(am_uart_isr),                // 15: UART0
+    ISR_VECTOR(am_uart1_isr),               // 16: UART1
+    ISR_VECTOR(am_scard_isr),               // 17: SCARD
+    ISR_VECTOR(am_adc_isr),                 // 18: ADC
+    ISR_VECTOR(am_pdm0_isr),                // 19: PDM
+    ISR_VECTOR(am_mspi0_isr),               // 20: MSPI0
+    ISR_VECTOR(am_software0_isr),           // 21: SOFTWARE0
+    ISR_VECTOR(am_stimer_isr),              // 22: SYSTEM TIMER
+    ISR_VECTOR(am_stimer_cmpr0_isr),        // 23: SYSTEM TIMER COMPARE0
+    ISR_VECTOR(am_stimer_cmpr1_isr),        // 24: SYSTEM TIMER COMPARE1
+    ISR_VECTOR(am_stimer_cmpr2_isr),        // 25: SYSTEM TIMER COMPARE2
+    ISR_VECTOR(am_stimer_cmpr3_isr),        // 26: SYSTEM TIMER COMPARE3
+    ISR_VECTOR(am_stimer_cmpr4_isr),        // 27: SYSTEM TIMER COMPARE4
+    ISR_VECTOR(am_stimer_cmpr5_isr),        // 28: SYSTEM TIMER COMPARE5
+    ISR_VECTOR(am_stimer_cmpr6_isr),        // 29: SYSTEM TIMER COMPARE6
+    ISR_VECTOR(am_stimer_cmpr7_isr),        // 30: SYSTEM TIMER COMPARE7
+    ISR_VECTOR(am_clkgen_isr),              // 31: CLKGEN
+};
+
+#ifdef ISR_PROFILING
+//*****************************************************************************
+//
+// With ISR_PROFILING defined every peripheral vector above points to
+// am_isr_profile(), which times the handler below that matches the active
+// vector.
+//
+//*****************************************************************************
+void (* const g_am_pfnPeripheralHandlers[])(void) =
+{
     am_brownout_isr,                        //  0: Brownout (rstgen)
     am_watchdog_isr,                        //  1: Watchdog
     am_rtc_isr,                             //  2: RTC
@@ -180,6 +231,7 @@ void (* const g_am_pfnVectors[])(void) =
     am_stimer_cmpr7_isr,                    // 30: SYSTEM TIMER COMPARE7
     am_clkgen_isr,                          // 31: CLKGEN
 };
+#endif
 
 //******************************************************************************
 //
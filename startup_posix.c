@@ -0,0 +1,233 @@
+/*
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2022, Northern Mechatronics, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+//*****************************************************************************
+//
+// Vector table of the host build.
+//
+// The host CPU emulation in the posix target runs the handlers of this table
+// for the pending exceptions, indexed by exception number as on the part.
+// The C runtime of the host initializes memory and calls main(), so there is
+// no reset handler, stack or patch table.
+//
+//*****************************************************************************
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "am_mcu_apollo.h"
+
+//*****************************************************************************
+//
+// Forward declaration of interrupt handlers.
+//
+//*****************************************************************************
+extern void NMI_Handler(void)         __attribute ((weak));
+extern void HardFault_Handler(void)   __attribute ((weak));
+extern void SVC_Handler(void)         __attribute ((weak, alias ("am_default_isr")));
+extern void DebugMon_Handler(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void PendSV_Handler(void)      __attribute ((weak, alias ("am_default_isr")));
+extern void SysTick_Handler(void)     __attribute ((weak, alias ("am_default_isr")));
+
+extern void am_brownout_isr(void)     __attribute ((weak, alias ("am_default_isr")));
+extern void am_watchdog_isr(void)     __attribute ((weak, alias ("am_default_isr")));
+extern void am_rtc_isr(void)          __attribute ((weak, alias ("am_default_isr")));
+extern void am_vcomp_isr(void)        __attribute ((weak, alias ("am_default_isr")));
+extern void am_ioslave_ios_isr(void)  __attribute ((weak, alias ("am_default_isr")));
+extern void am_ioslave_acc_isr(void)  __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster0_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster1_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster2_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster3_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster4_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_iomaster5_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_ble_isr(void)          __attribute ((weak, alias ("am_default_isr")));
+extern void am_gpio_isr(void)         __attribute ((weak, alias ("am_default_isr")));
+extern void am_ctimer_isr(void)       __attribute ((weak, alias ("am_default_isr")));
+extern void am_uart_isr(void)         __attribute ((weak, alias ("am_default_isr")));
+extern void am_uart1_isr(void)        __attribute ((weak, alias ("am_default_isr")));
+extern void am_scard_isr(void)        __attribute ((weak, alias ("am_default_isr")));
+extern void am_adc_isr(void)          __attribute ((weak, alias ("am_default_isr")));
+extern void am_pdm0_isr(void)         __attribute ((weak, alias ("am_default_isr")));
+extern void am_mspi0_isr(void)        __attribute ((weak, alias ("am_default_isr")));
+extern void am_software0_isr(void)    __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_isr(void)       __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr0_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr1_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr2_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr3_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr4_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr5_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr6_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_stimer_cmpr7_isr(void) __attribute ((weak, alias ("am_default_isr")));
+extern void am_clkgen_isr(void)       __attribute ((weak, alias ("am_default_isr")));
+
+extern void am_default_isr(void)      __attribute ((weak));
+
+#ifdef ISR_PROFILING
+extern void am_isr_profile(void);
+#define ISR_VECTOR(handler)     am_isr_profile
+#else
+#define ISR_VECTOR(handler)     handler
+#endif
+
+//*****************************************************************************
+//
+// The vector table.
+//
+//*****************************************************************************
+void (* const g_am_pfnVectors[])(void) =
+{
+    0,                                      // The initial stack pointer
+    0,                                      // The reset handler
+    NMI_Handler,                            // The NMI handler
+    HardFault_Handler,                      // The hard fault handler
+    HardFault_Handler,                      // The MemManage_Handler
+    HardFault_Handler,                      // The BusFault_Handler
+    HardFault_Handler,                      // The UsageFault_Handler
+    0,                                      // Reserved
+    0,                                      // Reserved
+    0,                                      // Reserved
+    0,                                      // Reserved
+    SVC_Handler,                            // SVCall handler
+    DebugMon_Handler,                       // Debug monitor handler
+    0,                                      // Reserved
+    PendSV_Handler,                         // The PendSV handler
+    SysTick_Handler,                        // The SysTick handler
+
+    //
+    // Peripheral Interrupts
+    //
+    ISR_VECTOR(am_brownout_isr),            //  0: Brownout (rstgen)
+    ISR_VECTOR(am_watchdog_isr),            //  1: Watchdog
+    ISR_VECTOR(am_rtc_isr),                 //  2: RTC
+    ISR_VECTOR(am_vcomp_isr),               //  3: Voltage Comparator
+    ISR_VECTOR(am_ioslave_ios_isr),         //  4: I/O Slave general
+    ISR_VECTOR(am_ioslave_acc_isr),         //  5: I/O Slave access
+    ISR_VECTOR(am_iomaster0_isr),           //  6: I/O Master 0
+    ISR_VECTOR(am_iomaster1_isr),           //  7: I/O Master 1
+    ISR_VECTOR(am_iomaster2_isr),           //  8: I/O Master 2
+    ISR_VECTOR(am_iomaster3_isr),           //  9: I/O Master 3
+    ISR_VECTOR(am_iomaster4_isr),           // 10: I/O Master 4
+    ISR_VECTOR(am_iomaster5_isr),           // 11: I/O Master 5
+    ISR_VECTOR(am_ble_isr),                 // 12: BLEIF
+    ISR_VECTOR(am_gpio_isr),                // 13: GPIO
+    ISR_VECTOR(am_ctimer_isr),              // 14: CTIMER
+    ISR_VECTOR(am_uart_isr),                // 15: UART0
+    ISR_VECTOR(am_uart1_isr),               // 16: UART1
+    ISR_VECTOR(am_scard_isr),               // 17: SCARD
+    ISR_VECTOR(am_adc_isr),                 // 18: ADC
+    ISR_VECTOR(am_pdm0_isr),                // 19: PDM
+    ISR_VECTOR(am_mspi0_isr),               // 20: MSPI0
+    ISR_VECTOR(am_software0_isr),           // 21: SOFTWARE0
+    ISR_VECTOR(am_stimer_isr),              // 22: SYSTEM TIMER
+    ISR_VECTOR(am_stimer_cmpr0_isr),        // 23: SYSTEM TIMER COMPARE0
+    ISR_VECTOR(am_stimer_cmpr1_isr),        // 24: SYSTEM TIMER COMPARE1
+    ISR_VECTOR(am_stimer_cmpr2_isr),        // 25: SYSTEM TIMER COMPARE2
+    ISR_VECTOR(am_stimer_cmpr3_isr),        // 26: SYSTEM TIMER COMPARE3
+    ISR_VECTOR(am_stimer_cmpr4_isr),        // 27: SYSTEM TIMER COMPARE4
+    ISR_VECTOR(am_stimer_cmpr5_isr),        // 28: SYSTEM TIMER COMPARE5
+    ISR_VECTOR(am_stimer_cmpr6_isr),        // 29: SYSTEM TIMER COMPARE6
+    ISR_VECTOR(am_stimer_cmpr7_isr),        // 30: SYSTEM TIMER COMPARE7
+    ISR_VECTOR(am_clkgen_isr),              // 31: CLKGEN
+};
+
+#ifdef ISR_PROFILING
+//*****************************************************************************
+//
+// With ISR_PROFILING defined every peripheral vector above points to
+// am_isr_profile(), which times the handler below that matches the active
+// vector.
+//
+//*****************************************************************************
+void (* const g_am_pfnPeripheralHandlers[])(void) =
+{
+    am_brownout_isr,                        //  0: Brownout (rstgen)
+    am_watchdog_isr,                        //  1: Watchdog
+    am_rtc_isr,                             //  2: RTC
+    am_vcomp_isr,                           //  3: Voltage Comparator
+    am_ioslave_ios_isr,                     //  4: I/O Slave general
+    am_ioslave_acc_isr,                     //  5: I/O Slave access
+    am_iomaster0_isr,                       //  6: I/O Master 0
+    am_iomaster1_isr,                       //  7: I/O Master 1
+    am_iomaster2_isr,                       //  8: I/O Master 2
+    am_iomaster3_isr,                       //  9: I/O Master 3
+    am_iomaster4_isr,                       // 10: I/O Master 4
+    am_iomaster5_isr,                       // 11: I/O Master 5
+    am_ble_isr,                             // 12: BLEIF
+    am_gpio_isr,                            // 13: GPIO
+    am_ctimer_isr,                          // 14: CTIMER
+    am_uart_isr,                            // 15: UART0
+    am_uart1_isr,                           // 16: UART1
+    am_scard_isr,                           // 17: SCARD
+    am_adc_isr,                             // 18: ADC
+    am_pdm0_isr,                            // 19: PDM
+    am_mspi0_isr,                           // 20: MSPI0
+    am_software0_isr,                       // 21: SOFTWARE0
+    am_stimer_isr,                          // 22: SYSTEM TIMER
+    am_stimer_cmpr0_isr,                    // 23: SYSTEM TIMER COMPARE0
+    am_stimer_cmpr1_isr,                    // 24: SYSTEM TIMER COMPARE1
+    am_stimer_cmpr2_isr,                    // 25: SYSTEM TIMER COMPARE2
+    am_stimer_cmpr3_isr,                    // 26: SYSTEM TIMER COMPARE3
+    am_stimer_cmpr4_isr,                    // 27: SYSTEM TIMER COMPARE4
+    am_stimer_cmpr5_isr,                    // 28: SYSTEM TIMER COMPARE5
+    am_stimer_cmpr6_isr,                    // 29: SYSTEM TIMER COMPARE6
+    am_stimer_cmpr7_isr,                    // 30: SYSTEM TIMER COMPARE7
+    am_clkgen_isr,                          // 31: CLKGEN
+};
+#endif
+
+//*****************************************************************************
+//
+// Faults and unexpected interrupts stop the process with the active exception
+// number so that a debugger or the soak test harness sees them.
+//
+//*****************************************************************************
+void
+NMI_Handler(void)
+{
+    fprintf(stderr, "NMI\n");
+    abort();
+}
+
+void
+HardFault_Handler(void)
+{
+    fprintf(stderr, "HardFault\n");
+    abort();
+}
+
+void
+am_default_isr(void)
+{
+    fprintf(stderr, "Unexpected exception %u\n", (unsigned)__get_IPSR());
+    abort();
+}
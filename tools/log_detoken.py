@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Expand tokenized log records (LOG_PRINTF with LOG_TOKENIZED) using the ELF
+# file of the running firmware.
+#
+#   log_detoken.py build/nmapp.axf < console.log
+#   log_detoken.py build/nmapp.axf --port /dev/ttyACM0
+#
+# Lines that do not contain a record are passed through unchanged.
+
+import argparse
+import re
+import struct
+import sys
+
+RECORD = re.compile(r'~((?:[0-9A-F]{8}){2,})')
+SPECIFIER = re.compile(r'%([-+ #0]*)(\d*|\*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+STIMER_HZ = 32768
+
+
+#******************************************************************************
+#
+# Minimal ELF32 little endian section reader, enough to find the format
+# strings and the constant strings referenced by %s.
+#
+#******************************************************************************
+class Elf:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError('%s is not a 32-bit little endian ELF file' % path)
+
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', self.data, 0x2E)
+
+        headers = []
+        for i in range(shnum):
+            name, stype, flags, addr, offset, size = struct.unpack_from(
+                '<IIIIII', self.data, shoff + i * shentsize)
+            headers.append((name, stype, flags, addr, offset, size))
+
+        strtab = headers[shstrndx]
+        self.sections = {}
+        self.loadable = []
+        for name, stype, flags, addr, offset, size in headers:
+            end = self.data.index(b'\0', strtab[4] + name)
+            section = self.data[strtab[4] + name:end].decode()
+            self.sections[section] = (addr, offset, size)
+            # SHT_PROGBITS with SHF_ALLOC
+            if stype == 1 and flags & 0x2:
+                self.loadable.append((addr, offset, size))
+
+    def string_at(self, data, offset):
+        end = data.find(b'\0', offset)
+        if end < 0:
+            end = len(data)
+        return data[offset:end].decode(errors='replace')
+
+    def format_string(self, token):
+        if '.log_fmt' not in self.sections:
+            raise ValueError('no .log_fmt section, was the firmware built with LOG_TOKENIZED?')
+        addr, offset, size = self.sections['.log_fmt']
+        if token >= size:
+            return None
+        return self.string_at(self.data[offset:offset + size], token)
+
+    def constant_string(self, address):
+        for addr, offset, size in self.loadable:
+            if addr <= address < addr + size:
+                return self.string_at(self.data[offset:offset + size], address - addr)
+        return '<0x%08x>' % address
+
+
+def format_record(elf, fmt, args):
+    out = []
+    position = 0
+    index = 0
+
+    for match in SPECIFIER.finditer(fmt):
+        out.append(fmt[position:match.start()])
+        position = match.end()
+        flags, width, precision, length, conversion = match.groups()
+
+        if conversion == '%':
+            out.append('%')
+            continue
+
+        value = args[index] if index < len(args) else 0
+        index += 1
+
+        if conversion in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+        elif conversion == 's':
+            value = elf.constant_string(value)
+        elif conversion == 'c':
+            value = chr(value & 0xFF)
+        elif conversion == 'p':
+            conversion = 'x'
+            flags = '#'
+
+        spec = '%' + flags + width + ('.' + precision if precision else '') + conversion
+        out.append(spec % value)
+
+    out.append(fmt[position:])
+    return ''.join(out)
+
+
+def expand(elf, line, timestamps):
+    def replace(match):
+        words = [int(match.group(1)[i:i + 8], 16) for i in range(0, len(match.group(1)), 8)]
+        token, timestamp, args = words[0], words[1], words[2:]
+        fmt = elf.format_string(token)
+        if fmt is None:
+            return '<unknown token 0x%x>' % token
+        text = format_record(elf, fmt, args)
+        if timestamps:
+            text = '[%10.3f] %s' % (timestamp / STIMER_HZ, text)
+        return text
+
+    return RECORD.sub(replace, line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Expand tokenized LOG_PRINTF records.')
+    parser.add_argument('elf', help='firmware ELF file (.axf)')
+    parser.add_argument('--port', help='serial port to read from instead of stdin')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--timestamps', action='store_true', help='prefix records with the STIMER time')
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud)
+        lines = (raw.decode(errors='replace') for raw in iter(stream.readline, b''))
+    else:
+        lines = sys.stdin
+
+    for line in lines:
+        sys.stdout.write(expand(elf, line, args.timestamps))
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()